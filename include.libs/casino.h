@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 2.00 
-    Dated:   27th February 2024
+    Version: 2.01 
+    Dated:   19th October 2026
     E-Mail:  mao@tumblingdice.co.uk 
 ------------------------------------------------------------------------------*/
 
@@ -22,7 +22,7 @@
 /* Version */
 /***********/
 
-#define CASINO_VERSION  "2.00"
+#define CASINO_VERSION  "2.01"
 
 
 /*------------------*/
@@ -53,6 +53,19 @@ typedef struct {   uint32_t     n_gates;     // Number of gates
                } gate_type;
 
 
+/*---------------------------------------------------------------*/
+/* Random stream. Each stream carries its own (xoshiro256**)     */
+/* generator state, so streams may be used concurrently from     */
+/* different threads without locking. Independent substreams are */
+/* obtained by jumping a parent stream ahead 2^128 draws         */
+/*---------------------------------------------------------------*/
+
+typedef struct {   uint64_t     s[4];        // Generator state
+                   _BOOLEAN     have_gauss;  // TRUE if cached Gaussian deviate
+                   FTYPE        gauss;       // Cached (second) Gaussian deviate
+               } rstream_type;
+
+
 #ifdef __NOT_LIB_SOURCE__
 
 _EXPORT  int64_t  r_init;
@@ -177,6 +190,51 @@ _PROTOTYPE _EXPORT void gser(FTYPE *, const FTYPE, const FTYPE, FTYPE *);
 // Evaluate the incomplete gamma function by its continued fraction
 _PROTOTYPE _EXPORT void gcf(FTYPE *, const FTYPE, const FTYPE, FTYPE *);
 
+// Seed random stream
+_PROTOTYPE _EXPORT void rstream_seed(rstream_type *, const uint64_t);
+
+// Jump random stream ahead 2^128 draws
+_PROTOTYPE _EXPORT void rstream_jump(rstream_type *);
+
+// Jump random stream ahead 2^192 draws
+_PROTOTYPE _EXPORT void rstream_long_jump(rstream_type *);
+
+// Split random stream into independent (non-overlapping) substreams
+_PROTOTYPE _EXPORT int32_t rstream_split(rstream_type *, const uint32_t, rstream_type *);
+
+// Next raw 64 bit value from random stream
+_PROTOTYPE _EXPORT uint64_t rstream_next(rstream_type *);
+
+// Uniform deviate in (0.0, 1.0) from random stream
+_PROTOTYPE _EXPORT FTYPE rstream_uniform(rstream_type *);
+
+// Gaussian deviate (zero mean, given variance) from random stream
+_PROTOTYPE _EXPORT FTYPE rstream_gaussian(rstream_type *, const FTYPE);
+
+// Gamma deviate of order a from random stream
+_PROTOTYPE _EXPORT FTYPE rstream_gamma(rstream_type *, const FTYPE);
+
+// Poisson deviate of mean xm from random stream
+_PROTOTYPE _EXPORT FTYPE rstream_poisson(rstream_type *, const FTYPE);
+
+// Fill array with uniform deviates from random stream
+_PROTOTYPE _EXPORT void rstream_fill_uniform(rstream_type *, const uint32_t, FTYPE *);
+
+// Fill array with Gaussian deviates from random stream
+_PROTOTYPE _EXPORT void rstream_fill_gaussian(rstream_type *, const uint32_t, const FTYPE, FTYPE *);
+
+// Fill array with Poisson deviates from random stream
+_PROTOTYPE _EXPORT void rstream_fill_poisson(rstream_type *, const uint32_t, const FTYPE, FTYPE *);
+
+// Set master seed for per-thread random streams
+_PROTOTYPE _EXPORT void rstream_set_thread_seed(const uint64_t);
+
+// Get random stream private to calling thread
+_PROTOTYPE _EXPORT rstream_type *rstream_thread(void);
+
+// Uniform deviate from calling thread's random stream (drop in for ran1 etc.)
+_PROTOTYPE _EXPORT FTYPE rstream_ran(void);
+
 #ifdef _CPLUSPLUS
 #   undef  _EXPORT
 #   define _EXPORT extern C
@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------
+    Purpose: Layout of shared memory CPU utilisation table. The table is
+             published by cpuload (which samples the per-CPU counters in
+             /proc/stat) and read by homeostatic PUPS processes via
+             pups_cpu_utilisation() and pups_get_load_average(), so they
+             do not each have to sample /proc themselves.
+
+    Author:  M.A. O'Neill
+             Tumbling Dice Ltd
+             Gosforth
+             Newcastle upon Tyne
+             NE3 4RT
+             United Kingdom
+
+    Version: 1.00
+    Dated:   19th October 2026
+    E-Mail:  mao@tumblingdice.co.uk
+------------------------------------------------------------------------------*/
+
+#ifndef CPUSTAT_H
+#define CPUSTAT_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/*-----------------------------------------------------------*/
+/* Table is a (POSIX) shared memory object in /dev/shm. It   */
+/* is written by (one) cpuload daemon and is world readable  */
+/*-----------------------------------------------------------*/
+
+#define CPUSTAT_VERSION      "1.00"
+#define CPUSTAT_PATH         "/dev/shm/pups.cpustat"
+#define CPUSTAT_MAGIC        0x43505531U
+#define CPUSTAT_MAX_CPUS     256
+#define CPUSTAT_MAX_WINDOW   120
+#define CPUSTAT_MAX_SPINS    1024
+
+
+/*-----------------------------------------------------------*/
+/* Utilisation is averaged over three windows (in samples).  */
+/* The instantaneous window is always one sample, the sizes  */
+/* of the short and long windows are set by cpuload          */
+/*-----------------------------------------------------------*/
+
+#define CPUSTAT_INSTANT      0
+#define CPUSTAT_SHORT        1
+#define CPUSTAT_LONG         2
+#define CPUSTAT_WINDOWS      3
+
+
+/*-----------------------------------------------------------*/
+/* CPU index used by readers to select aggregate (over all   */
+/* CPUs) utilisation                                         */
+/*-----------------------------------------------------------*/
+
+#define CPUSTAT_AGGREGATE    (-1)
+
+
+/*--------------------------------------------------------------*/
+/* Sequence number is odd while cpuload is updating the table.  */
+/* Readers copy what they need and discard the copy if the      */
+/* sequence number changed while they were copying it. Readers  */
+/* give up after CPUSTAT_MAX_SPINS attempts (a publisher which  */
+/* dies mid update leaves the sequence number odd)              */
+/*--------------------------------------------------------------*/
+
+typedef struct {    uint32_t  seq;                                        // Table sequence number
+                    uint32_t  magic;                                      // Table magic number
+                    pid_t     publisher;                                  // PID of (cpuload) publisher
+                    uint32_t  period;                                     // Sample period (milliseconds)
+                    int64_t   updated;                                    // Time of last update (seconds since epoch)
+                    uint32_t  n_cpus;                                     // Number of CPUs
+                    uint32_t  window[CPUSTAT_WINDOWS];                    // Window sizes (samples)
+                    float     loadavg[3];                                 // 1, 5 and 15 minute load averages
+                    float     aggregate[CPUSTAT_WINDOWS];                 // Aggregate utilisation (percent)
+                    float     cpu[CPUSTAT_MAX_CPUS][CPUSTAT_WINDOWS];     // Per CPU utilisation (percent)
+               } cpustat_type;
+
+#endif /* CPUSTAT_H */
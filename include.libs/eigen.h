@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 2.00 
-    Dated:   5th February 2024
+    Version: 2.01 
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 -------------------------------------------------------------------------------------*/
 
@@ -33,7 +33,7 @@
 /* Version */
 /***********/
 
-#define EIGEN_VERSION  "2.00"
+#define EIGEN_VERSION  "2.01"
 
 
 
@@ -45,6 +45,28 @@
 #include <ftype.h>
 
 
+
+
+/*--------------------------------------------------------------*/
+/* Contiguous (row-major) matrix used by the blocked/parallel   */
+/* PCA path. Rows are padded to a multiple of the cache line so */
+/* that every row starts on an aligned boundary                 */
+/*--------------------------------------------------------------*/
+
+typedef struct {   int32_t rows;                // Number of rows
+                   int32_t cols;                // Number of columns
+                   int32_t ld;                  // Leading dimension (padded row stride)
+                   FTYPE   *data;               // Matrix data (cache line aligned)
+               } ematrix_type;
+
+
+/*---------------------------------------------*/
+/* Access element (i,j) of a row-major ematrix */
+/*---------------------------------------------*/
+
+#define EMAT(m,i,j)  ((m)->data[(size_t)(i)*(size_t)(m)->ld + (size_t)(j)])
+
+
 /*---------------------*/
 /* Function prototypes */
 /*---------------------*/
@@ -73,5 +95,26 @@ _PUBLIC FTYPE **get_eigenpatterns(int, int32_t, int32_t, FTYPE **, FTYPE **);
 // Map pattern  into covariance basis (returning projection weights in that basis)
 _PUBLIC FTYPE *generate_weight_vector(int32_t,  int32_t, FTYPE *, FTYPE **);
 
+// Create (zeroed) contiguous row-major matrix
+_PUBLIC ematrix_type *ematrix_create(const int32_t, const int32_t);
+
+// Destroy contiguous row-major matrix
+_PUBLIC ematrix_type *ematrix_destroy(ematrix_type *);
+
+// Pack (0 based) pattern vectors into a contiguous row-major matrix
+_PUBLIC ematrix_type *ematrix_load(const int32_t, const int32_t, FTYPE **);
+
+// Get pattern vector covariance matrix (cache blocked, parallel SYRK kernel)
+_PUBLIC int32_t get_covariance_matrix_blocked(const ematrix_type *, ematrix_type *);
+
+// Get eigenvectors of covariance matrix (parallel Householder tridiagonalisation and QL)
+_PUBLIC int32_t get_eigenvectors_parallel(const FTYPE, ematrix_type *, FTYPE *);
+
+// Transform pattern vectors to basis defined by eigenvectors (blocked, parallel)
+_PUBLIC ematrix_type *get_eigenpatterns_blocked(const int32_t, const ematrix_type *, const ematrix_type *);
+
+// Map block of patterns into covariance basis (returning N x nse matrix of projection weights)
+_PUBLIC ematrix_type *generate_weight_matrix(const int32_t, const ematrix_type *, const ematrix_type *);
+
 #endif /* EIGEN_H */
 
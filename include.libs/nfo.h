@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 3.02 
-    Dated:   12th December 2024 
+    Version: 3.03 
+    Dated:   19th October 2026
     E-Mail:  mao@tumblingdice.co.uk 
 ------------------------------------------------------------------------------*/
 
@@ -28,7 +28,7 @@
 /* Version */
 /***********/
 
-#define NFO_VERSION    "3.02"
+#define NFO_VERSION    "3.03"
 
 
 
@@ -53,6 +53,60 @@
 
 
 
+/*------------------------------------------*/
+/* Methods used by parallel multistart      */
+/* minimiser (nfo_multistart)               */
+/*------------------------------------------*/
+
+#define NFO_ANNEAL 1            // Simulated annealing chains
+#define NFO_POWELL 2            // Powell restarts
+
+
+
+
+/*------------------------------------------------------------*/
+/* Objective functions used by the parallel minimiser. Unlike */
+/* the legacy minimisers these are passed user data, and the  */
+/* batch form evaluates a set of points in one call (so that  */
+/* vectorisable cost functions can be exploited)              */
+/*------------------------------------------------------------*/
+
+typedef FTYPE (*nfo_objective_type)(const FTYPE *, void *);
+typedef void  (*nfo_batch_objective_type)(const uint32_t, const uint32_t, const FTYPE *, FTYPE *, void *);
+
+
+
+
+/*----------------------------------------------------------*/
+/* Parallel multistart minimiser description. Chains (or    */
+/* restarts) run concurrently, each with its own random     */
+/* substream, and share a best-so-far point. All chains are */
+/* stopped when cancel becomes TRUE or f_target is reached  */
+/*----------------------------------------------------------*/
+
+typedef struct {   uint32_t                  method;          // NFO_ANNEAL or NFO_POWELL
+                   uint32_t                  n_starts;        // Number of chains/restarts
+                   uint32_t                  n_dims;          // Dimensions of objective (<= MAX_D)
+                   uint32_t                  max_iter;        // Iteration limit per chain
+                   uint32_t                  batch_size;      // Candidate moves per annealing step
+                   uint64_t                  seed;            // Seed for chain random streams
+                   FTYPE                     ftol;            // Relaxation tolerance
+                   FTYPE                     delta_range;     // Perturbation (and start spread) range
+                   FTYPE                     temperature;     // Initial annealing temperature
+                   FTYPE                     cooling;         // Temperature decay per step
+                   FTYPE                     f_target;        // Stop all chains at or below this cost
+                   nfo_objective_type        objective;       // Objective function
+                   nfo_batch_objective_type  batch_objective; // Batch objective (may be NULL)
+                   void                      *data;           // User data passed to objective
+                   volatile _BOOLEAN         cancel;          // Set TRUE to stop all chains
+                   volatile FTYPE            best_f;          // Best cost found so far
+                   FTYPE                     best_p[MAX_D];   // Best co-ordinate found so far
+                   uint32_t                  best_start;      // Chain which found best_p
+               } nfo_multistart_type;
+
+
+
+
 /*-------------------------------------------------------*/
 /* Constant definitions used by least squares regression */
 /*-------------------------------------------------------*/
@@ -104,7 +158,7 @@ _PROTOTYPE _EXPORT void mnbrak(FTYPE *,
                                FTYPE *,
                                FTYPE (* )(__UDEF_ARGS__));
 
-// Multidimensional minimisation using Powell's method [not thread safe]
+// Multidimensional minimisation using Powell's method [thread safe if func is]
 _PROTOTYPE _EXPORT void Powell(FTYPE [],
                                FTYPE [][MAX_D],
                                uint32_t, 
@@ -159,7 +213,7 @@ _PROTOTYPE _EXPORT FTYPE Simpson_spl(FTYPE,
 // Differentiation using Milnes method
 _PROTOTYPE _EXPORT FTYPE Milne_diff(uint32_t   , FTYPE, FTYPE []);
 
-// Linear minimisation using Brents' method [not thread safe]
+// Linear minimisation using Brents' method [thread safe if func is]
 _PROTOTYPE _EXPORT FTYPE Brent(FTYPE, 
                                FTYPE,
                                FTYPE,
@@ -175,6 +229,21 @@ _PROTOTYPE _EXPORT FTYPE golden(FTYPE,
                                 FTYPE, 
                                 FTYPE *);
 
+// Initialise multistart minimiser description (with default parameters)
+_PROTOTYPE _EXPORT void nfo_multistart_init(nfo_multistart_type *,
+                                            const uint32_t,
+                                            const uint32_t,
+                                            const uint32_t,
+                                            nfo_objective_type,
+                                            nfo_batch_objective_type,
+                                            void *);
+
+// Run multistart minimisation (annealing chains or Powell restarts) in parallel
+_PROTOTYPE _EXPORT int32_t nfo_multistart(nfo_multistart_type *, const FTYPE *, FTYPE *, FTYPE *);
+
+// Cancel running multistart minimisation
+_PROTOTYPE _EXPORT void nfo_multistart_cancel(nfo_multistart_type *);
+
 #ifdef _CPLUSPLUS
 #   undef  _EXPORT
 #   define _EXPORT extern C
@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------------
+    Purpose: Layout of (per user) shared memory process name registry. PUPS
+             processes register their (PSRP) process name here so that name
+             to PID resolution does not need to walk /proc. The layout (and
+             the small inline helpers needed to read it) are defined here so
+             that stand alone tools (for example nkill and kepher) which do
+             not link against the PUPS libraries can read the registry.
+
+    Author:  M.A. O'Neill
+             Tumbling Dice Ltd
+             Gosforth
+             Newcastle upon Tyne
+             NE3 4RT
+             United Kingdom
+
+    Version: 1.00
+    Dated:   19th October 2026
+    E-Mail:  mao@tumblingdice.co.uk
+------------------------------------------------------------------------------*/
+
+#ifndef PNREG_H
+#define PNREG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+
+/*---------------------------------------------------------------*/
+/* Registry is a (POSIX) shared memory object in /dev/shm. There */
+/* is one registry per user so that one user cannot redirect     */
+/* another user's name lookups                                   */
+/*---------------------------------------------------------------*/
+
+#define PNREG_VERSION        "1.00"
+#define PNREG_PATH_FMT       "/dev/shm/pups.pnreg.%d"
+#define PNREG_MAGIC          0x504e5231U
+#define PNREG_SLOTS          4096
+#define PNREG_PROBES         32
+#define PNREG_NAMELEN        64
+
+
+/*----------------------------------------------------------------*/
+/* Readers retry an entry which is being written at most          */
+/* PNREG_MAX_SPINS times. A writer which finds that an entry has  */
+/* stayed odd for PNREG_STALE_POLLS polls (one per millisecond)   */
+/* assumes that its writer died and reclaims it                   */
+/*----------------------------------------------------------------*/
+
+#define PNREG_MAX_SPINS      64
+#define PNREG_STALE_POLLS    100
+#define PNREG_STAT_SIZE      1024
+
+
+/*----------------------------------------------------------------*/
+/* Registry entry. The sequence number is even when the entry is  */
+/* stable and odd while it is being written. Writers claim a slot */
+/* by moving the sequence number from even to odd (atomic CAS),   */
+/* readers copy the entry and discard it if the sequence number   */
+/* changed while they were copying it                             */
+/*----------------------------------------------------------------*/
+
+typedef struct {    uint32_t  seq;                     // Entry sequence number
+                    pid_t     pid;                     // PID of owner (0 if slot is free)
+                    uint64_t  start_time;              // Owner start time (clock ticks since boot)
+                    char      name[PNREG_NAMELEN];     // (PSRP) process name of owner
+               } pnreg_entry_type;
+
+
+typedef struct {    uint32_t          magic;           // Registry magic number
+                    uint32_t          slots;           // Number of slots in registry
+                    pnreg_entry_type  entry[PNREG_SLOTS];
+                                                       // Registry entries
+               } pnreg_type;
+
+
+/*----------------------------------------------------------------*/
+/* Names hash (FNV-1a) to a home slot. Entries live in the window */
+/* of PNREG_PROBES slots which starts at the home slot            */
+/*----------------------------------------------------------------*/
+
+#define PNREG_FNV_OFFSET     2166136261U
+#define PNREG_FNV_PRIME      16777619U
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Home slot (in process name registry) for a process name   */
+/*-----------------------------------------------------------*/
+
+static inline uint32_t pnreg_hash(const char *name)
+
+{   uint32_t hash = PNREG_FNV_OFFSET;
+
+    for(; *name != '\0'; ++name)
+    {  hash ^= (unsigned char)*name;
+       hash *= PNREG_FNV_PRIME;
+    }
+
+    return(hash % PNREG_SLOTS);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Start time of process (clock ticks since boot). Used to     */
+/* tell a registered process from one which has reused its PID */
+/*-------------------------------------------------------------*/
+
+static inline uint64_t pnreg_start_time(const pid_t pid)
+
+{   uint32_t i;
+    int32_t  fdes;
+    ssize_t  size;
+    uint64_t start_time                 = 0;
+
+    char     path[PNREG_STAT_SIZE]      = "",
+             stat_line[PNREG_STAT_SIZE] = "",
+             *ptr                       = (char *)NULL;
+
+    (void)snprintf(path,PNREG_STAT_SIZE,"/proc/%d/stat",pid);
+    if((fdes = open(path,O_RDONLY | O_CLOEXEC)) == (-1))
+       return(0);
+
+    size = read(fdes,stat_line,PNREG_STAT_SIZE - 1);
+    (void)close(fdes);
+
+    if(size <= 0)
+       return(0);
+    stat_line[size] = '\0';
+
+
+    /*--------------------------------------------------------*/
+    /* Process name (field 2) may contain spaces so skip past */
+    /* its closing bracket. Start time is field 22            */
+    /*--------------------------------------------------------*/
+
+    if((ptr = strrchr(stat_line,')')) == (char *)NULL)
+       return(0);
+
+    for(i=0; i<20 && ptr != (char *)NULL; ++i)
+       ptr = strchr(ptr + 1,' ');
+
+    if(ptr == (char *)NULL || sscanf(ptr,"%" SCNu64,&start_time) != 1)
+       return(0);
+
+    return(start_time);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Take consistent copy of registry entry. Returns 0 if copy is */
+/* good and -1 if the entry was being written (or changed) on   */
+/* every one of PNREG_MAX_SPINS attempts                        */
+/*--------------------------------------------------------------*/
+
+static inline int32_t pnreg_read_entry(pnreg_entry_type *entry, pnreg_entry_type *copy)
+
+{   uint32_t i,
+             seq;
+
+    for(i=0; i<PNREG_MAX_SPINS; ++i)
+    {  if(i > 0)
+          (void)sched_yield();
+
+       if((seq = __atomic_load_n(&entry->seq,__ATOMIC_ACQUIRE)) & 1)
+          continue;
+
+       copy->pid        = entry->pid;
+       copy->start_time = entry->start_time;
+       (void)memcpy(copy->name,entry->name,PNREG_NAMELEN);
+       copy->name[PNREG_NAMELEN - 1] = '\0';
+
+       __atomic_thread_fence(__ATOMIC_ACQUIRE);
+       if(__atomic_load_n(&entry->seq,__ATOMIC_RELAXED) == seq)
+       {  copy->seq = seq;
+          return(0);
+       }
+    }
+
+    return(-1);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Is registered process alive (pidfd) and not a PID which has */
+/* been reused (start time)? Returns 0 if it is and -1 if not  */
+/*-------------------------------------------------------------*/
+
+static inline int32_t pnreg_alive(const pid_t pid, const uint64_t start_time)
+
+{
+
+    #ifdef SYS_pidfd_open
+    int32_t pidfd;
+
+    if((pidfd = (int32_t)syscall(SYS_pidfd_open,pid,0)) == (-1))
+    {  if(errno == ESRCH)
+          return(-1);
+    }
+    else
+       (void)close(pidfd);
+    #endif /* SYS_pidfd_open */
+
+    if(pnreg_start_time(pid) != start_time)
+       return(-1);
+
+    return(0);
+}
+
+
+
+
+/*----------------------------------------------------------------*/
+/* Look up name in registry. Returns the number of live           */
+/* processes registered under name (0, 1 or 2 meaning more than   */
+/* one) with *pid set to the last one found, or -1 if an entry in */
+/* the name's window could not be read (in which case the caller  */
+/* must walk /proc as the entry could hide a duplicate)           */
+/*----------------------------------------------------------------*/
+
+static inline int32_t pnreg_lookup(pnreg_type *registry, const char *name, pid_t *pid)
+
+{   uint32_t i,
+             home;
+    int32_t  cnt = 0;
+
+    home = pnreg_hash(name);
+    for(i=0; i<PNREG_PROBES; ++i)
+    {  pnreg_entry_type copy;
+
+       if(pnreg_read_entry(&registry->entry[(home + i) % PNREG_SLOTS],&copy) == (-1))
+          return(-1);
+
+       if(copy.pid == 0 || strcmp(copy.name,name) != 0 || pnreg_alive(copy.pid,copy.start_time) == (-1))
+          continue;
+
+       *pid = copy.pid;
+       if(++cnt > 1)
+          break;
+    }
+
+    return(cnt);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Look up name in (our) process name registry (for tools      */
+/* which do not attach it). Returns PID if name is registered  */
+/* to exactly one live process and -1 otherwise, or if the     */
+/* registry cannot be read (in which case we walk /proc)       */
+/*-------------------------------------------------------------*/
+
+static inline pid_t pnreg_name_to_pid(const char *name)
+
+{   int32_t     fdes;
+    pid_t       pid                   = (-1);
+    pnreg_type  *registry             = (pnreg_type *)NULL;
+    char        path[PNREG_STAT_SIZE] = "";
+    struct stat buf;
+
+    if(strlen(name) >= PNREG_NAMELEN)
+       return(-1);
+
+    (void)snprintf(path,PNREG_STAT_SIZE,PNREG_PATH_FMT,getuid());
+    if((fdes = open(path,O_RDONLY | O_CLOEXEC)) == (-1))
+       return(-1);
+
+    if(fstat(fdes,&buf) == (-1) || buf.st_uid != getuid() || (size_t)buf.st_size < sizeof(pnreg_type))
+    {  (void)close(fdes);
+       return(-1);
+    }
+
+    registry = (pnreg_type *)mmap((void *)NULL,sizeof(pnreg_type),PROT_READ,MAP_SHARED,fdes,0);
+    (void)close(fdes);
+
+    if((void *)registry == MAP_FAILED)
+       return(-1);
+
+    if(registry->magic != PNREG_MAGIC || registry->slots != PNREG_SLOTS || pnreg_lookup(registry,name,&pid) != 1)
+       pid = (-1);
+
+    (void)munmap((void *)registry,sizeof(pnreg_type));
+    return(pid);
+}
+
+#endif /* PNREG_H */
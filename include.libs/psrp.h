@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 7.04 
-    Dated:   29th December 2024 
+    Version: 7.14 
+    Dated:   19th October 2026 
     E-mail:  mao@tumblingdice.co.uk
 -------------------------------------------------------------------------*/
 
@@ -38,7 +38,7 @@
 /* Version */
 /***********/
 
-#define PSRPLIB_VERSION      "7.04"
+#define PSRPLIB_VERSION      "7.14"
 
 
 /*-------------*/
@@ -76,6 +76,7 @@
 /*-----------------------------------*/
 
 #define MAX_CRON_SLOTS             16
+#define PSRP_CRON_MAX_DAYS         (5*366)    // Furthest ahead a cron expression is searched
 
 
 /*----------------------*/
@@ -210,6 +211,125 @@
 #define PSRP_REDIRECT_STDIO            (1 << 5) 
 
 
+/*-------------------------------------------------------------*/
+/* Socket (SOCK_SEQPACKET) transport. Each message is split    */
+/* into frames of at most PSRP_FRAME_PAYLOAD bytes, each frame */
+/* preceded by a psrp_frame_header_type. PSRP_FRAME_MORE is    */
+/* set on every frame but the last. PSRP_FRAME_BATCH marks a   */
+/* message which is a newline separated list of requests       */
+/* (which gets a single combined reply). PSRP_FRAME_BINARY     */
+/* marks a request for a typed function (tag then typed binary */
+/* arguments). Clients may have up to PSRP_PIPELINE_WINDOW     */
+/* (tagged) requests outstanding. Messages may not be longer   */
+/* than PSRP_FRAME_MAX_MESSAGE bytes                           */
+/*-------------------------------------------------------------*/
+
+#define PSRP_FRAME_MAGIC               0x50535250
+#define PSRP_FRAME_PAYLOAD             32768
+#define PSRP_FRAME_MAX_MESSAGE         (1 << 24)
+#define PSRP_FRAME_MORE                (1 << 0)
+#define PSRP_FRAME_BATCH               (1 << 1)
+#define PSRP_FRAME_BINARY              (1 << 2)
+#define PSRP_PIPELINE_WINDOW           32
+
+
+/*--------------------------------------------------------------*/
+/* Socket transport worker threads. Requests for static         */
+/* functions attached by psrp_attach_concurrent_function() are  */
+/* run by the worker pool, everything else is serialised on the */
+/* root thread. Detaching a function removes it from the worker */
+/* pool (once any requests it is running have finished)         */
+/*--------------------------------------------------------------*/
+
+#define PSRP_SOCK_WORKERS              4
+#define PSRP_CONCURRENT_TABLE_SIZE     32
+
+
+/*-------------------------------------------------------------*/
+/* Hashed dispatch. Object tags (and aliases) are indexed by a */
+/* chained hash table (which grows as objects are attached).   */
+/* Builtins are resolved via a (precomputed) perfect hash: the */
+/* seed was chosen so that no two builtin verbs collide. If a  */
+/* builtin is added the seed (and table) must be regenerated   */
+/*-------------------------------------------------------------*/
+
+#define PSRP_TAG_HASH_SIZE             64
+#define PSRP_BUILTIN_HASH_SIZE         256
+#define PSRP_BUILTIN_HASH_SHIFT        24
+#define PSRP_BUILTIN_HASH_SEED         0x16bc868a
+
+
+/*-------------------------------------------------------------*/
+/* Shared memory (SPSC) ring used for bulk databag transfer.   */
+/* The ring is a memfd which the reader opens via /proc. Data  */
+/* area size is a power of two (PSRP_RING_MIN_SIZE to          */
+/* PSRP_RING_SIZE bytes). Blocked ring operations check every  */
+/* PSRP_RING_POLL milliseconds that the peer is still alive.   */
+/* A transfer whose peer makes no progress for                 */
+/* PSRP_RING_TIMEOUT milliseconds is abandoned. Databags      */
+/* streamed via a ring may not exceed PSRP_RING_MAX_TOTAL      */
+/* bytes                                                       */
+/*-------------------------------------------------------------*/
+
+#define PSRP_RING_MAGIC                0x52494e47
+#define PSRP_RING_MIN_SIZE             (1 << 16)
+#define PSRP_RING_SIZE                 (1 << 22)
+#define PSRP_RING_POLL                 100
+#define PSRP_RING_TIMEOUT              30000
+#define PSRP_RING_MAX_TOTAL            (1L << 30)
+
+
+/*-------------------------------------------------------------*/
+/* Request latency histograms. Latencies (microseconds) are    */
+/* binned log-linearly (HDR style): each power of two is split */
+/* into 2^PSRP_HIST_SUB_BITS buckets, so relative error is     */
+/* bounded by 1/2^PSRP_HIST_SUB_BITS. Histograms are kept for  */
+/* queue, dispatch and reply write time per verb (up to        */
+/* PSRP_LATENCY_VERBS, then "other") and per client. Trace     */
+/* spans (if enabled) go to a ring of PSRP_TRACE_SPANS entries */
+/*-------------------------------------------------------------*/
+
+#define PSRP_HIST_SUB_BITS             4
+#define PSRP_HIST_SUB_BUCKETS          (1 << PSRP_HIST_SUB_BITS)
+#define PSRP_HIST_BUCKETS              ((32 - PSRP_HIST_SUB_BITS + 1) << PSRP_HIST_SUB_BITS)
+#define PSRP_LATENCY_VERBS             64
+#define PSRP_LATENCY_VERB_SIZE         32
+#define PSRP_LATENCY_QUEUE             0
+#define PSRP_LATENCY_DISPATCH          1
+#define PSRP_LATENCY_WRITE             2
+#define PSRP_LATENCY_PHASES            3
+#define PSRP_TRACE_SPANS               4096
+
+
+/*-------------------------------------------------------------*/
+/* SIC pool. Up to PSRP_SIC_POOL_SIZE SICs (keyed by host, ssh */
+/* port and PEN) are kept open between uses. A pooled SIC      */
+/* which has been idle for PSRP_SIC_POOL_IDLE seconds is       */
+/* destroyed. The pool is checked for idle SICs every          */
+/* PSRP_SIC_POOL_REAP virtual timer ticks                      */
+/*-------------------------------------------------------------*/
+
+#define PSRP_SIC_POOL_SIZE             4
+#define PSRP_SIC_POOL_IDLE             60
+#define PSRP_SIC_POOL_REAP             1000
+
+
+/*--------------------------------------------------------------*/
+/* Typed function arguments. A typed function has a schema (one */
+/* character per argument) and receives its arguments decoded   */
+/* into a psrp_typed_args_type                                  */
+/*--------------------------------------------------------------*/
+
+#define PSRP_ARG_INT                   'i'
+#define PSRP_ARG_DOUBLE                'd'
+#define PSRP_ARG_BYTES                 'b'
+#define PSRP_ARG_STRING                's'
+#define PSRP_ARG_VECTOR                'v'
+#define PSRP_ARG_TYPES                 "idbsv"
+#define PSRP_MAX_TYPED_ARGS            32
+#define PSRP_TYPED_TABLE_SIZE          32
+
+
 /*-----------------------------------------------------------------*/
 /* Object types and states that the PSRP handler has to know about */
 /*-----------------------------------------------------------------*/
@@ -248,12 +368,31 @@ typedef struct {   char     type[SSIZE];        // MIME part type
 /* Types used by cron subsystem */
 /*------------------------------*/
 
-typedef struct {   time_t        from;                // Start of scheduled op.
-                   time_t         to;                 // End of scheduled op.
-                   _BOOLEAN       overnight;          // Op extends over midnight
+typedef struct {   uint64_t       minute;             // Minutes (0-59) matched
+                   uint32_t       hour;               // Hours (0-23) matched
+                   uint32_t       mday;               // Days of month (1-31) matched
+                   uint32_t       month;              // Months (1-12) matched
+                   uint32_t       wday;               // Days of week (0-6, Sunday is 0) matched
+                   _BOOLEAN       any_mday;           // Day of month is unrestricted
+                   _BOOLEAN       any_wday;           // Day of week is unrestricted
+               } psrp_cron_spec_type;
+
+typedef struct {   _BOOLEAN       used;               // Slot in use
+                   _BOOLEAN       window;             // Start/stop window (not cron expression)
+                   _BOOLEAN       forever;            // Window is never closed
+                   _BOOLEAN       active;             // Window is open
+                   _BOOLEAN       running;            // Payload is running
+                   psrp_cron_spec_type start;         // Start of scheduled op.
+                   psrp_cron_spec_type stop;          // End of scheduled op. (window)
+                   time_t         due;                // Next scheduled event
+                   time_t         next;               // Next wakeup (due plus jitter)
+                   uint32_t       jitter;             // Maximum random delay (seconds)
+                   uint32_t       seed;               // Jitter random seed
+                   int32_t        heap_index;         // Position in deadline queue
+                   uint64_t       runs;               // Number of times payload run
                    void           (*func)(int32_t);   // Payload function
                    char           fname[SSIZE];       // Name of payload function
-                   char           fromdate[SSIZE];    // Date string for start
+                   char           fromdate[SSIZE];    // Date string (or cron expression) for start
                    char           todate[SSIZE];      // Date string for stop
                } psrp_crontab_type;
 
@@ -262,6 +401,117 @@ typedef struct {   time_t        from;                // Start of scheduled op.
 /* Types used by PSRP handler system */
 /*-----------------------------------*/
 
+typedef struct {    uint32_t       magic;              // PSRP_FRAME_MAGIC
+                    uint32_t       length;             // Payload bytes in this frame
+                    uint32_t       flags;              // PSRP_FRAME_MORE if message continues, PSRP_FRAME_BATCH
+                    uint32_t       seq;                // Request sequence number
+               } psrp_frame_header_type;
+
+
+typedef struct psrp_sock_work_type {
+                    uint32_t       s_index;            // Session index
+                    uint32_t       gen;                // Session generation
+                    uint32_t       seq;                // Request sequence number
+                    uint32_t       flags;              // Message flags (PSRP_FRAME_BATCH)
+                    uint64_t       queued;             // Time request was queued (microseconds)
+                    size_t         size;               // Size of request
+                    int32_t        (*func)(const int32_t, const char *[]);
+                                                       // Concurrent function (or NULL)
+                    char           *request;           // Request string
+                    struct psrp_sock_work_type *next;  // Next queued request
+               } psrp_sock_work_type;
+
+
+typedef struct psrp_tag_hash_type {
+                    uint32_t       hash;               // Hash of tag
+                    uint32_t       slot_index;         // Dispatch table slot
+                    uint32_t       tag_index;          // Index in slot tag list (0 is root tag)
+                    char           *tag;               // Tag (or alias)
+                    struct psrp_tag_hash_type *next;   // Next tag in bucket
+               } psrp_tag_hash_type;
+
+
+typedef struct {    const char     *verb;              // Builtin verb
+                    int32_t        (*func)(const uint32_t, const char *[]);
+                                                       // Builtin function
+                    int32_t        bind_status;        // Bind status required (or 0)
+               } psrp_builtin_type;
+
+
+typedef struct {    uint32_t       magic;              // PSRP_RING_MAGIC
+                    uint32_t       closed;             // Writer has finished
+                    uint32_t       abandoned;          // Transfer abandoned (by either side)
+                    uint32_t       data_futex;         // Futex (reader waits for data)
+                    uint32_t       space_futex;        // Futex (writer waits for space)
+                    uint32_t       reader_waiting;     // Reader is sleeping on data_futex
+                    uint32_t       writer_waiting;     // Writer is sleeping on space_futex
+                    pid_t          writer_pid;         // PID of writer
+                    pid_t          reader_pid;         // PID of reader
+                    uint64_t       size;               // Size of data area (power of 2)
+                    uint64_t       total;              // Bytes to be transferred (0 if unknown)
+                    uint64_t       head                // Bytes written (writer only)
+                                   __attribute__ ((aligned(64)));
+                    uint64_t       tail                // Bytes read (reader only)
+                                   __attribute__ ((aligned(64)));
+               } psrp_ring_header_type;
+
+
+typedef struct {    des_t                 des;         // Ring memfd
+                    size_t                map_size;    // Size of mapping
+                    uint64_t              size;        // Size of data area (private copy)
+                    psrp_ring_header_type *header;     // Shared ring header
+                    _BYTE                 *data;       // Shared ring data area
+               } psrp_ring_type;
+
+
+typedef struct {    char           type;               // Argument type (schema character)
+                    int64_t        i;                  // PSRP_ARG_INT value
+                    double         d;                  // PSRP_ARG_DOUBLE value
+                    const _BYTE    *bytes;             // PSRP_ARG_BYTES (or PSRP_ARG_STRING) data
+                    double         *vector;            // PSRP_ARG_VECTOR elements
+                    size_t         size;               // Bytes (or vector elements)
+               } psrp_arg_type;
+
+
+typedef struct {    const char     *tag;               // Tag of typed function
+                    uint32_t       argc;               // Number of arguments
+                    psrp_arg_type  arg[PSRP_MAX_TYPED_ARGS];
+                                                       // Decoded arguments
+               } psrp_typed_args_type;
+
+
+typedef struct {    _BYTE          *buf;               // Encoded arguments
+                    size_t         size;               // Bytes used
+                    size_t         allocated;          // Bytes allocated
+               } psrp_argbuf_type;
+
+
+typedef struct {    uint64_t       count;              // Number of samples
+                    uint64_t       sum;                // Sum of samples (microseconds)
+                    uint64_t       min;                // Smallest sample
+                    uint64_t       max;                // Largest sample
+                    uint32_t       bucket[PSRP_HIST_BUCKETS];
+                                                       // Log-linear sample counts
+               } psrp_hist_type;
+
+
+typedef struct {    char           verb[PSRP_LATENCY_VERB_SIZE];
+                                                       // Request verb (or client name)
+                    psrp_hist_type phase[PSRP_LATENCY_PHASES];
+                                                       // Queue, dispatch and write histograms
+               } psrp_latency_type;
+
+
+typedef struct {    char           verb[PSRP_LATENCY_VERB_SIZE];
+                                                       // Request verb
+                    int32_t        client;             // Client slot
+                    uint32_t       seq;                // Request sequence number (0 for FIFO)
+                    uint64_t       start;              // Start of span (microseconds)
+                    int64_t        duration[PSRP_LATENCY_PHASES];
+                                                       // Phase durations (-1 if not measured)
+               } psrp_trace_span_type;
+
+
 typedef struct {    uint32_t       aliases_allocated;  // Allocated alias slots
 		    uint32_t       aliases;            // Number of aliases
 		    char           **object_tag;       // Names of PSRP object
@@ -288,6 +538,16 @@ typedef struct {    char           in_name[SSIZE];     // Name of in stream
 		} psrp_channel_type;
 
 
+typedef struct {    char              host_name[SSIZE];  // Host of slaved client ("" if local)
+                    char              ssh_port[SSIZE];   // ssh port of slaved client
+                    char              pen[SSIZE];        // PEN of slaved client
+                    psrp_channel_type *sic;              // Pooled SIC (NULL if slot free)
+                    _BOOLEAN          in_use;            // TRUE if SIC is in use
+                    time_t            last_used;         // Time SIC was last used
+                    uint64_t          reuses;            // Number of times SIC has been re-used
+               } psrp_sic_pool_type;
+
+
 /*-------------------------------------------------------------*/
 /* Variables exported by the multithreaded DLL support library */
 /*-------------------------------------------------------------*/
@@ -300,7 +560,17 @@ typedef struct {    char           in_name[SSIZE];     // Name of in stream
 /*-------------------------------------------*/
 
 _EXPORT FILE     *psrp_in;                             // PSRP input channel (from client)
-_EXPORT FILE     *psrp_out;                            // PSRP output channel (to client)
+
+
+/*-----------------------------------------------------------*/
+/* psrp_out is thread local (so concurrent functions run by  */
+/* socket transport workers write to their own reply). This  */
+/* changes the ABI: code which refers to psrp_out must be    */
+/* rebuilt against this header                               */
+/*-----------------------------------------------------------*/
+
+_EXPORT __thread FILE *psrp_out;                       // PSRP output channel (to client)
+
 _EXPORT char     channel_name_in[];                    // PSRP input channel name
 _EXPORT char     channel_name_out[];                   // PSRP ouput channel name
 _EXPORT  int32_t psrp_client_pid[MAX_CLIENTS];         // PID of PSRP client process
@@ -315,6 +585,9 @@ _EXPORT _BOOLEAN in_psrp_handler;                      // TRUE if in PSRP handle
 _EXPORT _BOOLEAN in_chan_handler;                      // TRUE if in CHAN handler
 _EXPORT          psrp_channel_type *psrp_current_sic;  // Current SIC channel
 _EXPORT          psrp_object_type  *psrp_object_list;  // List of attached PSRP objects
+_EXPORT _BOOLEAN psrp_socket_transport;                // TRUE if socket transport enabled
+_EXPORT char     psrp_socket_name[];                   // PSRP (SOCK_SEQPACKET) socket name
+_EXPORT uint32_t psrp_sock_workers;                    // Socket transport worker threads
 
 #else
 #   undef  _EXPORT
@@ -350,6 +623,15 @@ _PROTOTYPE _EXPORT void psrp_init(const int32_t, const int32_t (*)(const int32_t
 // Attach static function to PSRP handler [root thread]
 _PROTOTYPE _EXPORT int32_t psrp_attach_static_function(const char *, const void *);
 
+// Attach (thread safe) static function which may be run concurrently [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_attach_concurrent_function(const char *, const void *);
+
+// Attach static function with typed arguments [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_attach_typed_function(const char *, const char *, int32_t (*)(const psrp_typed_args_type *));
+
+// Register typed argument schema for attached (static or dynamic) function [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_set_arg_schema(const char *, const char *, int32_t (*)(const psrp_typed_args_type *));
+
 // Attach static databag to PSRP handler [root thread]
 _PROTOTYPE _EXPORT int32_t psrp_attach_static_databag(const char *, const uint64_t, const _BYTE *);
 
@@ -429,9 +711,18 @@ _PROTOTYPE _EXPORT int32_t psrp_get_type_from_handle(const void *);
 // Remove communication channels when PSRP server process exist [root thread]
 _PROTOTYPE _EXPORT void psrp_exit(void);
 
-// Get process pid from process name [root thread]
+// Get process pid from process name (registered names resolved exactly) [root thread]
 _PROTOTYPE _EXPORT pid_t psrp_pname_to_pid(const char *);
 
+// Register process name in (shared memory) process name registry [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_pnreg_register(const char *);
+
+// Remove process name from process name registry
+_PROTOTYPE _EXPORT void psrp_pnreg_unregister(void);
+
+// Look up (live) process in process name registry (PSRP_TERMINATED if not found or unreadable)
+_PROTOTYPE _EXPORT pid_t psrp_pnreg_lookup(const char *);
+
 // Get process name from pid [root thread]
 _PROTOTYPE _EXPORT _BOOLEAN psrp_pid_to_pname(const pid_t, char *);
 
@@ -460,6 +751,15 @@ _PROTOTYPE _EXPORT char *psrp_slaved_client_transaction(const _BOOLEAN, const ps
 // Destroy slaved PSRP client connection [root thread]
 _PROTOTYPE _EXPORT psrp_channel_type *psrp_destroy_slaved_interaction_client(const psrp_channel_type *, const _BOOLEAN);
 
+// Get SIC from SIC pool (re-using idle SIC to same slaved client if possible) [root thread]
+_PROTOTYPE _EXPORT psrp_channel_type *psrp_sic_pool_get(const char *, const char *, const char *);
+
+// Return SIC to SIC pool [root thread]
+_PROTOTYPE _EXPORT void psrp_sic_pool_put(psrp_channel_type *, const _BOOLEAN);
+
+// Destroy idle pooled SICs
+_PROTOTYPE _EXPORT void psrp_sic_pool_reap(const _BOOLEAN);
+
 // Assign stdio descriptors for PSRP server [root thread]
 _PROTOTYPE _EXPORT int32_t psrp_assign_stdio(const FILE *, const int32_t *, const char *[], des_t *, des_t *, des_t *);
 
@@ -551,6 +851,15 @@ _PROTOTYPE _EXPORT int32_t psrp_reset_client_exitf(const uint32_t);
 // Schedule activity in (PSRP server) crontab table [root thread]
 _PROTOTYPE _EXPORT int32_t psrp_crontab_schedule(const char *, const char *, const char *, const void *);
 
+// Schedule activity in (PSRP server) crontab table using cron expression [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_crontab_schedule_cron(const char *, const char *, const void *);
+
+// Set maximum random delay for (PSRP server) crontab activity [root thread]
+_PROTOTYPE _EXPORT int32_t psrp_crontab_set_jitter(const uint32_t, const uint32_t);
+
+// Is (PSRP server) crontab activity window open (or payload running)
+_PROTOTYPE _EXPORT _BOOLEAN psrp_crontab_active(const uint32_t);
+
 // Unschedule  PSRP server (crontab) activity[root thread]
 _PROTOTYPE _EXPORT int32_t psrp_crontab_unschedule(const uint32_t);
 
@@ -637,6 +946,93 @@ _PROTOTYPE _EXPORT int32_t psrp_client_block(const _BOOLEAN);
 // Is PEN (process execution name) unique? [root thread]
 _PROTOTYPE _EXPORT void psrp_pen_unique(void);
 
+// Send (framed) message over PSRP socket transport
+_PROTOTYPE _EXPORT int32_t psrp_sock_send(const des_t, const uint32_t, const char *, const size_t);
+
+// Send (framed) message with message flags over PSRP socket transport
+_PROTOTYPE _EXPORT int32_t psrp_sock_sendmsg(const des_t, const uint32_t, const uint32_t, const char *, const size_t);
+
+// Receive (framed) message from PSRP socket transport
+_PROTOTYPE _EXPORT ssize_t psrp_sock_recv(const des_t, uint32_t *, char **, size_t *);
+
+// Receive (framed) message and its message flags from PSRP socket transport
+_PROTOTYPE _EXPORT ssize_t psrp_sock_recvmsg(const des_t, uint32_t *, uint32_t *, char **, size_t *);
+
+// Connect to PSRP server socket transport
+_PROTOTYPE _EXPORT des_t psrp_sock_connect(const char *, const char *, int32_t *);
+
+// Send request and get reply over PSRP socket transport
+_PROTOTYPE _EXPORT ssize_t psrp_sock_request(const des_t, const uint32_t, const char *, char **, size_t *);
+
+// Pipeline (tagged) requests over PSRP socket transport
+_PROTOTYPE _EXPORT int32_t psrp_sock_pipeline(const des_t, const uint32_t, const uint32_t, const char *[], const uint32_t, char *[], size_t []);
+
+// Send batch of requests (single combined reply) over PSRP socket transport
+_PROTOTYPE _EXPORT ssize_t psrp_sock_batch(const des_t, const uint32_t, const uint32_t, const char *[], char **, size_t *);
+
+// Close PSRP socket transport connection
+_PROTOTYPE _EXPORT int32_t psrp_sock_close(const des_t);
+
+// Append integer argument to typed argument buffer
+_PROTOTYPE _EXPORT int32_t psrp_argbuf_put_int(psrp_argbuf_type *, const int64_t);
+
+// Append double argument to typed argument buffer
+_PROTOTYPE _EXPORT int32_t psrp_argbuf_put_double(psrp_argbuf_type *, const double);
+
+// Append byte blob argument to typed argument buffer
+_PROTOTYPE _EXPORT int32_t psrp_argbuf_put_bytes(psrp_argbuf_type *, const _BYTE *, const size_t);
+
+// Append string argument to typed argument buffer
+_PROTOTYPE _EXPORT int32_t psrp_argbuf_put_string(psrp_argbuf_type *, const char *);
+
+// Append vector (of doubles) argument to typed argument buffer
+_PROTOTYPE _EXPORT int32_t psrp_argbuf_put_vector(psrp_argbuf_type *, const double *, const size_t);
+
+// Release typed argument buffer
+_PROTOTYPE _EXPORT void psrp_argbuf_free(psrp_argbuf_type *);
+
+// Decode typed (binary) arguments against schema
+_PROTOTYPE _EXPORT int32_t psrp_decode_typed_args(const char *, const _BYTE *, const size_t, psrp_typed_args_type *);
+
+// Decode text arguments against schema
+_PROTOTYPE _EXPORT int32_t psrp_text_typed_args(const char *, const int32_t, const char *[], psrp_typed_args_type *);
+
+// Release storage owned by decoded typed arguments
+_PROTOTYPE _EXPORT void psrp_free_typed_args(psrp_typed_args_type *);
+
+// Send request with typed arguments over PSRP socket transport
+_PROTOTYPE _EXPORT ssize_t psrp_sock_typed_request(const des_t, const uint32_t, const char *, const psrp_argbuf_type *, char **, size_t *);
+
+// Create shared memory ring (writer side)
+_PROTOTYPE _EXPORT psrp_ring_type *psrp_ring_create(const size_t, const uint64_t);
+
+// Attach to shared memory ring created by another process (reader side)
+_PROTOTYPE _EXPORT psrp_ring_type *psrp_ring_attach(const pid_t, const des_t);
+
+// Reserve (contiguous) space in shared memory ring
+_PROTOTYPE _EXPORT ssize_t psrp_ring_reserve(psrp_ring_type *, _BYTE **, const int32_t);
+
+// Publish reserved space in shared memory ring
+_PROTOTYPE _EXPORT void psrp_ring_commit(psrp_ring_type *, const size_t);
+
+// Peek at (contiguous) data in shared memory ring
+_PROTOTYPE _EXPORT ssize_t psrp_ring_peek(psrp_ring_type *, _BYTE **, const int32_t);
+
+// Release peeked data in shared memory ring
+_PROTOTYPE _EXPORT void psrp_ring_consume(psrp_ring_type *, const size_t);
+
+// Write buffer to shared memory ring
+_PROTOTYPE _EXPORT ssize_t psrp_ring_write(psrp_ring_type *, const _BYTE *, const size_t);
+
+// Read from shared memory ring
+_PROTOTYPE _EXPORT ssize_t psrp_ring_read(psrp_ring_type *, _BYTE *, const size_t);
+
+// Close (or abandon) shared memory ring
+_PROTOTYPE _EXPORT void psrp_ring_close(psrp_ring_type *, const _BOOLEAN);
+
+// Destroy shared memory ring
+_PROTOTYPE _EXPORT psrp_ring_type *psrp_ring_destroy(psrp_ring_type *);
+
 
 #ifdef _CPLUSPLUS
 #   undef  _EXPORT
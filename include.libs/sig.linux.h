@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 2.00 
-    Dated:   5th February 2024
+    Version: 2.01 
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 ------------------------------------------------------------------------------------------*/
 
@@ -76,8 +76,8 @@ _PRIVATE char  *signame[MAX_SIGS + 1]  =  {
 				         "SIGTHREADSTOP",
 				         "SIGTHREADRESTART",
                                          "SIGCRITICAL",
-                                         "SIGRT16",
-				         "SIGRT17",
+                                         "SIGPSRPIO",
+                                         "SIGCRON",
 				         "SIGRT18",
 				         "SIGRT19",
 				         "SIGRT20",
@@ -116,6 +116,8 @@ _PRIVATE char  *signame[MAX_SIGS + 1]  =  {
 #define SIGTHREADSTOP     SIGRTMIN + 14
 #define SIGTHREADRESTART  SIGRTMIN + 15
 #define SIGCRITICAL       SIGRTMIN + 16
+#define SIGPSRPIO         SIGRTMIN + 17
+#define SIGCRON           SIGRTMIN + 18
 
 
 #endif /* SIG_LINUX */
@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------
+    Purpose: Layout of (per user) shared memory software watchdog table. One
+             softdog daemon watches every process which has a slot in the
+             table. Watched processes kick the watchdog by writing the time
+             of the kick into their slot (rather than by sending a signal)
+             so a kick costs a store, not a system call. The layout is
+             defined here so that softdog (which does not link against the
+             PUPS libraries) and the PUPS libraries agree on it.
+
+    Author:  M.A. O'Neill
+             Tumbling Dice Ltd
+             Gosforth
+             Newcastle upon Tyne
+             NE3 4RT
+             United Kingdom
+
+    Version: 1.00
+    Dated:   19th October 2026
+    E-Mail:  mao@tumblingdice.co.uk
+------------------------------------------------------------------------------*/
+
+#ifndef SOFTDOG_H
+#define SOFTDOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/*---------------------------------------------------------------*/
+/* Table is a (POSIX) shared memory object in /dev/shm. There is */
+/* one table (and one softdog daemon) per user                   */
+/*---------------------------------------------------------------*/
+
+#define SOFTDOG_TABLE_VERSION  "1.00"
+#define SOFTDOG_PATH_FMT       "/dev/shm/pups.softdog.%d"
+#define SOFTDOG_MAGIC          0x53444f47U
+#define SOFTDOG_SLOTS          1024
+
+
+/*---------------------------------------------------------------*/
+/* Slot states. Clients claim a free slot (atomic CAS), fill it  */
+/* in and then make it active. Only the daemon frees an active   */
+/* or released slot                                              */
+/*---------------------------------------------------------------*/
+
+#define SOFTDOG_FREE           0
+#define SOFTDOG_CLAIMED        1
+#define SOFTDOG_ACTIVE         2
+#define SOFTDOG_RELEASED       3
+
+
+/*---------------------------------------------------------------*/
+/* Watchdog slot. Times are in milliseconds on CLOCK_MONOTONIC   */
+/* (which is the same for every process on the host)             */
+/*---------------------------------------------------------------*/
+
+typedef struct {    uint32_t  state;                   // Slot state
+                    pid_t     pid;                     // Watched process
+                    pid_t     pgrp;                    // Watched process group ((-1) if none)
+                    uint32_t  timeout;                 // Watchdog timeout (milliseconds)
+                    uint64_t  kick;                    // Time of last kick (milliseconds)
+               } softdog_slot_type;
+
+
+/*---------------------------------------------------------------*/
+/* Clients ring the doorbell (a pwrite() of the doorbell word)   */
+/* after they change the state of a slot. The write is seen by   */
+/* inotify so the daemon rescans the table without polling it    */
+/*---------------------------------------------------------------*/
+
+typedef struct {    uint32_t           magic;          // Table magic number
+                    pid_t              daemon;         // PID of softdog daemon
+                    uint32_t           doorbell;       // Doorbell word
+                    uint32_t           slots;          // Number of slots in table
+                    softdog_slot_type  slot[SOFTDOG_SLOTS];
+                                                       // Watchdog slots
+               } softdog_table_type;
+
+#endif /* SOFTDOG_H */
@@ -8,7 +8,7 @@
              NE3 4RT
              United Kingdom
 
-    Version: 8.11
+    Version: 8.15
     Dated:   2nd January 2025 
     E-Mail:  mao@tumblingdice.co.uk
 -------------------------------------------*/
@@ -52,7 +52,7 @@
 /* Version */
 /***********/
 
-#define UTILIB_VERSION              "8.11"
+#define UTILIB_VERSION              "8.15"
 
 
 /******************/
@@ -168,6 +168,17 @@
 #define VITIMER_QUANTUM    10000
 
 
+/*-------------------------------------------------------------*/
+/* Hierarchical timer wheel for virtual interval timers (when  */
+/* built with PTHREAD_SUPPORT). Each level has 64 slots, each  */
+/* slot at level n spans 64^n ticks (of VITIMER_QUANTUM)       */
+/*-------------------------------------------------------------*/
+
+#define VT_WHEEL_BITS      6
+#define VT_WHEEL_SLOTS     (1 << VT_WHEEL_BITS)
+#define VT_WHEEL_LEVELS    6
+
+
 /*------------------------------------------------*/
 /* Backtrack exit code (from SIGSEGV backtracker) */
 /*------------------------------------------------*/
@@ -420,6 +431,12 @@ typedef struct {   int32_t  priority;                        // Priority of time
                    int32_t  interval_time;                   // Length of  interval
                    char     handler_args[SSIZE];             // Handler argument string
                    void     (*handler)(void *, char *);      // Handler function
+                   uint64_t expires;                         // Expiry tick (timer wheel)
+                   int32_t  wheel_slot;                      // Timer wheel slot (-1 if none)
+                   int32_t  next;                            // Next timer in wheel slot
+                   int32_t  prev;                            // Previous timer in wheel slot
+                   _BOOLEAN fired;                           // TRUE if expired (handler pending)
+                   int32_t  fired_next;                      // Next expired timer
                } vttab_type;
 
 
@@ -1420,6 +1437,24 @@ _PROTOTYPE _EXPORT pid_t pups_lexec(const char *, const char *, const int32_t);
 // PUPS statkill (pids of terminated or stopped processes return error)
 _PROTOTYPE _EXPORT int32_t pups_statkill(const pid_t, const  int32_t);
 
+// Open process descriptor (pidfd)
+_PROTOTYPE _EXPORT des_t pups_pidfd_open(const pid_t);
+
+// Wait (with timeout) for process to exit
+_PROTOTYPE _EXPORT int32_t pups_pid_wait(const pid_t, const int32_t);
+
+// Add process to liveness watch set
+_PROTOTYPE _EXPORT int32_t pups_pid_watch(const pid_t);
+
+// Remove process from liveness watch set
+_PROTOTYPE _EXPORT int32_t pups_pid_unwatch(const pid_t);
+
+// Collect watched processes which have exited
+_PROTOTYPE _EXPORT int32_t pups_pid_watch_poll(pid_t *, const uint32_t, const int32_t);
+
+// Reap child whose exit was missed by SIGCHLD handler
+_PROTOTYPE _EXPORT _BOOLEAN pups_reap_child(const pid_t);
+
 // Set file table id tag
 _PROTOTYPE _EXPORT int32_t pups_set_ftab_id(const des_t, const  int32_t);
 
@@ -1625,6 +1660,9 @@ _PROTOTYPE _EXPORT _BOOLEAN pups_cmd_installed(const char *);
 // Get CPU utilisation on host
 _PROTOTYPE _EXPORT FTYPE pups_cpu_utilisation(void);
 
+// Get (per CPU or aggregate) CPU utilisation on host over window
+_PROTOTYPE _EXPORT FTYPE pups_cpu_utilisation_window(const int32_t, const int32_t);
+
 // Get prefix
 _PROTOTYPE _EXPORT int32_t pups_prefix(const char, const char *, char *);
 
@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-     Version: 2.09 
-     Date:    12th December 2024
+     Version: 2.10 
+     Date:    19th October 2026
      E-mail:  mao@tumblingdice.co.uk
 ------------------------------------------------------------------------------*/
 
@@ -28,7 +28,7 @@
 /* Version */
 /***********/
 
-#define VEC3_VERSION    "2.09"
+#define VEC3_VERSION    "2.10"
 
 
 /*-------------------------------*/
@@ -83,6 +83,19 @@ typedef struct {   FTYPE comp[3][3];            // Matrix components
 
 
 
+/*----------------------------------------------------------------*/
+/* Structure of arrays (SoA) set of vector3's. Component arrays   */
+/* are contiguous and cache line aligned so that batch kernels    */
+/* vectorise. Batch kernels may be applied in place               */
+/*----------------------------------------------------------------*/
+
+typedef struct {   size_t n;                    // Number of vectors
+                   FTYPE  *comp[3];          // Component arrays
+               } vector3_soa;
+
+
+
+
 /*------------------------------------------------------------------------------
     These are the functions which are associated with the type vector3 ...
 ------------------------------------------------------------------------------*/
@@ -275,6 +288,52 @@ _PROTOTYPE _EXPORT matrix3 m3inv(matrix3 *);
 // Solve 3x3 simultaneous equations using Gaussian Elimination
 _PROTOTYPE _EXPORT _BOOLEAN m3GE_solve(uint32_t *, const matrix3 *, const vector3 *, vector3 *);
 
+
+
+/*------------------------------------------------------*/
+/* Batch (SoA) vector3 kernels. These return 0 on       */
+/* success, and -1 (with errno set) if set sizes differ */
+/*------------------------------------------------------*/
+
+// Create SoA vector3 set
+_PROTOTYPE _EXPORT vector3_soa *v3soa_create(const size_t);
+
+// Destroy SoA vector3 set
+_PROTOTYPE _EXPORT vector3_soa *v3soa_destroy(vector3_soa *);
+
+// Load SoA vector3 set from array of vector3's
+_PROTOTYPE _EXPORT int32_t v3soa_load(const size_t, const vector3 *, vector3_soa *);
+
+// Store SoA vector3 set to array of vector3's
+_PROTOTYPE _EXPORT int32_t v3soa_store(const vector3_soa *, vector3 *);
+
+// Add two SoA vector3 sets
+_PROTOTYPE _EXPORT int32_t v3soa_add(const vector3_soa *, const vector3_soa *, vector3_soa *);
+
+// Subtract SoA vector3 set from SoA vector3 set
+_PROTOTYPE _EXPORT int32_t v3soa_sub(const vector3_soa *, const vector3_soa *, vector3_soa *);
+
+// Multiply SoA vector3 set by scalar
+_PROTOTYPE _EXPORT int32_t v3soa_scalm(const FTYPE, const vector3_soa *, vector3_soa *);
+
+// Scalar (dot) products of two SoA vector3 sets
+_PROTOTYPE _EXPORT int32_t v3soa_dot(const vector3_soa *, const vector3_soa *, FTYPE *);
+
+// Magnitudes of SoA vector3 set
+_PROTOTYPE _EXPORT int32_t v3soa_mag(const vector3_soa *, FTYPE *);
+
+// Normalise SoA vector3 set (zero vectors stay zero)
+_PROTOTYPE _EXPORT int32_t v3soa_unit(const vector3_soa *, vector3_soa *);
+
+// Cross products of two SoA vector3 sets (first three components)
+_PROTOTYPE _EXPORT int32_t v3soa_cross(const vector3_soa *, const vector3_soa *, vector3_soa *);
+
+// Rotate SoA vector3 set by theta radians in plane of two components
+_PROTOTYPE _EXPORT int32_t v3soa_rot(const uint32_t, const uint32_t, const FTYPE, const vector3_soa *, vector3_soa *);
+
+// Multiply SoA vector3 set by matrix3
+_PROTOTYPE _EXPORT int32_t v3soa_mmult(const matrix3 *, const vector3_soa *, vector3_soa *);
+
 #ifdef _CPLUSPLUS
 #   undef  _EXPORT
 #   define _EXPORT extern C
@@ -9,8 +9,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 1.16
-    Dated:   10th Decemeber 2024
+    Version: 1.17
+    Dated:   19th October 2026
     E-Mail:  mao@tumblingdice.co.uk
 ----------------------------------------------------------------------------*/
 
@@ -18,7 +18,10 @@
 #include <utils.h>
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 #include <tad.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 
 #undef   __NOT_LIB_SOURCE__
 #include <casino.h>
@@ -2102,3 +2105,572 @@ _PUBLIC void gcf(FTYPE *gammcf, const FTYPE a, const FTYPE x, FTYPE *gln)
 
     *gammcf = EXP(-x + a*LOG(x) - (*gln))*h;
 }
+
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Random streams. The generator is xoshiro256** (Blackman & Vigna)  */
+/* seeded via splitmix64. All state lives in the stream object, so   */
+/* unlike ran1 .. ran5 the stream functions are reentrant, and the   */
+/* jump functions give non-overlapping substreams for threads        */
+/*-------------------------------------------------------------------*/
+
+#define RSTREAM_BLOCK       256          // Raw draws staged per bulk pass
+#define RSTREAM_DEFAULT_SEED 0x5eed5eedULL
+
+
+/*-------------------------------------------------------------*/
+/* Master seed (and its generation) for per-thread streams and */
+/* the stream id given to the next thread (the process main    */
+/* thread is always id 0)                                      */
+/*-------------------------------------------------------------*/
+
+_PRIVATE uint64_t  thread_seed            = RSTREAM_DEFAULT_SEED;
+_PRIVATE uint32_t  thread_seed_generation = 1;
+_PRIVATE uint32_t  next_stream_id         = 1;
+
+_PRIVATE __thread rstream_type thread_stream;
+_PRIVATE __thread uint32_t     thread_stream_generation = 0;
+_PRIVATE __thread uint32_t     thread_stream_id         = 0;
+_PRIVATE __thread _BOOLEAN     have_thread_stream_id    = FALSE;
+
+
+
+
+/*---------------------------------*/
+/* Rotate left (xoshiro primitive) */
+/*---------------------------------*/
+
+_PRIVATE inline uint64_t rotl(const uint64_t x, const int32_t k)
+
+{   return((x << k) | (x >> (64 - k)));
+}
+
+
+
+
+/*-------------------------------------------*/
+/* Splitmix64 (used to expand a 64 bit seed) */
+/*-------------------------------------------*/
+
+_PRIVATE inline uint64_t splitmix64(uint64_t *x)
+
+{   uint64_t z;
+
+    z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return(z ^ (z >> 31));
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Convert 64 bit draw to uniform deviate in the open (0,1)   */
+/* interval so that it can be passed to LOG without a guard.  */
+/* The double build uses the top 53 bits offset by half an    */
+/* ulp. The float build uses the top 24 bits, which are exact */
+/* in single precision and so can never round up to 1.0, with */
+/* a zero draw moved to half an ulp                           */
+/*------------------------------------------------------------*/
+
+_PRIVATE inline FTYPE to_uniform(const uint64_t x)
+
+{
+
+    #ifdef FLOAT
+    FTYPE u = (x >> 40) * 0x1.0p-24f;
+
+    return(u > 0.0f ? u : 0x1.0p-25f);
+    #else
+    return(((double)(x >> 11) + 0.5) * (1.0/9007199254740992.0));
+    #endif /* FLOAT */
+}
+
+
+
+
+/*--------------------*/
+/* Seed random stream */
+/*--------------------*/
+
+_PUBLIC void rstream_seed(rstream_type *stream, const uint64_t seed)
+
+{   uint64_t x = seed;
+
+    if(stream == (rstream_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    stream->s[0]       = splitmix64(&x);
+    stream->s[1]       = splitmix64(&x);
+    stream->s[2]       = splitmix64(&x);
+    stream->s[3]       = splitmix64(&x);
+    stream->have_gauss = FALSE;
+    stream->gauss      = 0.0;
+
+    pups_set_errno(OK);
+}
+
+
+
+
+/*------------------------------------------*/
+/* Next raw 64 bit value from random stream */
+/*------------------------------------------*/
+
+_PUBLIC uint64_t rstream_next(rstream_type *stream)
+
+{   uint64_t result,
+             t;
+
+    result        = rotl(stream->s[1] * 5, 7) * 9;
+    t             = stream->s[1] << 17;
+
+    stream->s[2] ^= stream->s[0];
+    stream->s[3] ^= stream->s[1];
+    stream->s[1] ^= stream->s[2];
+    stream->s[0] ^= stream->s[3];
+    stream->s[2] ^= t;
+    stream->s[3]  = rotl(stream->s[3], 45);
+
+    return(result);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Apply jump polynomial to random stream (advances */
+/* the stream as if rstream_next had been called    */
+/* 2^128 or 2^192 times)                            */
+/*--------------------------------------------------*/
+
+_PRIVATE void rstream_apply_jump(rstream_type *stream, const uint64_t *jump)
+
+{   uint32_t i,
+             b;
+
+    uint64_t s0 = 0,
+             s1 = 0,
+             s2 = 0,
+             s3 = 0;
+
+    for(i=0; i<4; ++i)
+    {  for(b=0; b<64; ++b)
+       {  if(jump[i] & (1ULL << b))
+          {  s0 ^= stream->s[0];
+             s1 ^= stream->s[1];
+             s2 ^= stream->s[2];
+             s3 ^= stream->s[3];
+          }
+
+          (void)rstream_next(stream);
+       }
+    }
+
+    stream->s[0]       = s0;
+    stream->s[1]       = s1;
+    stream->s[2]       = s2;
+    stream->s[3]       = s3;
+    stream->have_gauss = FALSE;
+}
+
+
+
+
+/*--------------------------------------*/
+/* Jump random stream ahead 2^128 draws */
+/*--------------------------------------*/
+
+_PUBLIC void rstream_jump(rstream_type *stream)
+
+{   _IMMORTAL const uint64_t jump[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                         0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    if(stream == (rstream_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    rstream_apply_jump(stream,jump);
+    pups_set_errno(OK);
+}
+
+
+
+
+/*--------------------------------------*/
+/* Jump random stream ahead 2^192 draws */
+/*--------------------------------------*/
+
+_PUBLIC void rstream_long_jump(rstream_type *stream)
+
+{   _IMMORTAL const uint64_t jump[4] = { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                         0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+
+    if(stream == (rstream_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    rstream_apply_jump(stream,jump);
+    pups_set_errno(OK);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Split random stream into n independent substreams. Substream */
+/* i starts i+1 jumps (2^128 draws each) beyond the parent,     */
+/* and the parent is left positioned after the last substream   */
+/* so that it may be split again without overlap                */
+/*--------------------------------------------------------------*/
+
+_PUBLIC int32_t rstream_split(rstream_type *parent, const uint32_t n, rstream_type *streams)
+
+{   uint32_t i;
+
+    if(parent == (rstream_type *)NULL || streams == (rstream_type *)NULL || n == 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    for(i=0; i<n; ++i)
+    {  rstream_jump(parent);
+       (void)memcpy((void *)&streams[i],(void *)parent,sizeof(rstream_type));
+    }
+
+    rstream_jump(parent);
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Uniform deviate in (0.0, 1.0) from random stream */
+/*--------------------------------------------------*/
+
+_PUBLIC FTYPE rstream_uniform(rstream_type *stream)
+
+{   return(to_uniform(rstream_next(stream)));
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Gaussian deviate with zero mean and given variance (polar    */
+/* Box-Muller, second deviate cached in the stream)             */
+/*--------------------------------------------------------------*/
+
+_PUBLIC FTYPE rstream_gaussian(rstream_type *stream, const FTYPE variance)
+
+{   FTYPE fac,
+          r,
+          v1,
+          v2;
+
+    if(stream->have_gauss == TRUE)
+    {  stream->have_gauss = FALSE;
+       return(stream->gauss*SQRT(variance));
+    }
+
+    do {   v1 = 2.0*rstream_uniform(stream) - 1.0;
+           v2 = 2.0*rstream_uniform(stream) - 1.0;
+           r  = v1*v1 + v2*v2;
+       } while(r >= 1.0 || r == 0.0);
+
+    fac                = SQRT(-2.0*LOG(r)/r);
+    stream->gauss      = v1*fac;
+    stream->have_gauss = TRUE;
+
+    return(v2*fac*SQRT(variance));
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Gamma deviate of (real) order a > 0 from random stream    */
+/* (Marsaglia and Tsang squeeze method, boosted for a < 1)   */
+/*-----------------------------------------------------------*/
+
+_PUBLIC FTYPE rstream_gamma(rstream_type *stream, const FTYPE a)
+
+{   FTYPE d,
+          c,
+          x,
+          v,
+          u;
+
+    if(a <= 0.0)
+    {  pups_set_errno(EDOM);
+       return(-1.0);
+    }
+
+    if(a < 1.0)
+       return(rstream_gamma(stream,a + 1.0)*POW(rstream_uniform(stream),1.0/a));
+
+    d = a - 1.0/3.0;
+    c = 1.0/SQRT(9.0*d);
+
+    while(1)
+    {  do {   x = rstream_gaussian(stream,1.0);
+              v = 1.0 + c*x;
+          } while(v <= 0.0);
+
+       v = v*v*v;
+       u = rstream_uniform(stream);
+
+       if(u < 1.0 - 0.0331*x*x*x*x)
+          return(d*v);
+
+       if(LOG(u) < 0.5*x*x + d*(1.0 - v + LOG(v)))
+          return(d*v);
+    }
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Poisson deviate of mean xm from random stream (direct method    */
+/* for small means, Lorentzian rejection as poidev otherwise). The */
+/* precomputed terms are recalculated per call so that no state is */
+/* shared between streams                                          */
+/*-----------------------------------------------------------------*/
+
+_PUBLIC FTYPE rstream_poisson(rstream_type *stream, const FTYPE xm)
+
+{   int32_t sign;
+
+    FTYPE sq,
+          alxm,
+          g,
+          em,
+          t,
+          y;
+
+    if(xm < 12.0)
+    {  g  = EXP(-xm);
+       em = -1.0;
+       t  =  1.0;
+
+       do {   em += 1.0;
+              t  *= rstream_uniform(stream);
+          } while(t > g);
+
+       return(em);
+    }
+
+    sq   = SQRT(2.0*xm);
+    alxm = LOG(xm);
+    g    = xm*alxm - LGAMMA_R(xm + 1.0,&sign);
+
+    do {   do {   y  = TAN(PI*rstream_uniform(stream));
+                  em = sq*y + xm;
+              } while(em < 0.0);
+
+           em = FLOOR(em);
+           t  = 0.9*(1.0 + y*y)*EXP(em*alxm - LGAMMA_R(em + 1.0,&sign) - g);
+       } while(rstream_uniform(stream) > t);
+
+    return(em);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Fill array with uniform deviates. Raw draws are staged in     */
+/* blocks (the generator itself is serial) and then converted in */
+/* a loop the compiler can vectorise                             */
+/*---------------------------------------------------------------*/
+
+_PUBLIC void rstream_fill_uniform(rstream_type *stream, const uint32_t n, FTYPE *x)
+
+{   uint32_t i,
+             j,
+             nb;
+
+    uint64_t raw[RSTREAM_BLOCK];
+
+    for(i=0; i<n; i += RSTREAM_BLOCK)
+    {  nb = (n - i < RSTREAM_BLOCK ? n - i : RSTREAM_BLOCK);
+
+       for(j=0; j<nb; ++j)
+          raw[j] = rstream_next(stream);
+
+       #pragma omp simd
+       for(j=0; j<nb; ++j)
+          x[i+j] = to_uniform(raw[j]);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Fill array with Gaussian deviates (zero mean, given variance) */
+/* using the trigonometric Box-Muller transform, which unlike    */
+/* the polar form has no rejection step and so vectorises        */
+/*---------------------------------------------------------------*/
+
+_PUBLIC void rstream_fill_gaussian(rstream_type *stream, const uint32_t n, const FTYPE variance, FTYPE *x)
+
+{   uint32_t i,
+             j,
+             nb,
+             np;
+
+    FTYPE    sd,
+             u[RSTREAM_BLOCK];
+
+    sd = SQRT(variance);
+    for(i=0; i<n; i += RSTREAM_BLOCK)
+    {  nb = (n - i < RSTREAM_BLOCK ? n - i : RSTREAM_BLOCK);
+       np = (nb + 1)/2;
+
+       rstream_fill_uniform(stream,2*np,u);
+
+       #pragma omp simd
+       for(j=0; j<np; ++j)
+       {  FTYPE r     = SQRT(-2.0*LOG(u[2*j]))*sd,
+                theta = 2.0*PI*u[2*j+1];
+
+          u[2*j]   = r*COS(theta);
+          u[2*j+1] = r*SIN(theta);
+       }
+
+       (void)memcpy((void *)&x[i],(void *)u,nb*sizeof(FTYPE));
+    }
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Fill array with Poisson deviates of mean xm. Small means   */
+/* use the direct method against a single precomputed         */
+/* exponential, large means draw via the rejection generator  */
+/*------------------------------------------------------------*/
+
+_PUBLIC void rstream_fill_poisson(rstream_type *stream, const uint32_t n, const FTYPE xm, FTYPE *x)
+
+{   uint32_t i;
+
+    FTYPE    g,
+             em,
+             t;
+
+    if(xm < 12.0)
+    {  g = EXP(-xm);
+
+       for(i=0; i<n; ++i)
+       {  em = -1.0;
+          t  =  1.0;
+
+          do {   em += 1.0;
+                 t  *= rstream_uniform(stream);
+             } while(t > g);
+
+          x[i] = em;
+       }
+    }
+    else
+    {  for(i=0; i<n; ++i)
+          x[i] = rstream_poisson(stream,xm);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Set master seed for per-thread streams. Threads re-derive   */
+/* their stream from the new seed on their next draw           */
+/*-------------------------------------------------------------*/
+
+_PUBLIC void rstream_set_thread_seed(const uint64_t seed)
+
+{
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&access_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    thread_seed = seed;
+    ++thread_seed_generation;
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&access_mutex);
+    #endif /* PTHREAD_SUPPORT */
+}
+
+
+
+
+/*----------------------------------------------------------------*/
+/* Get random stream private to calling thread. The stream is the */
+/* master stream jumped ahead by the thread's stream id. The id   */
+/* is thread-local and is fixed the first time the thread asks    */
+/* for a stream: the process main thread is id 0 and every other  */
+/* thread (OpenMP team member or not) takes the next free id. A   */
+/* team thread number is not used, as it is reused by nested and  */
+/* concurrent teams, which would then share a stream              */
+/*----------------------------------------------------------------*/
+
+_PRIVATE uint32_t rstream_thread_index(void)
+
+{   if(have_thread_stream_id == FALSE)
+    {  if(syscall(SYS_gettid) != getpid())
+          thread_stream_id = __atomic_fetch_add(&next_stream_id,1,__ATOMIC_RELAXED);
+
+       have_thread_stream_id = TRUE;
+    }
+
+    return(thread_stream_id);
+}
+
+
+_PUBLIC rstream_type *rstream_thread(void)
+
+{   uint32_t i,
+             index;
+
+    if(thread_stream_generation != thread_seed_generation)
+    {  index = rstream_thread_index();
+
+       rstream_seed(&thread_stream,thread_seed);
+       for(i=0; i<index; ++i)
+          rstream_jump(&thread_stream);
+
+       thread_stream_generation = thread_seed_generation;
+    }
+
+    return(&thread_stream);
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Uniform deviate from calling thread's stream. This has the same */
+/* signature as ran1 .. ran3 so it can be passed to gasdev, gamdev */
+/* poidev etc. where those are called from more than one thread    */
+/*-----------------------------------------------------------------*/
+
+_PUBLIC FTYPE rstream_ran(void)
+
+{   return(rstream_uniform(rstream_thread()));
+}
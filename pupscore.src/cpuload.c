@@ -1,5 +1,8 @@
 /*----------------------------------------------------
-    Purpose: Compute CPU loading using mpstat untility
+    Purpose: Compute CPU loading by sampling the (per CPU) counters
+             in /proc/stat. Per CPU and aggregate utilisation (over
+             instantaneous, short and long windows) is published in
+             shared memory (see cpustat.h)
 
     Author:  Mark A. O'Neill
              Tumbling Dice Ltd
@@ -8,8 +11,8 @@
              NE3 4RT
              Tyne and Wear
 
-    Version: 1.04
-    Dated:   10th Decemeber 2024
+    Version: 1.05
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 ---------------------------------------------------*/
 
@@ -22,20 +25,37 @@
 #include <sys/stat.h>
 #include <signal.h>
 #include <fcntl.h>
+#include <time.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/file.h>
 #include <xtypes.h>
 #include <dirent.h>
+#include <cpustat.h>
 
 
 /*---------*/
 /* Defines */
 /*---------*/
 
-#define CPULOAD_VERSION  "1.03"
+#define CPULOAD_VERSION  "1.05"
 #define SSIZE            2048
-#define WINDOW_SIZE      32 
+#define DEFAULT_PERIOD   1000
+#define DEFAULT_SHORT    8
+#define DEFAULT_LONG     32
+#define HOMEOSTAT_PERIOD 30
 #define _PUBLIC
 
 
+/*-------------------------------------------*/
+/* Snapshot of (cumulative) /proc/stat ticks */
+/*-------------------------------------------*/
+
+typedef struct {    uint64_t total;                      // Total ticks
+                    uint64_t busy;                       // Busy (not idle or iowait) ticks
+               } counter_type;
+
+
 /*------------------*/
 /* Global variables */
 /*------------------*/
@@ -43,10 +63,21 @@
 _PRIVATE char  boldOn [8]  = "\e[1m",                  // Make character bold
                boldOff[8]  = "\e[m" ;                  // Make character non-bold
 
-_PRIVATE FILE  *pstream             = (FILE *)NULL;
-_PRIVATE FILE  *stream              = (FILE *)NULL;
-_PRIVATE char  linkName[SSIZE]      = "";
-_PRIVATE float loading[WINDOW_SIZE] = { 0.0 };
+_PRIVATE FILE     *stream              = (FILE *)NULL;
+_PRIVATE char     linkName[SSIZE]      = "";
+_PRIVATE uint32_t n_cpus               = 0;
+_PRIVATE uint32_t period               = DEFAULT_PERIOD;
+_PRIVATE int32_t  cpustat_des          = (-1);    // Utilisation table (locked while we publish it)
+_PRIVATE uint32_t window[CPUSTAT_WINDOWS]
+                                       = { 1, DEFAULT_SHORT, DEFAULT_LONG };
+
+
+/*---------------------------------------------------------*/
+/* Ring of counter snapshots (last column is the aggregate */
+/* over all CPUs)                                          */
+/*---------------------------------------------------------*/
+
+_PRIVATE counter_type history[CPUSTAT_MAX_WINDOW + 1][CPUSTAT_MAX_CPUS + 1];
 
 
 /*----------------*/
@@ -57,10 +88,6 @@ _PRIVATE int32_t sigHandler(int32_t signum)
 
 {    struct stat buf;
 
-     if(pstream != (FILE *)NULL)
-        (void)fclose(pstream);
-
-
      if(stream != (FILE *)NULL)
         (void)fclose(stream);
 
@@ -91,6 +118,15 @@ _PRIVATE int32_t sigHandler(int32_t signum)
 
         (void)unlink("/tmp/cpuload.pid");
         (void)unlink("/tmp/.cpuload.pid");
+
+
+        /*------------------------------------------*/
+        /* Only the publisher (which holds the lock */
+        /* on it) removes the utilisation table     */
+        /*------------------------------------------*/
+
+        if(cpustat_des != (-1))
+           (void)unlink(CPUSTAT_PATH);
      }
 
      (void)fprintf(stderr,"    cpuload: finished (%d remaining usage cases)\n",buf.st_nlink - 2);
@@ -102,37 +138,209 @@ _PRIVATE int32_t sigHandler(int32_t signum)
 
 
 
-/*----------------------------*/
-/* Window average CPU loading */
-/*----------------------------*/
+/*-------------------------------------------------------*/
+/* Read (per CPU and aggregate) counters from /proc/stat */
+/*-------------------------------------------------------*/
 
-_PRIVATE float window_average_loading(uint32_t    cnt, float next_loading)
+_PRIVATE _BOOLEAN read_cpu_counters(counter_type *counter)
 
-{   uint32_t i;
-    float    sum = 0.0;
-    
-    if(cnt < WINDOW_SIZE)
-    {  loading[cnt] = next_loading;
- 
-       for(i=0; i<cnt+1; ++i)
-          sum += loading[i];
+{   FILE *pstat      = (FILE *)NULL;
+    char line[SSIZE] = "";
+
+    if((pstat = fopen("/proc/stat","r")) == (FILE *)NULL)
+       return(FALSE);
 
-       if(sum > 0.0)
-          sum /= (float)(cnt + 1);
+
+    /*------------------------------------------------*/
+    /* CPUs which are offline have no line (and count */
+    /* as idle)                                       */
+    /*------------------------------------------------*/
+
+    (void)memset((void *)counter,0,(CPUSTAT_MAX_CPUS + 1)*sizeof(counter_type));
+
+    while(fgets(line,SSIZE,pstat) != (char *)NULL)
+    {  int32_t  cpu,
+                index;
+       uint64_t user      = 0,
+                nice      = 0,
+                system    = 0,
+                idle      = 0,
+                iowait    = 0,
+                irq       = 0,
+                softirq   = 0,
+                steal     = 0;
+
+
+       /*---------------------------------------*/
+       /* CPU lines come first in /proc/stat    */
+       /*---------------------------------------*/
+
+       if(strncmp(line,"cpu",3) != 0)
+          break;
+
+       if(line[3] == ' ')
+          index = CPUSTAT_MAX_CPUS;
+       else if(sscanf(&line[3],"%d",&cpu) == 1 && cpu >= 0 && cpu < CPUSTAT_MAX_CPUS)
+       {  index = cpu;
+
+          if(cpu + 1 > n_cpus)
+             n_cpus = cpu + 1;
+       }
+       else
+          continue;
+
+       (void)sscanf(strchr(line,' '),"%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64,&user,&nice,&system,&idle,&iowait,&irq,&softirq,&steal);
+
+       counter[index].total = user + nice + system + idle + iowait + irq + softirq + steal;
+       counter[index].busy  = counter[index].total - idle - iowait;
     }
 
-    else
-    {  loading[cnt % WINDOW_SIZE] = next_loading;
- 
-       for(i=0; i<WINDOW_SIZE; ++i)
-          sum += loading[i];
-       sum /= (float)WINDOW_SIZE;
+    (void)fclose(pstat);
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------*/
+/* Utilisation (percent) over window (in samples) ending */
+/* at current sample                                     */
+/*-------------------------------------------------------*/
+
+_PRIVATE float window_utilisation(uint64_t cnt, uint32_t window, uint32_t index)
+
+{   uint64_t     total,
+                 busy;
+    counter_type *now  = (counter_type *)NULL,
+                 *then = (counter_type *)NULL;
+
+    if(window > cnt)
+       window = cnt;
+
+    if(window == 0)
+       return(0.0);
+
+    now  = &history[cnt          % (CPUSTAT_MAX_WINDOW + 1)][index];
+    then = &history[(cnt - window) % (CPUSTAT_MAX_WINDOW + 1)][index];
+
+    if(now->total <= then->total || now->busy < then->busy)
+       return(0.0);
+
+    total = now->total - then->total;
+    busy  = now->busy  - then->busy;
+
+    return(100.0*(float)busy/(float)total);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Map shared memory utilisation table. Failing to map it  */
+/* is not fatal -- we simply do not publish. Only one      */
+/* cpuload (the one holding the table lock) publishes      */
+/*---------------------------------------------------------*/
+
+_PRIVATE cpustat_type *cpustat_map(void)
+
+{   int32_t      fdes;
+    struct stat  buf;
+    cpustat_type *table = (cpustat_type *)NULL;
+
+    if((fdes = open(CPUSTAT_PATH,O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC,0644)) == (-1))
+       return((cpustat_type *)NULL);
+
+
+    /*-------------------------------------------------*/
+    /* Table must belong to us and another cpuload     */
+    /* must not be publishing it                       */
+    /*-------------------------------------------------*/
+
+    if(fstat(fdes,&buf) == (-1) || buf.st_uid != getuid() || flock(fdes,LOCK_EX | LOCK_NB) == (-1))
+    {  (void)close(fdes);
+       return((cpustat_type *)NULL);
+    }
+
+    (void)fchmod(fdes,0644);
+    if(ftruncate(fdes,sizeof(cpustat_type)) == (-1))
+    {  (void)close(fdes);
+       return((cpustat_type *)NULL);
+    }
+
+    table = (cpustat_type *)mmap((void *)NULL,sizeof(cpustat_type),PROT_READ | PROT_WRITE,MAP_SHARED,fdes,0);
+    if((void *)table == MAP_FAILED)
+    {  (void)close(fdes);
+       return((cpustat_type *)NULL);
+    }
+
+
+    /*-------------------------------------------------*/
+    /* Previous publisher died mid update -- make the  */
+    /* sequence number even again                      */
+    /*-------------------------------------------------*/
+
+    if(__atomic_load_n(&table->seq,__ATOMIC_ACQUIRE) & 1)
+       (void)__atomic_add_fetch(&table->seq,1,__ATOMIC_RELEASE);
+
+
+    /*-------------------------------------------------*/
+    /* Keep descriptor open (it holds the table lock)  */
+    /*-------------------------------------------------*/
+
+    cpustat_des = fdes;
+    return(table);
+}
+
+
+
+
+/*---------------------------------------------------*/
+/* Publish utilisation (and load averages) in shared */
+/* memory                                            */
+/*---------------------------------------------------*/
+
+_PRIVATE void cpustat_publish(cpustat_type *table, uint64_t cnt)
+
+{   uint32_t i,
+             j;
+    FILE     *pload = (FILE *)NULL;
+    float    loadavg[3] = { 0.0, 0.0, 0.0 };
+
+    if((pload = fopen("/proc/loadavg","r")) != (FILE *)NULL)
+    {  (void)fscanf(pload,"%f%f%f",&loadavg[0],&loadavg[1],&loadavg[2]);
+       (void)fclose(pload);
     }
 
-    return(sum);
+
+    /*----------------------------------------------------*/
+    /* Sequence number is odd while table is inconsistent */
+    /*----------------------------------------------------*/
+
+    (void)__atomic_add_fetch(&table->seq,1,__ATOMIC_ACQ_REL);
+
+    table->publisher = getpid();
+    table->period    = period;
+    table->updated   = (int64_t)time((time_t *)NULL);
+    table->n_cpus    = n_cpus;
+
+    for(j=0; j<CPUSTAT_WINDOWS; ++j)
+    {  table->window[j]    = window[j];
+       table->aggregate[j] = window_utilisation(cnt,window[j],CPUSTAT_MAX_CPUS);
+
+       for(i=0; i<n_cpus; ++i)
+          table->cpu[i][j] = window_utilisation(cnt,window[j],i);
+    }
+
+    for(i=0; i<3; ++i)
+       table->loadavg[i] = loadavg[i];
+
+    __atomic_store_n(&table->magic,CPUSTAT_MAGIC,__ATOMIC_RELAXED);
+    (void)__atomic_add_fetch(&table->seq,1,__ATOMIC_RELEASE);
 }
 
 
+
+
 /*------------------------*/
 /* Remove stale links and */
 /* repair critical files  */
@@ -228,13 +436,10 @@ _PRIVATE void file_homeostat()
 
 _PUBLIC int32_t main(int32_t argc, char *argv[])
 
-{   int64_t cnt                = 0;
-
-    char    strdum[SSIZE]      = "",
-            mpstat_cmd[SSIZE]  = "";
-
-    float next_loading         = 0.0,
-          average_loading      = 0.0;
+{   uint64_t        cnt      = 0;
+    int32_t         i;
+    struct timespec next;
+    cpustat_type    *table   = (cpustat_type *)NULL;
 
 
     /*------*/
@@ -250,19 +455,48 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        (void)fprintf(stderr,"See the GPL and LGPL licences at www.gnu.org for further details\n");
        (void)fprintf(stderr,"CPULOAD comes with ABSOLUTELY NO WARRANTY\n\n");
 
-       (void)fprintf(stderr,"\nusage: cpuload [2> log/status file]\n\n");
+       (void)fprintf(stderr,"\nusage: cpuload [-period <sample period ms:%d>]\n",DEFAULT_PERIOD);
+       (void)fprintf(stderr,"               [-short_window <samples:%d>]\n",DEFAULT_SHORT);
+       (void)fprintf(stderr,"               [-long_window <samples:%d>]\n",DEFAULT_LONG);
+       (void)fprintf(stderr,"               [2> log/status file]\n\n");
        (void)fflush(stderr);
 
        exit(255);
     }
 
 
-    /*----------------------------------*/
-    /* Unparsed command line parameters */
-    /*----------------------------------*/
+    /*-------------------------------------------*/
+    /* Sample period and (short and long) window */
+    /* sizes                                     */
+    /*-------------------------------------------*/
+
+    for(i=1; i<argc; ++i)
+    {  int32_t value;
+
+       if(i + 1 < argc && sscanf(argv[i + 1],"%d",&value) == 1)
+       {  if(strcmp(argv[i],"-period") == 0 && value > 0)
+          {  period = value;
+             ++i;
+             continue;
+          }
+          else if(strcmp(argv[i],"-short_window") == 0 && value > 0 && value <= CPUSTAT_MAX_WINDOW)
+          {  window[CPUSTAT_SHORT] = value;
+             ++i;
+             continue;
+          }
+          else if(strcmp(argv[i],"-long_window") == 0 && value > 0 && value <= CPUSTAT_MAX_WINDOW)
+          {  window[CPUSTAT_LONG] = value;
+             ++i;
+             continue;
+          }
+       }
+
 
-    else if(argc > 1)
-    {  (void)fprintf(stderr,"\n    cpuload %sERROR%s: unparsed command line paramters\n\n",boldOn,boldOff);
+       /*----------------------------------*/
+       /* Unparsed command line parameters */
+       /*----------------------------------*/
+
+       (void)fprintf(stderr,"\n    cpuload %sERROR%s: unparsed (or invalid) command line paramters\n\n",boldOn,boldOff);
        (void)fflush(stderr);
 
        exit(255);
@@ -403,17 +637,16 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
     }
 
 
-    /*---------------------------------*/
-    /* Collect loading statistics once */
-    /* per second                      */
-    /*---------------------------------*/
+    /*-----------------------------------------------*/
+    /* Map shared memory utilisation table. If we    */
+    /* cannot map it (e.g. it belongs to another     */
+    /* user or another cpuload is publishing it) we  */
+    /* still maintain /tmp/cpuloading                */
+    /*-----------------------------------------------*/
 
-    (void)strlcpy(mpstat_cmd,"bash -c \"mpstat 1\"",SSIZE);
-    if((pstream = popen(mpstat_cmd,"r")) == (FILE *)NULL)
-    {  (void)fprintf(stderr,"\n    cpuload %sERROR%s: could not start mpstat command\n\n",boldOn,boldOff);
+    if((table = cpustat_map()) == (cpustat_type *)NULL)
+    {  (void)fprintf(stderr,"    cpuload: could not map %s (utilisation table will not be published)\n",CPUSTAT_PATH);
        (void)fflush(stderr);
-
-       exit(255);
     }
 
 
@@ -428,27 +661,54 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        exit(255);
     }
 
-    while(TRUE)
-    {   char line[SSIZE] = "";
+    (void)fprintf(stderr,"    cpuload: sampling /proc/stat every %d milliseconds (windows %d/%d samples)\n",
+                                                         period,window[CPUSTAT_SHORT],window[CPUSTAT_LONG]);
+    (void)fflush(stderr);
+
 
-        (void)fgets(line,SSIZE,pstream);
+    /*------------------------------------------------*/
+    /* Sample (per CPU) counters in /proc/stat once   */
+    /* per period. Sleep to absolute deadlines so the */
+    /* sample period does not drift                   */
+    /*------------------------------------------------*/
 
-        if(sscanf(line,"%s%s%f",strdum,strdum,&next_loading) == 3)
-        {  average_loading = window_average_loading(cnt,next_loading);
-           ++cnt; 
+    (void)read_cpu_counters(history[0]);
+    (void)clock_gettime(CLOCK_MONOTONIC,&next);
 
-           (void)fprintf(stream,"%5.2f\n",average_loading);
-           (void)fflush(stream);
-           (void)rewind(stream);
+    while(TRUE)
+    {   next.tv_sec  += period / 1000;
+        next.tv_nsec += (period % 1000)*1000000L;
+
+        if(next.tv_nsec >= 1000000000L)
+        {  ++next.tv_sec;
+           next.tv_nsec -= 1000000000L;
         }
 
+        while(clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,(struct timespec *)NULL) != 0)
+           continue;
+
+        ++cnt;
+        if(read_cpu_counters(history[cnt % (CPUSTAT_MAX_WINDOW + 1)]) == FALSE)
+           (void)memcpy((void *)history[cnt       % (CPUSTAT_MAX_WINDOW + 1)],
+                        (void *)history[(cnt - 1) % (CPUSTAT_MAX_WINDOW + 1)],
+                        (CPUSTAT_MAX_CPUS + 1)*sizeof(counter_type));
+
+        if(table != (cpustat_type *)NULL)
+           cpustat_publish(table,cnt);
+
+        (void)fprintf(stream,"%5.2f\n",window_utilisation(cnt,window[CPUSTAT_LONG],CPUSTAT_MAX_CPUS));
+        (void)fflush(stream);
+        (void)rewind(stream);
+
 
-        /*---------------------------*/
-        /* Reap any dead links       */
-        /* and repair critical files */
-        /*---------------------------*/
+        /*------------------------------------------*/
+        /* Reap any dead links and repair critical  */
+        /* files (this does not need to be done on  */
+        /* every sample)                            */
+        /*------------------------------------------*/
 
-        file_homeostat();
+        if(cnt % HOMEOSTAT_PERIOD == 0)
+           file_homeostat();
     }    
 
 
@@ -19,5 +19,5 @@
 /* are dynamic PSRP action functions                           */
 /*-------------------------------------------------------------*/
 
-_IMPORT FILE *psrp_in,
-             *psrp_out;
+_IMPORT FILE          *psrp_in;
+_IMPORT __thread FILE *psrp_out;
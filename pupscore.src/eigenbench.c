@@ -0,0 +1,282 @@
+/*------------------------------------------------------------------
+    Purpose: Benchmark batched (generate_weight_matrix) against
+             per-pattern (generate_weight_vector) eigenspace projection
+
+     Author:  M.A. O'Neill
+              Tumbling Dice Ltd
+              Gosforth
+              Newcastle upon Tyne
+              NE3 4RT
+              United Kingdom
+
+    Version: 1.00
+    Dated:   19th October 2026
+    E-mail:  mao@tumblingdice.co.uk
+------------------------------------------------------------------*/
+
+#include <me.h>
+#include <utils.h>
+#include <eigen.h>
+#include <ftype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <math.h>
+
+
+/*-----------------------------*/
+/* Version of this application */
+/*-----------------------------*/
+
+#define EIGENBENCH_VERSION    "1.00"
+
+
+
+
+/*----------------------------------------------*/
+/* Get application information for slot manager */
+/*----------------------------------------------*/
+/*---------------------------*/
+/* Slot information function */
+/*---------------------------*/
+
+_PRIVATE void eigenbench_slot(int32_t level)
+{   (void)fprintf(stderr,"int app eigenbench %s: [ANSI C]\n",EIGENBENCH_VERSION);
+
+    if(level > 1)
+    {  (void)fprintf(stderr,"(C) 2026 Tumbling Dice\n");
+       (void)fprintf(stderr,"Author: M.A. ONeill\n");
+       (void)fprintf(stderr,"Eigenspace projection benchmark (gcc %s: built %s %s)\n\n",__VERSION__,__TIME__,__DATE__);
+    }
+    else
+       (void)fprintf(stderr,"\n");
+
+    (void)fflush(stderr);
+}
+
+
+
+
+/*----------------------------*/
+/* Application usage function */
+/*----------------------------*/
+
+_PRIVATE void eigenbench_usage(void)
+
+{   (void)fprintf(stderr,"[-patterns <number of patterns:10000>]\n");
+    (void)fprintf(stderr,"[-size <pattern size:1024>]\n");
+    (void)fprintf(stderr,"[-nse <number of eigenpatterns:32>]\n");
+    (void)fprintf(stderr,"[-iterations <timed iterations:5>]\n\n");
+    (void)fprintf(stderr,"[>& <ASCII log file>]\n\n");
+    (void)fflush(stderr);
+}
+
+
+#ifdef SLOT
+#include <slotman.h>
+_EXTERN void (* SLOT)() __attribute__ ((aligned(16))) = eigenbench_slot;
+_EXTERN void (* USE )() __attribute__ ((aligned(16))) = eigenbench_usage;
+#endif /* SLOT */
+
+
+
+
+/*------------------------*/
+/* Application build date */
+/*------------------------*/
+
+_EXTERN char appl_build_time[SSIZE] = __TIME__;
+_EXTERN char appl_build_date[SSIZE] = __DATE__;
+
+
+
+
+/*--------------------------------------------------------------------------*/
+/* Software I.D. tag (used if CKPT support enabled to discard stale dynamic */
+/* checkpoint files)                                                        */
+/*--------------------------------------------------------------------------*/
+
+#define VTAG  1
+
+extern int32_t appl_vtag = VTAG;
+
+
+
+
+/*------------------*/
+/* Main entry point */
+/*------------------*/
+
+_PUBLIC  int32_t pups_main(int argc, char *argv[])
+
+{   int32_t i,
+            j,
+            iter,
+            n_patterns   = 10000,
+            pattern_size = 1024,
+            nse          = 32,
+            iterations   = 5;
+
+    double  start,
+            t_vector     = 0.0,
+            t_matrix     = 0.0,
+            max_diff     = 0.0;
+
+    FTYPE   **pattern      = (FTYPE **)NULL,
+            **eigenpattern = (FTYPE **)NULL,
+            **weight       = (FTYPE **)NULL;
+
+    ematrix_type *p_block  = (ematrix_type *)NULL,
+                 *e_block  = (ematrix_type *)NULL,
+                 *w_block  = (ematrix_type *)NULL;
+
+
+    /*------------------------------------------*/
+    /* Get standard items form the command tail */
+    /*------------------------------------------*/
+
+    pups_std_init(TRUE,
+                  &argc,
+                  EIGENBENCH_VERSION,
+                  "M.A. O'Neill",
+                  "eigenbench",
+                  "2026",
+                  argv);
+
+    if((ptr = pups_locate(&init,"patterns",&argc,args,0)) != NOT_FOUND)
+    {  if((n_patterns = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || n_patterns < 1)
+          pups_error("[eigenbench] expecting number of patterns");
+    }
+
+    if((ptr = pups_locate(&init,"size",&argc,args,0)) != NOT_FOUND)
+    {  if((pattern_size = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || pattern_size < 1)
+          pups_error("[eigenbench] expecting pattern size");
+    }
+
+    if((ptr = pups_locate(&init,"nse",&argc,args,0)) != NOT_FOUND)
+    {  if((nse = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || nse < 1)
+          pups_error("[eigenbench] expecting number of eigenpatterns");
+    }
+
+    if((ptr = pups_locate(&init,"iterations",&argc,args,0)) != NOT_FOUND)
+    {  if((iterations = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || iterations < 1)
+          pups_error("[eigenbench] expecting number of iterations");
+    }
+
+
+    /*---------------------------------------*/
+    /* Complain about any unparsed arguments */
+    /*---------------------------------------*/
+
+    pups_t_arg_errs(argd,args);
+
+
+    /*-------------------------------------------------------*/
+    /* Random patterns and (random) orthogonal-ish basis. We */
+    /* only care about timing and agreement here, not about  */
+    /* the basis being a real PCA basis                      */
+    /*-------------------------------------------------------*/
+
+    (void)srand48((long)getpid());
+
+    pattern      = (FTYPE **)pups_calloc(n_patterns,sizeof(FTYPE *));
+    eigenpattern = (FTYPE **)pups_calloc(nse,sizeof(FTYPE *));
+    weight       = (FTYPE **)pups_calloc(n_patterns,sizeof(FTYPE *));
+
+    for(i=0; i<n_patterns; ++i)
+    {  pattern[i] = (FTYPE *)pups_calloc(pattern_size,sizeof(FTYPE));
+
+       for(j=0; j<pattern_size; ++j)
+          pattern[i][j] = (FTYPE)drand48();
+    }
+
+    for(i=0; i<nse; ++i)
+    {  eigenpattern[i] = (FTYPE *)pups_calloc(pattern_size,sizeof(FTYPE));
+
+       for(j=0; j<pattern_size; ++j)
+          eigenpattern[i][j] = (FTYPE)(drand48() - 0.5);
+    }
+
+    if((p_block = ematrix_load(n_patterns,pattern_size,pattern)) == (ematrix_type *)NULL ||
+       (e_block = ematrix_load(nse,pattern_size,eigenpattern))   == (ematrix_type *)NULL  )
+       pups_error("[eigenbench] failed to allocate contiguous pattern matrices");
+
+    (void)fprintf(stderr,"\n    eigenbench %s: %d patterns, pattern size %d, %d eigenpatterns, %d iterations",
+                                         EIGENBENCH_VERSION,n_patterns,pattern_size,nse,iterations);
+
+    #ifdef _OPENMP
+    (void)fprintf(stderr,", %d OMP threads\n\n",omp_get_max_threads());
+    #else
+    (void)fprintf(stderr,"\n\n");
+    #endif /* _OPENMP */
+
+    (void)fflush(stderr);
+
+    for(iter=0; iter<iterations; ++iter)
+    {
+
+       /*---------------------------*/
+       /* Per-pattern (GEMV) method */
+       /*---------------------------*/
+
+       start = millitime();
+       for(i=0; i<n_patterns; ++i)
+          weight[i] = generate_weight_vector(nse,pattern_size,pattern[i],eigenpattern);
+       t_vector += millitime() - start;
+
+
+       /*-----------------------*/
+       /* Batched (GEMM) method */
+       /*-----------------------*/
+
+       start   = millitime();
+       w_block = generate_weight_matrix(nse,p_block,e_block);
+       t_matrix += millitime() - start;
+
+
+       /*---------------------------------------*/
+       /* Check that both methods agree (scaled */
+       /* by magnitude of projection)           */
+       /*---------------------------------------*/
+
+       for(i=0; i<n_patterns; ++i)
+       {  for(j=0; j<nse; ++j)
+          {  double diff = FABS(weight[i][j] - EMAT(w_block,i,j))/(1.0 + FABS(weight[i][j]));
+
+             if(diff > max_diff)
+                max_diff = diff;
+          }
+
+          (void)pups_free((void *)weight[i]);
+       }
+
+       w_block = ematrix_destroy(w_block);
+    }
+
+    (void)fprintf(stderr,"    per-pattern (generate_weight_vector): %10.6f secs/iteration (%10.1f patterns/sec)\n",
+                                                         t_vector/iterations,n_patterns*iterations/t_vector);
+    (void)fprintf(stderr,"    batched     (generate_weight_matrix): %10.6f secs/iteration (%10.1f patterns/sec)\n",
+                                                         t_matrix/iterations,n_patterns*iterations/t_matrix);
+    (void)fprintf(stderr,"    speedup: %6.2f, maximum relative difference: %g\n\n",t_vector/t_matrix,max_diff);
+    (void)fflush(stderr);
+
+
+    /*----------------------*/
+    /* Clean up and go home */
+    /*----------------------*/
+
+    for(i=0; i<n_patterns; ++i)
+       (void)pups_free((void *)pattern[i]);
+
+    for(i=0; i<nse; ++i)
+       (void)pups_free((void *)eigenpattern[i]);
+
+    (void)pups_free((void *)pattern);
+    (void)pups_free((void *)eigenpattern);
+    (void)pups_free((void *)weight);
+
+    (void)ematrix_destroy(p_block);
+    (void)ematrix_destroy(e_block);
+
+    pups_exit(0);
+}
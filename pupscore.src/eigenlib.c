@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 1.05
-    Dated:   10th December 2024
+    Version: 1.06
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 
     Some routines here are derived from those given in Press et al (Numerical
@@ -22,6 +22,7 @@
 #include <casino.h>
 #include <errno.h>
 #include <string.h>
+#include <stdlib.h>
 
 
 /*----------------------------------------*/
@@ -49,6 +50,21 @@ _PRIVATE FTYPE sqrarg;
 #endif /* SQR */
 
 
+/*------------------------------------------------------------*/
+/* Blocking factors for the contiguous PCA path. EIGEN_MB is  */
+/* the edge of a covariance tile, EIGEN_KB the depth of the   */
+/* pattern panel streamed through it (a pair of panels fits   */
+/* in L2 cache). Matrices smaller than EIGEN_PAR_MIN are not  */
+/* worth forking a thread team for                            */
+/*------------------------------------------------------------*/
+
+#define EIGEN_MB       64
+#define EIGEN_KB       512
+#define EIGEN_ALIGN    64
+#define EIGEN_PAR_MIN  128
+#define EIGEN_MAX_ITER 30
+
+
 
 
 /*-------------------------------------------------*/
@@ -200,7 +216,7 @@ _PUBLIC void tred2(_BOOLEAN eigenvectors, FTYPE **a, int32_t n, FTYPE *d, FTYPE
           g,
           f;
 
-    for(i=n-1; i>=2; i--)
+    for(i=n; i>=2; i--)
     {  l = i-1;
        h = scale=0.0;
 
@@ -599,3 +615,760 @@ _PUBLIC FTYPE *generate_weight_vector(int32_t nse,  int32_t pattern_size, FTYPE
 
     return(weight);
 }
+
+
+
+
+/*------------------------------------------------------------*/
+/* Create contiguous row-major matrix (rows are padded so     */
+/* that each starts on a cache line boundary)                 */
+/*------------------------------------------------------------*/
+
+_PUBLIC ematrix_type *ematrix_create(const int32_t rows, const int32_t cols)
+
+{   int32_t      pad;
+    size_t       size;
+    ematrix_type *m = (ematrix_type *)NULL;
+
+    if(rows <= 0 || cols <= 0)
+    {  pups_set_errno(EINVAL);
+       return((ematrix_type *)NULL);
+    }
+
+    if((m = (ematrix_type *)pups_calloc(1,sizeof(ematrix_type))) == (ematrix_type *)NULL)
+       return((ematrix_type *)NULL);
+
+    pad     = EIGEN_ALIGN/sizeof(FTYPE);
+    m->rows = rows;
+    m->cols = cols;
+    m->ld   = ((cols + pad - 1)/pad)*pad;
+    size    = (size_t)rows*(size_t)m->ld*sizeof(FTYPE);
+
+    if(posix_memalign((void **)&m->data,EIGEN_ALIGN,size) != 0)
+    {  (void)pups_free((void *)m);
+
+       pups_set_errno(ENOMEM);
+       return((ematrix_type *)NULL);
+    }
+
+    (void)memset((void *)m->data,0,size);
+
+    pups_set_errno(OK);
+    return(m);
+}
+
+
+
+
+/*-------------------------------------*/
+/* Destroy contiguous row-major matrix */
+/*-------------------------------------*/
+
+_PUBLIC ematrix_type *ematrix_destroy(ematrix_type *m)
+
+{   if(m == (ematrix_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((ematrix_type *)NULL);
+    }
+
+    if(m->data != (FTYPE *)NULL)
+       (void)pups_free((void *)m->data);
+
+    (void)pups_free((void *)m);
+
+    pups_set_errno(OK);
+    return((ematrix_type *)NULL);
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Pack (0 based) pattern vectors into a contiguous matrix   */
+/*-----------------------------------------------------------*/
+
+_PUBLIC ematrix_type *ematrix_load(const int32_t n_patterns, const int32_t pattern_size, FTYPE **pattern_matrix)
+
+{   int32_t      i;
+    ematrix_type *m = (ematrix_type *)NULL;
+
+    if(pattern_matrix == (FTYPE **)NULL)
+    {  pups_set_errno(EINVAL);
+       return((ematrix_type *)NULL);
+    }
+
+    if((m = ematrix_create(n_patterns,pattern_size)) == (ematrix_type *)NULL)
+       return((ematrix_type *)NULL);
+
+    #pragma omp parallel for if(n_patterns > EIGEN_PAR_MIN)
+    for(i=0; i<n_patterns; ++i)
+       (void)memcpy((void *)&EMAT(m,i,0),(void *)pattern_matrix[i],pattern_size*sizeof(FTYPE));
+
+    pups_set_errno(OK);
+    return(m);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Generate ATA matrix from input pattern vectors. This is the   */
+/* cache blocked equivalent of get_covariance_matrix. The upper  */
+/* triangle is cut into EIGEN_MB x EIGEN_MB tiles which are      */
+/* shared dynamically between threads. Each tile is accumulated  */
+/* in EIGEN_KB deep panels, the innermost loop being a unit      */
+/* stride (SIMD) dot product. The result is mirrored into the    */
+/* lower triangle                                                */
+/*---------------------------------------------------------------*/
+
+_PUBLIC int32_t get_covariance_matrix_blocked(const ematrix_type *patterns, ematrix_type *cmatrix)
+
+{   int32_t n,
+            n_blocks,
+            n_tiles,
+            t;
+
+    if(patterns == (const ematrix_type *)NULL || cmatrix == (ematrix_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    n = patterns->rows;
+    if(cmatrix->rows != n || cmatrix->cols != n)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    n_blocks = (n + EIGEN_MB - 1)/EIGEN_MB;
+    n_tiles  = n_blocks*(n_blocks + 1)/2;
+
+    #pragma omp parallel for schedule(dynamic,1) if(n > EIGEN_PAR_MIN)
+    for(t=0; t<n_tiles; ++t)
+    {   int32_t i,
+                j,
+                k,
+                k0,
+                kn,
+                bi,
+                bj,
+                i0,
+                i1,
+                j0,
+                j1,
+                r;
+
+        FTYPE acc[EIGEN_MB][EIGEN_MB];
+
+
+        /*---------------------------------------------*/
+        /* Map linear tile index onto (row, col) block */
+        /* in the upper triangle                       */
+        /*---------------------------------------------*/
+
+        bi = 0;
+        r  = t;
+        while(r >= n_blocks - bi)
+        {  r -= n_blocks - bi;
+           ++bi;
+        }
+        bj = bi + r;
+
+        i0 = bi*EIGEN_MB;
+        i1 = (i0 + EIGEN_MB < n ? i0 + EIGEN_MB : n);
+        j0 = bj*EIGEN_MB;
+        j1 = (j0 + EIGEN_MB < n ? j0 + EIGEN_MB : n);
+
+        (void)memset((void *)acc,0,sizeof(acc));
+
+        for(k0=0; k0<patterns->cols; k0 += EIGEN_KB)
+        {  kn = (k0 + EIGEN_KB < patterns->cols ? EIGEN_KB : patterns->cols - k0);
+
+           for(i=i0; i<i1; ++i)
+           {  const FTYPE *pi = &EMAT(patterns,i,k0);
+
+              for(j=(bi == bj ? i : j0); j<j1; ++j)
+              {  const FTYPE *pj = &EMAT(patterns,j,k0);
+                 FTYPE       sum = 0.0;
+
+                 #pragma omp simd reduction(+:sum)
+                 for(k=0; k<kn; ++k)
+                    sum += pi[k]*pj[k];
+
+                 acc[i-i0][j-j0] += sum;
+              }
+           }
+        }
+
+        for(i=i0; i<i1; ++i)
+        {  for(j=(bi == bj ? i : j0); j<j1; ++j)
+           {  EMAT(cmatrix,i,j) = acc[i-i0][j-j0];
+              EMAT(cmatrix,j,i) = acc[i-i0][j-j0];
+           }
+        }
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Householder reduction of real symmetric (row-major) matrix to   */
+/* tridiagonal form. This is tred2 (with eigenvectors) rewritten   */
+/* for 0 based contiguous storage. The full symmetric matrix is    */
+/* kept so that the matrix-vector product and the rank-2 update    */
+/* at each step are unit stride row operations which can be       */
+/* shared between threads                                          */
+/*-----------------------------------------------------------------*/
+
+_PRIVATE void tred2_parallel(ematrix_type *a, FTYPE *d, FTYPE *e)
+
+{   int32_t i,
+            j,
+            k,
+            l,
+            n;
+
+    FTYPE scale,
+          hh,
+          h,
+          g,
+          f,
+          *g_row = (FTYPE *)NULL;
+
+    n = a->rows;
+    for(i=n-1; i>=1; --i)
+    {  FTYPE *u = &EMAT(a,i,0);
+
+       l = i-1;
+       h = scale = 0.0;
+
+       if(l > 0)
+       {  for(k=0; k<=l; ++k)
+             scale += FABS(u[k]);
+
+          if(scale == 0.0)
+             e[i] = u[l];
+          else
+          {  for(k=0; k<=l; ++k)
+             {  u[k] /= scale;
+                h    += u[k]*u[k];
+             }
+
+             f    =  u[l];
+             g    =  (f >= 0.0 ? -SQRT(h) : SQRT(h));
+             e[i] =  scale*g;
+             h    -= f*g;
+             u[l] =  f - g;
+
+
+             /*------------------------------------*/
+             /* p = A.u/h (stored in e) and K = p.u */
+             /*------------------------------------*/
+
+             f = 0.0;
+
+             #pragma omp parallel for reduction(+:f) if(l > EIGEN_PAR_MIN)
+             for(j=0; j<=l; ++j)
+             {  const FTYPE *aj = &EMAT(a,j,0);
+                FTYPE       sum = 0.0;
+
+                EMAT(a,j,i) = u[j]/h;
+
+                #pragma omp simd reduction(+:sum)
+                for(k=0; k<=l; ++k)
+                   sum += aj[k]*u[k];
+
+                e[j] =  sum/h;
+                f    += e[j]*u[j];
+             }
+
+
+             /*-----------------------------------------*/
+             /* q = p - K.u and A = A - q.u' - u.q'     */
+             /*-----------------------------------------*/
+
+             hh = f/(h+h);
+             for(j=0; j<=l; ++j)
+                e[j] -= hh*u[j];
+
+             #pragma omp parallel for if(l > EIGEN_PAR_MIN)
+             for(j=0; j<=l; ++j)
+             {  FTYPE *aj = &EMAT(a,j,0),
+                      uj  = u[j],
+                      qj  = e[j];
+
+                #pragma omp simd
+                for(k=0; k<=l; ++k)
+                   aj[k] -= (uj*e[k] + qj*u[k]);
+             }
+          }
+       }
+       else
+          e[i] = u[l];
+
+       d[i] = h;
+    }
+
+    d[0] = 0.0;
+    e[0] = 0.0;
+
+
+    /*----------------------------------*/
+    /* Accumulate transformation matrix */
+    /*----------------------------------*/
+
+    g_row = (FTYPE *)pups_calloc(n,sizeof(FTYPE));
+    for(i=0; i<n; ++i)
+    {  if(d[i] != 0.0)
+       {  FTYPE *u = &EMAT(a,i,0);
+
+          (void)memset((void *)g_row,0,i*sizeof(FTYPE));
+
+
+          /*----------------------------------------*/
+          /* g' = u'.Q (column blocks per thread)   */
+          /*----------------------------------------*/
+
+          #pragma omp parallel if(i > EIGEN_PAR_MIN)
+          {  int32_t jj,
+                     jc,
+                     kk;
+
+             #pragma omp for
+             for(jj=0; jj<i; jj += EIGEN_KB)
+             {  int32_t jn = (jj + EIGEN_KB < i ? jj + EIGEN_KB : i);
+
+                for(kk=0; kk<i; ++kk)
+                {  const FTYPE *ak = &EMAT(a,kk,0);
+                   FTYPE       uk  = u[kk];
+
+                   #pragma omp simd
+                   for(jc=jj; jc<jn; ++jc)
+                      g_row[jc] += uk*ak[jc];
+                }
+             }
+
+
+             /*---------------------------*/
+             /* Q = Q - (column i).g'     */
+             /*---------------------------*/
+
+             #pragma omp for
+             for(kk=0; kk<i; ++kk)
+             {  FTYPE *ak = &EMAT(a,kk,0),
+                      vk  = ak[i];
+
+                #pragma omp simd
+                for(jj=0; jj<i; ++jj)
+                   ak[jj] -= g_row[jj]*vk;
+             }
+          }
+       }
+
+       d[i]         = EMAT(a,i,i);
+       EMAT(a,i,i)  = 1.0;
+
+       for(j=0; j<i; ++j)
+          EMAT(a,j,i) = EMAT(a,i,j) = 0.0;
+    }
+
+    (void)pups_free((void *)g_row);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* QL with implicit shifts on tridiagonal matrix (0 based). The     */
+/* plane rotations of each QL sweep are recorded and then applied   */
+/* to the rows of the eigenvector matrix in parallel (the rows are  */
+/* independent so each thread walks its own block of rows)         */
+/*------------------------------------------------------------------*/
+
+_PRIVATE int32_t tqli_parallel(FTYPE *d, FTYPE *e, ematrix_type *z)
+
+{   int32_t m,
+            l,
+            iter,
+            i,
+            k,
+            n,
+            n_rot;
+
+    int32_t *rot_i = (int32_t *)NULL;
+
+    FTYPE s,
+          r,
+          p,
+          g,
+          f,
+          dd,
+          c,
+          b,
+          *rot_c = (FTYPE *)NULL,
+          *rot_s = (FTYPE *)NULL;
+
+    n = z->rows;
+    if((rot_i = (int32_t *)pups_calloc(n,sizeof(int32_t))) == (int32_t *)NULL ||
+       (rot_c = (FTYPE   *)pups_calloc(n,sizeof(FTYPE)))   == (FTYPE   *)NULL ||
+       (rot_s = (FTYPE   *)pups_calloc(n,sizeof(FTYPE)))   == (FTYPE   *)NULL  )
+    {  if(rot_i != (int32_t *)NULL)
+          (void)pups_free((void *)rot_i);
+
+       if(rot_c != (FTYPE *)NULL)
+          (void)pups_free((void *)rot_c);
+
+       pups_set_errno(ENOMEM);
+       return(-1);
+    }
+
+    for(i=1; i<n; ++i)
+       e[i-1] = e[i];
+    e[n-1] = 0.0;
+
+    for(l=0; l<n; ++l)
+    {  iter = 0;
+
+       do {   for(m=l; m<n-1; ++m)
+              {  dd = FABS(d[m]) + FABS(d[m+1]);
+                 if((FTYPE)(FABS(e[m]) + dd) == dd)
+                    break;
+              }
+
+              if(m != l)
+              {  if(iter++ == EIGEN_MAX_ITER)
+                 {  (void)pups_free((void *)rot_i);
+                    (void)pups_free((void *)rot_c);
+                    (void)pups_free((void *)rot_s);
+
+                    pups_set_errno(E2BIG);
+                    return(-1);
+                 }
+
+                 g     = (d[l+1] - d[l])/(2.0*e[l]);
+                 r     = pythag(g,1.0);
+                 g     = d[m] - d[l] + e[l]/(g + SIGN(r,g));
+                 s     = c = 1.0;
+                 p     = 0.0;
+                 n_rot = 0;
+
+                 for(i=m-1; i>=l; --i)
+                 {  f      = s*e[i];
+                    b      = c*e[i];
+                    e[i+1] = (r = pythag(f,g));
+
+                    if(r == 0.0)
+                    {  d[i+1] -= p;
+                       e[m]   =  0.0;
+                       break;
+                    }
+
+                    s      = f/r;
+                    c      = g/r;
+                    g      = d[i+1] - p;
+                    r      = (d[i] - g)*s + 2.0*c*b;
+                    d[i+1] = g + (p = s*r);
+                    g      = c*r - b;
+
+                    rot_i[n_rot] = i;
+                    rot_c[n_rot] = c;
+                    rot_s[n_rot] = s;
+                    ++n_rot;
+                 }
+
+
+                 /*---------------------------------------*/
+                 /* Apply rotations for this sweep to the */
+                 /* rows of the eigenvector matrix        */
+                 /*---------------------------------------*/
+
+                 #pragma omp parallel for if(n > EIGEN_PAR_MIN)
+                 for(k=0; k<n; ++k)
+                 {  int32_t q;
+                    FTYPE   *zk = &EMAT(z,k,0);
+
+                    for(q=0; q<n_rot; ++q)
+                    {  int32_t ii = rot_i[q];
+                       FTYPE   ff = zk[ii+1];
+
+                       zk[ii+1] = rot_s[q]*zk[ii] + rot_c[q]*ff;
+                       zk[ii]   = rot_c[q]*zk[ii] - rot_s[q]*ff;
+                    }
+                 }
+
+                 if(r == 0.0 && i >= l)
+                    continue;
+
+                 d[l] -= p;
+                 e[l] =  g;
+                 e[m] =  0.0;
+              }
+          } while(m != l);
+    }
+
+    (void)pups_free((void *)rot_i);
+    (void)pups_free((void *)rot_c);
+    (void)pups_free((void *)rot_s);
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Generate eigenvectors of (contiguous) covariance matrix. On     */
+/* return column j of cmatrix is the j'th eigenvector and d[j] its */
+/* eigenvalue (both sorted into descending order of eigenvalue).   */
+/* Returns the number of significant eigenvectors                  */
+/*-----------------------------------------------------------------*/
+
+_PUBLIC int32_t get_eigenvectors_parallel(const FTYPE significance, ematrix_type *cmatrix, FTYPE *d)
+
+{   int32_t i,
+            j,
+            n,
+            nse       = 0,
+            n_threads = 1,
+            *perm     = (int32_t *)NULL;
+
+    FTYPE   trace,
+            *e        = (FTYPE *)NULL,
+            *sorted   = (FTYPE *)NULL,
+            *scratch  = (FTYPE *)NULL;
+
+    if(cmatrix == (ematrix_type *)NULL || d == (FTYPE *)NULL || cmatrix->rows != cmatrix->cols)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    n = cmatrix->rows;
+    if((e = (FTYPE *)pups_calloc(n,sizeof(FTYPE))) == (FTYPE *)NULL)
+       return(-1);
+
+    tred2_parallel(cmatrix,d,e);
+    if(tqli_parallel(d,e,cmatrix) == (-1))
+    {  (void)pups_free((void *)e);
+       return(-1);
+    }
+
+    (void)pups_free((void *)e);
+
+
+    /*--------------------------------------------------*/
+    /* Sort into descending order of eigenvalue. The    */
+    /* eigenvectors are permuted a row at a time so the */
+    /* column shuffle stays unit stride                 */
+    /*--------------------------------------------------*/
+
+    perm   = (int32_t *)pups_calloc(n,sizeof(int32_t));
+    sorted = (FTYPE   *)pups_calloc(n,sizeof(FTYPE));
+
+    for(i=0; i<n; ++i)
+       perm[i] = i;
+
+    for(i=0; i<n-1; ++i)
+    {  int32_t k = i;
+
+       for(j=i+1; j<n; ++j)
+          if(d[perm[j]] >= d[perm[k]])
+             k = j;
+
+       if(k != i)
+       {  int32_t tmp = perm[i];
+
+          perm[i] = perm[k];
+          perm[k] = tmp;
+       }
+    }
+
+    for(i=0; i<n; ++i)
+       sorted[i] = d[perm[i]];
+    (void)memcpy((void *)d,(void *)sorted,n*sizeof(FTYPE));
+
+
+    /*---------------------------------------------------*/
+    /* Row scratch space for every thread that may run   */
+    /* the permutation. It is allocated here as          */
+    /* pups_calloc is not safe within a parallel region  */
+    /*---------------------------------------------------*/
+
+    #ifdef _OPENMP
+    n_threads = omp_get_max_threads();
+    #endif /* _OPENMP */
+
+    if((scratch = (FTYPE *)pups_calloc(n_threads*n,sizeof(FTYPE))) == (FTYPE *)NULL)
+    {  (void)pups_free((void *)perm);
+       (void)pups_free((void *)sorted);
+
+       return(-1);
+    }
+
+    #pragma omp parallel if(n > EIGEN_PAR_MIN)
+    {  int32_t k,
+               jj;
+
+       FTYPE   *row = scratch;
+
+       #ifdef _OPENMP
+       row += omp_get_thread_num()*n;
+       #endif /* _OPENMP */
+
+       #pragma omp for
+       for(k=0; k<n; ++k)
+       {  FTYPE *zk = &EMAT(cmatrix,k,0);
+
+          for(jj=0; jj<n; ++jj)
+             row[jj] = zk[perm[jj]];
+
+          (void)memcpy((void *)zk,(void *)row,n*sizeof(FTYPE));
+       }
+    }
+
+    (void)pups_free((void *)perm);
+    (void)pups_free((void *)sorted);
+    (void)pups_free((void *)scratch);
+
+
+    /*---------------------------------------------------------------*/
+    /* Proportion of variation that each eigenvector accounts for    */
+    /*---------------------------------------------------------------*/
+
+    trace = 0.0;
+    for(i=0; i<n; ++i)
+       trace += d[i];
+
+    for(i=0; i<n; ++i)
+       if((d[i]/trace) * 100.0 >= significance)
+          ++nse;
+
+    pups_set_errno(OK);
+    return(nse);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Generate eigenpatterns (nse x pattern_size) from contiguous  */
+/* pattern and eigenvector matrices. Each thread owns a block   */
+/* of pattern columns which it updates for all nse components   */
+/* as it streams through the patterns, so the output tile stays */
+/* in cache and the inner loop is a unit stride AXPY            */
+/*--------------------------------------------------------------*/
+
+_PUBLIC ematrix_type *get_eigenpatterns_blocked(const int32_t nse, const ematrix_type *patterns, const ematrix_type *eigenvector)
+
+{   int32_t      ib,
+                 n_patterns,
+                 pattern_size;
+
+    ematrix_type *eigenpattern = (ematrix_type *)NULL;
+
+    if(patterns == (const ematrix_type *)NULL || eigenvector == (const ematrix_type *)NULL ||
+       nse <= 0 || nse > eigenvector->cols || eigenvector->rows != patterns->rows       )
+    {  pups_set_errno(EINVAL);
+       return((ematrix_type *)NULL);
+    }
+
+    n_patterns   = patterns->rows;
+    pattern_size = patterns->cols;
+
+    if((eigenpattern = ematrix_create(nse,pattern_size)) == (ematrix_type *)NULL)
+       return((ematrix_type *)NULL);
+
+    #pragma omp parallel for schedule(static) if(pattern_size > EIGEN_KB)
+    for(ib=0; ib<pattern_size; ib += EIGEN_KB)
+    {  int32_t i,
+               j,
+               k,
+               in = (ib + EIGEN_KB < pattern_size ? ib + EIGEN_KB : pattern_size);
+
+       for(k=0; k<n_patterns; ++k)
+       {  const FTYPE *pk = &EMAT(patterns,k,0);
+
+          for(j=0; j<nse; ++j)
+          {  FTYPE *ej = &EMAT(eigenpattern,j,0),
+                   vkj = EMAT(eigenvector,k,j);
+
+             #pragma omp simd
+             for(i=ib; i<in; ++i)
+                ej[i] += vkj*pk[i];
+          }
+       }
+    }
+
+    pups_set_errno(OK);
+    return(eigenpattern);
+}
+
+
+
+
+/*----------------------------------------------------------------*/
+/* Map a block of patterns into eigenspace. This is the batched   */
+/* form of generate_weight_vector: W = P.E' where P is the N x    */
+/* pattern_size block of patterns and E the nse x pattern_size    */
+/* eigenpatterns. The patterns are cut into EIGEN_MB row tiles    */
+/* (shared between threads) and the pattern dimension into        */
+/* EIGEN_KB deep panels, so each eigenpattern panel is reused     */
+/* from cache for every pattern in the tile                       */
+/*----------------------------------------------------------------*/
+
+_PUBLIC ematrix_type *generate_weight_matrix(const int32_t nse, const ematrix_type *patterns, const ematrix_type *eigenpattern)
+
+{   int32_t      ib,
+                 n_patterns,
+                 pattern_size;
+
+    ematrix_type *weight = (ematrix_type *)NULL;
+
+    if(patterns == (const ematrix_type *)NULL || eigenpattern == (const ematrix_type *)NULL ||
+       nse <= 0 || nse > eigenpattern->rows || eigenpattern->cols != patterns->cols       )
+    {  pups_set_errno(EINVAL);
+       return((ematrix_type *)NULL);
+    }
+
+    n_patterns   = patterns->rows;
+    pattern_size = patterns->cols;
+
+    if((weight = ematrix_create(n_patterns,nse)) == (ematrix_type *)NULL)
+       return((ematrix_type *)NULL);
+
+    #pragma omp parallel for schedule(dynamic,1) if(n_patterns > EIGEN_MB)
+    for(ib=0; ib<n_patterns; ib += EIGEN_MB)
+    {  int32_t i,
+               j,
+               k,
+               k0,
+               kn,
+               in = (ib + EIGEN_MB < n_patterns ? ib + EIGEN_MB : n_patterns);
+
+       for(k0=0; k0<pattern_size; k0 += EIGEN_KB)
+       {  kn = (k0 + EIGEN_KB < pattern_size ? EIGEN_KB : pattern_size - k0);
+
+          for(i=ib; i<in; ++i)
+          {  const FTYPE *pi = &EMAT(patterns,i,k0);
+             FTYPE       *wi = &EMAT(weight,i,0);
+
+             for(j=0; j<nse; ++j)
+             {  const FTYPE *ej = &EMAT(eigenpattern,j,k0);
+                FTYPE       sum = 0.0;
+
+                #pragma omp simd reduction(+:sum)
+                for(k=0; k<kn; ++k)
+                   sum += pi[k]*ej[k];
+
+                wi[j] += sum;
+             }
+          }
+       }
+    }
+
+    pups_set_errno(OK);
+    return(weight);
+}
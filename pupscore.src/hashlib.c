@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 3.00 
-    Dated:   10th December 2024
+    Version: 3.01 
+    Dated:   19th October 2026
     E-Mail:  mao@tumblingdice.co.uk
 --------------------------------------*/
 
@@ -95,22 +95,24 @@ _PROTOTYPE _PRIVATE int32_t hash_key(int32_t, hash_table_type *);
 
 _PRIVATE  int32_t hash_key(int32_t h_index, hash_table_type *hash_table)
 
-{    int32_t w;
+{    int32_t      w;
+     rstream_type stream;
 
 
     /*-------------------------------------------------------------*/
-    /* Seed random number generator so that random number produced */
-    /* is a function of the index                                  */
+    /* Seed a private random stream so that the random number      */
+    /* produced is a function of the index (without disturbing the */
+    /* global generator state used by ran1)                        */
     /*-------------------------------------------------------------*/
 
-    r_init = (long)(-h_index);
+    rstream_seed(&stream,(uint64_t)h_index);
 
 
     /*-------------------*/
     /* Generate hash key */
     /*-------------------*/
 
-    w = (int)(ran1()*(FTYPE)(hash_table->size - 1));
+    w = (int)(rstream_uniform(&stream)*(FTYPE)(hash_table->size - 1));
     return(w);
 }
 
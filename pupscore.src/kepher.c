@@ -8,8 +8,8 @@
               NE3 4RT
               United Kingdom
 
-     Version: 3.04
-     Dated:   10th December 2024
+     Version: 4.00
+     Dated:   19th October 2026
      E-mail:  mao@tumblingdice.co.uk
 --------------------------------------*/
 
@@ -26,6 +26,13 @@
 #include <time.h>
 #include <xtypes.h>
 #include <stdint.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <pnreg.h>
 
 
 /*-------------------------------------------------*/
@@ -35,7 +42,7 @@
 /* Version of kepher */
 /*-------------------*/
  
-#define KEPHER_VERSION    "3.04"
+#define KEPHER_VERSION    "4.00"
 #define EXTENSION_LIST    "fifo tmp run agf pheap lid lock"
 
 
@@ -46,6 +53,50 @@
 #define SSIZE             2048 
 
 
+/*-----------------------------------------------------*/
+/* Candidate index, sweep worker pool and event sizes  */
+/*-----------------------------------------------------*/
+
+#define INDEX_BUCKETS     4096
+#define DEFAULT_WORKERS   4
+#define MAX_WORKERS       64
+#define JOB_QUEUE_SIZE    1024
+#define EVENT_BUFSIZE     4096
+#define DEFAULT_PERIOD    1000
+
+
+/*-----------------------------------------------------*/
+/* Maximum depth of (sub)directories which we descend  */
+/* into when removing an object                        */
+/*-----------------------------------------------------*/
+
+#define MAX_REMOVE_DEPTH  64
+
+
+/*-------------------------------------------------------------*/
+/* Candidate (object in monitored directory). The index of     */
+/* candidates is built once and then kept up to date (inotify) */
+/* so a sweep does not have to read the directory              */
+/*-------------------------------------------------------------*/
+
+typedef struct candidate {   char             *name;                     // Name (in monitored directory)
+                             pid_t            pid;                       // Owning process ((-1) if none)
+                             _BOOLEAN         queued;                    // TRUE if queued for removal
+                             struct candidate *next;                     // Next candidate (in bucket)
+                         } candidate_type;
+
+
+/*-------------------------------------------*/
+/* Removal job (taken by sweep worker)       */
+/*-------------------------------------------*/
+
+typedef struct {   char     *name;                                       // Object to remove
+                   pid_t    pid;                                         // Owning process ((-1) if none)
+                   _BOOLEAN shadowed;                                    // TRUE if object is protected
+                   _BOOLEAN verbose;                                     // TRUE if removal is logged
+               } job_type;
+
+
 
 /*------------------*/
 /* Global variables */
@@ -70,6 +121,34 @@ _PRIVATE char     nextPathFile[SSIZE]        = "";
 _PRIVATE char     nextPathShadow[SSIZE]      = "";
 _PRIVATE char     ignoreExtensionList[SSIZE] = "";
 _PRIVATE int32_t  nfiles                     = 0;
+_PRIVATE int32_t  inotify_des                = (-1);
+_PRIVATE int32_t  mpid_fd                    = (-1);
+_PRIVATE _BOOLEAN mpid_exited                = FALSE;
+_PRIVATE uint32_t sweep_period               = DEFAULT_PERIOD;
+_PRIVATE volatile sig_atomic_t term_signal   = 0;
+
+
+/*------------------------------------------------------------*/
+/* Candidate index and sweep state. Workers take removal jobs */
+/* from a bounded queue so a sweep never has more than        */
+/* JOB_QUEUE_SIZE removals in flight                          */
+/*------------------------------------------------------------*/
+
+_PRIVATE candidate_type  *index_bucket[INDEX_BUCKETS];
+_PRIVATE uint32_t        n_indexed                  = 0;
+_PRIVATE uint32_t        n_workers                  = DEFAULT_WORKERS;
+_PRIVATE uint32_t        n_started                  = 0;
+_PRIVATE job_type        job_queue[JOB_QUEUE_SIZE];
+_PRIVATE uint32_t        job_head                   = 0;
+_PRIVATE uint32_t        n_jobs                     = 0;
+_PRIVATE uint32_t        n_pending                  = 0;
+_PRIVATE _BOOLEAN        workers_quit               = FALSE;
+_PRIVATE uint64_t        n_sweeps                   = 0;
+_PRIVATE uint64_t        n_removed                  = 0;
+_PRIVATE uint64_t        n_reclaimed                = 0;
+_PRIVATE pthread_mutex_t job_mutex                  = PTHREAD_MUTEX_INITIALIZER;
+_PRIVATE pthread_cond_t  job_cond                   = PTHREAD_COND_INITIALIZER;
+_PRIVATE pthread_cond_t  done_cond                  = PTHREAD_COND_INITIALIZER;
 
 
 
@@ -92,6 +171,14 @@ _PRIVATE int32_t getPidFromPname(char *pname)
     pid_t   pid   = (-1);
     int32_t found = 0;
 
+
+    /*-------------------------------------------------------*/
+    /* Try PUPS process name registry before walking /proc   */
+    /*-------------------------------------------------------*/
+
+    if ((pid = pnreg_name_to_pid(pname)) > 0)
+       return(pid);
+
     pdirp = opendir("/proc");
     while((next_item = readdir(pdirp)) != (struct dirent *)NULL)
     {    int32_t next_pid = (-1);
@@ -161,8 +248,13 @@ _PRIVATE void strdate(char *date)
 
 {   time_t tval;
 
+
+    /*-------------------------------------*/
+    /* Called by sweep workers (reentrant) */
+    /*-------------------------------------*/
+
     (void)time(&tval);
-    (void)strcpy(date,ctime(&tval));
+    (void)ctime_r(&tval,date);
     date[strlen(date) - 1] = '\0';
 }
 
@@ -318,35 +410,122 @@ _PRIVATE  int32_t getPidFromFname(char *fname)
 
 
 
-/*---------------*/
-/* Delete a file */
-/*---------------*/
+/*-------------------------------------------------------------*/
+/* Remove object (without forking rm). Directories are removed */
+/* recursively (to at most MAX_REMOVE_DEPTH levels). Returns   */
+/* space reclaimed (bytes) - space held by objects with other  */
+/* (hard) links is not reclaimed                               */
+/*-------------------------------------------------------------*/
 
-_PRIVATE  int32_t deleteFile(_BOOLEAN do_verbose, _BOOLEAN shadowed, pid_t pid, char *fname)
+_PRIVATE uint64_t removeObject(const int32_t dir_fd, const char *name, const uint32_t depth)
 
-{   char rm_cmd[SSIZE]  = "",
-         pidInfo[SSIZE] = "";
+{   uint64_t reclaimed = 0;
+    _BOOLEAN is_dir    = FALSE;
 
+    #ifdef STATX_BLOCKS
+    struct statx buf;
 
-    /*---------------------*/
-    /* Delete primary file */
-    /*---------------------*/
+    if (statx(dir_fd,name,AT_SYMLINK_NOFOLLOW,STATX_TYPE | STATX_NLINK | STATX_BLOCKS,&buf) == (-1))
+       return(0);
+
+    if (S_ISDIR(buf.stx_mode))
+       is_dir = TRUE;
+
+    if (is_dir == FALSE && buf.stx_nlink == 1)
+       reclaimed = buf.stx_blocks*512;
+    #else
+    struct stat buf;
+
+    if (fstatat(dir_fd,name,&buf,AT_SYMLINK_NOFOLLOW) == (-1))
+       return(0);
+
+    if (S_ISDIR(buf.st_mode))
+       is_dir = TRUE;
 
-    (void)snprintf(rm_cmd,SSIZE,"rm -rf %s/%s",mdir,fname);
-    (void)system(rm_cmd);
+    if (is_dir == FALSE && buf.st_nlink == 1)
+       reclaimed = buf.st_blocks*512;
+    #endif /* STATX_BLOCKS */
 
 
-    /*---------------*/
-    /* Delete shadow */
-    /*---------------*/
+    /*-------------------------------------*/
+    /* Empty directory before removing it  */
+    /*-------------------------------------*/
+
+    if (is_dir == TRUE)
+    {  int32_t       sub_fd;
+       DIR           *sub_dirp   = (DIR *)NULL;
+       struct dirent *next_entry = (struct dirent *)NULL;
+
+
+       /*-------------------------------------------*/
+       /* Too deep - leave it (and its parents) be  */
+       /*-------------------------------------------*/
+
+       if (depth >= MAX_REMOVE_DEPTH)
+          return(0);
+
+       if ((sub_fd = openat(dir_fd,name,O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC)) == (-1))
+          return(0);
+
+       if ((sub_dirp = fdopendir(sub_fd)) == (DIR *)NULL)
+       {  (void)close(sub_fd);
+          return(0);
+       }
+
+       while ((next_entry = readdir(sub_dirp)) != (struct dirent *)NULL)
+       {   if (strcmp(next_entry->d_name,".") != 0 && strcmp(next_entry->d_name,"..") != 0)
+              reclaimed += removeObject(sub_fd,next_entry->d_name,depth + 1);
+       }
+
+       (void)closedir(sub_dirp);
+
+       if (unlinkat(dir_fd,name,AT_REMOVEDIR) == (-1))
+          return(reclaimed);
+    }
+    else if (unlinkat(dir_fd,name,0) == (-1))
+       return(0);
+
+    return(reclaimed);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Delete a file. Called by sweep workers (so we do not touch */
+/* any state which is not thread safe)                        */
+/*------------------------------------------------------------*/
+
+_PRIVATE  int32_t deleteFile(_BOOLEAN do_verbose, _BOOLEAN shadowed, pid_t pid, char *fname)
+
+{   uint64_t reclaimed      = 0;
+    char     pidInfo[SSIZE] = "",
+             date[SSIZE]    = "",
+             shadow[SSIZE]  = "";
+
+
+    /*-----------------------------------------------*/
+    /* Delete shadow (first, so that the file is not */
+    /* relinked while we are deleting it)            */
+    /*-----------------------------------------------*/
 
     if (do_protect == TRUE)
-    {  (void)snprintf(rm_cmd,SSIZE,"rm -rf %s/.%s",mdir,fname);
-       (void)system(rm_cmd);
+    {  (void)snprintf(shadow,SSIZE,".%s",fname);
+       reclaimed += removeObject(dirfd(dirp),shadow,0);
     }
 
+
+    /*---------------------*/
+    /* Delete primary file */
+    /*---------------------*/
+
+    reclaimed += removeObject(dirfd(dirp),fname,0);
+
+    (void)__atomic_add_fetch(&n_reclaimed,reclaimed,__ATOMIC_RELAXED);
+    (void)__atomic_add_fetch(&n_removed,  1,        __ATOMIC_RELAXED);
+
     if (shadowed == TRUE)
-       --nfiles;
+       (void)__atomic_sub_fetch(&nfiles,1,__ATOMIC_RELAXED);
 
     if (pid != (-1))
        (void)snprintf(pidInfo,SSIZE," (monitor pid %d) ",pid);
@@ -378,20 +557,21 @@ _PRIVATE  int32_t deleteFile(_BOOLEAN do_verbose, _BOOLEAN shadowed, pid_t pid,
 
        for (i=0; i<strlen(fname) - 4; ++i)
        {  if (strncmp((char *)&fname[i],".lid",4) == 0)
-          {  char tmpstr[SSIZE] = "";
+          {  char tmpstr[SSIZE] = "",
+                  lock[SSIZE]   = "";
 
 
              (void)strcpy(tmpstr,fname);
              tmpstr[i] = '\0';
 
-             (void)snprintf(rm_cmd,SSIZE,"rm -f %s/%s.lock",mdir,tmpstr);
-             (void)system(rm_cmd);
-
              if (do_protect == TRUE)
-             {  (void)snprintf(rm_cmd,SSIZE,"rm -f %s/.%s.lock",mdir,tmpstr);
-                (void)system(rm_cmd);
+             {  (void)snprintf(lock,SSIZE,".%s.lock",tmpstr);
+                (void)unlinkat(dirfd(dirp),lock,0);
              }
 
+             (void)snprintf(lock,SSIZE,"%s.lock",tmpstr);
+             (void)unlinkat(dirfd(dirp),lock,0);
+
              if (do_verbose == TRUE)
              {  (void)strdate(date);
                 (void)fprintf(stderr,"%s kepher (%d@%s): stale lock \"%s.lock\" smashed (in \"%s\")\n",date,getpid(),hostname,tmpstr,mdir);
@@ -486,12 +666,48 @@ _PRIVATE int32_t destroy_shadowFiles(void)
 
 
 
-/*-----------------------------------------*/
-/* Handle SIGTERM, SIGINT, SIGQUIT, SIGHUP */ 
-/*-----------------------------------------*/
+/*-----------------------------------------------------------*/
+/* Handle SIGTERM, SIGINT, SIGQUIT, SIGHUP. Sweep workers    */
+/* may be using the monitored directory so we just note the  */
+/* signal here and leave the main loop to clean up and exit  */
+/*-----------------------------------------------------------*/
 
 _PRIVATE  int32_t term_handler(int signum)
 
+{    term_signal = signum;
+     return(0);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Stop sweep workers. Queued removals are finished before */
+/* we return so nothing is using the monitored directory   */
+/*---------------------------------------------------------*/
+
+_PRIVATE void stop_workers(void)
+
+{   (void)pthread_mutex_lock(&job_mutex);
+
+    workers_quit = TRUE;
+    (void)pthread_cond_broadcast(&job_cond);
+
+    while (n_pending > 0)
+          (void)pthread_cond_wait(&done_cond,&job_mutex);
+
+    (void)pthread_mutex_unlock(&job_mutex);
+}
+
+
+
+
+/*---------------------------------------------*/
+/* Clean up (monitored directory) and exit     */
+/*---------------------------------------------*/
+
+_PRIVATE void kepher_exit(int signum)
+
 {    if (do_verbose == TRUE)
      {  (void)strdate(date);
         (void)fprintf(stderr,"%s kepher (%d@%s): exiting (signal %d)\n",date,getpid(),hostname,signum);
@@ -499,6 +715,7 @@ _PRIVATE  int32_t term_handler(int signum)
      }
 
      (void)unlink(kepherRun);
+     stop_workers();
 
 
      /*-------------------------------------------*/
@@ -506,9 +723,7 @@ _PRIVATE  int32_t term_handler(int signum)
      /*-------------------------------------------*/
 
      if (do_delete == TRUE)
-     {  char rm_cmd[SSIZE] = "";
-
-        (void)closedir(dirp);
+     {  (void)closedir(dirp);
 
         if (do_verbose == TRUE)
         {  (void)strdate(date);
@@ -516,8 +731,7 @@ _PRIVATE  int32_t term_handler(int signum)
            (void)fflush(stderr);
         }
 
-        (void)snprintf(rm_cmd,SSIZE,"rm -rf %s",mdir);
-        (void)system(rm_cmd);
+        (void)removeObject(AT_FDCWD,mdir,0);
      }
      else if (do_protect == TRUE)
      {  (void)destroy_shadowFiles();
@@ -567,6 +781,490 @@ _PRIVATE _BOOLEAN ignoreFile(char *fileName)
 
 
 
+/*---------------------------------------*/
+/* Current time (milliseconds)           */
+/*---------------------------------------*/
+
+_PRIVATE uint64_t now_ms(void)
+
+{   struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC,&now);
+    return((uint64_t)now.tv_sec*1000 + (uint64_t)now.tv_nsec/1000000);
+}
+
+
+
+
+/*---------------------------------------*/
+/* Index bucket for candidate (FNV hash) */
+/*---------------------------------------*/
+
+_PRIVATE uint32_t index_hash(const char *name)
+
+{   uint32_t   hash  = 2166136261U;
+    const char *ptr  = (const char *)NULL;
+
+    for (ptr = name; *ptr != '\0'; ++ptr)
+    {  hash ^= (unsigned char)*ptr;
+       hash *= 16777619U;
+    }
+
+    return(hash % INDEX_BUCKETS);
+}
+
+
+
+
+/*------------------------------*/
+/* Find candidate in index      */
+/*------------------------------*/
+
+_PRIVATE candidate_type *index_find(const char *name)
+
+{   candidate_type *next = (candidate_type *)NULL;
+
+    for (next = index_bucket[index_hash(name)]; next != (candidate_type *)NULL; next = next->next)
+    {  if (strcmp(next->name,name) == 0)
+          return(next);
+    }
+
+    return((candidate_type *)NULL);
+}
+
+
+
+
+/*------------------------------------------------------*/
+/* Add candidate to index. The owner of the candidate   */
+/* (if any) is only worked out once                     */
+/*------------------------------------------------------*/
+
+_PRIVATE void index_add(const char *name)
+
+{   uint32_t       bucket;
+    candidate_type *candidate = (candidate_type *)NULL;
+
+    if (strcmp(name,".") == 0 || strcmp(name,"..") == 0 || index_find(name) != (candidate_type *)NULL)
+       return;
+
+    if ((candidate = (candidate_type *)malloc(sizeof(candidate_type))) == (candidate_type *)NULL)
+       return;
+
+    if ((candidate->name = strdup(name)) == (char *)NULL)
+    {  (void)free((void *)candidate);
+       return;
+    }
+
+    candidate->pid         = getPidFromFname(candidate->name);
+    candidate->queued      = FALSE;
+
+    bucket                 = index_hash(name);
+    candidate->next        = index_bucket[bucket];
+    index_bucket[bucket]   = candidate;
+
+    ++n_indexed;
+}
+
+
+
+
+/*------------------------------*/
+/* Remove candidate from index  */
+/*------------------------------*/
+
+_PRIVATE void index_remove(const char *name)
+
+{   candidate_type **next     = (candidate_type **)NULL,
+                   *candidate = (candidate_type *)NULL;
+
+    for (next = &index_bucket[index_hash(name)]; *next != (candidate_type *)NULL; next = &(*next)->next)
+    {  if (strcmp((*next)->name,name) == 0)
+       {  candidate = *next;
+          *next     = candidate->next;
+
+          (void)free((void *)candidate->name);
+          (void)free((void *)candidate);
+
+          --n_indexed;
+          return;
+       }
+    }
+}
+
+
+
+
+/*-----------------------------------------------------*/
+/* (Re)build index from monitored directory. We only   */
+/* do this at startup and if inotify loses events      */
+/*-----------------------------------------------------*/
+
+_PRIVATE void index_rebuild(void)
+
+{   uint32_t       i;
+    candidate_type *next      = (candidate_type *)NULL,
+                   *candidate = (candidate_type *)NULL;
+
+    for (i=0; i<INDEX_BUCKETS; ++i)
+    {  for (next = index_bucket[i]; next != (candidate_type *)NULL; next = candidate)
+       {  candidate = next->next;
+
+          (void)free((void *)next->name);
+          (void)free((void *)next);
+       }
+
+       index_bucket[i] = (candidate_type *)NULL;
+    }
+
+    n_indexed = 0;
+
+    (void)rewinddir(dirp);
+    while ((next_item = readdir(dirp)) != (struct dirent *)NULL)
+          index_add(next_item->d_name);
+}
+
+
+
+
+/*------------------------------------------------------*/
+/* Update index from (pending) changes to monitored     */
+/* directory                                            */
+/*------------------------------------------------------*/
+
+_PRIVATE void index_update(void)
+
+{   ssize_t size;
+    char    buf[EVENT_BUFSIZE] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    while ((size = read(inotify_des,buf,EVENT_BUFSIZE)) > 0)
+    {  char *ptr = (char *)NULL;
+
+       for (ptr = buf; ptr < buf + size; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len)
+       {  const struct inotify_event *event = (const struct inotify_event *)ptr;
+
+
+          /*----------------------------------------------*/
+          /* Events have been lost - rebuild index        */
+          /*----------------------------------------------*/
+
+          if (event->mask & IN_Q_OVERFLOW)
+          {  if (do_verbose == TRUE)
+             {  (void)strdate(date);
+                (void)fprintf(stderr,"%s kepher (%d@%s): event queue overflow -- rebuilding index of \"%s\"\n",
+                                                                                     date,getpid(),hostname,mdir);
+                (void)fflush(stderr);
+             }
+
+             index_rebuild();
+          }
+          else if (event->len > 0 && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+             index_add(event->name);
+          else if (event->len > 0 && (event->mask & (IN_DELETE | IN_MOVED_FROM)))
+             index_remove(event->name);
+       }
+    }
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Sweep worker. Takes removal jobs from the (bounded) queue  */
+/*------------------------------------------------------------*/
+
+_PRIVATE void *sweep_worker(void *arg)
+
+{   while (TRUE)
+    {   job_type job;
+
+        (void)pthread_mutex_lock(&job_mutex);
+
+        while (n_jobs == 0 && workers_quit == FALSE)
+              (void)pthread_cond_wait(&job_cond,&job_mutex);
+
+
+        /*------------------------------------*/
+        /* Queue drained and we are exiting   */
+        /*------------------------------------*/
+
+        if (n_jobs == 0)
+        {  (void)pthread_mutex_unlock(&job_mutex);
+           break;
+        }
+
+        job      = job_queue[job_head];
+        job_head = (job_head + 1) % JOB_QUEUE_SIZE;
+        --n_jobs;
+
+        (void)pthread_mutex_unlock(&job_mutex);
+
+        (void)deleteFile(job.verbose,job.shadowed,job.pid,job.name);
+        (void)free((void *)job.name);
+
+        (void)pthread_mutex_lock(&job_mutex);
+
+        --n_pending;
+        if (n_pending == 0)
+           (void)pthread_cond_broadcast(&done_cond);
+
+        (void)pthread_mutex_unlock(&job_mutex);
+    }
+
+    return((void *)NULL);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Start sweep workers. If we cannot start any the  */
+/* sweep removes objects itself                     */
+/*--------------------------------------------------*/
+
+_PRIVATE void start_workers(void)
+
+{   uint32_t  i;
+    pthread_t worker;
+    sigset_t  set,
+              old_set;
+
+
+    /*------------------------------------------------*/
+    /* Workers must not run our signal handlers       */
+    /*------------------------------------------------*/
+
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_BLOCK,&set,&old_set);
+
+    for (i=0; i<n_workers; ++i)
+    {  if (pthread_create(&worker,(pthread_attr_t *)NULL,&sweep_worker,(void *)NULL) == 0)
+       {  (void)pthread_detach(worker);
+          ++n_started;
+       }
+    }
+
+    (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
+}
+
+
+
+
+/*-------------------------------------------------------*/
+/* Queue candidate for removal. Returns FALSE if removal */
+/* queue is full (candidate is retried next sweep)       */
+/*-------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN queue_removal(candidate_type *candidate, const _BOOLEAN shadowed)
+
+{   job_type job;
+
+    job.pid      = candidate->pid;
+    job.shadowed = shadowed;
+
+
+    /*------------------------------------------------*/
+    /* Removal of stale PUPS/P3 objects is always     */
+    /* logged                                         */
+    /*------------------------------------------------*/
+
+    if (job.pid != (-1))
+       job.verbose = TRUE;
+    else
+       job.verbose = FALSE;
+
+
+    /*-----------------------------*/
+    /* No workers - remove it now  */
+    /*-----------------------------*/
+
+    if (n_started == 0)
+    {  (void)deleteFile(job.verbose,shadowed,job.pid,candidate->name);
+       return(TRUE);
+    }
+
+    if ((job.name = strdup(candidate->name)) == (char *)NULL)
+       return(FALSE);
+
+    (void)pthread_mutex_lock(&job_mutex);
+
+    if (n_jobs == JOB_QUEUE_SIZE)
+    {  (void)pthread_mutex_unlock(&job_mutex);
+       (void)free((void *)job.name);
+
+       return(FALSE);
+    }
+
+    job_queue[(job_head + n_jobs) % JOB_QUEUE_SIZE] = job;
+    ++n_jobs;
+    ++n_pending;
+
+    (void)pthread_cond_signal(&job_cond);
+    (void)pthread_mutex_unlock(&job_mutex);
+
+    candidate->queued = TRUE;
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Sweep candidate index. Stale objects are queued for removal */
+/* (by sweep workers), protected objects are checked against   */
+/* their shadows                                               */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void sweep(void)
+
+{   uint32_t       i;
+    _BOOLEAN       idle;
+    pid_t          nextPid;
+    candidate_type *candidate = (candidate_type *)NULL;
+
+
+    /*----------------------------------------------------------*/
+    /* Removals which are not pending have finished. Index has  */
+    /* to be brought up to date after we check this so it sees  */
+    /* every object they removed                                */
+    /*----------------------------------------------------------*/
+
+    (void)pthread_mutex_lock(&job_mutex);
+
+    if (n_pending == 0)
+       idle = TRUE;
+    else
+       idle = FALSE;
+
+    (void)pthread_mutex_unlock(&job_mutex);
+
+    index_update();
+
+    for (i=0; i<INDEX_BUCKETS; ++i)
+    {  for (candidate = index_bucket[i]; candidate != (candidate_type *)NULL; candidate = candidate->next)
+       {
+
+           /*----------------------------------------------*/
+           /* Candidate is (or failed to be) removed       */
+           /*----------------------------------------------*/
+
+           if (candidate->queued == TRUE)
+           {  if (idle == FALSE)
+                 continue;
+
+              candidate->queued = FALSE;
+           }
+
+           (void)strlcpy(nextFile,candidate->name,SSIZE);
+
+
+           /*-----------------------------------------*/
+           /* Files associated with PUPS/P3 processes */ 
+           /* and shells                              */
+           /*-----------------------------------------*/
+
+           if ((nextPid = candidate->pid) != (-1))
+           {  if (kill(nextPid,SIGCONT) == (-1))
+                 (void)queue_removal(candidate,FALSE);
+           }
+
+
+           /*--------------------------------------*/
+           /* Protect regular files (with shadows) */
+           /*--------------------------------------*/
+
+           else if (do_protect == TRUE)
+           {
+
+              /*------------------------------------------*/
+              /* Shadow exists but shadowed file does not */
+              /* relink shadowed file                     */
+              /*------------------------------------------*/
+
+              if (nextFile[0] == '.' && nextFile[1] != '\0' && index_find((char *)&nextFile[1]) == (candidate_type *)NULL)
+              {  (void)linkat(dirfd(dirp),nextFile,dirfd(dirp),(char *)&nextFile[1],0);
+   
+                 if (do_verbose == TRUE)
+                 {  (void)strdate(date);
+                    (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): file \"%s\" lost - relinking\n",boldOn,boldOff,date,getpid(),hostname,(char *)&nextFile[1]); 
+                    (void)fflush(stderr);
+                 }
+              }
+
+
+              /*-------------------------------------*/
+              /* File without shadow - delete it     */
+              /* if it doesn't have a file extension */
+              /* we are ignoring                     */
+              /*-------------------------------------*/
+
+              else if (nextFile[0] != '.')
+              {  (void)snprintf(nextPathShadow,SSIZE,".%s",nextFile);
+                    
+                 if (index_find(nextPathShadow) == (candidate_type *)NULL && ignoreFile(nextFile) == FALSE)
+                 {  if (strcmp(nextFile,"kepher.run") != 0)
+                    {  if (queue_removal(candidate,TRUE) == TRUE && do_verbose == TRUE)
+                       {  (void)strdate(date);
+                          (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): file \"%s\" has no shadow - deleting\n",boldOn,boldOff,date,getpid(),hostname,nextFile); 
+                          (void)fflush(stderr);
+                       }
+                    }
+                    else
+                    {  (void)linkat(dirfd(dirp),nextFile,dirfd(dirp),nextPathShadow,0);
+ 
+                       if (do_verbose == TRUE)
+                       {  (void)strdate(date);
+                          (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): cannot delete \"kepher.run\"\n",boldOn,boldOff,date,getpid(),hostname); 
+                          (void)fflush(stderr);
+                       }
+                    }
+                 }
+              }
+           }
+       }
+    }
+
+    ++n_sweeps;
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Publish sweep progress. The run file holds our PID (first     */
+/* line) followed by the sweep counters so they can be read by   */
+/* other processes                                               */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void publish_status(void)
+
+{   int32_t  fdes;
+    size_t   size;
+    uint32_t pending;
+    char     status[SSIZE] = "";
+
+    (void)pthread_mutex_lock(&job_mutex);
+    pending = n_pending;
+    (void)pthread_mutex_unlock(&job_mutex);
+
+    (void)snprintf(status,SSIZE,"%d\nsweeps %" PRIu64 " indexed %u pending %u removed %" PRIu64 " reclaimed %" PRIu64 "\n",
+                                                                                                   getpid(),n_sweeps,n_indexed,pending,
+                                                                                                   __atomic_load_n(&n_removed,__ATOMIC_RELAXED),
+                                                                                                   __atomic_load_n(&n_reclaimed,__ATOMIC_RELAXED));
+
+    if ((fdes = open(kepherRun,O_WRONLY | O_CLOEXEC)) == (-1))
+       return;
+
+    size = strlen(status);
+    if (pwrite(fdes,status,size,0) == (ssize_t)size)
+       (void)ftruncate(fdes,size);
+
+    (void)close(fdes);
+}
+
+
+
+
 /*----------------------------------*/
 /* Main entry point for application */
 /*----------------------------------*/
@@ -577,8 +1275,6 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     int32_t decoded           = 0;
     int32_t mpid              = (-1);
     _BOOLEAN looper           = TRUE;
-    struct   stat statBuf;
-    int32_t nextPid           = (-1);
     int32_t kpid              = (-1);
     FILE     *krstream        = (FILE *)NULL;
 
@@ -603,6 +1299,8 @@ _PUBLIC  int32_t main(int argc, char *argv[])
           (void)fprintf(stderr,"              [-protect:FALSE]\n");
           (void)fprintf(stderr,"              [-delete:FALSE]\n");
           (void)fprintf(stderr,"              [-exit_empty:FALSE]\n");
+          (void)fprintf(stderr,"              [-workers <number of sweep workers:%d>]\n",DEFAULT_WORKERS);
+          (void)fprintf(stderr,"              [-period <sweep period milliseconds:%d>]\n",DEFAULT_PERIOD);
           (void)fprintf(stderr,"              [>& <error/log file>]\n\n");
           (void)fflush(stderr);
 
@@ -624,6 +1322,36 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        {  do_exit_empty = TRUE;
           ++decoded;
        }
+       else if (strcmp(argv[i],"-workers") == 0)
+       {  if (i == argc - 1 || sscanf(argv[i+1],"%u",&n_workers) != 1 || n_workers > MAX_WORKERS)
+          {  if (do_verbose == TRUE)
+             {  (void)strdate(date);
+                (void)fprintf(stderr,"%s kepher (%d@%s): %sERROR%s number of workers must be between 0 and %d\n",
+                                                              date,getpid(),hostname,boldOn,boldOff,MAX_WORKERS);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          ++i;
+          decoded += 2;
+       }
+       else if (strcmp(argv[i],"-period") == 0)
+       {  if (i == argc - 1 || sscanf(argv[i+1],"%u",&sweep_period) != 1 || sweep_period == 0)
+          {  if (do_verbose == TRUE)
+             {  (void)strdate(date);
+                (void)fprintf(stderr,"%s kepher (%d@%s): %sERROR%s sweep period must be a positive number of milliseconds\n",
+                                                                                        date,getpid(),hostname,boldOn,boldOff);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          ++i;
+          decoded += 2;
+       }
        else if (strcmp(argv[i],"-mdir") == 0)
        {  if (i == argc - 1 || argv[i+1][0] == '-')
           {  if (do_verbose == TRUE)
@@ -705,6 +1433,7 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        (void)fprintf(stderr,"\n    Process %d on host \"%s\" monitoring \"%s\" for stale .tmp, .fifo, .run, .lock and .lid files\n",
                                                                                                              getpid(),hostname,mdir);
        (void)fprintf(stderr,"    Stale PSRP/P3 communications channels and lockposts will also be removed\n");
+       (void)fprintf(stderr,"    Directory swept every %d milliseconds (%d sweep workers)\n",sweep_period,n_workers);
 
        if (mpid != (-1))
           #ifdef HAVE_PROCFS
@@ -841,6 +1570,25 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     dirp = opendir(mdir);
 
 
+    /*------------------------------------------------------*/
+    /* Watch directory (before we build the index) so that  */
+    /* we do not miss any changes to it                     */
+    /*------------------------------------------------------*/
+
+    if (dirp == (DIR *)NULL                                                                                                  ||
+        (inotify_des = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == (-1)                                                      ||
+        inotify_add_watch(inotify_des,mdir,IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR) == (-1)          )
+    {  if (do_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s kepher (%d@%s): %sERROR%s cannot watch directory \"%s\"\n",
+                                                      date,getpid(),hostname,boldOn,boldOff,mdir);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
+
     /*--------------------------------------------*/
     /* Build shadow files for nominated directory */
     /*--------------------------------------------*/
@@ -850,95 +1598,75 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     else
        (void)create_shadowFiles(FALSE,dirp);
 
+    index_rebuild();
+    start_workers();
+
+
+    /*----------------------------------------------*/
+    /* Wait on monitored process (via pidfd) so we  */
+    /* see it exit without polling it               */
+    /*----------------------------------------------*/
+
+    #ifdef SYS_pidfd_open
+    if (mpid != (-1))
+       mpid_fd = (int32_t)syscall(SYS_pidfd_open,mpid,0);
+    #endif /* SYS_pidfd_open */
+
     while (looper == TRUE)
-    {   if (mpid != (-1) && kill(mpid,SIGCONT) == (-1))
+    {   if (term_signal != 0)
            looper = FALSE;
-        else if (do_exit_empty == TRUE && nfiles <= 0)
+        else if (mpid != (-1) && (mpid_exited == TRUE || kill(mpid,SIGCONT) == (-1)))
+           looper = FALSE;
+        else if (do_exit_empty == TRUE && __atomic_load_n(&nfiles,__ATOMIC_RELAXED) <= 0)
            looper = FALSE;
  
         if (looper == TRUE)
-        {  if ((next_item = readdir(dirp)) == (struct dirent *)NULL)
-              (void)rewinddir(dirp);
-           else if (strcmp(next_item->d_name,".") != 0 && strcmp(next_item->d_name,"..") != 0)
-           {   (void)strcpy(nextFile,next_item->d_name);
+        {  uint64_t      now,
+                         next_sweep;
+           int32_t       n_fds = 1;
+           struct pollfd fds[2];
 
+           sweep();
+           publish_status();
 
-               /*-----------------------------------------*/
-               /* Files associated with PUPS/P3 processes */ 
-               /* and shells                              */
-               /*-----------------------------------------*/
 
-               if ((nextPid = getPidFromFname(nextFile)) != (-1))
-               {  if (kill(nextPid,SIGCONT) == (-1))
-                     (void)deleteFile(TRUE, FALSE, nextPid, nextFile);
-               }
+           /*-------------------------------------------------*/
+           /* Keep index up to date until next sweep is due   */
+           /*-------------------------------------------------*/
 
+           fds[0].fd     = inotify_des;
+           fds[0].events = POLLIN;
 
-               /*--------------------------------------*/
-               /* Protect regular files (with shadows) */
-               /*--------------------------------------*/
+           if (mpid_fd != (-1))
+           {  fds[1].fd     = mpid_fd;
+              fds[1].events = POLLIN;
+              n_fds         = 2;
+           }
 
-               else if (do_protect == TRUE)
-               {
+           next_sweep = now_ms() + sweep_period;
+           while ((now = now_ms()) < next_sweep && term_signal == 0)
+           {     if (poll(fds,n_fds,(int32_t)(next_sweep - now)) <= 0)
+                    continue;
 
-                  /*------------------------------------------*/
-                  /* Shadow exists but shadowed file does not */
-                  /* relink shadowed file                     */
-                  /*------------------------------------------*/
+                 if (fds[0].revents & POLLIN)
+                    index_update();
 
-                  (void)snprintf(nextPathFile,SSIZE,"%s/%s",mdir,(char *)&nextFile[1]);
-                  if (nextFile[0] == '.' && access(nextPathFile,F_OK | R_OK | W_OK) == (-1))
-                  {  (void)snprintf(nextPathShadow,SSIZE,"%s/%s",mdir,nextFile); 
-                     (void)link(nextPathShadow,nextPathFile);
-   
-                     if (do_verbose == TRUE)
-                     {  (void)strdate(date);
-                        (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): file \%s\" lost - relinking\n",boldOn,boldOff,date,getpid(),hostname,(char *)&nextFile[1]); 
-                        (void)fflush(stderr);
-                     }
-                  }
-
-
-                  /*-------------------------------------*/
-                  /* File without shadow - delete it     */
-                  /* if it doesn't have a file extension */
-                  /* we are ignoring                     */
-                  /*-------------------------------------*/
-
-                  else if (nextFile[0] != '.')
-                  {  (void)snprintf(nextPathShadow,SSIZE,"%s/.%s",mdir,nextFile);
-                    
-                     if (access(nextPathShadow,F_OK | R_OK | W_OK) == (-1))
-                     {  if (ignoreFile(nextFile) == FALSE)
-                        {  if (strcmp(nextFile,"kepher.run") != 0)
-                           {  (void)deleteFile(FALSE, TRUE, (-1), nextFile);
-
-                              if (do_verbose == TRUE)
-                              {  (void)strdate(date);
-                                 (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): file \%s\" has no shadow - deleting\n",boldOn,boldOff,date,getpid(),hostname,nextFile); 
-                                 (void)fflush(stderr);
-                              }
-                           }
-                           else
-                           {  (void)snprintf(nextPathFile,SSIZE,"%s/%s",mdir,nextFile);
-                              (void)link(nextPathFile,nextPathShadow);
- 
-                              if (do_verbose == TRUE)
-                              {  (void)strdate(date);
-                                 (void)fprintf(stderr,"%sWARNING%s %s kepher (%d@%s): cannot delete \"kepher.run\"\n",boldOn,boldOff,date,getpid(),hostname); 
-                                 (void)fflush(stderr);
-                              }
-                           }
-                        }
-                     }
-                  }
-               }
-            }
-
-            (void)usleep(10000);
+
+                 /*----------------------------------*/
+                 /* Monitored process has exited     */
+                 /*----------------------------------*/
+
+                 if (n_fds == 2 && fds[1].revents & POLLIN)
+                 {  mpid_exited = TRUE;
+                    break;
+                 }
+           }
         }
     }
 
+    if (term_signal != 0)
+       kepher_exit(term_signal);
+
     if (do_verbose == TRUE && kill(mpid,SIGCONT) == (-1))
     {  (void)strdate(date);
 
@@ -953,5 +1681,5 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        (void)fflush(stderr);
     }
 
-    (void)term_handler(9999);
+    kepher_exit(9999);
 }
@@ -8,8 +8,8 @@
               NE3 4RT
               United Kingdom
 
-     Version: 3.03 
-     Dated:   10th December 2024
+     Version: 3.04 
+     Dated:   19th October 2026
      E-mail:  mao@tumblingdice.co.uk
 -------------------------------------------*/
 
@@ -25,9 +25,17 @@
 #include <signal.h>
 #include <time.h>
 #include <stdint.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
 
 
+#ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE
+#endif /* _XOPEN_SOURCE */
 #include <unistd.h>
 
 
@@ -38,7 +46,7 @@
 /* Vesion of lyosome */
 /*-------------------*/
 
-#define  LYOSOME_VERSION    "3.03"
+#define  LYOSOME_VERSION    "3.04"
 #define  FOREVER            (-9999.0)
 
 
@@ -56,6 +64,41 @@
 #define ARGC                255
 
 
+/*----------------------------------------------------*/
+/* Deletion engine (worker pool) and event loop sizes */
+/*----------------------------------------------------*/
+
+#define DEFAULT_WORKERS     4
+#define MAX_WORKERS         64
+#define EVENT_BUFSIZE       4096
+#define POLL_DELAY          10
+#define OWNER_POLL_DELAY    1000
+
+
+/*-------------------------------------------------------------*/
+/* Principal (file system object which is to be destroyed). A  */
+/* single lyosome can look after many principals, each with    */
+/* its own lifetime                                            */
+/*-------------------------------------------------------------*/
+
+typedef struct {   char          path[SSIZE];                   // Principal
+                   char          link[SSIZE];                   // Protective link (protect mode)
+                   _BOOLEAN      is_directory;                  // TRUE if principal is a directory
+                   _BOOLEAN      protect;                       // TRUE if principal is protected
+                   _BOOLEAN      live;                          // FALSE once principal destroyed
+                   time_t        lifetime;                      // Lifetime (seconds) or FOREVER
+               } principal_type;
+
+
+/*------------------------------------------------------------*/
+/* Directory found while deleting a tree. Directories are     */
+/* emptied (in parallel) and then removed deepest first       */
+/*------------------------------------------------------------*/
+
+typedef struct {   char     *path;                              // Directory (relative to root of tree)
+                   uint32_t depth;                              // Depth (below root of tree)
+               } dir_type;
+
 
 /*------------------*/
 /* Global variables */
@@ -64,19 +107,42 @@
 _PRIVATE char          boldOn [8]             = "\e[1m",    // Make character bold
                        boldOff[8]             = "\e[m" ;    // Make character non-bold
 
-_PRIVATE unsigned char principal[SSIZE]       = "";
-_PRIVATE unsigned char principal_link[SSIZE]  = "";
-_PRIVATE unsigned char hostname[SSIZE]        = "";
-_PRIVATE unsigned char pname[SSIZE]           = "";
-_PRIVATE unsigned char new_pname[SSIZE]       = "";
-_PRIVATE unsigned char ppath[SSIZE]           = "";
+_PRIVATE principal_type *principal_list       = (principal_type *)NULL;
+_PRIVATE uint32_t      n_principals           = 0;
+_PRIVATE char          hostname[SSIZE]        = "";
+_PRIVATE char          pname[SSIZE]           = "";
+_PRIVATE char          new_pname[SSIZE]       = "";
+_PRIVATE char          ppath[SSIZE]           = "";
 _PRIVATE uint32_t      pname_pos              = 0;
-_PRIVATE _BOOLEAN      principal_is_directory = FALSE;
 _PRIVATE _BOOLEAN      do_daemon              = FALSE;
 _PRIVATE _BOOLEAN      do_protect             = FALSE;
 _PRIVATE _BOOLEAN      do_verbose             = FALSE;
 _PRIVATE time_t        start_time             = 0;
 _PRIVATE time_t        lifetime               = 60;
+_PRIVATE pid_t         owner_pid              = 0;
+_PRIVATE int32_t       owner_pidfd            = (-1);
+_PRIVATE int32_t       inotify_des            = (-1);
+_PRIVATE _BOOLEAN      owner_exited           = FALSE;
+
+
+/*-------------------------------------------------------------*/
+/* Deletion engine state. Workers share a list of directories  */
+/* (next_dir indexes the next directory to be emptied)         */
+/*-------------------------------------------------------------*/
+
+_PRIVATE uint32_t        n_workers            = DEFAULT_WORKERS;
+_PRIVATE uint32_t        rate                 = 0;
+_PRIVATE uint64_t        next_slot            = 0;
+_PRIVATE dir_type        *dir_list            = (dir_type *)NULL;
+_PRIVATE uint32_t        n_dirs               = 0;
+_PRIVATE uint32_t        n_dir_alloc          = 0;
+_PRIVATE uint32_t        next_dir             = 0;
+_PRIVATE uint32_t        n_busy               = 0;
+_PRIVATE uint64_t        n_unlinked           = 0;
+_PRIVATE int32_t         root_fd              = (-1);
+_PRIVATE pthread_mutex_t dir_mutex            = PTHREAD_MUTEX_INITIALIZER;
+_PRIVATE pthread_cond_t  dir_cond             = PTHREAD_COND_INITIALIZER;
+_PRIVATE pthread_mutex_t rate_mutex           = PTHREAD_MUTEX_INITIALIZER;
 
 
 
@@ -84,26 +150,398 @@ _PRIVATE time_t        lifetime               = 60;
 /*-----------------------------------------------*/
 /* Functions which are local to this application */
 /*-----------------------------------------------*/
-/*---------------------*/
-/* Handler for SIGALRM */
-/*---------------------*/
+/*--------------------------------------------------------*/
+/* Pace unlinks (if we are rate limited) so that deleting */
+/* a large tree does not hog the I/O bandwidth of other   */
+/* jobs running on this host                              */
+/*--------------------------------------------------------*/
 
-_PRIVATE void exit_handler(void)
+_PRIVATE void rate_wait(void)
+
+{   uint64_t        now,
+                    slot;
+    struct timespec ts;
+
+    if (rate == 0)
+       return;
+
+    (void)clock_gettime(CLOCK_MONOTONIC,&ts);
+    now = (uint64_t)ts.tv_sec*1000000000UL + (uint64_t)ts.tv_nsec;
+
+    (void)pthread_mutex_lock(&rate_mutex);
+
+    if (next_slot < now)
+       next_slot = now;
+
+    slot       = next_slot;
+    next_slot += 1000000000UL / rate;
+
+    (void)pthread_mutex_unlock(&rate_mutex);
+
+    if (slot > now)
+    {  ts.tv_sec  = slot / 1000000000UL;
+       ts.tv_nsec = slot % 1000000000UL;
+
+       while (clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&ts,(struct timespec *)NULL) != 0)
+             continue;
+    }
+}
+
+
+
+
+/*----------------------------------------------------*/
+/* Add directory to list of directories to be emptied */
+/* (caller must hold directory mutex)                 */
+/*----------------------------------------------------*/
+
+_PRIVATE _BOOLEAN add_dir(char *path, const uint32_t depth)
+
+{   if (n_dirs == n_dir_alloc)
+    {  dir_type *new_list = (dir_type *)NULL;
+
+       if ((new_list = (dir_type *)realloc((void *)dir_list,(n_dir_alloc + 256)*sizeof(dir_type))) == (dir_type *)NULL)
+          return(FALSE);
+
+       dir_list     = new_list;
+       n_dir_alloc += 256;
+    }
+
+    dir_list[n_dirs].path  = path;
+    dir_list[n_dirs].depth = depth;
+    ++n_dirs;
+
+    return(TRUE);
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Open directory (relative to root of tree being deleted)   */
+/* one component at a time. Symbolic links are never         */
+/* followed so a directory which has been replaced by a link */
+/* cannot take us out of the tree                            */
+/*-----------------------------------------------------------*/
+
+_PRIVATE int32_t open_subdir(const char *path)
+
+{   int32_t fd,
+            next_fd;
+    char    *tmpstr        = (char *)NULL,
+            *component     = (char *)NULL,
+            *save_ptr      = (char *)NULL;
+
+    if ((tmpstr = strdup(path)) == (char *)NULL)
+       return(-1);
+
+    if ((fd = fcntl(root_fd,F_DUPFD_CLOEXEC,0)) != (-1))
+    {  for (component = strtok_r(tmpstr,"/",&save_ptr); component != (char *)NULL; component = strtok_r((char *)NULL,"/",&save_ptr))
+       {   next_fd = openat(fd,component,O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+           (void)close(fd);
+
+           if ((fd = next_fd) == (-1))
+              break;
+       }
+    }
+
+    (void)free((void *)tmpstr);
+    return(fd);
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Deletion worker. Takes directories from the shared list, */
+/* unlinks everything in them which is not a directory and  */
+/* adds their subdirectories to the list                    */
+/*----------------------------------------------------------*/
 
-{   if (principal_is_directory == TRUE)
-    {  unsigned char rm_cmd[SSIZE] = "";
+_PRIVATE void *delete_worker(void *arg)
 
-       (void)snprintf(rm_cmd,SSIZE,"rm -rf %s",principal);
-       (void)system(rm_cmd);
+{   while (TRUE)
+    {   uint32_t      index,
+                      depth;
+        int32_t       fd;
+        char          *path       = (char *)NULL;
+        DIR           *dirp       = (DIR *)NULL;
+        struct dirent *next_entry = (struct dirent *)NULL;
+
+
+        /*-------------------------------------------------*/
+        /* Wait for work. We are finished when there are   */
+        /* no directories left and no worker can add more  */
+        /*-------------------------------------------------*/
+
+        (void)pthread_mutex_lock(&dir_mutex);
+
+        while (next_dir == n_dirs && n_busy > 0)
+              (void)pthread_cond_wait(&dir_cond,&dir_mutex);
+
+        if (next_dir == n_dirs)
+        {  (void)pthread_cond_broadcast(&dir_cond);
+           (void)pthread_mutex_unlock(&dir_mutex);
+
+           return((void *)NULL);
+        }
+
+        index = next_dir++;
+        path  = dir_list[index].path;
+        depth = dir_list[index].depth;
+        ++n_busy;
+
+        (void)pthread_mutex_unlock(&dir_mutex);
+
+
+        /*-------------------*/
+        /* Empty directory   */
+        /*-------------------*/
+
+        if ((fd = open_subdir(path)) != (-1) && (dirp = fdopendir(fd)) == (DIR *)NULL)
+           (void)close(fd);
+
+        if (dirp != (DIR *)NULL)
+        {  while ((next_entry = readdir(dirp)) != (struct dirent *)NULL)
+           {  _BOOLEAN    is_dir = FALSE;
+              struct stat buf;
+
+              if (strcmp(next_entry->d_name,".") == 0 || strcmp(next_entry->d_name,"..") == 0)
+                 continue;
+
+
+              /*----------------------------------------------*/
+              /* Never follow symbolic links out of the tree  */
+              /*----------------------------------------------*/
+
+              if (next_entry->d_type == DT_DIR)
+                 is_dir = TRUE;
+              else if (next_entry->d_type == DT_UNKNOWN                                       &&
+                       fstatat(dirfd(dirp),next_entry->d_name,&buf,AT_SYMLINK_NOFOLLOW) == 0  &&
+                       S_ISDIR(buf.st_mode))
+                 is_dir = TRUE;
+
+              if (is_dir == TRUE)
+              {  size_t size;
+                 char   *subdir = (char *)NULL;
+
+                 size = strlen(path) + strlen(next_entry->d_name) + 2;
+                 if ((subdir = (char *)malloc(size)) == (char *)NULL)
+                    continue;
+
+                 if (path[0] == '\0')
+                    (void)strlcpy(subdir,next_entry->d_name,size);
+                 else
+                    (void)snprintf(subdir,size,"%s/%s",path,next_entry->d_name);
+
+                 (void)pthread_mutex_lock(&dir_mutex);
+
+                 if (add_dir(subdir,depth + 1) == FALSE)
+                    (void)free((void *)subdir);
+                 else
+                    (void)pthread_cond_signal(&dir_cond);
+
+                 (void)pthread_mutex_unlock(&dir_mutex);
+              }
+              else
+              {  rate_wait();
+
+                 if (unlinkat(dirfd(dirp),next_entry->d_name,0) == 0)
+                    (void)__atomic_add_fetch(&n_unlinked,1,__ATOMIC_RELAXED);
+              }
+           }
+
+           (void)closedir(dirp);
+        }
+
+        (void)pthread_mutex_lock(&dir_mutex);
+
+        --n_busy;
+        (void)pthread_cond_broadcast(&dir_cond);
+
+        (void)pthread_mutex_unlock(&dir_mutex);
     }
+}
+
+
+
+
+/*---------------------------------*/
+/* Order directories deepest first */
+/*---------------------------------*/
+
+_PRIVATE int32_t depth_compare(const void *a, const void *b)
+
+{   const dir_type *dir_a = (const dir_type *)a,
+                   *dir_b = (const dir_type *)b;
+
+    if (dir_a->depth > dir_b->depth)
+       return(-1);
+    else if (dir_a->depth < dir_b->depth)
+       return(1);
+
+    return(0);
+}
+
+
+
+
+/*----------------------------------------------------------------*/
+/* Delete directory tree (without forking rm). The tree is        */
+/* emptied by a (bounded) pool of workers and its directories are */
+/* then removed deepest first                                     */
+/*----------------------------------------------------------------*/
+
+_PRIVATE void delete_tree(const char *path)
+
+{   uint32_t  i,
+              n_started = 0;
+    char      *root     = (char *)NULL;
+    sigset_t  set,
+              old_set;
+    pthread_t worker[MAX_WORKERS];
+
+
+    /*-----------------------------------------------------*/
+    /* Principal has been replaced by something which is   */
+    /* not a directory (e.g. a symbolic link) -- remove it */
+    /* (but not what it points to)                         */
+    /*-----------------------------------------------------*/
+
+    if ((root_fd = open(path,O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC)) == (-1))
+    {  (void)unlink(path);
+       return;
+    }
+
+    if ((root = strdup("")) == (char *)NULL)
+    {  (void)close(root_fd);
+       return;
+    }
+
+    n_dirs     = 0;
+    next_dir   = 0;
+    n_busy     = 0;
+    n_unlinked = 0;
+    (void)add_dir(root,0);
+
+
+    /*------------------------------------------------*/
+    /* Workers must not run our signal handlers       */
+    /*------------------------------------------------*/
+
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_BLOCK,&set,&old_set);
+
+    for (i=0; i<n_workers; ++i)
+    {  if (pthread_create(&worker[n_started],(pthread_attr_t *)NULL,&delete_worker,(void *)NULL) == 0)
+          ++n_started;
+    }
+
+    (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
+
+
+    /*-----------------------------------------*/
+    /* No threads -- do the work ourself       */
+    /*-----------------------------------------*/
+
+    if (n_started == 0)
+       (void)delete_worker((void *)NULL);
+
+    for (i=0; i<n_started; ++i)
+       (void)pthread_join(worker[i],(void **)NULL);
+
+
+    /*-------------------------------------------*/
+    /* Directories are now empty -- remove them  */
+    /*-------------------------------------------*/
+
+    qsort((void *)dir_list,n_dirs,sizeof(dir_type),&depth_compare);
+
+    for (i=0; i<n_dirs; ++i)
+    {  char *leaf = (char *)NULL;
+
+
+       /*-------------------------------------------*/
+       /* Remove directory from its parent (root of */
+       /* tree is removed last)                     */
+       /*-------------------------------------------*/
+
+       if (dir_list[i].depth > 0)
+       {  int32_t parent_fd = (-1);
+
+          if ((leaf = strrchr(dir_list[i].path,'/')) == (char *)NULL)
+          {  leaf      = dir_list[i].path;
+             parent_fd = open_subdir("");
+          }
+          else
+          {  *leaf     = '\0';
+             parent_fd = open_subdir(dir_list[i].path);
+             ++leaf;
+          }
+
+          if (parent_fd != (-1))
+          {  (void)unlinkat(parent_fd,leaf,AT_REMOVEDIR);
+             (void)close(parent_fd);
+          }
+       }
+
+       (void)free((void *)dir_list[i].path);
+    }
+
+    (void)close(root_fd);
+    root_fd = (-1);
+
+    (void)rmdir(path);
+
+    if (do_verbose == TRUE)
+    {  (void)fprintf(stderr,"%s (%d@%s): deleted tree \"%s\" (%lu files, %d directories, %d workers)\n",
+                                    pname,getpid(),hostname,path,n_unlinked,n_dirs,n_started);
+       (void)fflush(stderr);
+    }
+
+    n_dirs   = 0;
+    next_dir = 0;
+}
+
+
+
+
+/*------------------------------*/
+/* Destroy (expired) principal  */
+/*------------------------------*/
+
+_PRIVATE void destroy_principal(principal_type *p)
+
+{   if (p->is_directory == TRUE)
+       delete_tree(p->path);
 
     else
-    {  (void)unlink(principal_link);
-       (void)unlink(principal);
+    {  (void)unlink(p->link);
+       (void)unlink(p->path);
     }
 
-    (void)fprintf(stderr,"\n%s (%d@%s): %sWARNING%s lifetime of principal [%s] expired -- deleted\n\n",pname,getpid(),hostname,boldOn,boldOff,principal);
+    p->live = FALSE;
+
+    (void)fprintf(stderr,"\n%s (%d@%s): %sWARNING%s lifetime of principal [%s] expired -- deleted\n\n",pname,getpid(),hostname,boldOn,boldOff,p->path);
     (void)fflush(stderr);
+}
+
+
+
+
+/*----------------------------------------------*/
+/* Destroy all principals which are still live  */
+/* and exit                                     */
+/*----------------------------------------------*/
+
+_PRIVATE void exit_handler(void)
+
+{   uint32_t i;
+
+    for (i=0; i<n_principals; ++i)
+    {  if (principal_list[i].live == TRUE)
+          destroy_principal(&principal_list[i]);
+    }
 
     exit(0);
 }
@@ -116,7 +554,12 @@ _PRIVATE void exit_handler(void)
 
 _PRIVATE int32_t term_handler(const int32_t signum)
 
-{   (void)unlink(principal_link);
+{   uint32_t i;
+
+    for (i=0; i<n_principals; ++i)
+    {  if (principal_list[i].protect == TRUE)
+          (void)unlink(principal_list[i].link);
+    }
 
     if (strncmp(ppath,"/tmp",4) == 0)
        (void)unlink(ppath);
@@ -148,20 +591,27 @@ _PRIVATE int32_t term_handler(const int32_t signum)
 /*--------------------------*/
 
 _PRIVATE int32_t rejuvenation_handler(const int32_t signum)
-{
-    if (lifetime != FOREVER)
-    {  start_time = time((time_t *)NULL);
 
-       if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): lifetime (of principal \"%s\") reset (%d seconds)\n\n",pname,getpid(),hostname,principal,lifetime);
-          (void)fflush(stderr);
+{   uint32_t i;
+
+    start_time = time((time_t *)NULL);
+
+    for (i=0; i<n_principals; ++i)
+    {  if (principal_list[i].live == FALSE)
+          continue;
+
+       if (principal_list[i].lifetime != FOREVER)
+       {  if (do_verbose == TRUE)
+          {  (void)fprintf(stderr,"\n%s (%d@%s): lifetime (of principal \"%s\") reset (%d seconds)\n\n",pname,getpid(),hostname,principal_list[i].path,principal_list[i].lifetime);
+             (void)fflush(stderr);
+          }
        }
-    }
 
-    else
-    {  if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): lifetime (of principal \"%s\") is unlimited\n\n",pname,getpid(),hostname,principal);
-          (void)fflush(stderr);
+       else
+       {  if (do_verbose == TRUE)
+          {  (void)fprintf(stderr,"\n%s (%d@%s): lifetime (of principal \"%s\") is unlimited\n\n",pname,getpid(),hostname,principal_list[i].path);
+             (void)fflush(stderr);
+          }
        }
     }
 
@@ -177,10 +627,7 @@ _PRIVATE int32_t rejuvenation_handler(const int32_t signum)
 
 _PRIVATE int32_t status_handler(const int32_t signum)
 
-{   time_t        lifetime_left  = 0;
-    unsigned char ftype[SSIZE]   = "";
-
-    lifetime_left = lifetime - (time((time_t *)NULL) - start_time); 
+{   uint32_t i;
 
     (void)fprintf(stderr,"\nlyosome lightweight file destructor version %s, (C) Tumbling Dice, 2004-2024 (gcc %s: built %s %s)\n",LYOSOME_VERSION,__VERSION__,__TIME__,__DATE__);
 
@@ -199,12 +646,31 @@ _PRIVATE int32_t status_handler(const int32_t signum)
     else
        (void)fprintf(stderr,"    protect mode                  : off\n");
 
-    (void)fprintf(stderr,"    protecting file systems object: \"%s\"\n",principal);
+    (void)fprintf(stderr,"    deletion workers              : %d\n",n_workers);
 
-    if (lifetime == FOREVER)
-       (void)fprintf(stderr,"    monitoring period             : indefinite\n");
+    if (rate == 0)
+       (void)fprintf(stderr,"    deletion rate                 : unlimited\n");
     else
-       (void)fprintf(stderr,"    monitoring period             : %04d seconds (%04d seconds left)\n",lifetime,lifetime_left);
+       (void)fprintf(stderr,"    deletion rate                 : %d unlinks/second\n",rate);
+
+    if (owner_pid > 0)
+       (void)fprintf(stderr,"    owner process                 : %d\n",owner_pid);
+
+    for (i=0; i<n_principals; ++i)
+    {  time_t lifetime_left;
+
+       if (principal_list[i].live == FALSE)
+          continue;
+
+       (void)fprintf(stderr,"    protecting file systems object: \"%s\"\n",principal_list[i].path);
+
+       lifetime_left = principal_list[i].lifetime - (time((time_t *)NULL) - start_time); 
+
+       if (principal_list[i].lifetime == FOREVER)
+          (void)fprintf(stderr,"    monitoring period             : indefinite\n");
+       else
+          (void)fprintf(stderr,"    monitoring period             : %04d seconds (%04d seconds left)\n",principal_list[i].lifetime,lifetime_left);
+    }
 
     (void)fflush(stderr);
 
@@ -218,7 +684,7 @@ _PRIVATE int32_t status_handler(const int32_t signum)
 /* Extract leaf from the end of pathname */
 /*---------------------------------------*/
 
-_PRIVATE _BOOLEAN strleaf(const unsigned char *pathname, unsigned char *leaf)
+_PRIVATE _BOOLEAN strleaf(const char *pathname, char *leaf)
 
 {   size_t i;
 
@@ -228,7 +694,7 @@ _PRIVATE _BOOLEAN strleaf(const unsigned char *pathname, unsigned char *leaf)
     }
 
     if (i > 0)
-       (void)strlcpy(leaf,(unsigned char *)&pathname[i+1],SSIZE);
+       (void)strlcpy(leaf,(char *)&pathname[i+1],SSIZE);
     else
        (void)strlcpy(leaf,pathname,SSIZE);
 
@@ -242,10 +708,10 @@ _PRIVATE _BOOLEAN strleaf(const unsigned char *pathname, unsigned char *leaf)
 /* Make sure path is absolute */
 /*----------------------------*/
 
-_PRIVATE  int32_t absolute_path(const unsigned char *pathname, unsigned char *absolute_pathname)
+_PRIVATE  int32_t absolute_path(const char *pathname, char *absolute_pathname)
 
-{   unsigned char leaf[SSIZE]         = "",
-                  current_path[SSIZE] = "";
+{   char leaf[SSIZE]         = "",
+         current_path[SSIZE] = "";
 
 
     /*---------------*/
@@ -272,17 +738,254 @@ _PRIVATE  int32_t absolute_path(const unsigned char *pathname, unsigned char *ab
 
 
 
+/*-------------------------------------------------------*/
+/* Get (pollable) descriptor for process (Linux pidfd)   */
+/*-------------------------------------------------------*/
+
+_PRIVATE int32_t lyosome_pidfd_open(const pid_t pid)
+
+{
+    #ifdef SYS_pidfd_open
+    return((int32_t)syscall(SYS_pidfd_open,pid,0));
+    #else
+    errno = ENOSYS;
+    return(-1);
+    #endif /* SYS_pidfd_open */
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Make protective link to (regular file) principal. If we have  */
+/* a pathname the link is made on its leaf                       */
+/*---------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN protect_principal(principal_type *p)
+
+{   char *leaf = (char *)NULL;
+
+    if ((leaf = strrchr(p->path,'/')) != (char *)NULL)
+    {  char branch[SSIZE] = "";
+
+       (void)strlcpy(branch,p->path,SSIZE);
+       branch[leaf - p->path + 1] = '\0';
+
+       (void)snprintf(p->link,SSIZE,"%s.%s",branch,leaf + 1);
+    }
+
+
+    /*-----------------*/
+    /* Simple filename */
+    /*-----------------*/
+
+    else
+       (void)snprintf(p->link,SSIZE,".%s.%d.tmp",p->path,getpid());
+
+    if (link(p->path,p->link) == (-1))
+       return(FALSE);
+
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Watch the directory which contains principal, so we are     */
+/* woken when the principal (or its protective link) is        */
+/* deleted or renamed                                          */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void watch_principal(const principal_type *p)
+
+{   char *leaf           = (char *)NULL,
+         parent[SSIZE]   = "";
+
+    if (inotify_des == (-1))
+       return;
+
+    (void)strlcpy(parent,p->path,SSIZE);
+    if ((leaf = strrchr(parent,'/')) == (char *)NULL)
+       (void)strlcpy(parent,".",SSIZE);
+    else if (leaf == parent)
+       parent[1] = '\0';
+    else
+       *leaf = '\0';
+
+    if (inotify_add_watch(inotify_des,parent,IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR) == (-1))
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"%s (%d@%s): cannot watch \"%s\" (polling)\n",pname,getpid(),hostname,parent);
+          (void)fflush(stderr);
+       }
+
+       (void)close(inotify_des);
+       inotify_des = (-1);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Check principals. Protected principals which have been      */
+/* deleted are relinked, unprotected principals which have     */
+/* been deleted are dropped. Returns number of live principals */
+/*-------------------------------------------------------------*/
+
+_PRIVATE uint32_t check_principals(void)
+
+{   uint32_t       i,
+                   n_live = 0;
+    principal_type *p     = (principal_type *)NULL;
+
+    for (i=0; i<n_principals; ++i)
+    {   p = &principal_list[i];
+
+        if (p->live == FALSE)
+           continue;
+
+        if (p->protect == TRUE)
+        {  if (access(p->path,F_OK | R_OK | W_OK) == (-1) && access(p->link,F_OK | R_OK | W_OK) == (-1))
+           {  if (do_verbose == TRUE)
+              {  (void)fprintf(stderr,"\n%s (%d@%s): %sWARNING%s lost monitored file system object [%s] -- aborting\n\n",pname,getpid(),hostname,boldOn,boldOff,p->path);
+                 (void)fflush(stderr);
+              }
+
+              exit(255);
+           }
+
+           else if (access(p->path,F_OK | R_OK | W_OK) == (-1))
+           {  (void)link(p->link,p->path);
+              if (do_verbose == TRUE)
+              {  (void)fprintf(stderr,"%s (%d@%s): %sWARNING%s unexpected attempt to delete monitored file system object [%s] -- relinking\n",pname,getpid(),hostname,boldOn,boldOff,p->path);
+                 (void)fflush(stderr);
+              }
+           }
+
+           else if (access(p->link,F_OK | R_OK | W_OK) == (-1))
+              (void)link(p->path,p->link);
+        }
+
+
+        /*------------------------------*/
+        /* Nothing to monitor (so drop) */
+        /*------------------------------*/
+
+        else if (access(p->path,F_OK | R_OK | W_OK) == (-1))
+        {  if (do_verbose == TRUE)
+           {  (void)fprintf(stderr,"%s (%d@%s): monitored file system object [%s] deleted\n",pname,getpid(),hostname,p->path);
+              (void)fflush(stderr);
+           }
+
+           p->live = FALSE;
+           continue;
+        }
+
+        ++n_live;
+    }
+
+    return(n_live);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Wait until a principal expires, a watched directory changes   */
+/* or the owner process terminates. Falls back to polling if     */
+/* inotify (or pidfd) is not available                           */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void wait_events(void)
+
+{   _IMMORTAL char event_buf[EVENT_BUFSIZE] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    uint32_t      i,
+                  n_fds   = 0;
+    int32_t       timeout = (-1);
+    time_t        now;
+    struct pollfd pfd[2];
+
+    now = time((time_t *)NULL);
+
+
+    /*--------------------------------------*/
+    /* Time until next principal expires    */
+    /*--------------------------------------*/
+
+    for (i=0; i<n_principals; ++i)
+    {  if (principal_list[i].live == TRUE && principal_list[i].lifetime != FOREVER)
+       {  time_t left;
+
+          if ((left = start_time + principal_list[i].lifetime - now) < 0)
+             left = 0;
+
+          if (timeout == (-1) || left*1000 < timeout)
+             timeout = left*1000;
+       }
+    }
+
+    if (inotify_des == (-1) && (timeout == (-1) || timeout > POLL_DELAY))
+       timeout = POLL_DELAY;
+
+    if (owner_pid > 0 && owner_pidfd == (-1) && (timeout == (-1) || timeout > OWNER_POLL_DELAY))
+       timeout = OWNER_POLL_DELAY;
+
+    if (inotify_des != (-1))
+    {  pfd[n_fds].fd      = inotify_des;
+       pfd[n_fds].events  = POLLIN;
+       pfd[n_fds].revents = 0;
+       ++n_fds;
+    }
+
+    if (owner_pidfd != (-1))
+    {  pfd[n_fds].fd      = owner_pidfd;
+       pfd[n_fds].events  = POLLIN;
+       pfd[n_fds].revents = 0;
+       ++n_fds;
+    }
+
+
+    /*---------------------------------------------------*/
+    /* Signals (e.g. rejuvenation) interrupt the wait    */
+    /* so the expiry time is always recomputed           */
+    /*---------------------------------------------------*/
+
+    (void)poll(pfd,n_fds,timeout);
+
+
+    /*-------------------------------------------------*/
+    /* Owner has exited (pidfd stays readable so we    */
+    /* must not poll it again)                         */
+    /*-------------------------------------------------*/
+
+    if (owner_pidfd != (-1) && (pfd[n_fds - 1].revents & POLLIN))
+       owner_exited = TRUE;
+
+
+    /*-------------------------------------------------*/
+    /* Events only tell us to look at the principals   */
+    /*-------------------------------------------------*/
+
+    if (inotify_des != (-1))
+    {  while (read(inotify_des,event_buf,EVENT_BUFSIZE) > 0)
+             continue;
+    }
+}
+
+
+
+
 /*------------------*/
 /* Main entry point */
 /*------------------*/
 
 _PUBLIC  int32_t main(int argc, char *argv[])
 
-{   uint32_t      i,
-                  decoded        = 0,
-                  p_index        = 1;
+{   uint32_t      i;
 
-    unsigned char tmpstr[SSIZE]  = "";
+    char          tmpstr[SSIZE]  = "";
 
     sigset_t      set;
     struct stat   statBuf;
@@ -322,13 +1025,31 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        (void)fprintf(stderr,"               [-lifetime <destruct delay in seconds:60>]\n");
        (void)fprintf(stderr,"               [-always:FALSE]\n");
        (void)fprintf(stderr,"               [-daemon:FALSE [<name of daemon process>]]\n");
-       (void)fprintf(stderr,"               [-protect:FALSE]\n\n");
+       (void)fprintf(stderr,"               [-protect:FALSE]\n");
+       (void)fprintf(stderr,"               [-workers <number of deletion workers:%d>]\n",DEFAULT_WORKERS);
+       (void)fprintf(stderr,"               [-rate <maximum unlinks per second:0 (unlimited)>]\n");
+       (void)fprintf(stderr,"               [-owner <PID of owner (destroy principals when it exits)>]\n");
+       (void)fprintf(stderr,"               <principal> [<principal> ...]\n\n");
        (void)fflush(stderr);
 
        exit(0);
     }
 
-    for (i=0; i<argc-1; ++i)
+    /*------------------------------------------------*/
+    /* Principals take the lifetime which is current  */
+    /* when they appear on the command tail           */
+    /*------------------------------------------------*/
+
+    if ((principal_list = (principal_type *)calloc(argc,sizeof(principal_type))) == (principal_type *)NULL)
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s failed to allocate memory for principals\n\n",pname,getpid(),hostname,boldOn,boldOff);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
+    for (i=1; i<argc; ++i)
     {
 
        /*--------------*/
@@ -336,19 +1057,17 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        /*--------------*/
 
        if (strcmp(argv[i],"-verbose") == 0)
-       {  do_verbose = TRUE;
-          ++decoded;
-       }
+          do_verbose = TRUE;
 
 
        /*-------------*/
        /* Daemon mode */
        /*-------------*/
 
-       if (strcmp(argv[i],"-daemon") == 0)
+       else if (strcmp(argv[i],"-daemon") == 0)
        {  do_daemon  = TRUE;
 
-          if (i <= argc - 2 && argv[i+1][0] != '-')
+          if (i < argc - 2 && argv[i+1][0] != '-')
           {  (void)sscanf(argv[i+1],"%s",new_pname); 
 
              if (strcmp(pname,new_pname) == 0)
@@ -361,12 +1080,8 @@ _PUBLIC  int32_t main(int argc, char *argv[])
              }
 
              pname_pos = i + 1;
-
              ++i;
-             decoded += 2;
           }
-          else 
-             ++decoded;
        }
 
 
@@ -374,8 +1089,8 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        /* Monitoring lifetime for principle */
        /*-----------------------------------*/
 
-       if (strcmp(argv[i],"-lifetime") == 0)
-       {  if (i == argc - 2 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&lifetime) != 1 || lifetime < 0) 
+       else if (strcmp(argv[i],"-lifetime") == 0)
+       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%ld",&lifetime) != 1 || lifetime < 0) 
           {  if (do_verbose == TRUE)
              {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s lifetime must be a positive  int32_teger value\n\n",pname,getpid(),hostname,boldOn,boldOff);
                 (void)fflush(stderr);
@@ -385,7 +1100,6 @@ _PUBLIC  int32_t main(int argc, char *argv[])
           }
 
           ++i;
-          decoded += 2;;
        }
 
 
@@ -394,48 +1108,111 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        /*---------------------------*/
 
        else if (strcmp(argv[i],"-always") == 0)
-       {  p_index  = 2;
           lifetime = FOREVER;
 
-          ++decoded;
-       }
-
 
        /*------------------------*/
        /* Homeostatic protection */
        /*------------------------*/
  
        else if (strcmp(argv[i],"-protect") == 0)
-       {  do_protect = TRUE;
-          ++decoded;
+          do_protect = TRUE;
+
+
+       /*--------------------------------------------*/
+       /* Size of worker pool (for deleting trees)   */
+       /*--------------------------------------------*/
+
+       else if (strcmp(argv[i],"-workers") == 0)
+       {  if (i == argc - 1 || sscanf(argv[i+1],"%u",&n_workers) != 1 || n_workers < 1 || n_workers > MAX_WORKERS) 
+          {  if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s number of workers must be between 1 and %d\n\n",pname,getpid(),hostname,boldOn,boldOff,MAX_WORKERS);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          ++i;
        }
-    }
-  
 
-    /*--------------------------------------------*/ 
-    /* Check for unparsed command line parameters */
-    /*--------------------------------------------*/ 
-     
-    if (decoded < argc - 2)
-    {  if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s command tail items unparsed\n\n",pname,getpid(),hostname,boldOn,boldOff);
-          (void)fflush(stderr);
+
+       /*-------------------------------------------*/
+       /* Maximum unlink rate (0 is unlimited)      */
+       /*-------------------------------------------*/
+
+       else if (strcmp(argv[i],"-rate") == 0)
+       {  if (i == argc - 1 || sscanf(argv[i+1],"%u",&rate) != 1) 
+          {  if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s expecting deletion rate (unlinks per second)\n\n",pname,getpid(),hostname,boldOn,boldOff);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          ++i;
        }
 
-       exit(255);
-    }
- 
-    p_index = argc - 1;
 
+       /*-------------------------------------------------*/
+       /* Destroy principals when owner process exits     */
+       /*-------------------------------------------------*/
+
+       else if (strcmp(argv[i],"-owner") == 0)
+       {  if (i == argc - 1 || sscanf(argv[i+1],"%d",&owner_pid) != 1 || owner_pid <= 0 || kill(owner_pid,0) == (-1)) 
+          {  if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s expecting PID of (running) owner process\n\n",pname,getpid(),hostname,boldOn,boldOff);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          ++i;
+       }
+
+
+       /*--------------------------------------------*/
+       /* Check for unparsed command line parameters */
+       /*--------------------------------------------*/
+
+       else if (argv[i][0] == '-')
+       {  if (do_verbose == TRUE)
+          {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s command tail items unparsed\n\n",pname,getpid(),hostname,boldOn,boldOff);
+             (void)fflush(stderr);
+          }
+
+          exit(255);
+       }
+
+
+       /*---------------------*/
+       /* Monitored principal */
+       /*---------------------*/
+
+       else
+       {  principal_type *p = &principal_list[n_principals];
 
-    /*---------------------*/
-    /* Monitored principal */
-    /*---------------------*/
-                              
-    (void)strlcpy(principal,argv[p_index],SSIZE);
-    if (access(principal,F_OK | R_OK | W_OK) == (-1))
+          (void)strlcpy(p->path,argv[i],SSIZE);
+          if (access(p->path,F_OK | R_OK | W_OK) == (-1))
+          {  if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s cannot find principal to monitor [%s]\n\n",pname,getpid(),hostname,boldOn,boldOff,p->path);
+                (void)fflush(stderr);
+             }
+
+             exit(255);
+          }
+
+          p->lifetime = lifetime;
+          p->live     = TRUE;
+          ++n_principals;
+       }
+    }
+
+    if (n_principals == 0)
     {  if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s cannot find principal to monitor [%s]\n\n",pname,getpid(),hostname,boldOn,boldOff,principal);
+       {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s no principal to monitor\n\n",pname,getpid(),hostname,boldOn,boldOff);
           (void)fflush(stderr);
        }
 
@@ -457,100 +1234,68 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     (void)signal(SIGUSR1, (void *)&status_handler);
     (void)signal(SIGUSR2, (void *)&rejuvenation_handler);
 
-    (void)stat(principal,&statBuf);
+    for (i=0; i<n_principals; ++i)
+    {  principal_type *p = &principal_list[i];
 
+       (void)lstat(p->path,&statBuf);
 
-    /*-----------*/
-    /* Directory */
-    /*-----------*/
 
-    if (S_ISDIR(statBuf.st_mode))
-    {  if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): monitoring principal directory \"%s\" for %d seconds\n\n",pname,getpid(),hostname,principal,lifetime);
-          (void)fflush(stderr);
-       }
+       /*-----------*/
+       /* Directory */
+       /*-----------*/
 
-       principal_is_directory = TRUE;
+       if (S_ISDIR(statBuf.st_mode))
+       {  if (do_verbose == TRUE)
+          {  (void)fprintf(stderr,"\n%s (%d@%s): monitoring principal directory \"%s\" for %d seconds\n\n",pname,getpid(),hostname,p->path,p->lifetime);
+             (void)fflush(stderr);
+          }
 
+          p->is_directory = TRUE;
 
-       /*----------------------------*/
-       /* Cannot protect directories */
-       /*----------------------------*/
 
-       if (do_protect == TRUE)
-       {  do_protect = FALSE;
+          /*----------------------------*/
+          /* Cannot protect directories */
+          /*----------------------------*/
 
-          if (do_verbose == TRUE)
+          if (do_protect == TRUE && do_verbose == TRUE)
           {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s cannot protect directories (yet)\n",pname,getpid(),hostname,boldOn,boldOff);
              (void)fflush(stderr);
           }
        }
-    }
-
-
-    /*--------------*/
-    /* Regular file */
-    /*--------------*/
 
-    else if (do_protect == TRUE)
-    {  size_t j;
 
-       /*--------------------------------------------------------------*/
-       /* If we have an absolute path make protective link on its leaf */
-       /*--------------------------------------------------------------*/
+       /*--------------*/
+       /* Regular file */
+       /*--------------*/
 
-       for (j=strlen(principal); j>=0; --j)
+       else if (do_protect == TRUE)
        {
 
-          /*----------------------------------*/
-          /* Is filename actually a pathname? */ 
-          /*----------------------------------*/
-
-          if (principal[j] == '/')
-          {  unsigned char leaf  [SSIZE] = "",
-                           branch[SSIZE] = "";
-
-             (void)strlcpy(leaf,&principal[j+1],SSIZE);
-             (void)strlcpy(branch,principal,SSIZE);
-             branch[j+1] = '\0';
-
-             (void)snprintf(principal_link,SSIZE,"%s.%s",branch,leaf);
-             goto dot_inserted;
-          }
-       }
-
-
-       /*-----------------*/
-       /* Simple filename */
-       /*-----------------*/
-
-       (void)snprintf(principal_link,SSIZE,".%s.%d.tmp",principal,getpid());
-
-dot_inserted:
+          /*-------*/
+          /* Error */
+          /*-------*/
 
+          if (protect_principal(p) == FALSE)
+          {  if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%sERROR%s %s (%d@%s): could not make protective link to regular file [%s] -- aborting\n\n",boldOn,boldOff,pname,getpid(),hostname,p->path);
+                (void)fflush(stderr);
+             }
 
-       /*-------*/
-       /* Error */
-       /*-------*/
-
-       if (link(principal,principal_link) == (-1))
-       {  if (do_verbose == TRUE)
-          {  (void)fprintf(stderr,"\n%sERROR%s %s (%d@%s): could not make protective link to regular file [%s] -- aborting\n\n",boldOn,boldOff,pname,getpid(),hostname,principal);
-             (void)fflush(stderr);
+             exit(255);
           }
 
-          exit(255);
-       }
 
+          /*-------------*/
+          /* Can protect */
+          /*-------------*/
 
-       /*-------------*/
-       /* Can protect */
-       /*-------------*/
+          else
+          {  p->protect = TRUE;
 
-       else
-       {  if (do_verbose == TRUE)
-          {  (void)fprintf(stderr,"\n%s (%d@%s): protecting regular file \"%s\" for %04d seconds\n\n",pname,getpid(),hostname,principal,lifetime);
-             (void)fflush(stderr);
+             if (do_verbose == TRUE)
+             {  (void)fprintf(stderr,"\n%s (%d@%s): protecting regular file \"%s\" for %04d seconds\n\n",pname,getpid(),hostname,p->path,p->lifetime);
+                (void)fflush(stderr);
+             }
           }
        }
     }
@@ -561,7 +1306,7 @@ dot_inserted:
     /*-------------*/
 
     if (do_daemon == TRUE)
-    {  unsigned char tmpPathName[SSIZE]  = "";
+    {  char     tmpPathName[SSIZE]  = "";
        uint32_t nargc         = 1;
        char     *nargv[ARGC]  = { (char *)NULL };
 
@@ -587,7 +1332,7 @@ dot_inserted:
        /* Error */
        /*-------*/
 
-       if ((nargv[0] = (unsigned char *)malloc(SSIZE*sizeof(unsigned char))) == (unsigned char *)NULL)
+       if ((nargv[0] = (char *)malloc(SSIZE*sizeof(char))) == (char *)NULL)
        {  if (do_verbose == TRUE)
           {  (void)fprintf(stderr,"\n%s (%d@%s): %sERROR%s failed to allocate memory for first argument vector\n\n",pname,getpid(),hostname,boldOn,boldOff);
              (void)fflush(stderr);
@@ -613,7 +1358,7 @@ dot_inserted:
              /* Next argument vector element */
              /*------------------------------*/
 
-             if ((nargv[nargc] = (unsigned char *)malloc(SSIZE*sizeof(unsigned char))) != (unsigned char *)NULL)
+             if ((nargv[nargc] = (char *)malloc(SSIZE*sizeof(char))) != (char *)NULL)
              {  (void)strlcpy(nargv[nargc],argv[i],SSIZE);
                 ++nargc;
              }
@@ -639,7 +1384,7 @@ dot_inserted:
        /* Terminate argument list */
        /*-------------------------*/
 
-       nargv[nargc] = (unsigned char *)NULL;
+       nargv[nargc] = (char *)NULL;
 
 
        /*--------*/
@@ -689,65 +1434,72 @@ dot_inserted:
 
 
 
-    /*----------------------------------*/
-    /* Monitor nominated file/directory */
-    /*----------------------------------*/
+    /*-----------------------------------------------------*/
+    /* Watch principals (and owner) rather than polling    */
+    /* them. Descriptors are created after we have become  */
+    /* a daemon (exec would close them)                    */
+    /*-----------------------------------------------------*/
 
-    if (lifetime != FOREVER)
-       start_time = time((time_t *)NULL);
+    if ((inotify_des = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) != (-1))
+    {  for (i=0; i<n_principals; ++i)
+          watch_principal(&principal_list[i]);
+    }
 
-    while (TRUE)
-    {   if (do_protect == TRUE)
-        {  if (access(principal,F_OK | R_OK | W_OK) == (-1))
-           {  (void)link(principal_link,principal);
-              if (do_verbose == TRUE)
-              {  (void)fprintf(stderr,"%s (%d@%s): %sWARNING%s unexpected attempt to delete monitored file system object [%s] -- relinking\n",pname,getpid(),hostname,boldOn,boldOff,principal);
-                 (void)fflush(stderr);
-              }
-           }
+    if (owner_pid > 0)
+       owner_pidfd = lyosome_pidfd_open(owner_pid);
 
-           else if (access(principal_link,F_OK | R_OK | W_OK) == (-1))
-              (void)link(principal,principal_link);
 
-           else if (access(principal,F_OK | R_OK | W_OK) == (-1) && access(principal_link,F_OK | R_OK | W_OK) == (-1))
-           {  if (do_verbose == TRUE)
-              {  (void)fprintf(stderr,"\n%s (%d@%s): %sWARNING%s lost monitored file system object [%s] -- aborting\n\n",pname,getpid(),hostname,boldOn,boldOff,principal);
-                 (void)fflush(stderr);
-              }
+    /*-------------------------------------*/
+    /* Monitor nominated files/directories */
+    /*-------------------------------------*/
 
-              exit(255);
-           }
-        }
+    start_time = time((time_t *)NULL);
+
+    while (TRUE)
+    {   uint32_t n_live;
+
+        n_live = check_principals();
 
 
         /*------------------------------*/
         /* Nothing to monitor (so exit) */
         /*------------------------------*/
 
-        else if (access(principal,F_OK | R_OK | W_OK) == (-1))
+        if (n_live == 0)
         {  if (do_verbose == TRUE)
-           {  (void)fprintf(stderr,"%s (%d@%s): monitored file system object [%s] deleted -- exiting\n",pname,getpid(),hostname,principal);
+           {  (void)fprintf(stderr,"%s (%d@%s): no monitored file system objects left -- exiting\n",pname,getpid(),hostname);
               (void)fflush(stderr);
            }
 
-           exit_handler();
+           exit(0);
         }
 
 
-        /*-------*/
-        /* Delay */
-        /*-------*/
+        /*--------------------------------------------*/
+        /* Owner has terminated (so destroy and exit) */
+        /*--------------------------------------------*/
 
-        (void)usleep(10000);
+        if (owner_exited == TRUE || (owner_pid > 0 && owner_pidfd == (-1) && kill(owner_pid,0) == (-1) && errno == ESRCH))
+        {  if (do_verbose == TRUE)
+           {  (void)fprintf(stderr,"%s (%d@%s): owner process %d terminated\n",pname,getpid(),hostname,owner_pid);
+              (void)fflush(stderr);
+           }
+
+           exit_handler();
+        }
 
 
-        /*----------------------------------------*/
-        /* End of (monitoring) lifetime (so exit) */
-        /*----------------------------------------*/
+        /*-----------------------------------------------*/
+        /* End of (monitoring) lifetime (so destroy)     */
+        /*-----------------------------------------------*/
 
-        if (lifetime != FOREVER)
-        {  if (time((time_t *)NULL) - start_time >= lifetime)
-              exit_handler();
+        for (i=0; i<n_principals; ++i)
+        {  if (principal_list[i].live     == TRUE    &&
+               principal_list[i].lifetime != FOREVER &&
+               time((time_t *)NULL) - start_time >= principal_list[i].lifetime)
+              destroy_principal(&principal_list[i]);
         }
+
+        wait_events();
     }
 }
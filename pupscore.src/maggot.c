@@ -9,8 +9,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 4.01 
-    Dated:   29th Decemeber 2024
+    Version: 4.02 
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 --------------------------------------------------------------------------------------*/
 
@@ -27,13 +27,16 @@
 #include <errno.h>
 #include <vstamp.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#include <poll.h>
 
 
 /*-------------------*/
 /* Version of maggot */
 /*-------------------*/
 
-#define MAGGOT_VERSION    "4.01"
+#define MAGGOT_VERSION    "4.02"
 
 
 /*----------------------------------------------------------------*/
@@ -93,7 +96,9 @@ _PRIVATE void maggot_usage(void)
 {   
     (void)fprintf(stderr,"[-search <directory list:/tmp;/fifos/<localhost>]\n");
     (void)fprintf(stderr,"[-parse <key list>\n");
-    (void)fprintf(stderr,"[-delay_period <minutes:60>]\n"); 
+    (void)fprintf(stderr,"[-delay_period <minutes:60> (not applied to objects removed when owner exits)]\n");
+    (void)fprintf(stderr,"[-rescan_period <seconds:300>]\n");
+    (void)fprintf(stderr,"[-polled:FALSE]\n");
     (void)fprintf(stderr,"[-global:FALSE]\n\n");
     (void)fprintf(stderr,"[>& <ASCII log file>]\n\n");
 
@@ -137,6 +142,9 @@ _EXTERN char appl_build_date[SSIZE] = __DATE__;
 #define N_ENTRIES     1024
 #define MAX_S_DIRS    32
 #define MAX_KEYS      32
+#define MAX_OWNERS    512
+#define MAX_WATCHES   (MAX_S_DIRS + 2)
+#define EVENT_BUFSIZE 65536
 
 
 
@@ -148,6 +156,30 @@ _EXTERN char appl_build_date[SSIZE] = __DATE__;
 
 
 
+/*-----------------------------------------------------------------*/
+/* Owner of (one or more) PSRP objects. In event driven mode owner */
+/* is monitored via a pidfd which becomes readable when it exits   */
+/*-----------------------------------------------------------------*/
+
+typedef struct {   pid_t    pid;
+                   uid_t    owner;
+                   int32_t  pidfd;
+                   int32_t  n_objects;
+                   char     **object;
+               } owner_type;
+
+
+/*---------------------------------------------*/
+/* Directory watched (via inotify) by a maggot */
+/*---------------------------------------------*/
+
+typedef struct {   int32_t  wd;
+                   char     directory[SSIZE];
+               } watch_type;
+
+
+
+
 /*-------------------*/
 /* Private functions */
 /*-------------------*/
@@ -167,6 +199,9 @@ _PROTOTYPE _PRIVATE int32_t psrp_help(int32_t, char *[]);
 /* PSRP function to set delay period */
 _PROTOTYPE _PRIVATE int32_t set_delay_period(int32_t, char *[]);
 
+/* PSRP function to set (event driven mode) rescan period */
+_PROTOTYPE _PRIVATE int32_t set_rescan_period(int32_t, char *[]);
+
 /* PSRP function to add a directory to scan list */
 _PROTOTYPE _PRIVATE int32_t add_directory(int32_t, char *[]);
 
@@ -179,6 +214,45 @@ _PROTOTYPE _PRIVATE  int32_t add_key(int32_t, char *[]);
 /* PSRP function to remove a key from key  list */
 _PROTOTYPE _PRIVATE  int32_t remove_key(int32_t, char *[]);
 
+/* Apply action to all (directory,key) pairs searched by maggot */
+_PROTOTYPE _PRIVATE void scan_directories(_BOOLEAN (*)(char *, char *));
+
+/* Initialise event driven (inotify/pidfd) stale object removal */
+_PROTOTYPE _PRIVATE _BOOLEAN maggot_event_init(void);
+
+/* Event driven stale object removal loop */
+_PROTOTYPE _PRIVATE void maggot_event_loop(void);
+
+/* Register objects in directory (matching key) with their owners */
+_PROTOTYPE _PRIVATE _BOOLEAN register_objects(char *, char *);
+
+/* Open process descriptor (pidfd) for owner of object */
+_PROTOTYPE _PRIVATE int32_t maggot_pidfd_open(pid_t);
+
+/* Get PID and UID of owner of PSRP object */
+_PROTOTYPE _PRIVATE _BOOLEAN object_owner(char *, pid_t *, uid_t *);
+
+/* Does object name match a key for watched directory? */
+_PROTOTYPE _PRIVATE _BOOLEAN key_match(char *, char *);
+
+/* Stop monitoring owner of PSRP objects */
+_PROTOTYPE _PRIVATE void release_owner(int32_t);
+
+/* Register PSRP object with its owner */
+_PROTOTYPE _PRIVATE void add_object(char *, char *);
+
+/* Forget PSRP object which has been removed */
+_PROTOTYPE _PRIVATE void drop_object(char *, char *);
+
+/* Remove PSRP object whose owner has exited */
+_PROTOTYPE _PRIVATE void remove_object(char *);
+
+/* (Re)build list of directories watched via inotify */
+_PROTOTYPE _PRIVATE void update_watches(void);
+
+/* Process pending inotify events */
+_PROTOTYPE _PRIVATE void read_events(void);
+
 
 
 
@@ -203,6 +277,15 @@ _PRIVATE char        **entry_list       = (char **)NULL;   /* List of PSRP resou
 _PRIVATE struct stat buf;                                  /* Stat buffer for determining log stream type             */
 _PRIVATE char        d_list[MAX_S_DIRS][SSIZE];            /* List of user scanned directories                        */
 _PRIVATE char        key_list[MAX_S_DIRS][SSIZE];          /* List of user search keys                                */
+_PRIVATE _BOOLEAN    event_driven       = TRUE;            /* TRUE if stale objects removed as owners exit            */
+_PRIVATE _BOOLEAN    watch_rebuild      = FALSE;           /* TRUE if watched directory list has changed              */
+_PRIVATE int32_t     rescan_period      = 300;             /* Safety net rescan period (event driven mode)            */
+_PRIVATE int32_t     inotify_des        = (-1);            /* Inotify descriptor (event driven mode)                  */
+_PRIVATE int32_t     n_watches          = 0;               /* Number of watched directories                           */
+_PRIVATE int32_t     n_owners           = 0;               /* Number of monitored owners                              */
+_PRIVATE int32_t     event_cnt          = 0;               /* Number of stale objects removed on owner exit           */
+_PRIVATE watch_type  watch_list[MAX_WATCHES];              /* Directories watched by inotify                          */
+_PRIVATE owner_type  owner_list[MAX_OWNERS];               /* Owners of PSRP objects (monitored via pidfds)           */
                                                            /*---------------------------------------------------------*/
 
 
@@ -278,6 +361,27 @@ _PUBLIC int32_t pups_main(int32_t argc, char *argv[])
     }
 
 
+    /*---------------------------------------------------------------------*/
+    /* Get safety net rescan period -- in event driven mode stale objects  */
+    /* are removed as soon as their owner exits, and full directory scans  */
+    /* only catch objects whose creation (or owner) we failed to see       */
+    /*---------------------------------------------------------------------*/
+
+    if((ptr = pups_locate(&init,"rescan_period",&argc,args,0)) != NOT_FOUND)
+    {  if((rescan_period = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || rescan_period <= 0)
+          pups_error("[maggot] expecting rescan period (seconds)");
+    }
+
+
+    /*------------------------------------------------------------*/
+    /* Use legacy polled mode (directories are rescanned every 5  */
+    /* seconds)                                                   */
+    /*------------------------------------------------------------*/
+
+    if(pups_locate(&init,"polled",&argc,args,0) != NOT_FOUND)
+       event_driven = FALSE;
+
+
     /*--------------------------*/
     /* Convert delay to seconds */
     /*--------------------------*/
@@ -505,6 +609,7 @@ _PUBLIC int32_t pups_main(int32_t argc, char *argv[])
     (void)psrp_init(PSRP_STATUS_ONLY | PSRP_HOMEOSTATIC_STREAMS,(void *)&psrp_process_status);
     (void)psrp_attach_static_function("help",            &psrp_help);
     (void)psrp_attach_static_function("delay_period",    &set_delay_period);
+    (void)psrp_attach_static_function("rescan_period",   &set_rescan_period);
     (void)psrp_attach_static_function("add_directory",   &add_directory);
     (void)psrp_attach_static_function("remove_directory",&remove_directory);
     (void)psrp_attach_static_function("add_key",         &add_key);
@@ -521,13 +626,25 @@ _PUBLIC int32_t pups_main(int32_t argc, char *argv[])
                          (char *)NULL);
 
 
+    /*--------------------------------------------------------------------*/
+    /* Event driven mode -- new objects are registered via inotify and    */
+    /* tied to their owner via a pidfd. Stale objects are removed as soon */
+    /* as their owner exits. The global maggot checks remote owners (via  */
+    /* ssh) so it is always polled                                        */
+    /*--------------------------------------------------------------------*/
+
+    if(global_maggot == FALSE && event_driven == TRUE && maggot_event_init() == TRUE)
+       maggot_event_loop();
+    else
+       event_driven = FALSE;
+
+
     /*--------------------------------------------------------------------------------------------------*/
     /* This is the pups_main loop of the maggot -- it periodically checks the /fifo/<hostname> and /tmp */
     /* filesystems of its host and removes stale resources                                              */
     /*--------------------------------------------------------------------------------------------------*/
 
-    do {    uint32_t i;
-
+    do {    
 
             /*-------------------------------------------*/
             /* Delay period between PSRP directory scans */
@@ -545,46 +662,7 @@ _PUBLIC int32_t pups_main(int32_t argc, char *argv[])
             /* are found remove them                              */
             /*----------------------------------------------------*/
 
-            if(global_maggot == TRUE)
-               (void)psrp_remove_stale_objects("/tmp","log"); 
-            else
-            {  (void)psrp_remove_stale_objects(appl_fifo_dir,"fifo");
-               (void)psrp_remove_stale_objects(appl_fifo_dir,"pst");
-               (void)psrp_remove_stale_objects("/tmp","fifo");
-               (void)psrp_remove_stale_objects("/tmp","pst");
-
-
-               /*---------------------------*/
-               /* Process user defined keys */
-               /*---------------------------*/
-
-               for (i=0; i<key_cnt; ++i)
-                   (void)psrp_remove_stale_objects("/tmp",key_list[i]);
-            }
-
-
-            /*-------------------------------------------------*/
-            /* Scan user defined directories for stale objects */
-            /* and remove any which are found                  */
-            /*-------------------------------------------------*/
-
-            for(i=0; i<d_cnt; ++i)
-            {  uint32_t j;
-
-               if(strcmp(d_list[i],"notset") != 0)
-               {  (void)psrp_remove_stale_objects(d_list[i],"fifo");
-                  (void)psrp_remove_stale_objects(d_list[i],"pst");
-
-
-                  /*---------------------------*/
-                  /* Process user defined keys */
-                  /*---------------------------*/
-
-                  for (j=0; j<key_cnt; ++j)
-                      (void)psrp_remove_stale_objects(d_list[i],key_list[j]);
-               }
-            }
-
+            scan_directories(&psrp_remove_stale_objects);
        } while(TRUE);
 
 
@@ -619,7 +697,14 @@ _PRIVATE  int32_t psrp_process_status(int32_t argc, char *argv[])
      (void)fprintf(psrp_out,"    Binary is Crui enabled (checkpointable)\n");
      #endif  /* CRUI_SUPPORT */
 
-     (void)fprintf(psrp_out,"    Stale resources will be deleted after %d minutes\n",delay_period/60);    
+     if(event_driven == TRUE)
+     {  (void)fprintf(psrp_out,"    Event driven: stale resources deleted when owner exits (%d owners monitored)\n",n_owners);
+        (void)fprintf(psrp_out,"    Safety net rescan every %d seconds\n",rescan_period);
+        (void)fprintf(psrp_out,"    Stale resources found by rescan will be deleted after %d minutes (no delay if owner seen to exit)\n",delay_period/60);
+     }
+     else
+        (void)fprintf(psrp_out,"    Stale resources will be deleted after %d minutes\n",delay_period/60);
+
      (void)fprintf(psrp_out,"    Scanning \"%s\" for stale PSRP objects\n",appl_fifo_dir);
 
      if(strin(appl_fifo_dir,"fifos") == TRUE)
@@ -675,7 +760,7 @@ _PRIVATE  int32_t psrp_process_status(int32_t argc, char *argv[])
      if(delete_cnt == 0)
         (void)fprintf(psrp_out,"\n\n    No stale PSRP resources removed\n\n",delete_cnt);
      else
-        (void)fprintf(psrp_out,"\n\n    %d stale PSRP resources removed\n\n",delete_cnt);
+        (void)fprintf(psrp_out,"\n\n    %d stale PSRP resources removed (%d on owner exit)\n\n",delete_cnt,event_cnt);
      (void)fflush(psrp_out);
 
      return(PSRP_OK);
@@ -687,7 +772,7 @@ _PRIVATE  int32_t psrp_process_status(int32_t argc, char *argv[])
 /* Parse pid in <file name>-<pid> format file */
 /*--------------------------------------------*/
 
-_PRIVATE pid_t parse_pidname(unsigned char *filename)
+_PRIVATE pid_t parse_pidname(const char *filename)
 
 {    size_t i,
             size          = 0,
@@ -909,6 +994,655 @@ _PRIVATE void maggot_exit_f(char *arg_str)
 
        (void *)pups_free((void *)entry_list);
     } 
+
+
+    /*----------------------------------------------*/
+    /* Close inotify and process descriptors (event */
+    /* driven mode)                                 */
+    /*----------------------------------------------*/
+
+    if(inotify_des != (-1))
+    {  for(i=0; i<MAX_OWNERS; ++i)
+       {  if(owner_list[i].pidfd != (-1))
+             release_owner(i);
+       }
+
+       (void)close(inotify_des);
+    }
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Apply action to all (directory,key) pairs which this maggot  */
+/* searches for stale PSRP objects                              */
+/*--------------------------------------------------------------*/
+
+_PRIVATE void scan_directories(_BOOLEAN (*action)(char *, char *))
+
+{   uint32_t i;
+
+    if(global_maggot == TRUE)
+       (void)(*action)("/tmp","log"); 
+    else
+    {  (void)(*action)(appl_fifo_dir,"fifo");
+       (void)(*action)(appl_fifo_dir,"pst");
+       (void)(*action)("/tmp","fifo");
+       (void)(*action)("/tmp","pst");
+
+
+       /*---------------------------*/
+       /* Process user defined keys */
+       /*---------------------------*/
+
+       for (i=0; i<key_cnt; ++i)
+       {  if(strcmp(key_list[i],"notset") != 0)
+             (void)(*action)("/tmp",key_list[i]);
+       }
+    }
+
+
+    /*-------------------------------*/
+    /* Scan user defined directories */
+    /*-------------------------------*/
+
+    for(i=0; i<d_cnt; ++i)
+    {  uint32_t j;
+
+       if(strcmp(d_list[i],"notset") != 0)
+       {  (void)(*action)(d_list[i],"fifo");
+          (void)(*action)(d_list[i],"pst");
+
+
+          /*---------------------------*/
+          /* Process user defined keys */
+          /*---------------------------*/
+
+          for (j=0; j<key_cnt; ++j)
+          {  if(strcmp(key_list[j],"notset") != 0)
+                (void)(*action)(d_list[i],key_list[j]);
+          }
+       }
+    }
+}
+
+
+
+
+/*-----------------------------------------------------*/
+/* Open process descriptor (pidfd) for owner of object */
+/*-----------------------------------------------------*/
+
+_PRIVATE int32_t maggot_pidfd_open(pid_t pid)
+
+{
+    #ifdef SYS_pidfd_open
+    return((int32_t)syscall(SYS_pidfd_open,pid,0));
+    #else
+    errno = ENOSYS;
+    return(-1);
+    #endif /* SYS_pidfd_open */
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Get PID and UID of the owner of a PSRP object (from name) */
+/*-----------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN object_owner(char *name, pid_t *pid, uid_t *owner)
+
+{   char strdum[SSIZE]     = "",
+         next_entry[SSIZE] = "";
+
+    *pid   = (-1);
+    *owner = (-1);
+
+    (void)strlcpy(next_entry,name,SSIZE);
+    mchrep(' ',".:#",next_entry);
+
+                                                                                                 /*------------------------------*/
+    if(sscanf(next_entry,"%s%s%s%s%s%d%d",strdum,strdum,strdum,strdum,strdum,pid,owner) == 7 ||    /* Standard PUP/P3 files/FIFO's */
+       (*pid = parse_pidname(name))                                                     >= 0  )    /* <filename>-<pid>             */
+       return(TRUE);                                                                             /*------------------------------*/
+
+    return(FALSE);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Does name match a key for the watched directory? */
+/*--------------------------------------------------*/
+
+_PRIVATE _BOOLEAN key_match(char *directory, char *name)
+
+{   uint32_t i;
+
+    if(strin(name,"fifo") == TRUE || strin(name,"pst") == TRUE)
+       return(TRUE);
+
+
+    /*---------------------------------------------------*/
+    /* User defined keys are not applied to PSRP channel */
+    /* directory (same as a full scan)                   */
+    /*---------------------------------------------------*/
+
+    if(strcmp(directory,appl_fifo_dir) == 0 && strcmp(directory,"/tmp") != 0)
+       return(FALSE);
+
+    for(i=0; i<key_cnt; ++i)
+    {  if(strcmp(key_list[i],"notset") != 0 && strin(name,key_list[i]) == TRUE)
+          return(TRUE);
+    }
+
+    return(FALSE);
+}
+
+
+
+
+/*----------------------------------------------------*/
+/* Stop monitoring owner (and forget all its objects) */
+/*----------------------------------------------------*/
+
+_PRIVATE void release_owner(int32_t index)
+
+{   uint32_t i;
+
+    for(i=0; i<owner_list[index].n_objects; ++i)
+       (void)pups_free((void *)owner_list[index].object[i]);
+
+    if(owner_list[index].object != (char **)NULL)
+       owner_list[index].object = (char **)pups_free((void *)owner_list[index].object);
+
+    (void)close(owner_list[index].pidfd);
+
+    owner_list[index].pidfd     = (-1);
+    owner_list[index].pid       = (-1);
+    owner_list[index].n_objects = 0;
+
+    --n_owners;
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Register object with its owner. If the owner is not already */
+/* monitored, open a pidfd for it. Objects whose owner is dead */
+/* (or cannot be monitored) are left to the safety net rescan  */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void add_object(char *directory, char *name)
+
+{   uint32_t i;
+
+    int32_t  index    = (-1);
+    pid_t    pid      = (-1);
+    uid_t    owner    = (-1);
+    char     pathname[SSIZE] = "";
+
+    if(object_owner(name,&pid,&owner) == FALSE || pid <= 0 || pid == appl_pid)
+       return;
+
+
+    /*----------------------------------------------*/
+    /* We can only remove objects we have rights to */
+    /*----------------------------------------------*/
+
+    if(owner != getuid() && getuid() != 0)
+       return;
+
+    (void)snprintf(pathname,SSIZE,"%s/%s",directory,name);
+
+
+    /*-------------------------------------*/
+    /* Is the owner already being watched? */
+    /*-------------------------------------*/
+
+    for(i=0; i<MAX_OWNERS; ++i)
+    {  if(owner_list[i].pidfd != (-1) && owner_list[i].pid == pid)
+       {  uint32_t j;
+
+          for(j=0; j<owner_list[i].n_objects; ++j)
+          {  if(strcmp(owner_list[i].object[j],pathname) == 0)
+                return;
+          }
+
+          index = i;
+          break;
+       }
+    }
+
+
+    /*-----------------------------------*/
+    /* New owner -- get a pidfd for it   */
+    /*-----------------------------------*/
+
+    if(index == (-1))
+    {  int32_t pidfd;
+
+       if(n_owners == MAX_OWNERS || (pidfd = maggot_pidfd_open(pid)) == (-1))
+          return;
+
+       for(i=0; i<MAX_OWNERS; ++i)
+       {  if(owner_list[i].pidfd == (-1))
+          {  index = i;
+             break;
+          }
+       }
+
+       owner_list[index].pid       = pid;
+       owner_list[index].owner     = owner;
+       owner_list[index].pidfd     = pidfd;
+       owner_list[index].n_objects = 0;
+       owner_list[index].object    = (char **)NULL;
+
+       ++n_owners;
+    }
+
+    owner_list[index].object = (char **)pups_realloc((void *)owner_list[index].object,
+                                                     (owner_list[index].n_objects + 1)*sizeof(char *));
+    owner_list[index].object[owner_list[index].n_objects] = (char *)pups_malloc(strlen(pathname) + 1);
+    (void)strlcpy(owner_list[index].object[owner_list[index].n_objects],pathname,strlen(pathname) + 1);
+    ++owner_list[index].n_objects;
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Forget object which has been removed (e.g. by its own owner) */
+/*--------------------------------------------------------------*/
+
+_PRIVATE void drop_object(char *directory, char *name)
+
+{   uint32_t i;
+
+    pid_t    pid      = (-1);
+    uid_t    owner    = (-1);
+    char     pathname[SSIZE] = "";
+
+    if(object_owner(name,&pid,&owner) == FALSE)
+       return;
+
+    (void)snprintf(pathname,SSIZE,"%s/%s",directory,name);
+
+    for(i=0; i<MAX_OWNERS; ++i)
+    {  if(owner_list[i].pidfd != (-1) && owner_list[i].pid == pid)
+       {  uint32_t j;
+
+          for(j=0; j<owner_list[i].n_objects; ++j)
+          {  if(strcmp(owner_list[i].object[j],pathname) == 0)
+             {  (void)pups_free((void *)owner_list[i].object[j]);
+
+                owner_list[i].object[j] = owner_list[i].object[owner_list[i].n_objects - 1];
+                --owner_list[i].n_objects;
+
+
+                /*-------------------------------------------------*/
+                /* No objects left so there is no need to monitor  */
+                /* this owner any more                             */
+                /*-------------------------------------------------*/
+
+                if(owner_list[i].n_objects == 0)
+                   release_owner(i);
+
+                return;
+             }
+          }
+
+          return;
+       }
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Register all objects (matching key) in directory with their */
+/* owners                                                      */
+/*-------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN register_objects(char *directory, char *object_key)
+
+{   uint32_t i;
+
+    int32_t entry_cnt  = 0,
+            key_entries = 0;
+    char    **entries   = (char **)NULL;
+
+    if(access(directory,F_OK | R_OK | W_OK) == (-1))
+       return(FALSE);
+
+    if((entries = pups_get_directory_entries(directory,object_key,&key_entries,&entry_cnt)) == (char **)NULL)
+       return(FALSE);
+
+    for(i=0; i<key_entries; ++i)
+    {  add_object(directory,entries[i]);
+       (void)pups_free((void *)entries[i]);
+    }
+
+    (void)pups_free((void *)entries);
+    return(TRUE);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Remove stale object (owner has exited) and log the fact */
+/* Note delay_period is not applied here -- we saw the     */
+/* owner exit so the object cannot be in use               */
+/*---------------------------------------------------------*/
+
+_PRIVATE void remove_object(char *pathname)
+
+{   struct stat buf;
+
+    if(lstat(pathname,&buf) == (-1) || unlink(pathname) == (-1))
+       return;
+
+    ++delete_cnt;
+    ++event_cnt;
+
+    if(appl_verbose == TRUE)
+    {  ++items_logged;
+       if(items_logged == log_wrap_cnt)
+       {  items_logged = 0;
+          (void)pups_lseek(2,wrap_pos,SEEK_SET);
+       }
+
+       (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): stale PSRP resource (%s) has been removed (owner exited)\n",date,
+                                                                                                     appl_name,
+                                                                                                      appl_pid,
+                                                                                                     appl_host,
+                                                                                                    appl_owner,
+                                                                                                      pathname);
+       (void)fflush(stderr);
+    }
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* (Re)build the list of directories watched via inotify      */
+/*------------------------------------------------------------*/
+
+_PRIVATE void update_watches(void)
+
+{   uint32_t i;
+
+    char     directory[MAX_WATCHES][SSIZE];
+    int32_t  n_dirs = 0;
+
+    for(i=0; i<n_watches; ++i)
+    {  if(watch_list[i].wd != (-1))
+          (void)inotify_rm_watch(inotify_des,watch_list[i].wd);
+    }
+    n_watches     = 0;
+    watch_rebuild = FALSE;
+
+    (void)strlcpy(directory[n_dirs++],appl_fifo_dir,SSIZE);
+    (void)strlcpy(directory[n_dirs++],"/tmp",SSIZE);
+
+    for(i=0; i<d_cnt; ++i)
+    {  if(strcmp(d_list[i],"notset") != 0)
+          (void)strlcpy(directory[n_dirs++],d_list[i],SSIZE);
+    }
+
+
+    /*-----------------------------------------------------------*/
+    /* Note inotify returns the same watch descriptor if a given */
+    /* directory is listed more than once                        */
+    /*-----------------------------------------------------------*/
+
+    for(i=0; i<n_dirs; ++i)
+    {  uint32_t j;
+       int32_t  wd;
+
+       if((wd = inotify_add_watch(inotify_des,directory[i],IN_CREATE     |
+                                                           IN_MOVED_TO   |
+                                                           IN_DELETE     |
+                                                           IN_MOVED_FROM |
+                                                           IN_ONLYDIR     )) == (-1))
+          continue;
+
+       for(j=0; j<n_watches; ++j)
+       {  if(watch_list[j].wd == wd)
+             break;
+       }
+
+       if(j == n_watches)
+       {  watch_list[n_watches].wd = wd;
+          (void)strlcpy(watch_list[n_watches].directory,directory[i],SSIZE);
+          ++n_watches;
+       }
+    }
+
+
+    /*------------------------------------------------------*/
+    /* Register objects which already exist in the watched  */
+    /* directories                                          */
+    /*------------------------------------------------------*/
+
+    scan_directories(&register_objects);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Read (and process) pending inotify events                  */
+/*------------------------------------------------------------*/
+
+_PRIVATE void read_events(void)
+
+{   _IMMORTAL char event_buf[EVENT_BUFSIZE] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t size;
+
+    while((size = read(inotify_des,event_buf,EVENT_BUFSIZE)) > 0)
+    {  char *ptr = (char *)NULL;
+
+       for(ptr = event_buf; ptr < event_buf + size; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len)
+       {  uint32_t             i;
+          struct inotify_event *event = (struct inotify_event *)ptr;
+
+
+          /*--------------------------------------------------------*/
+          /* Events have been lost -- re-register everything which  */
+          /* is in the watched directories                          */
+          /*--------------------------------------------------------*/
+
+          if(event->mask & IN_Q_OVERFLOW)
+          {  scan_directories(&register_objects);
+             continue;
+          }
+
+          for(i=0; i<n_watches; ++i)
+          {  if(watch_list[i].wd == event->wd)
+                break;
+          }
+
+          if(i == n_watches)
+             continue;
+
+
+          /*--------------------------------------------*/
+          /* Watched directory has gone away            */
+          /*--------------------------------------------*/
+
+          if(event->mask & IN_IGNORED)
+          {  watch_list[i].wd = (-1);
+             continue;
+          }
+
+          if(event->len == 0)
+             continue;
+
+          if(event->mask & (IN_CREATE | IN_MOVED_TO))
+          {  if(key_match(watch_list[i].directory,event->name) == TRUE)
+                add_object(watch_list[i].directory,event->name);
+          }
+          else if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+             drop_object(watch_list[i].directory,event->name);
+       }
+    }
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Initialise event driven mode. Returns FALSE if inotify (or */
+/* pidfd) support is not available in which case we fall back */
+/* to polled mode                                             */
+/*------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN maggot_event_init(void)
+
+{   uint32_t i;
+    int32_t  pidfd;
+
+    if((pidfd = maggot_pidfd_open(appl_pid)) == (-1))
+       return(FALSE);
+    (void)close(pidfd);
+
+    if((inotify_des = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == (-1))
+       return(FALSE);
+
+    for(i=0; i<MAX_OWNERS; ++i)
+    {  owner_list[i].pidfd     = (-1);
+       owner_list[i].pid       = (-1);
+       owner_list[i].n_objects = 0;
+       owner_list[i].object    = (char **)NULL;
+    }
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): event driven (safety net rescan every %d seconds)\n",date,
+                                                                                               appl_name,
+                                                                                                appl_pid,
+                                                                                               appl_host,
+                                                                                              appl_owner,
+                                                                                           rescan_period);
+       (void)fflush(stderr);
+    }
+
+    return(TRUE);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Event driven main loop of maggot. Objects are registered as they */
+/* are created and removed as soon as their owner exits. A (slow)   */
+/* periodic full scan catches anything we did not see               */
+/*------------------------------------------------------------------*/
+
+_PRIVATE void maggot_event_loop(void)
+
+{   time_t        last_rescan = 0;
+    int32_t       index[MAX_OWNERS + 1];
+    struct pollfd pfd[MAX_OWNERS + 1];
+
+
+    /*-------------------------------------------------------*/
+    /* Initial scan removes stale objects left from before   */
+    /* we started                                            */
+    /*-------------------------------------------------------*/
+
+    scan_directories(&psrp_remove_stale_objects);
+    ++scan_cnt;
+
+    last_rescan = time((time_t *)NULL);
+    update_watches();
+
+    do {    uint32_t i;
+
+            int32_t  n_fds   = 1,
+                     timeout;
+
+
+            /*--------------------------------------------------*/
+            /* Directory list changed (via PSRP) -- rebuild the */
+            /* list of watched directories                      */
+            /*--------------------------------------------------*/
+
+            if(watch_rebuild == TRUE)
+               update_watches();
+
+            pfd[0].fd      = inotify_des;
+            pfd[0].events  = POLLIN;
+            pfd[0].revents = 0;
+
+            for(i=0; i<MAX_OWNERS; ++i)
+            {  if(owner_list[i].pidfd != (-1))
+               {  pfd[n_fds].fd      = owner_list[i].pidfd;
+                  pfd[n_fds].events  = POLLIN;
+                  pfd[n_fds].revents = 0;
+                  index[n_fds]       = i;
+                  ++n_fds;
+               }
+            }
+
+            if((timeout = rescan_period - (int32_t)(time((time_t *)NULL) - last_rescan)) < 0)
+               timeout = 0;
+
+
+            /*---------------------------------------------------------*/
+            /* Wait for something to happen. We are interrupted by     */
+            /* PSRP requests (which are handled asynchronously)        */
+            /*---------------------------------------------------------*/
+
+            if(poll(pfd,n_fds,timeout*1000) > 0)
+            {
+
+               /*--------------------------------------------------*/
+               /* Owner(s) have exited -- remove all their objects */
+               /* Note that this is done before processing inotify */
+               /* events which may reuse owner slots               */
+               /*--------------------------------------------------*/
+
+               for(i=1; i<n_fds; ++i)
+               {  if(pfd[i].revents & (POLLIN | POLLHUP | POLLERR))
+                  {  uint32_t j;
+
+                     for(j=0; j<owner_list[index[i]].n_objects; ++j)
+                        remove_object(owner_list[index[i]].object[j]);
+
+                     release_owner(index[i]);
+                  }
+               }
+
+               if(pfd[0].revents & POLLIN)
+                  read_events();
+            }
+
+
+            /*---------------------------------------------------------*/
+            /* Safety net -- full scan of (all) searched directories   */
+            /*---------------------------------------------------------*/
+
+            if(time((time_t *)NULL) - last_rescan >= rescan_period)
+            {  start_time = time((time_t *)NULL);
+
+               scan_directories(&psrp_remove_stale_objects);
+               scan_directories(&register_objects);
+
+               last_rescan = time((time_t *)NULL);
+               ++scan_cnt;
+            }
+       } while(TRUE);
 }
 
 
@@ -974,6 +1708,8 @@ _PRIVATE  int32_t add_directory(int32_t argc, char *argv[])
           if(i >= d_cnt)
              ++d_cnt;
 
+          watch_rebuild = TRUE;
+
           (void)fprintf(psrp_out,"    add_directory: %s added to scanned directory list\n",argv[1]);
           (void)fflush(psrp_out);
 
@@ -1013,6 +1749,7 @@ _PRIVATE int32_t remove_directory(int32_t argc, char *argv[])
     for(i=0; i<d_cnt; ++i)
     {  if(strcmp(argv[1],d_list[i]) == 0)
        {  (void)strlcpy(d_list[i],"notset",SSIZE);
+          watch_rebuild = TRUE;
 
           (void)fprintf(psrp_out,"    remove_directory: %s has been removed from scanned directory list\n",argv[1]);
           (void)fflush(psrp_out);
@@ -1183,6 +1920,49 @@ _PRIVATE int32_t set_delay_period(int32_t argc, char *argv[])
 
 
 
+
+/*-------------------------------------------------------------------*/
+/* Static PSRP function which sets (event driven mode) rescan period */
+/*-------------------------------------------------------------------*/
+
+_PRIVATE int32_t set_rescan_period(int32_t argc, char *argv[])
+
+{    int32_t tmp_rescan_period;
+
+
+    /*-----------------------------------------------*/
+    /* Check that we have the correct argument count */
+    /*-----------------------------------------------*/
+
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"    usage: rescan_period <seconds:%04d>\n",rescan_period);
+       (void)fflush(psrp_out);
+
+       return(PSRP_ERROR);
+    }
+
+
+    /*--------------*/
+    /* Sanity check */
+    /*--------------*/
+
+    if (sscanf(argv[1],"%d",&tmp_rescan_period) != 1 || tmp_rescan_period <= 0)
+    {  (void)fprintf(psrp_out,"\n    %sERROR%s: expecting rescan period (integer > 0)\n\n",boldOn,boldOff);
+       (void)fflush(psrp_out);
+
+       return(PSRP_ERROR);
+    }
+
+    rescan_period = tmp_rescan_period;
+
+    (void)fprintf(psrp_out,"    set_rescan_period: safety net rescan period is now %04d seconds\n\n",rescan_period);
+    (void)fflush(psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
 /*---------------------------------*/
 /* PSRP API - maggot specific help */
 /*---------------------------------*/
@@ -1196,6 +1976,7 @@ _PRIVATE  int32_t psrp_help(int32_t argc, char *argv[])
      (void)fprintf(psrp_out,"    ======================\n\n");
      (void)fprintf(psrp_out,"    status                                           : display current status of maggot\n");
      (void)fprintf(psrp_out,"    delay_period      !<seconds>!                    : set scan delay period <seconds>\n");
+     (void)fprintf(psrp_out,"    rescan_period     !<seconds>!                    : set (event driven mode) safety net rescan period <seconds>\n");
      (void)fprintf(psrp_out,"    add_directory     !<name>!                       : add directory <name> to list of scanned directories\n");
      (void)fprintf(psrp_out,"    remove_directory  !<name>!                       : remove directory <name> from list of scanned directories\n");
      (void)fprintf(psrp_out,"    add_key           !<name>!                       : add key <name> to list of files keys to check for removal\n");
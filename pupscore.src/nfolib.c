@@ -10,8 +10,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 3.02 
-    Dated:   29th December 2024
+    Version: 3.03 
+    Dated:   19th October 2026
     E-Mail:  mao@tumblingdice.co.uk 
 ----------------------------------------------------------------------*/
 
@@ -21,6 +21,13 @@
 #include <unistd.h>
 #include <stdlib.h>
 
+#include <string.h>
+#include <errno.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif /* _OPENMP */
+
 
 /*-------------------------------------------------*/
 /* Slot and usage functions - used by slot manager */
@@ -784,13 +791,15 @@ _PUBLIC FTYPE Milne_diff(uint32_t el, FTYPE h, FTYPE y_arr[])
 
 /*------------------------------------------------------*/
 /* Global definitions required by linmin/f1dim routines */
+/* (thread local so that Powell and Brent may be run    */
+/* concurrently by multistart minimiser)                */
 /*------------------------------------------------------*/
 
-_PRIVATE int32_t ncom = 0;
+_PRIVATE __thread int32_t ncom = 0;
 
-_PRIVATE FTYPE   pcom[MAX_D]  = { 0.0 },
-                 xicom[MAX_D] = { 0.0 },
-                 (*nrfunc)()  = (FTYPE (*)())NULL;
+_PRIVATE __thread FTYPE   pcom[MAX_D]  = { 0.0 },
+                          xicom[MAX_D] = { 0.0 },
+                          (*nrfunc)()  = (FTYPE (*)())NULL;
 
 
 /*-----------------------------*/
@@ -886,7 +895,7 @@ _PRIVATE FTYPE f1dim(FTYPE x)
 _PUBLIC FTYPE Brent(FTYPE      ax,    // Bracket 1
                     FTYPE      bx,    // Bracket 2
                     FTYPE      cx,    // Bracket 3
-                    FTYPE ( *f)(),    // Function to be minimised
+                    FTYPE ( *f_udef)(), // Function to be minimised
                     FTYPE     tol,    // Relaxation tolerance
                     FTYPE   *xmin)    // X co-ordinate of minimum
 
@@ -902,6 +911,14 @@ _PUBLIC FTYPE Brent(FTYPE      ax,    // Bracket 1
 
 {   uint32_t iter;
 
+
+    /*-------------------------------------------------------------*/
+    /* Call through prototyped pointer (otherwise FTYPE argument   */
+    /* is promoted to double when FTYPE is float)                  */
+    /*-------------------------------------------------------------*/
+
+    FTYPE (*f)(FTYPE) = (FTYPE (*)(FTYPE))f_udef;
+
     FTYPE    a,
              b,
              d,
@@ -1242,9 +1259,18 @@ _PUBLIC void mnbrak(FTYPE         *ax,   // Bracket 1
                     FTYPE         *fa,   // f(bracket 1)
                     FTYPE         *fb,   // f(bracket 2)
                     FTYPE         *fc,   // f(bracket 3)
-                    FTYPE   (*func)())   // Function to minimise 
+                    FTYPE (*func_udef)())   // Function to minimise 
+
+{
+
+    /*-------------------------------------------------------------*/
+    /* Call through prototyped pointer (otherwise FTYPE argument   */
+    /* is promoted to double when FTYPE is float)                  */
+    /*-------------------------------------------------------------*/
+
+    FTYPE (*func)(FTYPE) = (FTYPE (*)(FTYPE))func_udef;
 
-{   FTYPE u,
+    FTYPE u,
           r,
           q,
           fu,
@@ -1408,7 +1434,7 @@ _PUBLIC void mnbrak(FTYPE         *ax,   // Bracket 1
 _PUBLIC FTYPE golden(FTYPE       ax,   // Guess [bracket 1 co-ordinate] 
                      FTYPE       bx,   // Guess [bracket 2 co-ordinate]
                      FTYPE       cx,   // Guess [bracket 3 co-ordinate]
-                     FTYPE  (* f)(),   // Function to be bracketed
+                     FTYPE  (* f_udef)(),   // Function to be bracketed
                      FTYPE      tol,   // Bracket tolerance
                      FTYPE    *xmin)   // Co-ordinate of minimum
 
@@ -1423,7 +1449,16 @@ _PUBLIC FTYPE golden(FTYPE       ax,   // Guess [bracket 1 co-ordinate]
     /* value                                                                */
     /*----------------------------------------------------------------------*/
 
-{   FTYPE f0,
+{
+
+    /*-------------------------------------------------------------*/
+    /* Call through prototyped pointer (otherwise FTYPE argument   */
+    /* is promoted to double when FTYPE is float)                  */
+    /*-------------------------------------------------------------*/
+
+    FTYPE (*f)(FTYPE) = (FTYPE (*)(FTYPE))f_udef;
+
+    FTYPE f0,
           f1,
           f2,
           f3,
@@ -1575,3 +1610,390 @@ _PUBLIC void anneal(FTYPE                 p[],   // Co-ordinate of minimum
     for(i=1; i<n; ++i)
         p[i] = ptt[i];
 }
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Maximum number of Powell iterations between cancel checks   */
+/* and default annealing batch size for multistart minimiser   */
+/*-------------------------------------------------------------*/
+
+#define NFO_POWELL_CHUNK   3
+#define NFO_DEFAULT_BATCH  8
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Per-thread objective (and its data) used by the trampoline   */
+/* which lets the legacy minimisers call nfo_objective_type     */
+/*--------------------------------------------------------------*/
+
+_PRIVATE __thread nfo_objective_type nfo_thread_objective = (nfo_objective_type)NULL;
+_PRIVATE __thread void               *nfo_thread_data     = (void *)NULL;
+
+_PRIVATE FTYPE nfo_trampoline(FTYPE *p)
+
+{   return((*nfo_thread_objective)((const FTYPE *)p,nfo_thread_data));
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Evaluate a batch of points (using batch objective if one  */
+/* has been supplied)                                        */
+/*-----------------------------------------------------------*/
+
+_PRIVATE void nfo_evaluate_batch(const nfo_multistart_type *ms,
+                                 const uint32_t            n_points,
+                                 const FTYPE               *points,
+                                 FTYPE                     *costs)
+
+{   uint32_t i;
+
+    if(ms->batch_objective != (nfo_batch_objective_type)NULL)
+       (*ms->batch_objective)(n_points,ms->n_dims,points,costs,ms->data);
+    else
+    {  for(i=0; i<n_points; ++i)
+          costs[i] = (*ms->objective)(&points[i*ms->n_dims],ms->data);
+    }
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Offer a chain result to the shared best-so-far point. If */
+/* target cost has been reached, cancel remaining chains    */
+/*----------------------------------------------------------*/
+
+_PRIVATE void nfo_offer_best(nfo_multistart_type *ms,
+                             const uint32_t      start,
+                             const FTYPE         *p,
+                             const FTYPE         f)
+
+{   uint32_t i;
+
+    #pragma omp critical (nfo_multistart_best)
+    {  if(f < ms->best_f)
+       {  for(i=0; i<ms->n_dims; ++i)
+             ms->best_p[i] = p[i];
+
+          ms->best_start = start;
+          ms->best_f     = f;
+
+          if(f <= ms->f_target)
+             ms->cancel = TRUE;
+       }
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Simulated annealing chain. Each step draws batch_size candidate   */
+/* moves which are evaluated together; the best candidate is then    */
+/* subject to the Metropolis acceptance test                         */
+/*-------------------------------------------------------------------*/
+
+_PRIVATE FTYPE nfo_anneal_chain(nfo_multistart_type *ms,
+                                const uint32_t      start,
+                                rstream_type        *stream,
+                                FTYPE               *p)
+
+{   uint32_t i,
+             j,
+             k,
+             best,
+             quiet     = 0,
+             n_dims    = ms->n_dims,
+             batch     = ms->batch_size;
+
+    FTYPE    current_cost,
+             t         = ms->temperature,
+             *cand     = (FTYPE *)NULL,
+             *costs    = (FTYPE *)NULL,
+             p_best[MAX_D];
+
+    FTYPE    f_best;
+
+
+    /*------------------------------------------------------*/
+    /* Plain malloc - pups_malloc is not thread safe inside */
+    /* a parallel region                                    */
+    /*------------------------------------------------------*/
+
+    cand  = (FTYPE *)malloc((size_t)batch*n_dims*sizeof(FTYPE));
+    costs = (FTYPE *)malloc((size_t)batch*sizeof(FTYPE));
+
+
+    /*-------------------------------------------------*/
+    /* Out of memory - chain cost is that of its start */
+    /* point                                           */
+    /*-------------------------------------------------*/
+
+    if(cand == (FTYPE *)NULL || costs == (FTYPE *)NULL)
+    {  (void)free((void *)cand);
+       (void)free((void *)costs);
+
+       return((*ms->objective)(p,ms->data));
+    }
+
+    current_cost = (*ms->objective)(p,ms->data);
+    f_best       = current_cost;
+
+    for(i=0; i<n_dims; ++i)
+       p_best[i] = p[i];
+
+    for(k=0; k<ms->max_iter && ms->cancel == FALSE; ++k)
+    {
+
+       /*------------------------------------*/
+       /* Generate batch of candidate moves  */
+       /*------------------------------------*/
+
+       for(j=0; j<batch; ++j)
+       {  for(i=0; i<n_dims; ++i)
+             cand[j*n_dims + i] = p[i] + ms->delta_range*(rstream_uniform(stream) - 0.5);
+       }
+
+       nfo_evaluate_batch(ms,batch,cand,costs);
+
+       best = 0;
+       for(j=1; j<batch; ++j)
+       {  if(costs[j] < costs[best])
+             best = j;
+       }
+
+
+       /*-------------------------------*/
+       /* Metropolis acceptance test    */
+       /*-------------------------------*/
+
+       if(costs[best] < current_cost ||
+          (t > 0.0 && rstream_uniform(stream) < EXP((current_cost - costs[best])/t)))
+       {  if(FABS(current_cost - costs[best]) < ms->ftol)
+             ++quiet;
+          else
+             quiet = 0;
+
+          current_cost = costs[best];
+          for(i=0; i<n_dims; ++i)
+             p[i] = cand[best*n_dims + i];
+
+          if(current_cost < f_best)
+          {  f_best = current_cost;
+
+             for(i=0; i<n_dims; ++i)
+                p_best[i] = p[i];
+
+             nfo_offer_best(ms,start,p_best,f_best);
+          }
+       }
+       else
+          ++quiet;
+
+
+       /*---------------------------------------------*/
+       /* Chain has frozen - no useful moves for many */
+       /* steps at low temperature                    */
+       /*---------------------------------------------*/
+
+       if(quiet > PO_ITMAX && t < ms->ftol)
+          break;
+
+       t *= ms->cooling;
+    }
+
+    for(i=0; i<n_dims; ++i)
+       p[i] = p_best[i];
+
+    (void)free((void *)cand);
+    (void)free((void *)costs);
+
+    return(f_best);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Powell restart. Powell is run in short chunks (retaining the  */
+/* direction set) so that cancellation is seen promptly          */
+/*---------------------------------------------------------------*/
+
+_PRIVATE FTYPE nfo_powell_restart(nfo_multistart_type *ms,
+                                  const uint32_t      start,
+                                  FTYPE               *p)
+
+{   uint32_t i,
+             j,
+             iter,
+             done = 0;
+
+    FTYPE    fret,
+             xi[MAX_D][MAX_D];
+
+    nfo_thread_objective = ms->objective;
+    nfo_thread_data      = ms->data;
+
+    for(i=0; i<ms->n_dims; ++i)
+    {  for(j=0; j<ms->n_dims; ++j)
+          xi[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+
+    do {    Powell(p,xi,ms->n_dims,NFO_POWELL_CHUNK,ms->ftol,&iter,&fret,
+                   (FTYPE (*)())nfo_trampoline,(FTYPE (*)())NULL,(FTYPE (*)())NULL);
+
+            done += iter;
+            nfo_offer_best(ms,start,p,fret);
+       } while(iter > NFO_POWELL_CHUNK && done < ms->max_iter && ms->cancel == FALSE);
+
+    return(fret);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Initialise multistart minimiser description (defaults)  */
+/*---------------------------------------------------------*/
+
+_PUBLIC void nfo_multistart_init(nfo_multistart_type      *ms,              // Minimiser description
+                                 const uint32_t           method,           // NFO_ANNEAL or NFO_POWELL
+                                 const uint32_t           n_starts,         // Number of chains/restarts
+                                 const uint32_t           n_dims,           // Dimensions of objective
+                                 nfo_objective_type       objective,        // Objective function
+                                 nfo_batch_objective_type batch_objective,  // Batch objective (or NULL)
+                                 void                     *data)            // User data
+
+{   (void)memset((void *)ms,0,sizeof(nfo_multistart_type));
+
+    ms->method          = method;
+    ms->n_starts        = n_starts;
+    ms->n_dims          = n_dims;
+    ms->max_iter        = 10000;
+    ms->batch_size      = NFO_DEFAULT_BATCH;
+    ms->seed            = 0x5eed;
+    ms->ftol            = TOL;
+    ms->delta_range     = 1.0;
+    ms->temperature     = 1.0;
+    ms->cooling         = 0.999;
+    ms->f_target        = -NATURAL;
+    ms->objective       = objective;
+    ms->batch_objective = batch_objective;
+    ms->data            = data;
+    ms->cancel          = FALSE;
+    ms->best_f          = NATURAL;
+}
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Run multistart minimisation. Chains start at p0 perturbed by      */
+/* delta_range (chain 0 starts at p0). Each chain has an independent */
+/* random substream so results are reproducible for a given seed     */
+/* whatever the thread count. Returns number of chains completed, or */
+/* -1 on error. Best point is returned in p, its cost in fret, and   */
+/* (optionally) each chain's final cost in start_cost                */
+/*-------------------------------------------------------------------*/
+
+_PUBLIC int32_t nfo_multistart(nfo_multistart_type *ms,           // Minimiser description
+                               const FTYPE         *p0,           // Starting point
+                               FTYPE               *p,            // Best point found
+                               FTYPE               *start_cost)   // Per-chain cost (or NULL)
+
+{   uint32_t i,
+             completed = 0;
+
+    int32_t  start;
+
+    rstream_type master,
+                 *streams = (rstream_type *)NULL;
+
+    if(ms == (nfo_multistart_type *)NULL                     ||
+       ms->objective == (nfo_objective_type)NULL             ||
+       ms->n_dims == 0 || ms->n_dims > MAX_D                 ||
+       ms->n_starts == 0                                     ||
+       (ms->method != NFO_ANNEAL && ms->method != NFO_POWELL) )
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    if(ms->batch_size == 0)
+       ms->batch_size = 1;
+
+    ms->best_f = NATURAL;
+
+
+    /*--------------------------------------------------*/
+    /* A cancel only applies to the run it was issued   */
+    /* for                                              */
+    /*--------------------------------------------------*/
+
+    ms->cancel = FALSE;
+
+
+    /*--------------------------------------------------------*/
+    /* Chain substream is a function of its index only (not   */
+    /* of the thread which happens to run it)                 */
+    /*--------------------------------------------------------*/
+
+    streams = (rstream_type *)pups_malloc(ms->n_starts*sizeof(rstream_type));
+    rstream_seed(&master,ms->seed);
+    (void)rstream_split(&master,ms->n_starts,streams);
+
+    #pragma omp parallel for schedule(dynamic,1) reduction(+:completed)
+    for(start=0; start<(int32_t)ms->n_starts; ++start)
+    {  uint32_t     j;
+
+       FTYPE        f,
+                    pt[MAX_D];
+
+       rstream_type *stream = &streams[start];
+
+       for(j=0; j<ms->n_dims; ++j)
+          pt[j] = (start == 0) ? p0[j] : p0[j] + ms->delta_range*(rstream_uniform(stream) - 0.5);
+
+       if(ms->cancel == TRUE)
+          f = NATURAL;
+       else
+       {  if(ms->method == NFO_ANNEAL)
+             f = nfo_anneal_chain(ms,(uint32_t)start,stream,pt);
+          else
+             f = nfo_powell_restart(ms,(uint32_t)start,pt);
+
+          nfo_offer_best(ms,(uint32_t)start,pt,f);
+          ++completed;
+       }
+
+       if(start_cost != (FTYPE *)NULL)
+          start_cost[start] = f;
+    }
+
+    (void)pups_free((void *)streams);
+
+    for(i=0; i<ms->n_dims; ++i)
+       p[i] = ms->best_p[i];
+
+    pups_set_errno(OK);
+    return((int32_t)completed);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Cancel multistart minimisation (may be called from another */
+/* thread or from an objective function)                      */
+/*------------------------------------------------------------*/
+
+_PUBLIC void nfo_multistart_cancel(nfo_multistart_type *ms)
+
+{   if(ms != (nfo_multistart_type *)NULL)
+       ms->cancel = TRUE;
+}
@@ -8,8 +8,8 @@
               NE3 4RT
               United Kingdom
 
-     Version: 5.02 
-     Dated:   10th December 2024
+     Version: 5.04 
+     Dated:   19th October 2026
      E-mail:  mao@tumblingdice.co.uk
 --------------------------------------------------------------------------------*/
 
@@ -34,14 +34,21 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <pnreg.h>
 #include <sys/stat.h>
 #include <signal.h>
 #include <dirent.h>
+#include <poll.h>
 
+#ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE
+#endif /* _XOPEN_SOURCE */
 #include <unistd.h>
 
-#define _GNU_SOURCE 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
 #include <crypt.h>
 
 
@@ -76,20 +83,30 @@
 /* Version of nkill */
 /*------------------*/
 
-#define NKILL_VERSION "5.01"
+#define NKILL_VERSION "5.04"
 
 
 /*-------------*/
 /* String size */
 /*-------------*/
 
-#define SSIZE         2048
+#define SSIZE         512
 
 
 #define MAX_TRYS      16
 #define O_BLOCK       0
 #define MAX_HOSTS     512 
-#define SSIZE         512
+
+
+/*----------------------------------------------------*/
+/* Targets, parallel (ssh) sessions and size of the   */
+/* (batched) remote nkill command                     */
+/*----------------------------------------------------*/
+
+#define MAX_TARGETS   1024
+#define MAX_FANOUT    64
+#define DEFAULT_FANOUT 16
+#define CMD_SIZE      131072
 
 
 /*----------------------------------------------*/
@@ -109,6 +126,27 @@
 
 
 
+/*-------------------------------------------------*/
+/* Remote target and (per host) ssh session tables */
+/*-------------------------------------------------*/
+
+typedef struct {   char     pidname[SSIZE];           // Target (name or PID)
+                   char     hostname[SSIZE];          // Host running target
+                   char     username[SSIZE];          // Owner of target
+                   uint32_t session;                  // Session which signals target
+                   _BOOLEAN reported;                 // TRUE if result reported
+               } target_type;
+
+typedef struct {   char     hostname[SSIZE];          // Remote host
+                   char     username[SSIZE];          // Remote user
+                   pid_t    pid;                      // PID of ssh process
+                   des_t    des;                      // Read end of ssh output pipe
+                   size_t   len;                      // Bytes in (partial) line buffer
+                   char     buf[SSIZE];               // Line buffer
+               } session_type;
+
+
+
 /*-----------------------*/
 /* Local functions which */
 /*-----------------------*/
@@ -123,7 +161,7 @@ _PROTOTYPE _PRIVATE struct passwd *pups_getpwuid(const uid_t);
 _PROTOTYPE _PRIVATE _BOOLEAN local_pid_to_pname(const pid_t, char *);
 
 // Convert (local) pidname to pidlist
-_PROTOTYPE _PRIVATE _BOOLEAN local_pname_to_pids(const FILE *, const char *,const  _BOOLEAN, const _BOOLEAN, const char *, pid_t []);
+_PROTOTYPE _PRIVATE _BOOLEAN local_pname_to_pids(FILE *, const char *,const  _BOOLEAN, const _BOOLEAN, const char *, pid_t []);
 
 // Extract pidname 
 _PROTOTYPE _PRIVATE _BOOLEAN get_pid_name(const char *, const char *, pid_t *);
@@ -141,8 +179,37 @@ _PROTOTYPE _PRIVATE _BOOLEAN strin(const char *, const char *);
 // Parse (fully qualified) pidname to pidname,hostname pair or pidname,hostname.username tuple 
 _PROTOTYPE _PRIVATE int32_t parse_pidname(const char *, char *, char *, char *);
 
-// Distribute signal to process on named host
-_PROTOTYPE _PRIVATE _BOOLEAN nkill(const FILE *, const _BOOLEAN, const char *, const char *, const char *, const char *, const char *);
+// Send signal to process on local host
+_PROTOTYPE _PRIVATE _BOOLEAN nkill(FILE *, const _BOOLEAN, const char *, const char *, char *);
+
+// Print machine readable result for target
+_PROTOTYPE _PRIVATE void report_target(const char *, const char *, const pid_t, const char *, const int32_t);
+
+// Add remote target to target list
+_PROTOTYPE _PRIVATE int32_t add_target(const char *, const char *, const char *);
+
+// Expand target list files in command tail
+_PROTOTYPE _PRIVATE char **expand_targets(int32_t *, char *[]);
+
+#ifdef SSH_SUPPORT
+// Append single quoted (shell) word to remote command
+_PROTOTYPE _PRIVATE _BOOLEAN append_quoted(char *, const char *);
+
+// Start ssh session which signals targets on one host
+_PROTOTYPE _PRIVATE _BOOLEAN start_session(FILE *, const _BOOLEAN, const _BOOLEAN, const char *, const uint32_t);
+
+// Process result line from remote nkill
+_PROTOTYPE _PRIVATE void session_result(FILE *, const char *, const uint32_t, const char *);
+
+// Read output of ssh session
+_PROTOTYPE _PRIVATE _BOOLEAN session_read(FILE *, const char *, const uint32_t);
+
+// End ssh session (reporting targets with no result)
+_PROTOTYPE _PRIVATE void end_session(FILE *, const char *, const uint32_t);
+
+// Signal remote targets (one ssh session per host, in parallel)
+_PROTOTYPE _PRIVATE void nkill_sessions(FILE *, const _BOOLEAN, const char *);
+#endif /* SSH_SUPPORT */
 
 // Convert signal name to signal number
 _PRIVATE int32_t signametosigno(const char *);
@@ -160,6 +227,12 @@ _PRIVATE char     localhostname[SSIZE]  = "";
 _PRIVATE char     remotehostname[SSIZE] = "";
 _PRIVATE _BOOLEAN binname               = COMMAND;
 _PRIVATE _BOOLEAN slaved                = FALSE;
+_PRIVATE _BOOLEAN report                = FALSE;
+_PRIVATE uint32_t fanout                = DEFAULT_FANOUT;
+_PRIVATE uint32_t n_targets             = 0;
+_PRIVATE uint32_t n_sessions            = 0;
+_PRIVATE target_type  target[MAX_TARGETS];
+_PRIVATE session_type session[MAX_HOSTS];
 
 
 
@@ -197,7 +270,8 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
 
     if(argc < 2 || strcmp(argv[1],"-usage") == 0 || strcmp(argv[1],"-help") == 0)
     {  (void)fprintf(stderr,"\nnkill version %s, (C) 1999-2024 Tumbling Dice (gcc %s: built %s)\n",NKILL_VERSION,__VERSION__,__TIME__,__DATE__);
-       (void)fprintf(stderr,"\nUsage: nkill [+/-all] [+/-verbose] [+binname | +status] [-slaved:FALSE] [-psrp] !signum | signame! <process-list>\n");
+       (void)fprintf(stderr,"\nUsage: nkill [+/-all] [+/-verbose] [+binname | +status] [-slaved:FALSE] [-psrp] [+report] [-fanout <sessions>]\n");
+       (void)fprintf(stderr,"             !signum | signame! <process-list> [-targets <file>]\n");
        (void)fprintf(stderr,"\nProcess list entries have the following forms:\n\n");
        (void)fprintf(stderr,"numeric-pid              :    Process identifier on local host\n");
        (void)fprintf(stderr,"numeric-pid@localhost    :    Process identifier on local host\n");
@@ -211,6 +285,9 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        (void)fprintf(stderr,"-verbose turns off verbose mode\n");
        (void)fprintf(stderr,"+binname uses binary rather than execution name\n");
        (void)fprintf(stderr,"+status uses name from /proc/status rather than execution name\n");
+       (void)fprintf(stderr,"+report prints one (tab separated) line per target: host, target, PID, status and errno\n");
+       (void)fprintf(stderr,"-fanout sets maximum number of (per host) ssh sessions run in parallel (default %d)\n",DEFAULT_FANOUT);
+       (void)fprintf(stderr,"-targets reads (whitespace separated) process list entries from file (- is stdin)\n");
        (void)fprintf(stderr,"-usage displays (this) usage message\n\n");
        (void)fflush(stderr);
 
@@ -238,6 +315,14 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        stream = stderr;
 
 
+    /*-------------------------------------------------*/
+    /* Replace -targets <file> with the targets listed */
+    /* in file                                         */
+    /*-------------------------------------------------*/
+
+    argv = expand_targets(&argc,argv);
+
+
     /*---------------------*/ 
     /* Decode command tail */
     /*---------------------*/ 
@@ -279,6 +364,19 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
           binname = BINNAME;
        else if(strcmp(argv[i],"+status") == 0)
           binname = STATUS;
+       else if(strcmp(argv[i],"+report") == 0)
+          report = TRUE;
+       else if(strcmp(argv[i],"-fanout") == 0)
+       {  if(i == argc - 1 || sscanf(argv[i+1],"%u",&fanout) != 1 || fanout < 1 || fanout > MAX_FANOUT)
+          {  (void)fprintf(stderr,"nkill: expecting number of sessions (1-%d)\n",MAX_FANOUT);
+             (void)fflush(stderr);
+
+             exit(255);
+          }
+
+          ++i;
+          continue;
+       }
 
 
        /*------------------------------------------------------------*/
@@ -372,24 +470,102 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
           }
 
 
-          /*------------------------------*/
-          /* Deliver signal to named host */
-          /*------------------------------*/
-
-          (void)nkill(stream,
-                      s_all,
-                      username,
-                      password,
-                      signame,
-                      target_hostname,
-                      pidname);
+          /*-------------------------------------------------*/
+          /* Deliver signal to local target now. Remote      */
+          /* targets are batched (one ssh session per host)  */
+          /*-------------------------------------------------*/
 
+          if(strcmp(target_hostname,"localhost") == 0)
+             (void)nkill(stream,
+                         s_all,
+                         username,
+                         signame,
+                         pidname);
+          else if(add_target(pidname,target_hostname,username) == (-1))
+             exit(255);
        }
     }
 
+    #ifdef SSH_SUPPORT
+    nkill_sessions(stream,s_all,signame);
+    #endif /* SSH_SUPPORT */
+
     exit(0);
 }
 
+
+
+
+/*------------------------------------------------------------------------
+    Expand target list files. Each -targets <file> in the command tail
+    is replaced by the (whitespace separated) targets read from file ...
+------------------------------------------------------------------------*/
+
+_PRIVATE char **expand_targets(int32_t *argc, char *argv[])
+
+{   uint32_t i,
+             n_args    = 0,
+             max_args  = *argc + 1;
+
+    char     next_target[SSIZE] = "",
+             **targv            = (char **)NULL;
+
+    FILE     *target_stream     = (FILE *)NULL;
+
+    for(i=0; i<*argc; ++i)
+    {  if(strcmp(argv[i],"-targets") == 0)
+          break;
+    }
+
+    if(i == *argc)
+       return(argv);
+
+    if((targv = (char **)malloc(max_args*sizeof(char *))) == (char **)NULL)
+       return(argv);
+
+    for(i=0; i<*argc; ++i)
+    {  if(strcmp(argv[i],"-targets") == 0 && i < *argc - 1)
+       {  ++i;
+
+          if(strcmp(argv[i],"-") == 0)
+             target_stream = stdin;
+          else if((target_stream = fopen(argv[i],"r")) == (FILE *)NULL)
+          {  (void)fprintf(stderr,"nkill: cannot open target list file \"%s\"\n",argv[i]);
+             (void)fflush(stderr);
+
+             exit(255);
+          }
+
+          while(fscanf(target_stream,"%511s",next_target) == 1)
+          {    if(n_args == max_args - 1)
+               {  max_args *= 2;
+                  if((targv = (char **)realloc(targv,max_args*sizeof(char *))) == (char **)NULL)
+                     exit(255);
+               }
+
+               targv[n_args++] = strdup(next_target);
+          }
+
+          if(target_stream != stdin)
+             (void)fclose(target_stream);
+       }
+       else
+       {  if(n_args == max_args - 1)
+          {  max_args *= 2;
+             if((targv = (char **)realloc(targv,max_args*sizeof(char *))) == (char **)NULL)
+                exit(255);
+          }
+
+          targv[n_args++] = argv[i];
+       }
+    }
+
+    targv[n_args] = (char *)NULL;
+    *argc         = n_args;
+
+    return(targv);
+}
+
  
 
 
@@ -502,34 +678,26 @@ _PRIVATE int32_t parse_pidname(const char *full_pidname, char *pidname, char *ho
 
      
 /*------------------------------------------------------------------------
-    Send a signal to a named host first checking to see if it is
-    alive ...
+    Send a signal to a process (or processes) on the local host ...
 ------------------------------------------------------------------------*/
 
-_PRIVATE _BOOLEAN nkill(const FILE   *stream,   /* Error log/status stream                */
+_PRIVATE _BOOLEAN nkill(FILE         *stream,   /* Error log/status stream                */
                         const _BOOLEAN s_all,   /* Signal all procs called pname  if TRUE */
                         const char *username,   /* Username (on remote host)              */
-                        const char *password,   /* Authentication token                   */
                         const char  *signame,   /* Signal name (or number)                */
-                        const char    *rhost,   /* Remote host                            */
-                        const char  *pidname)   /* Name of process to signal              */
+                        char        *pidname)   /* Name of process to signal              */
 
 {   uint32_t i,
              cnt                 = 0;
 
-    pid_t    pid,
-             ptab[MAX_HOSTS];
+    pid_t    ptab[MAX_HOSTS];
 
-    int32_t  status,
-             signum,
+    int32_t  signum,
              reply,
              sent = 0;
 
-    char     strdum[SSIZE]       = "",
-             lhost[SSIZE]        = "",
-             next_pidname[SSIZE] = "";
-
-    _BOOLEAN remote              = TRUE;
+    char     lhost[SSIZE]        = "",
+             target[SSIZE]       = "";
 
     if(sscanf(signame,"%d",&signum) == 0)
     {
@@ -557,14 +725,7 @@ _PRIVATE _BOOLEAN nkill(const FILE   *stream,   /* Error log/status stream
     /*------------------------*/
 
     (void)gethostname(lhost,SSIZE);
-
-
-    /*-------------------------------------------------------*/
-    /* Are we trying to signal target running on remote host */
-    /*-------------------------------------------------------*/
-
-    if(strcmp(rhost,"localhost") == 0)
-       remote = FALSE;
+    (void)strlcpy(target,pidname,SSIZE);
 
 
     /*----------------------------------------------------------------*/
@@ -573,271 +734,392 @@ _PRIVATE _BOOLEAN nkill(const FILE   *stream,   /* Error log/status stream
     /*----------------------------------------------------------------*/
 
     if(sscanf(pidname,"%d",&ptab[0]) == 0)
-    {  uint32_t i;
-       int32_t  ret = 0;
+    {  cnt = local_pname_to_pids(stream,lhost,s_all,binname,pidname,ptab);
 
+       if(cnt == 0 && pidname[0] != '+' && pidname[0] != '-')
+       {  if(stream != (FILE *)NULL)
+          {  if(slaved == FALSE)
+                (void)fprintf(stream,"nkill: process %s not running on host %s\n",pidname,lhost);
+             else
+                (void)fprintf(stream,"%d\n",-EEXIST);
+             (void)fflush(stream);
+          }
 
-       /*-----------------------------------------------------*/
-       /* If signal is being sent to localhost run ps locally */
-       /*-----------------------------------------------------*/
+          report_target(lhost,target,(-1),"notfound",ESRCH);
+          return(FALSE);
+       }
+    }
+    else
+    {
 
-       if(remote == FALSE)
-       {  cnt = local_pname_to_pids(stream,lhost,s_all,binname,pidname,ptab);
+       /*----------------------------------------------*/
+       /* We are sending a signal to an unamed process */
+       /* Lets look up its name                        */
+       /*----------------------------------------------*/
+
+       (void)local_pid_to_pname(ptab[0],pidname);
+       ++cnt;
+    }
 
-          if(cnt == 0 && pidname[0] != '+' && pidname[0] != '-')
-          {  if(stream != (FILE *)NULL)
-             {  if(slaved == FALSE)
-                   (void)fprintf(stream,"nkill: process %s not running on host %s\n",pidname,lhost);
-                else
-                   (void)fprintf(stream,"%d\n",-EEXIST);
-                (void)fflush(stream);
-             }
 
-             return(FALSE);
+    /*----------------------------------------------------------------*/
+    /* We are local instance of nkill so lets nail the target PIDlist */
+    /*----------------------------------------------------------------*/
+
+    for(i=0; i<cnt; ++i)
+    {  if((reply = kill(ptab[i],signum)) == 0)
+       {  if(stream != (FILE *)NULL)
+          {  if(slaved == FALSE)
+                (void)fprintf(stream,"Signal %s sent to %s [%d@%s:%s] (reply %d)\n",
+                                       signame,pidname,ptab[i],lhost,username,reply);
+             else
+                (void)fprintf(stream,"%d\n",reply);
           }
+
+          report_target(lhost,target,ptab[i],"sent",0);
+          ++sent;
        }
-       #ifdef SSH_SUPPORT
        else
-       {
+       {  int32_t err = errno;
 
-          /*------------------------------------------------------*/
-          /* Use secure shell (ssh) to send signal to remote host */
-          /*------------------------------------------------------*/
+          if(stream != (FILE *)NULL)
+          {  if(slaved == FALSE)
+                (void)fprintf(stream,"Failed to send signal %s to %s[%d@%s:%s]\n",signame,pidname,ptab[i],username,lhost);
+             else
+                (void)fprintf(stream,"%d\n",reply);
+          }
 
-          if((pid = fork()) == 0)
-          {  char remote_nkill_command[SSIZE] = "";
+          if(err == ESRCH)
+             report_target(lhost,target,ptab[i],"notfound",err);
+          else
+             report_target(lhost,target,ptab[i],"failed",err);
+       }
+
+       if(stream != (FILE *)NULL)
+          (void)fflush(stream);
+    }
 
+    if(sent > 0)
+       return(TRUE);
 
-             /*--------------------*/
-             /* Child side of fork */
-             /*--------------------*/
-             /*---------------------*/
-             /* Overlay ssh command */
-             /*---------------------*/
+    return(FALSE);
+}
 
-             (void)snprintf(remote_nkill_command,SSIZE,"nkill %s",signame);
-             if(stream == stderr)
-                (void)strlcat(remote_nkill_command," +verbose",SSIZE);
 
-             if(binname == TRUE)
-                (void)strlcat(remote_nkill_command," +binname",SSIZE);
 
-             if(s_all == TRUE)
-                (void)strlcat(remote_nkill_command," +all",SSIZE);
 
-             (void)strlcat(remote_nkill_command," ",    SSIZE);
-             (void)strlcat(remote_nkill_command,pidname,SSIZE);
+/*------------------------------------------------------------------------
+    Print machine readable result for target (one tab separated line
+    per target process: host, target, PID, status and errno) ...
+------------------------------------------------------------------------*/
 
-             if(isatty(0) == 1)
-                (void)execlp("ssh","ssh","-t","-u","-l",username,rhost,remote_nkill_command,(char *)NULL);
-             else
-                (void)execlp("ssh","ssh","-u","-l",username,rhost,remote_nkill_command,(char *)NULL);
+_PRIVATE void report_target(const char *host, const char *target, const pid_t pid, const char *status, const int32_t err)
 
+{   if(report == FALSE)
+       return;
 
-             /*------------------------*/
-             /* We should not get here */
-             /*------------------------*/
+    (void)fprintf(stdout,"%s\t%s\t%d\t%s\t%d\n",host,target,pid,status,err);
+    (void)fflush(stdout);
+}
 
-             _exit(255);
-         }
 
 
-         /*---------------------*/
-         /* Parent side of fork */
-         /*---------------------*/
 
-         else if(pid == (-1))
-         {
+/*------------------------------------------------------------------------
+    Add remote target to target list. Targets are grouped by host (and
+    owner) so that each group can be signalled in one ssh session ...
+------------------------------------------------------------------------*/
 
-            /*---------------------------------------------------------------*/
-            /* If we get here connection to remote host (via ssh) has failed */
-            /*---------------------------------------------------------------*/
+_PRIVATE int32_t add_target(const char *pidname, const char *hostname, const char *username)
 
-            if(slaved == FALSE)
-            {  (void)fprintf(stderr,"nkill: failed to connect to remote host (via ssh)\n");
-               (void)fflush(stderr);
-            }
+{   uint32_t i;
 
-            return(FALSE);
-         }
+    if(n_targets == MAX_TARGETS)
+    {  (void)fprintf(stderr,"nkill: too many targets (maximum %d)\n",MAX_TARGETS);
+       (void)fflush(stderr);
 
-         /*----------------*/
-         /* Wait for child */
-         /*----------------*/
+       return(-1);
+    }
 
-         while((ret = waitpid(pid,&status,WNOHANG)) != pid)
-         {    if(ret == (-1) || WEXITSTATUS(status) < 0 || WEXITSTATUS(status) == 255)
-              {  (void)fprintf(stderr,"nkill: error connecting to remote host (via ssh)\n");
-                 (void)fflush(stderr);
+    (void)strlcpy(target[n_targets].pidname, pidname, SSIZE);
+    (void)strlcpy(target[n_targets].hostname,hostname,SSIZE);
+    (void)strlcpy(target[n_targets].username,username,SSIZE);
+    target[n_targets].reported = FALSE;
 
-                 return(FALSE);
-              }
-              else
-                 (void)usleep(100);
-         }
-      }
-      #endif /* SSH_SUPPORT */
+    for(i=0; i<n_sessions; ++i)
+    {  if(strcmp(session[i].hostname,hostname) == 0 && strcmp(session[i].username,username) == 0)
+          break;
     }
-    else
-    {
 
-       /*----------------------------------------------*/
-       /* We are sending a signal to an unamed process */
-       /* Lets look up its name                        */
-       /*----------------------------------------------*/
+    if(i == n_sessions)
+    {  if(n_sessions == MAX_HOSTS)
+       {  (void)fprintf(stderr,"nkill: too many hosts (maximum %d)\n",MAX_HOSTS);
+          (void)fflush(stderr);
 
-       (void)local_pid_to_pname(ptab[0],pidname);
-       ++cnt;
+          return(-1);
+       }
 
+       (void)strlcpy(session[i].hostname,hostname,SSIZE);
+       (void)strlcpy(session[i].username,username,SSIZE);
+       session[i].pid = (-1);
+       session[i].des = (-1);
+       session[i].len = 0;
+       ++n_sessions;
+    }
 
-       /*-----------------------------------------*/
-       /* See if we have a valid target to signal */
-       /*-----------------------------------------*/
+    target[n_targets].session = i;
+    ++n_targets;
+    return(0);
+}
 
-       #ifdef SSH_SUPPORT
-       if(remote == TRUE)
-       {   int32_t ret = 0;
 
-          /*-------------------------------------------------*/
-          /* We are sending a signal to a remote numeric PID */ 
-          /*-------------------------------------------------*/
 
-          char pidstr[SSIZE]               = "",
-               remote_nkill_command[SSIZE] = "";
 
+#ifdef SSH_SUPPORT
+/*------------------------------------------------------------------------
+    Append word to remote command as a single quoted (shell) word so
+    that the remote shell cannot interpret anything in it. Returns
+    FALSE (and leaves command unchanged) if there is no room for it ...
+------------------------------------------------------------------------*/
 
-          if((pid = fork()) == 0)
-          {
+_PRIVATE _BOOLEAN append_quoted(char *command, const char *word)
 
-             /*------------------------------------------------------------------*/
-             /* Use secure shell (ssh) rather than PSRP protocols to send signal */
-             /* to remote host                                                   */
-             /* Overlay ssh command                                              */
-             /*------------------------------------------------------------------*/
+{   size_t start,
+           len;
 
-             (void)snprintf(remote_nkill_command,SSIZE,"nkill %s",signame);
-             if(stream == stderr)
-                (void)strlcat(remote_nkill_command," +verbose",SSIZE);
+    if((start = strlen(command)) + 8 > CMD_SIZE)
+       return(FALSE);
 
-             if(s_all == TRUE)
-                (void)strlcat(remote_nkill_command," +binname",SSIZE);
+    len = start;
+    command[len++] = ' ';
+    command[len++] = '\'';
 
-             (void)strlcat(remote_nkill_command," ",SSIZE);
-             (void)snprintf(pidstr,SSIZE,"%d",ptab[0]);
-             (void)strlcat(remote_nkill_command,pidstr,SSIZE);
+    for(; *word != '\0' && len + 5 < CMD_SIZE; ++word)
+    {  if(*word == '\'')
+       {  (void)memcpy((void *)&command[len],"'\\''",4);
+          len += 4;
+       }
+       else
+          command[len++] = *word;
+    }
 
-             if(isatty(0) == 1)
-                (void)execlp("ssh","ssh","-t","-l",username,rhost,remote_nkill_command,(char *)NULL);
-             else
-                (void)execlp("ssh","ssh","-l",username,rhost,remote_nkill_command,(char *)NULL);
 
+    /*--------------------------------------*/
+    /* No room - leave command as it was    */
+    /*--------------------------------------*/
 
-             _exit(255);
-          }
+    if(*word != '\0')
+    {  command[start] = '\0';
+       return(FALSE);
+    }
 
+    command[len++] = '\'';
+    command[len]   = '\0';
 
-          /*---------------------*/
-          /* Parent side of fork */
-          /*---------------------*/
+    return(TRUE);
+}
 
-          else if(pid == (-1))
-          {  
 
-             /*---------------------------------------------------------------*/
-             /* If we get here connection to remote host (via ssh) has failed */
-             /*---------------------------------------------------------------*/
 
-             if(slaved == FALSE)
-             {  (void)fprintf(stderr,"nkill: failed to connect to remote host (via ssh)\n");
-                (void)fflush(stderr);
-             }
 
-             return(FALSE);
-          }
+/*------------------------------------------------------------------------
+    Start ssh session which signals all targets in session group. The
+    remote nkill reports its results (one line per target) on our end
+    of a pipe ...
+------------------------------------------------------------------------*/
 
-          /*----------------*/
-          /* Wait for child */
-          /*----------------*/
+_PRIVATE _BOOLEAN start_session(FILE           *stream,
+                                const _BOOLEAN  s_all,
+                                const _BOOLEAN  batch,
+                                const char   *signame,
+                                const uint32_t  s_index)
 
-          while((ret = waitpid(pid,&status,WNOHANG) != pid))
-          {    if(ret == (-1) || WEXITSTATUS(status) < 0 || WEXITSTATUS(status) == 255)
-               {  (void)fprintf(stderr,"nkill: error connecting to remote host (via ssh)\n");
-                  (void)fflush(stderr);
- 
-                  return(FALSE);
-               }
-               else
-                  (void)usleep(100);
-          }
+{   uint32_t i;
+    des_t    pdes[2];
 
-          return(TRUE);
+    char     remote_nkill_command[CMD_SIZE] = "";
+
+    (void)strlcpy(remote_nkill_command,"nkill",CMD_SIZE);
+    (void)append_quoted(remote_nkill_command,signame);
+    (void)strlcat(remote_nkill_command," +report",CMD_SIZE);
+
+    if(binname == BINNAME)
+       (void)strlcat(remote_nkill_command," +binname",CMD_SIZE);
+    else if(binname == STATUS)
+       (void)strlcat(remote_nkill_command," +status",CMD_SIZE);
+    else if(binname == CMDLINE)
+       (void)strlcat(remote_nkill_command," +cmdline",CMD_SIZE);
+
+    if(s_all == TRUE)
+       (void)strlcat(remote_nkill_command," +all",CMD_SIZE);
+
+
+    /*--------------------------------------------------*/
+    /* Every target in the group goes on one command    */
+    /* line so there is one connection setup per host.  */
+    /* Targets are quoted as the remote shell parses    */
+    /* the command line                                 */
+    /*--------------------------------------------------*/
+
+    for(i=0; i<n_targets; ++i)
+    {  if(target[i].session == s_index && append_quoted(remote_nkill_command,target[i].pidname) == FALSE)
+       {  report_target(session[s_index].hostname,target[i].pidname,(-1),"failed",E2BIG);
+          target[i].reported = TRUE;
        }
+    }
 
-       else
-       #endif /* SSH_SUPPORT */
+    if(pipe(pdes) == (-1))
+       return(FALSE);
 
-       {
+    if((session[s_index].pid = fork()) == 0)
+    {
 
-          /*----------------------------------------------*/
-          /* We are sending signal to a local numeric PID */ 
-          /*----------------------------------------------*/
+       /*--------------------*/
+       /* Child side of fork */
+       /*--------------------*/
 
-          if((reply = kill(ptab[0],signum)) == (-1))
-          {  if(stream != (FILE *)NULL)
-             {  if(slaved == FALSE)
-                   (void)fprintf(stream,"nkill: process %d not running on host %s\n",ptab[0],lhost);
-                else
-                   (void)fprintf(stream,"%d\n",-EEXIST);
-                (void)fflush(stream);
-             }
+       (void)dup2(pdes[1],1);
+       (void)close(pdes[0]);
+       (void)close(pdes[1]);
 
 
-             return(FALSE);
+       /*-----------------------------------------------------*/
+       /* Sessions which run in parallel cannot share the tty */
+       /* so they must not prompt for anything                */
+       /*-----------------------------------------------------*/
+
+       if(batch == TRUE)
+       {  des_t null_des;
+
+          if((null_des = open("/dev/null",O_RDONLY)) != (-1))
+          {  (void)dup2(null_des,0);
+             (void)close(null_des);
           }
-          else
-          {  if(stream != (FILE *)NULL)
-             {  if(slaved == FALSE)
-                   (void)fprintf(stream,"Signal %s sent to %s [%d@%s:%s] (reply %d)\n",
-                                          signame,pidname,ptab[0],lhost,username,reply);
-                else
-                   (void)fprintf(stream,"%d\n",reply);
-             }
 
-             return(TRUE);
-          } 
+          (void)execlp("ssh","ssh","-o","BatchMode=yes","-l",session[s_index].username,"--",session[s_index].hostname,remote_nkill_command,(char *)NULL);
        }
+       else
+          (void)execlp("ssh","ssh","-l",session[s_index].username,"--",session[s_index].hostname,remote_nkill_command,(char *)NULL);
+
+
+       /*------------------------*/
+       /* We should not get here */
+       /*------------------------*/
+
+       _exit(255);
     }
 
 
-    /*----------------------------------------------------------------*/
-    /* We are local instance of nkill so lets nail the target PIDlist */
-    /*----------------------------------------------------------------*/
+    /*---------------------*/
+    /* Parent side of fork */
+    /*---------------------*/
 
-    for(i=0; i<cnt; ++i)
-    {  if((reply = kill(ptab[i],signum)) == 0)
-       {  if(stream != (FILE *)NULL)
-          {  if(slaved == FALSE)
-                (void)fprintf(stream,"Signal %s sent to %s [%d@%s:%s] (reply %d)\n",
-                                       signame,pidname,ptab[i],lhost,username,reply);
-             else
-                (void)fprintf(stream,"%d\n",reply);
-          }
+    (void)close(pdes[1]);
 
-          ++sent;
+    if(session[s_index].pid == (-1))
+    {  (void)close(pdes[0]);
+
+       if(slaved == FALSE)
+       {  (void)fprintf(stderr,"nkill: failed to connect to remote host %s (via ssh)\n",session[s_index].hostname);
+          (void)fflush(stderr);
        }
-       else
-       {  if(stream != (FILE *)NULL)
-          {  if(slaved == FALSE)
-                (void)fprintf(stream,"Failed to send signal %s to %s[%d@%s:%s]\n",signame,pidname,ptab[i],username,lhost);
-             else
-                (void)fprintf(stream,"%d\n",reply);
-          }
+
+       return(FALSE);
+    }
+
+    session[s_index].des = pdes[0];
+    session[s_index].len = 0;
+
+    return(TRUE);
+}
+
+
+
+
+/*------------------------------------------------------------------------
+    Process result line from remote nkill. Lines have the form
+    host <tab> target <tab> pid <tab> status <tab> errno ...
+------------------------------------------------------------------------*/
+
+_PRIVATE void session_result(FILE *stream, const char *signame, const uint32_t s_index, const char *line)
+
+{   uint32_t i;
+    pid_t    pid;
+    int32_t  err;
+
+    char     rhost[SSIZE]   = "",
+             pidname[SSIZE] = "",
+             status[SSIZE]  = "";
+
+    if(sscanf(line,"%s%s%d%s%d",rhost,pidname,&pid,status,&err) != 5)
+    {
+
+       /*-----------------------------------------------*/
+       /* Not a result - (probably) a message from ssh  */
+       /*-----------------------------------------------*/
+
+       if(stream != (FILE *)NULL)
+       {  (void)fprintf(stream,"%s: %s\n",session[s_index].hostname,line);
+          (void)fflush(stream);
        }
 
+       return;
+    }
+
+    for(i=0; i<n_targets; ++i)
+    {  if(target[i].session == s_index && strcmp(target[i].pidname,pidname) == 0)
+          target[i].reported = TRUE;
+    }
+
+    if(stream != (FILE *)NULL && slaved == FALSE)
+    {  if(strcmp(status,"sent") == 0)
+          (void)fprintf(stream,"Signal %s sent to %s [%d@%s:%s]\n",
+                              signame,pidname,pid,session[s_index].hostname,
+                                                  session[s_index].username);
+       else
+          (void)fprintf(stream,"nkill: failed to send signal %s to %s on host %s (%s)\n",
+                                         signame,pidname,session[s_index].hostname,status);
        (void)fflush(stream);
     }
 
-    if(sent > 0)
+    report_target(session[s_index].hostname,pidname,pid,status,err);
+}
+
+
+
+
+/*------------------------------------------------------------------------
+    Read output of session. Returns FALSE at end of session ...
+------------------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN session_read(FILE *stream, const char *signame, const uint32_t s_index)
+
+{   ssize_t n;
+    char    *eol = (char *)NULL;
+
+    if((n = read(session[s_index].des,&session[s_index].buf[session[s_index].len],SSIZE - session[s_index].len - 1)) > 0)
+    {  session[s_index].len += n;
+       session[s_index].buf[session[s_index].len] = '\0';
+
+       while((eol = strchr(session[s_index].buf,'\n')) != (char *)NULL)
+       {    *eol = '\0';
+            session_result(stream,signame,s_index,session[s_index].buf);
+
+            session[s_index].len -= (eol - session[s_index].buf + 1);
+            (void)memmove(session[s_index].buf,eol + 1,session[s_index].len + 1);
+       }
+
+
+       /*----------------------------------------*/
+       /* Line too long for buffer - discard it  */
+       /*----------------------------------------*/
+
+       if(session[s_index].len == SSIZE - 1)
+          session[s_index].len = 0;
+
+       return(TRUE);
+    }
+    else if(n == (-1) && errno == EINTR)
        return(TRUE);
 
     return(FALSE);
@@ -846,6 +1128,127 @@ _PRIVATE _BOOLEAN nkill(const FILE   *stream,   /* Error log/status stream
 
 
 
+/*------------------------------------------------------------------------
+    End session and report targets which the remote nkill said nothing
+    about ...
+------------------------------------------------------------------------*/
+
+_PRIVATE void end_session(FILE *stream, const char *signame, const uint32_t s_index)
+
+{   uint32_t i;
+    int32_t  status = 0;
+
+    char     *result = "unreachable";
+
+    if(session[s_index].des != (-1))
+    {  (void)close(session[s_index].des);
+       session[s_index].des = (-1);
+    }
+
+    if(session[s_index].pid > 0)
+    {  while(waitpid(session[s_index].pid,&status,0) == (-1))
+       {    if(errno != EINTR)
+               break;
+       }
+
+       session[s_index].pid = (-1);
+    }
+
+
+    /*------------------------------------------------------------*/
+    /* If ssh itself succeeded the remote nkill ran but did not   */
+    /* report (for example it is an old version without +report)  */
+    /*------------------------------------------------------------*/
+
+    if(WIFEXITED(status) && WEXITSTATUS(status) != 255)
+       result = "unconfirmed";
+
+    for(i=0; i<n_targets; ++i)
+    {  if(target[i].session == s_index && target[i].reported == FALSE)
+       {  if(stream != (FILE *)NULL && slaved == FALSE)
+          {  (void)fprintf(stream,"nkill: signal %s to %s on host %s %s\n",
+                      signame,target[i].pidname,session[s_index].hostname,result);
+             (void)fflush(stream);
+          }
+
+          report_target(session[s_index].hostname,target[i].pidname,(-1),result,EHOSTUNREACH);
+          target[i].reported = TRUE;
+       }
+    }
+}
+
+
+
+
+/*------------------------------------------------------------------------
+    Signal remote targets. There is one ssh session per host (carrying
+    all of the targets on that host) and up to fanout sessions run in
+    parallel ...
+------------------------------------------------------------------------*/
+
+_PRIVATE void nkill_sessions(FILE *stream, const _BOOLEAN s_all, const char *signame)
+
+{   uint32_t i,
+             n_active = 0,
+             next     = 0;
+
+    _BOOLEAN batch = FALSE;
+
+    if(n_sessions == 0)
+       return;
+
+    if(n_sessions > 1 && fanout > 1)
+       batch = TRUE;
+
+    while(next < n_sessions || n_active > 0)
+    {   uint32_t      n_fds = 0;
+        uint32_t      s_map[MAX_FANOUT];
+        struct pollfd fds[MAX_FANOUT];
+
+
+        /*----------------------------------*/
+        /* Start sessions while we have the */
+        /* capacity to run them             */
+        /*----------------------------------*/
+
+        while(next < n_sessions && n_active < fanout)
+        {    if(start_session(stream,s_all,batch,signame,next) == TRUE)
+                ++n_active;
+             else
+                end_session(stream,signame,next);
+             ++next;
+        }
+
+        for(i=0; i<next; ++i)
+        {  if(session[i].des != (-1))
+           {  fds[n_fds].fd     = session[i].des;
+              fds[n_fds].events = POLLIN;
+              s_map[n_fds]      = i;
+              ++n_fds;
+           }
+        }
+
+        if(n_fds == 0)
+           break;
+
+        if(poll(fds,n_fds,(-1)) == (-1))
+        {  if(errno == EINTR)
+              continue;
+           break;
+        }
+
+        for(i=0; i<n_fds; ++i)
+        {  if(fds[i].revents != 0 && session_read(stream,signame,s_map[i]) == FALSE)
+           {  end_session(stream,signame,s_map[i]);
+              --n_active;
+           }
+        }
+    }
+}
+#endif /* SSH_SUPPORT */
+
+
+
 
 #ifdef SSH_SUPPORT
 /*--------------------------------------------------------------*/
@@ -980,7 +1383,7 @@ _PRIVATE _BOOLEAN get_pid_name(const char *pidname, const char *line, pid_t *pid
 /* Convert (local) pidname to list of matching PIDS */
 /*--------------------------------------------------*/
 
-_PRIVATE _BOOLEAN local_pname_to_pids(const FILE      *stream,
+_PRIVATE _BOOLEAN local_pname_to_pids(FILE            *stream,
                                       const char       *lhost,
                                       const _BOOLEAN    s_all,
                                       const _BOOLEAN  binname,
@@ -997,6 +1400,17 @@ _PRIVATE _BOOLEAN local_pname_to_pids(const FILE      *stream,
    DIR      *dirp                = (DIR *)NULL;
    struct   dirent *next_item    = (struct dirent *)NULL;
 
+   /*----------------------------------------------------------*/
+   /* Try PUPS process name registry first. It only holds      */
+   /* (unique) PSRP process names so it can only be used when  */
+   /* we are looking for a single process by its command name  */
+   /*----------------------------------------------------------*/
+
+   if(binname == COMMAND && s_all == FALSE && (pid = pnreg_name_to_pid(pidname)) > 0)
+   {  ptab[0] = pid;
+      return(1);
+   }
+
    dirp = opendir("/proc");
 
 
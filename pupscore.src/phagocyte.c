@@ -8,8 +8,8 @@
               NE3 4RT
               United Kingdom
 
-     Version: 1.02 
-     Dated:   10th December 2024 
+     Version: 1.03 
+     Dated:   19th October 2026 
      E-mail:  mao@tumblingdice.co.uk
 -----------------------------------------------------------------*/
 
@@ -25,9 +25,16 @@
 #include <signal.h>
 #include <ftype.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/timerfd.h>
 
 
+#ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE
+#endif /* _XOPEN_SOURCE */
 #include <unistd.h>
 
 
@@ -38,7 +45,7 @@
 /* Version */
 /*---------*/
 
-#define  PHAGOCYTE_VERSION "1.02"
+#define  PHAGOCYTE_VERSION "1.03"
 
 
 /*-------------*/
@@ -55,12 +62,38 @@
 #define ARGC                255
 
 
+/*-------------------------------------------------------*/
+/* Maximum number of monitored process names, and size   */
+/* of process table (power of 2) used by sampling engine */
+/*-------------------------------------------------------*/
+
+#define MAX_MONITORED       32
+#define PROC_TABLE_SIZE     8192
+
+
+/*--------------------------------------------------------*/
+/* Process seen by sampling engine. Monitor is the index  */
+/* of the monitored name it matches (-1 if none)          */
+/*--------------------------------------------------------*/
+
+typedef struct {   pid_t    pid;
+                   uint64_t start_time;
+                   uint64_t ticks;
+                   int32_t  monitor;
+               } proc_type;
+
+
 /*-------------------*/
 /* Private variables */
 /*-------------------*/
 
 _PRIVATE unsigned char hostname[SSIZE]        = "";
-_PRIVATE unsigned char monitor_pname[SSIZE]   = "";
+_PRIVATE unsigned char monitor_pname[MAX_MONITORED][SSIZE];
+_PRIVATE uint32_t      n_monitored            = 0;
+_PRIVATE uint32_t      n_tracked              = 0;
+_PRIVATE uint32_t      current_table          = 0;
+_PRIVATE proc_type     proc_table[2][PROC_TABLE_SIZE];
+_PRIVATE long          clock_ticks            = 100;
 _PRIVATE unsigned char pname[SSIZE]           = "";
 _PRIVATE unsigned char new_pname[SSIZE]       = "";
 _PRIVATE unsigned char ppath[SSIZE]           = "";
@@ -76,89 +109,262 @@ _PRIVATE _BOOLEAN      do_verbose             = FALSE;
 /*-----------------------------------------------*/
 /* Functions which are local to this application */
 /*-----------------------------------------------*/
-/*---------------------*/
-/* Handler for SIGALRM */
-/*---------------------*/
+/*------------------------------------------------------------*/
+/* Read CPU ticks (utime + stime) and start time of a process */
+/* from /proc/<pid>/stat                                      */
+/*------------------------------------------------------------*/
 
-_PRIVATE void alarm_handler(void)
+_PRIVATE _BOOLEAN read_proc_stat(const pid_t pid, uint64_t *start_time, uint64_t *ticks)
 
-{   unsigned char  ps_cmd[SSIZE]   = "";
-    pid_t          pid             = (-1);
-    FTYPE          next_cpu_usage  = 0.0;
-    FILE           *ps_stream      = (FILE *)NULL;
+{   uint32_t      i;
+    int32_t       fdes;
+    ssize_t       size;
+    uint64_t      utime             = 0,
+                  stime             = 0;
 
+    char          path[SSIZE]       = "",
+                  stat_line[SSIZE]  = "",
+                  *ptr              = (char *)NULL;
 
-    /*---------------------------------*/
-    /* Run ps command to get cpu usage */
-    /*---------------------------------*/
+    (void)snprintf(path,SSIZE,"/proc/%d/stat",pid);
+    if ((fdes = open(path,O_RDONLY)) == (-1))
+       return(FALSE);
+
+    size = read(fdes,stat_line,SSIZE - 1);
+    (void)close(fdes);
+
+    if (size <= 0)
+       return(FALSE);
+    stat_line[size] = '\0';
+
+
+    /*---------------------------------------------------------*/
+    /* Process name (field 2) may contain spaces so skip past  */
+    /* its closing bracket. Then utime, stime and start time   */
+    /* are fields 14, 15 and 22                                */
+    /*---------------------------------------------------------*/
+
+    if ((ptr = strrchr(stat_line,')')) == (char *)NULL)
+       return(FALSE);
+
+    for (i=0; i<12 && ptr != (char *)NULL; ++i)
+        ptr = strchr(ptr + 1,' ');
+
+    if (ptr == (char *)NULL || sscanf(ptr,"%" SCNu64 "%" SCNu64,&utime,&stime) != 2)
+       return(FALSE);
+
+    for (i=0; i<8 && ptr != (char *)NULL; ++i)
+        ptr = strchr(ptr + 1,' ');
+
+    if (ptr == (char *)NULL || sscanf(ptr,"%" SCNu64,start_time) != 1)
+       return(FALSE);
+
+    *ticks = utime + stime;
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Which (if any) monitored name does process command line     */
+/* contain? Only done once for each process we see             */
+/*-------------------------------------------------------------*/
+
+_PRIVATE int32_t classify_process(const pid_t pid)
+
+{   uint32_t      i;
+    int32_t       fdes;
+    ssize_t       size;
+
+    char          path[SSIZE]    = "",
+                  cmdline[SSIZE] = "";
+
+    (void)snprintf(path,SSIZE,"/proc/%d/cmdline",pid);
+    if ((fdes = open(path,O_RDONLY)) == (-1))
+       return(-1);
+
+    size = read(fdes,cmdline,SSIZE - 1);
+    (void)close(fdes);
+
+    if (size <= 0)
+       return(-1);
+
+
+    /*--------------------------------------------*/
+    /* Arguments are NULL separated -- make them  */
+    /* into a single (space separated) string     */
+    /*--------------------------------------------*/
+
+    for (i=0; i<size; ++i)
+    {  if (cmdline[i] == '\0')
+          cmdline[i] = ' ';
+    }
+    cmdline[size] = '\0';
+
+    for (i=0; i<n_monitored; ++i)
+    {  if (strstr(cmdline,(char *)monitor_pname[i]) != (char *)NULL)
+          return(i);
+    }
+
+    return(-1);
+}
+
+
+
+
+/*-------------------------------------------------*/
+/* Find process in process table (-1 if not found) */
+/*-------------------------------------------------*/
+
+_PRIVATE int32_t proc_lookup(const proc_type *table, const pid_t pid)
+
+{   uint32_t i,
+             slot;
+
+    slot = ((uint32_t)pid * 2654435761U) & (PROC_TABLE_SIZE - 1);
+    for (i=0; i<PROC_TABLE_SIZE; ++i)
+    {  if (table[slot].pid == pid)
+          return(slot);
+       else if (table[slot].pid == 0)
+          return(-1);
+
+       slot = (slot + 1) & (PROC_TABLE_SIZE - 1);
+    }
+
+    return(-1);
+}
 
-    (void)snprintf(ps_cmd,SSIZE,"ps ux | grep %s | awk '{print $2,$3}'",monitor_pname);
 
-    if ((ps_stream = popen(ps_cmd,"r")) == (FILE *)NULL)
-    {  if (do_verbose == TRUE)
-       {  (void)fprintf(stderr,"\n%s (%d@%s): failed to open stream for 'ps' command\n\n",pname,pid);
-          (void)fflush(stderr);
-       }
-      
-       exit(255);
-    } 
 
 
-    /*---------------------------------------------*/
-    /* Look at cpu usages for named process/binary */
-    /*---------------------------------------------*/
+/*----------------------------------------------------------*/
+/* Insert process into process table. Table is kept at most */
+/* three quarters full -- processes which do not fit are    */
+/* simply (re)classified next time they are seen            */
+/*----------------------------------------------------------*/
 
-    do {   (void)fscanf(ps_stream,"%d%F",&pid,&next_cpu_usage);
+_PRIVATE void proc_insert(proc_type *table, uint32_t *n_entries, const proc_type *entry)
 
+{   uint32_t slot;
 
-           /*-----------------------------------------------*/
-           /* Process above threshold cpu usage - terminate */
-           /*-----------------------------------------------*/
+    if (*n_entries >= 3*PROC_TABLE_SIZE/4)
+       return;
 
-           if (next_cpu_usage > max_cpu_usage)
-           {  (void)kill(pid,SIGKILL);
-              ++n_killed;
+    slot = ((uint32_t)entry->pid * 2654435761U) & (PROC_TABLE_SIZE - 1);
+    while (table[slot].pid != 0)
+          slot = (slot + 1) & (PROC_TABLE_SIZE - 1);
 
-              if (do_verbose == TRUE)
-              {  (void)fprintf(stderr,"\n%s (%d@%s): %s process [%d] killed\n\n",pname,getpid(),hostname,monitor_pname,pid);
-                 (void)fflush(stderr);
-              }
-           }
+    table[slot] = *entry;
+    ++(*n_entries);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Sample CPU usage of (our) processes. CPU share is computed  */
+/* from the utime/stime delta since the last sample, so a      */
+/* process must be seen twice before any action is taken       */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void sample_processes(const FTYPE elapsed)
+
+{   uint32_t      n_entries   = 0,
+                  n_targets   = 0;
+
+    pid_t         self        = getpid();
+    uid_t         uid         = getuid();
+
+    proc_type     *old_table  = proc_table[current_table],
+                  *new_table  = proc_table[1 - current_table];
+
+    DIR           *dirp       = (DIR *)NULL;
+    struct dirent *next_item  = (struct dirent *)NULL;
+
+    if ((dirp = opendir("/proc")) == (DIR *)NULL)
+       return;
+
+    (void)memset((void *)new_table,0,PROC_TABLE_SIZE*sizeof(proc_type));
+
+    while ((next_item = readdir(dirp)) != (struct dirent *)NULL)
+    {    int32_t     slot;
+         pid_t       pid;
+         uint64_t    start_time,
+                     ticks;
+         proc_type   entry;
+         struct stat buf;
 
 
-           /*-----------------------------------------------*/
-           /* Process below threshold cpu usage - terminate */
-           /*-----------------------------------------------*/
+         /*-------------------------------------------------*/
+         /* Only look at our own processes (as "ps ux" did) */
+         /*-------------------------------------------------*/
 
-           else if (next_cpu_usage < min_cpu_usage)
-           {  (void)kill(pid,SIGKILL);
-              ++n_killed;
+         if (sscanf(next_item->d_name,"%d",&pid) != 1 || pid == self)
+            continue;
 
-              if (do_verbose == TRUE)
-              {  (void)fprintf(stderr,"\n%s (%d@%s): %s process [%d] killed\n\n",pname,getpid(),hostname,monitor_pname,pid);
-                 (void)fflush(stderr);
-              }
-           }
+         if (fstatat(dirfd(dirp),next_item->d_name,&buf,0) == (-1) || buf.st_uid != uid)
+            continue;
 
-        } while(feof(ps_stream) != 0);
+         if (read_proc_stat(pid,&start_time,&ticks) == FALSE)
+            continue;
 
 
-    /*-------------------------*/
-    /* Close ps command stream */
-    /*-------------------------*/
+         /*------------------------------------------------------*/
+         /* New process (or PID has been reused) -- classify it  */
+         /* and use this sample as baseline                      */
+         /*------------------------------------------------------*/
 
-    (void)pclose(ps_stream);
+         if ((slot = proc_lookup(old_table,pid)) == (-1) || old_table[slot].start_time != start_time)
+         {  entry.pid        = pid;
+            entry.start_time = start_time;
+            entry.monitor    = classify_process(pid);
+         }
 
 
-    /*-----------------------*/
-    /* Schedule next SIGALRM */
-    /*-----------------------*/
+         /*-----------------------------------------------------*/
+         /* Process we have seen before -- if it is monitored,  */
+         /* check its CPU share over the last sample period     */
+         /*-----------------------------------------------------*/
 
-    (void)alarm(period);
+         else
+         {  entry = old_table[slot];
+
+            if (entry.monitor != (-1) && elapsed > 0.0)
+            {  FTYPE cpu_usage;
+
+               cpu_usage = 100.0*(FTYPE)(ticks - entry.ticks)/((FTYPE)clock_ticks*elapsed);
+               if (cpu_usage > max_cpu_usage || cpu_usage < min_cpu_usage)
+               {  (void)kill(pid,SIGKILL);
+                  ++n_killed;
+
+                  if (do_verbose == TRUE)
+                  {  (void)fprintf(stderr,"\n%s (%d@%s): %s process [%d] killed (cpu usage %5.2F%%)\n\n",
+                                          pname,self,hostname,monitor_pname[entry.monitor],pid,cpu_usage);
+                     (void)fflush(stderr);
+                  }
+
+                  continue;
+               }
+            }
+         }
+
+         entry.ticks = ticks;
+         proc_insert(new_table,&n_entries,&entry);
+
+         if (entry.monitor != (-1))
+            ++n_targets;
+    }
+
+    (void)closedir(dirp);
+
+    current_table = 1 - current_table;
+    n_tracked     = n_targets;
 }
 
 
 
+
 /*--------------*/
 /* Exit handler */
 /*--------------*/
@@ -202,7 +408,9 @@ _PRIVATE int32_t exit_handler(const int32_t signum)
 _PRIVATE  int32_t status_handler(const  int32_t signum)
 
 
-{  (void)fprintf(stderr,"\nphagocyte abnormal process killer version %s, (C) Tumbling Dice, 2024 (gcc %s: built %s %s)\n\n",PHAGOCYTE_VERSION,__VERSION__,__TIME__,__DATE__);
+{  uint32_t i;
+
+   (void)fprintf(stderr,"\nphagocyte abnormal process killer version %s, (C) Tumbling Dice, 2024 (gcc %s: built %s %s)\n\n",PHAGOCYTE_VERSION,__VERSION__,__TIME__,__DATE__);
 
    if (do_verbose == TRUE)
       (void)fprintf(stderr,"    verbose mode                   : on\n");
@@ -214,8 +422,14 @@ _PRIVATE  int32_t status_handler(const  int32_t signum)
    else
       (void)fprintf(stderr,"    daemon mode                    :  off\n");
 
-   (void)fprintf(stderr,"    partial monitoredprocess name  :  %s\n",           monitor_pname);
-   (void)fprintf(stderr,"    monitor period                 :  %04d seconds\n", period);     
+   for (i=0; i<n_monitored; ++i)
+       (void)fprintf(stderr,"    partial monitoredprocess name  :  %s\n",        monitor_pname[i]);
+
+   (void)fprintf(stderr,"    monitored processes            :  %04d\n",         n_tracked);
+   if (period == 0)
+      (void)fprintf(stderr,"    monitor period                 :  none (sampling disabled)\n");
+   else
+      (void)fprintf(stderr,"    monitor period                 :  %04d seconds\n", period);     
    (void)fprintf(stderr,"    minimum cpu usage              :  %5.2F%%\n",      min_cpu_usage);
    (void)fprintf(stderr,"    maximum cpu usage              :  %5.2F%%\n\n",    max_cpu_usage);
 
@@ -334,8 +548,8 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        (void)fprintf(stderr,"Usage: phagocyte [-usage] | [-help] |\n");
        (void)fprintf(stderr,"       [-verbose:FALSE]\n");
        (void)fprintf(stderr,"       [-daemon [<name of daemon process>]]\n");
-       (void)fprintf(stderr,"       !-monitor <process name>!\n");
-       (void)fprintf(stderr,"       [-period <process CPU usage polling delay in second]\n");
+       (void)fprintf(stderr,"       !-monitor <process name>! [-monitor <process name> ...]\n");
+       (void)fprintf(stderr,"       [-period <process CPU usage polling delay in seconds:none (not sampled)>]\n");
        (void)fprintf(stderr,"       [-mincpu <usage%%: %5.2F%%>]\n",min_cpu_usage);
        (void)fprintf(stderr,"       [-maxcpu <usage%%: %5.2F%%>]\n\n",max_cpu_usage);
        (void)fflush(stderr);
@@ -407,8 +621,10 @@ _PUBLIC  int32_t main(int argc, char *argv[])
           /* Get name of monitored process */
           /*-------------------------------*/
 
-          if (i <= argc - 1 && argv[i+1][0] != '-')
-             (void)sscanf(argv[i+1],"%s",monitor_pname); 
+          if (i <= argc - 1 && argv[i+1][0] != '-' && n_monitored < MAX_MONITORED)
+          {  (void)sscanf(argv[i+1],"%s",monitor_pname[n_monitored]); 
+             ++n_monitored;
+          }
 
 
           /*-------*/
@@ -473,7 +689,7 @@ _PUBLIC  int32_t main(int argc, char *argv[])
        /*---------------------------------------*/
 
        else if (strcmp(argv[i],"-period") == 0)
-       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&period) != 1) 
+       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&period) != 1 || period == 0) 
           {  if (do_verbose == TRUE)
              {  (void)fprintf(stderr,"\n%s (%d@%s): period must be a positive integer value\n\n",pname,getpid(),hostname);
                 (void)fflush(stderr);
@@ -513,7 +729,6 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     (void)signal(SIGQUIT,(void *)&exit_handler);
     (void)signal(SIGHUP, (void *)&exit_handler);
     (void)signal(SIGTERM,(void *)&exit_handler);
-    (void)signal(SIGALRM,(void *)&alarm_handler);
     (void)signal(SIGUSR1,(void *)&status_handler);
 
 
@@ -651,11 +866,66 @@ _PUBLIC  int32_t main(int argc, char *argv[])
     }
 
 
-    /*------------------------------------*/
-    /* Wait for SIGALRM (probe cpu usage) */
-    /*------------------------------------*/
+    /*-------------------------------------------------------*/
+    /* Sampling timer -- we sleep on it between samples (the */
+    /* first sample is a baseline)                           */
+    /*-------------------------------------------------------*/
+
+    if ((clock_ticks = sysconf(_SC_CLK_TCK)) <= 0)
+       clock_ticks = 100;
+
+
+    /*-------------------------------------------------------*/
+    /* No sampling period given -- processes are not sampled */
+    /* (so nothing is killed). Wait for signals              */
+    /*-------------------------------------------------------*/
+
+    if (period == 0)
+    {  while (TRUE)
+             (void)pause();
+    }
+
+    {  int32_t           timer_des;
+       FTYPE             last_sample;
+       struct timespec   now;
+       struct itimerspec interval;
+
+       if ((timer_des = timerfd_create(CLOCK_MONOTONIC,TFD_CLOEXEC)) == (-1))
+       {  if (do_verbose == TRUE)
+          {  (void)fprintf(stderr,"\n%s (%d@%s): failed to create sampling timer\n\n",pname,getpid(),hostname);
+             (void)fflush(stderr);
+          }
 
-    (void)alarm(period);
-    while (TRUE)
-        (void)usleep(1000);
+          exit(255);
+       }
+
+       interval.it_value.tv_sec     = period;
+       interval.it_value.tv_nsec    = 0;
+       interval.it_interval.tv_sec  = period;
+       interval.it_interval.tv_nsec = 0;
+       (void)timerfd_settime(timer_des,0,&interval,(struct itimerspec *)NULL);
+
+       (void)clock_gettime(CLOCK_MONOTONIC,&now);
+       last_sample = (FTYPE)now.tv_sec + (FTYPE)now.tv_nsec*1.0e-9;
+       sample_processes(0.0);
+
+       while (TRUE)
+       {     FTYPE    this_sample;
+             uint64_t expirations;
+
+
+             /*------------------------------------------------*/
+             /* Interrupted (e.g. by SIGUSR1) -- keep sleeping */
+             /*------------------------------------------------*/
+
+             if (read(timer_des,&expirations,sizeof(uint64_t)) != sizeof(uint64_t))
+                continue;
+
+             (void)clock_gettime(CLOCK_MONOTONIC,&now);
+             this_sample = (FTYPE)now.tv_sec + (FTYPE)now.tv_nsec*1.0e-9;
+
+             sample_processes(this_sample - last_sample);
+             last_sample = this_sample;
+       }
+    }
 }
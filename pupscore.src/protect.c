@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 2.02
-    Dated:   11th December 2024
+    Version: 2.03
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk
 ----------------------------------*/
 
@@ -28,13 +28,15 @@
 #include <vstamp.h>
 #include <time.h>
 #include <bsd/bsd.h>
+#include <sys/inotify.h>
+#include <poll.h>
 
 
 /*---------*/
 /* Version */
 /*---------*/
 
-#define PROTECT_VERSION    "2.02"
+#define PROTECT_VERSION    "2.03"
 
 #ifdef BUBBLE_MEMORY_SUPPORT
 #include <bubble.h>
@@ -63,7 +65,7 @@
 #endif /* AARCH64 */
 #undef __DEFINE__
 
-#define DELAY 100000
+#define POLL_DELAY 100000
 
 
 /*----------------------------------------------*/
@@ -98,6 +100,7 @@ _PRIVATE void protect_usage()
 
 {   (void)fprintf(stderr,"!-principal <file/directory to protect>!\n");
     (void)fprintf(stderr,"[-defer:FALSE]\n");
+    (void)fprintf(stderr,"[-recursive:FALSE]\n");
     (void)fprintf(stderr,"[-lifetime <lifetime in minutes>]\n");
     (void)fprintf(stderr,"[-key <key (for files in directory):all>]\n\n"); 
     (void)fprintf(stderr,"[>& <ASCII log file>]\n\n");
@@ -141,6 +144,27 @@ _EXTERN char appl_build_date[SSIZE] = __DATE__;
 #define DEFAULT_LIFETIME      600 
 
 
+/*---------------------------------------------------------------*/
+/* Events we watch for. We do not watch for attribute changes    */
+/* because homeostats themselves change attributes when they     */
+/* repair files                                                  */
+/*---------------------------------------------------------------*/
+
+#define WATCH_EVENTS          (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_MODIFY)
+#define EVENT_BUFSIZE         65536
+#define WATCH_TIMEOUT         1000
+#define COALESCE_DELAY        20
+#define MAX_COALESCE          50
+
+
+/*-------------------------------------------------*/
+/* Watched directory (indexed by watch descriptor) */
+/*-------------------------------------------------*/
+
+typedef struct {   char *directory;                      // Watched directory (NULL if slot free)
+               } watch_type;
+
+
 /*-------------------------------------------------*/
 /* Functions which are private to this application */
 /*-------------------------------------------------*/
@@ -172,6 +196,33 @@ _PROTOTYPE _PRIVATE int32_t psrp_process_status(int32_t, char *[]);
 // Scan directory (for new files to protect)
 _PROTOTYPE _PRIVATE void scan_directory(char *);
 
+// Is directory entry a candidate for protection?
+_PROTOTYPE _PRIVATE _BOOLEAN protectable(const char *);
+
+// Protect (key matching) file in directory
+_PROTOTYPE _PRIVATE _BOOLEAN protect_entry(const char *, const char *);
+
+// Watch directory (and subdirectories if recursive)
+_PROTOTYPE _PRIVATE int32_t add_watch(const char *);
+
+// Set up (inotify) watches on principal
+_PROTOTYPE _PRIVATE _BOOLEAN watch_init(void);
+
+// Remove all watches
+_PROTOTYPE _PRIVATE void watch_close(void);
+
+// Handle (inotify) event
+_PROTOTYPE _PRIVATE void watch_event(const struct inotify_event *);
+
+// Grow pending tables (if file table has grown)
+_PROTOTYPE _PRIVATE void pending_resize(void);
+
+// Run homeostat for protected file now
+_PROTOTYPE _PRIVATE void run_homeostat(const int32_t);
+
+// Wait for (and coalesce) events
+_PROTOTYPE _PRIVATE void watch_wait(const int32_t);
+
 
 
 /*--------------------------------------------*/
@@ -188,6 +239,22 @@ _PRIVATE struct       stat stat_buf;                     /* File (inode) statist
 _PRIVATE  des_t       fdes                  = 0;         /* Number of times principal attacked             */
 _PRIVATE uint32_t     n_files               = 0;         /* Number of protected files (in directory)       */
 _PRIVATE time_t       lifetime              = FOREVER;   /* Protection lifetime                            */
+_PRIVATE _BOOLEAN     recursive             = FALSE;     /* TRUE if protecting subdirectories              */
+_PRIVATE des_t        watch_des             = (-1);      /* Inotify descriptor (-1 if polling)             */
+_PRIVATE int32_t      principal_wd          = (-1);      /* Watch descriptor of principal (directory)      */
+_PRIVATE char         principal_base[SSIZE] = "";        /* Principal (file) name without directory        */
+_PRIVATE uint32_t     n_watches             = 0;         /* Number of watched directories                  */
+_PRIVATE int32_t      n_watch_slots         = 0;         /* Number of slots in watch table                 */
+_PRIVATE watch_type   *watch_list           = (watch_type *)NULL;
+                                                         /* Watch table                                    */
+_PRIVATE _BOOLEAN     watch_rescan          = FALSE;     /* TRUE if watched directories must be rescanned  */
+_PRIVATE _BOOLEAN     watch_reset           = FALSE;     /* TRUE if principal changed (rebuild watches)    */
+_PRIVATE _BOOLEAN     *pending              = (_BOOLEAN *)NULL;
+                                                         /* TRUE if file homeostat is queued               */
+_PRIVATE int32_t      *pending_list         = (int32_t *)NULL;
+                                                         /* Queued file homeostats                         */
+_PRIVATE uint32_t     n_pending             = 0;         /* Number of queued file homeostats               */
+_PRIVATE uint32_t     pending_size          = 0;         /* Size of pending tables (ftab slots)            */
                                                          /*------------------------------------------------*/
 
 #ifdef HYDRA_OF_LERNA
@@ -255,7 +322,7 @@ refork:
        /*---------------------------------------------------*/ 
 
        while(getppid() != 1)
-            (void)pups_usleep(DELAY);
+            (void)pups_usleep(POLL_DELAY);
 
        if(appl_verbose == TRUE)
        {  (void)strdate(date);
@@ -321,7 +388,7 @@ refork:
               goto refork;
            }
 
-           (void)pups_usleep(DELAY);
+           (void)pups_usleep(POLL_DELAY);
        }
     }
     else
@@ -357,6 +424,17 @@ refork:
     if(pups_locate(&init,"defer",&argc,args,0) !=  NOT_FOUND) 
        do_defer = TRUE;
 
+    if(pups_locate(&init,"recursive",&argc,args,0) !=  NOT_FOUND) 
+    {  recursive = TRUE;
+
+       if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): protecting (directory) principal recursively\n",
+                                                   date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+    }
+
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
        (void)fprintf(stderr,"%s %s (%d@%s:%s): deferred protection enabled\n",
@@ -569,7 +647,7 @@ refork:
              }
 
              while(access(file_name,F_OK | R_OK | W_OK) == (-1))
-                   pups_usleep(DELAY);
+                   pups_usleep(POLL_DELAY);
 
              if(appl_verbose == TRUE)
              {  (void)strdate(date);
@@ -594,6 +672,19 @@ refork:
     }
 
 
+    /*-----------------------------------------------------------*/
+    /* Watch principal (so we are told at once if protected      */
+    /* files are tampered with). If we cannot watch it we poll   */
+    /*-----------------------------------------------------------*/
+
+    if(watch_init() == FALSE && appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): inotify not available (polling principal)\n",
+                                           date,appl_name,appl_pid,appl_host,appl_owner);
+       (void)fflush(stderr);
+    }
+
+
     /*------------------------------------------------------------------------*/
     /* simply wait until protected files are tampered with (until terminated) */
     /*------------------------------------------------------------------------*/
@@ -616,11 +707,30 @@ refork:
 
         /*-----------------------------------------------------------------------*/
         /* Check to see if we have any new entries in directory -- if they match */
-        /* key we will have to protect them                                      */
+        /* key we will have to protect them. If we are watching the principal    */
+        /* we only need to do this if the key has changed or events were lost    */
         /*-----------------------------------------------------------------------*/
 
-        if(is_directory == TRUE)
-           scan_directory(file_name);      
+        if(watch_reset == TRUE)
+        {  watch_reset = FALSE;
+
+           watch_close();
+           (void)watch_init();
+        }
+
+        if(watch_des == (-1))
+        {  if(is_directory == TRUE)
+              scan_directory(file_name);      
+        }
+        else if(watch_rescan == TRUE)
+        {  int32_t i;
+
+           watch_rescan = FALSE;
+           for(i=0; i<n_watch_slots; ++i)
+           {  if(watch_list[i].directory != (char *)NULL && is_directory == TRUE)
+                 scan_directory(watch_list[i].directory);
+           }
+        }
 
 
         #ifdef HYDRA_OF_LERNA
@@ -641,7 +751,17 @@ refork:
         }
         #endif /* HYDRA_OF_LERNA */
 
-        (void)pups_usleep(DELAY);
+        if(watch_des == (-1))
+           (void)pups_usleep(POLL_DELAY);
+        else
+        {
+
+           #ifdef HYDRA_OF_LERNA
+           watch_wait(POLL_DELAY/1000);
+           #else
+           watch_wait(WATCH_TIMEOUT);
+           #endif /* HYDRA_OF_LERNA */
+        }
     }
 
 
@@ -689,7 +809,14 @@ _PRIVATE int32_t psrp_process_status(int32_t argc, char *argv[])
          (void)fprintf(psrp_out,"    Protecting regular file %s\n\n",file_name);
    }
 
-   (void)fflush(psrp_out);   
+   if(watch_des == (-1))
+      (void)fprintf(psrp_out,"    Principal is polled (every %d milliseconds)\n\n",POLL_DELAY/1000);
+   else if(recursive == TRUE)
+      (void)fprintf(psrp_out,"    Principal is watched recursively (%d directories watched)\n\n",n_watches);
+   else
+      (void)fprintf(psrp_out,"    Principal is watched (inotify)\n\n");
+
+   (void)fflush(psrp_out);
 
    #ifdef HYDRA_OF_LERNA
    (void)fprintf(psrp_out,"    Thread of execution protected by (bi-process) hydra-of-lerna algorithm\n\n");
@@ -702,6 +829,414 @@ _PRIVATE int32_t psrp_process_status(int32_t argc, char *argv[])
 
 
 
+/*--------------------------------------------------------------------*/
+/* Is directory entry a candidate for protection? Shadow files (which */
+/* homeostats create next to the files they protect) are not          */
+/*--------------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN protectable(const char *entry_name)
+
+{   if(strcmp(entry_name,".")           == 0    ||
+       strcmp(entry_name,"..")          == 0    ||
+       strin(entry_name,"uprot")        == TRUE ||
+       strin(entry_name,"shadow.tmp")   == TRUE  )
+       return(FALSE);
+
+    return(TRUE);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Protect (key matching) file if it is not yet     */
+/* protected. Returns TRUE if file is now protected */
+/*--------------------------------------------------*/
+
+_PRIVATE _BOOLEAN protect_entry(const char *dir_name, const char *entry_name)
+
+{   des_t       fdes             = (-1);
+    char        path[SSIZE]      = "",
+                hname[SSIZE]     = "";
+    struct stat buf;
+
+    if(protectable(entry_name) == FALSE || (strin(entry_name,key) == FALSE && strcmp(key,"all") != 0))
+       return(FALSE);
+
+    (void)snprintf(path,SSIZE,"%s/%s",dir_name,entry_name);
+    if(stat(path,&buf) == (-1) || (S_ISREG(buf.st_mode) == 0 && S_ISFIFO(buf.st_mode) == 0))
+       return(FALSE);
+
+    if(pups_get_ftab_index_by_name(path) != (-1))
+       return(FALSE);
+
+    if((fdes = pups_open(path,0,LIVE)) == (-1))
+       return(FALSE);
+
+    (void)pups_creator(fdes);
+    (void)snprintf(hname,SSIZE,"default_fd_homeostat: %s",path);
+    (void)pups_fd_alive(fdes,hname,&pups_default_fd_homeostat);
+
+    ++n_files;
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): protecting file \"%s\" (in directory \"%s\")\n",
+                                date,appl_name,appl_pid,appl_host,appl_owner,entry_name,dir_name);
+       (void)fflush(stderr);
+    }
+
+    return(TRUE);
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Watch directory (and if we are protecting recursively    */
+/* its subdirectories). Files which are already in watched  */
+/* directories are protected                                */
+/*----------------------------------------------------------*/
+
+_PRIVATE int32_t add_watch(const char *dir_name)
+
+{   int32_t       wd;
+    DIR           *dirp       = (DIR *)NULL;
+    struct dirent *next_entry = (struct dirent *)NULL;
+
+    if((wd = inotify_add_watch(watch_des,dir_name,WATCH_EVENTS | IN_ONLYDIR)) == (-1))
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): cannot watch directory \"%s\" (%s)\n",
+                        date,appl_name,appl_pid,appl_host,appl_owner,dir_name,strerror(errno));
+          (void)fflush(stderr);
+       }
+
+       return(-1);
+    }
+
+
+    /*----------------------------------------------------*/
+    /* Watch table is indexed by watch descriptor (which  */
+    /* the kernel allocates sequentially)                 */
+    /*----------------------------------------------------*/
+
+    if(wd >= n_watch_slots)
+    {  uint32_t old_slots = n_watch_slots;
+
+       while(wd >= n_watch_slots)
+          n_watch_slots += ALLOC_QUANTUM;
+
+       watch_list = (watch_type *)pups_realloc((void *)watch_list,n_watch_slots*sizeof(watch_type));
+       (void)memset((void *)&watch_list[old_slots],0,(n_watch_slots - old_slots)*sizeof(watch_type));
+    }
+
+    if(watch_list[wd].directory == (char *)NULL)
+    {  watch_list[wd].directory = (char *)pups_malloc(strlen(dir_name) + 1);
+       (void)strlcpy(watch_list[wd].directory,dir_name,strlen(dir_name) + 1);
+
+       ++n_watches;
+    }
+
+
+    /*----------------------------------------------*/
+    /* Protect files which are already in directory */
+    /*----------------------------------------------*/
+
+    scan_directory((char *)dir_name);
+
+    if(recursive == FALSE || (dirp = opendir(dir_name)) == (DIR *)NULL)
+       return(wd);
+
+    while((next_entry = readdir(dirp)) != (struct dirent *)NULL)
+    {  char        path[SSIZE] = "";
+       struct stat buf;
+
+       if(strcmp(next_entry->d_name,".") == 0 || strcmp(next_entry->d_name,"..") == 0)
+          continue;
+
+       (void)snprintf(path,SSIZE,"%s/%s",dir_name,next_entry->d_name);
+
+       if(next_entry->d_type == DT_DIR || (next_entry->d_type == DT_UNKNOWN && lstat(path,&buf) != (-1) && S_ISDIR(buf.st_mode)))
+          (void)add_watch(path);
+    }
+
+    (void)closedir(dirp);
+    return(wd);
+}
+
+
+
+
+/*------------------------------------------------------*/
+/* Grow pending tables. The file table (appl_max_files) */
+/* may grow after the watches have been set up          */
+/*------------------------------------------------------*/
+
+_PRIVATE void pending_resize(void)
+
+{   if(appl_max_files <= pending_size)
+       return;
+
+    pending      = (_BOOLEAN *)pups_realloc((void *)pending,     appl_max_files*sizeof(_BOOLEAN));
+    pending_list = (int32_t  *)pups_realloc((void *)pending_list,appl_max_files*sizeof(int32_t));
+
+    (void)memset((void *)&pending[pending_size],0,(appl_max_files - pending_size)*sizeof(_BOOLEAN));
+    pending_size = appl_max_files;
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Set up (inotify) watches on principal. If we are protecting  */
+/* a single file we watch the directory it lives in. Returns    */
+/* FALSE if inotify is not available (and we have to poll)      */
+/*--------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN watch_init(void)
+
+{   char watch_dir[SSIZE] = "";
+
+    if((watch_des = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) == (-1))
+       return(FALSE);
+
+    pending_resize();
+
+    if(is_directory == TRUE)
+       (void)strlcpy(watch_dir,file_name,SSIZE);
+    else
+    {  char *base = (char *)NULL;
+
+       (void)strlcpy(watch_dir,file_name,SSIZE);
+       if((base = strrchr(watch_dir,'/')) == (char *)NULL)
+       {  (void)strlcpy(principal_base,file_name,SSIZE);
+          (void)strlcpy(watch_dir,".",SSIZE);
+       }
+       else
+       {  (void)strlcpy(principal_base,base + 1,SSIZE);
+
+          if(base == watch_dir)
+             watch_dir[1] = '\0';
+          else
+             *base = '\0';
+       }
+    }
+
+    if((principal_wd = add_watch(watch_dir)) == (-1))
+    {  (void)close(watch_des);
+       watch_des = (-1);
+
+       return(FALSE);
+    }
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): watching %d directories (inotify)\n",
+                                date,appl_name,appl_pid,appl_host,appl_owner,n_watches);
+       (void)fflush(stderr);
+    }
+
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------*/
+/* Remove all watches (principal has been changed) */
+/*-------------------------------------------------*/
+
+_PRIVATE void watch_close(void)
+
+{   uint32_t i;
+
+    if(watch_des != (-1))
+    {  (void)close(watch_des);
+       watch_des = (-1);
+    }
+
+    for(i=0; i<n_watch_slots; ++i)
+    {  if(watch_list[i].directory != (char *)NULL)
+       {  (void)pups_free((void *)watch_list[i].directory);
+          watch_list[i].directory = (char *)NULL;
+       }
+    }
+
+    n_watches    = 0;
+    principal_wd = (-1);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Handle (inotify) event. New files are protected at once, the  */
+/* homeostats of files which have been tampered with are queued  */
+/* (so an event storm runs each homeostat once)                  */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void watch_event(const struct inotify_event *event)
+
+{   int32_t index;
+    char    path[SSIZE] = "";
+
+
+    /*-----------------------------------------------------------*/
+    /* Events have been lost -- rescan watched directories. Our  */
+    /* homeostats (which still run from virtual timers) will     */
+    /* catch any tampering we have missed                        */
+    /*-----------------------------------------------------------*/
+
+    if(event->mask & IN_Q_OVERFLOW)
+    {  watch_rescan = TRUE;
+       return;
+    }
+
+    if(event->wd < 0 || event->wd >= n_watch_slots || watch_list[event->wd].directory == (char *)NULL)
+       return;
+
+
+    /*---------------------------------*/
+    /* Watched directory has gone away */
+    /*---------------------------------*/
+
+    if(event->mask & IN_IGNORED)
+    {  (void)pups_free((void *)watch_list[event->wd].directory);
+       watch_list[event->wd].directory = (char *)NULL;
+       --n_watches;
+
+       if(event->wd == principal_wd && is_directory == TRUE)
+       {  if(appl_verbose == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): (protection) directory \"%s\" has gone away\n",
+                                      date,appl_name,appl_pid,appl_host,appl_owner,file_name);
+             (void)fflush(stderr);
+          }
+
+          pups_exit(255);
+       }
+
+       return;
+    }
+
+    if(event->len == 0)
+       return;
+
+    (void)snprintf(path,SSIZE,"%s/%s",watch_list[event->wd].directory,event->name);
+
+
+    /*-----------------------------------------------------*/
+    /* New subdirectory (if we are protecting recursively) */
+    /*-----------------------------------------------------*/
+
+    if(event->mask & IN_ISDIR)
+    {  if(is_directory == TRUE && recursive == TRUE && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+          (void)add_watch(path);
+
+       return;
+    }
+
+
+    /*------------------------------------------------------*/
+    /* Protecting single file -- ignore its neighbours      */
+    /*------------------------------------------------------*/
+
+    if(is_directory == FALSE)
+    {  if(strcmp(event->name,principal_base) != 0)
+          return;
+
+       (void)strlcpy(path,file_name,SSIZE);
+    }
+    else if(event->mask & (IN_CREATE | IN_MOVED_TO))
+    {  (void)protect_entry(watch_list[event->wd].directory,event->name);
+       return;
+    }
+
+
+    /*-----------------------------------------------------------*/
+    /* Protected file has been deleted, renamed or modified      */
+    /*-----------------------------------------------------------*/
+
+    if(event->mask & (IN_DELETE | IN_MOVED_FROM | IN_MODIFY))
+    {  pending_resize();
+
+       if((index = pups_get_ftab_index_by_name(path)) != (-1) && index < pending_size && pending[index] == FALSE)
+       {  pending[index]            = TRUE;
+          pending_list[n_pending++] = index;
+       }
+    }
+}
+
+
+
+
+/*----------------------------------------------------*/
+/* Run (queued) homeostat for protected file now      */
+/* rather than waiting for its virtual timer to fire  */
+/*----------------------------------------------------*/
+
+_PRIVATE void run_homeostat(const int32_t f_index)
+
+{   uint32_t i;
+
+    for(i=0; i<appl_max_vtimers; ++i)
+    {  if((void *)vttab[i].handler != (void *)NULL && strcmp(vttab[i].name,ftab[f_index].hname) == 0)
+       {  (void)pupsighold(SIGALRM,TRUE);
+          (*vttab[i].handler)((void *)&vttab[i],vttab[i].handler_args);
+          (void)pupsigrelse(SIGALRM);
+
+          return;
+       }
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Wait (up to timeout milliseconds) for events. Once events   */
+/* start arriving we keep reading until the storm has died     */
+/* down (or we have waited for MAX_COALESCE periods) and then  */
+/* run the homeostat of each file which was tampered with once */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void watch_wait(const int32_t timeout)
+
+{   _IMMORTAL char event_buf[EVENT_BUFSIZE] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    uint32_t      i,
+                  passes = 0;
+    ssize_t       size;
+    struct pollfd pfd;
+
+    pfd.fd     = watch_des;
+    pfd.events = POLLIN;
+
+    if(poll(&pfd,1,timeout) <= 0)
+       return;
+
+    do {   while((size = read(watch_des,event_buf,EVENT_BUFSIZE)) > 0)
+           {  char *ptr = (char *)NULL;
+
+              for(ptr = event_buf; ptr < event_buf + size; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len)
+                 watch_event((struct inotify_event *)ptr);
+           }
+
+           ++passes;
+       } while(passes < MAX_COALESCE && poll(&pfd,1,COALESCE_DELAY) > 0);
+
+    for(i=0; i<n_pending; ++i)
+    {  pending[pending_list[i]] = FALSE;
+       run_homeostat(pending_list[i]);
+    }
+
+    n_pending = 0;
+}
+
+
+
+
 /*----------------------------------------------------------------------------------------*/
 /* Routine to automically extended protection to key-match files which have been added to */
 /* the protected directory                                                                */
@@ -709,14 +1244,9 @@ _PRIVATE int32_t psrp_process_status(int32_t argc, char *argv[])
 
 _PRIVATE void scan_directory(char *dir_name)
 
-{   uint32_t      i,
-                  index,
-                  n_used      = 0,
-                  n_alloc     = 0;
-
+{   int32_t       index;
     DIR           *dirp       = (DIR *)NULL;
     struct dirent *next_entry = (struct dirent *)NULL;
-    char          **nlist     = (char **)NULL;
 
 
     /*---------------------------------------------------*/
@@ -724,110 +1254,87 @@ _PRIVATE void scan_directory(char *dir_name)
     /*---------------------------------------------------*/
 
     if((dirp = opendir(dir_name)) == (DIR *)NULL)
-    {  if(appl_verbose == TRUE)
+    {
+
+       /*----------------------------------------------*/
+       /* Subdirectories may come and go (if we are    */
+       /* protecting recursively)                      */
+       /*----------------------------------------------*/
+
+       if(strcmp(dir_name,file_name) != 0)
+          return;
+
+       if(appl_verbose == TRUE)
        {  (void)strdate(date);
           (void)fprintf(stderr,"%s %s (%d@%s:%s): cannot open (protection) directory (%s)\n",
                                 date,appl_name,appl_pid,appl_host,appl_owner,file_name);
           (void)fflush(stderr);
-
-          pups_exit(255);
        }
+
+       pups_exit(255);
     }
 
 
-    /*-----------------------------------------------------*/
-    /* Build snapshot of files in the protection directory */
-    /*-----------------------------------------------------*/
+    /*---------------------------------------------------------------------------------*/
+    /* Unprotect any files which no longer match key and add any new files to the list */
+    /*---------------------------------------------------------------------------------*/
 
     while((next_entry = readdir(dirp)) != (struct dirent *)NULL)
     {
 
         /*-----------------------------------------------------------------*/
         /* If any of the files in the directory are themselves a directory */
-        /* they cannot be protected.                                       */
+        /* they cannot be protected (but if we are protecting recursively  */
+        /* and are polling we must scan them)                              */
         /*-----------------------------------------------------------------*/
 
-        (void)snprintf(pathname,SSIZE,"%s/%s",file_name,next_entry->d_name); 
-        (void)stat(pathname,&stat_buf);
+        (void)snprintf(pathname,SSIZE,"%s/%s",dir_name,next_entry->d_name); 
 
-        if((S_ISREG(stat_buf.st_mode) || S_ISFIFO(stat_buf.st_mode))    &&
-           strcmp(next_entry->d_name,".")    != 0                       &&
-           strcmp(next_entry->d_name,"..")   != 0                       && 
-           strin(next_entry->d_name,"uprot") == FALSE                    )
-        {
+        if(protectable(next_entry->d_name) == FALSE || stat(pathname,&stat_buf) == (-1))
+           continue;
 
-           /*-------------------------------*/
-           /* Allocate space for name table */ 
-           /*-------------------------------*/
+        if(S_ISDIR(stat_buf.st_mode))
+        {  if(recursive == TRUE && watch_des == (-1))
+           {  char subdir_name[SSIZE] = "";
 
-           if(n_used % ALLOC_QUANTUM == 0)
-           {  n_alloc += ALLOC_QUANTUM;
-              nlist = (char **)pups_calloc(n_alloc,sizeof(char *));
-           } 
+              (void)strlcpy(subdir_name,pathname,SSIZE);
+              scan_directory(subdir_name);
+           }
 
-           nlist[n_used] = (char *)pups_malloc(SSIZE*sizeof(char));
-           (void)strlcpy(nlist[n_used++],pathname,SSIZE);
+           continue;
         }
-    }
-
-
-    /*---------------------------------------------------------------------------------*/
-    /* Ok - we have the current list of files in the protection directory -- unprotect */
-    /* any time expired files and add any new files to the list                        */
-    /*---------------------------------------------------------------------------------*/
-
-    for(i=0; i<n_used; ++i)
-    {  struct stat statbuf;
-
-
-       /*---------------------------*/
-       /* Do we have any new files? */
-       /*---------------------------*/
 
-       if((index = pups_get_ftab_index_by_name(nlist[i])) == (-1) && (strin(nlist[i],key) == TRUE || strcmp(key,"all") == 0))
-       {  des_t fdes         = (-1);
-          char  hname[SSIZE] = "";
 
-          fdes = pups_open(nlist[i],0,LIVE);
-          (void)pups_creator(fdes);
-          (void)snprintf(hname,SSIZE,"default_fd_homeostat: %s",nlist[i]);
-          (void)pups_fd_alive(fdes,hname,&pups_default_fd_homeostat);
+        /*---------------------------*/
+        /* Do we have any new files? */
+        /*---------------------------*/
 
-          ++n_files;
-       }       
+        if((index = pups_get_ftab_index_by_name(pathname)) == (-1))
+           (void)protect_entry(dir_name,next_entry->d_name);
 
 
-       /*---------------------------------------------------*/
-       /* If the key has been changed revoke the protection */
-       /* of those file which do not match new key          */
-       /*---------------------------------------------------*/
+        /*---------------------------------------------------*/
+        /* If the key has been changed revoke the protection */
+        /* of those file which do not match new key          */
+        /*---------------------------------------------------*/
 
-       if(index != (-1) && strin(ftab[index].fname,key) == FALSE && strcmp(key,"all") != 0)
-       {  if(appl_verbose == TRUE)
-          {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): protection revoked for file \"%s\"\n",
-                            date,appl_name,appl_pid,appl_host,appl_owner,ftab[index].fname);
-             (void)fflush(stderr);
-          }
+        else if(strin(ftab[index].fname,key) == FALSE && strcmp(key,"all") != 0)
+        {  if(appl_verbose == TRUE)
+           {  (void)strdate(date);
+              (void)fprintf(stderr,"%s %s (%d@%s:%s): protection revoked for file \"%s\"\n",
+                             date,appl_name,appl_pid,appl_host,appl_owner,ftab[index].fname);
+              (void)fflush(stderr);
+           }
 
-          (void)pupsighold(SIGALRM,TRUE);
-          (void)pups_fd_dead(ftab[index].fdes);
-          (void)pups_close(ftab[index].fdes);
-          (void)pupsigrelse(SIGALRM);
+           (void)pupsighold(SIGALRM,TRUE);
+           (void)pups_fd_dead(ftab[index].fdes);
+           (void)pups_close(ftab[index].fdes);
+           (void)pupsigrelse(SIGALRM);
 
-          --n_files;
-       }
+           --n_files;
+        }
     }
 
-
-    /*-------------*/
-    /* Free memory */
-    /*-------------*/
-
-    for(i=0; i<n_alloc; ++i)
-       (void)pups_free((void *)nlist[i]);
-
-    (void)pups_free((void *)nlist);
     (void)closedir(dirp);
 }
 
@@ -1226,6 +1733,8 @@ _PRIVATE int32_t set_key(int32_t argc, char *argv[])
     }
 
     (void)strlcpy(key,argv[1],SSIZE);
+    watch_rescan = TRUE;
+
     (void)fprintf(psrp_out,"\n(directory \"%s\") file key changed to \"%s\"\n\n",file_name,key);
     (void)fflush(psrp_out);
 
@@ -1328,6 +1837,8 @@ _PRIVATE int32_t set_principal(int32_t argc, char *argv[])
     }
 
     (void)strlcpy(file_name,argv[1],SSIZE);
+    watch_reset = TRUE;
+
     (void)fprintf(psrp_out,"\nprincipal changed to \"%s\"\n\n",file_name);
     (void)fflush(psrp_out);
 
@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 22.11
-    Dated:   3rd January 2025 
+    Version: 22.14
+    Dated:   19th October 2026 
     E-mail:  mao@tumblingdice.co.uk
 --------------------------------------------------------------*/
 /*-------------------------------------------------------------*/
@@ -51,6 +51,9 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/socket.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <utmp.h>
 #include <termios.h>
 #include <vstamp.h>
@@ -97,7 +100,7 @@
 /* Version */
 /*---------*/
 
-#define PSRP_VERSION          "22.09"
+#define PSRP_VERSION          "22.14"
 
 
 /*---------------------------------------------*/
@@ -183,6 +186,7 @@ _PRIVATE void psrp_usage(void)
     (void)fprintf(stdout,"[-squiet:FALSE]\n");
     (void)fprintf(stdout,"[-c <PSRP request to be executed>]\n");
     (void)fprintf(stdout,"[-hard:FALSE]\n");
+    (void)fprintf(stdout,"[-fifo:FALSE]\n");
     (void)fprintf(stdout,"[-log:FALSE>]\n");
     (void)fprintf(stdout,"[-recursive:FALSE]\n");
 
@@ -346,6 +350,14 @@ _PRIVATE _BOOLEAN   log_state_updated                    = FALSE;
 _PRIVATE _BOOLEAN   prompt                               = TRUE;
 _PRIVATE _BOOLEAN   have_access_lock                     = FALSE;
 _PRIVATE _BOOLEAN   server_connected                     = FALSE;
+_PRIVATE _BOOLEAN   use_socket_transport                 = TRUE;
+_PRIVATE _BOOLEAN   sock_transaction                     = FALSE;
+_PRIVATE des_t      server_sock                          = (-1);
+_PRIVATE uint32_t   sock_seq                             = 0;
+_PRIVATE char       server_sock_name[SSIZE]              = "";
+_PRIVATE char       *sock_reply                          = (char *)NULL;
+_PRIVATE size_t     sock_reply_size                      = 0;
+_PRIVATE size_t     sock_reply_pos                       = 0;
 
 _PRIVATE char mstack_f_name[MAX_PSRP_MACRO_FILES][SSIZE] = { [0 ... MAX_PSRP_MACRO_FILES-1] = {""}};
 
@@ -503,6 +515,27 @@ _PROTOTYPE _PRIVATE _BOOLEAN psrp_open_server(void);
 // Close a PSRP server process
 _PROTOTYPE _PRIVATE int32_t psrp_close_server(const _BOOLEAN, const _BOOLEAN);
 
+// Open socket transport to PSRP server process
+_PROTOTYPE _PRIVATE int32_t psrp_open_server_sock(void);
+
+// Close socket transport to PSRP server process
+_PROTOTYPE _PRIVATE void psrp_close_server_sock(void);
+
+// Send request to PSRP server process via socket transport
+_PROTOTYPE _PRIVATE int32_t psrp_sock_transaction(const char *);
+
+// Get next line of reply from PSRP server process
+_PROTOTYPE _PRIVATE void psrp_get_reply(char *);
+
+// Display (possibly combined) socket transport reply
+_PROTOTYPE _PRIVATE void psrp_show_sock_reply(const char *);
+
+// Builtin to submit request file (pipelined or batched) via socket transport
+_PROTOTYPE _PRIVATE void builtin_psrp_submit(const char *);
+
+// Builtin to send databag to server via shared memory ring
+_PROTOTYPE _PRIVATE int32_t builtin_psrp_sendbag(char *);
+
 // Builtin to catenate last request to macro definition file
 _PROTOTYPE _PRIVATE void builtin_catenate_macro(char *);
 
@@ -646,6 +679,14 @@ _PUBLIC int32_t pups_main(int32_t argc, char *argv[])
 
 
 
+    /*---------------------------------------------------------------*/
+    /* Use FIFO transport for requests (even if server has a socket) */
+    /*---------------------------------------------------------------*/
+
+    if(pups_locate(&init,"fifo",&argc,args,0) != NOT_FOUND)
+       use_socket_transport = FALSE;
+
+
     /*-----------------------------------------------------------*/
     /* Hard link - psrp client stays attached to stopped servers */
     /*-----------------------------------------------------------*/
@@ -4019,6 +4060,26 @@ _PRIVATE _BOOLEAN psrp_process_command(char *request_line)
             }
 
 
+            /*-----------------------------------------------------*/
+            /* Submit file of requests via socket transport either */
+            /* pipelined (pipeline) or as a single batch (batch)   */
+            /*-----------------------------------------------------*/
+
+            if(strncmp(request,"pipeline ",9) == 0 || strncmp(request,"batch ",6) == 0)
+            {  builtin_psrp_submit(request);
+               goto next_request;
+            }
+
+
+            /*---------------------------------------------------------*/
+            /* Send databag via shared memory ring. If the ring cannot */
+            /* be used the request is rewritten as bag (sent below)    */
+            /*---------------------------------------------------------*/
+
+            if(strncmp(request,"sendbag ",8) == 0 && builtin_psrp_sendbag(request) == 0)
+               goto next_request;
+
+
             /*-------------------------------------------------------------------*/
             /* If we are about to overlay we must stop monitoring current server */
             /*-------------------------------------------------------------------*/
@@ -4065,6 +4126,23 @@ busy_retry:
             try_cnt = 0;
 
 
+            /*------------------------------------------------------------*/
+            /* Socket transport - request and reply are single (framed)   */
+            /* messages, so we do not need the FIFO signal handshake. The */
+            /* FIFOs are still used for connection management and abort  */
+            /*------------------------------------------------------------*/
+
+            sock_transaction = FALSE;
+            if(server_sock != (-1) && request[0] != '\0' && strcmp(request,"terminate") != 0)
+            {  if(psrp_sock_transaction(request) == 0)
+               {  sock_transaction   = TRUE;
+                  processing_command = TRUE;
+
+                  goto sock_reply;
+               }
+            }
+
+
             /*------------------------------------------------------------------*/
             /* Grab the PSRP channel so we have the servers (metaphorical) ear! */
             /*------------------------------------------------------------------*/
@@ -4221,6 +4299,8 @@ busy_retry:
                (void)fflush(client_out);
 
 
+sock_reply:
+
                /*------------------------------------*/
                /* Activate (datasink if appropriate) */
                /*------------------------------------*/
@@ -4254,7 +4334,7 @@ busy_retry:
                      {  sigset_t set;
 
                         (void)strlcpy(reply,"",SSIZE); 
-                        (void)fgets(reply,SSIZE,client_in);
+                        psrp_get_reply(reply);
 
 
                         /*----------------------------*/
@@ -4418,15 +4498,17 @@ busy_retry:
                  /* Wait for server to tell us that SIGPSRP has been handled */
                  /*----------------------------------------------------------*/
 
-                 psrp_waitfor_endop("EOP psrp");
+                 if(sock_transaction == FALSE)
+                 {  psrp_waitfor_endop("EOP psrp");
 
 
-                 /*---------------*/
-                 /* Clear channel */
-                 /*---------------*/
+                    /*---------------*/
+                    /* Clear channel */
+                    /*---------------*/
 
-                 (void)psrp_empty_fifo(fileno(client_in));
-                 (void)psrp_empty_fifo(fileno(client_out));
+                    (void)psrp_empty_fifo(fileno(client_in));
+                    (void)psrp_empty_fifo(fileno(client_out));
+                 }
 
                  processing_command = FALSE;
 
@@ -4436,7 +4518,8 @@ busy_retry:
                  /* to submit requests            */
                  /*-------------------------------*/
 
-                 psrp_yield_channel();
+                 if(sock_transaction == FALSE)
+                    psrp_yield_channel();
 
 
                  /*-------------------------------------------------------*/
@@ -4466,7 +4549,8 @@ busy_retry:
                  /* Unlock channel */
                  /*----------------*/
 
-                 (void)lockf(fileno(client_in),F_ULOCK,0);
+                 if(sock_transaction == FALSE)
+                    (void)lockf(fileno(client_in),F_ULOCK,0);
              }
 
 
@@ -5278,7 +5362,11 @@ _PRIVATE _BOOLEAN psrp_open_server(void)
     /* channel. Send password to authenticate remote access.  */
     /*--------------------------------------------------------*/
 
-    (void)fprintf(client_out,"OPEN %d %s\n",appl_pid,appl_password);
+    if(use_socket_transport == TRUE)
+       (void)fprintf(client_out,"OPEN %d %s SEQPACKET\n",appl_pid,appl_password);
+    else
+       (void)fprintf(client_out,"OPEN %d %s\n",appl_pid,appl_password);
+
     (void)fflush(client_out);
     (void)fgets(tmp_str,SSIZE,client_in);
 
@@ -5287,7 +5375,17 @@ _PRIVATE _BOOLEAN psrp_open_server(void)
     (void)fflush(stderr);
     #endif /* PSRP_DEBUG */
 
-    (void)sscanf(tmp_str,"%d",&server_seg_cnt);
+
+    /*---------------------------------------------------------*/
+    /* Server which supports socket transport appends the name */
+    /* of its socket                                           */
+    /*---------------------------------------------------------*/
+
+    {  char transport[SSIZE] = "";
+
+       if(sscanf(tmp_str,"%d %s %s",&server_seg_cnt,transport,server_sock_name) != 3 || strcmp(transport,"SEQPACKET") != 0)
+          (void)strlcpy(server_sock_name,"",SSIZE);
+    }
 
 
     /*---------------------------------------------------------*/
@@ -5318,6 +5416,15 @@ _PRIVATE _BOOLEAN psrp_open_server(void)
     (void)pups_release_fd_lock(fileno(client_out)); 
     have_access_lock = FALSE;
 
+
+    /*-----------------------------------------------------------*/
+    /* Requests go via socket transport if server supports it -- */
+    /* otherwise (or if we cannot connect) we use the PSRP FIFOs */
+    /*-----------------------------------------------------------*/
+
+    if(server_sock_name[0] != '\0')
+       (void)psrp_open_server_sock();
+
     (void)strlcpy(psrp_c_code,"ok",SSIZE);
     return(TRUE);
 }
@@ -5333,6 +5440,9 @@ _PRIVATE int32_t psrp_close_server(const _BOOLEAN force_hard_link, const _BOOLEA
 
 {
 
+    psrp_close_server_sock();
+    (void)strlcpy(server_sock_name,"",SSIZE);
+
     /*-------------------------*/
     /* Get channel access lock */
     /*-------------------------*/
@@ -5431,6 +5541,482 @@ _PRIVATE int32_t psrp_close_server(const _BOOLEAN force_hard_link, const _BOOLEA
 
 
 
+/*-------------------------------------------------------------*/
+/* Open socket transport to PSRP server (we must already have  */
+/* connected to it via its FIFOs)                              */
+/*-------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_open_server_sock(void)
+
+{   int32_t seg_cnt;
+
+    psrp_close_server_sock();
+
+    if(server_sock_name[0] == '\0')
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    if((server_sock = psrp_sock_connect(server_sock_name,appl_password,&seg_cnt)) == (-1))
+    {  if(psrp_log == TRUE && pel_appl_verbose == TRUE)
+       {  (void)fprintf(stdout,"\nServer process %s (%d@%s) socket transport unavailable (%s) -- using FIFO transport\n\n",
+                                                                         psrp_server,server_pid,psrp_host,strerror(errno));
+          (void)fflush(stdout);
+       }
+
+       return(-1);
+    }
+
+    if(psrp_log == TRUE && pel_appl_verbose == TRUE)
+    {  (void)fprintf(stdout,"\nServer process %s (%d@%s) datagram connection via (SOCK_SEQPACKET) socket %s\n\n",
+                                                                    psrp_server,server_pid,psrp_host,server_sock_name);
+       (void)fflush(stdout);
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*------------------------------------------*/
+/* Close socket transport to PSRP server    */
+/*------------------------------------------*/
+
+_PRIVATE void psrp_close_server_sock(void)
+
+{   if(server_sock != (-1))
+    {  (void)psrp_sock_close(server_sock);
+       server_sock = (-1);
+    }
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Send request to PSRP server via socket transport. If the request */
+/* cannot be sent (even after reconnecting) return -1 so the caller */
+/* falls back to the FIFO transport. Once the request has been sent */
+/* it is never resent -- a lost reply is reported as a broken       */
+/* channel                                                          */
+/*-----------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_sock_transaction(const char *request)
+
+{   uint32_t seq;
+    ssize_t  size;
+    char     request_line[SSIZE + 1] = "";
+
+    (void)snprintf(request_line,SSIZE + 1,"%s\n",request);
+
+    ++sock_seq;
+    if(psrp_sock_send(server_sock,sock_seq,request_line,pups_strlen(request_line)) == (-1))
+    {  if(psrp_open_server_sock() == (-1) || psrp_sock_send(server_sock,sock_seq,request_line,pups_strlen(request_line)) == (-1))
+       {  psrp_close_server_sock();
+          return(-1);
+       }
+    }
+
+    do {    size = psrp_sock_recv(server_sock,&seq,&sock_reply,&sock_reply_size);
+       } while(size > 0 && seq != sock_seq);
+
+    if(size <= 0)
+    {  if(pel_appl_verbose == TRUE)
+       {  (void)fprintf(stdout,"\n%sWARNING%s lost reply from %s (%d@%s) on socket transport -- using FIFO transport\n\n",
+                                                                           boldOn,boldOff,psrp_server,server_pid,psrp_host);
+          (void)fflush(stdout);
+       }
+
+       psrp_close_server_sock();
+       (void)strlcpy(server_sock_name,"",SSIZE);
+
+       sock_reply_size = SSIZE;
+       sock_reply      = (char *)pups_realloc((void *)sock_reply,sock_reply_size);
+       (void)strlcpy(sock_reply,"EOT cbrokerr\n",SSIZE);
+       sock_reply_pos  = 0;
+
+       return(0);
+    }
+
+
+    /*-------------------------------------------------------------------*/
+    /* Skip server channel identifier (this is the first line of reply) */
+    /*-------------------------------------------------------------------*/
+
+    sock_reply_pos = 0;
+    if(sock_reply[0] == '(')
+    {  while(sock_reply_pos < (size_t)size && sock_reply[sock_reply_pos] != '\n')
+             ++sock_reply_pos;
+
+       if(sock_reply_pos < (size_t)size)
+          ++sock_reply_pos;
+    }
+
+    return(0);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Get next line of reply from PSRP server (from reply buffer if */
+/* request was sent via socket transport)                        */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void psrp_get_reply(char *reply)
+
+{   size_t i = 0;
+
+    if(sock_transaction == FALSE)
+    {  (void)fgets(reply,SSIZE,client_in);
+       return;
+    }
+
+
+    /*--------------------------------------------------------*/
+    /* Reply without EOT (should not happen) - end it for the */
+    /* caller                                                 */
+    /*--------------------------------------------------------*/
+
+    if(sock_reply == (char *)NULL || sock_reply[sock_reply_pos] == '\0')
+    {  (void)strlcpy(reply,"EOT cbrokerr\n",SSIZE);
+       return;
+    }
+
+    while(i < SSIZE - 1 && sock_reply[sock_reply_pos] != '\0')
+    {  reply[i++] = sock_reply[sock_reply_pos++];
+
+       if(reply[i - 1] == '\n')
+          break;
+    }
+
+    reply[i] = '\0';
+}
+
+
+
+
+/*----------------------------------------------------------------*/
+/* Display socket transport reply. The reply may be the combined  */
+/* reply to a batch, so may contain several "(channel)" and "EOP" */
+/* markers. Sets psrp_c_code to first non ok completion code      */
+/*----------------------------------------------------------------*/
+
+_PRIVATE void psrp_show_sock_reply(const char *reply)
+
+{   size_t     len;
+    char       c_code[SSIZE] = "";
+    const char *line         = reply;
+
+    while(line != (const char *)NULL && *line != '\0')
+    {  len = strcspn(line,"\n");
+
+       if(strncmp(line,"EOT ",4) == 0)
+       {  (void)sscanf(line,"EOT %s",c_code);
+
+          if(strcmp(c_code,"ok") != 0)
+          {  (void)fprintf(stdout,"    [completion code \"%s\"]\n",c_code);
+
+             if(strcmp(psrp_c_code,"ok") == 0)
+                (void)strlcpy(psrp_c_code,c_code,SSIZE);
+          }
+       }
+       else if(line[0] != '(' && strncmp(line,"EOP ",4) != 0)
+          (void)fprintf(stdout,"%.*s\n",(int)len,line);
+
+       line += len;
+       if(*line == '\n')
+          ++line;
+    }
+
+    (void)fflush(stdout);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Builtin command to submit a file of requests via socket          */
+/* transport. "pipeline <file> [<window>]" streams (tagged)         */
+/* requests, keeping up to <window> outstanding. "batch <file>"     */
+/* sends the whole file as one message and gets one combined reply. */
+/* Either way replies are displayed in request order                */
+/*------------------------------------------------------------------*/
+
+_PRIVATE void builtin_psrp_submit(const char *request)
+
+{   uint32_t i,
+             n_requests          = 0,
+             window              = PSRP_PIPELINE_WINDOW;
+
+    int32_t  ret;
+
+    size_t   size                = 0,
+             *reply_size         = (size_t *)NULL;
+
+    char     command[SSIZE]      = "",
+             f_name[SSIZE]       = "",
+             line[SSIZE]         = "",
+             *reply              = (char *)NULL,
+             **requests          = (char **)NULL,
+             **replies           = (char **)NULL;
+
+    FILE     *stream             = (FILE *)NULL;
+
+    if(sscanf(request,"%s %s %u",command,f_name,&window) < 2 || window == 0)
+    {  (void)fprintf(stdout,"\nusage: pipeline <request file> [<window>] | batch <request file>\n\n");
+       (void)fflush(stdout);
+
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return;
+    }
+
+    if(server_sock == (-1))
+    {  (void)fprintf(stdout,"\n%sERROR%s %s requires socket transport to PSRP server\n\n",boldOn,boldOff,command);
+       (void)fflush(stdout);
+
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return;
+    }
+
+    if((stream = fopen(f_name,"r")) == (FILE *)NULL)
+    {  (void)fprintf(stdout,"\n%sERROR%s cannot open request file \"%s\"\n\n",boldOn,boldOff,f_name);
+       (void)fflush(stdout);
+
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return;
+    }
+
+
+    /*-------------------------------------------------------*/
+    /* Read requests (ignoring blank lines and comments)     */
+    /*-------------------------------------------------------*/
+
+    while(fgets(line,SSIZE,stream) != (char *)NULL)
+    {  line[strcspn(line,"\n")] = '\0';
+
+       if(line[strspn(line," \t")] == '\0' || line[strspn(line," \t")] == '#')
+          continue;
+
+       requests               = (char **)pups_realloc((void *)requests,(n_requests + 1)*sizeof(char *));
+       requests[n_requests++] = strdup(line);
+    }
+
+    (void)fclose(stream);
+
+    if(n_requests == 0)
+    {  (void)strlcpy(psrp_c_code,"ok",SSIZE);
+       return;
+    }
+
+    (void)strlcpy(psrp_c_code,"ok",SSIZE);
+
+
+    /*-------------------------------------------------------------*/
+    /* Batch - the server runs requests in order and the replies   */
+    /* come back as a single message                               */
+    /*-------------------------------------------------------------*/
+
+    if(strcmp(command,"batch") == 0)
+    {  ++sock_seq;
+
+       if(psrp_sock_batch(server_sock,sock_seq,n_requests,(const char **)requests,&reply,&size) <= 0)
+          (void)strlcpy(psrp_c_code,"cbrokerr",SSIZE);
+       else
+          psrp_show_sock_reply(reply);
+
+       (void)free((void *)reply);
+    }
+
+
+    /*-------------------------------------------------------------*/
+    /* Pipeline - the server may reply out of order, replies are   */
+    /* matched to requests by sequence number                      */
+    /*-------------------------------------------------------------*/
+
+    else
+    {  replies    = (char **) pups_calloc(n_requests,sizeof(char *));
+       reply_size = (size_t *)pups_calloc(n_requests,sizeof(size_t));
+
+       ret        = psrp_sock_pipeline(server_sock,sock_seq + 1,n_requests,(const char **)requests,window,replies,reply_size);
+       sock_seq  += n_requests;
+
+       for(i=0; i<n_requests; ++i)
+       {  if(replies[i] != (char *)NULL)
+             psrp_show_sock_reply(replies[i]);
+
+          (void)free((void *)replies[i]);
+       }
+
+       if(ret == (-1))
+          (void)strlcpy(psrp_c_code,"cbrokerr",SSIZE);
+
+       (void)pups_free((void *)replies);
+       (void)pups_free((void *)reply_size);
+    }
+
+    if(strcmp(psrp_c_code,"cbrokerr") == 0 && pel_appl_verbose == TRUE)
+    {  (void)fprintf(stdout,"\n%sWARNING%s lost replies from %s (%d@%s) on socket transport\n\n",
+                                                 boldOn,boldOff,psrp_server,server_pid,psrp_host);
+       (void)fflush(stdout);
+    }
+
+    for(i=0; i<n_requests; ++i)
+       (void)free((void *)requests[i]);
+
+    (void)pups_free((void *)requests);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Builtin command to send a databag to the PSRP server via shared  */
+/* memory ring ("sendbag <tag> <file>"). The file is read directly  */
+/* into the ring and the server copies it directly into the bag.    */
+/* If the ring cannot be used (no memfd, no socket transport or the */
+/* server cannot attach the ring) request is rewritten as           */
+/* "bag <tag> <file>" and -1 returned, so caller sends it via the   */
+/* usual PSRP channel                                               */
+/*------------------------------------------------------------------*/
+
+_PRIVATE int32_t builtin_psrp_sendbag(char *request)
+
+{   uint32_t       seq;
+
+    des_t          f_des;
+
+    ssize_t        space,
+                   size                = 0,
+                   bytes_read          = 0;
+
+    size_t         reply_size          = 0;
+
+    char           tag[SSIZE]          = "",
+                   f_name[SSIZE]       = "",
+                   path[PATH_MAX]      = "",
+                   rbag_request[SSIZE] = "",
+                   *reply              = (char *)NULL;
+
+    _BOOLEAN       abandoned           = FALSE;
+
+    _BYTE          *ptr                = (_BYTE *)NULL;
+
+    struct stat    buf;
+    struct pollfd  pfd;
+
+    psrp_ring_type *ring               = (psrp_ring_type *)NULL;
+
+    if(sscanf(request,"%*s %s %s",tag,f_name) != 2)
+    {  (void)fprintf(stdout,"\nusage: sendbag <PSRP dispatch name> <databag file name>\n\n");
+       (void)fflush(stdout);
+
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return(0);
+    }
+
+    if(realpath(f_name,path) == (char *)NULL || (f_des = open(path,O_RDONLY)) == (-1))
+    {  (void)fprintf(stdout,"\n%sERROR%s cannot open databag file \"%s\"\n\n",boldOn,boldOff,f_name);
+       (void)fflush(stdout);
+
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return(0);
+    }
+
+    (void)fstat(f_des,&buf);
+    (void)snprintf(request,SSIZE,"bag %s %s",tag,path);
+
+    if(buf.st_size > PSRP_RING_MAX_TOTAL)
+    {  (void)fprintf(stdout,"\n%sERROR%s databag file \"%s\" is too large to send via ring (maximum %ld bytes)\n\n",boldOn,boldOff,f_name,PSRP_RING_MAX_TOTAL);
+       (void)fflush(stdout);
+
+       (void)close(f_des);
+       (void)strlcpy(psrp_c_code,"psynerr",SSIZE);
+       return(0);
+    }
+
+    if(server_sock == (-1) || (ring = psrp_ring_create((size_t)buf.st_size,(uint64_t)buf.st_size)) == (psrp_ring_type *)NULL)
+    {  (void)close(f_des);
+       return(-1);
+    }
+
+    (void)snprintf(rbag_request,SSIZE,"rbag %s %d %d\n",tag,appl_pid,ring->des);
+
+    ++sock_seq;
+    if(psrp_sock_send(server_sock,sock_seq,rbag_request,pups_strlen(rbag_request)) == (-1))
+    {  (void)close(f_des);
+       (void)psrp_ring_destroy(ring);
+
+       return(-1);
+    }
+
+
+    /*-----------------------------------------------------------*/
+    /* Read file into ring. While ring is full check that server */
+    /* has not replied (which means it has abandoned transfer)   */
+    /*-----------------------------------------------------------*/
+
+    pfd.fd     = server_sock;
+    pfd.events = POLLIN;
+
+    while(TRUE)
+    {  if((space = psrp_ring_reserve(ring,&ptr,PSRP_RING_POLL)) == (-1))
+       {  if(errno == ETIMEDOUT && poll(&pfd,1,0) == 0)
+             continue;
+
+          abandoned = TRUE;
+          break;
+       }
+
+       if((bytes_read = read(f_des,ptr,space)) > 0)
+       {  psrp_ring_commit(ring,bytes_read);
+          size += bytes_read;
+       }
+       else if(bytes_read == 0 || errno != EINTR)
+          break;
+    }
+
+    (void)close(f_des);
+    psrp_ring_close(ring,abandoned || bytes_read == (-1));
+
+    do {    if(psrp_sock_recv(server_sock,&seq,&reply,&reply_size) <= 0)
+            {  (void)free((void *)reply);
+               (void)psrp_ring_destroy(ring);
+
+               psrp_close_server_sock();
+               return(-1);
+            }
+       } while(seq != sock_seq);
+
+    (void)psrp_ring_destroy(ring);
+
+
+    /*-------------------------------------------*/
+    /* Server could not attach ring -- fall back */
+    /*-------------------------------------------*/
+
+    if(strin(reply,"EOT ringerr") == TRUE)
+    {  (void)free((void *)reply);
+       return(-1);
+    }
+
+    (void)strlcpy(psrp_c_code,"ok",SSIZE);
+    psrp_show_sock_reply(reply);
+    (void)free((void *)reply);
+
+    if(pel_appl_verbose == TRUE && strcmp(psrp_c_code,"ok") == 0)
+    {  (void)fprintf(stdout,"    [%ld bytes sent via shared memory ring]\n\n",size);
+       (void)fflush(stdout);
+    }
+
+    return(0);
+}
+
+
+
+
 /*-------------------------------------------------------------------*/
 /* Builtin command to open a connection to a new PSRP server process */
 /* (and close the connection to the current server if any)           */
@@ -5836,6 +6422,9 @@ _PRIVATE void builtin_psrp_help(void)
      (void)fprintf(pstream,"    killall    <directory> <spec>: Kill all PSRP servers in <directory> matching <spec>\n");
      (void)fprintf(pstream,"    segaction  <action>          : specify/display request processing action on server segmenation\n");
      (void)fprintf(pstream,"    segcnt                       : display number of segments (for segmented server)\n");
+     (void)fprintf(pstream,"    pipeline   <file> [<window>] : pipeline requests in <file> (socket transport, <window> outstanding)\n");
+     (void)fprintf(pstream,"    batch      <file>            : send requests in <file> as single batch (socket transport)\n");
+     (void)fprintf(pstream,"    sendbag    <tag> <file>      : send <file> to server as dynamic databag <tag> (via shared memory ring)\n");
      (void)fprintf(pstream,"    quit | exit | bye            : terminate psrp client\n");
 
      (void)fprintf(pstream,"\n\n    %sBuiltin PSRP security commands%s\n", boldOn,boldOff);   
@@ -6118,6 +6707,16 @@ _PRIVATE int32_t psrp_int_handler(const int32_t signum)
      (void)fflush(client_out);
      (void)psrp_waitfor_endop("EOP abrt");
 
+
+     /*--------------------------------------------------*/
+     /* Server discards socket session of aborted client */
+     /*--------------------------------------------------*/
+
+     if(server_sock != (-1))
+     {  psrp_close_server_sock();
+        (void)psrp_open_server_sock();
+     }
+
      if(flycom == FALSE)
         (void)psrp_yield_channel();
 
@@ -0,0 +1,514 @@
+/*------------------------------------------------------------------
+    Purpose: Benchmark PSRP FIFO (signal handshake) transport against
+             PSRP socket (SOCK_SEQPACKET) transport
+
+     Author:  M.A. O'Neill
+              Tumbling Dice Ltd
+              Gosforth
+              Newcastle upon Tyne
+              NE3 4RT
+              United Kingdom
+
+    Version: 1.00
+    Dated:   19th October 2026
+    E-mail:  mao@tumblingdice.co.uk
+------------------------------------------------------------------*/
+
+#include <me.h>
+#include <utils.h>
+#include <psrp.h>
+#include <string.h>
+#include <bsd/string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/*----------------------------------------------------------------*/
+/* Get signal mapping appropriate to OS and hardware architecture */
+/*----------------------------------------------------------------*/
+
+#define __DEFINE__
+#if defined(I386) || defined(X86_64)
+#include <sig.linux.x86.h>
+#endif /* I386 || X86_64 */
+
+#ifdef ARMV6L
+#include <sig.linux.arm.h>
+#endif /* ARMV6L */
+
+#ifdef ARMV7L
+#include <sig.linux.arm.h>
+#endif /* ARMV7L */
+
+#ifdef AARCH64
+#include <sig.linux.arm.h>
+#endif /* AARCH64 */
+#undef __DEFINE__
+
+
+/*-----------------------------*/
+/* Version of this application */
+/*-----------------------------*/
+
+#define PSRPBENCH_VERSION    "1.00"
+
+
+/*--------------------------------------------------*/
+/* Length of reply lines (FIFO clients read replies */
+/* a line at a time)                                */
+/*--------------------------------------------------*/
+
+#define REPLY_LINE_SIZE      80
+
+
+
+
+/*----------------------------------------------*/
+/* Get application information for slot manager */
+/*----------------------------------------------*/
+/*---------------------------*/
+/* Slot information function */
+/*---------------------------*/
+
+_PRIVATE void psrpbench_slot(int32_t level)
+{   (void)fprintf(stderr,"int app psrpbench %s: [ANSI C]\n",PSRPBENCH_VERSION);
+
+    if(level > 1)
+    {  (void)fprintf(stderr,"(C) 2026 Tumbling Dice\n");
+       (void)fprintf(stderr,"Author: M.A. ONeill\n");
+       (void)fprintf(stderr,"PSRP transport benchmark (gcc %s: built %s %s)\n\n",__VERSION__,__TIME__,__DATE__);
+    }
+    else
+       (void)fprintf(stderr,"\n");
+
+    (void)fflush(stderr);
+}
+
+
+
+
+/*----------------------------*/
+/* Application usage function */
+/*----------------------------*/
+
+_PRIVATE void psrpbench_usage(void)
+
+{   (void)fprintf(stderr,"[-requests <number of small requests:2000>]\n");
+    (void)fprintf(stderr,"[-size <small reply size (bytes):64>]\n");
+    (void)fprintf(stderr,"[-transfers <number of bulk requests:50>]\n");
+    (void)fprintf(stderr,"[-bulk <bulk reply size (bytes):1048576>]\n\n");
+    (void)fprintf(stderr,"[>& <ASCII log file>]\n\n");
+    (void)fflush(stderr);
+}
+
+
+#ifdef SLOT
+#include <slotman.h>
+_EXTERN void (* SLOT)() __attribute__ ((aligned(16))) = psrpbench_slot;
+_EXTERN void (* USE )() __attribute__ ((aligned(16))) = psrpbench_usage;
+#endif /* SLOT */
+
+
+
+
+/*------------------------*/
+/* Application build date */
+/*------------------------*/
+
+_EXTERN char appl_build_time[SSIZE] = __TIME__;
+_EXTERN char appl_build_date[SSIZE] = __DATE__;
+
+
+
+
+/*--------------------------------------------------------------------------*/
+/* Software I.D. tag (used if CKPT support enabled to discard stale dynamic */
+/* checkpoint files)                                                        */
+/*--------------------------------------------------------------------------*/
+
+#define VTAG  1
+
+extern int32_t appl_vtag = VTAG;
+
+
+
+
+/*--------------------------------------------------*/
+/* Variables which are private to this application */
+/*--------------------------------------------------*/
+
+_PRIVATE char fifo_in_name[SSIZE]  = "";
+_PRIVATE char fifo_out_name[SSIZE] = "";
+_PRIVATE char sock_name[SSIZE]     = "";
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Build reply - size bytes of REPLY_LINE_SIZE byte lines    */
+/* followed by the EOT and EOP trailers sent by psrp_handler */
+/*-----------------------------------------------------------*/
+
+_PRIVATE char *build_reply(const size_t size, size_t *reply_size)
+
+{   size_t i;
+    char   *reply = (char *)NULL;
+
+    *reply_size = size + 32;
+    reply       = (char *)pups_malloc(*reply_size + 1);
+
+    for(i=0; i<size; ++i)
+    {  if(i % REPLY_LINE_SIZE == REPLY_LINE_SIZE - 1 || i == size - 1)
+          reply[i] = '\n';
+       else
+          reply[i] = 'a' + i % 26;
+    }
+
+    (void)snprintf(&reply[size],33,"EOT ok\nEOP psrp\n");
+    *reply_size = size + pups_strlen(&reply[size]);
+
+    return(reply);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* FIFO responder. This emulates the server side of the PSRP   */
+/* FIFO protocol: SIGCHAN (EOP chan), SIGPSRP (channel name),  */
+/* request line, reply, EOT and EOP                            */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void fifo_responder(const char *small, const size_t small_size, const char *bulk, const size_t bulk_size)
+
+{   int32_t  signum;
+    sigset_t set;
+    char     request[SSIZE] = "";
+    FILE     *in            = (FILE *)NULL,
+             *out           = (FILE *)NULL;
+
+    in  = fopen(fifo_in_name, "r+");
+    out = fopen(fifo_out_name,"r+");
+
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGCHAN);
+    (void)sigaddset(&set,SIGPSRP);
+    (void)sigaddset(&set,SIGTERM);
+
+    while(1)
+    {  if(sigwait(&set,&signum) != 0 || signum == SIGTERM)
+          _exit(0);
+
+       if(signum == SIGCHAN)
+       {  (void)fprintf(out,"EOP chan\n");
+          (void)fflush(out);
+          continue;
+       }
+
+       (void)fprintf(out,"(%s)\n",fifo_in_name);
+       (void)fflush(out);
+
+       (void)fgets(request,SSIZE,in);
+
+       if(strncmp(request,"bulk",4) == 0)
+          (void)fwrite(bulk,1,bulk_size,out);
+       else
+          (void)fwrite(small,1,small_size,out);
+
+       (void)fflush(out);
+    }
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Socket responder. Emulates server side of socket transport */
+/*------------------------------------------------------------*/
+
+_PRIVATE void sock_responder(const des_t listen_des, const char *small, const size_t small_size, const char *bulk, const size_t bulk_size)
+
+{   des_t    des;
+    uint32_t seq;
+    size_t   buf_size     = 0,
+             chan_size;
+    char     *buf         = (char *)NULL,
+             *small_reply = (char *)NULL,
+             *bulk_reply  = (char *)NULL;
+
+    if((des = accept(listen_des,(struct sockaddr *)NULL,(socklen_t *)NULL)) == (-1))
+       _exit(255);
+
+
+    /*-------------------------------------------------*/
+    /* Socket replies carry channel identifier in-band */
+    /*-------------------------------------------------*/
+
+    chan_size   = pups_strlen(fifo_in_name) + 3;
+    small_reply = (char *)pups_malloc(chan_size + small_size + 1);
+    bulk_reply  = (char *)pups_malloc(chan_size + bulk_size  + 1);
+
+    (void)snprintf(small_reply,chan_size + 1,"(%s)\n",fifo_in_name);
+    (void)snprintf(bulk_reply, chan_size + 1,"(%s)\n",fifo_in_name);
+    (void)memcpy((void *)&small_reply[chan_size],(void *)small,small_size);
+    (void)memcpy((void *)&bulk_reply[chan_size], (void *)bulk, bulk_size);
+
+    while(psrp_sock_recv(des,&seq,&buf,&buf_size) > 0)
+    {  if(strncmp(buf,"OPEN",4) == 0)
+          (void)psrp_sock_send(des,seq,"0\n",2);
+       else if(strncmp(buf,"bulk",4) == 0)
+          (void)psrp_sock_send(des,seq,bulk_reply,chan_size + bulk_size);
+       else
+          (void)psrp_sock_send(des,seq,small_reply,chan_size + small_size);
+    }
+
+    _exit(0);
+}
+
+
+
+
+/*----------------------------------------------------*/
+/* Client side of FIFO transaction (as psrp does it). */
+/* Returns number of reply bytes read                 */
+/*----------------------------------------------------*/
+
+_PRIVATE size_t fifo_transaction(const pid_t responder, FILE *in, FILE *out, const char *request)
+
+{   size_t bytes             = 0;
+    char   line[SSIZE]       = "";
+
+    (void)kill(responder,SIGCHAN);
+    do {    (void)fgets(line,SSIZE,in);
+       } while(strncmp(line,"EOP chan",8) != 0);
+
+    (void)kill(responder,SIGPSRP);
+    (void)fgets(line,SSIZE,in);
+
+    (void)fprintf(out,"%s\n",request);
+    (void)fflush(out);
+
+    do {    (void)fgets(line,SSIZE,in);
+            bytes += pups_strlen(line);
+       } while(strncmp(line,"EOT",3) != 0);
+
+    do {    (void)fgets(line,SSIZE,in);
+       } while(strncmp(line,"EOP psrp",8) != 0);
+
+    return(bytes);
+}
+
+
+
+
+/*------------------*/
+/* Main entry point */
+/*------------------*/
+
+_PUBLIC  int32_t pups_main(int argc, char *argv[])
+
+{   int32_t  i,
+             seg_cnt,
+             n_requests   = 2000,
+             n_transfers  = 50;
+
+    size_t   small_size   = 64,
+             bulk_size    = 1048576,
+             small_reply_size,
+             bulk_reply_size,
+             buf_size     = 0;
+
+    double   start,
+             bytes,
+             t_fifo_lat,
+             t_sock_lat,
+             t_fifo_bulk,
+             t_sock_bulk;
+
+    char     *small       = (char *)NULL,
+             *bulk        = (char *)NULL,
+             *buf         = (char *)NULL;
+
+    des_t    listen_des,
+             des;
+
+    pid_t    responder;
+    sigset_t set;
+    FILE     *in          = (FILE *)NULL,
+             *out         = (FILE *)NULL;
+
+    struct sockaddr_un addr;
+
+
+    /*------------------------------------------*/
+    /* Get standard items form the command tail */
+    /*------------------------------------------*/
+
+    pups_std_init(TRUE,
+                  &argc,
+                  PSRPBENCH_VERSION,
+                  "M.A. O'Neill",
+                  "psrpbench",
+                  "2026",
+                  argv);
+
+    if((ptr = pups_locate(&init,"requests",&argc,args,0)) != NOT_FOUND)
+    {  if((n_requests = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || n_requests < 1)
+          pups_error("[psrpbench] expecting number of requests");
+    }
+
+    if((ptr = pups_locate(&init,"size",&argc,args,0)) != NOT_FOUND)
+    {  if((i = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || i < 1)
+          pups_error("[psrpbench] expecting small reply size");
+       small_size = (size_t)i;
+    }
+
+    if((ptr = pups_locate(&init,"transfers",&argc,args,0)) != NOT_FOUND)
+    {  if((n_transfers = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || n_transfers < 1)
+          pups_error("[psrpbench] expecting number of bulk transfers");
+    }
+
+    if((ptr = pups_locate(&init,"bulk",&argc,args,0)) != NOT_FOUND)
+    {  if((i = pups_i_dec(&ptr,&argc,args)) == (int32_t)INVALID_ARG || i < 1)
+          pups_error("[psrpbench] expecting bulk reply size");
+       bulk_size = (size_t)i;
+    }
+
+
+    /*---------------------------------------*/
+    /* Complain about any unparsed arguments */
+    /*---------------------------------------*/
+
+    pups_t_arg_errs(argd,args);
+
+    small = build_reply(small_size,&small_reply_size);
+    bulk  = build_reply(bulk_size, &bulk_reply_size);
+
+
+    /*-------------------------------------------------------------*/
+    /* Responders wait for PSRP signals synchronously (so they are */
+    /* blocked here, and the mask is inherited)                    */
+    /*-------------------------------------------------------------*/
+
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGCHAN);
+    (void)sigaddset(&set,SIGPSRP);
+    (void)sigaddset(&set,SIGTERM);
+    (void)sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
+
+    (void)snprintf(fifo_in_name, SSIZE,"%s/psrpbench#fifo#in#%d", appl_fifo_dir,appl_pid);
+    (void)snprintf(fifo_out_name,SSIZE,"%s/psrpbench#fifo#out#%d",appl_fifo_dir,appl_pid);
+    (void)snprintf(sock_name,    SSIZE,"%s/psrpbench#sock#%d",    appl_fifo_dir,appl_pid);
+
+    if(mkfifo(fifo_in_name,0600) == (-1) || mkfifo(fifo_out_name,0600) == (-1))
+       pups_error("[psrpbench] failed to create FIFOs");
+
+    (void)fprintf(stderr,"\n    psrpbench %s: %d requests (%ld byte replies), %d transfers (%ld byte replies)\n\n",
+                                    PSRPBENCH_VERSION,n_requests,small_size,n_transfers,bulk_size);
+    (void)fflush(stderr);
+
+
+    /*----------------*/
+    /* FIFO transport */
+    /*----------------*/
+
+    if((responder = fork()) == 0)
+       fifo_responder(small,small_reply_size,bulk,bulk_reply_size);
+
+    in  = fopen(fifo_out_name,"r+");
+    out = fopen(fifo_in_name, "r+");
+
+    start = millitime();
+    for(i=0; i<n_requests; ++i)
+       (void)fifo_transaction(responder,in,out,"status");
+    t_fifo_lat = millitime() - start;
+
+    bytes = 0.0;
+    start = millitime();
+    for(i=0; i<n_transfers; ++i)
+       bytes += (double)fifo_transaction(responder,in,out,"bulk");
+    t_fifo_bulk = millitime() - start;
+
+    if(bytes < (double)n_transfers*bulk_size)
+       pups_error("[psrpbench] short FIFO transfer");
+
+    (void)kill(responder,SIGTERM);
+    (void)waitpid(responder,(int *)NULL,0);
+
+    (void)fclose(in);
+    (void)fclose(out);
+    (void)unlink(fifo_in_name);
+    (void)unlink(fifo_out_name);
+
+
+    /*-----------------------------------*/
+    /* Socket (SOCK_SEQPACKET) transport */
+    /*-----------------------------------*/
+
+    (void)memset((void *)&addr,0,sizeof(struct sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    (void)strlcpy(addr.sun_path,sock_name,sizeof(addr.sun_path));
+
+    if((listen_des = socket(AF_UNIX,SOCK_SEQPACKET,0))                                    == (-1) ||
+       bind(listen_des,(struct sockaddr *)&addr,sizeof(struct sockaddr_un))               == (-1) ||
+       listen(listen_des,1)                                                              == (-1)  )
+       pups_error("[psrpbench] failed to create socket");
+
+    if((responder = fork()) == 0)
+       sock_responder(listen_des,small,small_reply_size,bulk,bulk_reply_size);
+
+    if((des = psrp_sock_connect(sock_name,"notset",&seg_cnt)) == (-1))
+       pups_error("[psrpbench] failed to connect to socket");
+
+    start = millitime();
+    for(i=0; i<n_requests; ++i)
+    {  if(psrp_sock_request(des,i + 1,"status\n",&buf,&buf_size) <= 0)
+          pups_error("[psrpbench] socket request failed");
+    }
+    t_sock_lat = millitime() - start;
+
+    start = millitime();
+    for(i=0; i<n_transfers; ++i)
+    {  if(psrp_sock_request(des,n_requests + i + 1,"bulk\n",&buf,&buf_size) < (ssize_t)bulk_size)
+          pups_error("[psrpbench] short socket transfer");
+    }
+    t_sock_bulk = millitime() - start;
+
+    (void)psrp_sock_close(des);
+    (void)waitpid(responder,(int *)NULL,0);
+
+    (void)close(listen_des);
+    (void)unlink(sock_name);
+
+
+    /*----------------*/
+    /* Report results */
+    /*----------------*/
+
+    (void)fprintf(stderr,"    FIFO:   latency %10.2f usecs/request (%10.1f requests/sec), throughput %10.2f MB/sec\n",
+                                                                       1.0e6*t_fifo_lat/n_requests,n_requests/t_fifo_lat,
+                                                                  (double)n_transfers*bulk_size/(1.0e6*t_fifo_bulk));
+    (void)fprintf(stderr,"    socket: latency %10.2f usecs/request (%10.1f requests/sec), throughput %10.2f MB/sec\n",
+                                                                       1.0e6*t_sock_lat/n_requests,n_requests/t_sock_lat,
+                                                                  (double)n_transfers*bulk_size/(1.0e6*t_sock_bulk));
+    (void)fprintf(stderr,"    speedup: latency %6.2f, throughput %6.2f\n\n",t_fifo_lat/t_sock_lat,t_fifo_bulk/t_sock_bulk);
+    (void)fflush(stderr);
+
+
+    /*----------------------*/
+    /* Clean up and go home */
+    /*----------------------*/
+
+    (void)pups_free((void *)small);
+    (void)pups_free((void *)bulk);
+    (void)pups_free((void *)buf);
+
+    pups_exit(0);
+}
@@ -8,8 +8,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 7.05 
-    Dated:   29th December 2024 
+    Version: 7.16 
+    Dated:   19th October 2026 
     E-mail:  mao@tumblingdice.co.uk
 -------------------------------------------------------*/
 
@@ -34,7 +34,14 @@
 #include <dirent.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <inttypes.h>
 #include <bsd/bsd.h>
+#include <poll.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 
 #define SSIZE SSIZE
@@ -73,6 +80,8 @@
 
 #ifdef PTHREAD_SUPPORT
 #include <tad.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #endif /* PTHREAD_SUPPORT */
 
 #ifndef NO_SCHED_YIELD
@@ -83,6 +92,8 @@
 #include <psrp.h>
 #define __NOT_LIB_SOURCE__
 
+#include <pnreg.h>
+
 
 /*----------------------------------------------------------------*/
 /* Get signal mapping appropriate to OS and hardware architecture */
@@ -139,6 +150,9 @@ _PUBLIC char     channel_name_in[SSIZE]         = "";
 _PUBLIC char     channel_name_out[SSIZE]        = "";
 _PUBLIC psrp_channel_type *psrp_current_sic     = (psrp_channel_type *)NULL;
 _PUBLIC psrp_object_type  *psrp_object_list     = (psrp_object_type *)NULL;
+_PUBLIC _BOOLEAN psrp_socket_transport          = TRUE;
+_PUBLIC char     psrp_socket_name[SSIZE]        = "";
+_PUBLIC uint32_t psrp_sock_workers              = PSRP_SOCK_WORKERS;
 
 
 
@@ -160,6 +174,129 @@ _PRIVATE int32_t  ssh_sic_index                 = (-1);
 _PRIVATE char     psrp_password[SSIZE]          = "";
 
 
+/*---------------------------------------------------------*/
+/* Socket (SOCK_SEQPACKET) transport session table. Socket */
+/* sessions carry requests for clients which have already  */
+/* connected via the (FIFO) OPEN protocol                  */
+/*---------------------------------------------------------*/
+
+_PRIVATE des_t    psrp_listen_des               = (-1);
+_PRIVATE des_t    psrp_sock_des[MAX_CLIENTS];
+_PRIVATE int32_t  psrp_sock_client[MAX_CLIENTS];
+_PRIVATE pid_t    psrp_sock_pid[MAX_CLIENTS];
+_PRIVATE pid_t    psrp_sock_peer_pid[MAX_CLIENTS];
+_PRIVATE uint32_t psrp_sock_gen[MAX_CLIENTS];
+_PRIVATE FILE     *psrp_sock_reply              = (FILE *)NULL;
+
+
+/*-------------------------------------------------------*/
+/* Static functions which may be run concurrently (over  */
+/* the socket transport)                                 */
+/*-------------------------------------------------------*/
+
+_PRIVATE uint32_t psrp_concurrent_functions     = 0;
+_PRIVATE char     psrp_concurrent_tag[PSRP_CONCURRENT_TABLE_SIZE][SSIZE];
+_PRIVATE void     *psrp_concurrent_func[PSRP_CONCURRENT_TABLE_SIZE];
+
+
+/*-------------------------------------------------------*/
+/* Functions with typed arguments (and their schemas)    */
+/*-------------------------------------------------------*/
+
+_PRIVATE uint32_t psrp_typed_functions          = 0;
+_PRIVATE char     psrp_typed_tag[PSRP_TYPED_TABLE_SIZE][SSIZE];
+_PRIVATE char     psrp_typed_schema[PSRP_TYPED_TABLE_SIZE][PSRP_MAX_TYPED_ARGS + 1];
+_PRIVATE void     *psrp_typed_handle[PSRP_TYPED_TABLE_SIZE];
+_PRIVATE int32_t  (*psrp_typed_func[PSRP_TYPED_TABLE_SIZE])(const psrp_typed_args_type *);
+
+
+/*----------------------------------------------------------*/
+/* Request latency histograms (per verb and per client) and */
+/* trace span ring (allocated when tracing is switched on)  */
+/*----------------------------------------------------------*/
+
+_PRIVATE psrp_latency_type    psrp_latency_verb[PSRP_LATENCY_VERBS];
+_PRIVATE psrp_latency_type    psrp_latency_client[MAX_CLIENTS];
+_PRIVATE psrp_latency_type    psrp_latency_other;
+_PRIVATE psrp_trace_span_type *psrp_trace           = (psrp_trace_span_type *)NULL;
+_PRIVATE uint64_t             psrp_trace_spans      = 0;
+
+#ifdef PTHREAD_SUPPORT
+_PRIVATE pthread_mutex_t      psrp_latency_mutex    = PTHREAD_MUTEX_INITIALIZER;
+#endif /* PTHREAD_SUPPORT */
+
+
+/*----------------------------------------------------------*/
+/* Crontab deadline queue (binary heap of crontab slots     */
+/* ordered by next wakeup). If we have threads, it is       */
+/* serviced by a cron thread which sleeps until the         */
+/* earliest (absolute) wakeup. Payloads which are due are   */
+/* queued for the root thread, which is sent SIGCRON        */
+/*----------------------------------------------------------*/
+
+_PRIVATE int32_t              psrp_cron_heap[MAX_CRON_SLOTS];
+_PRIVATE uint32_t             psrp_cron_heap_size   = 0;
+
+#ifdef PTHREAD_SUPPORT
+_PRIVATE int32_t              psrp_cron_pending[MAX_CRON_SLOTS];
+_PRIVATE uint32_t             psrp_cron_n_pending   = 0;
+_PRIVATE _BOOLEAN             psrp_cron_threaded    = FALSE;
+_PRIVATE _BOOLEAN             psrp_cron_rearm       = FALSE;
+_PRIVATE pthread_t            psrp_cron_tid;
+_PRIVATE pthread_mutex_t      psrp_cron_mutex       = PTHREAD_MUTEX_INITIALIZER;
+_PRIVATE pthread_cond_t       psrp_cron_cond        = PTHREAD_COND_INITIALIZER;
+#endif /* PTHREAD_SUPPORT */
+
+
+/*---------------------------------------------------------*/
+/* Shared memory process name registry (layout in pnreg.h) */
+/* and the slot this process is registered in              */
+/*---------------------------------------------------------*/
+
+_PRIVATE pnreg_type           *psrp_pnreg           = (pnreg_type *)NULL;
+_PRIVATE int32_t              psrp_pnreg_slot       = (-1);
+_PRIVATE pid_t                psrp_pnreg_owner      = (-1);
+
+
+#ifdef PTHREAD_SUPPORT
+/*---------------------------------------------------------*/
+/* Socket transport event loop. A dedicated thread         */
+/* multiplexes the listener and sessions (via epoll).      */
+/* Requests for concurrent functions go to a worker pool,  */
+/* all other requests are queued (serialised) for the root */
+/* thread                                                  */
+/*---------------------------------------------------------*/
+
+#define PSRP_SOCK_LISTEN_TOKEN          MAX_CLIENTS
+#define PSRP_SOCK_WAKE_TOKEN            (MAX_CLIENTS + 1)
+
+_PRIVATE _BOOLEAN            psrp_sock_threaded        = FALSE;
+_PRIVATE volatile _BOOLEAN   psrp_sock_shutdown        = FALSE;
+_PRIVATE uint32_t            psrp_sock_workers_running = 0;
+_PRIVATE des_t               psrp_epoll_des            = (-1);
+_PRIVATE des_t               psrp_wake_des             = (-1);
+_PRIVATE pthread_t           psrp_sock_tid;
+_PRIVATE psrp_sock_work_type *psrp_serial_head         = (psrp_sock_work_type *)NULL;
+_PRIVATE psrp_sock_work_type *psrp_serial_tail         = (psrp_sock_work_type *)NULL;
+_PRIVATE psrp_sock_work_type *psrp_work_head           = (psrp_sock_work_type *)NULL;
+_PRIVATE psrp_sock_work_type *psrp_work_tail           = (psrp_sock_work_type *)NULL;
+
+// Session table (and root thread queue) mutex
+_PRIVATE pthread_mutex_t psrp_sock_mutex               = PTHREAD_MUTEX_INITIALIZER;
+
+// Per session send mutexes
+_PRIVATE pthread_mutex_t psrp_sock_send_mutex[MAX_CLIENTS];
+
+// Worker queue mutex (and condition)
+_PRIVATE pthread_mutex_t psrp_work_mutex               = PTHREAD_MUTEX_INITIALIZER;
+_PRIVATE pthread_cond_t  psrp_work_cond                = PTHREAD_COND_INITIALIZER;
+
+// Concurrent requests in progress (protected by session table mutex)
+_PRIVATE uint32_t        psrp_concurrent_running       = 0;
+_PRIVATE pthread_cond_t  psrp_concurrent_cond          = PTHREAD_COND_INITIALIZER;
+#endif /* PTHREAD_SUPPORT */
+
+
 
 /*-------------------------------------------------*/
 /* Slot and usage functions - used by slot manager */
@@ -200,7 +337,7 @@ _EXTERN void (* SLOT )() __attribute__ ((aligned(16))) = psrplib_slot;
 /*-------------------------------------------------------------------*/
  
 _PUBLIC FILE     *psrp_in                  = (FILE *)NULL;    // I/P from PSRP client
-_PUBLIC FILE     *psrp_out                 = (FILE *)NULL;    // O/P to PSRP client 
+_PUBLIC __thread FILE *psrp_out            = (FILE *)NULL;    // O/P to PSRP client (thread local)
 _PUBLIC _BOOLEAN psrp_reactivate_client    = FALSE;           // Reactivate attached client
 _PUBLIC _BOOLEAN connected_once            = FALSE;           // TRUE if connection made
 _PUBLIC _BOOLEAN in_psrp_new_segment       = FALSE;           // TRUE if in segment code 
@@ -356,6 +493,73 @@ _PROTOTYPE _PRIVATE int32_t psrp_builtin_crontab_unschedule(const uint32_t, cons
 // Check to see if any cron operations are pending
 _PROTOTYPE _PRIVATE void psrp_crontab_checkschedule(char *);
 
+// Lock crontab
+_PROTOTYPE _PRIVATE void psrp_cron_lock(sigset_t *);
+
+// Unlock crontab
+_PROTOTYPE _PRIVATE void psrp_cron_unlock(const sigset_t *);
+
+// Swap crontab deadline queue entries
+_PROTOTYPE _PRIVATE void psrp_cron_heap_swap(const uint32_t, const uint32_t);
+
+// Restore crontab deadline queue order
+_PROTOTYPE _PRIVATE void psrp_cron_heap_fix(uint32_t);
+
+// Add crontab slot to deadline queue
+_PROTOTYPE _PRIVATE void psrp_cron_heap_push(const int32_t);
+
+// Remove crontab slot from deadline queue
+_PROTOTYPE _PRIVATE void psrp_cron_heap_remove(const int32_t);
+
+// Parse cron expression field
+_PROTOTYPE _PRIVATE int32_t psrp_cron_field(const char *, const int32_t, const int32_t, uint64_t *);
+
+// Parse cron expression
+_PROTOTYPE _PRIVATE int32_t psrp_cron_parse(const char *, psrp_cron_spec_type *);
+
+// Set cron specification for window time
+_PROTOTYPE _PRIVATE int32_t psrp_cron_window_time(const char *, psrp_cron_spec_type *);
+
+// Does cron specification match day
+_PROTOTYPE _PRIVATE _BOOLEAN psrp_cron_day_match(const psrp_cron_spec_type *, const struct tm *);
+
+// Next time which matches cron specification
+_PROTOTYPE _PRIVATE time_t psrp_cron_next(const psrp_cron_spec_type *, const time_t);
+
+// Queue next start of crontab activity
+_PROTOTYPE _PRIVATE void psrp_cron_queue_start(const int32_t, const time_t);
+
+// Pop due crontab activities from deadline queue
+_PROTOTYPE _PRIVATE uint32_t psrp_cron_run_due(const time_t, int32_t *);
+
+// Find free crontab slot
+_PROTOTYPE _PRIVATE int32_t psrp_cron_free_slot(void);
+
+
+// Attach (and optionally create) process name registry
+_PROTOTYPE _PRIVATE _BOOLEAN psrp_pnreg_attach(const _BOOLEAN);
+
+// Reclaim registry entry abandoned (odd) by writer which died
+_PROTOTYPE _PRIVATE _BOOLEAN psrp_pnreg_reclaim(pnreg_entry_type *, uint32_t *);
+
+
+// Run payload of crontab activity (on root thread)
+_PROTOTYPE _PRIVATE void psrp_cron_launch(const int32_t);
+
+// Start cron service (cron thread or cron_homeostat virtual timer)
+_PROTOTYPE _PRIVATE void psrp_cron_start(void);
+
+#ifdef PTHREAD_SUPPORT
+// Handler for SIGCRON (run payloads queued by cron thread)
+_PROTOTYPE _PRIVATE int32_t psrp_cron_handler(const int32_t);
+
+// Cron thread
+_PROTOTYPE _PRIVATE void *psrp_cron_thread(void *);
+
+// Reset cron thread state in child (after fork)
+_PROTOTYPE _PRIVATE void psrp_cron_child(void);
+#endif /* PTHREAD_SUPPORT */
+
 // Add an alias to a PSRP object
 _PROTOTYPE _PRIVATE int32_t psrp_builtin_alias(const uint32_t, const char *[]);
 
@@ -396,10 +600,10 @@ _PROTOTYPE _PRIVATE  int32_t psrp_detach_object(uint32_t);
 _PROTOTYPE _PRIVATE void psrp_argvec(uint32_t *, const char *);
 
 // Switch transaction/error logging on/off
-_PROTOTYPE _PRIVATE int32_t psrp_builtin_appl_verbose(const int32_t, const char *[]);
+_PROTOTYPE _PRIVATE int32_t psrp_builtin_appl_verbose(const uint32_t, const char *[]);
 
 // Toggle (client) error handling on/off
-_PROTOTYPE _PRIVATE int32_t psrp_builtin_error_handling(const int32_t, const char *[]);
+_PROTOTYPE _PRIVATE int32_t psrp_builtin_error_handling(const uint32_t, const char *[]);
 
 // Delete object from PSRP dispatch table
 _PROTOTYPE _PRIVATE int32_t psrp_builtin_transactions(const uint32_t, const char *[]);
@@ -410,6 +614,9 @@ _PROTOTYPE _PRIVATE int32_t psrp_builtin_detach_object(const uint32_t, const cha
 // Show state of PSRP bindings (to client)
 _PROTOTYPE _PRIVATE int32_t psrp_builtin_show_psrp_state(const uint32_t, const char *[]);
 
+// Show (or dump) request latency histograms and control request tracing
+_PROTOTYPE _PRIVATE int32_t psrp_builtin_latency(const uint32_t, const char *[]);
+
 // Show bindings of all PSRP objects
 _PROTOTYPE _PRIVATE int32_t psrp_builtin_show_psrp_bind_type(const uint32_t, const char *[]);
 
@@ -548,6 +755,9 @@ _PROTOTYPE _PRIVATE int32_t psrp_builtin_overfork_server_process(const uint32_t,
 // Attach dynamic function to PSRP handler
 _PROTOTYPE _PRIVATE int32_t psrp_builtin_attach_dbag(const uint32_t, const char *[]);
 
+// Attach a dynamic databag (streamed via shared memory ring) to PSRP handler list
+_PROTOTYPE _PRIVATE int32_t psrp_builtin_attach_ring_dbag(const uint32_t, const char *[]);
+
 // Handler for SIGALRM
 _PROTOTYPE _PRIVATE void psrp_homeostat(void *, char *);
 
@@ -560,6 +770,183 @@ _PROTOTYPE _PRIVATE int32_t psrp_handler(const int32_t);
 // Handler for propagated SIGABRT
 _PROTOTYPE _PRIVATE int32_t abrt_handler(const int32_t);
 
+// Handler for SIGPSRPIO (socket transport activity)
+_PROTOTYPE _PRIVATE int32_t psrp_sock_handler(const int32_t);
+
+// Authenticate, log and dispatch a PSRP request
+_PROTOTYPE _PRIVATE void psrp_service_request(char *);
+
+// Create socket transport listener
+_PROTOTYPE _PRIVATE int32_t psrp_sock_listen(void);
+
+// Hash PSRP object tag (or builtin verb)
+_PROTOTYPE _PRIVATE uint32_t psrp_hash_tag(const char *, const uint32_t);
+
+// Add tag to PSRP object tag index
+_PROTOTYPE _PRIVATE void psrp_tag_index_insert(const char *, const uint32_t, const uint32_t);
+
+// Remove tag from PSRP object tag index
+_PROTOTYPE _PRIVATE void psrp_tag_index_remove(const char *, const uint32_t);
+
+// Remove tags (from given tag index onwards) of dispatch table slot from tag index
+_PROTOTYPE _PRIVATE void psrp_tag_index_remove_slot(const uint32_t, const uint32_t);
+
+// Look up (attached) PSRP object by tag
+_PROTOTYPE _PRIVATE int32_t psrp_tag_index_lookup(const char *);
+
+// Look up builtin (by verb)
+_PROTOTYPE _PRIVATE const psrp_builtin_type *psrp_builtin_lookup(const char *);
+
+// Check that builtin dispatch table is a perfect hash
+_PROTOTYPE _PRIVATE void psrp_builtin_check(void);
+
+// Read (complete) reply from slaved PSRP client
+_PROTOTYPE _PRIVATE char *psrp_read_sic_reply(const _BOOLEAN, const psrp_channel_type *);
+
+// Monotonic time (microseconds) for request latency
+_PROTOTYPE _PRIVATE uint64_t psrp_latency_now(void);
+
+// Latency histogram bucket
+_PROTOTYPE _PRIVATE uint32_t psrp_hist_bucket(uint64_t);
+
+// Smallest latency held by histogram bucket
+_PROTOTYPE _PRIVATE uint64_t psrp_hist_bucket_value(const uint32_t);
+
+// Add sample to latency histogram
+_PROTOTYPE _PRIVATE void psrp_hist_add(psrp_hist_type *, const uint64_t);
+
+// Latency at percentile of histogram
+_PROTOTYPE _PRIVATE uint64_t psrp_hist_percentile(const psrp_hist_type *, const double);
+
+// Find (or add) latency histograms for verb
+_PROTOTYPE _PRIVATE psrp_latency_type *psrp_latency_verb_entry(const char *);
+
+// Record latency (and trace span) of request
+_PROTOTYPE _PRIVATE void psrp_latency_record(const char *, const int32_t, const uint32_t, const uint64_t, const uint64_t, const uint64_t, const uint64_t);
+
+// Reset latency histograms of client slot
+_PROTOTYPE _PRIVATE void psrp_latency_reset_client(const int32_t);
+
+#ifdef PTHREAD_SUPPORT
+// Lock latency histograms (PSRP signals blocked)
+_PROTOTYPE _PRIVATE void psrp_latency_lock(sigset_t *);
+
+// Unlock latency histograms
+_PROTOTYPE _PRIVATE void psrp_latency_unlock(const sigset_t *);
+#endif /* PTHREAD_SUPPORT */
+
+// Show latency histograms
+_PROTOTYPE _PRIVATE void psrp_show_latency(const char *, const psrp_latency_type *);
+
+// Dump latency histograms (machine readable)
+_PROTOTYPE _PRIVATE void psrp_dump_latency(FILE *, const char *, const char *, const psrp_latency_type *);
+
+// Escape string for JSON
+_PROTOTYPE _PRIVATE void psrp_json_escape(const char *, char *, const size_t);
+
+// Export trace spans (Chrome trace format)
+_PROTOTYPE _PRIVATE int32_t psrp_export_trace(const char *);
+
+// Is SIC healthy?
+_PROTOTYPE _PRIVATE _BOOLEAN psrp_sic_alive(const psrp_channel_type *);
+
+// Reap idle pooled SICs (virtual timer payload)
+_PROTOTYPE _PRIVATE void psrp_sic_pool_homeostat(char *);
+
+// Reserve space in typed argument buffer
+_PROTOTYPE _PRIVATE int32_t psrp_argbuf_reserve(psrp_argbuf_type *, const size_t);
+
+// Append varint to typed argument buffer
+_PROTOTYPE _PRIVATE int32_t psrp_argbuf_put_varint(psrp_argbuf_type *, uint64_t);
+
+// Append byte blob (or string) to typed argument buffer
+_PROTOTYPE _PRIVATE int32_t psrp_argbuf_put_data(psrp_argbuf_type *, const _BYTE, const void *, const size_t);
+
+// Get varint from typed arguments
+_PROTOTYPE _PRIVATE int32_t psrp_args_get_varint(const _BYTE *, const size_t, size_t *, uint64_t *);
+
+// Find typed argument schema for attached object
+_PROTOTYPE _PRIVATE int32_t psrp_typed_lookup(const int32_t);
+
+// Run typed function with decoded arguments
+_PROTOTYPE _PRIVATE int32_t psrp_exec_typed_function(const int32_t, const char *, const int32_t, psrp_typed_args_type *);
+
+// Service typed (binary argument) request
+_PROTOTYPE _PRIVATE void psrp_service_typed_request(const char *, const size_t);
+
+// Futex operation on shared memory ring
+_PROTOTYPE _PRIVATE int32_t psrp_ring_futex(uint32_t *, const int32_t, const uint32_t, const int32_t);
+
+// Wake peer sleeping on shared memory ring
+_PROTOTYPE _PRIVATE void psrp_ring_wake(uint32_t *, uint32_t *);
+
+// Wait for peer to change shared memory ring state
+_PROTOTYPE _PRIVATE int32_t psrp_ring_wait(psrp_ring_type *, const _BOOLEAN, const int32_t);
+
+// Map shared memory ring
+_PROTOTYPE _PRIVATE psrp_ring_type *psrp_ring_map(const des_t);
+
+// Attach databag (read from shared memory ring)
+_PROTOTYPE _PRIVATE int32_t psrp_attach_ring_databag(const char *, psrp_ring_type *);
+
+#ifdef PTHREAD_SUPPORT
+// Lock socket transport session table (PSRP signals blocked)
+_PROTOTYPE _PRIVATE void psrp_sock_lock(sigset_t *);
+
+// Unlock socket transport session table
+_PROTOTYPE _PRIVATE void psrp_sock_unlock(const sigset_t *);
+#endif /* PTHREAD_SUPPORT */
+
+// Remove concurrent function (waiting for requests in progress)
+_PROTOTYPE _PRIVATE void psrp_concurrent_remove(const char *, const void *);
+
+// Close socket transport session
+_PROTOTYPE _PRIVATE void psrp_sock_drop(const uint32_t, const uint32_t);
+
+// Send reply on socket transport session
+_PROTOTYPE _PRIVATE int32_t psrp_sock_reply_send(const uint32_t, const uint32_t, const uint32_t, const char *, const size_t);
+
+// Accept socket transport sessions
+_PROTOTYPE _PRIVATE void psrp_sock_accept(void);
+
+// Bind socket transport session to connected client
+_PROTOTYPE _PRIVATE void psrp_sock_open_session(const uint32_t, const uint32_t, const uint32_t, const char *);
+
+// Strip (trailing) line terminators from socket transport request
+_PROTOTYPE _PRIVATE void psrp_sock_strip(char *);
+
+// Execute socket transport request (or batch of requests)
+_PROTOTYPE _PRIVATE void psrp_sock_execute(const uint32_t, const uint32_t, const uint32_t, const uint32_t, const uint64_t, const char *, const size_t);
+
+// Dispatch socket transport message
+_PROTOTYPE _PRIVATE void psrp_sock_dispatch(const uint32_t, const uint32_t, const uint32_t, const uint32_t, const uint64_t, const char *, const size_t);
+
+// Service socket transport session
+_PROTOTYPE _PRIVATE void psrp_sock_service(const uint32_t);
+
+#ifdef PTHREAD_SUPPORT
+// Read request from socket transport session (event loop thread)
+_PROTOTYPE _PRIVATE void psrp_sock_read(const uint32_t, const uint32_t);
+
+// Socket transport event loop thread
+_PROTOTYPE _PRIVATE void *psrp_sock_thread(void *);
+
+// Is concurrent function (still) attached
+_PROTOTYPE _PRIVATE _BOOLEAN psrp_sock_concurrent_begin(psrp_sock_work_type *);
+
+// Run concurrent request (worker thread)
+_PROTOTYPE _PRIVATE void psrp_sock_run_concurrent(psrp_sock_work_type *);
+
+// Socket transport worker thread
+_PROTOTYPE _PRIVATE void *psrp_sock_worker(void *);
+
+// Start socket transport event loop
+_PROTOTYPE _PRIVATE int32_t psrp_sock_start(void);
+
+// Stop socket transport event loop
+_PROTOTYPE _PRIVATE void psrp_sock_stop(void);
+#endif /* PTHREAD_SUPPORT */
+
 // Initialise channel table for slaved interaction clients
 _PROTOTYPE _PRIVATE void psrp_initsic(void);
 
@@ -584,7 +971,13 @@ _PRIVATE uint32_t          psrp_object_list_allocated;                       //
 _PRIVATE int32_t           psrp_bind_status  = PSRP_STATIC_FUNCTION;         // Default (attached) function bindiong type
 _PRIVATE _BOOLEAN          psrp_ignore       = FALSE;                        // Ignore PSRP requests
 _PRIVATE psrp_channel_type channel[PSRP_MAX_SIC_CHANNELS];                   // PSRP slaved ineraction channels
+_PRIVATE psrp_sic_pool_type psrp_sic_pool[PSRP_SIC_POOL_SIZE];               // Pool of (warm) SICs
+_PRIVATE _BOOLEAN          psrp_sic_pool_timer   = FALSE;                    // TRUE if SIC pool reaper is running
 _PRIVATE psrp_crontab_type crontab[MAX_CRON_SLOTS];                          // PSRP crontab slots
+_PRIVATE uint32_t          psrp_tag_hash_size    = 0;                        // Number of buckets in tag index
+_PRIVATE uint32_t          psrp_tag_hash_entries = 0;                        // Number of tags in tag index
+_PRIVATE psrp_tag_hash_type **psrp_tag_hash      = (psrp_tag_hash_type **)NULL;
+                                                                             // Tag (and alias) index
 
 
 
@@ -751,6 +1144,7 @@ _PUBLIC  int32_t psrp_attach_dynamic_function(const _BOOLEAN  search,  // Search
     }
 
 
+    psrp_tag_index_remove_slot(slot_index,0);
     psrp_object_list[slot_index].aliases               = 0;
     psrp_object_list[slot_index].aliases_allocated     = 0;
     tag_index                                          = psrp_get_tag_index(slot_index);
@@ -767,6 +1161,7 @@ _PUBLIC  int32_t psrp_attach_dynamic_function(const _BOOLEAN  search,  // Search
  
     (void)strlcpy((char *)psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
     (void)strlcpy((char *)psrp_object_list[slot_index].object_f_name,dll_name,SSIZE);
+    psrp_tag_index_insert(object_tag,slot_index,tag_index);
 
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
@@ -1076,6 +1471,8 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
     psrp_bind_status            = bind_status;
     appl_psrp                   = TRUE;
 
+    psrp_builtin_check();
+
 
     /*---------------------------------------------*/
     /* Initialise multiple access client database. */
@@ -1105,6 +1502,32 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
        pups_error("[psrp_init] failed to created psrp input channel");
 
 
+    /*------------------------------------------------------------*/
+    /* Register process name so other processes can resolve it    */
+    /* to our PID without walking /proc. If we cannot, they will  */
+    /* simply walk /proc                                          */
+    /*------------------------------------------------------------*/
+
+    (void)psrp_pnreg_register(appl_name);
+
+
+    /*--------------------------------------------------------------*/
+    /* Create socket transport endpoint. If we cannot, clients will */
+    /* simply use the FIFO transport                                */
+    /*--------------------------------------------------------------*/
+
+    if(psrp_socket_transport == TRUE && psrp_sock_listen() == (-1))
+    {  psrp_socket_transport = FALSE;
+
+       if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create PSRP socket transport (%s) -- using FIFO transport\n",
+                                                  date,appl_name,appl_pid,appl_host,appl_owner,strerror(errno));
+          (void)fflush(stderr);
+       }
+    }
+
+
     /*---------------------------------------------------------------------*/
     /* Make sure that we delete the communications channel pipes when this */
     /* process exits.                                                      */
@@ -1211,6 +1634,7 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
     (void)sigaddset(&chan_set,SIGINIT);
     (void)sigaddset(&chan_set,SIGCHAN);
     (void)sigaddset(&chan_set,SIGPSRP);
+    (void)sigaddset(&chan_set,SIGPSRPIO);
     (void)sigaddset(&chan_set,SIGCHLD);
     (void)sigaddset(&chan_set,SIGABRT);
     (void)sigaddset(&chan_set,SIGALRM);
@@ -1225,6 +1649,7 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
     (void)sigaddset(&psrp_set,SIGINIT);
     (void)sigaddset(&psrp_set,SIGCHAN);
     (void)sigaddset(&psrp_set,SIGPSRP);
+    (void)sigaddset(&psrp_set,SIGPSRPIO);
     (void)sigaddset(&psrp_set,SIGCHLD);
     (void)sigaddset(&psrp_set,SIGABRT);
     (void)sigaddset(&psrp_set,SIGALRM);
@@ -1239,6 +1664,7 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
     (void)sigaddset(&init_set,SIGINIT);
     (void)sigaddset(&init_set,SIGCHAN);
     (void)sigaddset(&init_set,SIGPSRP);
+    (void)sigaddset(&init_set,SIGPSRPIO);
     (void)sigaddset(&init_set,SIGCHLD);
     (void)sigaddset(&init_set,SIGABRT);
     (void)sigaddset(&init_set,SIGALRM);
@@ -1257,6 +1683,33 @@ _PUBLIC void psrp_init(const int32_t bind_status, const int32_t (*psrp_process_s
     (void)pups_sighandle(SIGINIT,  "chan_handler", (void *)chan_handler, &init_set);
     (void)pups_sighandle(SIGCHAN,  "chan_handler", (void *)chan_handler, &chan_set);
     (void)pups_sighandle(SIGPSRP,  "psrp_handler", (void *)psrp_handler, &psrp_set);
+
+    if(psrp_socket_transport == TRUE)
+    {  (void)pups_sighandle(SIGPSRPIO,"psrp_sock_handler",(void *)psrp_sock_handler,&psrp_set);
+
+
+       /*------------------------------------------------------*/
+       /* Real time signal queue overflow is reported as SIGIO */
+       /*------------------------------------------------------*/
+
+       (void)pups_sighandle(SIGIO,    "psrp_sock_handler",(void *)psrp_sock_handler,&psrp_set);
+
+
+       /*-------------------------------------------------------*/
+       /* Hand socket transport over to event loop thread. If   */
+       /* we cannot, it stays signal driven (all requests being */
+       /* serviced by the root thread)                          */
+       /*-------------------------------------------------------*/
+
+       #ifdef PTHREAD_SUPPORT
+       if(psrp_sock_start() == (-1) && appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to start PSRP socket transport event loop (%s) -- signal driven\n",
+                                                      date,appl_name,appl_pid,appl_host,appl_owner,strerror(errno));
+          (void)fflush(stderr);
+       }
+       #endif /* PTHREAD_SUPPORT */
+    }
     (void)pups_sighandle(SIGABRT,  "abrt_handler", (void *)abrt_handler, &abrt_set);
     (void)pups_sighandle(SIGCLIENT,"cdoss_handler",(void *)cdoss_handler,&abrt_set);
     (void)pups_sighandle(SIGALIVE, "ignore",SIG_IGN, (sigset_t *)NULL);
@@ -1476,15 +1929,17 @@ _PUBLIC int32_t psrp_attach_static_databag(const char     *object_tag,
        }
     }
 
+    psrp_tag_index_remove_slot(slot_index,0);
     psrp_object_list[slot_index].aliases           = 0;
     psrp_object_list[slot_index].aliases_allocated = 0;
     tag_index = psrp_get_tag_index(slot_index);
 
-    (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
-
     if(psrp_object_list[slot_index].object_tag[tag_index] == (char *)NULL)
        psrp_object_list[slot_index].object_tag[tag_index] = (char *)pups_malloc(SSIZE);
 
+    (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
+    psrp_tag_index_insert(object_tag,slot_index,tag_index);
+
     psrp_object_list[slot_index].object_handle     = (void *)databag_handle;
     psrp_object_list[slot_index].object_size       = databag_size;
     psrp_object_list[slot_index].object_type       = PSRP_STATIC_DATABAG;
@@ -1582,6 +2037,7 @@ _PUBLIC int32_t psrp_attach_dynamic_databag(const _BOOLEAN     search,  // If TR
     }
 
 
+    psrp_tag_index_remove_slot(slot_index,0);
     psrp_object_list[slot_index].aliases           = 0;
     psrp_object_list[slot_index].aliases_allocated = 0;
     tag_index                                      = psrp_get_tag_index(slot_index);
@@ -1621,6 +2077,7 @@ _PUBLIC int32_t psrp_attach_dynamic_databag(const _BOOLEAN     search,  // If TR
 
     (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
     (void)strlcpy(psrp_object_list[slot_index].object_f_name,bag_file_name,SSIZE);
+    psrp_tag_index_insert(object_tag,slot_index,tag_index);
 
     if(appl_verbose == TRUE)
     {  (void)fprintf(stderr,"%s %s (%d@%s:%s): dynamic databag \"%-32s\" attached (from %s at %016lx virtual)\n",
@@ -1642,6 +2099,138 @@ _PUBLIC int32_t psrp_attach_dynamic_databag(const _BOOLEAN     search,  // If TR
 
 
 
+/*------------------------------------------------------------------*/
+/* Attach a dynamic databag (streamed via shared memory ring) to    */
+/* the PSRP handler dispatch list. Data is copied once, directly    */
+/* from the ring into the databag                                   */
+/*------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_attach_ring_databag(const char *object_tag, psrp_ring_type *ring)
+
+{    int32_t slot_index,
+             tag_index;
+
+    ssize_t  avail;
+
+    size_t   bag_size      = 0,
+             bag_allocated = 0,
+             bag_max       = PSRP_RING_MAX_TOTAL;
+
+    uint64_t total;
+
+    _BYTE    *ptr          = (_BYTE *)NULL,
+             *bag_handle   = (_BYTE *)NULL;
+
+    if(object_tag == (const char *)NULL || ring == (psrp_ring_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+
+    /*------------------------------------------------------*/
+    /* Size is known up front (so databag can be allocated  */
+    /* in one go) unless writer is streaming from a pipe.   */
+    /* The size is written by the peer so it is only read   */
+    /* once and must not exceed PSRP_RING_MAX_TOTAL bytes   */
+    /*------------------------------------------------------*/
+
+    total = __atomic_load_n(&ring->header->total,__ATOMIC_SEQ_CST);
+    if(total > PSRP_RING_MAX_TOTAL)
+    {  pups_set_errno(EFBIG);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    if(total > 0)
+    {  bag_max       = (size_t)total;
+       bag_allocated = (size_t)total;
+       bag_handle    = (_BYTE *)pups_malloc(bag_allocated);
+    }
+
+    while((avail = psrp_ring_peek(ring,&ptr,PSRP_RING_TIMEOUT)) > 0)
+    {
+
+       /*--------------------------------------------------*/
+       /* Writer is sending more than it said it would (or */
+       /* more than PSRP_RING_MAX_TOTAL bytes)             */
+       /*--------------------------------------------------*/
+
+       if(bag_size + avail > bag_max)
+       {  (void)pups_free((void *)bag_handle);
+
+          pups_set_errno(EFBIG);
+          return(PSRP_DISPATCH_ERROR);
+       }
+
+       if(bag_size + avail > bag_allocated)
+       {  bag_allocated = bag_size + avail + PSRP_BAG_TABLE_SIZE;
+          bag_handle    = (_BYTE *)pups_realloc((void *)bag_handle,bag_allocated);
+       }
+
+       (void)memcpy((void *)(bag_handle + bag_size),(void *)ptr,avail);
+       psrp_ring_consume(ring,avail);
+
+       bag_size += avail;
+    }
+
+
+    /*-------------------------------------------------*/
+    /* Writer has died, stalled or abandoned transfer  */
+    /* midway (caller abandons the ring)               */
+    /*-------------------------------------------------*/
+
+    if(avail == (-1))
+    {  (void)pups_free((void *)bag_handle);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    if((slot_index = psrp_find_action_slot_index(object_tag)) == (-1))
+        slot_index = psrp_get_action_slot_index();
+    else if(psrp_object_list[slot_index].object_type == PSRP_DYNAMIC_DATABAG)
+    {  (void)pups_free((void *)psrp_object_list[slot_index].object_handle);
+       psrp_object_list[slot_index].object_handle = (void *)NULL;
+    }
+
+    psrp_tag_index_remove_slot(slot_index,0);
+    psrp_object_list[slot_index].aliases           = 0;
+    psrp_object_list[slot_index].aliases_allocated = 0;
+    tag_index                                      = psrp_get_tag_index(slot_index);
+
+    if(psrp_object_list[slot_index].object_tag[tag_index] == (char *)NULL)
+       psrp_object_list[slot_index].object_tag[tag_index] = (char *)pups_malloc(SSIZE);
+
+    if(psrp_object_list[slot_index].object_f_name == (char *)NULL)
+       psrp_object_list[slot_index].object_f_name = (char *)pups_malloc(SSIZE);
+
+    psrp_object_list[slot_index].object_handle = (void *)bag_handle;
+    psrp_object_list[slot_index].object_size   = bag_size;
+    psrp_object_list[slot_index].object_type   = PSRP_DYNAMIC_DATABAG;
+
+    (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
+    (void)strlcpy(psrp_object_list[slot_index].object_f_name,"ring",SSIZE);
+    psrp_tag_index_insert(object_tag,slot_index,tag_index);
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): dynamic databag \"%-32s\" attached (%ld bytes from ring [writer %d] at %016lx virtual)\n",
+                                                                                                                               date,
+                                                                                                                          appl_name,
+                                                                                                                           appl_pid,
+                                                                                                                          appl_host,
+                                                                                                                         appl_owner,
+                                                                                                                         object_tag,
+                                                                                                                           bag_size,
+                                                                                                             ring->header->writer_pid,
+                                                                                                               (uint64_t)bag_handle);
+       (void)fflush(stderr);
+    }
+
+    pups_set_errno(OK);
+    return(PSRP_OK);
+}
+
+
+
+
 
 #ifdef PERSISTENT_HEAP_SUPPORT
 /*------------------------------------------------------------*/
@@ -1715,6 +2304,7 @@ _PUBLIC int32_t psrp_attach_persistent_heap(const _BOOLEAN         search,    //
        return(-1);
     }
 
+    psrp_tag_index_remove_slot(slot_index,0);
     psrp_object_list[slot_index].aliases           = 0;
     psrp_object_list[slot_index].aliases_allocated = 0;
 
@@ -1739,6 +2329,7 @@ _PUBLIC int32_t psrp_attach_persistent_heap(const _BOOLEAN         search,    //
 
     (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],heap_tag,SSIZE);
     (void)strlcpy(psrp_object_list[slot_index].object_f_name,heap_file_name,SSIZE);
+    psrp_tag_index_insert(heap_tag,slot_index,tag_index);
 
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
@@ -1800,6 +2391,7 @@ _PUBLIC int32_t psrp_attach_static_function(const char    *object_tag,
        }
     }
 
+    psrp_tag_index_remove_slot(slot_index,0);
     psrp_object_list[slot_index].aliases               = 0;
     psrp_object_list[slot_index].aliases_allocated     = 0;
     psrp_object_list[slot_index].object_handle         = object_handle;
@@ -1812,6 +2404,7 @@ _PUBLIC int32_t psrp_attach_static_function(const char    *object_tag,
        psrp_object_list[slot_index].object_tag[tag_index] = (char *)pups_malloc(SSIZE);
 
     (void)strlcpy(psrp_object_list[slot_index].object_tag[tag_index],object_tag,SSIZE);
+    psrp_tag_index_insert(object_tag,slot_index,tag_index);
  
  
     if(appl_verbose == TRUE)
@@ -2018,8 +2611,7 @@ _PUBLIC void psrp_reset_dispatch_table(void)
  
 _PUBLIC _BOOLEAN psrp_detach_object_by_name(const char *object_tag)
  
-{    uint32_t i;
-     int32_t  slot_index;
+{    int32_t slot_index;
 
 
     if(object_tag == (const char *)NULL)
@@ -2035,25 +2627,23 @@ _PUBLIC _BOOLEAN psrp_detach_object_by_name(const char *object_tag)
     if(pupsthread_is_root_thread() == FALSE)
        pups_error("[psrp_detach_object_by_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {  if(psrp_object_list[i].object_handle != (void *)NULL && (slot_index = psrp_isearch_tag_list(object_tag,i)) >= 0)
-       {  
+    if((slot_index = psrp_tag_index_lookup(object_tag)) != (-1))
+    {  
 
-          if(appl_verbose == FALSE)
-          {  if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): object \"%-32s\" (index %d at %016lx virtual) detached\n",
-                                                                     date,appl_name,appl_pid,appl_host,appl_owner,
-                                                                          psrp_object_list[slot_index].object_tag,
-                                                                                                       slot_index,
-                                                             (uint64_t)psrp_object_list[slot_index].object_handle);
-                (void)fflush(stderr);
-             }
+       if(appl_verbose == FALSE)
+       {  if(appl_verbose == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): object \"%-32s\" (index %d at %016lx virtual) detached\n",
+                                                                  date,appl_name,appl_pid,appl_host,appl_owner,
+                                                                       psrp_object_list[slot_index].object_tag,
+                                                                                                    slot_index,
+                                                          (uint64_t)psrp_object_list[slot_index].object_handle);
+             (void)fflush(stderr);
           }
-
-          pups_set_errno(OK);
-          return(psrp_detach_object(i));
        }
+
+       pups_set_errno(OK);
+       return(psrp_detach_object(slot_index));
     }
 
     pups_set_errno(ESRCH);
@@ -2170,6 +2760,16 @@ _PRIVATE int32_t psrp_detach_object(uint32_t slot_index)
     }
 
 
+    /*--------------------------------------------------------------------*/
+    /* A function may also be registered to run concurrently. Remove it   */
+    /* (waiting for requests in progress) before it is reset or unloaded  */
+    /*--------------------------------------------------------------------*/
+
+    if(psrp_object_list[slot_index].object_type == PSRP_STATIC_FUNCTION  ||
+       psrp_object_list[slot_index].object_type == PSRP_DYNAMIC_FUNCTION  )
+       psrp_concurrent_remove(psrp_object_list[slot_index].object_tag[0],psrp_object_list[slot_index].object_handle);
+
+
     /*--------------------------------------------------------------------*/
     /* In the case of a static object - we simply reset it to its initial */
     /* state. That means all aliases must be removed                      */
@@ -2177,7 +2777,9 @@ _PRIVATE int32_t psrp_detach_object(uint32_t slot_index)
 
     if(psrp_object_list[slot_index].object_type == PSRP_STATIC_FUNCTION ||
        psrp_object_list[slot_index].object_type == PSRP_STATIC_DATABAG   )
-    {  for(i=1; i< psrp_object_list[slot_index].aliases_allocated; ++i)
+    {  psrp_tag_index_remove_slot(slot_index,1);
+
+       for(i=1; i< psrp_object_list[slot_index].aliases_allocated; ++i)
            if(psrp_object_list[slot_index].object_tag[i] != (char *)NULL)
               psrp_object_list[slot_index].object_tag[i] = pups_free((void *)psrp_object_list[slot_index].object_tag[i]);
 
@@ -2238,6 +2840,7 @@ _PRIVATE int32_t psrp_detach_object(uint32_t slot_index)
     /* Delete other attributes associated with the object */
     /*----------------------------------------------------*/
 
+    psrp_tag_index_remove_slot(slot_index,0);
     for(i=0; i< psrp_object_list[slot_index].aliases_allocated; ++i)
     {   if(psrp_object_list[slot_index].object_tag[i] != (char *)NULL)
            (void)pups_free((void *)psrp_object_list[slot_index].object_tag[i]);
@@ -2643,6 +3246,10 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
 
 {   sigset_t set;
 
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
+
     char     psrp_channel_name[SSIZE] = "",
              recreated[SSIZE]         = "",
              psrp_channel_op[SSIZE]   = "";
@@ -2745,7 +3352,8 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
 
     if(signum == SIGINIT)
     {  int32_t psrp_op_pid;
-       char    tmp_str[SSIZE] = "";
+       char    tmp_str[SSIZE]          = "",
+               psrp_channel_cap[SSIZE] = "";
 
 
        /*----------------------------*/
@@ -2753,7 +3361,7 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
        /*----------------------------*/
 
        (void)fgets(tmp_str,SSIZE,psrp_in);
-       (void)sscanf(tmp_str,"%s %d %s",psrp_channel_op,&psrp_op_pid,psrp_password);
+       (void)sscanf(tmp_str,"%s %d %s %s",psrp_channel_op,&psrp_op_pid,psrp_password,psrp_channel_cap);
 
        #ifdef PSRPLIB_DEBUG
        (void)fprintf(stderr,"PSRPLIB CLIENT OP: %s\n",tmp_str);
@@ -2918,6 +3526,17 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
 
              return(0);
           }
+
+
+          /*------------------------------------------------------*/
+          /* If client can use socket transport tell it where our */
+          /* socket is (older clients ignore the extra fields)    */
+          /*------------------------------------------------------*/
+
+          else if(strncmp(psrp_channel_op,"OPEN",4) == 0 && strcmp(psrp_channel_cap,"SEQPACKET") == 0 && psrp_listen_des != (-1))
+          {  (void)fprintf(psrp_out,"%d SEQPACKET %s\n",psrp_seg_cnt,psrp_socket_name);
+             (void)fflush(psrp_out);
+          }
           else
           {  (void)fprintf(psrp_out,"%d\n",psrp_seg_cnt);
              (void)fflush(psrp_out);
@@ -2939,18 +3558,34 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
           (void)fflush(stderr);
           #endif /* PSRPLIB_DEBUG */
 
+
+          /*----------------------------------------------------*/
+          /* Socket transport workers read the client table, so */
+          /* it is updated under the session table lock         */
+          /*----------------------------------------------------*/
+
+          #ifdef PTHREAD_SUPPORT
+          psrp_sock_lock(&old_set);
+          #endif /* PTHREAD_SUPPORT */
+
           if(sscanf(client_info,"%s%d%s%s",psrp_client_name[c_client],
                                            &psrp_client_pid[c_client],
                                            psrp_client_host[c_client],
                                            psrp_remote_hostpath[c_client]) != 4)
              (void)strlcpy(psrp_remote_hostpath[c_client],"notset",SSIZE);
 
+          #ifdef PTHREAD_SUPPORT
+          psrp_sock_unlock(&old_set);
+          #endif /* PTHREAD_SUPPORT */
 
-          /*---------------------------------------------------------------*/
-          /* We can only flag channel open once we have a valid client pid */
-          /* otherwise the homeostat will try to kill(0,SIGALIVE) with     */
-          /* disasterous results                                           */
-          /*---------------------------------------------------------------*/
+
+          /*------------------------------------------------------*/
+          /* Add client to liveness watch set (homeostat detects  */
+          /* clients which exit without closing their channel)    */
+          /*------------------------------------------------------*/
+
+          if(psrp_client_pid[c_client] > 0)
+             (void)pups_pid_watch(psrp_client_pid[c_client]);
 
           psrp_channel_open           = TRUE;
 
@@ -2981,6 +3616,7 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
                 (void)fflush(stderr);
              }
              psrp_transactions[c_client] = 0;
+             psrp_latency_reset_client(c_client);
           }
 
 
@@ -3034,48 +3670,38 @@ _PRIVATE int32_t chan_handler(const int32_t signum)
 
 _PRIVATE void psrp_homeostat(void *t_info, char *args)
 
-{    int32_t idum  = 0,
-             trys  = 0;
-
-     if(psrp_channel_open == TRUE)
-     {   int32_t i,
-                 ret;
-
-        char tcode[SSIZE] = "";
+{    int32_t i,
+             j,
+             n_exited,
+             idum = 0;
 
+     pid_t   exited[MAX_CLIENTS + MAX_CHILDREN];
 
-        /*------------------------------------------------------*/
-        /* Check (non active) connected clients are still alive */
-        /*------------------------------------------------------*/
 
+     /*--------------------------------------------------------*/
+     /* Collect clients and children which have exited. They   */
+     /* all live in one (pidfd) watch set so a single poll is  */
+     /* enough however many clients and children there are     */
+     /*--------------------------------------------------------*/
 
-        for(i=0; i<MAX_CLIENTS; ++i)
-        { 
-            /*------------------------------*/
-            /* Do not process active client */
-            /*------------------------------*/
- 
-            if(i != c_client && psrp_client_pid[i] != (-1)) 
-            {  do {    ret = pups_statkill(psrp_client_pid[i],SIGALIVE); 
-                       ++trys;
-                  } while(trys < max_trys && ret < 0);
+     n_exited = pups_pid_watch_poll(exited,MAX_CLIENTS + MAX_CHILDREN,0);
 
-               if(ret < 0)
-                  psrp_chbrk_handler(i,PSRP_CLIENT_TERMINATED);
-            }
+     for(j=0; j<n_exited; ++j)
+     {  for(i=0; i<MAX_CLIENTS; ++i)
+        {  if(psrp_client_pid[i] == exited[j])
+           {  psrp_chbrk_handler(i,PSRP_CLIENT_TERMINATED);
+              break;
+           }
         }
 
 
-        /*--------------------------------------------------*/
-        /* Check that (active) current client is still alive */
-        /*---------------------------------------------------*/
+        /*----------------------------------------*/
+        /* Not a client - reap child (if its exit */
+        /* was not seen by the SIGCHLD handler)   */
+        /*----------------------------------------*/
 
-        do {    ret = pups_statkill(psrp_client_pid[c_client],SIGALIVE);
-                   ++trys;
-           } while(trys < max_trys && ret < 0);
-
-        if(ret < 0)
-           psrp_chbrk_handler(c_client,PSRP_CLIENT_TERMINATED);
+        if(i == MAX_CLIENTS)
+           (void)pups_reap_child(exited[j]);
      }
 
      if(access(channel_name_in,F_OK | R_OK | W_OK)  == (-1))
@@ -3295,8 +3921,7 @@ _PRIVATE void *psrp_find_action_object(char *fname)
        return((void *)NULL);
     }
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-       if(psrp_object_list[i].object_handle != (void *)NULL && psrp_isearch_tag_list(fname,i) >= 0)
+    if((i = psrp_tag_index_lookup(fname)) != (-1))
        {  int32_t init,
                   (*func)(int32_t, char **);
 
@@ -3351,12 +3976,12 @@ _PRIVATE void *psrp_find_action_object(char *fname)
 
 _PRIVATE _BOOLEAN psrp_exec_action_object(const int32_t argc, int32_t *status, const char *argv[])
 
-{   uint32_t i;
+{   int32_t  i,
+             t_index;
 
     _BOOLEAN ret = FALSE;
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-       if(psrp_object_list[i].object_handle != (void *)NULL && psrp_isearch_tag_list(argv[0],i) >= 0)
+    if(argc > 0 && (i = psrp_tag_index_lookup(argv[0])) != (-1))
        {    int32_t init,
                     (*func)(const  int32_t, const char *[]) = (void *)NULL;
 
@@ -3374,8 +3999,19 @@ _PRIVATE _BOOLEAN psrp_exec_action_object(const int32_t argc, int32_t *status, c
                /*---------------------------------*/
 
                case PSRP_STATIC_FUNCTION:
-               case PSRP_DYNAMIC_FUNCTION:  func    = psrp_object_list[i].object_handle;
-                                            *status = (*func)(argc, argv);
+               case PSRP_DYNAMIC_FUNCTION:  if((t_index = psrp_typed_lookup(i)) != (-1))
+                                            {  psrp_typed_args_type args;
+
+                                               *status = psrp_exec_typed_function(t_index,
+                                                                                  argv[0],
+                                                                                  psrp_text_typed_args(psrp_typed_schema[t_index],argc,argv,&args),
+                                                                                  &args);
+                                            }
+                                            else
+                                            {  func    = psrp_object_list[i].object_handle;
+                                               *status = (*func)(argc, argv);
+                                            }
+
                                             ret     = TRUE;
                                             break;
 
@@ -3572,6 +4208,168 @@ _PUBLIC int32_t psrp_new_instance(const _BOOLEAN t_c_instance, const char *insta
 
 
 
+/*--------------------------------------------------------------------*/
+/* Builtin dispatch table. Entries are placed at the (perfect) hash of */
+/* their verb: psrp_hash_tag(verb,PSRP_BUILTIN_HASH_SEED) >>           */
+/* PSRP_BUILTIN_HASH_SHIFT. The seed was found (off line) by search so */
+/* that no two verbs collide -- psrp_init() checks that this is so     */
+/*--------------------------------------------------------------------*/
+
+_PRIVATE const psrp_builtin_type psrp_builtin_table[PSRP_BUILTIN_HASH_SIZE] = {
+
+    #ifdef DLL_SUPPORT
+    [0]   = { "ortab",          psrp_builtin_extend_ortab,                     PSRP_DYNAMIC_FUNCTION },  // Extend (DLL) orifice table
+    #endif /* DLL_SUPPORT */
+    [3]   = { "atexit",         psrp_builtin_pups_show_exit_f,                 0                     },  // Show exit functions for this application
+    [13]  = { "rset",           psrp_builtin_set_rlimit,                       0                     },  // Set resource usage for this server
+    [16]  = { "quantum",        psrp_builtin_set_vitimer_quantum,              0                     },  // Set quantum for PSRP handler
+    [20]  = { "atentrance",     psrp_builtin_pups_show_entrance_f,             0                     },  // Show entrance functions for this application
+    [23]  = { "vitstat",        psrp_builtin_pups_show_vitimers,               0                     },  // Show status of virtual interval timers associated with this application
+    #ifdef SSH_SUPPORT
+    [24]  = { "compress",       psrp_builtin_ssh_compress,                     0                     },  // Set ssh compression mode
+    #endif /* SSH_SUPPORT */
+    [28]  = { "showaliases",    psrp_builtin_showaliases,                      0                     },  // Show the aliases of an attached function of the handler
+    [29]  = { "hinfo",          psrp_builtin_show_hinfo,                       0                     },  // Show host information
+    [30]  = { "log",            psrp_builtin_transactions,                     0                     },  // Builtin to toggle PSRP status logging
+    [33]  = { "clients",        psrp_builtin_show_clients,                     0                     },  // Show clients connected to this server
+    [34]  = { "bindtype",       psrp_builtin_show_psrp_bind_type,              0                     },  // Tell client process the type of PSRP object bindings permitted
+    [39]  = { "bag",            psrp_builtin_attach_dbag,                      0                     },  // Attach a dynamic databag to PSRP dispatch handler
+    [47]  = { "softdog",        psrp_builtin_softdog,                          0                     },  // Enable/disable software watchdog
+    [53]  = { "save",           psrp_builtin_save_dispatch_table,              0                     },  // Save current dispatch table
+    [54]  = { "unschedule",     psrp_builtin_crontab_unschedule,               0                     },  // Remove a scheduling slot from this servers crontab
+    [56]  = { "cstat",          psrp_builtin_show_children,                    0                     },  // Show (active) children of this application
+    #ifdef BUBBLE_MEMORY_SUPPORT
+    [58]  = { "mset",           psrp_builtin_set_mbubble_utilisation_threshold, 0                     },  // Set/show memory bubble utilisation threshold
+    #endif /* BUBBLE_MEMORY_SUPPORT */
+    [60]  = { "show",           psrp_builtin_show_psrp_state,                  0                     },  // Show client current PSRP action bindings
+    [61]  = { "sicstat",        psrp_builtin_show_open_sics,                   0                     },  // Show slaved interation client channels open
+    [63]  = { "load",           psrp_builtin_load_dispatch_table,              0                     },  // Load a new dispatch table
+    [69]  = { "dead",           psrp_builtin_file_dead,                        0                     },  // Unprotect a file or files
+    [76]  = { "hostat",         psrp_builtin_show_htobjects,                   0                     },  // Show tracked heap objects on local heap
+    #ifdef PERSISTENT_HEAP_SUPPORT
+    [84]  = { "htab",           psrp_builtin_extend_htab,                      PSRP_PERSISTENT_HEAP  },  // Extend persistent heap table
+    #endif /* PERSISTENT_HEAP_SUPPORT */
+    [87]  = { "atabort",        psrp_builtin_pups_show_abort_f,                0                     },  // Show abort functions for this application
+    [91]  = { "cronstat",       psrp_builtin_show_crontab,                     0                     },  // Show crontab
+    [94]  = { "cachestat",      psrp_builtin_show_caches,                      0                     },  // Show mapped (fast) caches
+    [98]  = { "new",            psrp_builtin_new_instance,                     0                     },  // Produce new instance of current process
+    [99]  = { "live",           psrp_builtin_file_live,                        0                     },  // Protect a file or files
+    [100] = { "nodetach",       psrp_builtin_set_nodetach,                     0                     },  // Set PSRP server stdio detach on background state
+    [104] = { "chtab",          psrp_builtin_extend_chtab,                     0                     },  // Extend child table
+    [115] = { "autosave",       psrp_builtin_autosave_dispatch_table,          0                     },  // Set automatic dispatch table save status
+    #ifdef PTHREAD_SUPPORT
+    [117] = { "tstart",         psrp_builtin_launch_thread,                    0                     },  // Launch a new thread of execution (bound to named function)
+    #endif /* PTHREAD_SUPPORT */
+    [119] = { "maskstat",       psrp_builtin_show_sigmaskstatus,               0                     },  // Show signal mask/ signals pending for this application
+    [122] = { "sigstat",        psrp_builtin_show_sigstatus,                   0                     },  // Show non default signal handlers installed for this application
+    #ifdef PTHREAD_SUPPORT
+    [125] = { "tcont",          psrp_builtin_restart_thread,                   0                     },  // Restart thread of execution
+    #endif /* PTHREAD_SUPPORT */
+    [128] = { "cwd",            psrp_builtin_set_cwd,                          0                     },  // Set PSRP servers current working directory
+    #ifdef SSH_SUPPORT
+    [135] = { "port",           psrp_builtin_ssh_port,                         0                     },  // Set remote ssh port
+    #endif /* SSH_SUPPORT */
+    [138] = { "pstat",          psrp_builtin_show_procstatus,                  0                     },  // Show status entry in /proc filesystem for this application
+    #ifdef PTHREAD_SUPPORT
+    [139] = { "tstat",          psrp_builtin_show_threads,                     0                     },  // Show all threads running in this PSRP server instance
+    #endif /* PTHREAD_SUPPORT */
+    [141] = { "strys",          psrp_builtin_set_trys,                         0                     },  // Set number of times an operation will be retried (before aborting it)
+    [142] = { "rusage",         psrp_builtin_show_rusage,                      0                     },  // Show resource usage for this server
+    [151] = { "kill",           psrp_builtin_terminate_process,                0                     },  // Client termination of server process
+    #ifdef PSRP_AUTHENTICATE
+    [153] = { "secure",         psrp_builtin_set_secure,                       0                     },  // Change (secure) server authentication token
+    #endif /* PSRP_AUTHENTICATE */
+    [157] = { "alias",          psrp_builtin_alias,                            0                     },  // Alias an attached function of the handler
+    [159] = { "error_handling", psrp_builtin_error_handling,                   0                     },  // Toggle server side error handling on/off
+    [160] = { "schedule",       psrp_builtin_crontab_schedule,                 0                     },  // Add a scheduling slot to this servers crontab
+    [163] = { "overfork",       psrp_builtin_overfork_server_process,          0                     },  // Overfork the current process with new command
+    [166] = { "unalias",        psrp_builtin_unalias,                          0                     },  // Unalias an attached function of the handler
+    [172] = { "pexit",          psrp_builtin_set_pexit,                        0                     },  // Set PSRP servers (effective) parent exit status
+    #ifdef DLL_SUPPORT
+    [173] = { "dll",            psrp_builtin_attach_dynamic_function,          0                     },  // Attach a dynamic function to PSRP dispatch handler
+    #endif /* DLL_SUPPORT */
+    [174] = { "overlay",        psrp_builtin_overlay_server_process,           0                     },  // Overlay the current process with new command
+    #ifdef PTHREAD_SUPPORT
+    [183] = { "tkill",          psrp_builtin_kill_thread,                      0                     },  // Terminate a thread of execution
+    #endif /* PTHREAD_SUPPORT */
+    #ifdef PERSISTENT_HEAP_SUPPORT
+    [188] = { "hstat",          psrp_builtin_show_persistent_heaps,            0                     },  // Show persistent heaps mapped into process address space
+    #endif /* PERSISTENT_HEAP_SUPPORT */
+    [191] = { "vitab",          psrp_builtin_extend_vitab,                     0                     },  // Extend virtual timer table
+    [192] = { "terminate",      psrp_builtin_terminate_process,                0                     },  // Client termination of server process
+    [196] = { "rbag",           psrp_builtin_attach_ring_dbag,                 0                     },  // Attach a dynamic databag (streamed via shared memory ring)
+    [198] = { "parent",         psrp_builtin_set_parent,                       0                     },  // Set PSRP servers (effective) parent
+    [200] = { "appl_verbose",   psrp_builtin_appl_verbose,                     0                     },  // Toggle server transaction logging on/off
+    [201] = { "fstat",          psrp_builtin_show_open_fdescriptors,           0                     },  // Show streams/file descriptors opened by this application
+    #ifdef PTHREAD_SUPPORT
+    [209] = { "tpause",         psrp_builtin_pause_thread,                     0                     },  // Pause thread of execution
+    #endif /* PTHREAD_SUPPORT */
+    #ifdef CRIU_SUPPORT
+    [212] = { "ssave",          psrp_builtin_ssave,                            0                     },  // Enable/disable (Criu) state saving
+    #endif /* CRIU_SUPPORT */
+    [213] = { "latency",        psrp_builtin_latency,                          0                     },  // Show request latency histograms (and control tracing)
+    [223] = { "detach",         psrp_builtin_detach_object,                    0                     },  // Delete action function bound to PSRP handler
+    [229] = { "ftab",           psrp_builtin_extend_ftab,                      0                     },  // Extend file table
+    #ifdef PERSISTENT_HEAP_SUPPORT
+    [231] = { "heap",           psrp_builtin_attach_persistent_heap,           0                     },  // Attach a persistent heap to PSRP dispatch handler
+    #endif /* PERSISTENT_HEAP_SUPPORT */
+    [234] = { "unrooted",       psrp_builtin_set_unrooted,                     0                     },  // Reset PSRP servers system context migration status
+    #ifdef DLL_SUPPORT
+    [235] = { "ostat",          psrp_builtin_show_attached_orifices,           0                     },  // Show orifices which are bound to this application
+    #endif /* DLL_SUPPORT */
+    #ifdef BUBBLE_MEMORY_SUPPORT
+    [236] = { "mstat",          psrp_builtin_show_malloc_stats,                0                     },  // Show malloc statistics
+    #endif /* BUBBLE_MEMORY_SUPPORT */
+    [240] = { "lflstat",        psrp_builtin_show_link_file_locks,             0                     },  // Show concurrently held link file locks
+    [247] = { "reset",          psrp_builtin_reset_dispatch_table,             0                     },  // Reset dispatch table
+    [248] = { "shelp",          psrp_builtin_help,                             0                     },  // Display the builtin commands for this handler
+    [252] = { "rooted",         psrp_builtin_set_rooted,                       0                     },  // Set PSRP servers system context migration status
+    [253] = { "flstat",         psrp_builtin_show_flock_locks,                 0                     },  // Show (flock) locks
+};
+
+
+
+
+/*-------------------------------------------------------*/
+/* Look up builtin by verb (a single probe of the table) */
+/*-------------------------------------------------------*/
+
+_PRIVATE const psrp_builtin_type *psrp_builtin_lookup(const char *verb)
+
+{   const psrp_builtin_type *builtin = (const psrp_builtin_type *)NULL;
+
+    if(verb == (const char *)NULL)
+       return((const psrp_builtin_type *)NULL);
+
+    builtin = &psrp_builtin_table[psrp_hash_tag(verb,PSRP_BUILTIN_HASH_SEED) >> PSRP_BUILTIN_HASH_SHIFT];
+    if(builtin->verb != (const char *)NULL && strcmp(builtin->verb,verb) == 0)
+       return(builtin);
+
+    return((const psrp_builtin_type *)NULL);
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Check that builtin hash is perfect (that every builtin is */
+/* in the slot its verb hashes to)                           */
+/*-----------------------------------------------------------*/
+
+_PRIVATE void psrp_builtin_check(void)
+
+{   uint32_t i;
+
+    for(i=0; i<PSRP_BUILTIN_HASH_SIZE; ++i)
+    {  if(psrp_builtin_table[i].verb != (const char *)NULL && psrp_builtin_lookup(psrp_builtin_table[i].verb) != &psrp_builtin_table[i])
+          pups_error("[psrp_builtin_check] builtin dispatch table is not a perfect hash (regenerate PSRP_BUILTIN_HASH_SEED)");
+    }
+}
+
+
+
+
+
 /*-------------------------------------------------------------------------*/
 /* Parse PSRP request (taking account of the interface which has generated */
 /* the request)                                                            */
@@ -3586,6 +4384,8 @@ _PRIVATE int32_t psrp_parse_request(char *request, const uint32_t interface)
 
 {   uint32_t r_argc;
     int32_t  status;
+
+    const psrp_builtin_type *builtin = (const psrp_builtin_type *)NULL;
     
 
     /*---------------------------------------------*/
@@ -3595,1352 +4395,1432 @@ _PRIVATE int32_t psrp_parse_request(char *request, const uint32_t interface)
     psrp_argvec(&r_argc,request);
 
 
-    /*---------------------------------------------------------------------*/
-    /* The only builtins are detach which removes dynamic entries from the */
-    /* PSRP handler dispatch table and show which shows the functions      */
-    /* currently loaded in the PSRP handler dispatch table.                */
-    /*---------------------------------------------------------------------*/
+    /*--------------------------------------------------------------*/
+    /* Builtins are resolved by (perfect) hash of the request verb, */
+    /* so requests for attached objects are not matched against     */
+    /* every builtin in turn                                        */
+    /*--------------------------------------------------------------*/
 
-    #ifdef PSRP_AUTHENTICATE
-    /*---------------------------------------------*/
-    /* Change (secure) server authentication token */
-    /*---------------------------------------------*/
-    if(psrp_builtin_set_secure(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* PSRP_AUTHENTICATE */
+    if((builtin = psrp_builtin_lookup(r_argv[0])) != (const psrp_builtin_type *)NULL)
+    {  if((builtin->bind_status == 0 || (psrp_bind_status & builtin->bind_status)) &&
+          (*builtin->func)(r_argc,(void *)r_argv) == PSRP_OK                          )
+          goto object_dispatched;
+    }
 
 
-    /*-------------------------------------------------------------------*/
-    /* Set quantum for PSRP handler. The smaller the quantum, the better */
-    /* the response time, but the greater the system loading.            */
-    /*-------------------------------------------------------------------*/
+/*-----------------------------------------------------------------------*/
+/* Search list of user defined action functions bound to current process */
+/*-----------------------------------------------------------------------*/
 
-    else if(psrp_builtin_set_vitimer_quantum(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+re_dispatch:
 
 
-    /*-----------------------*/
-    /* Show host information */
-    /*-----------------------*/
+    /*---------------------------*/
+    /* Process next PSRP command */
+    /*---------------------------*/
 
-    else if(psrp_builtin_show_hinfo(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(psrp_exec_action_object(r_argc,&status,(void *)r_argv) == TRUE)
+    {
 
+       /*--------------------------------------*/
+       /* Command error                        */
+       /* Non zero return code indicates error */
+       /*--------------------------------------*/
 
-    #ifdef BUBBLE_MEMORY_SUPPORT
-    /*----------------------------------------------*/
-    /* Set/show memory bubble utilisation threshold */
-    /*----------------------------------------------*/
+       if(status < 0  && psrp_error_handling == TRUE)
+       {  (void)fprintf(psrp_out,"    Command returned error (%s)\n",r_argv[0]);
+          (void)fflush(psrp_out);
 
-    else if(psrp_builtin_set_mbubble_utilisation_threshold(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+          (void)strlcpy(psrp_c_code,"err",SSIZE);
 
+          if(appl_verbose == TRUE)
+          {  strdate(date);
 
-    /*------------------------*/
-    /* Show malloc statistics */
-    /*------------------------*/
+            (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" error (dispatch failure)\n",
+                                                                                                                date,
+                                                                                                           appl_name,
+                                                                                                            appl_pid,
+                                                                                                           appl_host,
+                                                                                                          appl_owner,
+                                                                                               PSRP_PROTOCOL_VERSION,
+                                                                                                             request);
+            (void)fflush(stderr);
+          }
 
-    else if(psrp_builtin_show_malloc_stats(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* BUBBLE_MEMORY_SUPPORT */
+          goto object_dispatched;
+       }
 
 
-    #ifdef CRIU_SUPPORT
-    /*------------------------------------*/
-    /* Enable/disable (Criu) state saving */
-    /*------------------------------------*/
+       /*-----------------*/
+       /* PSRP command ok */
+       /*-----------------*/
 
-    else if(psrp_builtin_ssave(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* CRIU_SUPPORT */
+       else
+          goto object_dispatched;
+    }
 
 
-    /*----------------------------------*/
-    /* Enable/disable software watchdog */
-    /*----------------------------------*/
+    /*-------------------*/
+    /* Command not found */
+    /*-------------------*/
 
-    else if(psrp_builtin_softdog(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    (void)fprintf(psrp_out,"    Illegal command [%s]\n",r_argv[0]);
+    (void)fflush(psrp_out);
 
+    (void)strlcpy(psrp_c_code,"illcerr",SSIZE);
 
-    /*--------------------------------------------------*/  
-    /* Set PSRP server stdio detach on background state */
-    /*--------------------------------------------------*/  
+    if(appl_verbose == TRUE)
+    {  strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" not recognised (dispatch failure)\n",
+                                                                                                                    date,
+                                                                                                               appl_name,
+                                                                                                                appl_pid,
+                                                                                                               appl_host,
+                                                                                                              appl_owner,
+                                                                                                   PSRP_PROTOCOL_VERSION,
+                                                                                                                 request);
+       (void)fflush(stderr);
+    }
+ 
 
-    else if(psrp_builtin_set_nodetach(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(appl_verbose == TRUE)
+    {  (void)fprintf(psrp_out,"\nPSRP (protocol %5.2F) request \"%s\" dispatch failure (%d@%s)\n\n",
+                                                    PSRP_PROTOCOL_VERSION,request,appl_pid,appl_host);
+       (void)fflush(psrp_out);
+    }
 
+object_dispatched:    
 
-    /*--------------------------------------------------*/
-    /* Set PSRP servers system context migration status */
-    /*--------------------------------------------------*/
+    if(interface == PSRP_FACE)
+    {
 
-    else if(psrp_builtin_set_rooted(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       /*-----------------------------------------------------------------------*/
+       /* Tell client that the request has been processed and reset the handler */
+       /* for future PSRP requests.                                             */
+       /*-----------------------------------------------------------------------*/
 
 
-    /*----------------------------------------------------*/
-    /* Reset PSRP servers system context migration status */
-    /*----------------------------------------------------*/
+       /*--------------------------------------------------------------*/
+       /* If PSRP service function has not returned its own error code */
+       /* simply return "ok"                                           */
+       /*--------------------------------------------------------------*/
 
-    else if(psrp_builtin_set_unrooted(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       if(strncmp(psrp_c_code,"none",4) == 0)
+          (void)strlcpy(psrp_c_code,"ok",SSIZE);
 
 
-    /*-------------------------------------*/
-    /* Set PSRP servers (effective) parent */
-    /*-------------------------------------*/
+       /*------------------------------------------------------*/
+       /* Tell client this request is now processed and return */
+       /* its exit code                                        */
+       /*------------------------------------------------------*/
 
-    else if(psrp_builtin_set_parent(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
+       (void)fflush(psrp_out);
 
 
-    /*-------------------------------------------------*/
-    /* Set PSRP servers (effective) parent exit status */
-    /*-------------------------------------------------*/
+       /*------------------------------------------------------*/
+       /* Tell client that we have finished processing SIGPSRP */
+       /*------------------------------------------------------*/
 
-    else if(psrp_builtin_set_pexit(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;  
+       psrp_endop("psrp");
+    }
+}
 
 
-    /*--------------------------------------------*/
-    /* Set PSRP servers current working directory */
-    /*--------------------------------------------*/
 
-    else if(psrp_builtin_set_cwd(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
+/*-------------------------------------------------*/
+/* Monotonic time (microseconds) for request spans */
+/*-------------------------------------------------*/
 
-    /*-----------------------------------------------------------------------*/               
-    /* Set number of times an operation will be retried (before aborting it) */
-    /*-----------------------------------------------------------------------*/               
+_PRIVATE uint64_t psrp_latency_now(void)
 
-    else if(psrp_builtin_set_trys(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+{   struct timespec ts;
 
+    (void)clock_gettime(CLOCK_MONOTONIC,&ts);
+    return((uint64_t)ts.tv_sec*1000000 + (uint64_t)ts.tv_nsec/1000);
+}
 
-    /*-------------------------*/         
-    /* Protect a file or files */
-    /*-------------------------*/         
 
-    else if(psrp_builtin_file_live(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*---------------------------*/
-    /* Unprotect a file or files */
-    /*---------------------------*/
+/*----------------------------------------------------------------*/
+/* Log-linear (HDR style) histogram bucket for latency (and the   */
+/* smallest latency held by a bucket)                             */
+/*----------------------------------------------------------------*/
 
-    else if(psrp_builtin_file_dead(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+_PRIVATE uint32_t psrp_hist_bucket(uint64_t value)
 
+{   uint32_t shift;
 
-    /*-------------------------------------*/
-    /* Show resource usage for this server */
-    /*-------------------------------------*/
+    if(value > UINT32_MAX)
+       value = UINT32_MAX;
 
-    else if(psrp_builtin_show_rusage(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(value < PSRP_HIST_SUB_BUCKETS)
+       return((uint32_t)value);
 
+    shift = 63 - __builtin_clzll(value) - PSRP_HIST_SUB_BITS;
+    return(((shift + 1) << PSRP_HIST_SUB_BITS) + (uint32_t)(value >> shift) - PSRP_HIST_SUB_BUCKETS);
+}
 
-    /*------------------------------------*/
-    /* Set resource usage for this server */
-    /*------------------------------------*/
 
-    else if(psrp_builtin_set_rlimit(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+_PRIVATE uint64_t psrp_hist_bucket_value(const uint32_t bucket)
 
+{   uint32_t shift;
 
-    /*------------------------------------------*/
-    /* Toggle server transaction logging on/off */
-    /*------------------------------------------*/
+    if(bucket < PSRP_HIST_SUB_BUCKETS)
+       return((uint64_t)bucket);
 
-    else if(psrp_builtin_appl_verbose(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    shift = (bucket >> PSRP_HIST_SUB_BITS) - 1;
+    return((uint64_t)((bucket & (PSRP_HIST_SUB_BUCKETS - 1)) + PSRP_HIST_SUB_BUCKETS) << shift);
+}
 
 
-    /*------------------------------------------*/
-    /* Toggle server side error handling on/off */
-    /*------------------------------------------*/
-
-    else if(psrp_builtin_error_handling(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-
-
-    /*---------------------------------------*/
-    /* Builtin to toggle PSRP status logging */
-    /*---------------------------------------*/
-
-    else if(psrp_builtin_transactions(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-
 
-    /*-=---------------------------------------------*/
-    /* Add a scheduling slot to this servers crontab */
-    /*-=---------------------------------------------*/
 
-    else if(psrp_builtin_crontab_schedule(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+/*-------------------------------------------*/
+/* Add sample (microseconds) to histogram    */
+/*-------------------------------------------*/
 
+_PRIVATE void psrp_hist_add(psrp_hist_type *hist, const uint64_t value)
 
-    /*----------------------------------------------------*/
-    /* Remove a schedulign slot from this servers crontab */
-    /*----------------------------------------------------*/
+{   if(hist->count == 0 || value < hist->min)
+       hist->min = value;
 
-    else if(psrp_builtin_crontab_unschedule(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(value > hist->max)
+       hist->max = value;
 
+    ++hist->count;
+    hist->sum += value;
+    ++hist->bucket[psrp_hist_bucket(value)];
+}
 
-    /*--------------*/
-    /* Show crontab */
-    /*--------------*/
 
-    else if(psrp_builtin_show_crontab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
-    /*----------------------------------------------*/
-    /* Delete action function bound to PSRP handler */
-    /*----------------------------------------------*/
 
-    else if(psrp_builtin_detach_object(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+/*--------------------------------------------------------------*/
+/* Value at percentile of histogram (upper bound of the bucket  */
+/* holding it, clamped to the largest sample seen)              */
+/*--------------------------------------------------------------*/
 
+_PRIVATE uint64_t psrp_hist_percentile(const psrp_hist_type *hist, const double percentile)
 
-    /*------------------------------------------*/
-    /* Set automatic dispatch table save status */
-    /*------------------------------------------*/
+{   uint32_t i;
+    uint64_t seen   = 0,
+             target,
+             value;
 
-    else if(psrp_builtin_autosave_dispatch_table(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(hist->count == 0)
+       return(0);
 
+    if((target = (uint64_t)((double)hist->count*percentile/100.0 + 0.5)) == 0)
+       target = 1;
 
-    /*---------------------------------------------------------------*/
-    /* Load a new dispatch table. If the new dispatch table contains */
-    /* PSRP objects with the same name(s) as existing objects, the   */
-    /* new objects will overwrite the old                            */
-    /*---------------------------------------------------------------*/
+    for(i=0; i<PSRP_HIST_BUCKETS; ++i)
+    {  if((seen += hist->bucket[i]) >= target)
+       {  value = psrp_hist_bucket_value(i + 1) - 1;
 
-    else if(psrp_builtin_load_dispatch_table(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+          if(value > hist->max)
+             return(hist->max);
 
+          return(value);
+       }
+    }
 
-    /*-----------------------------*/  
-    /* Save current dispatch table */
-    /*-----------------------------*/  
+    return(hist->max);
+}
 
-    else if(psrp_builtin_save_dispatch_table(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*------------------------------------------*/  
-    /* Show client current PSRP action bindings */ 
-    /*------------------------------------------*/  
 
-    else if(psrp_builtin_show_psrp_state(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+/*-----------------------------------------------------------------*/
+/* Find (or add) latency histograms for verb. When the table is    */
+/* full, new verbs are accumulated as "other"                      */
+/*-----------------------------------------------------------------*/
 
+_PRIVATE psrp_latency_type *psrp_latency_verb_entry(const char *verb)
 
-    /*----------------------*/
-    /* Reset dispatch table */
-    /*----------------------*/
+{   uint32_t i,
+             index;
 
-    else if(psrp_builtin_reset_dispatch_table(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    index = psrp_hash_tag(verb,0) & (PSRP_LATENCY_VERBS - 1);
+    for(i=0; i<PSRP_LATENCY_VERBS; ++i)
+    {  psrp_latency_type *entry = &psrp_latency_verb[(index + i) & (PSRP_LATENCY_VERBS - 1)];
 
+       if(entry->verb[0] == '\0')
+       {  (void)strlcpy(entry->verb,verb,PSRP_LATENCY_VERB_SIZE);
+          return(entry);
+       }
 
-    /*----------------------------------------------------------------*/
-    /* Tell client process the type of PSRP object bindings permitted */
-    /*----------------------------------------------------------------*/
+       if(strcmp(entry->verb,verb) == 0)
+          return(entry);
+    }
 
-    else if(psrp_builtin_show_psrp_bind_type(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(psrp_latency_other.verb[0] == '\0')
+       (void)strlcpy(psrp_latency_other.verb,"other",PSRP_LATENCY_VERB_SIZE);
 
+    return(&psrp_latency_other);
+}
 
-    /*-----------------------------------------------*/
-    /* Display the builtin commands for this handler */
-    /*-----------------------------------------------*/
 
-    else if(psrp_builtin_help(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*----------------------------------------*/
-    /* Show concurrently held link file locks */
-    /*----------------------------------------*/
+#ifdef PTHREAD_SUPPORT
+/*-------------------------------------------------------------*/
+/* Lock latency histograms. They are updated by worker threads */
+/* and by the root thread (from the PSRP handler), so signals  */
+/* must be blocked while we hold the lock                      */
+/*-------------------------------------------------------------*/
 
-    else if(psrp_builtin_show_link_file_locks(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+_PRIVATE void psrp_latency_lock(sigset_t *old_set)
 
+{   sigset_t set;
 
-    /*--------------------*/
-    /* Show (flock) locks */
-    /*--------------------*/
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_BLOCK,&set,old_set);
+    (void)pthread_mutex_lock(&psrp_latency_mutex);
+}
 
-    else if(psrp_builtin_show_flock_locks(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*-----------------------------------------------------------------*/
-    /* Show non default signal handlers installed for this application */
-    /*-----------------------------------------------------------------*/
 
-    else if(psrp_builtin_show_sigstatus(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+/*---------------------------------------------*/
+/* Unlock latency histograms                   */
+/*---------------------------------------------*/
 
+_PRIVATE void psrp_latency_unlock(const sigset_t *old_set)
 
-    /*--------------------------------------------------------*/
-    /* Show signal mask/ signals pending for this application */
-    /*--------------------------------------------------------*/
+{   (void)pthread_mutex_unlock(&psrp_latency_mutex);
+    (void)pthread_sigmask(SIG_SETMASK,old_set,(sigset_t *)NULL);
+}
+#endif /* PTHREAD_SUPPORT */
 
-    else if(psrp_builtin_show_sigmaskstatus(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*----------------------------------------------------------*/
-    /* Show streams/file descriptors opened by this application */
-    /*----------------------------------------------------------*/
 
-    else if(psrp_builtin_show_open_fdescriptors(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+/*------------------------------------------------------------------*/
+/* Record latency of (completed) request. Times are microseconds    */
+/* (psrp_latency_now), a phase which was not measured is passed as  */
+/* zero and is not recorded. May be called by any thread            */
+/*------------------------------------------------------------------*/
 
+_PRIVATE void psrp_latency_record(const char     *request,   // Request (verb is first token)
+                                  const int32_t  client,     // Client slot
+                                  const uint32_t seq,        // Request sequence number
+                                  const uint64_t queued,     // Time request was queued
+                                  const uint64_t started,    // Time dispatch started
+                                  const uint64_t dispatched, // Time dispatch finished
+                                  const uint64_t written)    // Time reply written
 
-    /*--------------------------------------------*/
-    /* Show (active) children of this application */
-    /*--------------------------------------------*/
+{   uint32_t          i;
+    int64_t           duration[PSRP_LATENCY_PHASES];
+    char              verb[PSRP_LATENCY_VERB_SIZE] = "";
+    psrp_latency_type *entry                       = (psrp_latency_type *)NULL;
 
-    else if(psrp_builtin_show_children(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    #ifdef PTHREAD_SUPPORT
+    sigset_t          old_set;
+    #endif /* PTHREAD_SUPPORT */
 
+    (void)sscanf(request,"%31s",verb);
+    if(verb[0] == '\0')
+       (void)strlcpy(verb,"<none>",PSRP_LATENCY_VERB_SIZE);
 
-    /*---------------------------*/
-    /* Show mapped (fast) caches */
-    /*---------------------------*/
+    duration[PSRP_LATENCY_QUEUE]    = (queued  != 0 && started    >= queued)     ? (int64_t)(started - queued)        : (-1);
+    duration[PSRP_LATENCY_DISPATCH] = (started != 0 && dispatched >= started)    ? (int64_t)(dispatched - started)    : (-1);
+    duration[PSRP_LATENCY_WRITE]    = (written != 0 && written    >= dispatched) ? (int64_t)(written - dispatched)    : (-1);
 
-    else if(psrp_builtin_show_caches(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
+    entry = psrp_latency_verb_entry(verb);
+    for(i=0; i<PSRP_LATENCY_PHASES; ++i)
+    {  if(duration[i] >= 0)
+       {  psrp_hist_add(&entry->phase[i],(uint64_t)duration[i]);
 
-    #ifdef DLL_SUPPORT
-    /*---------------------------------------------------*/
-    /* Show orifices which are bound to this application */
-    /*---------------------------------------------------*/
+          if(client >= 0 && client < MAX_CLIENTS)
+             psrp_hist_add(&psrp_latency_client[client].phase[i],(uint64_t)duration[i]);
+       }
+    }
 
-    else if(psrp_builtin_show_attached_orifices(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* DLL_SUPPORT */
 
+    /*------------------------------------------------*/
+    /* Trace span (overwriting oldest if ring is full) */
+    /*------------------------------------------------*/
 
-    #ifdef PTHREAD_SUPPORT 
-    /*-------------------------------------------------------*/
-    /* Show all threads running in this PSRP server instance */
-    /*-------------------------------------------------------*/
+    if(psrp_trace != (psrp_trace_span_type *)NULL)
+    {  psrp_trace_span_type *span = &psrp_trace[psrp_trace_spans++ % PSRP_TRACE_SPANS];
 
-    else if(psrp_builtin_show_threads(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       (void)strlcpy(span->verb,verb,PSRP_LATENCY_VERB_SIZE);
+       span->client = client;
+       span->seq    = seq;
+       span->start  = (queued != 0) ? queued : started;
 
+       for(i=0; i<PSRP_LATENCY_PHASES; ++i)
+          span->duration[i] = duration[i];
+    }
 
-    /*------------------------------------------------------------*/
-    /* Launch a new thread of execution (bound to named function) */
-    /*------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
+}
 
-    else if(psrp_builtin_launch_thread(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    /*---------------------------------*/
-    /* Terminate a thread of execution */
-    /*---------------------------------*/
 
-    else if(psrp_builtin_kill_thread(r_argc,(void *)r_argv) == PSRP_OK)
-      goto object_dispatched;
+/*-----------------------------------------------------------*/
+/* Reset latency histograms of client slot (slot is re-used) */
+/*-----------------------------------------------------------*/
 
+_PRIVATE void psrp_latency_reset_client(const int32_t client)
 
-    /*---------------------------*/
-    /* Pause thread of execution */
-    /*---------------------------*/
+{
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-    else if(psrp_builtin_pause_thread(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(client < 0 || client >= MAX_CLIENTS)
+       return;
 
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    /*-----------------------------*/
-    /* Restart thread of execution */
-    /*-----------------------------*/
+    (void)memset((void *)&psrp_latency_client[client],0,sizeof(psrp_latency_type));
 
-    else if(psrp_builtin_restart_thread(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_unlock(&old_set);
     #endif /* PTHREAD_SUPPORT */
+}
 
 
-    /*---------------------------------------------*/
-    /* Show slaved interation client channels open */
-    /*---------------------------------------------*/
 
-    else if(psrp_builtin_show_open_sics(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
+/*---------------------------------------------------------------*/
+/* PSRP hander routine - handles process status request protocol */
+/* [PSRP] interrupts                                             */
+/*---------------------------------------------------------------*/
 
-    /*----------------------------------------------*/
-    /* Show entrance functions for this application */
-    /*----------------------------------------------*/
+_PRIVATE int32_t psrp_handler(const int32_t signum)
 
-    else if(psrp_builtin_pups_show_entrance_f(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+{   int32_t  i,
+             idum,
+             r_argc,
+             status;
 
+    uint64_t started;
 
-    /*------------------------------------------*/
-    /* Show exit functions for this application */
-    /*------------------------------------------*/
+    char     request[SSIZE]             = "",
+             get_object_command[SSIZE]  = "",
+             psrp_channel_name[SSIZE]   = "",
+             request_str[SSIZE]         = "",
+             psrp_ckpt_status[SSIZE]    = "";
 
-    else if(psrp_builtin_pups_show_exit_f(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    sigset_t set;
 
 
-    /*-------------------------------------------*/
-    /* Show abort functions for this application */
-    /*-------------------------------------------*/
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB IN PSRP HANDLER\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+
 
-    else if(psrp_builtin_pups_show_abort_f(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    /*-----------------------------------------------------*/
+    /* Sometimes, because of latency, we can get a SIGPSRP */
+    /* raised in psrp_new_segment - this is spurious and   */
+    /* must not be processed                               */
+    /*-----------------------------------------------------*/
 
+    if(in_psrp_new_segment == TRUE)
+       return(0);
 
-    /*------------------------------------------------------------*/
-    /* Show status entry in /proc filesystem for this application */
-    /*------------------------------------------------------------*/
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB SIGPSRP\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
 
-    else if(psrp_builtin_show_procstatus(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
+    /*-----------------------------------------------------*/
+    /* Environment restore if SIGABRT recieved by process. */
+    /*-----------------------------------------------------*/
 
-    /*---------------------------------------*/
-    /* Show clients connected to this server */
-    /*---------------------------------------*/
+    ++psrp_transactions[c_client];
 
-    else if(psrp_builtin_show_clients(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB CCLIENT:%d, CNT:%d\n",c_client,psrp_transactions[c_client]);
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
 
+    if(sigsetjmp(psrp_env,1) > 0)
+    {
+ 
+       #ifdef PSRPLIB_DEBUG
+       (void)fprintf(stderr,"PSRPLIB SIGPSRP3 (ABORT)\n");
+       (void)fflush(stderr);
+       #endif /* PSRPLIB_DEBUG */
 
-    /*-------------------------------------------------------------------------*/
-    /* Show status of virtual interval timers associated with this application */
-    /*-------------------------------------------------------------------------*/
+       if(psrp_current_sic != (psrp_channel_type *)NULL)
+       {  psrp_destroy_slaved_interaction_client(psrp_current_sic,TRUE);
+          psrp_unset_current_sic();
+       }
 
-    else if(psrp_builtin_pups_show_vitimers(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
+       /*-----------------------*/
+       /* Close PSRP connection */
+       /*-----------------------*/
 
-    /*-------------------------------------------*/
-    /* Alias an attached function of the handler */
-    /*-------------------------------------------*/
+       if(psrp_in != (FILE *)NULL)
+       {  (void)psrp_empty_fifo(fileno(psrp_in));
+          psrp_in  = pups_fclose(psrp_in);
+       }
 
-    else if(psrp_builtin_alias(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       if(psrp_out != (FILE *)NULL)
+       {  (void)psrp_empty_fifo(fileno(psrp_out));
+          psrp_out = pups_fclose(psrp_out);
+       }
 
+       in_psrp_handler     = FALSE;
 
-    /*---------------------------------------------*/
-    /* Unalias an attached function of the handler */
-    /*---------------------------------------------*/
 
-    else if(psrp_builtin_unalias(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       /*--------------------------------------------------*/
+       /* Make sure that virtual timer system is restarted */
+       /* after PSRP request is aborted                    */
+       /*(void)pupsigrelse(SIGALRM);                       */
+       /*--------------------------------------------------*/
 
+       (void)pups_malarm(1);
 
-    /*---------------------------------------------------------*/   
-    /* Show the aliases of an attached function of the handler */
-    /*---------------------------------------------------------*/   
+       #ifdef PSRPLIB_DEBUG
+       (void)fprintf(stderr,"ABORT EXIT\n");
+       (void)fflush(stderr);
+       #endif /* PSRPLIB_DEBUG */
+  
+       return(0);
+    }
 
-    else if(psrp_builtin_showaliases(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    in_psrp_handler = TRUE;
+    (void)strlcpy(psrp_c_code,"none",SSIZE);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGABRT);
+    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
 
 
-    /*--------------------*/
-    /* Extend child table */
-    /*--------------------*/
+    /*------------------------------------------------------------------------*/
+    /* Tell PSRP client that this process supports the PSRP protocol and will */
+    /* provide status information to the PSRP client.                         */
+    /*------------------------------------------------------------------------*/
 
-    else if(psrp_builtin_extend_chtab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB SIGPSRP2\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+ 
 
+    (void)snprintf(psrp_channel_name,SSIZE,"%s/psrp#%s#%d#%d",appl_fifo_dir,appl_name,appl_pid,getuid());
+    (void)fprintf(psrp_out,"(%s)\n",psrp_channel_name);
+    (void)fflush(psrp_out);
 
-    /*----------------------------*/
-    /* Extend virtual timer table */
-    /*----------------------------*/
 
-    else if(psrp_builtin_extend_vitab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    /*-----------------------------------------------------------------------*/
+    /* Read request string from client - this is used by the client to tell  */
+    /* the handler which PSRP action function it wishes to be dispatched on  */
+    /* its behalf.                                                           */
+    /*-----------------------------------------------------------------------*/
 
+    (void)fgets(request,SSIZE,psrp_in);
+    (void)strlcpy(request_str,request,SSIZE);
+    request_str[pups_strlen(request_str) - 2] = '\0';
 
-    /*-------------------*/
-    /* Extend file table */
-    /*-------------------*/
 
-    else if(psrp_builtin_extend_ftab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    /*---------------------------------------------------------*/
+    /* FIFO replies are written as the request is dispatched,  */
+    /* so only dispatch time is recorded                       */
+    /*---------------------------------------------------------*/
 
+    started = psrp_latency_now();
+    psrp_service_request(request_str);
+    psrp_latency_record(request_str,c_client,0,0,started,psrp_latency_now(),0);
 
-    #ifdef PERSISTENT_HEAP_SUPPORT
-    /*--------------------------*/
-    /* Extend persistent heap table */
-    /*--------------------------*/
-    else if(psrp_bind_status & PSRP_PERSISTENT_HEAP && psrp_builtin_extend_htab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* PERSISTENT_HEAP_SUPPORT */
+    psrp_in  = pups_fclose(psrp_in);
+    psrp_out = pups_fclose(psrp_out);
 
+    in_psrp_handler = FALSE;
+    return(0);
+}
 
-    #ifdef DLL_SUPPORT
-    /*----------------------------*/
-    /* Extend (DLL) orifice table */
-    /*----------------------------*/
 
-    else if(psrp_bind_status & PSRP_DYNAMIC_FUNCTION &&  psrp_builtin_extend_ortab(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* DLL_SUPPORT */
 
 
-    /*-----------------------------------------*/
-    /* Produce new instance of current process */
-    /*-----------------------------------------*/
+/*-------------------------------------------------------------------*/
+/* Authenticate, log and dispatch a PSRP request. The reply is sent  */
+/* to psrp_out, which is either the PSRP output FIFO, or the reply   */
+/* buffer of a socket transport session                              */
+/*-------------------------------------------------------------------*/
 
-    else if(psrp_builtin_new_instance(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+_PRIVATE void psrp_service_request(char *request_str)
 
+{
 
+    #ifdef PSRP_AUTHENTICATE
     /*----------------------------------------------*/
-    /* Overlay the current process with new command */
+    /* Authenticate from psrp_passwd here if secure */
     /*----------------------------------------------*/
 
-    else if(psrp_builtin_overlay_server_process(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-
-
-    /*-----------------------------------------------*/
-    /* Overfork the current process with new command */
-    /*-----------------------------------------------*/
-
-    else if(psrp_builtin_overfork_server_process(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(appl_secure == TRUE && pups_check_appl_password(psrp_password) == FALSE)
+    {  (void)fprintf(psrp_out,"\nSecure server authentication failure (PSRP connection closed)\n\n");
+       (void)fflush(psrp_out);
 
+       if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): secure server authentication failure [client %s (%d@localhost)]\n",
+                                                                                                                   date,
+                                                                                                              appl_name,
+                                                                                                               appl_pid,
+                                                                                                              appl_host,
+                                                                                                             appl_owner,
+                                                                                             psrp_client_name[c_client],
+                                                                                              psrp_client_pid[c_client]);
+          else
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): secure server authentication failure [client %s (%d@%s)]\n",
+                                                                                                            date,
+                                                                                                       appl_name,
+                                                                                                        appl_pid,
+                                                                                                       appl_host,
+                                                                                                      appl_owner,
+                                                                                      psrp_client_name[c_client],
+                                                                                       psrp_client_pid[c_client],
+                                                                                  psrp_remote_hostpath[c_client]);
+          (void)fflush(stderr);
+       }
 
-    #ifdef DLL_SUPPORT
-    /*----------------------------------------------------*/
-    /* Attach a dynamic function to PSRP dispatch handler */
-    /*----------------------------------------------------*/
-    else if(psrp_builtin_attach_dynamic_function(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* DLL_SUPPORT */
+       /*------------------------------------------------------*/
+       /* Tell client this request is now processed and return */
+       /* its exit code                                        */
+       /*------------------------------------------------------*/
 
+       (void)fprintf(psrp_out,"EOT safail\n");
+       (void)fflush(psrp_out);
 
-    /*---------------------------------------------------*/
-    /* Attach a dynamic databag to PSRP dispatch handler */
-    /*---------------------------------------------------*/
 
-    else if(psrp_builtin_attach_dbag(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+       /*------------------------------------------------------*/
+       /* Tell client that we have finished processing SIGPSRP */
+       /*------------------------------------------------------*/
 
+       psrp_endop("psrp");
+       return;
+    }
+    #endif /* PSRP_AUTHENTICATE */
 
-    #ifdef PERSISTENT_HEAP_SUPPORT
-    /*---------------------------------------------------*/
-    /* Attach a persistent heap to PSRP dispatch handler */
-    /*---------------------------------------------------*/
 
-    else if(psrp_builtin_attach_persistent_heap(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    if(psrp_log[c_client] == TRUE && strncmp(request_str,"secure",6) != 0)
+    {  if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
+          (void)fprintf(psrp_out,
+                         "\nPSRP (protocol %5.2F) request \"%s\" received by %s (%d@%s:%s) from %s (%d@%s)\n\n",
+                                                                                          PSRP_PROTOCOL_VERSION,
+                                                                                          request_str,appl_name,
+                                                                                  appl_pid,appl_host,appl_owner,
+                                                                                     psrp_client_name[c_client],
+                                                                                      psrp_client_pid[c_client],
+                                                                                     psrp_client_host[c_client]);
+        else
+           (void)fprintf(psrp_out,
+                          "\nPSRP (protocol %5.2F) request \"%s\" received by %s (%d@%s:%s) from %s (%d@%s) [from %s]\n\n",
+                                                                                                     PSRP_PROTOCOL_VERSION,
+                                                                                                     request_str,appl_name,
+                                                                                             appl_pid,appl_host,appl_owner,
+                                                                                                psrp_client_name[c_client],
+                                                                                                 psrp_client_pid[c_client],
+                                                                                                psrp_client_host[c_client],
+                                                                                            psrp_remote_hostpath[c_client]);
+        (void)fflush(psrp_out);
+    }
 
+    if(appl_verbose == TRUE && strncmp(request_str,"secure",6) != 0)
+    {  strdate(date);
 
-    /*---------------------------------------------------------*/
-    /* Show persistent heaps mapped into process address space */
-    /*---------------------------------------------------------*/
+       if(strcmp(request_str,old_request_str[c_client]) != 0)
+       {  if(req_r_cnt[c_client] > 0)
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) last request repeated %d times\n",
+                                                                                                        date,
+                                                                                                   appl_name,
+                                                                                                    appl_pid,
+                                                                                                   appl_host,
+                                                                                                  appl_owner,
+                                                                                       PSRP_PROTOCOL_VERSION,
+                                                                                     req_r_cnt[c_client] + 1);
 
-    else if(psrp_builtin_show_persistent_heaps(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* PERSISTENT_HEAP_SUPPORT */
+          if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" received from %s (%d@%s)\n",
+                                                                                                                 date,
+                                                                                                            appl_name,
+                                                                                                             appl_pid,
+                                                                                                            appl_host,
+                                                                                                           appl_owner,
+                                                                                                PSRP_PROTOCOL_VERSION,
+                                                                                                          request_str,
+                                                                                           psrp_client_name[c_client],
+                                                                                            psrp_client_pid[c_client],
+                                                                                           psrp_client_host[c_client]);
+          else
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" received from %s (%d@%s) [from %s]\n",
+                                                                                                                           date,
+                                                                                                                      appl_name,
+                                                                                                                       appl_pid,
+                                                                                                                      appl_host,
+                                                                                                                     appl_owner,
+                                                                                                          PSRP_PROTOCOL_VERSION,
+                                                                                                                    request_str,
+                                                                                                     psrp_client_name[c_client],
+                                                                                                      psrp_client_pid[c_client],
+                                                                                                     psrp_client_host[c_client],
+                                                                                                 psrp_remote_hostpath[c_client]);
+          req_r_cnt[c_client] = 0;
+       }
+       else
+          ++req_r_cnt[c_client];
 
+       (void)fflush(stderr);
+       (void)strlcpy(old_request_str[c_client],request_str,SSIZE);
+    }
 
-    /*-----------------------------------------*/ 
-    /* Show tracked heap objects on local heap */
-    /*-----------------------------------------*/ 
 
-    else if(psrp_builtin_show_htobjects(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+    /*----------------------------------------------------------------------------*/
+    /* Parse PSRP request (noting request has been originated by a client talking */
+    /* PSRP protocols).                                                           */
+    /*----------------------------------------------------------------------------*/
 
+    psrp_parse_request(request_str,PSRP_FACE);
+}
 
-    /*--------------------------------------*/ 
-    /* Client termination of server process */
-    /*--------------------------------------*/ 
 
-    else if(psrp_builtin_terminate_process(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
 
 
-    #ifdef SSH_SUPPORT
-    /*--------------------------*/
-    /* Set ssh compression mode */
-    /*--------------------------*/
+/*--------------------------------------------------------------------*/
+/* Create socket transport listener. Activity on the listener (and on */
+/* its sessions) is signalled to the server via SIGPSRPIO, so socket  */
+/* requests are serviced in the same (signal) context as FIFO ones.   */
+/* If we have thread support, psrp_sock_start() then hands the        */
+/* listener over to an (epoll) event loop thread                      */
+/*--------------------------------------------------------------------*/
 
-    else if(psrp_builtin_ssh_compress(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
+_PRIVATE int32_t psrp_sock_listen(void)
 
+{   uint32_t           i;
+    struct sockaddr_un addr;
 
-    /*---------------------*/
-    /* Set remote ssh port */
-    /*---------------------*/
+    for(i=0; i<MAX_CLIENTS; ++i)
+    {  psrp_sock_des[i]    = (-1);
+       psrp_sock_client[i] = (-1);
+       psrp_sock_pid[i]      = (-1);
+       psrp_sock_peer_pid[i] = (-1);
+       psrp_sock_gen[i]      = 0;
 
-    else if(psrp_builtin_ssh_port(r_argc,(void *)r_argv) == PSRP_OK)
-       goto object_dispatched;
-    #endif /* SSH_SUPPORT */
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_init(&psrp_sock_send_mutex[i],(pthread_mutexattr_t *)NULL);
+       #endif /* PTHREAD_SUPPORT */
+    }
 
+    (void)snprintf(psrp_socket_name,SSIZE,"%s/psrp#%s#sock#%d#%d",appl_fifo_dir,appl_ch_name,appl_pid,appl_uid);
+    if((size_t)pups_strlen(psrp_socket_name) >= sizeof(addr.sun_path))
+    {  pups_set_errno(ENAMETOOLONG);
+       return(-1);
+    }
 
-/*-----------------------------------------------------------------------*/
-/* Search list of user defined action functions bound to current process */
-/*-----------------------------------------------------------------------*/
+    (void)memset((void *)&addr,0,sizeof(struct sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    (void)strlcpy(addr.sun_path,psrp_socket_name,sizeof(addr.sun_path));
 
-re_dispatch:
 
+    /*---------------------------------------------------------*/
+    /* Remove any stale socket left by an earlier segment of   */
+    /* this server (segmentation preserves the server pid)     */
+    /*---------------------------------------------------------*/
 
-    /*---------------------------*/
-    /* Process next PSRP command */
-    /*---------------------------*/
+    (void)unlink(psrp_socket_name);
 
-    if(psrp_exec_action_object(r_argc,&status,(void *)r_argv) == TRUE)
-    {
+    if((psrp_listen_des = socket(AF_UNIX,SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC,0)) == (-1))
+       return(-1);
 
-       /*--------------------------------------*/
-       /* Command error                        */
-       /* Non zero return code indicates error */
-       /*--------------------------------------*/
+    if(bind(psrp_listen_des,(struct sockaddr *)&addr,sizeof(struct sockaddr_un)) == (-1) ||
+       chmod(psrp_socket_name,0600)                                              == (-1) ||
+       listen(psrp_listen_des,MAX_CLIENTS)                                        == (-1) ||
+       fcntl(psrp_listen_des,F_SETOWN,appl_pid)                                   == (-1) ||
+       fcntl(psrp_listen_des,F_SETSIG,SIGPSRPIO)                                  == (-1) ||
+       fcntl(psrp_listen_des,F_SETFL,O_NONBLOCK | O_ASYNC)                        == (-1)  )
+    {  int32_t errno_save = errno;
 
-       if(status < 0  && psrp_error_handling == TRUE)
-       {  (void)fprintf(psrp_out,"    Command returned error (%s)\n",r_argv[0]);
-          (void)fflush(psrp_out);
+       (void)close(psrp_listen_des);
+       (void)unlink(psrp_socket_name);
+       psrp_listen_des = (-1);
 
-          (void)strlcpy(psrp_c_code,"err",SSIZE);
+       pups_set_errno(errno_save);
+       return(-1);
+    }
 
-          if(appl_verbose == TRUE)
-          {  strdate(date);
+    pups_set_errno(OK);
+    return(0);
+}
 
-            (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" error (dispatch failure)\n",
-                                                                                                                date,
-                                                                                                           appl_name,
-                                                                                                            appl_pid,
-                                                                                                           appl_host,
-                                                                                                          appl_owner,
-                                                                                               PSRP_PROTOCOL_VERSION,
-                                                                                                             request);
-            (void)fflush(stderr);
-          }
 
-          goto object_dispatched;
-       }
 
 
-       /*-----------------*/
-       /* PSRP command ok */
-       /*-----------------*/
+#ifdef PTHREAD_SUPPORT
+/*-------------------------------------------------------------*/
+/* Lock socket transport session table. The SIGPSRPIO handler  */
+/* takes the same lock on the root thread, so signals must be  */
+/* blocked while we hold it (as for the crontab lock)          */
+/*-------------------------------------------------------------*/
 
-       else
-          goto object_dispatched;
-    }
+_PRIVATE void psrp_sock_lock(sigset_t *old_set)
 
+{   sigset_t set;
 
-    /*-------------------*/
-    /* Command not found */
-    /*-------------------*/
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_BLOCK,&set,old_set);
+    (void)pthread_mutex_lock(&psrp_sock_mutex);
+}
 
-    (void)fprintf(psrp_out,"    Illegal command [%s]\n",r_argv[0]);
-    (void)fflush(psrp_out);
 
-    (void)strlcpy(psrp_c_code,"illcerr",SSIZE);
 
-    if(appl_verbose == TRUE)
-    {  strdate(date);
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" not recognised (dispatch failure)\n",
-                                                                                                                    date,
-                                                                                                               appl_name,
-                                                                                                                appl_pid,
-                                                                                                               appl_host,
-                                                                                                              appl_owner,
-                                                                                                   PSRP_PROTOCOL_VERSION,
-                                                                                                                 request);
-       (void)fflush(stderr);
-    }
- 
 
-    if(appl_verbose == TRUE)
-    {  (void)fprintf(psrp_out,"\nPSRP (protocol %5.2F) request \"%s\" dispatch failure (%d@%s)\n\n",
-                                                    PSRP_PROTOCOL_VERSION,request,appl_pid,appl_host);
-       (void)fflush(psrp_out);
-    }
+/*---------------------------------------------*/
+/* Unlock socket transport session table       */
+/*---------------------------------------------*/
 
-object_dispatched:    
+_PRIVATE void psrp_sock_unlock(const sigset_t *old_set)
 
-    if(interface == PSRP_FACE)
-    {
+{   (void)pthread_mutex_unlock(&psrp_sock_mutex);
+    (void)pthread_sigmask(SIG_SETMASK,old_set,(sigset_t *)NULL);
+}
+#endif /* PTHREAD_SUPPORT */
 
-       /*-----------------------------------------------------------------------*/
-       /* Tell client that the request has been processed and reset the handler */
-       /* for future PSRP requests.                                             */
-       /*-----------------------------------------------------------------------*/
 
 
-       /*--------------------------------------------------------------*/
-       /* If PSRP service function has not returned its own error code */
-       /* simply return "ok"                                           */
-       /*--------------------------------------------------------------*/
 
-       if(strncmp(psrp_c_code,"none",4) == 0)
-          (void)strlcpy(psrp_c_code,"ok",SSIZE);
+/*------------------------------------------------------------*/
+/* Close socket transport session. The generation number stops */
+/* a late reply (or error) from closing a recycled session     */
+/*------------------------------------------------------------*/
 
+_PRIVATE void psrp_sock_drop(const uint32_t s_index, const uint32_t gen)
 
-       /*------------------------------------------------------*/
-       /* Tell client this request is now processed and return */
-       /* its exit code                                        */
-       /*------------------------------------------------------*/
+{
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-       (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
-       (void)fflush(psrp_out);
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
+    if(psrp_sock_gen[s_index] == gen && psrp_sock_des[s_index] != (-1))
+    {
 
-       /*------------------------------------------------------*/
-       /* Tell client that we have finished processing SIGPSRP */
-       /*------------------------------------------------------*/
+       /*----------------------------------------------------*/
+       /* Wait for any send in progress on this session. The */
+       /* close also removes the session from the epoll set  */
+       /*----------------------------------------------------*/
 
-       psrp_endop("psrp");
-    }
-}
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_lock(&psrp_sock_send_mutex[s_index]);
+       #endif /* PTHREAD_SUPPORT */
+
+       (void)close(psrp_sock_des[s_index]);
+
+       psrp_sock_des[s_index]    = (-1);
+       psrp_sock_client[s_index] = (-1);
+       psrp_sock_pid[s_index]      = (-1);
+       psrp_sock_peer_pid[s_index] = (-1);
+       ++psrp_sock_gen[s_index];
+
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&psrp_sock_send_mutex[s_index]);
+       #endif /* PTHREAD_SUPPORT */
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
+}
 
 
 
 
 /*---------------------------------------------------------------*/
-/* PSRP hander routine - handles process status request protocol */
-/* [PSRP] interrupts                                             */
-/*---------------------------------------------------------------*/
+/* Send reply on socket transport session. Replies may be sent   */
+/* concurrently (by the root thread and by workers), so sends on */
+/* a session are serialised                                      */
+/*---------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_handler(const int32_t signum)
+_PRIVATE int32_t psrp_sock_reply_send(const uint32_t s_index,
+                                      const uint32_t gen,
+                                      const uint32_t seq,
+                                      const char     *buf,
+                                      const size_t   size)
 
-{   int32_t  i,
-             idum,
-             r_argc,
-             status;
+{   int32_t ret;
+    des_t   des;
 
-    char     request[SSIZE]             = "",
-             get_object_command[SSIZE]  = "",
-             psrp_channel_name[SSIZE]   = "",
-             request_str[SSIZE]         = "",
-             psrp_ckpt_status[SSIZE]    = "";
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-    sigset_t set;
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
+    if(psrp_sock_gen[s_index] != gen || (des = psrp_sock_des[s_index]) == (-1))
+    {
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB IN PSRP HANDLER\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_unlock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
 
+       pups_set_errno(EPIPE);
+       return(-1);
+    }
 
-    /*-----------------------------------------------------*/
-    /* Sometimes, because of latency, we can get a SIGPSRP */
-    /* raised in psrp_new_segment - this is spurious and   */
-    /* must not be processed                               */
-    /*-----------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&psrp_sock_send_mutex[s_index]);
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    if(in_psrp_new_segment == TRUE)
-       return(0);
+    ret = psrp_sock_send(des,seq,buf,size);
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB SIGPSRP\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&psrp_sock_send_mutex[s_index]);
+    #endif /* PTHREAD_SUPPORT */
 
+    return(ret);
+}
 
-    /*-----------------------------------------------------*/
-    /* Environment restore if SIGABRT recieved by process. */
-    /*-----------------------------------------------------*/
 
-    ++psrp_transactions[c_client];
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB CCLIENT:%d, CNT:%d\n",c_client,psrp_transactions[c_client]);
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
 
-    if(sigsetjmp(psrp_env,1) > 0)
-    {
- 
-       #ifdef PSRPLIB_DEBUG
-       (void)fprintf(stderr,"PSRPLIB SIGPSRP3 (ABORT)\n");
-       (void)fflush(stderr);
-       #endif /* PSRPLIB_DEBUG */
+/*-------------------------------------------------------------*/
+/* Accept pending socket transport connections from our own    */
+/* user (the socket is mode 0600, but check credentials anyway) */
+/*-------------------------------------------------------------*/
 
-       if(psrp_current_sic != (psrp_channel_type *)NULL)
-       {  psrp_destroy_slaved_interaction_client(psrp_current_sic,TRUE);
-          psrp_unset_current_sic();
-       }
+_PRIVATE void psrp_sock_accept(void)
 
+{   uint32_t i;
+    des_t    des;
 
-       /*-----------------------*/
-       /* Close PSRP connection */
-       /*-----------------------*/
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-       if(psrp_in != (FILE *)NULL)
-       {  (void)psrp_empty_fifo(fileno(psrp_in));
-          psrp_in  = pups_fclose(psrp_in);
+    while((des = accept4(psrp_listen_des,(struct sockaddr *)NULL,(socklen_t *)NULL,SOCK_NONBLOCK | SOCK_CLOEXEC)) != (-1))
+    {  struct ucred cred;
+       socklen_t    cred_size = sizeof(struct ucred);
+
+       if(getsockopt(des,SOL_SOCKET,SO_PEERCRED,&cred,&cred_size) == (-1) || cred.uid != appl_uid)
+       {  (void)close(des);
+          continue;
        }
 
-       if(psrp_out != (FILE *)NULL)
-       {  (void)psrp_empty_fifo(fileno(psrp_out));
-          psrp_out = pups_fclose(psrp_out);
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_lock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
+
+       for(i=0; i<MAX_CLIENTS; ++i)
+       {  if(psrp_sock_des[i] == (-1))
+             break;
        }
 
-       in_psrp_handler     = FALSE;
+       if(i < MAX_CLIENTS)
+          psrp_sock_peer_pid[i] = cred.pid;
 
+       if(i == MAX_CLIENTS)
+          (void)close(des);
 
-       /*--------------------------------------------------*/
-       /* Make sure that virtual timer system is restarted */
-       /* after PSRP request is aborted                    */
-       /*(void)pupsigrelse(SIGALRM);                       */
-       /*--------------------------------------------------*/
 
-       (void)pups_malarm(1);
+       /*---------------------------------------------------------*/
+       /* Event loop - session is added to the epoll set (tagged  */
+       /* with its index and generation)                          */
+       /*---------------------------------------------------------*/
 
-       #ifdef PSRPLIB_DEBUG
-       (void)fprintf(stderr,"ABORT EXIT\n");
-       (void)fflush(stderr);
-       #endif /* PSRPLIB_DEBUG */
-  
-       return(0);
-    }
+       #ifdef PTHREAD_SUPPORT
+       else if(psrp_sock_threaded == TRUE)
+       {  struct epoll_event event;
 
-    in_psrp_handler = TRUE;
-    (void)strlcpy(psrp_c_code,"none",SSIZE);
-    (void)sigemptyset(&set);
-    (void)sigaddset(&set,SIGABRT);
-    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+          event.events   = EPOLLIN;
+          event.data.u64 = ((uint64_t)psrp_sock_gen[i] << 32) | i;
 
+          if(epoll_ctl(psrp_epoll_des,EPOLL_CTL_ADD,des,&event) == (-1))
+             (void)close(des);
+          else
+             psrp_sock_des[i] = des;
+       }
+       #endif /* PTHREAD_SUPPORT */
 
-    /*------------------------------------------------------------------------*/
-    /* Tell PSRP client that this process supports the PSRP protocol and will */
-    /* provide status information to the PSRP client.                         */
-    /*------------------------------------------------------------------------*/
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB SIGPSRP2\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
- 
+       /*------------------------------------------------*/
+       /* Signal driven - session raises SIGPSRPIO when  */
+       /* it has a request pending                       */
+       /*------------------------------------------------*/
 
-    (void)snprintf(psrp_channel_name,SSIZE,"%s/psrp#%s#%d#%d",appl_fifo_dir,appl_name,appl_pid,getuid());
-    (void)fprintf(psrp_out,"(%s)\n",psrp_channel_name);
-    (void)fflush(psrp_out);
+       else if(fcntl(des,F_SETOWN,appl_pid)           == (-1) ||
+               fcntl(des,F_SETSIG,SIGPSRPIO)          == (-1) ||
+               fcntl(des,F_SETFL,O_NONBLOCK | O_ASYNC) == (-1)  )
+          (void)close(des);
+       else
+          psrp_sock_des[i] = des;
+
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_unlock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
+    }
+}
 
 
-    /*-----------------------------------------------------------------------*/
-    /* Read request string from client - this is used by the client to tell  */
-    /* the handler which PSRP action function it wishes to be dispatched on  */
-    /* its behalf.                                                           */
-    /*-----------------------------------------------------------------------*/
 
-    (void)fgets(request,SSIZE,psrp_in);
-    (void)strlcpy(request_str,request,SSIZE);
-    request_str[pups_strlen(request_str) - 2] = '\0';
 
+/*---------------------------------------------------------*/
+/* Bind socket transport session to connected client. The  */
+/* message must be "OPEN <pid> <password>" from a client   */
+/* which has already connected via the FIFO OPEN protocol. */
+/* We do not allocate a client slot here: connection (and  */
+/* disconnection) is still negotiated via the PSRP FIFOs   */
+/*---------------------------------------------------------*/
 
-    #ifdef PSRP_AUTHENTICATE
-    /*----------------------------------------------*/
-    /* Authenticate from psrp_passwd here if secure */
-    /*----------------------------------------------*/
+_PRIVATE void psrp_sock_open_session(const uint32_t s_index, const uint32_t gen, const uint32_t seq, const char *buf)
 
-    if(appl_secure == TRUE && pups_check_appl_password(psrp_password) == FALSE)
-    {  (void)fprintf(psrp_out,"\nSecure server authentication failure (PSRP connection closed)\n\n");
-       (void)fflush(psrp_out);
+{   uint32_t i;
+    int32_t  pid              = (-1),
+             client           = (-1);
+    char     op[SSIZE]        = "",
+             password[SSIZE]  = "",
+             tmp_str[SSIZE]   = "";
 
-       if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): secure server authentication failure [client %s (%d@localhost)]\n",
-                                                                                                                   date,
-                                                                                                              appl_name,
-                                                                                                               appl_pid,
-                                                                                                              appl_host,
-                                                                                                             appl_owner,
-                                                                                             psrp_client_name[c_client],
-                                                                                              psrp_client_pid[c_client]);
-          else
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): secure server authentication failure [client %s (%d@%s)]\n",
-                                                                                                            date,
-                                                                                                       appl_name,
-                                                                                                        appl_pid,
-                                                                                                       appl_host,
-                                                                                                      appl_owner,
-                                                                                      psrp_client_name[c_client],
-                                                                                       psrp_client_pid[c_client],
-                                                                                  psrp_remote_hostpath[c_client]);
-          (void)fflush(stderr);
-       }
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-       /*------------------------------------------------------*/
-       /* Tell client this request is now processed and return */
-       /* its exit code                                        */
-       /*------------------------------------------------------*/
 
-       (void)fprintf(psrp_out,"EOT safail\n");
-       (void)fflush(psrp_out);
+    /*-----------------------------------------------------*/
+    /* Field widths are SSIZE - 1 (message comes from the  */
+    /* client so may be arbitrarily long). The client must */
+    /* be the process which is connected to the socket     */
+    /*-----------------------------------------------------*/
 
+    if(sscanf(buf,"%511s %d %511s",op,&pid,password) >= 2 && strcmp(op,"OPEN") == 0 && pid > 0)
+    {
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_lock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
 
-       /*------------------------------------------------------*/
-       /* Tell client that we have finished processing SIGPSRP */
-       /*------------------------------------------------------*/
+       if(psrp_sock_gen[s_index] == gen && psrp_sock_peer_pid[s_index] == pid)
+       {  for(i=0; i<MAX_CLIENTS; ++i)
+          {  if(psrp_client_pid[i] == pid)
+             {  client = i;
+                break;
+             }
+          }
+       }
 
-       psrp_endop("psrp");
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_unlock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
+    }
 
-       psrp_in  = pups_fclose(psrp_in);
-       psrp_out = pups_fclose(psrp_out);
+    if(client == (-1))
+    {  (void)psrp_sock_reply_send(s_index,gen,seq,"ENOCH\n",6);
+       psrp_sock_drop(s_index,gen);
 
-       in_psrp_handler = FALSE;
-       return(0);
+       return;
     }
-    #endif /* PSRP_AUTHENTICATE */
 
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    if(psrp_log[c_client] == TRUE && strncmp(request_str,"secure",6) != 0)
-    {  if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
-          (void)fprintf(psrp_out,
-                         "\nPSRP (protocol %5.2F) request \"%s\" received by %s (%d@%s:%s) from %s (%d@%s)\n\n",
-                                                                                          PSRP_PROTOCOL_VERSION,
-                                                                                          request_str,appl_name,
-                                                                                  appl_pid,appl_host,appl_owner,
-                                                                                     psrp_client_name[c_client],
-                                                                                      psrp_client_pid[c_client],
-                                                                                     psrp_client_host[c_client]);
-        else
-           (void)fprintf(psrp_out,
-                          "\nPSRP (protocol %5.2F) request \"%s\" received by %s (%d@%s:%s) from %s (%d@%s) [from %s]\n\n",
-                                                                                                     PSRP_PROTOCOL_VERSION,
-                                                                                                     request_str,appl_name,
-                                                                                             appl_pid,appl_host,appl_owner,
-                                                                                                psrp_client_name[c_client],
-                                                                                                 psrp_client_pid[c_client],
-                                                                                                psrp_client_host[c_client],
-                                                                                            psrp_remote_hostpath[c_client]);
-        (void)fflush(psrp_out);
+    if(psrp_sock_gen[s_index] == gen)
+    {  psrp_sock_client[s_index] = client;
+       psrp_sock_pid[s_index]    = pid;
     }
 
-    if(appl_verbose == TRUE && strncmp(request_str,"secure",6) != 0)
-    {  strdate(date);
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-       if(strcmp(request_str,old_request_str[c_client]) != 0)
-       {  if(req_r_cnt[c_client] > 0)
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) last request repeated %d times\n",
-                                                                                                        date,
-                                                                                                   appl_name,
-                                                                                                    appl_pid,
-                                                                                                   appl_host,
-                                                                                                  appl_owner,
-                                                                                       PSRP_PROTOCOL_VERSION,
-                                                                                     req_r_cnt[c_client] + 1);
+    (void)strlcpy(psrp_password,password,SSIZE);
+    (void)snprintf(tmp_str,SSIZE,"%d\n",psrp_seg_cnt);
+    (void)psrp_sock_reply_send(s_index,gen,seq,tmp_str,pups_strlen(tmp_str));
+}
 
-          if(strcmp(psrp_remote_hostpath[c_client],"notset") == 0)
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" received from %s (%d@%s)\n",
-                                                                                                                 date,
-                                                                                                            appl_name,
-                                                                                                             appl_pid,
-                                                                                                            appl_host,
-                                                                                                           appl_owner,
-                                                                                                PSRP_PROTOCOL_VERSION,
-                                                                                                          request_str,
-                                                                                           psrp_client_name[c_client],
-                                                                                            psrp_client_pid[c_client],
-                                                                                           psrp_client_host[c_client]);
-          else
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP (protocol %5.2F) request \"%s\" received from %s (%d@%s) [from %s]\n",
-                                                                                                                           date,
-                                                                                                                      appl_name,
-                                                                                                                       appl_pid,
-                                                                                                                      appl_host,
-                                                                                                                     appl_owner,
-                                                                                                          PSRP_PROTOCOL_VERSION,
-                                                                                                                    request_str,
-                                                                                                     psrp_client_name[c_client],
-                                                                                                      psrp_client_pid[c_client],
-                                                                                                     psrp_client_host[c_client],
-                                                                                                 psrp_remote_hostpath[c_client]);
-          req_r_cnt[c_client] = 0;
-       }
-       else
-          ++req_r_cnt[c_client];
 
-       (void)fflush(stderr);
-       (void)strlcpy(old_request_str[c_client],request_str,SSIZE);
-    }
 
 
-    /*----------------------------------------------------------------------------*/
-    /* Parse PSRP request (noting request has been originated by a client talking */
-    /* PSRP protocols).                                                           */
-    /*----------------------------------------------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Strip trailing line terminators from socket transport       */
+/* request (a request may or may not be newline terminated)    */
+/*-------------------------------------------------------------*/
 
-    psrp_parse_request(request_str,PSRP_FACE);
+_PRIVATE void psrp_sock_strip(char *request_str)
 
-    psrp_in  = pups_fclose(psrp_in);
-    psrp_out = pups_fclose(psrp_out);
+{   size_t len = pups_strlen(request_str);
 
-    in_psrp_handler = FALSE;
-    return(0);
+    while(len > 0 && (request_str[len - 1] == '\n' || request_str[len - 1] == '\r'))
+       request_str[--len] = '\0';
 }
 
 
 
 
-/*---------------------*/
-/* Save dispatch table */
-/*---------------------*/
-
-_PUBLIC  int32_t psrp_save_dispatch_table(const char *autoload_file_name)
-                       
-{   uint32_t i,
-             j,
-             objects          = 0;
+/*-----------------------------------------------------------------*/
+/* Execute a socket transport request (on the root thread). This   */
+/* is the socket analogue of psrp_handler: the reply is buffered   */
+/* in an anonymous (memory) file and returned as a single message. */
+/* If the message is a batch (PSRP_FRAME_BATCH) each (newline      */
+/* separated) request is run in turn and the replies concatenated  */
+/*-----------------------------------------------------------------*/
 
-    FILE     *autoload_stream = (FILE *)NULL;                                 
+_PRIVATE void psrp_sock_execute(const uint32_t s_index, const uint32_t gen, const uint32_t seq, const uint32_t flags, const uint64_t queued, const char *buf, const size_t size)
 
+{   int32_t  client;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    uint64_t started    = 0,
+             dispatched = 0;
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_save_dispatch_table] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    pid_t    pid;
+    ssize_t  r_size;
+    size_t   r_len;
+    des_t    mdes;
 
-    if(autoload_file_name == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    char     *reply                   = (char *)NULL,
+             psrp_channel_name[SSIZE] = "",
+             request_str[SSIZE]       = "";
 
+    const char *next_request          = buf;
 
-    if(autoload_file_name == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    sigset_t set;
 
-    if(access(autoload_file_name,F_OK | R_OK | W_OK) == (-1))
-    {  (void)pups_creat(autoload_file_name,0644);
-       if((autoload_stream = fopen(autoload_file_name,"w")) == (FILE *)NULL)
-       {  pups_set_errno(EIO);
-          return(-1);
-       }
-    }
-    else
-    {  if((autoload_stream = fopen(autoload_file_name,"w+")) == (FILE *)NULL)
-       {  pups_set_errno(EPERM);
-          return(-1);
-       }
-    }
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
 
-    /*---------------------------------------------------------------*/
-    /* We need to lock the dispatch table file as multiple processes */
-    /* could be accessing the same file                              */
-    /*---------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    (void)pups_get_link_file_lock(WAIT_FOREVER,autoload_file_name);
+    client = psrp_sock_client[s_index];
+    pid    = psrp_sock_pid[s_index];
 
-    if(psrp_object_list_used == 0)
-    {  (void)fclose(autoload_stream);
-       (void)unlink(autoload_file_name);
-       (void)pups_release_link_file_lock(autoload_file_name);
+    if(psrp_sock_gen[s_index] != gen)
+       client = (-1);
 
-       pups_set_errno(OK);
-       return(PSRP_DISPATCH_ERROR);
-    }
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
 
-    /*------------------------------------------------*/
-    /* Get the number of valid objects (e.g. dispatch */
-    /* table slots which are both allocated and used) */
-    /*------------------------------------------------*/
+    /*------------------------------------------------------*/
+    /* Client slot has been recycled (client has closed its */
+    /* FIFO connection) - session is stale                  */
+    /*------------------------------------------------------*/
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {  if(psrp_object_list[i].object_handle != (void *)NULL && psrp_object_list[i].aliases > 0)
-          ++objects;
+    if(client == (-1) || psrp_client_pid[client] != pid)
+    {  psrp_sock_drop(s_index,gen);
+       return;
     }
 
-    (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n");
-    (void)fprintf(autoload_stream,"#    PSRP dispatch table resource file version 1.0                  \n");
-    (void)fprintf(autoload_stream,"#    (C) M.A. O'Neill, Tumbling Dice, Gosforth, 2024                \n");
-    (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n");
-    (void)fprintf(autoload_stream,"\n\n");
+    if((mdes = memfd_create("psrp_reply",MFD_CLOEXEC)) == (-1) || (psrp_sock_reply = fdopen(mdes,"w+")) == (FILE *)NULL)
+    {  if(mdes != (-1))
+          (void)close(mdes);
 
-    (void)fprintf(autoload_stream,"# Number of dispatch table objects saved\n");
-    (void)fprintf(autoload_stream,"%d\n\n",objects);
-    (void)fflush(autoload_stream);
+       psrp_sock_drop(s_index,gen);
+       return;
+    }
 
+    c_client = client;
+    ++psrp_transactions[c_client];
 
-    /*-------------------------------------*/
-    /* Save objects in PSRP dispatch table */
-    /*-------------------------------------*/
+    psrp_in  = (FILE *)NULL;
+    psrp_out = psrp_sock_reply;
 
-    for(i=0; i<psrp_object_list_allocated; ++i)     
-    {   if(psrp_object_list[i].aliases > 0)
-        {  (void)fprintf(autoload_stream,"\n\n#-------------------------------------------------------------------\n");
-           (void)fprintf(autoload_stream,"#    PSRP (root tag) object: %s\n",psrp_object_list[i].object_tag[0]);
-           (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n\n");
 
-           (void)fprintf(autoload_stream,"# object type\n");
-           (void)fflush(autoload_stream);
+    /*-----------------------------------------------------*/
+    /* Environment restore if SIGABRT recieved by process. */
+    /* The client has abandoned the request (and session)  */
+    /*-----------------------------------------------------*/
 
-           if(psrp_object_list[i].object_type == PSRP_DYNAMIC_FUNCTION)
-              (void)fprintf(autoload_stream,"dynamic_function\n\n");
+    if(sigsetjmp(psrp_env,1) > 0)
+    {  if(psrp_current_sic != (psrp_channel_type *)NULL)
+       {  psrp_destroy_slaved_interaction_client(psrp_current_sic,TRUE);
+          psrp_unset_current_sic();
+       }
 
-           if(psrp_object_list[i].object_type == PSRP_STATIC_FUNCTION)
-              (void)fprintf(autoload_stream,"static_function\n\n");
+       (void)fclose(psrp_sock_reply);
+       psrp_sock_reply = (FILE *)NULL;
+       psrp_out        = (FILE *)NULL;
 
-           if(psrp_object_list[i].object_type == PSRP_DYNAMIC_DATABAG)
-              (void)fprintf(autoload_stream,"dynamic_databag\n\n");
+       psrp_sock_drop(s_index,gen);
+       in_psrp_handler = FALSE;
 
-           if(psrp_object_list[i].object_type == PSRP_STATIC_DATABAG)
-           {   int32_t slot_index;
+       (void)pups_malarm(1);
+       return;
+    }
 
-              slot_index = pups_fname2index(psrp_object_list[i].object_f_name);
-              if(ftab[slot_index].homeostatic == 1)
-                 (void)fprintf(autoload_stream,"static_databag LIVE\n\n");
-              else
-                 (void)fprintf(autoload_stream,"static_databag DEAD\n\n");
-           }
+    in_psrp_handler = TRUE;
+    (void)strlcpy(psrp_c_code,"none",SSIZE);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGABRT);
+    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
 
-           #ifdef HAVE_DLL_SUPPORT 
-           if(psrp_object_list[i].object_type == PSRP_PERSISTENT_HEAP)
-           {   int32_t f_index;
+    (void)snprintf(psrp_channel_name,SSIZE,"%s/psrp#%s#%d#%d",appl_fifo_dir,appl_name,appl_pid,getuid());
 
 
-              /*--------------------------------*/
-              /* Get index  int32_to PUPS file table */
-              /*--------------------------------*/
+    /*-------------------------------------------------------*/
+    /* Typed request - tag and binary arguments are decoded  */
+    /* (once) and passed directly to the typed function      */
+    /*-------------------------------------------------------*/
 
-              f_index = pups_fname2index(psrp_object_list[i].object_f_name);
+    if(flags & PSRP_FRAME_BINARY)
+    {  (void)fprintf(psrp_out,"(%s)\n",psrp_channel_name);
 
-              if(ftab[f_index].homeostatic == 1)
-                 (void)fprintf(autoload_stream,"dynamic function LIVEn\n");
-              else
-                 (void)fprintf(autoload_stream,"dynamic function\n\n");
-           }
-           #endif /* HAVE_DLL_SUPPORT */
+       started = psrp_latency_now();
+       psrp_service_typed_request(buf,size);
+       dispatched = psrp_latency_now();
 
-           #ifdef PERSISTENT_HEAP_SUPPORT
-           if(psrp_object_list[i].object_type == PSRP_PERSISTENT_HEAP)
-           {   int32_t f_index;
+       (void)snprintf(request_str,SSIZE,"%.*s",(int)strnlen(buf,size),buf);
+       next_request = "";
+    }
+    else
 
+    /*------------------------------------------------------*/
+    /* A batch is run in order, each request in it gets its */
+    /* own (complete) reply. Blank lines are skipped        */
+    /*------------------------------------------------------*/
 
-              /*--------------------------------*/
-	      /* Get index  int32_to PUPS file table */
-              /*--------------------------------*/
+    do {    if(flags & PSRP_FRAME_BATCH)
+               r_len = strcspn(next_request,"\n");
+            else
+               r_len = pups_strlen(next_request);
 
-              f_index = pups_fname2index(psrp_object_list[i].object_f_name);
+            (void)strlcpy(request_str,next_request,(r_len < SSIZE) ? r_len + 1 : SSIZE);
+            psrp_sock_strip(request_str);
 
+            next_request += r_len;
+            if(*next_request == '\n')
+               ++next_request;
 
-              /*-------------------------------------------*/
-	      /* Get mapping mode for this persistent heap */
-              /*-------------------------------------------*/
+            if(request_str[0] != '\0' || (flags & PSRP_FRAME_BATCH) == 0)
+            {  (void)strlcpy(psrp_c_code,"none",SSIZE);
+               (void)fprintf(psrp_out,"(%s)\n",psrp_channel_name);
 
-              if(ftab[f_index].homeostatic == 1)
-                 (void)fprintf(autoload_stream,"persistent_heap LIVE\n\n");
-              else
-                 (void)fprintf(autoload_stream,"persistent_heap DEAD\n\n");
-           }
-           #endif /* PERSISTENT_HEAP_SUPPORT */
+               started = psrp_latency_now();
+               psrp_service_request(request_str);
+               dispatched = psrp_latency_now();
 
-           (void)fprintf(autoload_stream,"# File where object is located\n");
 
-           if(psrp_object_list[i].object_f_name != (char *)NULL)
-           {  (void)fprintf(autoload_stream,"%s\n\n",psrp_object_list[i].object_f_name);
-              (void)fflush(autoload_stream);
-           }
-           else
-           {  (void)fprintf(autoload_stream,"none\n\n");
-              (void)fflush(autoload_stream);
-           }
- 
-           (void)fprintf(autoload_stream,"# Object alias(es)\n");
-           (void)fflush(autoload_stream);
-           (void)fprintf(autoload_stream,"%d\n\n",psrp_object_list[i].aliases);
+               /*-------------------------------------------------*/
+               /* Requests in a batch share a single reply, so    */
+               /* their reply write time is not recorded (queue   */
+               /* time includes time spent behind earlier lines)  */
+               /*-------------------------------------------------*/
 
-           (void)fprintf(autoload_stream,"# Object root tag");
-           if(psrp_object_list[i].aliases > 1)
-              (void)fprintf(autoload_stream," and alias list\n");
-           else
-              (void)fprintf(autoload_stream,"\n");
+               if(flags & PSRP_FRAME_BATCH)
+                  psrp_latency_record(request_str,client,seq,queued,started,dispatched,0);
+            }
+       } while(*next_request != '\0' && psrp_out != (FILE *)NULL);
 
-           (void)fprintf(autoload_stream,"%s ",psrp_object_list[i].object_tag[0]);
-           (void)fflush(autoload_stream);
+    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
+    in_psrp_handler = FALSE;
+    psrp_out        = (FILE *)NULL;
 
-           if(psrp_object_list[i].aliases > 1)
-           {  for(j=1; j<psrp_object_list[i].aliases_allocated; ++j)
-                 if(psrp_object_list[i].object_tag[j] != (char *)NULL)
-                    (void)fprintf(autoload_stream,"%s ",psrp_object_list[i].object_tag[j]);
-           }
 
-           (void)fprintf(autoload_stream,"\n\n");
-           (void)fflush(autoload_stream);
-        }
-    }
+    /*-----------------*/
+    /* Send reply back */
+    /*-----------------*/
 
-    (void)fclose(autoload_stream);
-    (void)pups_release_link_file_lock(autoload_file_name);
+    (void)fflush(psrp_sock_reply);
+    if((r_size = (ssize_t)ftell(psrp_sock_reply)) > 0)
+    {  reply = (char *)mmap((void *)NULL,r_size,PROT_READ,MAP_SHARED,fileno(psrp_sock_reply),0);
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): dispatch table saved (to PSRP resource file %s)\n",
-                                  date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
-       (void)fflush(stderr);
+       if(reply == (char *)MAP_FAILED || psrp_sock_reply_send(s_index,gen,seq,reply,r_size) == (-1))
+          psrp_sock_drop(s_index,gen);
+
+       if(reply != (char *)MAP_FAILED)
+          (void)munmap((void *)reply,r_size);
     }
 
-    pups_set_errno(OK);
-    return(PSRP_OK);
+    if((flags & PSRP_FRAME_BATCH) == 0 && started != 0)
+       psrp_latency_record(request_str,client,seq,queued,started,dispatched,psrp_latency_now());
+
+    (void)fclose(psrp_sock_reply);
+    psrp_sock_reply = (FILE *)NULL;
 }
 
 
 
 
-/*-------------------------------------------------------------*/
-/* Remove communication channel when PSRP server process exits */
-/*-------------------------------------------------------------*/
+/*------------------------------------------------------------*/
+/* Dispatch a socket transport message (on the root thread).   */
+/* The first message on a session binds it, subsequent         */
+/* messages are PSRP requests                                  */
+/*------------------------------------------------------------*/
 
-_PUBLIC void psrp_exit(void)
- 
-{   uint32_t i;
-    char     autoload_file_name[SSIZE] = "";
+_PRIVATE void psrp_sock_dispatch(const uint32_t s_index, const uint32_t gen, const uint32_t seq, const uint32_t flags, const uint64_t queued, const char *buf, const size_t size)
 
+{   _BOOLEAN bound = FALSE;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_exit] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
+    if(psrp_sock_client[s_index] != (-1))
+       bound = TRUE;
 
-    /*---------------------------------------------------------------*/
-    /* Save the names of those objects which are to be automatically */
-    /* loaded at the next invocation of this server                  */
-    /*---------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    if(appl_psrp_save == TRUE)
-    {  
+    if(bound == TRUE)
+       psrp_sock_execute(s_index,gen,seq,flags,queued,buf,size);
+    else
+       psrp_sock_open_session(s_index,gen,seq,buf);
+}
 
-       if(getuid() != 0)
-          (void)snprintf(autoload_file_name,SSIZE,"%s/.%s.psrp",appl_home,appl_name);
-       else
-          (void)snprintf(autoload_file_name,SSIZE,"/%s.psrp",appl_name);
-
-       if(appl_verbose == TRUE)
-       {  strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): saving PSRP dispatch table (to [default] PSRP resource file %s)\n",
-                                                     date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
-          (void)fflush(stderr);
-       }
-    
-       psrp_save_dispatch_table(autoload_file_name);
-    }
 
 
-    /*------------------------------*/
-    /* Delete communication channel */
-    /*------------------------------*/
 
-    (void)pups_fclose(psrp_in);
-    (void)unlink(channel_name_in);
+/*------------------------------------------------------------*/
+/* Service one message on a (signal driven) socket transport  */
+/* session                                                    */
+/*------------------------------------------------------------*/
 
-    (void)pups_fclose(psrp_out);
-    (void)unlink(channel_name_out);
+_PRIVATE void psrp_sock_service(const uint32_t s_index)
 
+{   uint32_t seq,
+             flags,
+             gen      = psrp_sock_gen[s_index];
+    uint64_t queued   = psrp_latency_now();
+    ssize_t  size;
+    size_t   buf_size = 0;
+    char     *buf     = (char *)NULL;
 
-    /*-------------------------------------------------*/
-    /* Release memory allocated to PSRP server process */
-    /*-------------------------------------------------*/
+    if((size = psrp_sock_recvmsg(psrp_sock_des[s_index],&seq,&flags,&buf,&buf_size)) <= 0)
+       psrp_sock_drop(s_index,gen);
+    else
+       psrp_sock_dispatch(s_index,gen,seq,flags,queued,buf,(size_t)size);
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-       psrp_destroy_object(i);
+    (void)free((void *)buf);
 }
 
 
 
 
-/*--------------------------------*/
-/* Get PSRP handler entry by name */
-/*--------------------------------*/
+/*-------------------------------------------------------------------*/
+/* Handler for SIGPSRPIO - if the socket transport is event loop     */
+/* driven, run requests queued for the root thread. Otherwise accept */
+/* new sessions and service any sessions which have requests pending */
+/*-------------------------------------------------------------------*/
 
-_PUBLIC  int32_t lookup_psrp_object_by_name(const char *name)
+_PRIVATE int32_t psrp_sock_handler(const int32_t signum)
 
-{   uint32_t i;
+{   uint32_t      i,
+                  n_fds,
+                  serviced;
 
-    if(name == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    struct pollfd fds[MAX_CLIENTS];
+    uint32_t      s_index[MAX_CLIENTS];
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[lookup_psrp_object_by_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    /*-------------------------------------------------------*/
+    /* Spurious signals may arrive during segmentation - the */
+    /* client will retry                                     */
+    /*-------------------------------------------------------*/
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {  if(psrp_object_list[i].object_handle != (void *)NULL && psrp_isearch_tag_list(name,i) >= 0)
-       {  pups_set_errno(OK);
-          return(i);
-       }
-    }
+    if(in_psrp_new_segment == TRUE || psrp_listen_des == (-1))
+       return(0);
 
-    pups_set_errno(ESRCH);
-    return(-1);
-}
+    #ifdef PTHREAD_SUPPORT
+    if(psrp_sock_threaded == TRUE)
+    {  sigset_t            old_set;
+       psrp_sock_work_type *work = (psrp_sock_work_type *)NULL;
 
+       do {    psrp_sock_lock(&old_set);
 
+               if((work = psrp_serial_head) != (psrp_sock_work_type *)NULL)
+               {  if((psrp_serial_head = work->next) == (psrp_sock_work_type *)NULL)
+                     psrp_serial_tail = (psrp_sock_work_type *)NULL;
+               }
 
+               psrp_sock_unlock(&old_set);
 
-/*---------------------------------------*/
-/* Get PSRP handler list entry by handle */
-/*---------------------------------------*/
+               if(work != (psrp_sock_work_type *)NULL)
+               {  psrp_sock_dispatch(work->s_index,work->gen,work->seq,work->flags,work->queued,work->request,work->size);
 
-_PUBLIC int32_t lookup_psrp_object_by_handle(const void *object_handle)
- 
-{   uint32_t i; 
- 
+                  (void)free((void *)work->request);
+                  (void)free((void *)work);
+               }
+          } while(work != (psrp_sock_work_type *)NULL && psrp_listen_des != (-1));
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+       return(0);
+    }
+    #endif /* PTHREAD_SUPPORT */
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[lookup_psrp_object_by_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    psrp_sock_accept();
 
-    if(object_handle == (const void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-       if(psrp_object_list[i].object_handle == object_handle)
-       {  pups_set_errno(OK);
-          return(i);
-       }
+    /*------------------------------------------------------*/
+    /* Service sessions until none has anything pending. We */
+    /* poll rather than trust signal payloads, because they */
+    /* may be coalesced (or lost on queue overflow)         */
+    /*------------------------------------------------------*/
 
-    pups_set_errno(ESRCH);
-    return(-1); 
+    do {    serviced = 0;
+            n_fds    = 0;
+
+            for(i=0; i<MAX_CLIENTS; ++i)
+            {  if(psrp_sock_des[i] != (-1))
+               {  fds[n_fds].fd      = psrp_sock_des[i];
+                  fds[n_fds].events  = POLLIN;
+                  fds[n_fds].revents = 0;
+                  s_index[n_fds]     = i;
+                  ++n_fds;
+               }
+            }
+
+            if(n_fds == 0 || poll(fds,n_fds,0) <= 0)
+               break;
+
+            for(i=0; i<n_fds; ++i)
+            {  if(fds[i].revents != 0 && psrp_sock_des[s_index[i]] == fds[i].fd)
+               {  psrp_sock_service(s_index[i]);
+                  ++serviced;
+               }
+            }
+       } while(serviced > 0 && psrp_listen_des != (-1));
+
+    return(0);
 }
 
 
 
 
-/*-------------------------------------*/
-/* Get handle of PSRP object from name */
-/*-------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Attach a static function which may be run concurrently with */
+/* other requests. The function must be thread safe: over the  */
+/* socket transport it is run by a worker thread (writing to   */
+/* that thread's psrp_out) rather than on the root thread      */
+/*-------------------------------------------------------------*/
 
-_PUBLIC void *psrp_get_handle_from_name(const char *name)
+_PUBLIC int32_t psrp_attach_concurrent_function(const char *object_tag, const void *object_handle)
 
-{    int32_t d_index;
+{   uint32_t i;
+
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
 
     /*----------------------------------*/
@@ -4949,63 +5829,114 @@ _PUBLIC void *psrp_get_handle_from_name(const char *name)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_get_handle_from_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       pups_error("[psrp_attach_concurrent_function] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(name == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((void *)NULL);
+    if(psrp_attach_static_function(object_tag,object_handle) == PSRP_DISPATCH_ERROR)
+       return(PSRP_DISPATCH_ERROR);
+
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
+
+    for(i=0; i<psrp_concurrent_functions; ++i)
+    {  if(strcmp(psrp_concurrent_tag[i],object_tag) == 0)
+          break;
     }
 
-    if((d_index = lookup_psrp_object_by_name(name)) == (-1))
-       return((void *)NULL);
+    if(i == PSRP_CONCURRENT_TABLE_SIZE)
+    {
+
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_unlock(&old_set);
+       #endif /* PTHREAD_SUPPORT */
+
+
+       /*------------------------------------------------*/
+       /* Table full - function is still attached, but   */
+       /* requests for it will be serialised             */
+       /*------------------------------------------------*/
+
+       pups_set_errno(ENOSPC);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    (void)strlcpy(psrp_concurrent_tag[i],object_tag,SSIZE);
+    psrp_concurrent_func[i] = (void *)object_handle;
+
+    if(i == psrp_concurrent_functions)
+       ++psrp_concurrent_functions;
+
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
     pups_set_errno(OK);
-    return(psrp_object_list[d_index].object_handle);
+    return(PSRP_OK);
 }
 
 
 
 
-/*------------------------------------*/
-/*Get name of PSRP object from handle */
-/*------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Remove concurrent function (by tag or by handle) when it is */
+/* detached (or its DLL unloaded). If we have threads, wait    */
+/* until no concurrent request is running. Requests which are  */
+/* still queued for it are handed on to the root thread        */
+/*-------------------------------------------------------------*/
 
-_PUBLIC  int32_t psrp_get_name_from_handle(const void *handle, char *name)
+_PRIVATE void psrp_concurrent_remove(const char *object_tag, const void *object_handle)
 
-{    int32_t d_index;
+{   uint32_t i,
+             j = 0;
 
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_get_name_from_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    for(i=0; i<psrp_concurrent_functions; ++i)
+    {  if((object_tag    != (const char *)NULL && strcmp(psrp_concurrent_tag[i],object_tag) == 0) ||
+          (object_handle != (const void *)NULL && psrp_concurrent_func[i] == object_handle)         )
+          continue;
 
-    if(handle == (const void *)NULL || name == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+       if(j != i)
+       {  (void)strlcpy(psrp_concurrent_tag[j],psrp_concurrent_tag[i],SSIZE);
+          psrp_concurrent_func[j] = psrp_concurrent_func[i];
+       }
+
+       ++j;
     }
 
-    if((d_index = lookup_psrp_object_by_handle(handle)) == (-1))
-       return(-1);
+    psrp_concurrent_functions = j;
 
-    (void)strlcpy(name,psrp_object_list[d_index].object_handle,SSIZE);
-    pups_set_errno(OK);
-    return(0);
+    #ifdef PTHREAD_SUPPORT
+    while(psrp_concurrent_running > 0)
+       (void)pthread_cond_wait(&psrp_concurrent_cond,&psrp_sock_mutex);
+
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 }
 
 
 
 
-/*-----------------------------------*/
-/* Get type of PSRP object from name */
-/*-----------------------------------*/
+/*-------------------------------------------------------------------*/
+/* Register typed argument schema (and typed entry point) for an     */
+/* attached (static or dynamic) function. The schema is a string of  */
+/* argument types (PSRP_ARG_INT, PSRP_ARG_DOUBLE, PSRP_ARG_BYTES,    */
+/* PSRP_ARG_STRING or PSRP_ARG_VECTOR). Requests for the function    */
+/* are then decoded (once) into a psrp_typed_args_type which is      */
+/* passed to typed_func -- whether they arrive as binary arguments   */
+/* (psrp_sock_typed_request) or as text                              */
+/*-------------------------------------------------------------------*/
 
-_PUBLIC int32_t psrp_get_type_from_name(const char *name)
+_PUBLIC int32_t psrp_set_arg_schema(const char *object_tag,                                  // Tag of attached function
+                                    const char *schema,                                      // Argument schema
+                                    int32_t    (*typed_func)(const psrp_typed_args_type *))  // Typed entry point
 
-{   int32_t d_index;
+{   uint32_t i;
+    int32_t  slot_index;
 
 
     /*----------------------------------*/
@@ -5014,2361 +5945,2466 @@ _PUBLIC int32_t psrp_get_type_from_name(const char *name)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_get_type_from_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       pups_error("[psrp_set_arg_schema] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(name == (const char *)NULL)
+    if(object_tag == (const char *)NULL                         ||
+       schema     == (const char *)NULL                         ||
+       typed_func == (void *)NULL                               ||
+       pups_strlen(schema) > PSRP_MAX_TYPED_ARGS                ||
+       strspn(schema,PSRP_ARG_TYPES) != pups_strlen(schema)      )
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return(PSRP_DISPATCH_ERROR);
     }
 
-    if((d_index = lookup_psrp_object_by_name(name)) == (-1))
-       return(-1);
-
-    pups_set_errno(OK);
-    return(psrp_object_list[d_index].object_type);
-}
+    if((slot_index = psrp_tag_index_lookup(object_tag)) == (-1)                         ||
+       (psrp_object_list[slot_index].object_type != PSRP_STATIC_FUNCTION &&
+        psrp_object_list[slot_index].object_type != PSRP_DYNAMIC_FUNCTION)               )
+    {  pups_set_errno(ENOENT);
+       return(PSRP_DISPATCH_ERROR);
+    }
 
+    for(i=0; i<psrp_typed_functions; ++i)
+    {  if(strcmp(psrp_typed_tag[i],psrp_object_list[slot_index].object_tag[0]) == 0)
+          break;
+    }
 
+    if(i == PSRP_TYPED_TABLE_SIZE)
+    {  pups_set_errno(ENOSPC);
+       return(PSRP_DISPATCH_ERROR);
+    }
 
+    (void)strlcpy(psrp_typed_tag[i],psrp_object_list[slot_index].object_tag[0],SSIZE);
+    (void)strlcpy(psrp_typed_schema[i],schema,PSRP_MAX_TYPED_ARGS + 1);
+    psrp_typed_func[i]   = typed_func;
+    psrp_typed_handle[i] = psrp_object_list[slot_index].object_handle;
 
-/*-------------------------------------*/
-/* Get type of PSRP object from handle */
-/*-------------------------------------*/
+    if(i == psrp_typed_functions)
+       ++psrp_typed_functions;
 
-_PUBLIC int32_t psrp_get_type_from_handle(const void *handle)
+    pups_set_errno(OK);
+    return(PSRP_OK);
+}
 
-{   int32_t d_index;
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_get_type_from_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
+/*---------------------------------------------------------------*/
+/* Attach a static function with typed arguments. The function   */
+/* is called (via its typed entry point) with decoded arguments  */
+/*---------------------------------------------------------------*/
 
-    if(handle == (const void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+_PUBLIC int32_t psrp_attach_typed_function(const char *object_tag,                                  // Tag of function
+                                           const char *schema,                                      // Argument schema
+                                           int32_t    (*typed_func)(const psrp_typed_args_type *))  // Typed entry point
 
-    if((d_index = lookup_psrp_object_by_handle(handle)) == (-1))
-       return(-1);
+{   if(psrp_attach_static_function(object_tag,(void *)typed_func) == PSRP_DISPATCH_ERROR)
+       return(PSRP_DISPATCH_ERROR);
 
-    pups_set_errno(OK);
-    return(psrp_object_list[d_index].object_type);
+    return(psrp_set_arg_schema(object_tag,schema,typed_func));
 }
 
 
 
 
-/*--------------------------------------------------------------------------------------*/
-/* Parse PSRP dispatch request  int32_to POSIX command line format so that it can be further */
-/* processed by the comamnd line decoding utilities                                     */
-/*--------------------------------------------------------------------------------------*/
+/*--------------------------------------------------------------*/
+/* Find typed argument schema for (attached) object. An entry   */
+/* whose object has since been re-attached (handle changed) is  */
+/* stale and is ignored                                         */
+/*--------------------------------------------------------------*/
 
-_PRIVATE void psrp_argvec(uint32_t    *r_argc, const char *request)
+_PRIVATE int32_t psrp_typed_lookup(const int32_t slot_index)
 
 {   uint32_t i;
-    int32_t  ret;
-    char     next_arg[SSIZE]       = "";
 
-    _IMMORTAL _BOOLEAN entered = FALSE;
+    for(i=0; i<psrp_typed_functions; ++i)
+    {  if(strcmp(psrp_typed_tag[i],psrp_object_list[slot_index].object_tag[0]) == 0)
+       {  if(psrp_typed_handle[i] != psrp_object_list[slot_index].object_handle)
+             return(-1);
 
-    for(i=0; i<MAX_CMD_ARGS; ++i)
-    {  if(entered == FALSE)
-          r_argv[i] = (char *)pups_malloc(SSIZE);
-       (void)strlcpy(r_argv[i],"",SSIZE);
+          return((int32_t)i);
+       }
     }
 
-    entered = TRUE;
-    *r_argc = 0;
+    return(-1);
+}
 
 
-    /*--------------------------------------------*/
-    /* Reset internal pointers in strext function */
-    /*--------------------------------------------*/
 
-    (void)strext(' ',(char *)NULL,(char *)NULL);
-    do {    ret = strext(' ',next_arg,request);
 
-            (void)strlcpy(r_argv[(*r_argc)],next_arg,SSIZE);
-            ++(*r_argc);
+/*----------------------------------------------------------------*/
+/* Run typed function with (decoded) arguments, reporting schema  */
+/* mismatch back to the client                                    */
+/*----------------------------------------------------------------*/
 
-            if(*r_argc > MAX_CMD_ARGS)
-            {  (void)snprintf(errstr,SSIZE,"[psrp_argvec] too man arguments (max %d)",MAX_CMD_ARGS);
-               pups_error(errstr);
-            }
+_PRIVATE int32_t psrp_exec_typed_function(const int32_t        t_index,
+                                          const char           *tag,
+                                          const int32_t        decoded,
+                                          psrp_typed_args_type *args)
 
-       } while(ret == TRUE);
-}
+{   int32_t status;
 
+    if(decoded == (-1))
+    {  (void)fprintf(psrp_out,"    object %s expects typed arguments (schema \"%s\")\n",tag,psrp_typed_schema[t_index]);
+       (void)fflush(psrp_out);
 
+       return(-1);
+    }
 
+    args->tag = tag;
+    status    = (*psrp_typed_func[t_index])(args);
+    psrp_free_typed_args(args);
 
-/*-------------------------*/
-/* Initialise PSRP handler */
-/*-------------------------*/
+    return(status);
+}
 
-_PUBLIC _BOOLEAN psrp_std_init(const int32_t argc, const char *argv[])
 
-{   uint32_t         i;
-    char             item[SSIZE] = "";
-    psrp_object_type *psrp_object;
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+/*---------------------------------------------------------------------*/
+/* Service typed (binary argument) request from socket transport. The  */
+/* message is the function tag (NUL terminated) then the arguments     */
+/*---------------------------------------------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_std_init] attempt by non root thread to perform PUPS/P3 PSRP operation");
+_PRIVATE void psrp_service_typed_request(const char *buf, const size_t size)
 
-    if(argv == (const char **)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+{   int32_t              slot_index,
+                         t_index,
+                         status;
 
+    size_t               tag_size;
+    psrp_typed_args_type args;
 
-    /*-------------------------------------*/
-    /* Reset argument decode status vector */
-    /*-------------------------------------*/
+    tag_size = strnlen(buf,size);
 
-    t_args = argc;
+    #ifdef PSRP_AUTHENTICATE
+    if(appl_secure == TRUE && pups_check_appl_password(psrp_password) == FALSE)
+    {  (void)fprintf(psrp_out,"\nSecure server authentication failure (PSRP connection closed)\n\n");
+       (void)fprintf(psrp_out,"EOT safail\n");
+       (void)fflush(psrp_out);
 
+       psrp_endop("psrp");
+       return;
+    }
+    #endif /* PSRP_AUTHENTICATE */
 
-    /*---------------------------------------------------------*/
-    /* By the time we have got here we have implicitly decoded */
-    /* the first argument                                      */
-    /*---------------------------------------------------------*/
+    if(tag_size == size || (slot_index = psrp_tag_index_lookup(buf)) == (-1) || (t_index = psrp_typed_lookup(slot_index)) == (-1))
+    {  (void)fprintf(psrp_out,"    Illegal typed command [%.*s]\n",(int)tag_size,buf);
+       (void)strlcpy(psrp_c_code,"illcerr",SSIZE);
+    }
+    else
+    {  status = psrp_exec_typed_function(t_index,
+                                         buf,
+                                         psrp_decode_typed_args(psrp_typed_schema[t_index],(const _BYTE *)&buf[tag_size + 1],size - tag_size - 1,&args),
+                                         &args);
 
-    argd[0] = TRUE;
-    for(i=1; i<MAX_CMD_ARGS; ++i)
-       argd[i] = FALSE;
+       if(status < 0 && psrp_error_handling == TRUE)
+       {  (void)fprintf(psrp_out,"    Command returned error (%s)\n",buf);
+          (void)strlcpy(psrp_c_code,"err",SSIZE);
+       }
+       else
+          (void)strlcpy(psrp_c_code,"ok",SSIZE);
+    }
 
-    return(TRUE);
+    (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
+    (void)fflush(psrp_out);
+
+    psrp_endop("psrp");
 }
 
 
 
- 
-/*------------------------------------------------*/
-/* PSRP handler command line parser error handler */
-/*------------------------------------------------*/
 
-_PUBLIC _BOOLEAN psrp_t_arg_errs(const  int32_t argc, const _BOOLEAN argd[], const char *args[])
+#ifdef PTHREAD_SUPPORT
+/*--------------------------------------------------------------*/
+/* Read request from socket transport session (event loop       */
+/* thread). Requests for concurrent functions are passed to the */
+/* worker pool, all others (including session binding) are      */
+/* queued for the root thread, which is then sent SIGPSRPIO     */
+/*--------------------------------------------------------------*/
 
-{   uint32_t i;
-    _BOOLEAN parse_failed = FALSE;
+_PRIVATE void psrp_sock_read(const uint32_t s_index, const uint32_t gen)
 
+{   uint32_t            i,
+                        seq,
+                        flags;
+    ssize_t             size     = 0;
+    size_t              buf_size = 0,
+                        tag_size;
+    des_t               des      = (-1);
+    char                *buf     = (char *)NULL;
+    psrp_sock_work_type *work    = (psrp_sock_work_type *)NULL;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    (void)pthread_mutex_lock(&psrp_sock_mutex);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_t_arg_errs] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(psrp_sock_gen[s_index] == gen)
+       des = psrp_sock_des[s_index];
 
-    if(argd == (_BOOLEAN *)NULL || args == (char **)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    (void)pthread_mutex_unlock(&psrp_sock_mutex);
 
-    for(i=0; i<t_args; ++i)
-    {   if(argd[i] == FALSE)
-        {  if(parse_failed == FALSE)
-           {  (void)fprintf(psrp_out,"\n\n");
-              parse_failed = TRUE;
-           }
+    if(des == (-1))
+       return;
 
-           (void)fprintf(psrp_out,"psrp_t_arg_errs: failed to parse: %s\n",args[i]);
-           (void)fflush(psrp_out);
-        }
-    }
 
-    pups_set_errno(OK);
-    if(parse_failed == TRUE)
-       return(FALSE);
-    else
-       return(TRUE);
-}
+    /*---------------------------------------------------------*/
+    /* Note we use malloc/free (rather than pups_malloc and    */
+    /* pups_free) off the root thread: the latter manipulate   */
+    /* the (process wide) PUPS signal hold count               */
+    /*---------------------------------------------------------*/
 
+    if((size = psrp_sock_recvmsg(des,&seq,&flags,&buf,&buf_size)) <= 0 || (work = (psrp_sock_work_type *)malloc(sizeof(psrp_sock_work_type))) == (psrp_sock_work_type *)NULL)
+    {  (void)free((void *)buf);
+       psrp_sock_drop(s_index,gen);
 
+       return;
+    }
 
+    work->s_index = s_index;
+    work->gen     = gen;
+    work->seq     = seq;
+    work->flags   = flags;
+    work->queued  = psrp_latency_now();
+    work->size    = (size_t)size;
+    work->func    = (void *)NULL;
+    work->request = buf;
+    work->next    = (psrp_sock_work_type *)NULL;
 
-/*-------------------------------------------------*/
-/* Switch error logging on or off from PSRP client */
-/*-------------------------------------------------*/
+    tag_size = strcspn(buf," \n");
 
-_PRIVATE int32_t psrp_builtin_appl_verbose(const int32_t argc, const char *argv[])
+    (void)pthread_mutex_lock(&psrp_sock_mutex);
 
-{   if(strcmp("appl_verbose",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: appl_verbose [on | off]\n\n");
-       (void)fflush(psrp_out);
+    /*----------------------------------------------------------*/
+    /* Only requests on bound sessions can run concurrently. If */
+    /* the server is secure, requests must be authenticated     */
+    /* (on the root thread). Batches (and typed requests) are   */
+    /* always run in order on the root thread                   */
+    /*----------------------------------------------------------*/
 
-       return(PSRP_OK);
+    #ifdef PSRP_AUTHENTICATE
+    if(appl_secure == FALSE)
+    #endif /* PSRP_AUTHENTICATE */
+
+    if(psrp_sock_client[s_index] != (-1) && psrp_sock_workers_running > 0 && (flags & (PSRP_FRAME_BATCH | PSRP_FRAME_BINARY)) == 0)
+    {  for(i=0; i<psrp_concurrent_functions; ++i)
+       {  if(pups_strlen(psrp_concurrent_tag[i]) == tag_size && strncmp(buf,psrp_concurrent_tag[i],tag_size) == 0)
+          {  work->func = psrp_concurrent_func[i];
+             break;
+          }
+       }
     }
 
-    if(strcmp(argv[1],"on") == 0)
-    {  (void)fprintf(psrp_out,"\nserver transaction/error logging enabled\n\n");
-       (void)fflush(psrp_out);
+    if(work->func == (void *)NULL)
+    {  if(psrp_serial_tail == (psrp_sock_work_type *)NULL)
+          psrp_serial_head       = work;
+       else
+          psrp_serial_tail->next = work;
 
-       appl_verbose = TRUE;
-       return(PSRP_OK);
+       psrp_serial_tail = work;
     }
+
+    (void)pthread_mutex_unlock(&psrp_sock_mutex);
+
+    if(work->func == (void *)NULL)
+       (void)pthread_kill(appl_root_tid,SIGPSRPIO);
     else
-    {  if(strcmp(argv[1],"off") == 0)
-       {  (void)fprintf(psrp_out,"\nserver transaction/error logging disabled\n\n");
-          (void)fflush(psrp_out);
+    {  (void)pthread_mutex_lock(&psrp_work_mutex);
 
-          appl_verbose = FALSE;
-       }
+       if(psrp_work_tail == (psrp_sock_work_type *)NULL)
+          psrp_work_head       = work;
        else
-       {  (void)fprintf(psrp_out,"\nusage: appl_verbose [on | off]\n\n");
-          (void)fflush(psrp_out);
-       }
+          psrp_work_tail->next = work;
 
-       return(PSRP_OK);
-    }
+       psrp_work_tail = work;
 
-    return(PSRP_DISPATCH_ERROR);
+       (void)pthread_cond_signal(&psrp_work_cond);
+       (void)pthread_mutex_unlock(&psrp_work_mutex);
+    }
 }
 
 
 
 
-/*--------------------------------------------------*/
-/* Switch error handling on or off from PSRP client */
-/*--------------------------------------------------*/
+/*----------------------------------------------------------------*/
+/* Socket transport event loop thread. Multiplexes the listener   */
+/* and all sessions, so a slow request from one client no longer  */
+/* holds up reads (or concurrent requests) from the others        */
+/*----------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_error_handling(const int32_t argc, const char *argv[])
+_PRIVATE void *psrp_sock_thread(void *arg)
 
-{   if(strcmp("error_handling",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+{   int32_t            i,
+                       n_events;
+    struct epoll_event events[MAX_CLIENTS + 2];
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: error_handling [on | off]\n\n");
-       (void)fflush(psrp_out);
+    while(psrp_sock_shutdown == FALSE)
+    {  if((n_events = epoll_wait(psrp_epoll_des,events,MAX_CLIENTS + 2,(-1))) == (-1))
+       {  if(errno == EINTR)
+             continue;
 
-       return(PSRP_OK);
-    }
+          break;
+       }
 
-    if(strcmp(argv[1],"on") == 0)
-    {  (void)fprintf(psrp_out,"\nserver error handling enabled\n\n");
-       (void)fflush(psrp_out);
+       /*-----------------------------------------------------*/
+       /* Low word of event tag is session index (or listener */
+       /* or wakeup token), high word is session generation   */
+       /*-----------------------------------------------------*/
 
-       psrp_error_handling = TRUE;
-       return(PSRP_OK);
-    }
-    else
-    {  if(strcmp(argv[1],"off") == 0)
-       {  (void)fprintf(psrp_out,"\nerror handling disabled\n\n");
-          (void)fflush(psrp_out);
+       for(i=0; i<n_events; ++i)
+       {  uint32_t token = (uint32_t)(events[i].data.u64 & 0xffffffff);
 
-          psrp_error_handling = FALSE;
-       }
-       else
-       {  (void)fprintf(psrp_out,"\nusage: error_handling [on | off]\n\n");
-          (void)fflush(psrp_out);
+          if(token == PSRP_SOCK_WAKE_TOKEN)
+             return((void *)NULL);
+          else if(token == PSRP_SOCK_LISTEN_TOKEN)
+             psrp_sock_accept();
+          else
+             psrp_sock_read(token,(uint32_t)(events[i].data.u64 >> 32));
        }
-
-       return(PSRP_OK);
     }
 
-    return(PSRP_DISPATCH_ERROR);
+    return((void *)NULL);
 }
 
 
 
-#ifdef SSH_SUPPORT
-/*------------------------------------------*/
-/* Set ssh compression mode for PSRP client */
-/*------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_ssh_compress(const uint32_t argc, const char *argv[])
+/*--------------------------------------------------------------*/
+/* Is the function for a concurrent request still attached? If  */
+/* so it is counted as running (so it cannot be removed under   */
+/* us). If not, the request is handed on to the root thread     */
+/* (which replies that the function is not available)           */
+/*--------------------------------------------------------------*/
 
-{   if(strcmp("compress",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PRIVATE _BOOLEAN psrp_sock_concurrent_begin(psrp_sock_work_type *work)
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: compress [on | off]\n\n");
-       (void)fflush(psrp_out);
+{   uint32_t i;
 
-       return(PSRP_OK);
-    }
+    (void)pthread_mutex_lock(&psrp_sock_mutex);
 
-    if(strcmp(argv[1],"on") == 0)
-    {  (void)fprintf(psrp_out,"\nserver ssh compression enabled\n\n");
-       (void)fflush(psrp_out);
+    for(i=0; i<psrp_concurrent_functions; ++i)
+    {  if(psrp_concurrent_func[i] == (void *)work->func)
+       {  ++psrp_concurrent_running;
+          (void)pthread_mutex_unlock(&psrp_sock_mutex);
 
-       ssh_compression = TRUE;
-       return(PSRP_OK);
+          return(TRUE);
+       }
     }
-    else
-    {  if(strcmp(argv[1],"off") == 0)
-       {  (void)fprintf(psrp_out,"\nserver ssh compression disabled\n\n");
-          (void)fflush(psrp_out);
 
-          ssh_compression = FALSE;
-       }
-       else
-       {  (void)fprintf(psrp_out,"\nusage: compress  [on | off]\n\n");
-          (void)fflush(psrp_out);
-       }
+    work->func = (void *)NULL;
+    work->next = (psrp_sock_work_type *)NULL;
 
-       return(PSRP_OK);
-    }
+    if(psrp_serial_tail == (psrp_sock_work_type *)NULL)
+       psrp_serial_head       = work;
+    else
+       psrp_serial_tail->next = work;
 
-    return(PSRP_DISPATCH_ERROR);
+    psrp_serial_tail = work;
+    (void)pthread_mutex_unlock(&psrp_sock_mutex);
+
+    (void)pthread_kill(appl_root_tid,SIGPSRPIO);
+    return(FALSE);
 }
 
 
 
 
-/*------------------------------------------*/
-/* Set ssh remote host port for PSRP client */
-/*------------------------------------------*/
+/*------------------------------------------------------------*/
+/* Run a concurrent request (worker thread). This is a cut    */
+/* down psrp_service_request: there is no authentication (the */
+/* request would not be here if the server were secure) and   */
+/* no logging to stderr                                       */
+/*------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_ssh_port(const uint32_t argc, const char *argv[])
+_PRIVATE void psrp_sock_run_concurrent(psrp_sock_work_type *work)
 
-{   char port_id[SSIZE] = "";
+{   uint32_t r_argc = 0;
 
-    if(strcmp("port",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    int32_t  client,
+             status;
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: port <port number | default>\n\n");
-       (void)fflush(psrp_out);
+    _BOOLEAN log                      = FALSE;
 
-       return(PSRP_OK);
-    }
+    uint64_t started,
+             dispatched;
 
-    if(sscanf(argv[0],"%d",&port_id) != 1 || port_id < 0)
-    {  if(strcmp(port_id,"default") == 0)
+    pid_t    pid;
+    ssize_t  size;
+    des_t    mdes;
+    FILE     *reply_stream            = (FILE *)NULL;
 
+    char     *reply                   = (char *)NULL,
+             *next_arg                = (char *)NULL,
+             *save_ptr                = (char *)NULL,
+             *r_argv[MAX_CMD_ARGS]    = { (char *)NULL },
+             c_code[SSIZE]            = "ok",
+             client_name[SSIZE]       = "",
+             client_host[SSIZE]       = "",
+             psrp_channel_name[SSIZE] = "";
 
-          /*---------------------------*/
-          /* ssh is using default port */
-          /*---------------------------*/
 
-          (void)strlcpy(ssh_remote_port,"",SSIZE);
-       else 
-       {  
+    /*------------------------------------------------------*/
+    /* Take a copy of what we need from the client table    */
+    /* (the root thread updates it under the same lock)     */
+    /*------------------------------------------------------*/
 
-          /*------------------------------------------------*/
-          /* ssh is using user defined port. This is useful */
-          /* when the remote psrp server is running is a    */
-          /* container                                      */
-          /*------------------------------------------------*/
+    (void)pthread_mutex_lock(&psrp_sock_mutex);
 
-          (void)fprintf(psrp_out,"remote ssh port must be an (>= 0)\n");
-          (void)fflush(psrp_out);
+    client = psrp_sock_client[work->s_index];
+    pid    = psrp_sock_pid[work->s_index];
 
-          return(PSRP_OK);
-       }
+    if(psrp_sock_gen[work->s_index] != work->gen || (client != (-1) && psrp_client_pid[client] != pid))
+       client = (-1);
+    else if(client != (-1))
+    {  ++psrp_transactions[client];
+
+       log = psrp_log[client];
+       (void)strlcpy(client_name,psrp_client_name[client],SSIZE);
+       (void)strlcpy(client_host,psrp_client_host[client],SSIZE);
     }
-    else 
-       (void)strlcpy(ssh_remote_port,port_id,SSIZE);
 
-    if(strcmp(port_id,"default") == 0)
-       (void)fprintf(psrp_out,"using default port (22) for ssh\n");
-    else
-       (void)fprintf(psrp_out,"using (remote) port (%s) for ssh\n",ssh_remote_port);
-    (void)fflush(psrp_out);
-    
-    return(PSRP_OK);
-}
-#endif /* SSH_SUPPORT */
+    (void)pthread_mutex_unlock(&psrp_sock_mutex);
 
+    if(client == (-1))
+    {  psrp_sock_drop(work->s_index,work->gen);
+       return;
+    }
 
+    psrp_sock_strip(work->request);
 
+    if((mdes = memfd_create("psrp_reply",MFD_CLOEXEC)) == (-1) || (reply_stream = fdopen(mdes,"w+")) == (FILE *)NULL)
+    {  if(mdes != (-1))
+          (void)close(mdes);
 
-/*-------------------------------------------------*/
-/* Switch error logging on or off from PSRP client */
-/*-------------------------------------------------*/
+       psrp_sock_drop(work->s_index,work->gen);
+       return;
+    }
 
-_PRIVATE int32_t psrp_builtin_transactions(const uint32_t argc, const char *argv[])
 
-{   if(strcmp("log",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    /*-----------------------------------------------------*/
+    /* psrp_out is thread local, so the action function    */
+    /* writes to this request's reply (and not to the root */
+    /* thread's client channel)                            */
+    /*-----------------------------------------------------*/
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: transactions [on | off]\n\n");
-       (void)fflush(psrp_out);
+    psrp_out = reply_stream;
 
-       return(PSRP_OK);
-    }
+    (void)snprintf(psrp_channel_name,SSIZE,"%s/psrp#%s#%d#%d",appl_fifo_dir,appl_name,appl_pid,getuid());
+    (void)fprintf(psrp_out,"(%s)\n",psrp_channel_name);
 
-    if(strcmp(argv[1],"on") == 0)
-    {  (void)fprintf(psrp_out,"\nserver transaction logging enabled\n\n");
+    if(log == TRUE)
+    {  (void)fprintf(psrp_out,"\nPSRP (protocol %5.2F) request \"%s\" received by %s (%d@%s:%s) from %s (%d@%s) [concurrent]\n\n",
+                                                                                                            PSRP_PROTOCOL_VERSION,
+                                                                                                      work->request,appl_name,
+                                                                                                    appl_pid,appl_host,appl_owner,
+                                                                                                                      client_name,
+                                                                                                                              pid,
+                                                                                                                     client_host);
        (void)fflush(psrp_out);
-
-       psrp_log[c_client] = TRUE;
-       return(PSRP_OK);
     }
-    else
-    {  if(strcmp(argv[1],"off") == 0)
-       {  (void)fprintf(psrp_out,"\nserver transaction logging disabled\n\n");
-          (void)fflush(psrp_out);
 
-          psrp_log[c_client] = FALSE;
-          return(PSRP_OK);
-       }
-       else
-       {  (void)fprintf(psrp_out,"\nusage: transactions [on | off]\n\n");
-          (void)fflush(psrp_out);
+    for(next_arg = strtok_r(work->request," ",&save_ptr); next_arg != (char *)NULL && r_argc < MAX_CMD_ARGS - 1; next_arg = strtok_r((char *)NULL," ",&save_ptr))
+       r_argv[r_argc++] = next_arg;
 
-          return(PSRP_OK);
-       }
+    started = psrp_latency_now();
+    if((status = (*work->func)(r_argc,(const char **)r_argv)) < 0 && psrp_error_handling == TRUE)
+    {  (void)fprintf(psrp_out,"    Command returned error (%s)\n",r_argv[0]);
+       (void)strlcpy(c_code,"err",SSIZE);
     }
 
-    return(PSRP_DISPATCH_ERROR);
-}
+    (void)fprintf(psrp_out,"EOT %s\n",c_code);
+    psrp_endop("psrp");
 
+    psrp_out   = (FILE *)NULL;
+    dispatched = psrp_latency_now();
 
 
+    /*-----------------*/
+    /* Send reply back */
+    /*-----------------*/
 
+    if((size = (ssize_t)ftell(reply_stream)) > 0)
+    {  reply = (char *)mmap((void *)NULL,size,PROT_READ,MAP_SHARED,fileno(reply_stream),0);
 
-/*-------------------------*/
-/* Load new dispatch table */
-/*-------------------------*/
+       if(reply == (char *)MAP_FAILED || psrp_sock_reply_send(work->s_index,work->gen,work->seq,reply,size) == (-1))
+          psrp_sock_drop(work->s_index,work->gen);
 
-_PRIVATE int32_t psrp_builtin_autosave_dispatch_table(const uint32_t argc, const char *argv[])
+       if(reply != (char *)MAP_FAILED)
+          (void)munmap((void *)reply,size);
+    }
 
-{   char item[SSIZE] = "";
+    psrp_latency_record((r_argc > 0) ? r_argv[0] : "",client,work->seq,work->queued,started,dispatched,psrp_latency_now());
+    (void)fclose(reply_stream);
+}
 
-    if(strcmp("autosave",argv[0]) != 0)
-        return(PSRP_DISPATCH_ERROR);
 
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: autosave [on | off]\n\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
 
-    if(argc > 1)
-    {  if(strcmp(argv[1],"on") == 0)
-          appl_psrp_save = TRUE;
-       else if(strcmp(argv[1],"off") == 0)
-          appl_psrp_save = FALSE;
-       else
-       {  (void)fprintf(psrp_out,"   \nusage: autosave [on | off]\n\n");
-          (void)fflush(psrp_out);         
- 
-          return(PSRP_OK);
-       }
-    }
+/*-------------------------------------------*/
+/* Socket transport worker (pool) thread     */
+/*-------------------------------------------*/
 
-    if(appl_psrp_save == TRUE)
-       (void)fprintf(psrp_out,"\n   Dispatch table automatically saved when application exits (to ~/.%s.psrp)\n\n",
-                                                                                                         appl_name);
-    else
-       (void)fprintf(psrp_out,"\n   Dispatch table is not automatically saved when application exits\n\n");
+_PRIVATE void *psrp_sock_worker(void *arg)
 
-    (void)fflush(psrp_out);
+{   psrp_sock_work_type *work = (psrp_sock_work_type *)NULL;
 
-    return(PSRP_OK);
-}
+    while(TRUE)
+    {  (void)pthread_mutex_lock(&psrp_work_mutex);
 
+       while(psrp_work_head == (psrp_sock_work_type *)NULL && psrp_sock_shutdown == FALSE)
+          (void)pthread_cond_wait(&psrp_work_cond,&psrp_work_mutex);
 
+       if(psrp_sock_shutdown == TRUE)
+       {  (void)pthread_mutex_unlock(&psrp_work_mutex);
+          break;
+       }
 
+       work = psrp_work_head;
+       if((psrp_work_head = work->next) == (psrp_sock_work_type *)NULL)
+          psrp_work_tail = (psrp_sock_work_type *)NULL;
 
-/*--------------------------*/
-/* Load new dispatch table  */
-/*--------------------------*/
+       (void)pthread_mutex_unlock(&psrp_work_mutex);
 
-_PRIVATE int32_t psrp_builtin_load_dispatch_table(const uint32_t argc, const char *argv[])
+       if(psrp_sock_concurrent_begin(work) == TRUE)
+       {  psrp_sock_run_concurrent(work);
 
-{   char item[SSIZE] = "";
+          (void)free((void *)work->request);
+          (void)free((void *)work);
 
-    if(strcmp("load",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: load <PSRP resource file name>\n\n");
-       (void)fflush(psrp_out);
+          /*---------------------------------------------*/
+          /* Wake root thread if it is waiting to remove */
+          /* a concurrent function                       */
+          /*---------------------------------------------*/
 
-       return(PSRP_OK);
-    }
+          (void)pthread_mutex_lock(&psrp_sock_mutex);
 
-    (void)psrp_load_dispatch_table(TRUE,argv[1]);
+          if(--psrp_concurrent_running == 0)
+             (void)pthread_cond_broadcast(&psrp_concurrent_cond);
 
-    (void)fprintf(psrp_out,"\nPSRP resource file %s loaded (commands appended to existing dispatch table)\n",argv[1]);
-    (void)fflush(psrp_out);
+          (void)pthread_mutex_unlock(&psrp_sock_mutex);
+       }
+    }
 
-    return(PSRP_OK);
+    return((void *)NULL);
 }
 
 
 
-/*---------------------*/
-/* Save dispatch table */
-/*---------------------*/
 
-_PRIVATE int32_t psrp_builtin_save_dispatch_table(const uint32_t argc, const char *argv[])
+/*-----------------------------------------------------------------*/
+/* Start socket transport event loop (and worker pool). On failure */
+/* the listener is left signal (SIGPSRPIO) driven                  */
+/*-----------------------------------------------------------------*/
 
-{   char item[SSIZE] = "";
+_PRIVATE int32_t psrp_sock_start(void)
 
-    if(strcmp("save",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+{   uint32_t           i;
+    pthread_t          tid;
+    sigset_t           set,
+                       old_set;
+    struct epoll_event event;
 
-    if(argc != 2)
-    {  (void)fprintf(psrp_out,"\nusage: save <PSRP resource file name>\n\n");
-       (void)fflush(psrp_out);
+    if((psrp_epoll_des = epoll_create1(EPOLL_CLOEXEC)) == (-1))
+       return(-1);
 
-       return(PSRP_OK);
+    if((psrp_wake_des = eventfd(0,EFD_NONBLOCK | EFD_CLOEXEC)) == (-1))
+    {  (void)close(psrp_epoll_des);
+       psrp_epoll_des = (-1);
+
+       return(-1);
     }
 
-    (void)psrp_save_dispatch_table(argv[1]);
+    event.events   = EPOLLIN;
+    event.data.u64 = PSRP_SOCK_WAKE_TOKEN;
 
-    (void)fprintf(psrp_out,"\nPSRP resource file %s saved (contains all current dispatch table objects)\n\n",argv[1]);
-    (void)fflush(psrp_out);
+    if(epoll_ctl(psrp_epoll_des,EPOLL_CTL_ADD,psrp_wake_des,&event) == (-1))
+       goto start_failed;
 
-    return(PSRP_OK);
+    event.data.u64 = PSRP_SOCK_LISTEN_TOKEN;
 
-}
+    if(epoll_ctl(psrp_epoll_des,EPOLL_CTL_ADD,psrp_listen_des,&event) == (-1) ||
+       fcntl(psrp_listen_des,F_SETFL,O_NONBLOCK)                       == (-1)  )
+       goto start_failed;
 
 
+    /*-----------------------------------------------------------*/
+    /* Service threads must not take any signals - they are all  */
+    /* handled by the root thread                                */
+    /*-----------------------------------------------------------*/
 
+    psrp_sock_threaded = TRUE;
 
-/*----------------------*/
-/* Reset dispatch table */
-/*----------------------*/
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_SETMASK,&set,&old_set);
 
-_PRIVATE int32_t psrp_builtin_reset_dispatch_table(const uint32_t argc, const char *argv[])
+    if(pthread_create(&psrp_sock_tid,(pthread_attr_t *)NULL,psrp_sock_thread,(void *)NULL) != 0)
+    {  (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
 
-{   char item[SSIZE] = "";
+       psrp_sock_threaded = FALSE;
+       (void)fcntl(psrp_listen_des,F_SETFL,O_NONBLOCK | O_ASYNC);
 
-    if(strcmp("reset",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+       goto start_failed;
+    }
 
-    (void)psrp_reset_dispatch_table();
+    for(i=0; i<psrp_sock_workers; ++i)
+    {  if(pthread_create(&tid,(pthread_attr_t *)NULL,psrp_sock_worker,(void *)NULL) == 0)
+       {  (void)pthread_detach(tid);
+          ++psrp_sock_workers_running;
+       }
+    }
 
-    (void)fprintf(psrp_out,"\ndispatch table reset to default state (static aliases deleted and dynamic objects detached)\n\n");
-    (void)fflush(psrp_out);
+    (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
 
-    return(PSRP_OK);
-}
+    pups_set_errno(OK);
+    return(0);
 
+start_failed:
 
+    (void)close(psrp_wake_des);
+    (void)close(psrp_epoll_des);
 
+    psrp_wake_des  = (-1);
+    psrp_epoll_des = (-1);
 
+    return(-1);
+}
 
-/*-------------------------*/
-/* Builtin function detach */
-/*-------------------------*/
 
-_PRIVATE int32_t psrp_builtin_detach_object(const uint32_t argc, const char *argv[])
 
-{   uint32_t i;
-     int32_t ret_code;
 
-    char     item[SSIZE] = "";
+/*-----------------------------------------------------------------*/
+/* Stop socket transport event loop. Workers are not joined (they  */
+/* may be running a long request), they exit when next woken       */
+/*-----------------------------------------------------------------*/
 
-    if(strcmp("detach",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PRIVATE void psrp_sock_stop(void)
 
-    if(argc < 2)
-    {  psrp_error("Usage: detach <object-list>");
-       return(PSRP_OK);
-    }
+{   uint64_t            wake  = 1;
+    sigset_t            old_set;
+    psrp_sock_work_type *work = (psrp_sock_work_type *)NULL,
+                        *next = (psrp_sock_work_type *)NULL;
 
-    for(i=1; i<argc; ++i)
-    {  
+    if(psrp_sock_threaded == FALSE)
+       return;
 
-        /*---------------------------------------------------------------*/
-        /* If object is "all" then detach all dynamic objects and re-set */
-        /* alias list of all static objects                              */
-        /*---------------------------------------------------------------*/
+    psrp_sock_shutdown = TRUE;
+    (void)write(psrp_wake_des,&wake,sizeof(uint64_t));
+    (void)pthread_join(psrp_sock_tid,(void **)NULL);
 
-        if(strcmp(argv[i],"all") == 0)
-        {  psrp_reset_dispatch_table();
+    (void)pthread_mutex_lock(&psrp_work_mutex);
+    (void)pthread_cond_broadcast(&psrp_work_cond);
 
-           (void)fprintf(psrp_out,"\nall objects detached\n");
-           (void)fflush(psrp_out);
+    work           = psrp_work_head;
+    psrp_work_head = (psrp_sock_work_type *)NULL;
+    psrp_work_tail = (psrp_sock_work_type *)NULL;
 
-           return(PSRP_OK);
-        }
+    (void)pthread_mutex_unlock(&psrp_work_mutex);
 
-        ret_code = psrp_detach_object_by_name(argv[i]);
- 
-        switch(ret_code)
-        {   case PSRP_DISPATCH_ERROR:    (void)fprintf(psrp_out,"\ndynamic object not in PSRP handler dispatch_list (%s)\n",argv[i]);
-                                         break;
- 
-            case PSRP_DYNAMIC_FUNCTION:  (void)fprintf(psrp_out,"\ndynamic function detached (%s)\n",argv[i]);
-                                         break;
 
-            case PSRP_DYNAMIC_DATABAG:   (void)fprintf(psrp_out,"\ndynamic databag detached (%s)\n",argv[i]);
-                                         break;
+    /*------------------------------------------------*/
+    /* Free requests which were queued but never run  */
+    /*------------------------------------------------*/
 
-            case PSRP_PERSISTENT_HEAP:   (void)fprintf(psrp_out,"\npersistent heap detached (%s)\n",argv[i]);
-                                         break;
+    while(work != (psrp_sock_work_type *)NULL)
+    {  next = work->next;
 
-            default:                     (void)fprintf(psrp_out,"\ndynamic object detached (%s)\n",argv[i]);
-                                         break;
-        }
-        (void)fflush(psrp_out);
-    }
+       (void)free((void *)work->request);
+       (void)free((void *)work);
 
-    (void)fprintf(psrp_out,"\n");
-    (void)fflush(psrp_out);
+       work = next;
+    }
 
-    return(PSRP_OK);
-}
+    psrp_sock_lock(&old_set);
 
+    work             = psrp_serial_head;
+    psrp_serial_head = (psrp_sock_work_type *)NULL;
+    psrp_serial_tail = (psrp_sock_work_type *)NULL;
 
+    psrp_sock_unlock(&old_set);
 
-/*---------------------------------------------------*/
-/* Builtin function to display current PSRP bindings */
-/*---------------------------------------------------*/
+    while(work != (psrp_sock_work_type *)NULL)
+    {  next = work->next;
 
-_PRIVATE int32_t psrp_builtin_show_hinfo(const uint32_t  argc, const char *argv[])
+       (void)free((void *)work->request);
+       (void)free((void *)work);
 
-{   char machtype[SSIZE]  = "",
-         ostype[SSIZE]    = "",
-         hosttype[SSIZE]  = "";
+       work = next;
+    }
 
-    if(strcmp("hinfo",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    (void)close(psrp_wake_des);
+    (void)close(psrp_epoll_des);
 
+    psrp_wake_des      = (-1);
+    psrp_epoll_des     = (-1);
+    psrp_sock_threaded = FALSE;
+}
+#endif /* PTHREAD_SUPPORT */
 
-    /*---------------------------------------------*/
-    /* Set up command tail decoder for this object */
-    /*---------------------------------------------*/
 
-    if(psrp_std_init(argc,argv) == FALSE)
-       return(PSRP_OK);
 
 
-    /*------------------------------------------------------*/
-    /* Check that there is no junk left on the command line */
-    /*------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/* Send (framed) message over PSRP socket transport. Messages are   */
+/* split into PSRP_FRAME_PAYLOAD sized frames, each is a single     */
+/* SOCK_SEQPACKET packet                                            */
+/*------------------------------------------------------------------*/
 
-    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
-       return(PSRP_OK);
+_PUBLIC int32_t psrp_sock_send(const des_t des, const uint32_t seq, const char *buf, const size_t size)
 
+{   return(psrp_sock_sendmsg(des,seq,0,buf,size));
+}
 
-    /*------------------------------------------*/
-    /* Show client current PSRP action bindings */
-    /*------------------------------------------*/
 
-    if(getenv("MACHTYPE") != (char *)NULL && getenv("OSTYPE") != (char *)NULL && getenv("HOSTTYPE") != (char *)NULL)
-    {  (void)strlcpy(machtype,getenv("MACHTYPE"),SSIZE);
-       (void)strlcpy(ostype,  getenv("OSTYPE"),SSIZE);
-       (void)strlcpy(hosttype,getenv("HOSTTYPE"),SSIZE);
 
-       (void)fprintf(psrp_out,"\nPSRP server \"%s\" running on %s.%s (%s)\n",appl_name,machtype,ostype,hosttype);
-       (void)fprintf(psrp_out,"using named pipes (FIFO) for PSRP channels\n\n");
-       (void)fflush(psrp_out);
-    }
-    else
-    {  (void)fprintf(psrp_out,"\nHost information is not available\n\n");
-       (void)fflush(psrp_out);
-    }
 
-    return(PSRP_OK);
-}
+/*----------------------------------------------------------------*/
+/* Send (framed) message with message flags (e.g. PSRP_FRAME_BATCH) */
+/*----------------------------------------------------------------*/
 
+_PUBLIC int32_t psrp_sock_sendmsg(const des_t des, const uint32_t seq, const uint32_t flags, const char *buf, const size_t size)
 
+{   size_t                 sent = 0;
+    psrp_frame_header_type header;
+    struct iovec           iov[2];
+    struct msghdr          msg;
 
+    if(des < 0 || buf == (const char *)NULL || size == 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-/*---------------------------------------------------*/
-/* Builtin function to display current PSRP bindings */
-/*---------------------------------------------------*/
- 
-_PRIVATE int32_t psrp_builtin_show_psrp_state(const uint32_t argc, const char *argv[])
- 
-{   if(strcmp("show",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR); 
+    if(size > PSRP_FRAME_MAX_MESSAGE)
+    {  pups_set_errno(EMSGSIZE);
+       return(-1);
+    }
 
+    (void)memset((void *)&msg,0,sizeof(struct msghdr));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = 2;
 
-    /*---------------------------------------------*/
-    /* Set up command tail decoder for this object */
-    /*---------------------------------------------*/
+    do {    size_t frame_size = size - sent;
 
-    if(psrp_std_init(argc,argv) == FALSE)
-       return(PSRP_OK);
+            if(frame_size > PSRP_FRAME_PAYLOAD)
+               frame_size = PSRP_FRAME_PAYLOAD;
 
+            header.magic  = PSRP_FRAME_MAGIC;
+            header.length = (uint32_t)frame_size;
+            header.flags  = (sent + frame_size < size) ? (flags | PSRP_FRAME_MORE) : flags;
+            header.seq    = seq;
 
-    /*------------------------------------------------------*/ 
-    /* Check that there is no junk left on the command line */
-    /*------------------------------------------------------*/ 
+            iov[0].iov_base = (void *)&header;
+            iov[0].iov_len  = sizeof(psrp_frame_header_type);
+            iov[1].iov_base = (void *)&buf[sent];
+            iov[1].iov_len  = frame_size;
 
-    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
-       return(PSRP_OK);
+            while(sendmsg(des,&msg,MSG_NOSIGNAL) == (-1))
+            {  struct pollfd pfd;
 
+               if(errno == EINTR)
+                  continue;
+               else if(errno != EAGAIN)
+                  return(-1);
 
-    /*------------------------------------------*/
-    /* Show client current PSRP action bindings */ 
-    /*------------------------------------------*/
+               pfd.fd     = des;
+               pfd.events = POLLOUT;
+               (void)poll(&pfd,1,(-1));
+            }
 
-    psrp_show_object_list();
+            sent += frame_size;
+       } while(sent < size);
 
-    return(PSRP_OK);
+    pups_set_errno(OK);
+    return(0);
 }
 
 
 
-/*-------------------------------------------------------------------------------*/
-/* Builtin function to display current object binding types permitted on process */
-/*-------------------------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_psrp_bind_type(const uint32_t argc, const char *argv[])
+/*------------------------------------------------------------------*/
+/* Receive (framed) message from PSRP socket transport. The message */
+/* is assembled in *buf (grown as required) and is NULL terminated. */
+/* Returns message length, 0 at end of file, or -1 on error (empty  */
+/* messages cannot be sent, so 0 is unambiguous)                    */
+/*------------------------------------------------------------------*/
 
-{   if(strcmp("bindtype",argv[0]) != 0) 
-       return(PSRP_DISPATCH_ERROR);  
+_PUBLIC ssize_t psrp_sock_recv(const des_t des, uint32_t *seq, char **buf, size_t *buf_size)
 
+{   uint32_t flags;
 
-    /*---------------------------------------------*/
-    /* Set up command tail decoder for this object */
-    /*---------------------------------------------*/
-
-    if(psrp_std_init(argc,argv) == FALSE)
-       return(PSRP_OK);
-
+    return(psrp_sock_recvmsg(des,seq,&flags,buf,buf_size));
+}
 
-    /*------------------------------------------------------*/ 
-    /* Check that there is no junk left on the command line */
-    /*------------------------------------------------------*/ 
 
-    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)    
-       return(PSRP_OK);
 
 
-    /*----------------------------------------------------------------*/
-    /* Tell client process the type of PSRP object bindings permitted */
-    /*----------------------------------------------------------------*/
+/*----------------------------------------------------------------*/
+/* Receive (framed) message, returning its message flags (with    */
+/* PSRP_FRAME_MORE masked out)                                    */
+/*----------------------------------------------------------------*/
 
-    (void)fprintf(psrp_out,"\n    PSRP server interface (protocol %5.2F) bind status\n\n",PSRP_PROTOCOL_VERSION);
-    (void)fflush(psrp_out);
+_PUBLIC ssize_t psrp_sock_recvmsg(const des_t des, uint32_t *seq, uint32_t *flags, char **buf, size_t *buf_size)
 
-    if(psrp_bind_status & PSRP_STATUS_ONLY)
-       (void)fprintf(psrp_out,"    PSRP interface supports status reporting only\n");
-    else
-    {  if(psrp_bind_status & PSRP_STATIC_DATABAG)
-          (void)fprintf(psrp_out,"    Databags:  static binding enabled (cannot import databags)\n");
+{   size_t                 len = 0;
+    ssize_t                ret;
+    psrp_frame_header_type header;
+    struct iovec           iov[2];
+    struct msghdr          msg;
 
-       if(psrp_bind_status & PSRP_DYNAMIC_DATABAG)
-          (void)fprintf(psrp_out,"    Databags:  dynamic binding enabled (can import databags)\n");
+    if(des < 0 || seq == (uint32_t *)NULL || flags == (uint32_t *)NULL || buf == (char **)NULL || buf_size == (size_t *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-       if(psrp_bind_status & PSRP_STATIC_FUNCTION)
-          (void)fprintf(psrp_out,"    Functions: static binding enabled (cannot import DLL functions)\n");
+    (void)memset((void *)&msg,0,sizeof(struct msghdr));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = 2;
 
-       if(psrp_bind_status & PSRP_PERSISTENT_HEAP)
-          (void)fprintf(psrp_out,"    Heaps: dynamic binding enabled (can import persistent heaps) [%d heap slots allocated]\n",appl_max_pheaps);
+    do {
 
-       #ifdef DLL_SUPPORT
-       if(psrp_bind_status & PSRP_DYNAMIC_FUNCTION)
-          (void)fprintf(psrp_out,"    Functions: dynamic binding enabled (can import DLL functions) [%d orifices allocated]\n\n",appl_max_orifices);
-       #endif /* DLL_SUPPORT */
+            /*----------------------------------------------------*/
+            /* Message length is only known once all its frames   */
+            /* have arrived so cap it before we allocate any more */
+            /*----------------------------------------------------*/
 
-    }
+            if(len + PSRP_FRAME_PAYLOAD > PSRP_FRAME_MAX_MESSAGE)
+            {  pups_set_errno(EMSGSIZE);
+               return(-1);
+            }
 
-    if(psrp_bind_status & PSRP_HOMEOSTATIC_STREAMS)
-       (void)fprintf(psrp_out,"    Streams: PSRP channels are hoemostatic\n\n");
-    
-    (void)fflush(psrp_out);
-    return(PSRP_OK);
-}
+            if(*buf == (char *)NULL || *buf_size < len + PSRP_FRAME_PAYLOAD + 1)
+            {  char *new_buf = (char *)NULL;
 
 
+               /*----------------------------------------------------*/
+               /* Not pups_realloc - this may be called by the socket */
+               /* transport event loop thread                         */
+               /*----------------------------------------------------*/
 
+               if((new_buf = (char *)realloc((void *)*buf,len + PSRP_FRAME_PAYLOAD + 1)) == (char *)NULL)
+               {  pups_set_errno(ENOMEM);
+                  return(-1);
+               }
 
-/*---------------------------------------------------*/
-/* Builtin function to terminate PSRP server process */
-/*---------------------------------------------------*/
+               *buf      = new_buf;
+               *buf_size = len + PSRP_FRAME_PAYLOAD + 1;
+            }
 
-_PRIVATE int32_t psrp_builtin_terminate_process(const uint32_t argc, const char *argv[])
- 
-{   sigset_t set;
+            iov[0].iov_base = (void *)&header;
+            iov[0].iov_len  = sizeof(psrp_frame_header_type);
+            iov[1].iov_base = (void *)&(*buf)[len];
+            iov[1].iov_len  = PSRP_FRAME_PAYLOAD;
 
-    if(strcmp("terminate",argv[0]) != 0 && strcmp("kill",argv[0]) != 0) 
-       return(PSRP_DISPATCH_ERROR); 
+            while((ret = recvmsg(des,&msg,0)) == (-1))
+            {  struct pollfd pfd;
 
+               if(errno == EINTR)
+                  continue;
+               else if(errno != EAGAIN)
+                  return(-1);
 
-    (void)sigfillset(&set);
-    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
+               pfd.fd     = des;
+               pfd.events = POLLIN;
+               (void)poll(&pfd,1,(-1));
+            }
 
 
-    /*--------------------------------------*/
-    /* Client termination of server process */
-    /*--------------------------------------*/
+            /*-------------------------------------*/
+            /* End of file (peer closed) - only an */
+            /* error if it truncates a message     */
+            /*-------------------------------------*/
 
-    if (appl_verbose == TRUE)
-    {  (void)fprintf(stderr,"\n%s (%d@%s) terminated by PSRP client\n\n",appl_name,appl_pid,appl_host);
-       (void)fflush(stderr);
-    }
+            if(ret == 0)
+            {  if(len > 0)
+               {  pups_set_errno(EPIPE);
+                  return(-1);
+               }
 
+               pups_set_errno(OK);
+               return(0);
+            }
 
-    /*------------------------------------------------------------------------------------*/
-    /* Commit suicide explicitly to invoke handler - just in case we are a session leader */
-    /*------------------------------------------------------------------------------------*/
+            if((size_t)ret < sizeof(psrp_frame_header_type)                   ||
+               header.magic  != PSRP_FRAME_MAGIC                               ||
+               header.length != (size_t)ret - sizeof(psrp_frame_header_type)   ||
+               (len > 0 && header.seq != *seq)                                  )
+            {  pups_set_errno(EPROTO);
+               return(-1);
+            }
 
+            *seq   = header.seq;
+            *flags = header.flags & ~PSRP_FRAME_MORE;
+            len   += header.length;
+       } while(header.flags & PSRP_FRAME_MORE);
 
-    if (appl_pg_leader == TRUE)
-       (void)killpg(appl_pid,SIGTERM);
+    (*buf)[len] = '\0';
 
-    pups_exit(255);
+    pups_set_errno(OK);
+    return((ssize_t)len);
 }
 
 
 
 
 /*----------------------------------------------------------------*/
-/* Builtin function to add an alias the tag list of a PSRP object */
+/* Connect to PSRP server socket transport. The server replies to */
+/* "OPEN" with its segment count (or "ENOCH" if we have not       */
+/* previously connected via its FIFOs)                            */
 /*----------------------------------------------------------------*/
- 
-_PRIVATE int32_t psrp_builtin_alias(const uint32_t argc, const char *argv[])
- 
-{   if(strcmp("alias",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
- 
-    if(argc != 3 || strcmp(argv[1],"-help") == 0 || strcmp(argv[1],"-usage") == 0)
-    {  psrp_error("usage: alias <PSRP object name> <alias to PSRP object name>");
-       return(PSRP_OK);
-    }
- 
-    if(psrp_alias(argv[1],argv[2]) == PSRP_DISPATCH_ERROR)
-    {  if(psrp_alias(argv[2],argv[1]) == PSRP_DISPATCH_ERROR)
-       {  psrp_error("psrp_builtin_alias: problem with alias (builtin or not unique or not found)");
-          return(PSRP_OK);
-       }
-
-       (void)fprintf(psrp_out,"\"%s\" is now an alias of \"%s\"\n",argv[1],argv[2]);
-       (void)fflush(psrp_out);
-    }   
 
-    (void)fprintf(psrp_out,"\"%s\" is now an alias of \"%s\"\n",argv[2],argv[1]);
-    (void)fflush(psrp_out);
- 
-    return(PSRP_OK);
-}
+_PUBLIC des_t psrp_sock_connect(const char *socket_name, const char *password, int32_t *seg_cnt)
 
+{   des_t              des;
+    uint32_t           seq;
+    size_t             buf_size = 0;
+    char               *buf     = (char *)NULL,
+                       open_str[SSIZE] = "";
 
+    struct sockaddr_un addr;
 
+    if(socket_name == (const char *)NULL || password == (const char *)NULL || (size_t)pups_strlen(socket_name) >= sizeof(addr.sun_path))
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-/*----------------------------------------------------------*/
-/* Builtin function to show clients attached to this server */
-/*----------------------------------------------------------*/
+    (void)memset((void *)&addr,0,sizeof(struct sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    (void)strlcpy(addr.sun_path,socket_name,sizeof(addr.sun_path));
 
-_PRIVATE int32_t psrp_builtin_show_clients(const uint32_t argc, const char *argv[])
+    if((des = socket(AF_UNIX,SOCK_SEQPACKET | SOCK_CLOEXEC,0)) == (-1))
+       return(-1);
 
-{   if(strcmp("clients",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    if(connect(des,(struct sockaddr *)&addr,sizeof(struct sockaddr_un)) == (-1))
+    {  (void)close(des);
+       return(-1);
+    }
 
-    if(argc > 1 || strcmp(r_argv[1],"usage") == 0)
-    {  (void)fprintf(psrp_out,"usage: clients [usage]\n");
-       (void)fflush(psrp_out);
+    (void)snprintf(open_str,SSIZE,"OPEN %d %s",appl_pid,password);
+    if(psrp_sock_send(des,0,open_str,pups_strlen(open_str)) == (-1) || psrp_sock_recv(des,&seq,&buf,&buf_size) <= 0)
+    {  (void)pups_free((void *)buf);
+       (void)close(des);
 
-       return(PSRP_OK);
+       pups_set_errno(ECONNREFUSED);
+       return(-1);
     }
 
-    if(argc != 1)
-    {  psrp_error("usage: clients");
-       return(PSRP_OK);
+    if(sscanf(buf,"%d",seg_cnt) != 1)
+    {  (void)pups_free((void *)buf);
+       (void)close(des);
+
+       pups_set_errno(ECONNREFUSED);
+       return(-1);
     }
 
-    (void)psrp_show_clients();
-    return(PSRP_OK);
+    (void)pups_free((void *)buf);
+
+    pups_set_errno(OK);
+    return(des);
 }
 
 
- 
 
-/*----------------------------------------------------------------*/
-/* Builtin function to add an alias the tag list of a PSRP object */
-/*----------------------------------------------------------------*/
- 
-_PRIVATE int32_t psrp_builtin_unalias(const uint32_t argc, const char *argv[])
- 
-{   int32_t ret;
-    char    basename[SSIZE] = "";
- 
-    if(strcmp("unalias",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
- 
-    if(argc != 2 || strcmp(r_argv[1],"usage") == 0)
-    {  psrp_error("usage: unalias <PSRP object name alias>");
-       return(PSRP_OK);
-    }
- 
-    if((ret = psrp_unalias(argv[1],basename)) == PSRP_TAG_ERROR)
-       psrp_error("psrp_builtin_alias: alias cannot be removed (or object would become untagged)");
-    else
-    {  if(ret == PSRP_DISPATCH_ERROR)
-       {  (void)fprintf(psrp_out,"psrp_builtin_alias: \"%s\" is not a tag name of any attached PSRP object\n",argv[1]);
-          (void)fflush(psrp_out);
-       }
-       else
-       {  (void)fprintf(psrp_out,"\"%s\" is no longer an alias of \"%s\"\n",argv[1],basename);
-          (void)fflush(psrp_out);
-       }
-    }
-       
-    return(PSRP_OK);
-}
- 
- 
- 
- 
 
-/*----------------------------------------------*/
-/* Builtin function to show aliases of tag name */
-/*----------------------------------------------*/
+/*--------------------------------------------------------------*/
+/* Send request and get reply over PSRP socket transport. Stale */
+/* replies (sequence numbers of abandoned requests) are skipped */
+/*--------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_showaliases(const uint32_t argc, const char *argv[])
+_PUBLIC ssize_t psrp_sock_request(const des_t des, const uint32_t seq, const char *request, char **reply, size_t *reply_size)
 
-{   if(strcmp("showaliases",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+{   ssize_t  size;
+    uint32_t r_seq;
 
-    if(argc != 2)
-    {  psrp_error("usage: showaliases <of PSRP object tagname>");
-       return(PSRP_OK);
+    if(request == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
-    psrp_show_aliases(argv[1]);
-    return(PSRP_OK);
+    if(psrp_sock_send(des,seq,request,pups_strlen(request)) == (-1))
+       return(-1);
+
+    do {    if((size = psrp_sock_recv(des,&r_seq,reply,reply_size)) <= 0)
+            {  if(size == 0)
+                  pups_set_errno(EPIPE);
+
+               return(-1);
+            }
+       } while(r_seq != seq);
+
+    return(size);
 }
 
 
 
 
 /*-------------------------------------------------------------------*/
-/* Create a new instance of the current process - the old process is */
-/* terminated and a new instance of it is created - this permits the */
-/* user to modify the PSRP dispatch tables associated with a process */
-/* without effecting the parent                                      */
+/* Pipeline requests over PSRP socket transport. Up to window        */
+/* requests (tagged first_seq, first_seq + 1, ...) are outstanding   */
+/* at once. The server may reply out of order, replies are matched   */
+/* to requests by tag. The window stops client and server deadlocking */
+/* with both socket buffers full. Returns number of replies (the     */
+/* caller frees replies[])                                           */
 /*-------------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_new_instance(const uint32_t r_argc, const char *r_argv[])
-
-{ 
-     int32_t ret;
-
-    char n_i_name[SSIZE] = "",
-         n_i_host[SSIZE] = "notset"; 
+_PUBLIC int32_t psrp_sock_pipeline(const des_t      des,          // Socket transport connection
+                                   const uint32_t   first_seq,    // Tag of first request
+                                   const uint32_t   n_requests,   // Number of requests
+                                   const char       *requests[],  // Requests
+                                   const uint32_t   window,       // Maximum outstanding requests
+                                   char             *replies[],   // Replies (in request order)
+                                   size_t           reply_size[]) // Sizes of reply buffers
 
-    if(strcmp("new",r_argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+{   uint32_t i,
+             r_seq,
+             r_flags,
+             sent      = 0,
+             collected = 0,
+             eff_window;
 
+    ssize_t  size;
+    size_t   buf_size  = 0;
+    char     *buf      = (char *)NULL;
 
-    /*--------------*/
-    /* Sanity check */
-    /*--------------*/
+    if(des < 0 || requests == (const char **)NULL || replies == (char **)NULL || reply_size == (size_t *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-    if(r_argc < 2 || r_argc > 4 || strcmp(r_argv[1],"-usage") == 0)
-    {  (void)fprintf(psrp_out,"usage: new [keep | segment (current instance)] [<new instance name>] [<exec host>]\n");
-       (void)fflush(psrp_out);
+    eff_window = (window == 0) ? PSRP_PIPELINE_WINDOW : window;
 
-       return(PSRP_OK);
+    for(i=0; i<n_requests; ++i)
+    {  replies[i]    = (char *)NULL;
+       reply_size[i] = 0;
     }
 
-    if(r_argc == 4 && strcmp(r_argv[1],"segment") == 0 && appl_rooted == TRUE)
-    {  char rooted[SSIZE]          = "",
-            lyosome_command[SSIZE] = "";
+    while(collected < n_requests)
+    {
 
-       (void)fprintf(psrp_out,"\nPSRP server \"%s\" is rooted (system context cannot migrate to new host)\n\n",appl_name);
-       (void)fflush(psrp_out);
+       /*----------------------------------*/
+       /* Stream requests until window full */
+       /*----------------------------------*/
 
-       (void)snprintf(rooted,SSIZE,"%s/%d.rooted",appl_fifo_dir,appl_pid);
-       (void)pups_creat(rooted,0600);
+       while(sent < n_requests && sent - collected < eff_window)
+       {  if(psrp_sock_send(des,first_seq + sent,requests[sent],pups_strlen(requests[sent])) == (-1))
+             goto pipeline_failed;
 
-       /*-------------------------------------------------------------*/
-       /* Start lyosome process which destroys trail file after delay */
-       /* of 15 seconds - this should be long enough for clients to   */
-       /* attach to new instance                                      */
-       /*-------------------------------------------------------------*/
+          ++sent;
+       }
 
-       (void)snprintf(lyosome_command,SSIZE,"lyosome -lifetime 15 %s&",rooted);
-       (void)system(lyosome_command);   
 
-       return(PSRP_OK);
-    }
+       /*-------------------------------------------------------*/
+       /* Collect next reply, which may belong to any request   */
+       /* still outstanding. Stale replies (from abandoned      */
+       /* requests) are skipped                                 */
+       /*-------------------------------------------------------*/
 
+       if((size = psrp_sock_recvmsg(des,&r_seq,&r_flags,&buf,&buf_size)) <= 0)
+       {  if(size == 0)
+             pups_set_errno(EPIPE);
 
-    /*-------------------------------------*/
-    /* Is the current instance to be kept? */
-    /*-------------------------------------*/
+          goto pipeline_failed;
+       }
 
-    if(strcmp(r_argv[1],"segment") == 0)
-       terminate_current_instance = TRUE;
-    else if(strcmp(r_argv[1],"fork") == 0)
-       terminate_current_instance = FALSE;
-    else
-    {  (void)fprintf(psrp_out,"usage: new [fork | segment (current instance)] [<new instance name> | default] [<exec host>]\n");
-       (void)fflush(psrp_out);
+       if(r_seq - first_seq < sent && replies[r_seq - first_seq] == (char *)NULL)
+       {  replies[r_seq - first_seq]    = buf;
+          reply_size[r_seq - first_seq] = buf_size;
 
-       return(PSRP_OK);
+          buf      = (char *)NULL;
+          buf_size = 0;
+          ++collected;
+       }
     }
 
+    (void)free((void *)buf);
 
-    /*--------------------------------------*/
-    /* Get default name of the new instance */
-    /*--------------------------------------*/
+    pups_set_errno(OK);
+    return((int32_t)collected);
 
-    (void)strlcpy(n_i_name,appl_name,SSIZE);
-    (void)strlcpy(n_i_host,"notset",SSIZE);
+pipeline_failed:
 
+    (void)free((void *)buf);
+    return(-1);
+}
 
-    /*-----------------------------------------*/
-    /* New instance remote - if name is set to */
-    /* default it keeps the same name as the   */
-    /* current instance                        */
-    /*-----------------------------------------*/
 
-    if(r_argc == 4)
-    {  
 
-       /*--------------------------*/
-       /* Get name of new instance */
-       /* (if not defaulted)       */
-       /*--------------------------*/
 
-       if(strcmp(r_argv[2],"default") == 0)
-          (void)strlcpy(n_i_name,appl_name,SSIZE);
-       else
-          (void)strlcpy(n_i_name,r_argv[2],SSIZE);
+/*-----------------------------------------------------------------*/
+/* Send a batch of requests (as a single message) over PSRP socket  */
+/* transport. The server runs them in order and returns a single   */
+/* combined reply (the concatenation of the replies to each        */
+/* request, each ending with its own "EOT" and "EOP psrp")         */
+/*-----------------------------------------------------------------*/
 
+_PUBLIC ssize_t psrp_sock_batch(const des_t    des,         // Socket transport connection
+                                const uint32_t seq,         // Tag for batch
+                                const uint32_t n_requests,  // Number of requests in batch
+                                const char     *requests[], // Requests
+                                char           **reply,     // Combined reply
+                                size_t         *reply_size) // Size of reply buffer
 
-       /*--------------------------------------------------------*/
-       /* We cannot have a duplicate instance with the same name */
-       /* as our current server                                  */
-       /*--------------------------------------------------------*/
+{   uint32_t i,
+             r_seq,
+             r_flags;
 
-       if(terminate_current_instance  == FALSE    &&
-          strcmp(r_argv[2],appl_name)   == 0      &&
-          strcmp(r_argv[3],"localhost") == 0       )
-       {  (void)fprintf(psrp_out,"\ncannot have duplicate local instance with same name (%s)\n",appl_name);
-          (void)fflush(psrp_out);
- 
-          return(PSRP_OK);
-       }
-       else
-       {
+    ssize_t  size;
+    size_t   batch_size = 0,
+             len        = 0;
 
-          /*----------------------------------*/   
-          /* Get name of remote host (if any) */
-          /*----------------------------------*/   
+    char     *batch     = (char *)NULL;
 
-          (void)strlcpy(n_i_host,r_argv[3],SSIZE);
-       }
+    if(des < 0 || n_requests == 0 || requests == (const char **)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-       if(terminate_current_instance == TRUE)
-          (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\" as \"%s\" (on host %s)\n",
-                                                                               appl_name,n_i_name,n_i_host);
-       else
-          (void)fprintf(psrp_out,"\ncreating new instance of \"%s\" as \"%s\" (on host %s)\n",
-                                                                   appl_name,n_i_name,n_i_host);
 
-       (void)fprintf(psrp_out,"... waiting for %d seconds for remote instance to start\n\n",segmentation_delay);
-       (void)fflush(psrp_out);
+    /*-----------------------------------------*/
+    /* Batch is newline separated request list */
+    /*-----------------------------------------*/
+
+    for(i=0; i<n_requests; ++i)
+       batch_size += pups_strlen(requests[i]) + 1;
+
+    if((batch = (char *)malloc(batch_size + 1)) == (char *)NULL)
+    {  pups_set_errno(ENOMEM);
+       return(-1);
     }
 
+    for(i=0; i<n_requests; ++i)
+    {  size_t r_len = pups_strlen(requests[i]);
 
-    /*----------------------------------*/
-    /* New instance local with new name */
-    /*----------------------------------*/
+       (void)memcpy((void *)&batch[len],(void *)requests[i],r_len);
+       len += r_len;
 
-    else if(r_argc == 3)
-    {  
+       if(len == 0 || batch[len - 1] != '\n')
+          batch[len++] = '\n';
+    }
 
-       /*--------------------------------------------------------*/
-       /* We cannot have a duplicate instance with the same name */
-       /* as our current server                                  */
-       /*--------------------------------------------------------*/
+    batch[len] = '\0';
 
-       if(terminate_current_instance  == FALSE    &&
-          strcmp(r_argv[2],appl_name) ==0          )
-       {  (void)fprintf(psrp_out,"\ncannot have duplicate local instance with same name (%s)\n",appl_name);
-          (void)fflush(psrp_out);
+    if(psrp_sock_sendmsg(des,seq,PSRP_FRAME_BATCH,batch,len) == (-1))
+    {  (void)free((void *)batch);
+       return(-1);
+    }
 
-          return(PSRP_OK);
+    (void)free((void *)batch);
+
+    do {    if((size = psrp_sock_recvmsg(des,&r_seq,&r_flags,reply,reply_size)) <= 0)
+            {  if(size == 0)
+                  pups_set_errno(EPIPE);
+
+               return(-1);
+            }
+       } while(r_seq != seq);
+
+    return(size);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Typed (binary) argument encoding. Each argument is a type byte   */
+/* (its schema character) followed by its value: integers are       */
+/* zigzag varints, doubles are 8 bytes (host order -- the socket    */
+/* transport is local), blobs and strings are a varint length then  */
+/* the bytes (strings include their terminating NUL) and vectors    */
+/* are a varint count then that many doubles                        */
+/*------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_argbuf_reserve(psrp_argbuf_type *argbuf, const size_t size)
+
+{   if(argbuf->size + size > argbuf->allocated)
+    {  size_t new_allocated = (argbuf->allocated == 0) ? 256 : argbuf->allocated;
+       _BYTE  *new_buf      = (_BYTE *)NULL;
+
+       while(argbuf->size + size > new_allocated)
+          new_allocated <<= 1;
+
+       if((new_buf = (_BYTE *)realloc((void *)argbuf->buf,new_allocated)) == (_BYTE *)NULL)
+       {  pups_set_errno(ENOMEM);
+          return(-1);
        }
-       else
-          (void)strlcpy(n_i_name,r_argv[2],SSIZE);
 
-       if(terminate_current_instance == TRUE)
-          (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\" as \"%s\"\n\n",appl_name,n_i_name);
-       else
-          (void)fprintf(psrp_out,"\ncreating new instance of \"%s\" as \"%s\"\n",appl_name,n_i_name);
-       (void)fflush(psrp_out);
+       argbuf->buf       = new_buf;
+       argbuf->allocated = new_allocated;
     }
 
+    return(0);
+}
 
-    /*--------------------------------------*/
-    /* New local instance with default name */
-    /*--------------------------------------*/
 
-    else
-    {   if(terminate_current_instance == TRUE)
-           (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\"\n",appl_name);
-        else
-           (void)fprintf(psrp_out,"\ncreating new instance of \"%s\"\n",appl_name);
-        (void)fflush(psrp_out);
+_PRIVATE int32_t psrp_argbuf_put_varint(psrp_argbuf_type *argbuf, uint64_t value)
+
+{   if(psrp_argbuf_reserve(argbuf,10) == (-1))
+       return(-1);
+
+    while(value >= 0x80)
+    {  argbuf->buf[argbuf->size++] = (_BYTE)(value | 0x80);
+       value >>= 7;
     }
 
+    argbuf->buf[argbuf->size++] = (_BYTE)value;
+    return(0);
+}
 
-    /*--------------------*/
-    /* Start new instance */
-    /*--------------------*/
 
-    if(strcmp(n_i_host,"notset") == 0)
-       ret = psrp_new_instance(terminate_current_instance,n_i_name,(char *)NULL);
-    else
-       ret = psrp_new_instance(terminate_current_instance,n_i_name,n_i_host);
 
 
-    if(ret < 0)
-    {  (void)fprintf(psrp_out,"failed to created new instance\n\n");
-       (void)fflush(psrp_out);
-    }   
+/*---------------------------------------*/
+/* Append integer argument to arg buffer */
+/*---------------------------------------*/
 
-    /*------------------------------------------------------*/
-    /* Tell client this request is now processed and return */
-    /* its exit code                                        */
-    /*------------------------------------------------------*/
+_PUBLIC int32_t psrp_argbuf_put_int(psrp_argbuf_type *argbuf, const int64_t value)
 
-    (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
-    (void)fflush(psrp_out);
+{   if(argbuf == (psrp_argbuf_type *)NULL || psrp_argbuf_reserve(argbuf,1) == (-1))
+       return(-1);
 
+    argbuf->buf[argbuf->size++] = PSRP_ARG_INT;
+    return(psrp_argbuf_put_varint(argbuf,((uint64_t)value << 1) ^ (uint64_t)(value >> 63)));
+}
 
-    /*------------------------------------------------------*/
-    /* Tell client that we have finished processing SIGPSRP */
-    /*------------------------------------------------------*/
 
-    psrp_endop("psrp");
-    pups_sleep(1);
 
-    return(PSRP_OK);
-}
 
+/*--------------------------------------*/
+/* Append double argument to arg buffer */
+/*--------------------------------------*/
 
+_PUBLIC int32_t psrp_argbuf_put_double(psrp_argbuf_type *argbuf, const double value)
 
+{   if(argbuf == (psrp_argbuf_type *)NULL || psrp_argbuf_reserve(argbuf,1 + sizeof(double)) == (-1))
+       return(-1);
 
+    argbuf->buf[argbuf->size++] = PSRP_ARG_DOUBLE;
+    (void)memcpy((void *)&argbuf->buf[argbuf->size],(void *)&value,sizeof(double));
+    argbuf->size += sizeof(double);
 
-/*---------------------------------*/
-/* Get state of PSRP object by tag */
-/*---------------------------------*/
+    return(0);
+}
 
-_PUBLIC int32_t psrp_ostate(const char *object_tag)
 
-{   uint32_t i;
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+/*--------------------------------------------------*/
+/* Append byte blob (or string) argument to buffer  */
+/*--------------------------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-      pups_error("[psrp_ostate] attempt by non root thread to perform PUPS/P3 PSRP operation");
+_PRIVATE int32_t psrp_argbuf_put_data(psrp_argbuf_type *argbuf, const _BYTE type, const void *data, const size_t size)
 
-    if(object_tag == (const char *)NULL)
+{   if(argbuf == (psrp_argbuf_type *)NULL || (data == (const void *)NULL && size > 0) || psrp_argbuf_reserve(argbuf,1) == (-1))
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-       if(psrp_object_list[i].object_handle != (void *)NULL && psrp_isearch_tag_list(object_tag,i) >= 0)
-       {  pups_set_errno(OK);
-          return(psrp_object_list[i].object_state);
-       }
+    argbuf->buf[argbuf->size++] = type;
+    if(psrp_argbuf_put_varint(argbuf,(uint64_t)size) == (-1) || psrp_argbuf_reserve(argbuf,size) == (-1))
+       return(-1);
 
-    pups_set_errno(ESRCH);
-    return(PSRP_DISPATCH_ERROR);
+    (void)memcpy((void *)&argbuf->buf[argbuf->size],data,size);
+    argbuf->size += size;
+
+    return(0);
 }
 
 
+_PUBLIC int32_t psrp_argbuf_put_bytes(psrp_argbuf_type *argbuf, const _BYTE *bytes, const size_t size)
 
+{   return(psrp_argbuf_put_data(argbuf,PSRP_ARG_BYTES,(const void *)bytes,size));
+}
 
-/*-----------------------------------------------------------*/
-/* Builtin help function (displays server builtin functions) */
-/*-----------------------------------------------------------*/
- 
-_PRIVATE int32_t psrp_builtin_help(const uint32_t argc, const char *argv[])
- 
-{   if(strcmp("shelp",argv[0]) != 0) 
-       return(PSRP_DISPATCH_ERROR); 
 
+_PUBLIC int32_t psrp_argbuf_put_string(psrp_argbuf_type *argbuf, const char *str)
 
-    /*---------------------------------------------*/
-    /* Set up command tail decoder for this object */
-    /*---------------------------------------------*/
+{   if(str == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-    if(psrp_std_init(argc,argv) == FALSE)
-       return(PSRP_OK);
+    return(psrp_argbuf_put_data(argbuf,PSRP_ARG_STRING,(const void *)str,pups_strlen(str) + 1));
+}
 
 
-    /*------------------------------------------------------*/ 
-    /* Check that there is no junk left on the command line */
-    /*------------------------------------------------------*/ 
 
-    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
-       return(PSRP_OK);
 
+/*----------------------------------------------*/
+/* Append vector (of doubles) argument to buffer */
+/*----------------------------------------------*/
 
-    /*-------------------------------------------*/  
-    /* Display on line help for builtin commands */
-    /*-------------------------------------------*/  
+_PUBLIC int32_t psrp_argbuf_put_vector(psrp_argbuf_type *argbuf, const double *vector, const size_t n)
 
-    (void)fprintf(psrp_out,"\n\n    PSRP request handler version 2.17 (protocol %5.2F)\n",PSRP_PROTOCOL_VERSION);
-    (void)fprintf(psrp_out,"    (C) M.A. O'Neill, Tumbling Dice, 1995-2024\n\n");
-    (void)fprintf(psrp_out,"    Builtin commands\n");
-    (void)fprintf(psrp_out,"    ================\n\n");
-    (void)fflush(psrp_out);
+{   if(argbuf == (psrp_argbuf_type *)NULL || (vector == (const double *)NULL && n > 0) || psrp_argbuf_reserve(argbuf,1) == (-1))
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-    (void)fprintf(psrp_out,"    General P3 server control/status commands\n");
-    (void)fprintf(psrp_out,"    =========================================\n\n");
-    (void)fprintf(psrp_out,"    log            [on | off]        :   switch server transaction logging on or off\n");
-    (void)fprintf(psrp_out,"    verbose        [on | off]        :   switch server error logging on or off\n");
-    (void)fprintf(psrp_out,"    errorhandling  [on | off]        :   toggle error handling on or off\n\n");
-    (void)fprintf(psrp_out,"    hinfo                            :   display host information\n");
-    (void)fprintf(psrp_out,"    show                             :   display PSRP handler status\n");
-    (void)fprintf(psrp_out,"    clients                          :   display clients connected to this server\n");
-    (void)fprintf(psrp_out,"    bindtype                         :   display current object binding (static or dynamic)\n");
-    (void)fprintf(psrp_out,"    help                             :   display on line help information\n");
-    (void)fprintf(psrp_out,"    strys                            :   set number of time PSRP server retrys operation (before aborting)\n");
-    (void)fprintf(psrp_out,"    nodetach       [on | off]        :   toggle stdio (when in background) on or off\n");    
-    (void)fprintf(psrp_out,"    cwd            <path>            :   set PSRP servers current working directory\n");
-    (void)fprintf(psrp_out,"    rusage                           :   show current resource usage status\n"); 
-    (void)fprintf(psrp_out,"    rset                             :   set resource usage limits\n"); 
-    (void)fprintf(psrp_out,"    pstat                            :   display /proc filesystem status entry\n");
-    (void)fprintf(psrp_out,"    terminate | kill                 :   terminate (this) PSRP server process\n\n\n");
+    argbuf->buf[argbuf->size++] = PSRP_ARG_VECTOR;
+    if(psrp_argbuf_put_varint(argbuf,(uint64_t)n) == (-1) || psrp_argbuf_reserve(argbuf,n*sizeof(double)) == (-1))
+       return(-1);
 
-    (void)fprintf(psrp_out,"    P3 server virtual timer control/status functions\n");
-    (void)fprintf(psrp_out,"    ================================================\n\n");
-    (void)fprintf(psrp_out,"    quantum        [<time> | default]:   set PSRP (vitimer) quantum\n");
-    (void)fprintf(psrp_out,"    vitstat                          :   display status of PUPS virtual interval timers\n\n");
-    (void)fprintf(psrp_out,"    vitab          [<n> | shrink]    :   display [or set to <n> or Procrustes shrink] number of virtal timer table slots\n\n\n");
+    (void)memcpy((void *)&argbuf->buf[argbuf->size],(void *)vector,n*sizeof(double));
+    argbuf->size += n*sizeof(double);
 
-    (void)fprintf(psrp_out,"    P3 server child control/status functions\n");
-    (void)fprintf(psrp_out,"    =========================================\n\n");
-    (void)fprintf(psrp_out,"    cstat                            :   display active children`\n");
-    (void)fprintf(psrp_out,"    htab          [<n> | shrink]     :   display [or set to <n> or Procrustes shrink] number of child table slots\n\n\n");
+    return(0);
+}
 
-    (void)fprintf(psrp_out,"    P3 server command alias control/status functions\n");
-    (void)fprintf(psrp_out,"    ================================================\n\n");
-    (void)fprintf(psrp_out,"    showaliases    <n>               :   show aliases of PSRP object <n>                  \n");
-    (void)fprintf(psrp_out,"    alias          <n> <a>           :   alias <n> to <a>\n");
-    (void)fprintf(psrp_out,"    unalias        <a>               :   remove alias <a>\n\n\n");
 
-    (void)fprintf(psrp_out,"    P3 server entry/exit routine control/status functions\n");
-    (void)fprintf(psrp_out,"    =====================================================\n\n");
-    (void)fprintf(psrp_out,"    atentrance                       :   display list of (PUPS) application entrance functions\n");
-    (void)fprintf(psrp_out,"    atexit                           :   display list of (PUPS) application exit functions\n");
-    (void)fprintf(psrp_out,"    atabort                          :   display list of (PUPS) application abort functions\n\n\n");
-    (void)fflush(psrp_out);
 
-    #ifdef SSH_SUPPORT
-    (void)fprintf(psrp_out,"    P3 server ssh control functions\n");
-    (void)fprintf(psrp_out,"    ===============================\n\n");
-    (void)fprintf(psrp_out,"    compress                         :   toggle ssh compression mode\n");
-    (void)fprintf(psrp_out,"    port           <port number>     :   set remote ssh port\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* SSH_SUPPORT */
 
+/*------------------------------------*/
+/* Release (and reset) arg buffer     */
+/*------------------------------------*/
 
-    #ifdef MAIL_SUPPORT
-    (void)fprintf(psrp_out,"    P3 server mail control/status functions\n");
-    (void)fprintf(psrp_out,"    =======================================\n\n");
-    (void)fprintf(psrp_out,"    mtype          <mime part type>  :   set part type (for parts of MIME messages to be saved)\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* MAIL_SUPPORT */
+_PUBLIC void psrp_argbuf_free(psrp_argbuf_type *argbuf)
 
+{   if(argbuf == (psrp_argbuf_type *)NULL)
+       return;
 
-    #ifdef PSRP_AUTHENTICATE
-    (void)fprintf(psrp_out,"    P3 server security control/status functions\n");
-    (void)fprintf(psrp_out,"    ===========================================\n\n");
-    (void)fprintf(psrp_out,"    secure         <token>           :   set (secure) server authentication token\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* PSRP_AUTHENTICATE */
+    (void)free((void *)argbuf->buf);
 
+    argbuf->buf       = (_BYTE *)NULL;
+    argbuf->size      = 0;
+    argbuf->allocated = 0;
+}
 
-    #ifdef CRIU_SUPPORT
-    (void)fprintf(psrp_out,"    P3 server (Criu) state save control/status functions\n");
-    (void)fprintf(psrp_out,"    ====================================================\n\n");
-    (void)fprintf(psrp_out,"    ssave                       |    :   Report state saving status\n");
-    (void)fprintf(psrp_out,"             [sspoll <seconds>]      :   Save state every <poll time> seconds (default 60 seconds)\n");
-    (void)fprintf(psrp_out,"                [enable       ] |    :   Enable state saving\n");
-    (void)fprintf(psrp_out,"                [disable      ] |    :   Disable state saving\n");
-    (void)fprintf(psrp_out,"                [cd <criu dir>]      :   Set Criu directory (default /tmp)\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* CRIU_SUPPORT */
 
 
-    (void)fprintf(psrp_out,"    P3 sofware watchdog functions\n");
-    (void)fprintf(psrp_out,"    =============================\n\n");
-    (void)fprintf(psrp_out,"    softdog                          :   Report software watchdog status\n");
-    (void)fprintf(psrp_out,"                [timeout  <secs>]    :   Save state every <poll time> seconds (default 60 seconds)\n");
-    (void)fprintf(psrp_out,"                [enable       ] |    :   Enable software watchdog\n");
-    (void)fprintf(psrp_out,"                [disable      ]      :   Disable software watchdog\n\n\n");
 
+/*---------------------------------------------------------*/
+/* Get varint from encoded arguments (checking for overrun) */
+/*---------------------------------------------------------*/
 
-    #ifdef BUBBLE_MEMORY_SUPPORT
-    (void)fprintf(psrp_out,"    P3 server bubble memory control/status functions\n");
-    (void)fprintf(psrp_out,"    ================================================\n\n");
-    (void)fprintf(psrp_out,"    mstat                            :   show memory allocation statistics\n");
-    (void)fprintf(psrp_out,"    mset           <threshold>       :   set memory bubble utilisation threshold %% (-usage for more detailed help)\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* BUBBLE_MEMORY_SUPPPORT */
+_PRIVATE int32_t psrp_args_get_varint(const _BYTE *buf, const size_t size, size_t *pos, uint64_t *value)
 
-    (void)fprintf(psrp_out,"    P3 server (attached) file control/status functions\n");
-    (void)fprintf(psrp_out,"    ==================================================\n\n");
-    (void)fprintf(psrp_out,"    lflstat                          :   show concurrently held link file locks\n");
-    (void)fprintf(psrp_out,"    flstat                           :   show currently held flockfile locks\n");
-    (void)fprintf(psrp_out,"    fstat                            :   display open file descriptors\n");
-    (void)fprintf(psrp_out,"    ftab           [<n> | shrink]    :   display [or set to <n> or Procrustes shrink] number of file table slots\n\n\n");
-    (void)fflush(psrp_out);
+{   uint32_t shift = 0;
 
-    (void)fprintf(psrp_out,"    P3 server (attached) signal control/status functions\n");
-    (void)fprintf(psrp_out,"    ====================================================\n\n");
-    (void)fprintf(psrp_out,"    sigstat                          :   display non default signal handlers\n");
-    (void)fprintf(psrp_out,"    sigstat        <sig list>        :   display detailed data for selected signal handlers\n");
-    (void)fprintf(psrp_out,"    maskstat                         :   display signal mask and pending signals\n\n\n");
-    (void)fflush(psrp_out);
+    *value = 0;
+    while(*pos < size && shift < 64)
+    {  _BYTE byte = buf[(*pos)++];
 
-    (void)fprintf(psrp_out,"    P3 server (attached) fast cache status\n");
-    (void)fprintf(psrp_out,"    ======================================\n\n");
-    (void)fprintf(psrp_out,"    cachestat                        :   display (fast) caches mapped  int32_to process address space\n\n\n");
-    (void)fflush(psrp_out);
+       *value |= (uint64_t)(byte & 0x7f) << shift;
+       if((byte & 0x80) == 0)
+          return(0);
 
-    (void)fprintf(psrp_out,"    P3 server process cron scheduler control/status functions\n");
-    (void)fprintf(psrp_out,"    =========================================================\n\n");
-    (void)fprintf(psrp_out,"    schedule       <f> <t> [<func>]  :   schedule function <func> between times <f> and <t> using cron homeostat\n");
-    (void)fprintf(psrp_out,"                                     :   if <func> is omitted sleep between times <f> and <t>\n");
-    (void)fprintf(psrp_out,"    unschedule    <index>            :   unschedule a previously scheduled crontab slot\n");
-    (void)fprintf(psrp_out,"    crontstat                        :   display crontab\n\n\n");
-    (void)fflush(psrp_out);
-   
-    (void)fprintf(psrp_out,"    P3 server process general hoeostatis control/status functions\n");
-    (void)fprintf(psrp_out,"    =============================================================\n\n");
-    (void)fprintf(psrp_out,"    sicstat                          :   display open slaved interaction client channels\n");
-    (void)fprintf(psrp_out,"    rooted                           :   set process to rooted mode (system context cannot migrate)\n");
-    (void)fprintf(psrp_out,"    unrooted                         :   set process to unrooted mode (system context can migrate)\n");
-    (void)fprintf(psrp_out,"    parent         <name | PID>      :   set name/PID of effective parent process\n");
-    (void)fprintf(psrp_out,"    pexit                            :   process  exits if effective parent terminated\n");
-    (void)fprintf(psrp_out,"    unpexit                          :   process does not exit if effective parent terminated\n");
-    (void)fprintf(psrp_out,"    live           <f1> <f2> ...     :   protects list of (open) files against damage or deletion\n");
-    (void)fprintf(psrp_out,"    dead           <f1> <f2> ...     :   unprotects list of (open) files\n");
-    (void)fprintf(psrp_out,"    new            <f|>s> <n> <h>    :   create new instance <n> of server, n=instance, f=fork, s=segment, h=hostname\n");
-    (void)fprintf(psrp_out,"    overlay        <command>         :   Overlay server process with <command> (server resumes when command exits)\n");
-    (void)fprintf(psrp_out,"    overfork       <command>         :   Overfork server process with <command>\n");
-    (void)fprintf(psrp_out,"    autosave       [on | off]        :   switch automatic saving of dipatch table (at exit) on or off\n");
-    (void)fprintf(psrp_out,"    autosave                         :   display status of automatic dispatch table saving (at exit)\n");
-    (void)fprintf(psrp_out,"    save           <n>               :   save dispatch table (to PSRP ressource file <n>)\n");
-    (void)fprintf(psrp_out,"    load           <n>               :   load PSRP resource file <n> (appending objects to current dispatch table)\n");
-    (void)fprintf(psrp_out,"    reset                            :   reset dispatch table (returning it to its default state)\n");
+       shift += 7;
+    }
 
-    if (psrp_bind_status & PSRP_DYNAMIC_DATABAG)
-       (void)fprintf(psrp_out,"    bag       <n> <f>   [LIVE|DEAD]  :   bind dynamic databag in <f> to PSRP handler <n>\n");
-    (void)fprintf(psrp_out,"\n\n");
-    (void)fflush(psrp_out);
-    
+    return(-1);
+}
 
-    #ifdef DLL_SUPPORT 
-    (void)fprintf(psrp_out,"    P3 server process DLL (dynamically linked object) control/status functions\n");
-    (void)fprintf(psrp_out,"    ==========================================================================\n\n");
 
-    if (psrp_bind_status & PSRP_DYNAMIC_FUNCTION)
-    {  (void)fprintf(psrp_out,"    dll         <name> <object DLL>  :   bind dynamic function in <object DLL> to PSRP handler with <name>\n");
-       (void)fprintf(psrp_out,"    ostat                            :   display orifices which are bound to application\n");
-       (void)fprintf(psrp_out,"    ortab       [<n>]                :   display [or set to <n>] number of orifice [DLL] table slots\n\n\n");
-    }
 
-    if (psrp_bind_status & PSRP_DYNAMIC_FUNCTION || psrp_bind_status & PSRP_DYNAMIC_DATABAG || psrp_bind_status & PSRP_PERSISTENT_HEAP)
-    {  (void)fprintf(psrp_out,"    detach      <item-list>          :   detach PSRP objects function in <item-list>\n");
-       (void)fprintf(psrp_out,"                                     :   if item list contains \"all\" reset dispatch table\n");
+
+/*-------------------------------------------------------------------*/
+/* Decode binary arguments (against schema). Blobs and strings point */
+/* into buf, vectors are copied (so they are aligned). Returns -1    */
+/* (EINVAL) if arguments do not match schema                         */
+/*-------------------------------------------------------------------*/
+
+_PUBLIC int32_t psrp_decode_typed_args(const char           *schema,  // Argument schema
+                                       const _BYTE          *buf,     // Encoded arguments
+                                       const size_t         size,     // Size of encoded arguments
+                                       psrp_typed_args_type *args)    // Decoded arguments
+
+{   uint32_t i;
+    size_t   pos = 0;
+    uint64_t value;
+
+    if(schema == (const char *)NULL || args == (psrp_typed_args_type *)NULL || (buf == (const _BYTE *)NULL && size > 0))
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
-    (void)fprintf(psrp_out,"    dllstat     <name>               :   show orifices exported by DLL <name>\n\n\n");
-    (void)fflush(psrp_out);
-    #endif /* DLL_SUPPORT */
+    (void)memset((void *)args,0,sizeof(psrp_typed_args_type));
 
+    for(i=0; schema[i] != '\0'; ++i)
+    {  psrp_arg_type *arg = &args->arg[i];
 
-    #ifdef PTHREAD_SUPPORT
-    (void)fprintf(psrp_out,"    P3 server process thread control/status functions\n");
-    (void)fprintf(psrp_out,"    =================================================\n\n");
-    (void)fprintf(psrp_out,"    tstat          [<nid>]           :   show running threads, or optionally info for thread <nid>\n");
-    (void)fprintf(psrp_out,"    tstart         [<n> [ <a>]       :   run (static or dynamic payload function) [name <a>] on thread <n>\n");
-    (void)fprintf(psrp_out,"    tpause         [<n> | <all>]     :   pause thread <n> or all threads if <all> specifed\n");
-    (void)fprintf(psrp_out,"    tcont          [<n> | <all>]     :   restart thread <n> or all threads if <all> specifed\n");
-    (void)fprintf(psrp_out,"    tkill          [<n> | <all>]     :   kill thread <n> or all threads if <all> specifed\n\n\n");
-    #endif /* PTHREAD_SUPPORT */
- 
-    (void)fprintf(psrp_out,"    P3 server process heap control/status functions\n");
-    (void)fprintf(psrp_out,"    ===============================================\n\n");
-    (void)fflush(psrp_out);
+       if(i == PSRP_MAX_TYPED_ARGS || pos >= size || buf[pos] != (_BYTE)schema[i])
+          goto decode_error;
 
+       arg->type = schema[i];
+       ++pos;
 
-    #ifdef PERSISTENT_HEAP_SUPPORT
-    if(psrp_bind_status & PSRP_PERSISTENT_HEAP)
-    {  (void)fprintf(psrp_out,"    heap     <n> <f>  [LIVE|DEAD      :   map persistent heap in <f> to PSRP handler <n>\n");
-       (void)fprintf(psrp_out,"    hstat    [<h | id> [<o | id>]     :   display pesistent heap details\n");
-       (void)fprintf(psrp_out,"    htab     [<n> | shrink]           :   display [or set to <n>] or Procrustes shrink number of persistent heap table slots\n");
-    }
-    #endif /* PERSISTENT_HEAP_SUPPORT */
+       switch(schema[i])
+       {   case PSRP_ARG_INT:    if(psrp_args_get_varint(buf,size,&pos,&value) == (-1))
+                                    goto decode_error;
 
-    (void)fprintf(psrp_out,"    hostat      <o1> <o2> ... <on>i  :   Show statistics for tracked heap object <tracked object>\n");
-    (void)fprintf(psrp_out,"    hostat                           :   Show statistics for all tracked heap objects\n\n\n");
-    (void)fflush(psrp_out);
+                                 arg->i = (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+                                 break;
 
-    return(PSRP_OK);
-}
+           case PSRP_ARG_DOUBLE: if(size - pos < sizeof(double))
+                                    goto decode_error;
 
+                                 (void)memcpy((void *)&arg->d,(void *)&buf[pos],sizeof(double));
+                                 pos += sizeof(double);
+                                 break;
 
+           case PSRP_ARG_BYTES:
+           case PSRP_ARG_STRING: if(psrp_args_get_varint(buf,size,&pos,&value) == (-1) || value > size - pos)
+                                    goto decode_error;
 
-#ifdef DLL_SUPPORT
-/*---------------------------------------------------*/
-/* Show orifices which are bound to this application */
-/*---------------------------------------------------*/
+                                 if(schema[i] == PSRP_ARG_STRING && (value == 0 || buf[pos + value - 1] != '\0'))
+                                    goto decode_error;
 
-_PRIVATE int32_t psrp_builtin_show_attached_orifices(const uint32_t argc, const char *argv[])
+                                 arg->bytes = &buf[pos];
+                                 arg->size  = (size_t)value;
+                                 pos       += (size_t)value;
+                                 break;
 
-{   if(strcmp("ostat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+           case PSRP_ARG_VECTOR: if(psrp_args_get_varint(buf,size,&pos,&value) == (-1) || value > (size - pos)/sizeof(double))
+                                    goto decode_error;
 
-    if(argc != 1)
-    {  (void)fprintf(psrp_out,"Usage: ostat\n");
-       (void)fflush(psrp_out);
+                                 if((arg->vector = (double *)malloc(value*sizeof(double) + 1)) == (double *)NULL)
+                                    goto decode_error;
 
-       return(PSRP_OK);
+                                 (void)memcpy((void *)arg->vector,(void *)&buf[pos],value*sizeof(double));
+                                 arg->size  = (size_t)value;
+                                 pos       += (size_t)value*sizeof(double);
+                                 break;
+
+           default:              goto decode_error;
+       }
+
+       ++args->argc;
     }
 
-    (void)pups_show_orifices(psrp_out);
-    return(PSRP_OK);
+    if(pos != size)
+       goto decode_error;
+
+    pups_set_errno(OK);
+    return(0);
+
+decode_error:
+
+    psrp_free_typed_args(args);
+
+    pups_set_errno(EINVAL);
+    return(-1);
 }
-#endif /* DLL_SUPPORT */
 
 
 
 
-#ifdef PTHREAD_SUPPORT 
-/*-------------------------------------------------------*/
-/* Show threads of execution running in this application */
-/*-------------------------------------------------------*/
+/*------------------------------------------------------------------*/
+/* Decode text arguments (argv[1] onwards) against schema, so typed */
+/* functions can also be used from interactive psrp sessions.       */
+/* Vectors are comma separated lists                                */
+/*------------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_threads(const uint32_t argc, const char *argv[])
+_PUBLIC int32_t psrp_text_typed_args(const char           *schema,  // Argument schema
+                                     const int32_t        argc,     // Number of text arguments (including tag)
+                                     const char           *argv[],  // Text arguments
+                                     psrp_typed_args_type *args)    // Decoded arguments
 
-{   if(strcmp("tstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+{   uint32_t i;
+    char     *end_ptr = (char *)NULL;
 
-    if(argc > 2 || (argc == 1 && strcmp(argv[0],"-usage") == 0))
-    {  (void)fprintf(psrp_out,"Usage: tstat [<nid>]\n");
-       (void)fflush(psrp_out);
+    if(schema == (const char *)NULL || argv == (const char **)NULL || args == (psrp_typed_args_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-       return(PSRP_OK);
+    (void)memset((void *)args,0,sizeof(psrp_typed_args_type));
+
+    if(pups_strlen(schema) != (size_t)(argc - 1) || pups_strlen(schema) > PSRP_MAX_TYPED_ARGS)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
-    else if(argc == 2)
-    {  int32_t nid;
 
+    for(i=0; schema[i] != '\0'; ++i)
+    {  psrp_arg_type *arg = &args->arg[i];
+       const char    *str = argv[i + 1];
 
-       /*--------------------------------*/
-       /* Check that we have a valid nid */
-       /*--------------------------------*/
+       arg->type = schema[i];
+       switch(schema[i])
+       {   case PSRP_ARG_INT:    arg->i = (int64_t)strtoll(str,&end_ptr,0);
+                                 if(end_ptr == str || *end_ptr != '\0')
+                                    goto decode_error;
+                                 break;
 
-       if(sscanf(argv[1],"%d",&nid) != 1 || nid < 0)
-       {  (void)fprintf(psrp_out,"expecting  integer value (>= 0) for (thread) nid\n");
-          (void)fflush(psrp_out);
+           case PSRP_ARG_DOUBLE: arg->d = strtod(str,&end_ptr);
+                                 if(end_ptr == str || *end_ptr != '\0')
+                                    goto decode_error;
+                                 break;
 
-          return(PSRP_OK);
-       }
+           case PSRP_ARG_BYTES:  arg->bytes = (const _BYTE *)str;
+                                 arg->size  = pups_strlen(str);
+                                 break;
 
+           case PSRP_ARG_STRING: arg->bytes = (const _BYTE *)str;
+                                 arg->size  = pups_strlen(str) + 1;
+                                 break;
 
-       /*--------------------------------------*/
-       /* Show ttab entry for specified thread */
-       /*--------------------------------------*/
+           case PSRP_ARG_VECTOR: {  size_t n = 1;
+                                    const char *next = str;
 
-       if(pupsthread_show_threadinfo(psrp_out,nid) < 0)
-       {  (void)fprintf(psrp_out,"specfied thread (nid %d) does not exist\n",nid);
-          (void)fflush(psrp_out);
-       
-          return(PSRP_OK);
+                                    while((next = strchr(next,',')) != (const char *)NULL)
+                                    {  ++n;
+                                       ++next;
+                                    }
+
+                                    if((arg->vector = (double *)malloc(n*sizeof(double))) == (double *)NULL)
+                                       goto decode_error;
+
+                                    for(next=str, arg->size=0; arg->size<n; ++arg->size)
+                                    {  arg->vector[arg->size] = strtod(next,&end_ptr);
+                                       if(end_ptr == next || (*end_ptr != ',' && *end_ptr != '\0'))
+                                       {  ++args->argc;
+                                          goto decode_error;
+                                       }
+
+                                       next = end_ptr + 1;
+                                    }
+                                 }
+                                 break;
+
+           default:              goto decode_error;
        }
+
+       ++args->argc;
     }
-    else
-       (void)pupsthread_show_ttab(psrp_out);
 
-    return(PSRP_OK);
+    pups_set_errno(OK);
+    return(0);
+
+decode_error:
+
+    psrp_free_typed_args(args);
+
+    pups_set_errno(EINVAL);
+    return(-1);
 }
 
 
 
 
-/*---------------------------------------------------------------*/
-/* Start a new thread of execution (using dispatch table object) */
-/*---------------------------------------------------------------*/
+/*------------------------------------------------*/
+/* Release storage owned by decoded arguments     */
+/*------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_launch_thread(const uint32_t argc, const char *argv[])
+_PUBLIC void psrp_free_typed_args(psrp_typed_args_type *args)
 
 {   uint32_t i;
-    int32_t  d_index;
 
-    char tname[SSIZE] = "";
+    if(args == (psrp_typed_args_type *)NULL)
+       return;
 
-    void *tfunc = (void *)NULL,
-         *targs = (void *)NULL;
+    for(i=0; i<args->argc; ++i)
+    {  if(args->arg[i].type == PSRP_ARG_VECTOR)
+          (void)free((void *)args->arg[i].vector);
 
-    pthread_t tid;
+       args->arg[i].vector = (double *)NULL;
+    }
 
-    if(strcmp("tstart",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    args->argc = 0;
+}
 
-    if(argc == 1 || argc == 2 && (strcmp(argv[1],"-usage") == 0))
-    {  (void)fprintf(psrp_out,"Usage: tstart [-usage] | [<thread name> <payload name> [<argument string>]]\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
 
 
-    /*-------------------------------------------------------------------*/
-    /* Check that payload is in dispatch table and that it is executable */
-    /*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/* Send request (with typed binary arguments) for typed function    */
+/* over PSRP socket transport and get reply                          */
+/*-------------------------------------------------------------------*/
 
-    if((d_index = lookup_psrp_object_by_name(argv[2])) == (-1))
-    {  (void)fprintf(psrp_out,"Payload function \"%s\" is not in disptach table\n",argv[2]);
-       (void)fflush(psrp_out);
+_PUBLIC ssize_t psrp_sock_typed_request(const des_t            des,         // Socket transport connection
+                                        const uint32_t         seq,         // Request tag
+                                        const char             *tag,        // Typed function tag
+                                        const psrp_argbuf_type *argbuf,     // Encoded arguments
+                                        char                   **reply,     // Reply
+                                        size_t                 *reply_size) // Size of reply buffer
 
-       return(PSRP_OK);
+{   uint32_t r_seq,
+             r_flags;
+
+    ssize_t  size;
+    size_t   tag_size,
+             msg_size;
+
+    char     *msg = (char *)NULL;
+
+    if(des < 0 || tag == (const char *)NULL || argbuf == (const psrp_argbuf_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
 
-    /*--------------------------------------------------------*/
-    /* Check object type - if its not PSRP_STATIC_FUNCTION or */
-    /* PSRP_DYNAMIC_FUNCTION we can't execute it!             */
-    /*--------------------------------------------------------*/
+    /*------------------------------------------*/
+    /* Message is tag (NUL terminated) then the */
+    /* encoded arguments                        */
+    /*------------------------------------------*/
 
-    if(psrp_object_list[d_index].object_type != PSRP_STATIC_FUNCTION    &&
-       psrp_object_list[d_index].object_type != PSRP_DYNAMIC_FUNCTION    )  
-    {  (void)fprintf(psrp_out,"Payload function \"%s\" is not a static or dynamic executable\n");
-       (void)fflush(psrp_out);
+    tag_size = pups_strlen(tag) + 1;
+    msg_size = tag_size + argbuf->size;
 
-       return(PSRP_OK);
+    if((msg = (char *)malloc(msg_size)) == (char *)NULL)
+    {  pups_set_errno(ENOMEM);
+       return(-1);
     }
 
+    (void)memcpy((void *)msg,(void *)tag,tag_size);
+    if(argbuf->size > 0)
+       (void)memcpy((void *)&msg[tag_size],(void *)argbuf->buf,argbuf->size);
 
-    /*-----------------------------------------*/
-    /* Build argument list for thread launcher */
-    /* and get name of thread                  */
-    /*-----------------------------------------*/
-
-    tfunc = (void *)psrp_object_list[d_index].object_handle;
-    (void)strlcpy(tname,argv[1],SSIZE);
+    if(psrp_sock_sendmsg(des,seq,PSRP_FRAME_BINARY,msg,msg_size) == (-1))
+    {  (void)free((void *)msg);
+       return(-1);
+    }
 
+    (void)free((void *)msg);
 
-    /*------------------------------------------*/
-    /* We have some arguments - typically these */
-    /* will be passed as a string which will be */
-    /* parsed by the thread payload function    */
-    /*------------------------------------------*/
+    do {    if((size = psrp_sock_recvmsg(des,&r_seq,&r_flags,reply,reply_size)) <= 0)
+            {  if(size == 0)
+                  pups_set_errno(EPIPE);
 
-    if(argc == 4)
-       targs = argv[3];
-                                                             /*----------------------------------------------*/
-    if((tid = pupsthread_create(tname,                       /* Name of payload function to be run by thread */
-                                tfunc,                       /* Payload function to be run by thread         */
-                                targs)) != (pthread_t)NULL)  /* Payload arguments                            */
-                                                             /*----------------------------------------------*/
-    {   int32_t tpid,
-                t_index;
+               return(-1);
+            }
+       } while(r_seq != seq);
 
-       t_index = pupsthread_tid2nid(tid);
-       tpid    = pupsthread_nid2tpid(t_index);
-       (void)fprintf(psrp_out,"Thread %d (LWP: %d, payload function: \"%-32s\") launched (at %016lx virtual)\n",
-                                                                               t_index,tpid,tname,(uint64_t)tid);
-       (void)fflush(psrp_out);
-    }
-    else
-    {  (void)fprintf(psrp_out,"Failed to start thread\n");
-       (void)fflush(psrp_out);
-    }
-   
-    return(PSRP_OK);
+    return(size);
 }
 
 
 
 
-/*--------------------------------------------*/
-/* Pause thread executing in this application */
-/*--------------------------------------------*/
+/*-------------------------------------*/
+/* Close PSRP socket transport session */
+/*-------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_pause_thread(const uint32_t argc, const char *argv[])
+_PUBLIC int32_t psrp_sock_close(const des_t des)
 
-{   pthread_t tid;
+{   if(des < 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-    if(strcmp("tpause",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    (void)close(des);
 
-    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
-    {  (void)fprintf(psrp_out,"Usage: tpause [-usage] | [<thread name> | [all]]\n");
-       (void)fflush(psrp_out);
+    pups_set_errno(OK);
+    return(0);
+}
 
-       return(PSRP_OK);
-    }
 
 
-    /*------------------------*/
-    /* Pause specified thread */
-    /*------------------------*/
 
-    if(strcmp(argv[1],"all") != 0)
-    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
-       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
-          (void)fflush(psrp_out);
+/*--------------------------------------------------------------------*/
+/* Shared memory ring transport. A ring is a memfd holding a header   */
+/* followed by a power of two sized data area. There is exactly one   */
+/* writer and one reader (SPSC), so head (advanced by the writer) and */
+/* tail (advanced by the reader) need no lock. A side which finds the */
+/* ring full (or empty) sleeps on a futex in the shared header, so    */
+/* the writer is throttled by the reader (backpressure)               */
+/*--------------------------------------------------------------------*/
 
-          return(PSRP_OK);
-       }
+_PRIVATE int32_t psrp_ring_futex(uint32_t *uaddr, const int32_t op, const uint32_t val, const int32_t timeout)
 
-       if(pupsthread_pause(tid) == (-1))
-       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to stop\n",(uint64_t)tid,argv[1]);
-          (void)fflush(psrp_out);
+{   struct timespec ts;
 
-          return(PSRP_OK);
-       }
+    ts.tv_sec  = timeout / 1000;
+    ts.tv_nsec = (timeout % 1000) * 1000000;
 
-       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") paused\n",(uint64_t)tid,argv[1]);
-       (void)fflush(psrp_out);
+    return((int32_t)syscall(SYS_futex,uaddr,op,val,(op == FUTEX_WAIT) ? &ts : (struct timespec *)NULL,(uint32_t *)NULL,0));
+}
 
-       return(PSRP_OK);
-    }
 
 
-    /*-------------------*/
-    /* Pause all threads */
-    /*-------------------*/
 
-    else
-    {   int32_t i,
-                t_cnt = 0;
+/*-------------------------------------------------------------------*/
+/* Wake peer sleeping on futex (only if it has said it is sleeping) */
+/*-------------------------------------------------------------------*/
 
-       char     tmpname[SSIZE] = "";
+_PRIVATE void psrp_ring_wake(uint32_t *waiting, uint32_t *uaddr)
 
-       (void)pthread_mutex_lock(&ttab_mutex);
+{   if(__atomic_load_n(waiting,__ATOMIC_SEQ_CST) != 0)
+    {  (void)__atomic_fetch_add(uaddr,1,__ATOMIC_SEQ_CST);
+       (void)psrp_ring_futex(uaddr,FUTEX_WAKE,INT32_MAX,0);
+    }
+}
 
 
-       /*---------------------------------------------------*/
-       /* Pause all active threads (other than root thread) */
-       /*---------------------------------------------------*/
 
-       for(i=0; i<MAX_THREADS; ++i)
-       {  if(ttab[i].tid != (pthread_t *)NULL)
-          {  tid = ttab[i].tid;
-             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
-             if(pupsthread_pause(tid) == (-1))
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to stop\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
-             }
-             else
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") stopped\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
 
-                ++t_cnt;
-             }
-          }
-       }
+/*------------------------------------------------------------------*/
+/* Sleep (on futex) until peer changes ring state. The wait is in   */
+/* slices of PSRP_RING_POLL milliseconds, between which we check    */
+/* that the peer is still alive. Returns 0 if woken, -1 (ETIMEDOUT) */
+/* if timeout (milliseconds, < 0 for none) expires and -1 (EPIPE)   */
+/* if peer has gone                                                 */
+/*------------------------------------------------------------------*/
 
-       (void)pthread_mutex_unlock(&ttab_mutex);
+_PRIVATE int32_t psrp_ring_wait(psrp_ring_type *ring, const _BOOLEAN writer, const int32_t timeout)
 
+{   int32_t         slice,
+                    waited = 0;
 
-       if(t_cnt == 0)
-          (void)fprintf(psrp_out,"\nno threads stopped\n");
-       else
-          (void)fprintf(psrp_out,"\n%d threads stopped\n",t_cnt);
-       (void)fflush(psrp_out);
-    }
+    uint32_t        seq,
+                    *waiting,
+                    *uaddr;
 
-    return(PSRP_OK);
-}
+    pid_t           peer;
+    struct timespec start,
+                    now;
 
+    if(writer == TRUE)
+    {  waiting = &ring->header->writer_waiting;
+       uaddr   = &ring->header->space_futex;
+    }
+    else
+    {  waiting = &ring->header->reader_waiting;
+       uaddr   = &ring->header->data_futex;
+    }
 
+    if(__atomic_load_n(&ring->header->abandoned,__ATOMIC_SEQ_CST) != 0)
+    {  pups_set_errno(EPIPE);
+       return(-1);
+    }
 
+    seq = __atomic_load_n(uaddr,__ATOMIC_SEQ_CST);
+    __atomic_store_n(waiting,1,__ATOMIC_SEQ_CST);
 
-/*----------------------------------------------*/
-/* Restart thread executing in this application */
-/*----------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_restart_thread(const uint32_t argc, const char *argv[])
+    /*------------------------------------------------------*/
+    /* State may have changed before we said we were asleep */
+    /*------------------------------------------------------*/
 
-{   pthread_t tid;
+    if((writer == TRUE  && __atomic_load_n(&ring->header->head,__ATOMIC_SEQ_CST) - __atomic_load_n(&ring->header->tail,__ATOMIC_SEQ_CST) < ring->size) ||
+       (writer == FALSE && (__atomic_load_n(&ring->header->head,__ATOMIC_SEQ_CST) != ring->header->tail || __atomic_load_n(&ring->header->closed,__ATOMIC_SEQ_CST) != 0)))
+    {  __atomic_store_n(waiting,0,__ATOMIC_SEQ_CST);
+       return(0);
+    }
 
-    if(strcmp("tcont",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    (void)clock_gettime(CLOCK_MONOTONIC,&start);
+    while(__atomic_load_n(uaddr,__ATOMIC_SEQ_CST) == seq)
+    {  if(timeout >= 0 && timeout - waited < PSRP_RING_POLL)
+          slice = timeout - waited;
+       else
+          slice = PSRP_RING_POLL;
 
-    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
-    {  (void)fprintf(psrp_out,"Usage: tcont [-usage] | [<thread name> | [all]]\n");
-       (void)fflush(psrp_out);
+       if(psrp_ring_futex(uaddr,FUTEX_WAIT,seq,slice) == 0 || errno == EAGAIN)
+          break;
 
-       return(PSRP_OK);
-    }
 
+       /*--------------------------------------------------*/
+       /* Time actually waited (a signal may have cut the  */
+       /* slice short)                                     */
+       /*--------------------------------------------------*/
 
-    /*--------------------------*/
-    /* Restart specified thread */
-    /*--------------------------*/
+       (void)clock_gettime(CLOCK_MONOTONIC,&now);
+       waited = (int32_t)((now.tv_sec - start.tv_sec)*1000 + (now.tv_nsec - start.tv_nsec)/1000000);
 
-    if(strcmp(argv[1],"all") != 0)
-    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
-       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
-          (void)fflush(psrp_out);
 
-          return(PSRP_OK);
-       }
+       /*---------------------------------------*/
+       /* Peer has gone (or abandoned the ring) */
+       /*---------------------------------------*/
 
-       if(pupsthread_cont(tid) == (-1))
-       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to restart\n",(uint64_t)tid,argv[1]);
-          (void)fflush(psrp_out);
+       peer = (writer == TRUE) ? ring->header->reader_pid : ring->header->writer_pid;
+       if(__atomic_load_n(&ring->header->abandoned,__ATOMIC_SEQ_CST) != 0 || (peer > 0 && kill(peer,0) == (-1) && errno == ESRCH))
+       {  __atomic_store_n(waiting,0,__ATOMIC_SEQ_CST);
 
-          return(PSRP_OK);
+          pups_set_errno(EPIPE);
+          return(-1);
        }
 
-       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") restarted\n",(uint64_t)tid,argv[1]);
-       (void)fflush(psrp_out);
+       if(timeout >= 0 && waited >= timeout)
+       {  __atomic_store_n(waiting,0,__ATOMIC_SEQ_CST);
 
-       return(PSRP_OK);
+          pups_set_errno(ETIMEDOUT);
+          return(-1);
+       }
     }
 
+    __atomic_store_n(waiting,0,__ATOMIC_SEQ_CST);
+    return(0);
+}
 
-    /*---------------------*/
-    /* Restart all threads */
-    /*---------------------*/
 
-    else
-    {  uint32_t i,
-                t_cnt          = 0;
 
-       char     tmpname[SSIZE] = "";
 
-       (void)pthread_mutex_lock(&ttab_mutex);
+/*-----------------------------------------------------------------*/
+/* Create shared memory ring (writer side). Size is rounded up to  */
+/* a power of two. Total is the number of bytes which will be sent */
+/* (or 0 if not known). Returns NULL (ENOSYS) if memfd is not      */
+/* supported, in which case the caller should fall back to FIFOs   */
+/*-----------------------------------------------------------------*/
 
+_PUBLIC psrp_ring_type *psrp_ring_create(const size_t size, const uint64_t total)
 
-       /*-----------------------------------------------------*/
-       /* Restart all active threads (other than root thread) */
-       /*-----------------------------------------------------*/
+{   size_t         eff_size = PSRP_RING_MIN_SIZE;
+    des_t          des;
+    psrp_ring_type *ring    = (psrp_ring_type *)NULL;
 
-       for(i=0; i<MAX_THREADS; ++i)
-       {  if(ttab[i].tid != (pthread_t *)NULL)
-          {  tid = ttab[i].tid;
-             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
-             if(pupsthread_cont(tid) == (-1))
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to restart\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
-             }
-             else
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") restarted\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
+    while(eff_size < size && eff_size < PSRP_RING_SIZE)
+       eff_size <<= 1;
 
-                ++t_cnt;
-             }
-          }
-       }
+    if((des = memfd_create("psrp_ring",MFD_CLOEXEC)) == (-1))
+    {  pups_set_errno(ENOSYS);
+       return((psrp_ring_type *)NULL);
+    }
 
-       (void)pthread_mutex_unlock(&ttab_mutex);
+    if(ftruncate(des,sizeof(psrp_ring_header_type) + eff_size) == (-1))
+    {  (void)close(des);
 
+       pups_set_errno(ENOMEM);
+       return((psrp_ring_type *)NULL);
+    }
 
-       if(t_cnt == 0)
-          (void)fprintf(psrp_out,"\nno threads restarted\n");
-       else
-          (void)fprintf(psrp_out,"\n%d threads restarted\n",t_cnt);
-       (void)fflush(psrp_out);
+    if((ring = psrp_ring_map(des)) == (psrp_ring_type *)NULL)
+    {  (void)close(des);
+       return((psrp_ring_type *)NULL);
     }
 
-    return(PSRP_OK);
-}
+    ring->size               = eff_size;
+    ring->header->magic      = PSRP_RING_MAGIC;
+    ring->header->size       = eff_size;
+    ring->header->total      = total;
+    ring->header->writer_pid = appl_pid;
 
+    pups_set_errno(OK);
+    return(ring);
+}
 
 
-/*-------------------------------------------*/
-/* Kill thread executing in this application */
-/*-------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_kill_thread(const uint32_t argc, const char *argv[])
 
-{   pthread_t tid;
+/*----------------------------------------------------------*/
+/* Map ring (memfd) into our address space                  */
+/*----------------------------------------------------------*/
 
-    if(strcmp("tkill",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PRIVATE psrp_ring_type *psrp_ring_map(const des_t des)
 
-    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
-    {  (void)fprintf(psrp_out,"Usage: tkill [-usage] | [<thread name> | [all]]\n");
-       (void)fflush(psrp_out);
+{   struct stat    buf;
+    psrp_ring_type *ring = (psrp_ring_type *)NULL;
 
-       return(PSRP_OK);
+    if(fstat(des,&buf) == (-1) || (size_t)buf.st_size <= sizeof(psrp_ring_header_type))
+    {  pups_set_errno(EINVAL);
+       return((psrp_ring_type *)NULL);
     }
 
+    ring           = (psrp_ring_type *)pups_malloc(sizeof(psrp_ring_type));
+    ring->des      = des;
+    ring->map_size = (size_t)buf.st_size;
+    ring->header   = (psrp_ring_header_type *)mmap((void *)NULL,ring->map_size,PROT_READ | PROT_WRITE,MAP_SHARED,des,0);
 
-    /*-----------------------*/
-    /* Kill specified thread */
-    /*-----------------------*/
+    if(ring->header == (psrp_ring_header_type *)MAP_FAILED)
+    {  (void)pups_free((void *)ring);
 
-    if(strcmp(argv[1],"all") != 0)
-    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
-       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
-          (void)fflush(psrp_out);
+       pups_set_errno(ENOMEM);
+       return((psrp_ring_type *)NULL);
+    }
 
-          return(PSRP_OK);
-       }
+    ring->data = (_BYTE *)ring->header + sizeof(psrp_ring_header_type);
 
-       if(pupsthread_cancel(tid) == (-1))
-       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to terminate\n",(uint64_t)tid,argv[1]);
-          (void)fflush(psrp_out);
+    pups_set_errno(OK);
+    return(ring);
+}
 
-          return(PSRP_OK);
-       }
-    
-       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") terminated\n",(uint64_t)tid,argv[1]);
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
 
 
-    /*------------------*/
-    /* Kill all threads */
-    /*------------------*/
+/*------------------------------------------------------------------*/
+/* Attach (reader side) to ring created by process pid. The ring is */
+/* opened via /proc/<pid>/fd/<des> so this works with either PSRP   */
+/* transport                                                        */
+/*------------------------------------------------------------------*/
 
-    else
-    {  uint32_t i,
-                t_cnt          = 0;
+_PUBLIC psrp_ring_type *psrp_ring_attach(const pid_t pid, const des_t des)
 
-       char     tmpname[SSIZE] = "";
+{   des_t          r_des;
+    char           fd_name[SSIZE] = "";
+    psrp_ring_type *ring          = (psrp_ring_type *)NULL;
 
-       (void)pthread_mutex_lock(&ttab_mutex);
+    (void)snprintf(fd_name,SSIZE,"/proc/%d/fd/%d",pid,des);
+    if((r_des = open(fd_name,O_RDWR | O_CLOEXEC)) == (-1))
+    {  pups_set_errno(ENOENT);
+       return((psrp_ring_type *)NULL);
+    }
 
+    if((ring = psrp_ring_map(r_des)) == (psrp_ring_type *)NULL)
+    {  (void)close(r_des);
+       return((psrp_ring_type *)NULL);
+    }
 
-       /*--------------------------------------------------*/
-       /* Kill all active threads (other than root thread) */
-       /*--------------------------------------------------*/
 
-       for(i=0; i<MAX_THREADS; ++i)
-       {  if(ttab[i].tid != (pthread_t *)NULL)
-          {  tid = ttab[i].tid;
-             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
-             if(pupsthread_cancel(tid) == (-1))
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to terminate\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
-             }
-             else
-             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") terminated\n",(uint64_t)tid,tmpname);
-                (void)fflush(psrp_out);
-
-                ++t_cnt;
-             }
-          }
-       }
-
-       (void)pthread_mutex_unlock(&ttab_mutex);
+    /*--------------------------------------------------------*/
+    /* The header is writable by the peer so take a private   */
+    /* copy of the (validated) size which is used from now on */
+    /*--------------------------------------------------------*/
 
+    ring->size = ring->header->size;
+    if(ring->header->magic != PSRP_RING_MAGIC                         ||
+       ring->header->writer_pid != pid                                ||
+       ring->size < PSRP_RING_MIN_SIZE || ring->size > PSRP_RING_SIZE ||
+       ring->size + sizeof(psrp_ring_header_type) > ring->map_size    ||
+       (ring->size & (ring->size - 1)) != 0                            )
+    {  (void)psrp_ring_destroy(ring);
 
-       if(t_cnt == 0)
-          (void)fprintf(psrp_out,"\nno threads terminated\n");
-       else
-          (void)fprintf(psrp_out,"\n%d threads terminated\n",t_cnt);
-       (void)fflush(psrp_out);
+       pups_set_errno(EINVAL);
+       return((psrp_ring_type *)NULL);
     }
 
-    return(PSRP_OK);
-}
-#endif /* PTHREAD_SUPPORT */
-
-
+    ring->header->reader_pid = appl_pid;
 
+    pups_set_errno(OK);
+    return(ring);
+}
 
-/*------------------------------------------------*/
-/* Show /proc filesystem entries for this process */
-/*------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_procstatus(const uint32_t argc, const char *argv[])
 
-{   char appl_procstatus[SSIZE] = "",
-         line[SSIZE]            = "";
 
-    FILE *proc_stream = (FILE *)NULL;
+/*-------------------------------------------------------------------*/
+/* Reserve space in ring (writer). Returns (contiguous) space which  */
+/* can be filled directly (e.g. by read(2)) before psrp_ring_commit */
+/*-------------------------------------------------------------------*/
 
-    if(strcmp("pstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PUBLIC ssize_t psrp_ring_reserve(psrp_ring_type *ring, _BYTE **space, const int32_t timeout)
 
-    if(argc != 1)
-    {  (void)fprintf(psrp_out,"\nusage: procstatus\n\n");
-       (void)fflush(psrp_out);
+{   uint64_t head,
+             tail,
+             offset;
 
-       return(PSRP_OK);
+    if(ring == (psrp_ring_type *)NULL || space == (_BYTE **)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
-    (void)snprintf(appl_procstatus,SSIZE,"/proc/%d/status",appl_pid);
+    head = ring->header->head;
+    while((tail = __atomic_load_n(&ring->header->tail,__ATOMIC_ACQUIRE)) + ring->size == head)
+    {  if(psrp_ring_wait(ring,TRUE,timeout) == (-1))
+          return(-1);
+    }
 
-    proc_stream = pups_fopen(appl_procstatus,"r",DEAD);
 
-    (void)fprintf(psrp_out,"\n");
-    (void)fflush(psrp_out);
+    /*-------------------------------------------*/
+    /* Reader has corrupted the shared positions */
+    /*-------------------------------------------*/
 
-    do {   (void)pups_fgets(line,SSIZE,proc_stream);
+    if(head - tail > ring->size)
+    {  psrp_ring_close(ring,TRUE);
 
-           if(feof(proc_stream) == 0)
-           {  (void)fprintf(psrp_out,"%s\n",line);
-              (void)fflush(psrp_out);
-           }
-       } while(feof(proc_stream) == 0);
-      
-    (void)pups_fclose(proc_stream);
-    (void)fprintf(psrp_out,"\n");
-    (void)fflush(psrp_out);
+       pups_set_errno(EPROTO);
+       return(-1);
+    }
 
-    return(PSRP_OK); 
-}
+    offset = head & (ring->size - 1);
+    *space = ring->data + offset;
 
+    pups_set_errno(OK);
+    if(ring->size - offset < ring->size - (head - tail))
+       return((ssize_t)(ring->size - offset));
 
+    return((ssize_t)(ring->size - (head - tail)));
+}
 
 
 
-/*-----------------------------------------------*/
-/* Show link file locks held by this application */
-/*-----------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_link_file_locks(const uint32_t argc, const char *argv[])
+/*------------------------------------------------*/
+/* Publish size bytes of reserved space (writer)  */
+/*------------------------------------------------*/
 
-{   if(strcmp("lflstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PUBLIC void psrp_ring_commit(psrp_ring_type *ring, const size_t size)
 
-    (void)pups_show_link_file_locks(psrp_out);
-    return(PSRP_OK);
+{   __atomic_store_n(&ring->header->head,ring->header->head + size,__ATOMIC_SEQ_CST);
+    psrp_ring_wake(&ring->header->reader_waiting,&ring->header->data_futex);
 }
 
 
 
 
-/*-------------------------------------------*/
-/* Show flock locks held by this application */
-/*-------------------------------------------*/
-
-_PRIVATE int32_t psrp_builtin_show_flock_locks(const uint32_t argc, const char *argv[])
-
-{   if(strcmp("flstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
-
-    (void)pups_show_flock_locks(psrp_out);
-    return(PSRP_OK);
-}
+/*-------------------------------------------------------------------*/
+/* Peek at (contiguous) data in ring (reader). The data can be read  */
+/* in place before psrp_ring_consume. Returns 0 when the writer has  */
+/* closed the ring and it is empty                                   */
+/*-------------------------------------------------------------------*/
 
+_PUBLIC ssize_t psrp_ring_peek(psrp_ring_type *ring, _BYTE **data, const int32_t timeout)
 
+{   uint64_t head,
+             tail,
+             offset;
 
+    if(ring == (psrp_ring_type *)NULL || data == (_BYTE **)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-/*-----------------------------------------------------------------*/
-/* Show non-default signal handlers installed for this application */
-/*-----------------------------------------------------------------*/
+    tail = ring->header->tail;
+    while((head = __atomic_load_n(&ring->header->head,__ATOMIC_ACQUIRE)) == tail)
+    {  if(__atomic_load_n(&ring->header->closed,__ATOMIC_ACQUIRE) != 0 && __atomic_load_n(&ring->header->head,__ATOMIC_ACQUIRE) == tail)
+       {  if(__atomic_load_n(&ring->header->abandoned,__ATOMIC_SEQ_CST) != 0)
+          {  pups_set_errno(EPIPE);
+             return(-1);
+          }
 
-_PRIVATE int32_t psrp_builtin_show_sigstatus(const uint32_t argc, const char *argv[])
+          pups_set_errno(OK);
+          return(0);
+       }
 
-{   if(strcmp("sigstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+       if(psrp_ring_wait(ring,FALSE,timeout) == (-1))
+          return(-1);
+    }
 
 
-    /*------------------------------------------*/
-    /* Show signal status for individual signal */
-    /*------------------------------------------*/
+    /*-------------------------------------------*/
+    /* Writer has corrupted the shared positions */
+    /*-------------------------------------------*/
 
-    if(argc > 1)
-    {  uint32_t i;
+    if(head - tail > ring->size)
+    {  psrp_ring_close(ring,TRUE);
 
-       for(i=1; i<argc; ++i)
-       {  if(pups_show_siglstatus(pups_signametosigno(argv[i]),psrp_out) == (-1))
-          {  (void)fprintf(psrp_out,"Not a valid signal (%s)\n",argv[i]);
-             (void)fflush(psrp_out);
-          }
-       }
+       pups_set_errno(EPROTO);
+       return(-1);
     }
 
+    offset = tail & (ring->size - 1);
+    *data  = ring->data + offset;
 
-    /*---------------------------------------*/
-    /* Show (abridged) status of all signals */
-    /*---------------------------------------*/
-
-    else
-       pups_show_sigstatus(psrp_out);
+    pups_set_errno(OK);
+    if(ring->size - offset < head - tail)
+       return((ssize_t)(ring->size - offset));
 
-    return(PSRP_OK);
+    return((ssize_t)(head - tail));
 }
 
 
 
 
-/*-----------------------------------------------------------*/
-/* Show signal mask and signals pending for this application */
-/*-----------------------------------------------------------*/
-
-_PRIVATE int32_t psrp_builtin_show_sigmaskstatus(const uint32_t argc, const char *argv[])
+/*---------------------------------------------*/
+/* Release size bytes of peeked data (reader)  */
+/*---------------------------------------------*/
 
-{   if(strcmp("maskstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PUBLIC void psrp_ring_consume(psrp_ring_type *ring, const size_t size)
 
-    pups_show_sigmaskstatus(psrp_out);
-    return(PSRP_OK);
+{   __atomic_store_n(&ring->header->tail,ring->header->tail + size,__ATOMIC_SEQ_CST);
+    psrp_ring_wake(&ring->header->writer_waiting,&ring->header->space_futex);
 }
 
 
 
 
-/*--------------------------------------------------*.
-/* Show file descriptors opened by this application */
-/*--------------------------------------------------*/
-
-_PRIVATE int32_t psrp_builtin_show_open_fdescriptors(const uint32_t argc, const char *argv[])
-
-{   if(strcmp("fstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+/*--------------------------------------------------------*/
+/* Write buffer to ring (blocking while ring is full). If */
+/* the reader stalls for PSRP_RING_TIMEOUT milliseconds   */
+/* the transfer is abandoned                              */
+/*--------------------------------------------------------*/
 
-    pups_show_open_fdescriptors(psrp_out);
-    return(PSRP_OK);
-}
+_PUBLIC ssize_t psrp_ring_write(psrp_ring_type *ring, const _BYTE *buf, const size_t size)
 
+{   size_t  written = 0;
+    ssize_t space;
+    _BYTE   *ptr    = (_BYTE *)NULL;
 
+    while(written < size)
+    {  if((space = psrp_ring_reserve(ring,&ptr,PSRP_RING_TIMEOUT)) == (-1))
+       {  if(errno == ETIMEDOUT)
+             psrp_ring_close(ring,TRUE);
 
+          return(-1);
+       }
 
-/*-------------------------------------------*/
-/* Show (active) children of current process */
-/*-------------------------------------------*/
+       if((size_t)space > size - written)
+          space = (ssize_t)(size - written);
 
-_PRIVATE int32_t psrp_builtin_show_children(const uint32_t argc, const char *argv[])
+       (void)memcpy((void *)ptr,(void *)(buf + written),space);
+       psrp_ring_commit(ring,space);
 
-{   if(strcmp("cstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+       written += space;
+    }
 
-    pups_show_children(psrp_out);
-    return(PSRP_OK);
+    return((ssize_t)written);
 }
 
 
 
-/*-------------------------------------------------------------------------------*/
-/* Show (fast) caches curently mapped into the address space of this application */
-/*-------------------------------------------------------------------------------*/
-
-_PRIVATE int32_t psrp_builtin_show_caches(const uint32_t argc, const char *argv[])
 
-{   if(strcmp("cachestat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+/*-------------------------------------------------------*/
+/* Read from ring (blocking while ring is empty). Returns */
+/* 0 at end of transfer. If the writer stalls for         */
+/* PSRP_RING_TIMEOUT milliseconds the transfer is         */
+/* abandoned                                              */
+/*-------------------------------------------------------*/
 
-    if(argc > 1)
-    {  (void)fprintf(psrp_out,"usage: cashestat <cache>\n");
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
-    }
+_PUBLIC ssize_t psrp_ring_read(psrp_ring_type *ring, _BYTE *buf, const size_t size)
 
-    if(argc == 2)
-    {  int32_t c_index; 
+{   ssize_t avail;
+    _BYTE   *ptr = (_BYTE *)NULL;
 
-       c_index = cache_name2index(FALSE,argv[1]);
-       if(cache_display_statistics(FALSE,psrp_out,c_index) == (-1))
-       {  (void)fprintf(psrp_out,"\ncache \"%s\" is not mapped into addrees space of \"%s\"\n",argv[1],appl_name);
-          (void)fflush(psrp_out);
+    if((avail = psrp_ring_peek(ring,&ptr,PSRP_RING_TIMEOUT)) <= 0)
+    {  if(avail == (-1) && errno == ETIMEDOUT)
+          psrp_ring_close(ring,TRUE);
 
-          return(PSRP_OK);
-       }
+       return(avail);
     }
-    else
-       (void)cache_display(FALSE,psrp_out);
 
-    return(PSRP_OK);
-}
+    if((size_t)avail > size)
+       avail = (ssize_t)size;
 
+    (void)memcpy((void *)buf,(void *)ptr,avail);
+    psrp_ring_consume(ring,avail);
 
+    return(avail);
+}
 
 
-#ifdef PERSISTENT_HEAP_SUPPORT
-/*---------------------------------------------------------------------------*/
-/* Show persistent heaps attached to this application - if request is of the */
-/* form hstat <heap> show the object map of that heap                        */
-/*---------------------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_persistent_heaps(const uint32_t argc, const char *argv[])
 
-{   if(strcmp("hstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+/*--------------------------------------------------------------*/
+/* Close ring (writer has finished, reader may drain what is    */
+/* left). If abandon is TRUE the transfer is being abandoned    */
+/* (by either side) and the peer's wait fails with EPIPE        */
+/*--------------------------------------------------------------*/
 
+_PUBLIC void psrp_ring_close(psrp_ring_type *ring, const _BOOLEAN abandon)
 
-    /*--------------------*/
-    /* Parse command line */
-    /*--------------------*/
+{   if(ring == (psrp_ring_type *)NULL)
+       return;
 
-    if(argc > 3 || (argc == 2 && strcmp(argv[1],"-usage") == 0))
-    {  (void)fprintf(psrp_out,"usage: hstat [<hid>]\n");
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
-    }
+    if(abandon == TRUE)
+       __atomic_store_n(&ring->header->abandoned,1,__ATOMIC_SEQ_CST);
 
+    __atomic_store_n(&ring->header->closed,1,__ATOMIC_SEQ_CST);
 
-    /*---------------------------------------------*/
-    /* Display details of specific persistent heap */
-    /*---------------------------------------------*/
+    psrp_ring_wake(&ring->header->reader_waiting,&ring->header->data_futex);
+    psrp_ring_wake(&ring->header->writer_waiting,&ring->header->space_futex);
+}
 
-    if(argc >= 2)
-    {   int32_t h_index;
-       char     heapname[SSIZE] = "";
 
 
-       /*--------------*/
-       /* Sanity check */
-       /*--------------*/
 
-       if(sscanf(argv[1],"%d",&h_index) != 1 || h_index < 0)
-       {  
-          if((h_index = msm_name2index(argv[1])) == (-1))
-          {  (void)fprintf(psrp_out,"invalid heap specification (%s)\n",argv[1]);
-             (void)fflush(psrp_out);
+/*-------------------------------------------*/
+/* Unmap ring and release its resources      */
+/*-------------------------------------------*/
 
-             return(PSRP_OK);
-          }
-       }
+_PUBLIC psrp_ring_type *psrp_ring_destroy(psrp_ring_type *ring)
 
+{   if(ring == (psrp_ring_type *)NULL)
+       return((psrp_ring_type *)NULL);
 
-       /*------------------------------------*/
-       /* Display objects on persistent heap */
-       /*------------------------------------*/
+    (void)munmap((void *)ring->header,ring->map_size);
+    (void)close(ring->des);
+    (void)pups_free((void *)ring);
 
-       if(argc == 2)
-       {  if(msm_show_mapped_objects(h_index,psrp_out) == (-1))
-          {  (void)fprintf(psrp_out,"invalid heap specification (%s)\n",argv[1]);
-             (void)fflush(psrp_out);
+    return((psrp_ring_type *)NULL);
+}
 
-             return(PSRP_OK);
-          }
-       } 
 
 
-       /*------------------------------------*/
-       /* Display details of specific object */
-       /* on peristent heap                  */
-       /*------------------------------------*/
 
-       else
-       {  int32_t o_index;
+/*---------------------*/
+/* Save dispatch table */
+/*---------------------*/
 
-          if(sscanf(argv[2],"%d",&o_index) != 1 ||  o_index < 0)
-          {  if((o_index = msm_map_objectname2index(h_index,argv[2])) == (-1))
-             {  (void)fprintf(psrp_out,"\nInvalid object specification (%s)\n",argv[2]);
-                (void)fflush(psrp_out);
+_PUBLIC  int32_t psrp_save_dispatch_table(const char *autoload_file_name)
+                       
+{   uint32_t i,
+             j,
+             objects          = 0;
 
-                return(PSRP_OK);
-              }
-          }
+    FILE     *autoload_stream = (FILE *)NULL;                                 
 
-          if(msm_show_mapped_object(h_index,o_index,psrp_out) == (-1))
-          {  (void)fprintf(psrp_out,"\nInvalid object specification (%s)\n",argv[2]);
-             (void)fflush(psrp_out);
 
-             return(PSRP_OK);
-          }
-       } 
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_save_dispatch_table] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(autoload_file_name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
 
-    /*--------------------------------------------------*/
-    /* Display details of all attached persistent heaps */
-    /*--------------------------------------------------*/
+    if(autoload_file_name == (char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
+    if(access(autoload_file_name,F_OK | R_OK | W_OK) == (-1))
+    {  (void)pups_creat(autoload_file_name,0644);
+       if((autoload_stream = fopen(autoload_file_name,"w")) == (FILE *)NULL)
+       {  pups_set_errno(EIO);
+          return(-1);
+       }
+    }
     else
-       psrp_show_persistent_heaps(psrp_out);
+    {  if((autoload_stream = fopen(autoload_file_name,"w+")) == (FILE *)NULL)
+       {  pups_set_errno(EPERM);
+          return(-1);
+       }
+    }
 
-    return(PSRP_OK);
-}
-#endif /* PERSISTENT_HEAP_SUPPORT */
 
+    /*---------------------------------------------------------------*/
+    /* We need to lock the dispatch table file as multiple processes */
+    /* could be accessing the same file                              */
+    /*---------------------------------------------------------------*/
 
+    (void)pups_get_link_file_lock(WAIT_FOREVER,autoload_file_name);
 
+    if(psrp_object_list_used == 0)
+    {  (void)fclose(autoload_stream);
+       (void)unlink(autoload_file_name);
+       (void)pups_release_link_file_lock(autoload_file_name);
 
+       pups_set_errno(OK);
+       return(PSRP_DISPATCH_ERROR);
+    }
 
-/*-------------------------------------------------------------------*/
-/* Show slaved interation client channels opened by this application */
-/*-------------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_show_open_sics(const uint32_t argc, const char *argv[])
+    /*------------------------------------------------*/
+    /* Get the number of valid objects (e.g. dispatch */
+    /* table slots which are both allocated and used) */
+    /*------------------------------------------------*/
 
-{   if(strcmp("sicstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+    for(i=0; i<psrp_object_list_allocated; ++i)
+    {  if(psrp_object_list[i].object_handle != (void *)NULL && psrp_object_list[i].aliases > 0)
+          ++objects;
+    }
 
-    psrp_show_open_sics(psrp_out);
-    return(PSRP_OK);
-}
+    (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n");
+    (void)fprintf(autoload_stream,"#    PSRP dispatch table resource file version 1.0                  \n");
+    (void)fprintf(autoload_stream,"#    (C) M.A. O'Neill, Tumbling Dice, Gosforth, 2024                \n");
+    (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n");
+    (void)fprintf(autoload_stream,"\n\n");
 
+    (void)fprintf(autoload_stream,"# Number of dispatch table objects saved\n");
+    (void)fprintf(autoload_stream,"%d\n\n",objects);
+    (void)fflush(autoload_stream);
 
- 
 
-/*-----------------------------------------------------*/
-/* Show (PUPS) entrance functions bound to application */
-/*-----------------------------------------------------*/
+    /*-------------------------------------*/
+    /* Save objects in PSRP dispatch table */
+    /*-------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_pups_show_entrance_f(const uint32_t argc, const char *argv[])
+    for(i=0; i<psrp_object_list_allocated; ++i)     
+    {   if(psrp_object_list[i].aliases > 0)
+        {  (void)fprintf(autoload_stream,"\n\n#-------------------------------------------------------------------\n");
+           (void)fprintf(autoload_stream,"#    PSRP (root tag) object: %s\n",psrp_object_list[i].object_tag[0]);
+           (void)fprintf(autoload_stream,"#-------------------------------------------------------------------\n\n");
 
-{   if(strcmp("atentrance",argv[0]) != 0) 
-       return(PSRP_DISPATCH_ERROR); 
+           (void)fprintf(autoload_stream,"# object type\n");
+           (void)fflush(autoload_stream);
 
-    pups_show_entrance_f(psrp_out);
-    return(PSRP_OK);
-}
+           if(psrp_object_list[i].object_type == PSRP_DYNAMIC_FUNCTION)
+              (void)fprintf(autoload_stream,"dynamic_function\n\n");
 
+           if(psrp_object_list[i].object_type == PSRP_STATIC_FUNCTION)
+              (void)fprintf(autoload_stream,"static_function\n\n");
 
+           if(psrp_object_list[i].object_type == PSRP_DYNAMIC_DATABAG)
+              (void)fprintf(autoload_stream,"dynamic_databag\n\n");
 
+           if(psrp_object_list[i].object_type == PSRP_STATIC_DATABAG)
+           {   int32_t slot_index;
 
-/*-------------------------------------------------*/
-/* Show (PUPS) exit functions bound to application */
-/*-------------------------------------------------*/
+              slot_index = pups_fname2index(psrp_object_list[i].object_f_name);
+              if(ftab[slot_index].homeostatic == 1)
+                 (void)fprintf(autoload_stream,"static_databag LIVE\n\n");
+              else
+                 (void)fprintf(autoload_stream,"static_databag DEAD\n\n");
+           }
 
-_PRIVATE int32_t psrp_builtin_pups_show_exit_f(const uint32_t argc, const char *argv[])
+           #ifdef HAVE_DLL_SUPPORT 
+           if(psrp_object_list[i].object_type == PSRP_PERSISTENT_HEAP)
+           {   int32_t f_index;
 
-{   if(strcmp("atexit",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
 
-    pups_show_exit_f(psrp_out);
-    return(PSRP_OK);
-}
+              /*--------------------------------*/
+              /* Get index  int32_to PUPS file table */
+              /*--------------------------------*/
 
+              f_index = pups_fname2index(psrp_object_list[i].object_f_name);
 
+              if(ftab[f_index].homeostatic == 1)
+                 (void)fprintf(autoload_stream,"dynamic function LIVEn\n");
+              else
+                 (void)fprintf(autoload_stream,"dynamic function\n\n");
+           }
+           #endif /* HAVE_DLL_SUPPORT */
 
-/*-------------------------------------------------*/
-/* Show (PUPS) exit functions bound to application */
-/*-------------------------------------------------*/
+           #ifdef PERSISTENT_HEAP_SUPPORT
+           if(psrp_object_list[i].object_type == PSRP_PERSISTENT_HEAP)
+           {   int32_t f_index;
 
-_PRIVATE int32_t psrp_builtin_pups_show_abort_f(const uint32_t argc, const char *argv[])
 
-{   if(strcmp("atabort",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+              /*--------------------------------*/
+	      /* Get index  int32_to PUPS file table */
+              /*--------------------------------*/
 
-    pups_show_abort_f(psrp_out);
-    psrp_show_on_abort_callback_f(psrp_out);
+              f_index = pups_fname2index(psrp_object_list[i].object_f_name);
 
-    return(PSRP_OK);
-}
 
+              /*-------------------------------------------*/
+	      /* Get mapping mode for this persistent heap */
+              /*-------------------------------------------*/
 
+              if(ftab[f_index].homeostatic == 1)
+                 (void)fprintf(autoload_stream,"persistent_heap LIVE\n\n");
+              else
+                 (void)fprintf(autoload_stream,"persistent_heap DEAD\n\n");
+           }
+           #endif /* PERSISTENT_HEAP_SUPPORT */
 
+           (void)fprintf(autoload_stream,"# File where object is located\n");
 
-/*-----------------------------------------------------------------*/
-/* Show (PUPS) virtual interval timers associated with application */
-/*-----------------------------------------------------------------*/
+           if(psrp_object_list[i].object_f_name != (char *)NULL)
+           {  (void)fprintf(autoload_stream,"%s\n\n",psrp_object_list[i].object_f_name);
+              (void)fflush(autoload_stream);
+           }
+           else
+           {  (void)fprintf(autoload_stream,"none\n\n");
+              (void)fflush(autoload_stream);
+           }
+ 
+           (void)fprintf(autoload_stream,"# Object alias(es)\n");
+           (void)fflush(autoload_stream);
+           (void)fprintf(autoload_stream,"%d\n\n",psrp_object_list[i].aliases);
 
-_PRIVATE int32_t psrp_builtin_pups_show_vitimers(const uint32_t argc, const char *argv[])
+           (void)fprintf(autoload_stream,"# Object root tag");
+           if(psrp_object_list[i].aliases > 1)
+              (void)fprintf(autoload_stream," and alias list\n");
+           else
+              (void)fprintf(autoload_stream,"\n");
 
-{   if(strcmp("vitstat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
+           (void)fprintf(autoload_stream,"%s ",psrp_object_list[i].object_tag[0]);
+           (void)fflush(autoload_stream);
 
-    pups_show_vitimers(psrp_out);
-    return(PSRP_OK);
-}
+           if(psrp_object_list[i].aliases > 1)
+           {  for(j=1; j<psrp_object_list[i].aliases_allocated; ++j)
+                 if(psrp_object_list[i].object_tag[j] != (char *)NULL)
+                    (void)fprintf(autoload_stream,"%s ",psrp_object_list[i].object_tag[j]);
+           }
 
+           (void)fprintf(autoload_stream,"\n\n");
+           (void)fflush(autoload_stream);
+        }
+    }
 
+    (void)fclose(autoload_stream);
+    (void)pups_release_link_file_lock(autoload_file_name);
 
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): dispatch table saved (to PSRP resource file %s)\n",
+                                  date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
+       (void)fflush(stderr);
+    }
 
-/*----------------------------------*/
-/* Show tracked heap memory objects */
-/*----------------------------------*/
+    pups_set_errno(OK);
+    return(PSRP_OK);
+}
 
-_PRIVATE int32_t psrp_builtin_show_htobjects(const uint32_t argc, const char *argv[])
 
-{   uint32_t objects;
 
-    if(strcmp("hostat",argv[0]) != 0)
-       return(PSRP_DISPATCH_ERROR);
 
-    if(argc < 2)
-    {  (void)fprintf(psrp_out,"Usage: hostat <Largest N objects | list of named objects>\n");
-       (void)fflush(psrp_out);
+/*-------------------------------------------------------------*/
+/* Remove communication channel when PSRP server process exits */
+/*-------------------------------------------------------------*/
 
-       return(PSRP_OK);
-    }
+_PUBLIC void psrp_exit(void)
+ 
+{   uint32_t i;
+    char     autoload_file_name[SSIZE] = "";
 
-    if(sscanf(argv[1],"%d",&objects) == 1)
-       pups_tshowobjects(psrp_out,&objects);
-    else
-    {  uint32_t    i,
-                    pos;
 
-       if(argc >= 2)
-       {  for(i=1; i<argc; ++i)
-          {  int32_t  cnt          = 0;
-             _BOOLEAN is_name = FALSE;
-             void     *ptr    = (void *)NULL;
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_exit] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-             /*--------------------------------*/ 
-             /* Search matab by (partial) name */ 
-             /*--------------------------------*/ 
-
-             pos = 0;
-             while((ptr = pups_tpartnametoptr(&pos, argv[i])) != (void *)NULL)
-             {    is_name = TRUE;
-
-                  pups_tshowobject(psrp_out,ptr);
-                  ++cnt;
-             }
 
+    /*---------------------------------------------------------------*/
+    /* Save the names of those objects which are to be automatically */
+    /* loaded at the next invocation of this server                  */
+    /*---------------------------------------------------------------*/
 
-             /*-----------------------------------*/
-             /* Not a name - search matab by type */
-             /*-----------------------------------*/
+    if(appl_psrp_save == TRUE)
+    {  
 
-             if(is_name == FALSE)
-             {  pos = 0;
-                while((ptr = pups_ttypetoptr(&pos ,argv[i])) != (void *)NULL)
-                {    pups_tshowobject(psrp_out,ptr);
-                     ++cnt;
-                }
-             }
+       if(getuid() != 0)
+          (void)snprintf(autoload_file_name,SSIZE,"%s/.%s.psrp",appl_home,appl_name);
+       else
+          (void)snprintf(autoload_file_name,SSIZE,"/%s.psrp",appl_name);
 
-             if(cnt == 0)
-             {  (void)fprintf(psrp_out,"\n%s is not a tracked heap object\n\n",argv[i]);
-                (void)fflush(psrp_out);
-             }
-          }
+       if(appl_verbose == TRUE)
+       {  strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): saving PSRP dispatch table (to [default] PSRP resource file %s)\n",
+                                                     date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
+          (void)fflush(stderr);
        }
+    
+       psrp_save_dispatch_table(autoload_file_name);
     }
 
-    return(PSRP_OK);
-}
 
+    /*------------------------------*/
+    /* Delete communication channel */
+    /*------------------------------*/
 
+    psrp_pnreg_unregister();
 
+    (void)pups_fclose(psrp_in);
+    (void)unlink(channel_name_in);
 
+    (void)pups_fclose(psrp_out);
+    (void)unlink(channel_name_out);
 
-/*--------------------------------------------*/
-/* Destroy PSRP object by handler table index */
-/*--------------------------------------------*/
+    if(psrp_listen_des != (-1))
+    {
 
-_PUBLIC void psrp_destroy_object(const uint32_t slot_index)
+       #ifdef PTHREAD_SUPPORT
+       psrp_sock_stop();
+       #endif /* PTHREAD_SUPPORT */
 
-{   
+       for(i=0; i<MAX_CLIENTS; ++i)
+          psrp_sock_drop(i,psrp_sock_gen[i]);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+       (void)close(psrp_listen_des);
+       (void)unlink(psrp_socket_name);
+       psrp_listen_des = (-1);
+    }
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_destroy_object] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    (void)psrp_ifree_tag_list(slot_index); 
+    /*-----------------------------*/
+    /* Destroy (idle) pooled SICs  */
+    /*-----------------------------*/
+
+    psrp_sic_pool_reap(TRUE);
+
+    if(psrp_sic_pool_timer == TRUE)
+    {  (void)pups_clearvitimer("sic_pool_homeostat");
+       psrp_sic_pool_timer = FALSE;
+    }
+
+
+    /*-------------------------------------------------*/
+    /* Release memory allocated to PSRP server process */
+    /*-------------------------------------------------*/
+
+    for(i=0; i<psrp_object_list_allocated; ++i)
+       psrp_destroy_object(i);
 }
 
 
 
 
-/*-------------------------------------*/
-/* Send error message string to client */
-/*-------------------------------------*/
+/*--------------------------------*/
+/* Get PSRP handler entry by name */
+/*--------------------------------*/
 
-_PUBLIC void psrp_error(const char *error_string)
+_PUBLIC  int32_t lookup_psrp_object_by_name(const char *name)
 
-{   
-    if(error_string == (const char *)NULL)
+{   int32_t i;
+
+    if(name == (const char *)NULL)
     {  pups_set_errno(EINVAL);
-       return;
+       return(-1);
     }
 
     /*----------------------------------*/
@@ -7377,110 +8413,94 @@ _PUBLIC void psrp_error(const char *error_string)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_destroy_object] attempt by non root thread to perform PUPS/P3 PSRP operation");
-
+       pups_error("[lookup_psrp_object_by_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    (void)fprintf(psrp_out,"[psrp %sERROR%s] %s\n",boldOn,boldOff,error_string);
-    (void)fflush(psrp_out);
+    if((i = psrp_tag_index_lookup(name)) != (-1))
+    {  pups_set_errno(OK);
+       return(i);
+    }
 
-    pups_set_errno(OK);
+    pups_set_errno(ESRCH);
+    return(-1);
 }
 
 
 
 
-/*-----------------------------------*/
-/* Get process pid from process name */
-/*-----------------------------------*/
-
-_PUBLIC pid_t psrp_pname_to_pid(const char *process_name)
+/*---------------------------------------*/
+/* Get PSRP handler list entry by handle */
+/*---------------------------------------*/
 
-{   int32_t       target_pid         = PSRP_TERMINATED;
-    pid_t         pid;
-    uint32_t      cnt                = 0;
+_PUBLIC int32_t lookup_psrp_object_by_handle(const void *object_handle)
+ 
+{   uint32_t i; 
+ 
 
-    char          cmd_line[SSIZE]    = "",
-                  procpidpath[SSIZE] = "";
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    FILE          *stream            = (FILE *)NULL;
-    DIR           *dirp              = (DIR *)NULL;
-    struct dirent *next_item         = (struct dirent *)NULL;
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[lookup_psrp_object_by_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(process_name == (const char *)NULL)
+    if(object_handle == (const void *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    if((dirp = opendir("/proc")) == (DIR *)NULL)
-    {  pups_set_errno(ENOTDIR);
-       return(-1);
-    }
+    for(i=0; i<psrp_object_list_allocated; ++i)
+       if(psrp_object_list[i].object_handle == object_handle)
+       {  pups_set_errno(OK);
+          return(i);
+       }
 
+    pups_set_errno(ESRCH);
+    return(-1); 
+}
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_pname_to_pid] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
 
-    /*----------------------------*/
-    /* Search for (named) process */
-    /*----------------------------*/
+/*-------------------------------------*/
+/* Get handle of PSRP object from name */
+/*-------------------------------------*/
 
-    pups_set_errno(OK);
-    while((next_item = readdir(dirp)) != (struct dirent *)NULL)
-    {    if(sscanf(next_item->d_name,"%d",&pid) == 1) 
-         {  (void)snprintf(procpidpath,SSIZE,"/proc/%d/cmdline",pid);
-            if ((stream = fopen(procpidpath,"r")) != (FILE *)NULL)
-            {  
-               (void)strlcpy(cmd_line,"",SSIZE);
-               (void)fgets(cmd_line,SSIZE,stream);
-               (void)fclose(stream);
+_PUBLIC void *psrp_get_handle_from_name(const char *name)
 
-               if(strncmp(cmd_line,process_name,strlen(process_name)) == 0)
-               {  ++cnt;
+{    int32_t d_index;
 
-                  if(cnt > 1)
-                  {  (void)closedir(dirp);
-                      pups_set_errno(ESRCH);
 
-                      return(PSRP_DUPLICATE_PROCESS_NAME);
-                  }
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-                  target_pid = pid;
-               }
-            }
-         }
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_get_handle_from_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((void *)NULL);
     }
 
-    (void)closedir(dirp);
+    if((d_index = lookup_psrp_object_by_name(name)) == (-1))
+       return((void *)NULL);
 
     pups_set_errno(OK);
-    return(target_pid);
+    return(psrp_object_list[d_index].object_handle);
 }
 
-               
-            
-                                        
 
-/*---------------------------*/
-/* Get process name from pid */
-/*---------------------------*/
 
-_PUBLIC _BOOLEAN psrp_pid_to_pname(const pid_t pid, char *process_name) 
 
-{   FILE *stream = (FILE *)NULL;
+/*------------------------------------*/
+/*Get name of PSRP object from handle */
+/*------------------------------------*/
 
-    char cmd_line[SSIZE]    = "",
-         procpidpath[SSIZE] = "";
+_PUBLIC  int32_t psrp_get_name_from_handle(const void *handle, char *name)
 
-    if(process_name == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+{    int32_t d_index;
 
 
     /*----------------------------------*/
@@ -7489,58 +8509,63 @@ _PUBLIC _BOOLEAN psrp_pid_to_pname(const pid_t pid, char *process_name)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_pid_to_pname] attempt by non root thread to perform PUPS/P3 PSRP operation");
-
-
-    /*-------------------------*/
-    /* Does the process exist? */
-    /*-------------------------*/
+       pups_error("[psrp_get_name_from_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    (void)snprintf(procpidpath,SSIZE,"/proc/%d/cmdline",pid);
-    if((stream = fopen(procpidpath,"r")) == (FILE *)NULL)
-    {  pups_set_errno(ESRCH);
-       return(FALSE);
+    if(handle == (const void *)NULL || name == (char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
+    if((d_index = lookup_psrp_object_by_handle(handle)) == (-1))
+       return(-1);
 
-    /*-------------------------------------------*/
-    /* Ok -- process exists -- lets get its name */
-    /*-------------------------------------------*/
+    (void)strlcpy(name,psrp_object_list[d_index].object_handle,SSIZE);
+    pups_set_errno(OK);
+    return(0);
+}
 
-    (void)fgets(cmd_line,SSIZE,stream);
-    (void)fclose(stream);
-    
-    if(sscanf(cmd_line,"%s",process_name) != 1)
-       (void)strlcpy(process_name,"<unknown>",SSIZE);
 
-    pups_set_errno(OK);
-    return(TRUE);
-} 
 
 
+/*-----------------------------------*/
+/* Get type of PSRP object from name */
+/*-----------------------------------*/
 
+_PUBLIC int32_t psrp_get_type_from_name(const char *name)
 
-/*--------------------------------*/
-/* Get pid from PSRP channel name */
-/*--------------------------------*/
+{   int32_t d_index;
 
-_PUBLIC pid_t psrp_channelname_to_pid(const char *patchboard_path,  // Patchboard containing channel information
-                                      const char *process_name,     // Name of process for which corresponding pid required
-                                      const char *process_host)     // Name of host running process
 
-{   uint32_t i,
-             entry_cnt,
-             d_cnt                       = 0;
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    pid_t    old_target_pid              = PSRP_TERMINATED,
-             target_pid                  = PSRP_TERMINATED;
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_get_type_from_name] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    uid_t    target_uid                  = (-1);
-         
-    char     strdum[SSIZE]               = "",
-             tmpstr[SSIZE]               = "",
-             channel_process_name[SSIZE] = "",
-             **entries                   = (char **)NULL;
+    if(name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    if((d_index = lookup_psrp_object_by_name(name)) == (-1))
+       return(-1);
+
+    pups_set_errno(OK);
+    return(psrp_object_list[d_index].object_type);
+}
+
+
+
+
+/*-------------------------------------*/
+/* Get type of PSRP object from handle */
+/*-------------------------------------*/
+
+_PUBLIC int32_t psrp_get_type_from_handle(const void *handle)
+
+{   int32_t d_index;
 
 
     /*----------------------------------*/
@@ -7549,110 +8574,76 @@ _PUBLIC pid_t psrp_channelname_to_pid(const char *patchboard_path,  // Patchboar
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_channelname_to_pid] attempt by non root thread to perform PUPS/P3 PSRP operation");
-
+       pups_error("[psrp_get_type_from_handle] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(patchboard_path == (const char *)NULL    ||
-       process_name    == (const char *)NULL    ||
-       process_host    == (const char *)NULL     )
+    if(handle == (const void *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    (void)strlcpy(tmpstr,process_name,SSIZE);
-    (void)strlcat(tmpstr,"#",SSIZE);
-    if((entries = pups_get_directory_entries(patchboard_path, 
-                                             tmpstr, 
-                                             &d_cnt, 
-                                             &entry_cnt)) == (char **)NULL)
-    {   pups_set_errno(ESRCH);
-        return(-1);
-    }
-
+    if((d_index = lookup_psrp_object_by_handle(handle)) == (-1))
+       return(-1);
 
-    /*-----------------------------------------------------------------*/
-    /* Check that we don't have duplicate processes with the same name */
-    /*-----------------------------------------------------------------*/
+    pups_set_errno(OK);
+    return(psrp_object_list[d_index].object_type);
+}
 
-    for(i=0; i<d_cnt; ++i)
-    {  (void)mchrep(' ',"#",entries[i]);
 
-       if(strin(entries[i],"psrp") == TRUE && strin(entries[i],"in") == TRUE)
-       {  int32_t tmp_pid;
 
-          (void)sscanf(entries[i],"%s%s%s%s%s%d%d",strdum,channel_process_name,process_host,strdum,strdum,&tmp_pid,&target_uid);
 
-          if(target_uid == getuid())
-          {  if(i > 0                                          &&
-                old_target_pid > 0                             &&
-                strcmp(process_name,channel_process_name) == 0 &&
-                tmp_pid != old_target_pid                       )
-             {
+/*--------------------------------------------------------------------------------------*/
+/* Parse PSRP dispatch request  int32_to POSIX command line format so that it can be further */
+/* processed by the comamnd line decoding utilities                                     */
+/*--------------------------------------------------------------------------------------*/
 
-                /*----------------------------------------------------*/ 
-                /* Clear memory allocated by directory search routine */
-                /*----------------------------------------------------*/ 
+_PRIVATE void psrp_argvec(uint32_t    *r_argc, const char *request)
 
-                for(i=0; i<d_cnt; ++i)
-                   (void)pups_free((void *)entries[i]);
-                (void)pups_free((void *)entries);
+{   uint32_t i;
+    int32_t  ret;
+    char     next_arg[SSIZE]       = "";
 
-                pups_set_errno(EEXIST);
-                return(PSRP_DUPLICATE_PROCESS_NAME);
-             }
+    _IMMORTAL _BOOLEAN entered = FALSE;
 
-             else
-             {  target_pid     = tmp_pid;
-                old_target_pid = target_pid;
-             }
-          }
-       }
+    for(i=0; i<MAX_CMD_ARGS; ++i)
+    {  if(entered == FALSE)
+          r_argv[i] = (char *)pups_malloc(SSIZE);
+       (void)strlcpy(r_argv[i],"",SSIZE);
     }
 
+    entered = TRUE;
+    *r_argc = 0;
 
-    /*----------------------------------------------------*/
-    /* Clear memory allocated by directory search routine */
-    /*----------------------------------------------------*/
-
-    for(i=0; i<d_cnt; ++i)
-       (void)pups_free((void *)entries[i]);
-    (void)pups_free((void *)entries);
 
+    /*--------------------------------------------*/
+    /* Reset internal pointers in strext function */
+    /*--------------------------------------------*/
 
-    /*----------------------------------------------------------*/
-    /* Is the channel actually associated with a live processs? */
-    /*----------------------------------------------------------*/
+    (void)strext(' ',(char *)NULL,(char *)NULL);
+    do {    ret = strext(' ',next_arg,request);
 
-    if(target_pid > 0 && kill(target_pid,SIGALIVE) == (-1))
-    {  pups_set_errno(EEXIST);
-       return(PSRP_TERMINATED);
-    }
- 
-    pups_set_errno(OK);
-    return(target_pid);
-}
+            (void)strlcpy(r_argv[(*r_argc)],next_arg,SSIZE);
+            ++(*r_argc);
 
+            if(*r_argc > MAX_CMD_ARGS)
+            {  (void)snprintf(errstr,SSIZE,"[psrp_argvec] too man arguments (max %d)",MAX_CMD_ARGS);
+               pups_error(errstr);
+            }
 
+       } while(ret == TRUE);
+}
 
 
-/*---------------------------------------------*/
-/* Resolve process name from PSRP channel name */
-/*---------------------------------------------*/
 
-_PUBLIC _BOOLEAN psrp_pid_to_channelname(const char *patchboard_path,  // Patchboard containing channel information
-                                         const pid_t             pid,  // Pid for which corresponding channelname is required
-                                         char          *process_name,  // Name of process corresponding to pid
-                                         char          *process_host)  // Name of host running process corresponding to pid
 
-{  uint32_t i,
-            entry_cnt,
-            d_cnt          = 0;
+/*-------------------------*/
+/* Initialise PSRP handler */
+/*-------------------------*/
 
-   uid_t    uid;
+_PUBLIC _BOOLEAN psrp_std_init(const int32_t argc, const char *argv[])
 
-   char     strdum[SSIZE]  = "",
-            pid_str[SSIZE] = "",
-            **entries      = (char **)NULL;
+{   uint32_t         i;
+    char             item[SSIZE] = "";
+    psrp_object_type *psrp_object;
 
 
     /*----------------------------------*/
@@ -7661,1560 +8652,1381 @@ _PUBLIC _BOOLEAN psrp_pid_to_channelname(const char *patchboard_path,  // Patchb
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_pid_to_channelname] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       pups_error("[psrp_std_init] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(patchboard_path == (char *)NULL    ||
-       pid             <  0               || 
-       process_name    == (char *)NULL    ||
-       process_host    == (char *)NULL     )
+    if(argv == (const char **)NULL)
     {  pups_set_errno(EINVAL);
-       return(FALSE);
+       return(-1);
     }
 
 
-    /*-----------------------------------------*/
-    /* Check to see if process actually exists */
-    /*-----------------------------------------*/
-
-    if(kill(pid,SIGALIVE) == (-1))
-    {  pups_set_errno(EEXIST);
-       return(FALSE);
-    }
+    /*-------------------------------------*/
+    /* Reset argument decode status vector */
+    /*-------------------------------------*/
 
+    t_args = argc;
 
-    /*------------------------------------------------*/
-    /* Open stream and run ps command to get pid list */
-    /*------------------------------------------------*/
 
-    (void)snprintf(pid_str,SSIZE,"%d",pid);
-    if((entries = pups_get_directory_entries(patchboard_path, 
-                                             pid_str, 
-                                             &d_cnt, 
-                                             &entry_cnt)) == (char **)NULL)
-    {   pups_set_errno(ESRCH);
-        return(FALSE);
-    }
+    /*---------------------------------------------------------*/
+    /* By the time we have got here we have implicitly decoded */
+    /* the first argument                                      */
+    /*---------------------------------------------------------*/
 
+    argd[0] = TRUE;
+    for(i=1; i<MAX_CMD_ARGS; ++i)
+       argd[i] = FALSE;
 
-    /*--------------------------------------------------------------*/
-    /* values <= 0 imply that their is no channel for specified pid */
-    /*--------------------------------------------------------------*/
+    return(TRUE);
+}
 
-    if(d_cnt > 0)
-    {  for(i=0; i<d_cnt; ++i)    
-       {  if(strin(entries[i],"psrp") == TRUE)
-          {  int32_t tmp_pid;
 
-             (void)mchrep(' ',"#",entries[i]);
-             (void)sscanf(entries[i],"%s%s%s%s%s%d%d",strdum,process_name,process_host,strdum,strdum,&tmp_pid,&uid);
 
+ 
+/*------------------------------------------------*/
+/* PSRP handler command line parser error handler */
+/*------------------------------------------------*/
 
-             /*----------------------------------------------*/
-             /* Check to see if we actually own this process */
-             /*----------------------------------------------*/
+_PUBLIC _BOOLEAN psrp_t_arg_errs(const  int32_t argc, const _BOOLEAN argd[], const char *args[])
 
-             if(uid != getuid())
-             {  pups_set_errno(EACCES);
-                return(FALSE);
-             }
+{   uint32_t i;
+    _BOOLEAN parse_failed = FALSE;
 
-             if(pid == tmp_pid)
-             {
 
-                /*----------------------------------------------------*/
-                /* Clear memory allocated by directory search routine */
-                /*----------------------------------------------------*/
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-                for(i=0; i<d_cnt; ++i)
-                   (void)pups_free((void *)entries[i]);
-                (void)pups_free((void *)entries);
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_t_arg_errs] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-                pups_set_errno(OK);
-                return(TRUE);
-             }
-          }
-       }
+    if(argd == (_BOOLEAN *)NULL || args == (char **)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
+    for(i=0; i<t_args; ++i)
+    {   if(argd[i] == FALSE)
+        {  if(parse_failed == FALSE)
+           {  (void)fprintf(psrp_out,"\n\n");
+              parse_failed = TRUE;
+           }
 
-    /*----------------------------------------------------*/
-    /* Clear memory allocated by directory search routine */
-    /*----------------------------------------------------*/
+           (void)fprintf(psrp_out,"psrp_t_arg_errs: failed to parse: %s\n",args[i]);
+           (void)fflush(psrp_out);
+        }
+    }
 
-    for(i=0; i<d_cnt; ++i)
-       (void)pups_free((void *)entries[i]);
-    (void)pups_free((void *)entries);
-
-    (void)strlcpy(process_name,"nochan",SSIZE);
-    (void)strlcpy(process_host,"nohost",SSIZE);
-
-    pups_set_errno(ESRCH);
-    return(FALSE);
+    pups_set_errno(OK);
+    if(parse_failed == TRUE)
+       return(FALSE);
+    else
+       return(TRUE);
 }
 
 
 
 
-/*---------------------------------------------------*/
-/* Initialise slaved interation client channel table */
-/*---------------------------------------------------*/
+/*-------------------------------------------------*/
+/* Switch error logging on or off from PSRP client */
+/*-------------------------------------------------*/
 
-_PRIVATE void psrp_initsic(void)
+_PRIVATE int32_t psrp_builtin_appl_verbose(const uint32_t argc, const char *argv[])
 
-{   uint32_t i;
+{   if(strcmp("appl_verbose",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
-    {  (void)strlcpy(channel[i].in_name,  "",SSIZE);
-       (void)strlcpy(channel[i].out_name, "",SSIZE);
-       (void)strlcpy(channel[i].host_name,"",SSIZE);
-       (void)strlcpy(channel[i].ssh_port, "",SSIZE);
-       (void)strlcpy(channel[i].pen,      "",SSIZE);
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: appl_verbose [on | off]\n\n");
+       (void)fflush(psrp_out);
 
-       channel[i].index      = FREE; 
-       channel[i].in_stream  = (FILE *)NULL;
-       channel[i].out_stream = (FILE *)NULL;
+       return(PSRP_OK);
     }
 
-    if(appl_verbose == TRUE)
-    {  strdate(date);
+    if(strcmp(argv[1],"on") == 0)
+    {  (void)fprintf(psrp_out,"\nserver transaction/error logging enabled\n\n");
+       (void)fflush(psrp_out);
 
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP slaved  interaction clients (%d channels available)\n",
-                                       date,appl_name,appl_pid,appl_host,appl_owner,PSRP_MAX_SIC_CHANNELS);
-       (void)fflush(stderr);
+       appl_verbose = TRUE;
+       return(PSRP_OK);
     }
-}
+    else
+    {  if(strcmp(argv[1],"off") == 0)
+       {  (void)fprintf(psrp_out,"\nserver transaction/error logging disabled\n\n");
+          (void)fflush(psrp_out);
 
+          appl_verbose = FALSE;
+       }
+       else
+       {  (void)fprintf(psrp_out,"\nusage: appl_verbose [on | off]\n\n");
+          (void)fflush(psrp_out);
+       }
 
+       return(PSRP_OK);
+    }
 
+    return(PSRP_DISPATCH_ERROR);
+}
 
-#ifdef PERSISTENT_HEAP_SUPPORT
-/*---------------------------------------------------------*/
-/* Show persistent heaps mapped into process address space */
-/*---------------------------------------------------------*/
 
-_PUBLIC void psrp_show_persistent_heaps(const FILE *stream)
 
-{   uint32_t i,
-             heaps = 0;
 
+/*--------------------------------------------------*/
+/* Switch error handling on or off from PSRP client */
+/*--------------------------------------------------*/
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+_PRIVATE int32_t psrp_builtin_error_handling(const uint32_t argc, const char *argv[])
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_show_persistemt_heaps] attempt by non root thread to perform PUPS/P3 PSRP operation");
+{   if(strcmp("error_handling",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    if(stream == (FILE *)NULL)
-    {  pups_set_errno(EINVAL);
-       return;
-    }
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: error_handling [on | off]\n\n");
+       (void)fflush(psrp_out);
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&htab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+       return(PSRP_OK);
+    }
 
+    if(strcmp(argv[1],"on") == 0)
+    {  (void)fprintf(psrp_out,"\nserver error handling enabled\n\n");
+       (void)fflush(psrp_out);
 
-    /*---------------------------------------*/
-    /* Check to see that we have initialised */
-    /* persistent heaps                      */
-    /*---------------------------------------*/
+       psrp_error_handling = TRUE;
+       return(PSRP_OK);
+    }
+    else
+    {  if(strcmp(argv[1],"off") == 0)
+       {  (void)fprintf(psrp_out,"\nerror handling disabled\n\n");
+          (void)fflush(psrp_out);
 
-    if(msm_init == FALSE)
-    {  (void)fprintf(stream,"\n\n    Persistent heaps not initialised\n\n");
-       (void)fflush(stream);
+          psrp_error_handling = FALSE;
+       }
+       else
+       {  (void)fprintf(psrp_out,"\nusage: error_handling [on | off]\n\n");
+          (void)fflush(psrp_out);
+       }
 
-       pups_set_errno(EINVAL);
-       return;
+       return(PSRP_OK);
     }
 
-    (void)fprintf(stream,"\n\n    Persistent heaps attached\n");
-    (void)fprintf(stream,"    =========================\n\n");
-    (void)fflush(stream);
+    return(PSRP_DISPATCH_ERROR);
+}
 
 
-    /*-----------------------------------------------------------*/
-    /* Display abridged details of each attached persistent heap */
-    /*-----------------------------------------------------------*/
 
-    for(i=0; i<appl_max_pheaps; ++i)
-    {
+#ifdef SSH_SUPPORT
+/*------------------------------------------*/
+/* Set ssh compression mode for PSRP client */
+/*------------------------------------------*/
 
-       #ifdef PSRPLIB_DEBUG
-       (void)fprintf(stderr,"HTABLE: %d name: (%s)\n",i,htable[i].name);
-       (void)fflush(stderr);
-       #endif /* PSRPLIB_DEBUG */
+_PRIVATE int32_t psrp_builtin_ssh_compress(const uint32_t argc, const char *argv[])
 
-       if(strcmp(htable[i].name,"") != 0)
-       {  
+{   if(strcmp("compress",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-          (void)fprintf(stream,"    %04d: \"%-32s\"  mapped at %016lx virtual (size %016lx bytes)\n",i,
-                                                                                        htable[i].name,
-                                                                     (uint64_t         )htable[i].addr,
-                                                                     htable[i].edata - htable[i].sdata);
-          (void)fflush(stream);
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: compress [on | off]\n\n");
+       (void)fflush(psrp_out);
 
-          ++heaps;
-       }
+       return(PSRP_OK);
     }
 
+    if(strcmp(argv[1],"on") == 0)
+    {  (void)fprintf(psrp_out,"\nserver ssh compression enabled\n\n");
+       (void)fflush(psrp_out);
 
-    /*---------------------------------------------*/
-    /* Display number of attached persistent heaps */
-    /*---------------------------------------------*/
-
-    if(heaps == 0)
-    {  (void)fprintf(stream,"    no persistent heaps mapped (%04d slots free)\n\n",appl_max_pheaps,appl_max_pheaps);
-       (void)fflush(stream);
+       ssh_compression = TRUE;
+       return(PSRP_OK);
     }
-    else if(heaps == 1)
-       (void)fprintf(stream,"\n\n    %04d persistent heap mapped  int32_to process address space (%04d slots free)\n\n",1,appl_max_pheaps,appl_max_pheaps - 1);
-    else if(heaps > 1)
-       (void)fprintf(stream,"\n\n    %04d persistent heaps mapped  int32_to process address space (%04d slots free)\n\n",heaps,appl_max_pheaps,appl_max_pheaps - heaps);
+    else
+    {  if(strcmp(argv[1],"off") == 0)
+       {  (void)fprintf(psrp_out,"\nserver ssh compression disabled\n\n");
+          (void)fflush(psrp_out);
 
-    (void)fflush(stream);
+          ssh_compression = FALSE;
+       }
+       else
+       {  (void)fprintf(psrp_out,"\nusage: compress  [on | off]\n\n");
+          (void)fflush(psrp_out);
+       }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&htab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+       return(PSRP_OK);
+    }
 
-    pups_set_errno(OK);
+    return(PSRP_DISPATCH_ERROR);
 }
-#endif /* PERSISTENT_HEAP_SUPPORT */
 
 
 
 
-/*----------------------------------*/
-/* Show open slaved client channels */
-/*----------------------------------*/
-
-_PUBLIC void psrp_show_open_sics(const FILE *stream)
+/*------------------------------------------*/
+/* Set ssh remote host port for PSRP client */
+/*------------------------------------------*/
 
-{   uint32_t i,
-             sics = 0;
+_PRIVATE int32_t psrp_builtin_ssh_port(const uint32_t argc, const char *argv[])
 
+{   char port_id[SSIZE] = "";
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(strcmp("port",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_show_open_sics] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: port <port number | default>\n\n");
+       (void)fflush(psrp_out);
 
-    if(stream == (FILE *)NULL)
-    {  pups_set_errno(EINVAL);
-       return;
+       return(PSRP_OK);
     }
 
-    (void)fprintf(stream,"\n\n     Slaved interation client channels (SICs) free\n");
-    (void)fprintf(stream,"     =============================================\n\n");
+    if(sscanf(argv[0],"%d",&port_id) != 1 || port_id < 0)
+    {  if(strcmp(port_id,"default") == 0)
 
-    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
-    {  if(channel[i].index != FREE)
-       {  char type[SSIZE] = "";
 
-          if(channel[i].type == SIC_FIFO)
-             (void)strlcpy(type,"[duplex FIFO]",SSIZE);
-          else
-             (void)strlcpy(type,"[ssh tunnel]",SSIZE); 
+          /*---------------------------*/
+          /* ssh is using default port */
+          /*---------------------------*/
 
-          #ifdef SSH_SUPPORT
-          (void)fprintf(stream,"    %04d: %-32s (on host %-48s via %-48s) %-16s (ssh port: %s)\n",i,
-                                                                                     channel[i].pen,
-                                                                                channel[i].out_name,
-                                                                               channel[i].host_name,
-                                                                                               type,
-                                                                                channel[i].ssh_port);
-          #else
-          (void)fprintf(stream,"    %04d: %-32s (on host %-48s via %-48s) %-16s (ssh port: %s)\n",i,
-                                                                                     channel[i].pen,
-                                                                                channel[i].out_name,
-                                                                               channel[i].host_name,
-                                                                                               type);
-          #endif /* SSH_SUPPPORT */
+          (void)strlcpy(ssh_remote_port,"",SSIZE);
+       else 
+       {  
 
-          (void)fflush(stream);
-          ++sics;
+          /*------------------------------------------------*/
+          /* ssh is using user defined port. This is useful */
+          /* when the remote psrp server is running is a    */
+          /* container                                      */
+          /*------------------------------------------------*/
+
+          (void)fprintf(psrp_out,"remote ssh port must be an (>= 0)\n");
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
        }
     }
+    else 
+       (void)strlcpy(ssh_remote_port,port_id,SSIZE);
 
-    if(sics == 0)
-       (void)fprintf(stream,"\n\n     no sics in use (%04d slots free)\n\n",PSRP_MAX_SIC_CHANNELS);
-    else if(sics == 1)
-       (void)fprintf(stream,"\n\n     %04d sic in use (%04d slots free)\n\n", 1,PSRP_MAX_SIC_CHANNELS - 1);
+    if(strcmp(port_id,"default") == 0)
+       (void)fprintf(psrp_out,"using default port (22) for ssh\n");
     else
-       (void)fprintf(stream,"    %04d sics in use (%04d slots free)\n\n",sics,PSRP_MAX_SIC_CHANNELS - sics);
-
-    (void)fflush(stream);
-
-    pups_set_errno(OK);
+       (void)fprintf(psrp_out,"using (remote) port (%s) for ssh\n",ssh_remote_port);
+    (void)fflush(psrp_out);
+    
+    return(PSRP_OK);
 }
+#endif /* SSH_SUPPORT */
+
 
-                                                        
 
 
 /*-------------------------------------------------*/
-/* Create connection to slaved PSRP client process */
+/* Switch error logging on or off from PSRP client */
 /*-------------------------------------------------*/
 
-#ifdef SSH_SUPPORT
-_PUBLIC psrp_channel_type *psrp_create_slaved_interaction_client(const char  *host_name,  // Host to create client on 
-                                                                 const char  *ssh_port,   // Port on client
-                                                                 const char  *psrp_pen)   // PEN of client
-#else
-_PUBLIC psrp_channel_type *psrp_create_slaved_interaction_client(const char  *psrp_pen)   // PEN of client
-#endif /* SSH_SUPPORT */
-{   uint32_t i,
-             sic_index;
-
-    int32_t  ssh_portNo                   = (-1), 
-             scp,
-             ft_index,
-             get_items;
+_PRIVATE int32_t psrp_builtin_transactions(const uint32_t argc, const char *argv[])
 
-    char     eff_psrp_pen[SSIZE]          = "psrp",
-             sic_channel_in_name[SSIZE]   = "",
-             sic_channel_out_name[SSIZE]  = "",
-             psrp_command[SSIZE]          = "",
-             psrp_pathname[SSIZE]         = "",
-             pwd_file_name[SSIZE]         = "",
-             slaved_psrp_client_ok[SSIZE] = "";
+{   _BOOLEAN log;
 
-    _BOOLEAN local_client                 = TRUE,
-             channel_in_use               = FALSE,
-             channel_allocated            = FALSE;
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
+    if(strcmp("log",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: transactions [on | off]\n\n");
+       (void)fflush(psrp_out);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_create_slaved_interaction_client] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       return(PSRP_OK);
+    }
 
+    if(strcmp(argv[1],"on") == 0)
+    {  (void)fprintf(psrp_out,"\nserver transaction logging enabled\n\n");
+       (void)fflush(psrp_out);
 
-    /*----------------------------------*/
-    /* Get name of slaved psrp instance */
-    /*----------------------------------*/
+       log = TRUE;
+    }
+    else if(strcmp(argv[1],"off") == 0)
+    {  (void)fprintf(psrp_out,"\nserver transaction logging disabled\n\n");
+       (void)fflush(psrp_out);
 
-    if(psrp_pen != (char *)NULL)
-       (void)strlcpy(eff_psrp_pen,psrp_pen,SSIZE);
+       log = FALSE;
+    }
+    else
+    {  (void)fprintf(psrp_out,"\nusage: transactions [on | off]\n\n");
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
-    #ifdef SSH_SUPPORT
-    /*--------------------------*/
-    /* Check port specification */
-    /*--------------------------*/
 
-    if(ssh_port                  != (char *)NULL  && 
-       strcmp(ssh_port,"")       != 0             && 
-       strcmp(ssh_port,"notset") != 0              )
-    {  if(sscanf(ssh_port,"%d",&ssh_portNo) != 1 || ssh_portNo <= 0)
-       {  pups_set_errno(EINVAL);
-          return((psrp_channel_type *)NULL);
-       }
-    }
-    #endif /* SSH_SUPPORT */
+    /*-----------------------------------------------*/
+    /* Socket transport workers read logging flags   */
+    /*-----------------------------------------------*/
 
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-    /*-----------------------------------------------------------------------------------*/
-    /* We have not yet created this channel so find a free slot in the channel table and */
-    /* allocate it.                                                                      */
-    /*-----------------------------------------------------------------------------------*/
+    psrp_log[c_client] = log;
 
-    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
-    {  if(channel[i].index == FREE)
-       {
+    #ifdef PTHREAD_SUPPORT
+    psrp_sock_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-          /*------------------------------*/
-          /* SIC channel can be allocated */
-          /*------------------------------*/
+    return(PSRP_OK);
+}
 
-          sic_index         = i;
-          channel_allocated = TRUE;
-          break;
-       }
-    }
 
 
-    /*-------------------------------------------------*/
-    /* SIC channel names for input and output channels */
-    /*-------------------------------------------------*/
 
-    (void)snprintf(sic_channel_in_name,SSIZE, "%s/psrp#%s#%s#fifo#in#%d#%d#sic#%d" ,appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid,sic_index); 
-    (void)snprintf(sic_channel_out_name,SSIZE,"%s/psrp#%s#%s#fifo#out#%d#%d#sic#%d",appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid,sic_index);
 
+/*-------------------------*/
+/* Load new dispatch table */
+/*-------------------------*/
 
-    /*-------------------------*/
-    /* All SIC channels in use */
-    /*-------------------------*/
+_PRIVATE int32_t psrp_builtin_autosave_dispatch_table(const uint32_t argc, const char *argv[])
 
-    if(channel_allocated == FALSE)
-    {  pups_set_errno(ENFILE);
-       return((psrp_channel_type *)NULL);
-    }
+{   char item[SSIZE] = "";
 
+    if(strcmp("autosave",argv[0]) != 0)
+        return(PSRP_DISPATCH_ERROR);
 
-    /*----------------------------------------------------------*/
-    /* Create FIFO channels for local slaved interaction client */
-    /*----------------------------------------------------------*/
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: autosave [on | off]\n\n");
+       (void)fflush(psrp_out);
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
+       return(PSRP_OK);
+    }
 
-       if(host_name != (char *)NULL)
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): creating remote SIC channel [to host %s] (via slaved client %s)\n",
-                                                 date,appl_name,appl_pid,appl_host,appl_owner,host_name,eff_psrp_pen);
+    if(argc > 1)
+    {  if(strcmp(argv[1],"on") == 0)
+          appl_psrp_save = TRUE;
+       else if(strcmp(argv[1],"off") == 0)
+          appl_psrp_save = FALSE;
        else
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): creating local SIC channel (via slaved client %s)\n",
-                                             date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
-       (void)fflush(stderr);
+       {  (void)fprintf(psrp_out,"   \nusage: autosave [on | off]\n\n");
+          (void)fflush(psrp_out);         
+ 
+          return(PSRP_OK);
+       }
     }
 
+    if(appl_psrp_save == TRUE)
+       (void)fprintf(psrp_out,"\n   Dispatch table automatically saved when application exits (to ~/.%s.psrp)\n\n",
+                                                                                                         appl_name);
+    else
+       (void)fprintf(psrp_out,"\n   Dispatch table is not automatically saved when application exits\n\n");
 
-    /*---------------------------------------------------*/
-    /* Fill in (common) fields of SIC channel descriptor */
-    /*---------------------------------------------------*/
+    (void)fflush(psrp_out);
 
-    channel[sic_index].index = sic_index;
+    return(PSRP_OK);
+}
 
-    (void)strlcpy(channel[sic_index].in_name, sic_channel_in_name,SSIZE);
-    (void)strlcpy(channel[sic_index].out_name,sic_channel_out_name,SSIZE);
 
-    if(host_name == (char *)NULL)
-    {  (void)strlcpy(channel[sic_index].host_name,appl_host,SSIZE);
-        channel[sic_index].remote = FALSE;
-    }
-    else
-    {  (void)strlcpy(channel[sic_index].host_name,host_name,SSIZE);
-        channel[sic_index].remote = TRUE;
-    }
 
 
+/*--------------------------*/
+/* Load new dispatch table  */
+/*--------------------------*/
 
-    /*----------------------*/
-    /* Non default ssh port */
-    /* (e.g. for container) */
-    /*----------------------*/
+_PRIVATE int32_t psrp_builtin_load_dispatch_table(const uint32_t argc, const char *argv[])
 
-    if(ssh_portNo >  0)
-       (void)strlcpy(channel[sic_index].ssh_port,ssh_port,SSIZE);
-    (void)strlcpy(channel[sic_index].pen,eff_psrp_pen,SSIZE);
+{   char item[SSIZE] = "";
 
+    if(strcmp("load",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    /*----------------------------------------------*/
-    /* Create physical channel (as named FIFO pair) */
-    /*----------------------------------------------*/
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: load <PSRP resource file name>\n\n");
+       (void)fflush(psrp_out);
 
-    (void)mkfifo(sic_channel_in_name,0600);
-    channel[sic_index].in_stream  = pups_fopen(sic_channel_in_name, "w",LIVE);
-    (void)psrp_empty_fifo(fileno(channel[sic_index].in_stream));
+       return(PSRP_OK);
+    }
 
-    (void)mkfifo(sic_channel_out_name,0600);
-    channel[sic_index].out_stream = pups_fopen(sic_channel_out_name,"r",LIVE);
-    (void)psrp_empty_fifo(fileno(channel[sic_index].out_stream));
+    (void)psrp_load_dispatch_table(TRUE,argv[1]);
 
+    (void)fprintf(psrp_out,"\nPSRP resource file %s loaded (commands appended to existing dispatch table)\n",argv[1]);
+    (void)fflush(psrp_out);
 
-    /*-----------------------------------------------------------------*/
-    /* Give the slave channel FIFO's the same level of protection as   */
-    /* a PSRP channel -- e.g. homeostatic protection cannot be removed */
-    /*-----------------------------------------------------------------*/
+    return(PSRP_OK);
+}
 
-    ft_index = pups_get_ftab_index(fileno(channel[sic_index].in_stream));
-    ftab[ft_index].psrp    = TRUE;
-    ftab[ft_index].creator = TRUE;
 
-    ft_index = pups_get_ftab_index(fileno(channel[sic_index].out_stream));
-    ftab[ft_index].psrp    = TRUE;
-    ftab[ft_index].creator = TRUE;
 
+/*---------------------*/
+/* Save dispatch table */
+/*---------------------*/
 
-    /*----------------------------------------*/
-    /* Start remote slaved interaction client */ 
-    /*----------------------------------------*/
+_PRIVATE int32_t psrp_builtin_save_dispatch_table(const uint32_t argc, const char *argv[])
 
-    if(strccpy(psrp_pathname,pups_search_path("PATH","psrp")) == (char *)NULL)
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
+{   char item[SSIZE] = "";
 
+    if(strcmp("save",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-          /*--------------------------*/
-          /* Cannot find psrp command */
-          /*--------------------------*/
+    if(argc != 2)
+    {  (void)fprintf(psrp_out,"\nusage: save <PSRP resource file name>\n\n");
+       (void)fflush(psrp_out);
 
-          if(host_name != (char *)NULL)
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) SIC channel [to host %s] (cannot find psrp client in path)\n",
-                                                                                                 date,appl_name,appl_pid,appl_host,appl_owner,host_name);
-          else
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create local SIC channel (cannot find psrp client in path)\n",
-                                                                                date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
-       }
+       return(PSRP_OK);
+    }
 
-       psrp_clear_channel_slot(&channel[sic_index]);
+    (void)psrp_save_dispatch_table(argv[1]);
 
-       pups_set_errno(EEXIST);
-       return((psrp_channel_type *)NULL);
-    }
-
-
-    /*--------------------------------------------------------------------*/
-    /* Build slaved client command (noting whether it is local or remote) */
-    /*--------------------------------------------------------------------*/
+    (void)fprintf(psrp_out,"\nPSRP resource file %s saved (contains all current dispatch table objects)\n\n",argv[1]);
+    (void)fflush(psrp_out);
 
+    return(PSRP_OK);
 
-    /*----------------------------------------*/
-    /* Slaved PSRP client is running remotely */
-    /*----------------------------------------*/
+}
 
-    if(host_name                     != (char *)NULL  && 
-       strcmp(host_name,"localhost") != 0             && 
-       strcmp(host_name,"notset")    != 0             &&
-       strcmp(host_name,"")          != 0              )
-    {  (void)snprintf(psrp_command,SSIZE,"%s -slaved -on %s -from %s %s %d -pen %s -noprompt",
-                                                                                psrp_pathname,
-                                                                                    host_name,
-                                                                                    appl_host,
-                                                                                    appl_name,
-                                                                                     appl_pid,
-                                                                                 eff_psrp_pen);
-       local_client = FALSE;
-    }
 
-    /*---------------------------------------*/
-    /* Slaved PSRP client is running locally */
-    /*---------------------------------------*/
 
-    else
-       (void)snprintf(psrp_command,SSIZE,"%s -slaved -pen %s -noprompt",
-                                                          psrp_pathname,
-                                                           eff_psrp_pen);
 
+/*----------------------*/
+/* Reset dispatch table */
+/*----------------------*/
 
-    /*---------------------------------------------*/
-    /* Start (local) slaved instane of psrp client */
-    /*---------------------------------------------*/
+_PRIVATE int32_t psrp_builtin_reset_dispatch_table(const uint32_t argc, const char *argv[])
 
-    if(local_client == TRUE)
-    { 
+{   char item[SSIZE] = "";
 
-       /*----------------------------------------------------*/
-       /* Child side of fork                                 */
-       /* Associate stdio (for slaved ssh) with PSRP channel */
-       /*----------------------------------------------------*/
+    if(strcmp("reset",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-       if((scp = pups_fork(FALSE,FALSE)) == 0)
-       {
+    (void)psrp_reset_dispatch_table();
 
-          /*--------------------------------------*/
-          /* Connect slaved client to SIC channel */
-          /*--------------------------------------*/
+    (void)fprintf(psrp_out,"\ndispatch table reset to default state (static aliases deleted and dynamic objects detached)\n\n");
+    (void)fflush(psrp_out);
 
-          (void)fclose(stdin);
-          stdin = fopen(sic_channel_in_name,  "r");
+    return(PSRP_OK);
+}
 
-          (void)fclose(stdout);
-          stdout = fopen(sic_channel_out_name,"w");
 
-          (void)fclose(stderr);
-          stderr = fopen(sic_channel_out_name,"w");
 
 
-          /*----------------------------------*/
-          /* Start local slaved psrp instance */
-          /*----------------------------------*/
 
-          (void)execlp("sh","sh","-c",psrp_command,(char *)NULL);
+/*-------------------------*/
+/* Builtin function detach */
+/*-------------------------*/
 
+_PRIVATE int32_t psrp_builtin_detach_object(const uint32_t argc, const char *argv[])
 
-          /*---------------------------------------------------------*/
-          /* We should not get here -- if we do an error has occured */
-          /*---------------------------------------------------------*/
+{   uint32_t i;
+     int32_t ret_code;
 
-          _exit(255);
-       }
+    char     item[SSIZE] = "";
 
+    if(strcmp("detach",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-       /*---------------------*/
-       /* Parent side of fork */
-       /*---------------------*/
+    if(argc < 2)
+    {  psrp_error("Usage: detach <object-list>");
+       return(PSRP_OK);
+    }
 
-       else if(scp == (-1))
-       {  
+    for(i=1; i<argc; ++i)
+    {  
 
-          /*---------------------------------------*/
-          /* Failed to create slaved psrp instance */
-          /*---------------------------------------*/
+        /*---------------------------------------------------------------*/
+        /* If object is "all" then detach all dynamic objects and re-set */
+        /* alias list of all static objects                              */
+        /*---------------------------------------------------------------*/
 
-          (void)psrp_destroy_slaved_interaction_client(&channel[sic_index],TRUE);
+        if(strcmp(argv[i],"all") == 0)
+        {  psrp_reset_dispatch_table();
 
-          if(appl_verbose == TRUE)
-          {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create local (duplex FIFO) SIC channel (exec failed)\n",
-                                                                          date,appl_name,appl_pid,appl_host,appl_owner);
-             (void)fflush(stderr);
-          }
+           (void)fprintf(psrp_out,"\nall objects detached\n");
+           (void)fflush(psrp_out);
 
-          psrp_clear_channel_slot(&channel[sic_index]);
+           return(PSRP_OK);
+        }
 
-          pups_set_errno(ENOEXEC);
-          return((psrp_channel_type *)NULL);
-       }
+        ret_code = psrp_detach_object_by_name(argv[i]);
+ 
+        switch(ret_code)
+        {   case PSRP_DISPATCH_ERROR:    (void)fprintf(psrp_out,"\ndynamic object not in PSRP handler dispatch_list (%s)\n",argv[i]);
+                                         break;
+ 
+            case PSRP_DYNAMIC_FUNCTION:  (void)fprintf(psrp_out,"\ndynamic function detached (%s)\n",argv[i]);
+                                         break;
 
+            case PSRP_DYNAMIC_DATABAG:   (void)fprintf(psrp_out,"\ndynamic databag detached (%s)\n",argv[i]);
+                                         break;
 
-       /*----------------------------------------------------*/
-       /* Fill in remaining fields of SIC channel descriptor */
-       /*----------------------------------------------------*/
+            case PSRP_PERSISTENT_HEAP:   (void)fprintf(psrp_out,"\npersistent heap detached (%s)\n",argv[i]);
+                                         break;
 
-       channel[sic_index].type     = SIC_FIFO;
-       channel[sic_index].remote   = FALSE;
-       channel[sic_index].scp      = scp; 
+            default:                     (void)fprintf(psrp_out,"\ndynamic object detached (%s)\n",argv[i]);
+                                         break;
+        }
+        (void)fflush(psrp_out);
     }
 
+    (void)fprintf(psrp_out,"\n");
+    (void)fflush(psrp_out);
 
-    /*---------------------------------------------*/
-    /* Start remote slaved instance of psrp client */
-    /*---------------------------------------------*/
-
-    #ifdef SSH_SUPPORT
-    else
-    {  char absolute_pathname[SSIZE] = "";
-
+    return(PSRP_OK);
+}
 
-       /*------------------------------------------------------*/
-       /* ssh needs an absolute pathname if we have a relative */
-       /* pathname -- make it absolute                         */
-       /*------------------------------------------------------*/
 
-       if(psrp_pathname[0] != '/')
-       {  char cwd[SSIZE] = "";
 
-          (void)getcwd(cwd,SSIZE);
+/*---------------------------------------------------*/
+/* Builtin function to display current PSRP bindings */
+/*---------------------------------------------------*/
 
+_PRIVATE int32_t psrp_builtin_show_hinfo(const uint32_t  argc, const char *argv[])
 
-          /*-----------------------------------*/
-          /* Pathname is of the form ./relpath */
-          /*-----------------------------------*/
+{   char machtype[SSIZE]  = "",
+         ostype[SSIZE]    = "",
+         hosttype[SSIZE]  = "";
 
-          if(psrp_pathname[0] == '.')
-             (void)snprintf(absolute_pathname,SSIZE,"%s/%s",cwd,&psrp_command[2]);
-          else
-             (void)snprintf(absolute_pathname,SSIZE,"%s/%s",cwd,psrp_command);
+    if(strcmp("hinfo",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-          (void)strlcpy(psrp_command,absolute_pathname,SSIZE);
-       }
 
-       ssh_sic_index = (int)sic_index;
+    /*---------------------------------------------*/
+    /* Set up command tail decoder for this object */
+    /*---------------------------------------------*/
 
-       #ifdef PSRPLIB_DEBUG
-       (void)fprintf(stderr,"REMOTE PSRP COMMAND: \"%s\"\n",psrp_command);
-       (void)fflush(stderr);
-       #endif /* PSRPLIB_DEBUG */
+    if(psrp_std_init(argc,argv) == FALSE)
+       return(PSRP_OK);
 
 
-       /*----------------------------------------------------*/
-       /* Child side of fork                                 */
-       /* Associate stdio (for slaved ssh) with PSRP channel */
-       /*----------------------------------------------------*/
+    /*------------------------------------------------------*/
+    /* Check that there is no junk left on the command line */
+    /*------------------------------------------------------*/
 
-       if((scp = pups_fork(FALSE,FALSE)) == 0)
-       {  char sshPortOpt[SSIZE] = "";
+    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
+       return(PSRP_OK);
 
-          if(ssh_portNo > 0)
-             (void)snprintf(sshPortOpt,SSIZE,"-p %d",ssh_portNo);
-          else
-             (void)snprintf(sshPortOpt,SSIZE,"-p 22");
 
-          (void)fclose(stdin);
-          stdin = fopen(sic_channel_in_name,  "r");
+    /*------------------------------------------*/
+    /* Show client current PSRP action bindings */
+    /*------------------------------------------*/
 
-          (void)fclose(stdout);
-          stdout = fopen(sic_channel_out_name,"w");
+    if(getenv("MACHTYPE") != (char *)NULL && getenv("OSTYPE") != (char *)NULL && getenv("HOSTTYPE") != (char *)NULL)
+    {  (void)strlcpy(machtype,getenv("MACHTYPE"),SSIZE);
+       (void)strlcpy(ostype,  getenv("OSTYPE"),SSIZE);
+       (void)strlcpy(hosttype,getenv("HOSTTYPE"),SSIZE);
 
-          (void)fclose(stderr);
-          stderr = fopen(sic_channel_out_name,"w");
+       (void)fprintf(psrp_out,"\nPSRP server \"%s\" running on %s.%s (%s)\n",appl_name,machtype,ostype,hosttype);
+       (void)fprintf(psrp_out,"using named pipes (FIFO) for PSRP channels\n\n");
+       (void)fflush(psrp_out);
+    }
+    else
+    {  (void)fprintf(psrp_out,"\nHost information is not available\n\n");
+       (void)fflush(psrp_out);
+    }
 
+    return(PSRP_OK);
+}
 
-          /*--------------------------------------*/
-          /* We are not using passwords. You will */
-          /* need to generate a public/private    */
-          /* keyset for this to work              */
-          /*--------------------------------------*/
 
 
-          /*-----------------------------------*/
-          /* Start remote slaved psrp instance */
-          /*-----------------------------------*/
 
-          if(ssh_compression == TRUE)
-             (void)execlp("ssh","ssh",sshPortOpt,"-oPasswordAuthentication=no","-C","-l",    ssh_remote_uname,host_name,psrp_command,(char *)NULL);
-          else
-             (void)execlp("ssh","ssh",sshPortOpt,"-oPasswordAuthentication=no","-l",         ssh_remote_uname,host_name,psrp_command,(char *)NULL);
+/*---------------------------------------------------*/
+/* Builtin function to display current PSRP bindings */
+/*---------------------------------------------------*/
+ 
+_PRIVATE int32_t psrp_builtin_show_psrp_state(const uint32_t argc, const char *argv[])
+ 
+{   if(strcmp("show",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR); 
 
 
-          /*---------------------------------------------------------*/
-          /* We should not get here -- if we do an error has occured */
-          /*---------------------------------------------------------*/
+    /*---------------------------------------------*/
+    /* Set up command tail decoder for this object */
+    /*---------------------------------------------*/
 
-          _exit(255);
-       }
+    if(psrp_std_init(argc,argv) == FALSE)
+       return(PSRP_OK);
 
 
-       /*---------------------*/
-       /* Parent side of fork */
-       /*---------------------*/
+    /*------------------------------------------------------*/ 
+    /* Check that there is no junk left on the command line */
+    /*------------------------------------------------------*/ 
 
-       else if(scp == (-1))
-       {  if(appl_verbose == TRUE)
-          {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) SIC channel [to host %s] (could not exec ssh)\n",
-                                                                                    date,appl_name,appl_pid,appl_host,appl_owner,host_name);
-             (void)fflush(stderr);
-          }
+    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
+       return(PSRP_OK);
 
-          psrp_clear_channel_slot(&channel[sic_index]);
 
-          pups_set_errno(ENOEXEC);
-          return((psrp_channel_type *)NULL);
-       }
- 
+    /*------------------------------------------*/
+    /* Show client current PSRP action bindings */ 
+    /*------------------------------------------*/
 
-       if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP servers (slaved) ssh using (ssh tunnel) SIC channel (%s)\n",
-                                                  date,appl_name,appl_pid,appl_host,appl_owner,sic_channel_in_name);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): now talking to PSRP server \"%s\"'s slaved ssh client\n\n",
-                                                      date,appl_name,appl_pid,appl_host,appl_owner,appl_name);
-          (void)fflush(stderr);
-       }
+    psrp_show_object_list();
 
+    return(PSRP_OK);
+}
 
-       if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): finished talking to PSRP server \"%s\"'s slaved ssh client (authentication successful)\n",
-                                                                                     date,appl_name,appl_pid,appl_host,appl_owner,appl_name);
-          (void)fflush(stderr);
-       }
 
 
-       /*----------------------------------------------------*/
-       /* Fill in remaining fields of SIC channel descriptor */
-       /*----------------------------------------------------*/
 
-       channel[sic_index].type   = SIC_SSH_TUNNEL;
-       channel[sic_index].remote = TRUE;
-       channel[sic_index].scp    = scp;
+/*---------------------------------------------------------------*/
+/* Show latency histograms (count, mean and percentiles in       */
+/* microseconds) for queue, dispatch and reply write time        */
+/*---------------------------------------------------------------*/
 
+_PRIVATE void psrp_show_latency(const char *name, const psrp_latency_type *entry)
 
-       /*-------------------*/   
-       /* Clear SIC channel */
-       /*-------------------*/   
+{   uint32_t   i;
 
-       (void)psrp_empty_fifo(fileno(channel[sic_index].in_stream));
-       (void)psrp_empty_fifo(fileno(channel[sic_index].out_stream));
+    const char *phase_name[PSRP_LATENCY_PHASES] = { "queue", "dispatch", "write" };
 
-       scp           = (-1);
-       ssh_sic_index = (-1);
-    } 
-    #else
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): remote SIC channels not supported (no ssh support)\n",
-                                                           date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
-       }
+    for(i=0; i<PSRP_LATENCY_PHASES; ++i)
+    {  const psrp_hist_type *hist = &entry->phase[i];
 
-       psrp_clear_channel_slot(&channel[index]);
+       if(hist->count == 0)
+          continue;
 
-       pups_set_errno(EINVAL);
-       return((psrp_channel_type *)NULL);
-    }       
-    #endif /* SSH_SUPPORT */
+       (void)fprintf(psrp_out,"    %-20s %-9s %8lu %10.1f %10lu %10lu %10lu %10lu\n",
+                                                                           name,
+                                                                  phase_name[i],
+                                                                    hist->count,
+                                            (double)hist->sum/(double)hist->count,
+                                               psrp_hist_percentile(hist,50.0),
+                                               psrp_hist_percentile(hist,90.0),
+                                               psrp_hist_percentile(hist,99.0),
+                                                                      hist->max);
+    }
+}
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       if(host_name == (char *)NULL)
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): local (duplex FIFO) SIC channel created (via slaved client %s)\n",
-                                                          date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
-       #ifdef SSH_SUPPORT
-       else
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): remote (ssh tunnel) SIC channel [to host %s] created (via slaved client %s)\n",
-                                                             date,appl_name,appl_pid,appl_host,appl_owner,host_name,eff_psrp_pen);
-       #endif /* SSH_SUPPORT */
 
-       (void)fflush(stderr);
-    }
 
 
-    /*---------------------------------------------------*/
-    /* Check that we have out PSRP server up and running */
-    /*---------------------------------------------------*/
+/*----------------------------------------------------------------*/
+/* Dump latency histograms (machine readable). One line per       */
+/* histogram: <kind> <name> <phase> <count> <sum> <min> <max>     */
+/* followed by <bucket low value>:<count> for non empty buckets   */
+/*----------------------------------------------------------------*/
 
-    (void)fgets(slaved_psrp_client_ok,SSIZE,channel[sic_index].out_stream);
+_PRIVATE void psrp_dump_latency(FILE *stream, const char *kind, const char *name, const psrp_latency_type *entry)
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"GOT \"%s\"\n",slaved_psrp_client_ok);
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+{   uint32_t   i,
+               j;
 
-    if(strncmp(slaved_psrp_client_ok,"PSRP",4) == 0)
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): slaved PSRP server \"%s\" has started\n",
-                                 date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
-          (void)fflush(stderr);
-       }
+    const char *phase_name[PSRP_LATENCY_PHASES] = { "queue", "dispatch", "write" };
 
+    for(i=0; i<PSRP_LATENCY_PHASES; ++i)
+    {  const psrp_hist_type *hist = &entry->phase[i];
 
-       #ifdef PSRPLIB_DEBUG
-       int32_t cnt = 0;
-       while(1)
-       {   (void)fputs("test\n",channel[sic_index].in_stream);
-           (void)fflush(channel[index].in_stream);
+       if(hist->count == 0)
+          continue;
 
-           (void)psrp_read_sic(&channel[sic_index],slaved_psrp_client_ok);
-           (void)pups_sleep(1);
+       (void)fprintf(stream,"%s %s %s %lu %lu %lu %lu",kind,name,phase_name[i],hist->count,hist->sum,hist->min,hist->max);
 
-           (void)fprintf(stderr,"GOT: %s (cnt: %d)\n**********\n\n",slaved_psrp_client_ok,cnt++);
-           (void)fflush(stderr);
+       for(j=0; j<PSRP_HIST_BUCKETS; ++j)
+       {  if(hist->bucket[j] > 0)
+             (void)fprintf(stream," %lu:%u",psrp_hist_bucket_value(j),hist->bucket[j]);
        }
-       #endif /* PSRPLIB_DEBUG */
 
-       pups_set_errno(OK);
-       return(&channel[sic_index]);
+       (void)fputc('\n',stream);
     }
+}
 
 
-    /*---------------------------------*/
-    /* Problem with slaved psrp server */
-    /*---------------------------------*/
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): slaved PSRP server \"%s\" has failed to start\n",
-                                      date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
-       (void)fflush(stderr);
-    }
 
-    psrp_clear_channel_slot(&channel[sic_index]);
-       
-    pups_set_errno(EINVAL);
-    return((psrp_channel_type *)NULL);
-}
+/*--------------------------------------------------------------*/
+/* Escape string for inclusion in JSON (quoted) string. Output  */
+/* is truncated (at a character boundary) if it is too long     */
+/*--------------------------------------------------------------*/
 
+_PRIVATE void psrp_json_escape(const char *in, char *out, const size_t size)
 
+{   size_t i,
+           j = 0;
 
+    char   next_char[8] = "";
 
-/*---------------------------------------------------------*/
-/* Send a request to slaved PSRP client and wait for reply */
-/*---------------------------------------------------------*/
+    for(i=0; in[i] != '\0'; ++i)
+    {  if(in[i] == '"' || in[i] == '\\')
+          (void)snprintf(next_char,8,"\\%c",in[i]);
+       else if((unsigned char)in[i] < 0x20)
+          (void)snprintf(next_char,8,"\\u%04x",(unsigned char)in[i]);
+       else
+       {  next_char[0] = in[i];
+          next_char[1] = '\0';
+       }
 
-_PUBLIC char *psrp_slaved_client_transaction(const _BOOLEAN          log_reply, // Log reply
-                                             const psrp_channel_type      *sic, // SIC channel
-                                             const char               *request) // Request to send
+       if(j + strlen(next_char) >= size)
+          break;
 
-{   int32_t  ret;
-    size_t   size           = 0;
+       (void)strlcpy(&out[j],next_char,size - j);
+       j += strlen(next_char);
+    }
 
-    _BOOLEAN looper;
+    out[j] = '\0';
+}
 
-    char     tmp_str[512]   = "",    
-             *reply         = (char *)NULL;;
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_slaved_client_transaction] attempt by non root thread to perform PUPS/P3 PSRP operation");
+/*--------------------------------------------------------------*/
+/* Export trace spans as Chrome trace (JSON) format. Each phase */
+/* of a request is a complete ("X") event, client slots are     */
+/* threads                                                      */
+/*--------------------------------------------------------------*/
 
-    if(sic == (const psrp_channel_type *)NULL || request == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((char *)NULL);
-    }
+_PRIVATE int32_t psrp_export_trace(const char *f_name)
 
+{   uint32_t   i,
+               j,
+               n_spans;
 
-    /*--------------*/
-    /* Send request */
-    /*--------------*/
+    uint64_t   first,
+               ts;
 
-    if((ret = psrp_write_sic(sic,request)) < 0)
-    {  if(ret == (-2) && appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"\n%s %s (%d@%s:%s): attempted SIC transaction with self\n\n",
-                                                date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
-       }
+    char       verb[6*PSRP_LATENCY_VERB_SIZE]   = "";
+    FILE       *stream                          = (FILE *)NULL;
+    _BOOLEAN   comma                            = FALSE;
+    const char *phase_name[PSRP_LATENCY_PHASES] = { "queue", "dispatch", "write" };
 
-       pups_set_errno(EINVAL);
-       return((char *)NULL);
+    if((stream = fopen(f_name,"w")) == (FILE *)NULL)
+    {  pups_set_errno(EACCES);
+       return(-1);
     }
 
+    (void)fprintf(stream,"{\"traceEvents\":[\n");
 
-    /*------------*/
-    /* Read reply */
-    /*------------*/
-
-    do {    (void)psrp_set_current_sic(sic); 
-            if((looper = psrp_read_sic(sic,tmp_str)) == PSRP_MORE)
-            {  
-               if(log_reply == TRUE)
-               {  size += strlen(tmp_str);
-                  reply = (char *)realloc((void *)reply,size);
-                  (void)strlcat(reply,tmp_str,SSIZE);
-               }
-            }
-
-            #ifdef PSRPLIB_DEBUG
-            (void)fprintf(stderr,"PSRPLIB TRANSACTION GOT: \"%s\"\n",tmp_str);
-            (void)fflush(stderr);
-            #endif /* PSRPLIB_DEBUG */
+    if(psrp_trace_spans > PSRP_TRACE_SPANS)
+    {  n_spans = PSRP_TRACE_SPANS;
+       first   = psrp_trace_spans - PSRP_TRACE_SPANS;
+    }
+    else
+    {  n_spans = (uint32_t)psrp_trace_spans;
+       first   = 0;
+    }
+
+    for(i=0; i<n_spans; ++i)
+    {  const psrp_trace_span_type *span = &psrp_trace[(first + i) % PSRP_TRACE_SPANS];
+
+       psrp_json_escape(span->verb,verb,6*PSRP_LATENCY_VERB_SIZE);
+
+       ts = span->start;
+       for(j=0; j<PSRP_LATENCY_PHASES; ++j)
+       {  if(span->duration[j] < 0)
+             continue;
+
+          (void)fprintf(stream,"%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%ld,\"pid\":%d,\"tid\":%d,\"args\":{\"seq\":%u}}",
+                                                                                                                 (comma == TRUE) ? ",\n" : "",
+                                                                                                                                        verb,
+                                                                                                                               phase_name[j],
+                                                                                                                                          ts,
+                                                                                                                           span->duration[j],
+                                                                                                                                    appl_pid,
+                                                                                                                                span->client,
+                                                                                                                                   span->seq);
+          ts    += span->duration[j];
+          comma  = TRUE;
+       }
+    }
 
-            (void)psrp_unset_current_sic();
-       } while(looper == PSRP_MORE);
+    (void)fprintf(stream,"\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"application\":\"%s\",\"host\":\"%s\"}}\n",appl_name,appl_host);
+    (void)fclose(stream);
 
     pups_set_errno(OK);
-    return(reply);
+    return(0);
 }
 
- 
 
 
-/*------------------------------------------------*/
-/* Routine to clear a SIC channel descriptor slot */
-/*------------------------------------------------*/
 
-_PRIVATE void psrp_clear_channel_slot(psrp_channel_type *channel)
+/*-----------------------------------------------------------------*/
+/* Builtin function to show (or dump) request latency histograms   */
+/* and to control (and export) request tracing                     */
+/*-----------------------------------------------------------------*/
 
-{   channel->in_stream   = channel->out_stream = (FILE *)NULL;
+_PRIVATE int32_t psrp_builtin_latency(const uint32_t argc, const char *argv[])
 
-    (void)strlcpy(channel->in_name,  "",SSIZE);
-    (void)strlcpy(channel->out_name, "",SSIZE);
-    (void)strlcpy(channel->host_name,"",SSIZE);
-    (void)strlcpy(channel->ssh_port, "",SSIZE);
-    (void)strlcpy(channel->pen,      "",SSIZE);
+{   uint32_t i;
+    FILE     *stream = (FILE *)NULL;
 
-    channel->index       = FREE;
-    channel->scp         = 0;
-    channel->type        = 0;
-    channel->remote      = FALSE;
-}
+    #ifdef PTHREAD_SUPPORT
+    sigset_t old_set;
+    #endif /* PTHREAD_SUPPORT */
 
+    if(strcmp("latency",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_lock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
 
-/*---------------------------------------*/
-/* Destroy slaved PSRP client connection */
-/*---------------------------------------*/
+    /*------------------------------------------*/
+    /* Show histograms (per verb and per client) */
+    /*------------------------------------------*/
 
-_PUBLIC psrp_channel_type *psrp_destroy_slaved_interaction_client(const psrp_channel_type        *channel,   // SIC to destroy
-                                                                  const _BOOLEAN           channel_client)   // Force slaved client termination
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n    Request latency (microseconds) for %s (%d@%s)\n\n",appl_name,appl_pid,appl_host);
+       (void)fprintf(psrp_out,"    %-20s %-9s %8s %10s %10s %10s %10s %10s\n","verb","phase","count","mean","p50","p90","p99","max");
+       (void)fprintf(psrp_out,"    %-20s %-9s %8s %10s %10s %10s %10s %10s\n","----","-----","-----","----","---","---","---","---");
 
-{   char reply[SSIZE] = "";
+       for(i=0; i<PSRP_LATENCY_VERBS; ++i)
+       {  if(psrp_latency_verb[i].verb[0] != '\0')
+             psrp_show_latency(psrp_latency_verb[i].verb,&psrp_latency_verb[i]);
+       }
 
+       if(psrp_latency_other.verb[0] != '\0')
+          psrp_show_latency(psrp_latency_other.verb,&psrp_latency_other);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+       (void)fprintf(psrp_out,"\n    %-20s %-9s %8s %10s %10s %10s %10s %10s\n","client","phase","count","mean","p50","p90","p99","max");
+       (void)fprintf(psrp_out,"    %-20s %-9s %8s %10s %10s %10s %10s %10s\n","------","-----","-----","----","---","---","---","---");
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_destroy_slaved_interaction_client] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       for(i=0; i<MAX_CLIENTS; ++i)
+       {  if(psrp_client_pid[i] != (-1))
+             psrp_show_latency(psrp_client_name[i],&psrp_latency_client[i]);
+       }
 
-    if(channel == (const psrp_channel_type *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((psrp_channel_type *)NULL);
+       if(psrp_trace != (psrp_trace_span_type *)NULL)
+          (void)fprintf(psrp_out,"\n    tracing on (%lu spans recorded)\n",psrp_trace_spans);
+
+       (void)fprintf(psrp_out,"\n");
     }
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
 
-       #ifdef SSH_SUPPORT
-       if(channel->remote == TRUE)
-       {  (void)fprintf(stderr,"%s %s (%d@%s:%s): remote (ssh tunnel) SIC [to PSRP client %s@%s] destroyed\n",
-                                 date,appl_name,appl_pid,appl_host,appl_owner,channel->pen,channel->host_name);
-       }
-       else
-       #endif /* SSH_SUPPORT */
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): local (duplex FIFO) SIC [to PSRP client %s] destroyed\n",
-                                                 date,appl_name,appl_pid,appl_host,appl_owner,channel->pen);
+    /*-------------------*/
+    /* Reset histograms */
+    /*-------------------*/
 
-       (void)fflush(stderr);
+    else if(argc == 2 && strcmp(argv[1],"reset") == 0)
+    {  (void)memset((void *)psrp_latency_verb,  0,sizeof(psrp_latency_verb));
+       (void)memset((void *)psrp_latency_client,0,sizeof(psrp_latency_client));
+       (void)memset((void *)&psrp_latency_other,0,sizeof(psrp_latency_type));
+       psrp_trace_spans = 0;
+
+       (void)fprintf(psrp_out,"\nrequest latency histograms reset\n\n");
     }
 
 
-    /*--------------------------------*/
-    /* Destroy the interaction client */ 
-    /*--------------------------------*/
-
-    if(channel_client == TRUE)
-       (void)psrp_write_sic(channel,"quit\n");
-
-    (void)pups_fclose(channel->in_stream); 
-    (void)pups_fclose(channel->out_stream); 
-    (void)unlink(channel->in_name); 
-    (void)unlink(channel->out_name); 
+    /*-------------------------------------------*/
+    /* Dump histograms to file (machine readable) */
+    /*-------------------------------------------*/
 
+    else if(argc == 3 && strcmp(argv[1],"dump") == 0)
+    {  if((stream = fopen(argv[2],"w")) == (FILE *)NULL)
+          (void)fprintf(psrp_out,"\ncannot open latency dump file \"%s\"\n\n",argv[2]);
+       else
+       {  (void)fprintf(stream,"# psrp latency %s %d %s (microseconds, bucket sub bits %d)\n",appl_name,appl_pid,appl_host,PSRP_HIST_SUB_BITS);
 
-    /*-------------------------------*/
-    /* Clear channel descriptor slot */
-    /*-------------------------------*/
+          for(i=0; i<PSRP_LATENCY_VERBS; ++i)
+          {  if(psrp_latency_verb[i].verb[0] != '\0')
+                psrp_dump_latency(stream,"verb",psrp_latency_verb[i].verb,&psrp_latency_verb[i]);
+          }
 
-    psrp_clear_channel_slot(channel);
+          if(psrp_latency_other.verb[0] != '\0')
+             psrp_dump_latency(stream,"verb",psrp_latency_other.verb,&psrp_latency_other);
 
+          for(i=0; i<MAX_CLIENTS; ++i)
+          {  if(psrp_client_pid[i] != (-1))
+             {  char client_name[SSIZE] = "";
 
-    /*-------------------------------------------------*/
-    /* If we have run a suid root SIC we might need to */
-    /* re-create /dev/tty                              */
-    /*-------------------------------------------------*/
+                (void)snprintf(client_name,SSIZE,"%s:%d",psrp_client_name[i],psrp_client_pid[i]);
+                psrp_dump_latency(stream,"client",client_name,&psrp_latency_client[i]);
+             }
+          }
 
-    if(access("/dev/tty",F_OK | R_OK | W_OK) == (-1))
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): /dev/tty lost - recreating (mktty)\n",
-                                           date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
+          (void)fclose(stream);
+          (void)fprintf(psrp_out,"\nrequest latency histograms dumped to \"%s\"\n\n",argv[2]);
        }
-
-       (void)pups_system("mktty",shell,PUPS_ERROR_EXIT,(int32_t *)NULL);
     }
 
-    pups_set_errno(OK);
-    return((psrp_channel_type *)NULL);
-}
-
-
 
+    /*---------------------------------*/
+    /* Switch request tracing on (off) */
+    /*---------------------------------*/
 
-/*------------------------------------------*/
-/* Assign stdio descriptors for PSRP server */
-/*------------------------------------------*/
-
-_PUBLIC int32_t psrp_assign_stdio(const FILE     *psrp_out,   // PSRP output channel
-                                  const  int32_t     *argc,   // Number of arguments
-                                  const char       *argv[],   // Argument vector
-                                  des_t            *in_des,   // Input descriptor
-                                  des_t           *out_des,   // Output descriptor
-                                  des_t           *err_des)   // Error/status logging descriptor
+    else if(argc == 3 && strcmp(argv[1],"trace") == 0 && strcmp(argv[2],"on") == 0)
+    {  if(psrp_trace == (psrp_trace_span_type *)NULL)
+       {  psrp_trace       = (psrp_trace_span_type *)calloc(PSRP_TRACE_SPANS,sizeof(psrp_trace_span_type));
+          psrp_trace_spans = 0;
+       }
 
-{    char in_name[SSIZE]  = "",
-          out_name[SSIZE] = "",
-          err_name[SSIZE] = ""; 
+       (void)fprintf(psrp_out,"\nrequest tracing on (%d span ring)\n\n",PSRP_TRACE_SPANS);
+    }
+    else if(argc == 3 && strcmp(argv[1],"trace") == 0 && strcmp(argv[2],"off") == 0)
+    {  if(psrp_trace != (psrp_trace_span_type *)NULL)
+       {  (void)free((void *)psrp_trace);
+          psrp_trace = (psrp_trace_span_type *)NULL;
+       }
 
+       (void)fprintf(psrp_out,"\nrequest tracing off\n\n");
+    }
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_assign_stdio] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    /*-------------------------------------------------*/
+    /* Export trace spans (as Chrome trace JSON) to file */
+    /*-------------------------------------------------*/
 
-    if(psrp_out == (const FILE *)   NULL    ||
-       argc     == (const int32_t *)NULL    ||
-       argv     == (const char **)  NULL    ||
-       in_des   == (const int32_t *)NULL    ||
-       out_des  == (const int32_t *)NULL    ||
-       err_des  == (const int32_t *)NULL     )
-    {  pups_set_errno(EINVAL);
-       return(PSRP_STDIO_ERROR);
+    else if(argc == 3 && strcmp(argv[1],"trace") == 0)
+    {  if(psrp_trace == (psrp_trace_span_type *)NULL)
+          (void)fprintf(psrp_out,"\nrequest tracing is not on\n\n");
+       else if(psrp_export_trace(argv[2]) == (-1))
+          (void)fprintf(psrp_out,"\ncannot open trace file \"%s\"\n\n",argv[2]);
+       else
+          (void)fprintf(psrp_out,"\n%lu trace spans exported to \"%s\" (Chrome trace format)\n\n",
+                         (psrp_trace_spans > PSRP_TRACE_SPANS) ? (uint64_t)PSRP_TRACE_SPANS : psrp_trace_spans,argv[2]);
     }
+    else
+       (void)fprintf(psrp_out,"usage: latency [reset | dump <file> | trace on | trace off | trace <file>]\n");
 
-    if((ptr = pups_locate(&init,"in",argc,(char **)argv,0)) != NOT_FOUND    ||
-       (ptr = pups_locate(&init,"i", argc,(char **)argv,0)) != NOT_FOUND     )
-    {  if(strccpy(in_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting input file name");
-          (void)fflush(psrp_out);
-
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
+    #ifdef PTHREAD_SUPPORT
+    psrp_latency_unlock(&old_set);
+    #endif /* PTHREAD_SUPPORT */
 
-       if((*in_des = open(in_name,2)) == (-1))
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (input) stream %s could not be opened\n");
-          (void)fflush(psrp_out);
+    (void)fflush(psrp_out);
+    return(PSRP_OK);
+}
 
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
-    }
-    else
-       *in_des = open("/dev/null",2);   
 
-    if((ptr = pups_locate(&init,"out",argc,(char **)argv,0)) != NOT_FOUND    ||
-       (ptr = pups_locate(&init,"o"  ,argc,(char **)argv,0)) != NOT_FOUND     )
-    {  if(strccpy(out_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting output file name");
-          (void)fflush(psrp_out);
 
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
+/*-------------------------------------------------------------------------------*/
+/* Builtin function to display current object binding types permitted on process */
+/*-------------------------------------------------------------------------------*/
 
-       if((*out_des = open(out_name,2)) == (-1))
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (output) stream %s could not be opened\n");
-          (void)fflush(psrp_out);
+_PRIVATE int32_t psrp_builtin_show_psrp_bind_type(const uint32_t argc, const char *argv[])
 
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
-    }
-    else
-       *out_des = open("/dev/null",2);   
+{   if(strcmp("bindtype",argv[0]) != 0) 
+       return(PSRP_DISPATCH_ERROR);  
 
-    if((ptr = pups_locate(&init,"err",argc,(char **)argv,0)) != NOT_FOUND    ||
-       (ptr = pups_locate(&init,"e"  ,argc,(char **)argv,0))  != NOT_FOUND    )
-    {  if(strccpy(err_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting error (log) file name");
-           (void)fflush(psrp_out);
 
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
- 
-       if((*err_des = open(err_name,2)) == (-1))
-       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (error) stream %s could not be opened\n");
-          (void)fflush(psrp_out);
+    /*---------------------------------------------*/
+    /* Set up command tail decoder for this object */
+    /*---------------------------------------------*/
 
-          pups_set_errno(EINVAL);
-          return(PSRP_STDIO_ERROR);
-       }
-    }
-    else
-       *err_des = open("/dev/null",2);   
+    if(psrp_std_init(argc,argv) == FALSE)
+       return(PSRP_OK);
 
-    pups_set_errno(OK); 
-    return(PSRP_STDIO_ASSIGNED);
-}
 
+    /*------------------------------------------------------*/ 
+    /* Check that there is no junk left on the command line */
+    /*------------------------------------------------------*/ 
 
+    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)    
+       return(PSRP_OK);
 
-/*--------------------------------------*/
-/* Assign stdio streams for PSRP server */
-/*--------------------------------------*/
 
-_PUBLIC int32_t psrp_assign_fstdio(const FILE    *psrp_out, // PSRP output channel
-                                   const int32_t     *argc, // Number of arguments
-                                   const char      *argv[], // Argument vector
-                                   FILE         *in_stream, // Input stream
-                                   FILE        *out_stream, // Output stream
-                                   FILE        *err_stream) // Error/logging stream
+    /*----------------------------------------------------------------*/
+    /* Tell client process the type of PSRP object bindings permitted */
+    /*----------------------------------------------------------------*/
 
-{    des_t in,
-           out,
-           err,
-           ret; 
+    (void)fprintf(psrp_out,"\n    PSRP server interface (protocol %5.2F) bind status\n\n",PSRP_PROTOCOL_VERSION);
+    (void)fflush(psrp_out);
 
+    if(psrp_bind_status & PSRP_STATUS_ONLY)
+       (void)fprintf(psrp_out,"    PSRP interface supports status reporting only\n");
+    else
+    {  if(psrp_bind_status & PSRP_STATIC_DATABAG)
+          (void)fprintf(psrp_out,"    Databags:  static binding enabled (cannot import databags)\n");
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+       if(psrp_bind_status & PSRP_DYNAMIC_DATABAG)
+          (void)fprintf(psrp_out,"    Databags:  dynamic binding enabled (can import databags)\n");
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_assign_fstdio] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       if(psrp_bind_status & PSRP_STATIC_FUNCTION)
+          (void)fprintf(psrp_out,"    Functions: static binding enabled (cannot import DLL functions)\n");
 
-    if(psrp_out    == (const FILE *)   NULL    ||
-       argc        == (const int32_t *)NULL    ||
-       argv        == (const char **)  NULL    ||
-       in_stream   == (const FILE *)   NULL    ||
-       out_stream  == (const FILE *)   NULL    ||
-       err_stream  == (const FILE *)   NULL     )
-    {  pups_set_errno(EINVAL);
-       return(PSRP_STDIO_ERROR);
-    }
+       if(psrp_bind_status & PSRP_PERSISTENT_HEAP)
+          (void)fprintf(psrp_out,"    Heaps: dynamic binding enabled (can import persistent heaps) [%d heap slots allocated]\n",appl_max_pheaps);
 
-    ret = psrp_assign_stdio(psrp_out,argc,argv,&in,&out,&err);
+       #ifdef DLL_SUPPORT
+       if(psrp_bind_status & PSRP_DYNAMIC_FUNCTION)
+          (void)fprintf(psrp_out,"    Functions: dynamic binding enabled (can import DLL functions) [%d orifices allocated]\n\n",appl_max_orifices);
+       #endif /* DLL_SUPPORT */
 
-    if(ret != PSRP_STDIO_ERROR)
-    {  in_stream  = fdopen(in,"r"),
-       out_stream = fdopen(out,"w"),
-       err_stream = fdopen(err,"w");
     }
 
-    return(ret);
+    if(psrp_bind_status & PSRP_HOMEOSTATIC_STREAMS)
+       (void)fprintf(psrp_out,"    Streams: PSRP channels are hoemostatic\n\n");
+    
+    (void)fflush(psrp_out);
+    return(PSRP_OK);
 }
 
 
 
 
+/*---------------------------------------------------*/
+/* Builtin function to terminate PSRP server process */
+/*---------------------------------------------------*/
 
-/*---------------------------------------*/
-/* Wait for data on nominated descriptor */
-/*---------------------------------------*/
-
-_PUBLIC int32_t psrp_wait_for_data(const des_t fdes)
+_PRIVATE int32_t psrp_builtin_terminate_process(const uint32_t argc, const char *argv[])
+ 
+{   sigset_t set;
 
-{   fd_set readfds,
-           excepfds;
+    if(strcmp("terminate",argv[0]) != 0 && strcmp("kill",argv[0]) != 0) 
+       return(PSRP_DISPATCH_ERROR); 
 
-    struct timeval timeout;
 
+    (void)sigfillset(&set);
+    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_wait_for_data] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    /*--------------------------------------*/
+    /* Client termination of server process */
+    /*--------------------------------------*/
 
-    if(fdes < 0 || fdes >= appl_max_files)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+    if (appl_verbose == TRUE)
+    {  (void)fprintf(stderr,"\n%s (%d@%s) terminated by PSRP client\n\n",appl_name,appl_pid,appl_host);
+       (void)fflush(stderr);
     }
 
-    timeout.tv_sec  = 0;
-    timeout.tv_usec = 100;
 
-    FD_ZERO(&readfds);
-    FD_ZERO(&excepfds);
-    FD_SET(fdes,&readfds);
-    FD_SET(fdes,&excepfds);
+    /*------------------------------------------------------------------------------------*/
+    /* Commit suicide explicitly to invoke handler - just in case we are a session leader */
+    /*------------------------------------------------------------------------------------*/
 
 
-    /*-----------------------------------------------------------*/
-    /* Wait for data to become available on nominated descriptor */
-    /*-----------------------------------------------------------*/
+    if (appl_pg_leader == TRUE)
+       (void)killpg(appl_pid,SIGTERM);
 
-    do {   while(select(1,&readfds,(fd_set *)NULL,(fd_set *)NULL,&timeout) < 0);
+    pups_exit(255);
+}
 
 
-           /*-------------------------*/
-           /* Invalid file descriptor */
-           /*-------------------------*/
- 
-           if(errno == EBADF)
-              return(-1);
 
-           timeout.tv_sec  = 0;
-           timeout.tv_usec = 100;
 
-           if(FD_ISSET(0,&readfds))
-           {  pups_set_errno(OK);
-              return(0);
-           }
+/*----------------------------------------------------------------*/
+/* Builtin function to add an alias the tag list of a PSRP object */
+/*----------------------------------------------------------------*/
+ 
+_PRIVATE int32_t psrp_builtin_alias(const uint32_t argc, const char *argv[])
+ 
+{   if(strcmp("alias",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+ 
+    if(argc != 3 || strcmp(argv[1],"-help") == 0 || strcmp(argv[1],"-usage") == 0)
+    {  psrp_error("usage: alias <PSRP object name> <alias to PSRP object name>");
+       return(PSRP_OK);
+    }
+ 
+    if(psrp_alias(argv[1],argv[2]) == PSRP_DISPATCH_ERROR)
+    {  if(psrp_alias(argv[2],argv[1]) == PSRP_DISPATCH_ERROR)
+       {  psrp_error("psrp_builtin_alias: problem with alias (builtin or not unique or not found)");
+          return(PSRP_OK);
+       }
 
-           FD_SET(0,&readfds);
-           FD_SET(1,&readfds);
-        } while(TRUE);
+       (void)fprintf(psrp_out,"\"%s\" is now an alias of \"%s\"\n",argv[1],argv[2]);
+       (void)fflush(psrp_out);
+    }   
 
-    pups_set_errno(OK);
-    return(0);
+    (void)fprintf(psrp_out,"\"%s\" is now an alias of \"%s\"\n",argv[2],argv[1]);
+    (void)fflush(psrp_out);
+ 
+    return(PSRP_OK);
 }
 
 
 
 
-/*---------------------------------------------*/
-/* Search PSRP handler list for the first slot */
-/*---------------------------------------------*/
-
-_PUBLIC int32_t psrp_get_tag_index(const uint32_t tag_index)
-
-{   uint32_t i;
+/*----------------------------------------------------------*/
+/* Builtin function to show clients attached to this server */
+/*----------------------------------------------------------*/
 
+_PRIVATE int32_t psrp_builtin_show_clients(const uint32_t argc, const char *argv[])
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+{   if(strcmp("clients",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_get_tag_index] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(argc > 1 || strcmp(r_argv[1],"usage") == 0)
+    {  (void)fprintf(psrp_out,"usage: clients [usage]\n");
+       (void)fflush(psrp_out);
 
-    if(tag_index > psrp_object_list_allocated)
-    {  pups_set_errno(EINVAL);
-       return(PSRP_DISPATCH_ERROR);
+       return(PSRP_OK);
     }
 
-    if(psrp_object_list[tag_index].aliases == psrp_object_list[tag_index].aliases_allocated)
-    {  psrp_object_list[tag_index].aliases_allocated += PSRP_ALLOCATION_QUANTUM;
-
-       if(psrp_object_list[tag_index].object_tag == (char **)NULL)
-         psrp_object_list[tag_index].object_tag = (char **)pups_calloc(psrp_object_list[tag_index].aliases_allocated,sizeof(char **));
-      else
-         psrp_object_list[tag_index].object_tag = (char **)pups_realloc((void *)psrp_object_list[tag_index].object_tag,
-                                                                        psrp_object_list[tag_index].aliases_allocated*sizeof(char **));
+    if(argc != 1)
+    {  psrp_error("usage: clients");
+       return(PSRP_OK);
+    }
 
+    (void)psrp_show_clients();
+    return(PSRP_OK);
+}
 
-       for(i=psrp_object_list[tag_index].aliases; i<psrp_object_list[tag_index].aliases_allocated; ++i)
-          psrp_object_list[tag_index].object_tag[i] = (char *)NULL;
 
-       ++psrp_object_list[tag_index].aliases; 
+ 
 
-       pups_set_errno(OK);
-       return(psrp_object_list[tag_index].aliases - 1);
+/*----------------------------------------------------------------*/
+/* Builtin function to add an alias the tag list of a PSRP object */
+/*----------------------------------------------------------------*/
+ 
+_PRIVATE int32_t psrp_builtin_unalias(const uint32_t argc, const char *argv[])
+ 
+{   int32_t ret;
+    char    basename[SSIZE] = "";
+ 
+    if(strcmp("unalias",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+ 
+    if(argc != 2 || strcmp(r_argv[1],"usage") == 0)
+    {  psrp_error("usage: unalias <PSRP object name alias>");
+       return(PSRP_OK);
     }
-
-    for(i=0; i<psrp_object_list[tag_index].aliases_allocated; ++i)
-    {  if(psrp_object_list[tag_index].object_tag[i] == (char *)NULL)
-       {  ++psrp_object_list[tag_index].aliases;
-
-          pups_set_errno(OK);
-          return(i);
+ 
+    if((ret = psrp_unalias(argv[1],basename)) == PSRP_TAG_ERROR)
+       psrp_error("psrp_builtin_alias: alias cannot be removed (or object would become untagged)");
+    else
+    {  if(ret == PSRP_DISPATCH_ERROR)
+       {  (void)fprintf(psrp_out,"psrp_builtin_alias: \"%s\" is not a tag name of any attached PSRP object\n",argv[1]);
+          (void)fflush(psrp_out);
+       }
+       else
+       {  (void)fprintf(psrp_out,"\"%s\" is no longer an alias of \"%s\"\n",argv[1],basename);
+          (void)fflush(psrp_out);
        }
     }
-
-    pups_set_errno(ESRCH);
+       
     return(PSRP_OK);
 }
-
-
  
  
-/*-----------------------------------------------*/
-/* Free resources allocated to PSRP handler slot */
-/*-----------------------------------------------*/
-
-_PUBLIC int32_t psrp_ifree_tag_list(const uint32_t tag_index)
-
-{   uint32_t i;
-
+ 
+ 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+/*----------------------------------------------*/
+/* Builtin function to show aliases of tag name */
+/*----------------------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_ifree_tag_list] attempt by non root thread to perform PUPS/P3 PSRP operation");
+_PRIVATE int32_t psrp_builtin_showaliases(const uint32_t argc, const char *argv[])
 
-    if(tag_index > psrp_object_list_allocated)
-    {  pups_set_errno(EINVAL);
+{   if(strcmp("showaliases",argv[0]) != 0)
        return(PSRP_DISPATCH_ERROR);
-    }
-
-    if(psrp_object_list[tag_index].object_handle != (void *)NULL    &&
-       psrp_object_list[tag_index].object_tag    != (void *)NULL     )
-    {   for(i=0; i<psrp_object_list[i].aliases_allocated; ++i)
-        {   if(psrp_object_list[tag_index].object_tag[i] != (char *)NULL)
-               (void)pups_free((void *)psrp_object_list[tag_index].object_tag[i]);
-        }
- 
-        psrp_object_list[tag_index].object_tag = (char **)NULL; 
-        pups_set_errno(OK);
 
-        return(0);
+    if(argc != 2)
+    {  psrp_error("usage: showaliases <of PSRP object tagname>");
+       return(PSRP_OK);
     }
 
-    pups_set_errno(ESRCH);
-    return(-1);
+    psrp_show_aliases(argv[1]);
+    return(PSRP_OK);
 }
 
 
 
 
+/*-------------------------------------------------------------------*/
+/* Create a new instance of the current process - the old process is */
+/* terminated and a new instance of it is created - this permits the */
+/* user to modify the PSRP dispatch tables associated with a process */
+/* without effecting the parent                                      */
+/*-------------------------------------------------------------------*/
 
-/*-----------------------------------*/
-/* Search PSRP handler list by index */
-/*-----------------------------------*/
+_PRIVATE int32_t psrp_builtin_new_instance(const uint32_t r_argc, const char *r_argv[])
 
-_PUBLIC int32_t psrp_isearch_tag_list(const char *object_tag, const uint32_t tag_index)
+{ 
+     int32_t ret;
 
-{   uint32_t i;
+    char n_i_name[SSIZE] = "",
+         n_i_host[SSIZE] = "notset"; 
 
+    if(strcmp("new",r_argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_isearch_tag_list] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    /*--------------*/
+    /* Sanity check */
+    /*--------------*/
 
-    if(object_tag == (const char *)NULL || tag_index > psrp_object_list_allocated)
-    {  pups_set_errno(EINVAL);
-       return(PSRP_DISPATCH_ERROR);
-    }
+    if(r_argc < 2 || r_argc > 4 || strcmp(r_argv[1],"-usage") == 0)
+    {  (void)fprintf(psrp_out,"usage: new [keep | segment (current instance)] [<new instance name>] [<exec host>]\n");
+       (void)fflush(psrp_out);
 
-    for(i=0; i<psrp_object_list[tag_index].aliases_allocated; ++i)
-    {  if(psrp_object_list[tag_index].object_tag[i] != (char *)NULL       &&
-          strcmp(psrp_object_list[tag_index].object_tag[i],object_tag) == 0)
-       {  pups_set_errno(OK);
-          return(i);
-       }
+       return(PSRP_OK);
     }
 
-    pups_set_errno(ESRCH);
-    return(PSRP_DISPATCH_ERROR);
-}
-
+    if(r_argc == 4 && strcmp(r_argv[1],"segment") == 0 && appl_rooted == TRUE)
+    {  char rooted[SSIZE]          = "",
+            lyosome_command[SSIZE] = "";
 
+       (void)fprintf(psrp_out,"\nPSRP server \"%s\" is rooted (system context cannot migrate to new host)\n\n",appl_name);
+       (void)fflush(psrp_out);
 
+       (void)snprintf(rooted,SSIZE,"%s/%d.rooted",appl_fifo_dir,appl_pid);
+       (void)pups_creat(rooted,0600);
 
-/*--------------------------------*/
-/* Create alias for a PSRP object */
-/*--------------------------------*/
+       /*-------------------------------------------------------------*/
+       /* Start lyosome process which destroys trail file after delay */
+       /* of 15 seconds - this should be long enough for clients to   */
+       /* attach to new instance                                      */
+       /*-------------------------------------------------------------*/
 
-_PUBLIC int32_t psrp_alias(const char *name, const char *alias)
+       (void)snprintf(lyosome_command,SSIZE,"lyosome -lifetime 15 %s&",rooted);
+       (void)system(lyosome_command);   
 
-{   uint32_t i;
-    int32_t  alias_index;
+       return(PSRP_OK);
+    }
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    /*-------------------------------------*/
+    /* Is the current instance to be kept? */
+    /*-------------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_alias] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(strcmp(r_argv[1],"segment") == 0)
+       terminate_current_instance = TRUE;
+    else if(strcmp(r_argv[1],"fork") == 0)
+       terminate_current_instance = FALSE;
+    else
+    {  (void)fprintf(psrp_out,"usage: new [fork | segment (current instance)] [<new instance name> | default] [<exec host>]\n");
+       (void)fflush(psrp_out);
 
-    if(name == (const char *)NULL || alias == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(PSRP_DISPATCH_ERROR);
+       return(PSRP_OK);
     }
 
-    /*-------------------------------------------*/
-    /* Search dispatch table for object to alias */
-    /*-------------------------------------------*/
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {  if(psrp_object_list[i].object_handle != NULL)
-       {
+    /*--------------------------------------*/
+    /* Get default name of the new instance */
+    /*--------------------------------------*/
 
-          /*----------------------------------------------------------------*/
-          /* Search for PSRP object tagged with target name (to be aliased) */ 
-          /*----------------------------------------------------------------*/
+    (void)strlcpy(n_i_name,appl_name,SSIZE);
+    (void)strlcpy(n_i_host,"notset",SSIZE);
 
-          if(psrp_isearch_tag_list(name,i) >= 0) 
-          {
 
-             /*---------------------------------*/
-             /* Check that this alias is unique */
-             /*---------------------------------*/
+    /*-----------------------------------------*/
+    /* New instance remote - if name is set to */
+    /* default it keeps the same name as the   */
+    /* current instance                        */
+    /*-----------------------------------------*/
 
-             if(psrp_isearch_tag_list(alias,i) >= 0)
-             {  pups_set_errno(ESRCH);
-                return(PSRP_DISPATCH_ERROR);
-             }
-             else
-             {  alias_index = psrp_get_tag_index(i);
+    if(r_argc == 4)
+    {  
 
-                if(psrp_object_list[i].object_tag[alias_index] == (char *)NULL)
-                   psrp_object_list[i].object_tag[alias_index] = (char *)pups_malloc(SSIZE);
-                (void)strlcpy(psrp_object_list[i].object_tag[alias_index],alias,SSIZE);
+       /*--------------------------*/
+       /* Get name of new instance */
+       /* (if not defaulted)       */
+       /*--------------------------*/
 
-                if(appl_verbose == TRUE)
-                {  (void)fprintf(stderr,"%s %s (%d@%s:%s): %s aliased to %s\n",
-                                                                          date,
-                                                                     appl_name,
-                                                                      appl_pid,
-                                                                     appl_host,
-                                                                    appl_owner,
-                                             psrp_object_list[i].object_tag[0],
-                                                                         alias);
-                   (void)fflush(stderr);
-                }
+       if(strcmp(r_argv[2],"default") == 0)
+          (void)strlcpy(n_i_name,appl_name,SSIZE);
+       else
+          (void)strlcpy(n_i_name,r_argv[2],SSIZE);
 
-                pups_set_errno(OK);
-                return(PSRP_OK);
-             }
-          }
-        }   
-     }
 
-     pups_set_errno(ESRCH);
-     return(PSRP_DISPATCH_ERROR);
-}
+       /*--------------------------------------------------------*/
+       /* We cannot have a duplicate instance with the same name */
+       /* as our current server                                  */
+       /*--------------------------------------------------------*/
 
+       if(terminate_current_instance  == FALSE    &&
+          strcmp(r_argv[2],appl_name)   == 0      &&
+          strcmp(r_argv[3],"localhost") == 0       )
+       {  (void)fprintf(psrp_out,"\ncannot have duplicate local instance with same name (%s)\n",appl_name);
+          (void)fflush(psrp_out);
+ 
+          return(PSRP_OK);
+       }
+       else
+       {
 
+          /*----------------------------------*/   
+          /* Get name of remote host (if any) */
+          /*----------------------------------*/   
 
+          (void)strlcpy(n_i_host,r_argv[3],SSIZE);
+       }
+
+       if(terminate_current_instance == TRUE)
+          (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\" as \"%s\" (on host %s)\n",
+                                                                               appl_name,n_i_name,n_i_host);
+       else
+          (void)fprintf(psrp_out,"\ncreating new instance of \"%s\" as \"%s\" (on host %s)\n",
+                                                                   appl_name,n_i_name,n_i_host);
+
+       (void)fprintf(psrp_out,"... waiting for %d seconds for remote instance to start\n\n",segmentation_delay);
+       (void)fflush(psrp_out);
+    }
 
-/*--------------------------*/
-/* Remove PSRP object alias */
-/*--------------------------*/
- 
-_PUBLIC int32_t psrp_unalias(const char *alias, const char *base_tag_name)
- 
-{   uint32_t i;
-     int32_t alias_index;
- 
 
     /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
+    /* New instance local with new name */
     /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_unalias] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    else if(r_argc == 3)
+    {  
 
-    if(base_tag_name == (const char *)NULL || alias == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(PSRP_DISPATCH_ERROR);
+       /*--------------------------------------------------------*/
+       /* We cannot have a duplicate instance with the same name */
+       /* as our current server                                  */
+       /*--------------------------------------------------------*/
+
+       if(terminate_current_instance  == FALSE    &&
+          strcmp(r_argv[2],appl_name) ==0          )
+       {  (void)fprintf(psrp_out,"\ncannot have duplicate local instance with same name (%s)\n",appl_name);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+       else
+          (void)strlcpy(n_i_name,r_argv[2],SSIZE);
+
+       if(terminate_current_instance == TRUE)
+          (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\" as \"%s\"\n\n",appl_name,n_i_name);
+       else
+          (void)fprintf(psrp_out,"\ncreating new instance of \"%s\" as \"%s\"\n",appl_name,n_i_name);
+       (void)fflush(psrp_out);
     }
 
 
-    /*---------------------------------------------*/
-    /* Search dispatch table for object to unalias */
-    /*---------------------------------------------*/
+    /*--------------------------------------*/
+    /* New local instance with default name */
+    /*--------------------------------------*/
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {   if(psrp_object_list[i].object_handle != NULL)
-        {  if((alias_index = psrp_isearch_tag_list(alias,i)) >= 0)
-           {
+    else
+    {   if(terminate_current_instance == TRUE)
+           (void)fprintf(psrp_out,"\ncreating new [segmented] instance of \"%s\"\n",appl_name);
+        else
+           (void)fprintf(psrp_out,"\ncreating new instance of \"%s\"\n",appl_name);
+        (void)fflush(psrp_out);
+    }
 
-              /*----------------------------------------------------------*/
-              /* Check that this is not the root alias (the real name) of */
-              /* this object. We cannot remove this as it is used to map  */
-              /* and unmap the object if it a DLL object                  */
-              /*----------------------------------------------------------*/
 
-              if(alias_index == 0)
-              {  pups_set_errno(EPERM);
-                 return(PSRP_TAG_ERROR);
-              }
+    /*--------------------*/
+    /* Start new instance */
+    /*--------------------*/
 
-              if(appl_verbose == TRUE) 
-              {  (void)fprintf(stderr,"%s %s (%d@%s:%s): %s unliased from %s\n",
-                                                                           date,
-                                                                      appl_name,
-                                                                       appl_pid,
-                                                                      appl_host,
-                                                                     appl_owner,
-                                                                          alias,
-                                              psrp_object_list[i].object_tag[0]);
+    if(strcmp(n_i_host,"notset") == 0)
+       ret = psrp_new_instance(terminate_current_instance,n_i_name,(char *)NULL);
+    else
+       ret = psrp_new_instance(terminate_current_instance,n_i_name,n_i_host);
 
-                 (void)fflush(stderr);
-              }
 
-              (void)pups_free((void *)psrp_object_list[i].object_tag[alias_index]);
-              psrp_object_list[i].object_tag[alias_index] = (char *)NULL;
+    if(ret < 0)
+    {  (void)fprintf(psrp_out,"failed to created new instance\n\n");
+       (void)fflush(psrp_out);
+    }   
 
-              (void)strlcpy(base_tag_name,psrp_object_list[i].object_tag[0],SSIZE);
-              --psrp_object_list[i].aliases;
+    /*------------------------------------------------------*/
+    /* Tell client this request is now processed and return */
+    /* its exit code                                        */
+    /*------------------------------------------------------*/
 
-              pups_set_errno(OK); 
-              return(PSRP_OK);
-           }
-        }
-    }
-      
-    pups_set_errno(ESRCH); 
-    return(PSRP_DISPATCH_ERROR);
+    (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
+    (void)fflush(psrp_out);
+
+
+    /*------------------------------------------------------*/
+    /* Tell client that we have finished processing SIGPSRP */
+    /*------------------------------------------------------*/
+
+    psrp_endop("psrp");
+    pups_sleep(1);
+
+    return(PSRP_OK);
 }
 
 
 
 
-/*-----------------------------*/
-/* Display PSRP object aliases */
-/*-----------------------------*/
- 
-_PUBLIC int32_t psrp_show_aliases(const char *basename)
- 
-{   uint32_t i,
-             j;
 
-    int32_t  alias_index;
- 
+/*---------------------------------*/
+/* Get state of PSRP object by tag */
+/*---------------------------------*/
+
+_PUBLIC int32_t psrp_ostate(const char *object_tag)
+
+{   int32_t i;
+
 
     /*----------------------------------*/
     /* Only the root thread can process */
@@ -9222,357 +10034,5131 @@ _PUBLIC int32_t psrp_show_aliases(const char *basename)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_show_aliases] attempt by non root thread to perform PUPS/P3 PSRP operation");
+      pups_error("[psrp_ostate] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(basename == (const char *)NULL)
+    if(object_tag == (const char *)NULL)
     {  pups_set_errno(EINVAL);
-       return(PSRP_DISPATCH_ERROR);
+       return(-1);
     }
 
-    for(i=0; i<psrp_object_list_allocated; ++i)
-    {  if(psrp_object_list[i].object_handle != (void *)NULL)
-       {  alias_index = psrp_isearch_tag_list(basename,i);
- 
-         if(alias_index >= 0)
-         {  (void)fprintf(psrp_out,"\n\n    Aliases list containing object tag \"%s\"\n\n",basename); 
-            for(j=0; j<psrp_object_list[i].aliases_allocated; ++j)
-               if(psrp_object_list[i].object_tag[j] != (char *)NULL)
-               {  if(j == 0)
-                     (void)fprintf(psrp_out,"%04d:    \"%-32s\" (root tag of PSRP object at %016lx virtual)\n",j,
-                                                                               psrp_object_list[i].object_tag[j],
-                                                            (uint64_t         )psrp_object_list[i].object_handle);
-                  else
-                     (void)fprintf(psrp_out,"%04d:    \"%-32s\"\n",j,psrp_object_list[i].object_tag[j]);
-               }
-                 
-            (void)fprintf(psrp_out,"\n\n");
-            (void)fflush(psrp_out);
- 
-            pups_set_errno(OK);
-            return(PSRP_OK);
-         }
-       }
+    if((i = psrp_tag_index_lookup(object_tag)) != (-1))
+    {  pups_set_errno(OK);
+       return(psrp_object_list[i].object_state);
     }
- 
-    (void)fprintf(psrp_out,"psrp_show_aliases: \"%s\" is not a tag name of any loaded PSRP object\n",basename);       
-    (void)fflush(psrp_out);
 
-    pups_set_errno(ESRCH); 
+    pups_set_errno(ESRCH);
     return(PSRP_DISPATCH_ERROR);
 }
 
 
 
 
-/*-------------------------------------------------*/
-/* Check if named PSRP channel is locked by client */
-/*-------------------------------------------------*/
+/*-----------------------------------------------------------*/
+/* Builtin help function (displays server builtin functions) */
+/*-----------------------------------------------------------*/
+ 
+_PRIVATE int32_t psrp_builtin_help(const uint32_t argc, const char *argv[])
+ 
+{   if(strcmp("shelp",argv[0]) != 0) 
+       return(PSRP_DISPATCH_ERROR); 
 
-_PUBLIC _BOOLEAN psrp_channel_locked(const FILE *stream, const char *channel_name)
 
-{   struct stat buf;
+    /*---------------------------------------------*/
+    /* Set up command tail decoder for this object */
+    /*---------------------------------------------*/
 
+    if(psrp_std_init(argc,argv) == FALSE)
+       return(PSRP_OK);
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_channel_locked] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    /*------------------------------------------------------*/ 
+    /* Check that there is no junk left on the command line */
+    /*------------------------------------------------------*/ 
 
-    if(channel_name == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+    if(psrp_t_arg_errs(argc,argd,argv) == FALSE)
+       return(PSRP_OK);
+
+
+    /*-------------------------------------------*/  
+    /* Display on line help for builtin commands */
+    /*-------------------------------------------*/  
+
+    (void)fprintf(psrp_out,"\n\n    PSRP request handler version 2.17 (protocol %5.2F)\n",PSRP_PROTOCOL_VERSION);
+    (void)fprintf(psrp_out,"    (C) M.A. O'Neill, Tumbling Dice, 1995-2024\n\n");
+    (void)fprintf(psrp_out,"    Builtin commands\n");
+    (void)fprintf(psrp_out,"    ================\n\n");
+    (void)fflush(psrp_out);
+
+    (void)fprintf(psrp_out,"    General P3 server control/status commands\n");
+    (void)fprintf(psrp_out,"    =========================================\n\n");
+    (void)fprintf(psrp_out,"    log            [on | off]        :   switch server transaction logging on or off\n");
+    (void)fprintf(psrp_out,"    verbose        [on | off]        :   switch server error logging on or off\n");
+    (void)fprintf(psrp_out,"    errorhandling  [on | off]        :   toggle error handling on or off\n\n");
+    (void)fprintf(psrp_out,"    hinfo                            :   display host information\n");
+    (void)fprintf(psrp_out,"    show                             :   display PSRP handler status\n");
+    (void)fprintf(psrp_out,"    latency        [reset]           :   display (or reset) request latency histograms\n");
+    (void)fprintf(psrp_out,"    latency        dump <f>          :   dump request latency histograms to <f> (machine readable)\n");
+    (void)fprintf(psrp_out,"    latency        trace [on | off]  :   switch request tracing on or off\n");
+    (void)fprintf(psrp_out,"    latency        trace <f>         :   export request trace to <f> (Chrome trace format)\n");
+    (void)fprintf(psrp_out,"    clients                          :   display clients connected to this server\n");
+    (void)fprintf(psrp_out,"    bindtype                         :   display current object binding (static or dynamic)\n");
+    (void)fprintf(psrp_out,"    help                             :   display on line help information\n");
+    (void)fprintf(psrp_out,"    strys                            :   set number of time PSRP server retrys operation (before aborting)\n");
+    (void)fprintf(psrp_out,"    nodetach       [on | off]        :   toggle stdio (when in background) on or off\n");    
+    (void)fprintf(psrp_out,"    cwd            <path>            :   set PSRP servers current working directory\n");
+    (void)fprintf(psrp_out,"    rusage                           :   show current resource usage status\n"); 
+    (void)fprintf(psrp_out,"    rset                             :   set resource usage limits\n"); 
+    (void)fprintf(psrp_out,"    pstat                            :   display /proc filesystem status entry\n");
+    (void)fprintf(psrp_out,"    terminate | kill                 :   terminate (this) PSRP server process\n\n\n");
+
+    (void)fprintf(psrp_out,"    P3 server virtual timer control/status functions\n");
+    (void)fprintf(psrp_out,"    ================================================\n\n");
+    (void)fprintf(psrp_out,"    quantum        [<time> | default]:   set PSRP (vitimer) quantum\n");
+    (void)fprintf(psrp_out,"    vitstat                          :   display status of PUPS virtual interval timers\n\n");
+    (void)fprintf(psrp_out,"    vitab          [<n> | shrink]    :   display [or set to <n> or Procrustes shrink] number of virtal timer table slots\n\n\n");
+
+    (void)fprintf(psrp_out,"    P3 server child control/status functions\n");
+    (void)fprintf(psrp_out,"    =========================================\n\n");
+    (void)fprintf(psrp_out,"    cstat                            :   display active children`\n");
+    (void)fprintf(psrp_out,"    htab          [<n> | shrink]     :   display [or set to <n> or Procrustes shrink] number of child table slots\n\n\n");
+
+    (void)fprintf(psrp_out,"    P3 server command alias control/status functions\n");
+    (void)fprintf(psrp_out,"    ================================================\n\n");
+    (void)fprintf(psrp_out,"    showaliases    <n>               :   show aliases of PSRP object <n>                  \n");
+    (void)fprintf(psrp_out,"    alias          <n> <a>           :   alias <n> to <a>\n");
+    (void)fprintf(psrp_out,"    unalias        <a>               :   remove alias <a>\n\n\n");
+
+    (void)fprintf(psrp_out,"    P3 server entry/exit routine control/status functions\n");
+    (void)fprintf(psrp_out,"    =====================================================\n\n");
+    (void)fprintf(psrp_out,"    atentrance                       :   display list of (PUPS) application entrance functions\n");
+    (void)fprintf(psrp_out,"    atexit                           :   display list of (PUPS) application exit functions\n");
+    (void)fprintf(psrp_out,"    atabort                          :   display list of (PUPS) application abort functions\n\n\n");
+    (void)fflush(psrp_out);
+
+    #ifdef SSH_SUPPORT
+    (void)fprintf(psrp_out,"    P3 server ssh control functions\n");
+    (void)fprintf(psrp_out,"    ===============================\n\n");
+    (void)fprintf(psrp_out,"    compress                         :   toggle ssh compression mode\n");
+    (void)fprintf(psrp_out,"    port           <port number>     :   set remote ssh port\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* SSH_SUPPORT */
+
+
+    #ifdef MAIL_SUPPORT
+    (void)fprintf(psrp_out,"    P3 server mail control/status functions\n");
+    (void)fprintf(psrp_out,"    =======================================\n\n");
+    (void)fprintf(psrp_out,"    mtype          <mime part type>  :   set part type (for parts of MIME messages to be saved)\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* MAIL_SUPPORT */
+
+
+    #ifdef PSRP_AUTHENTICATE
+    (void)fprintf(psrp_out,"    P3 server security control/status functions\n");
+    (void)fprintf(psrp_out,"    ===========================================\n\n");
+    (void)fprintf(psrp_out,"    secure         <token>           :   set (secure) server authentication token\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* PSRP_AUTHENTICATE */
+
+
+    #ifdef CRIU_SUPPORT
+    (void)fprintf(psrp_out,"    P3 server (Criu) state save control/status functions\n");
+    (void)fprintf(psrp_out,"    ====================================================\n\n");
+    (void)fprintf(psrp_out,"    ssave                       |    :   Report state saving status\n");
+    (void)fprintf(psrp_out,"             [sspoll <seconds>]      :   Save state every <poll time> seconds (default 60 seconds)\n");
+    (void)fprintf(psrp_out,"                [enable       ] |    :   Enable state saving\n");
+    (void)fprintf(psrp_out,"                [disable      ] |    :   Disable state saving\n");
+    (void)fprintf(psrp_out,"                [cd <criu dir>]      :   Set Criu directory (default /tmp)\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* CRIU_SUPPORT */
+
+
+    (void)fprintf(psrp_out,"    P3 sofware watchdog functions\n");
+    (void)fprintf(psrp_out,"    =============================\n\n");
+    (void)fprintf(psrp_out,"    softdog                          :   Report software watchdog status\n");
+    (void)fprintf(psrp_out,"                [timeout  <secs>]    :   Save state every <poll time> seconds (default 60 seconds)\n");
+    (void)fprintf(psrp_out,"                [enable       ] |    :   Enable software watchdog\n");
+    (void)fprintf(psrp_out,"                [disable      ]      :   Disable software watchdog\n\n\n");
+
+
+    #ifdef BUBBLE_MEMORY_SUPPORT
+    (void)fprintf(psrp_out,"    P3 server bubble memory control/status functions\n");
+    (void)fprintf(psrp_out,"    ================================================\n\n");
+    (void)fprintf(psrp_out,"    mstat                            :   show memory allocation statistics\n");
+    (void)fprintf(psrp_out,"    mset           <threshold>       :   set memory bubble utilisation threshold %% (-usage for more detailed help)\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* BUBBLE_MEMORY_SUPPPORT */
+
+    (void)fprintf(psrp_out,"    P3 server (attached) file control/status functions\n");
+    (void)fprintf(psrp_out,"    ==================================================\n\n");
+    (void)fprintf(psrp_out,"    lflstat                          :   show concurrently held link file locks\n");
+    (void)fprintf(psrp_out,"    flstat                           :   show currently held flockfile locks\n");
+    (void)fprintf(psrp_out,"    fstat                            :   display open file descriptors\n");
+    (void)fprintf(psrp_out,"    ftab           [<n> | shrink]    :   display [or set to <n> or Procrustes shrink] number of file table slots\n\n\n");
+    (void)fflush(psrp_out);
+
+    (void)fprintf(psrp_out,"    P3 server (attached) signal control/status functions\n");
+    (void)fprintf(psrp_out,"    ====================================================\n\n");
+    (void)fprintf(psrp_out,"    sigstat                          :   display non default signal handlers\n");
+    (void)fprintf(psrp_out,"    sigstat        <sig list>        :   display detailed data for selected signal handlers\n");
+    (void)fprintf(psrp_out,"    maskstat                         :   display signal mask and pending signals\n\n\n");
+    (void)fflush(psrp_out);
+
+    (void)fprintf(psrp_out,"    P3 server (attached) fast cache status\n");
+    (void)fprintf(psrp_out,"    ======================================\n\n");
+    (void)fprintf(psrp_out,"    cachestat                        :   display (fast) caches mapped  int32_to process address space\n\n\n");
+    (void)fflush(psrp_out);
+
+    (void)fprintf(psrp_out,"    P3 server process cron scheduler control/status functions\n");
+    (void)fprintf(psrp_out,"    =========================================================\n\n");
+    (void)fprintf(psrp_out,"    schedule       <f> <t> [<func>]  :   schedule function <func> between times <f> and <t> using cron homeostat\n");
+    (void)fprintf(psrp_out,"                                     :   if <func> is omitted mark times <f> to <t> as inactive\n");
+    (void)fprintf(psrp_out,"    schedule cron  <expr> <func>     :   schedule function <func> at times matching cron expression <expr>\n");
+    (void)fprintf(psrp_out,"    schedule jitter <index> <secs>   :   delay start of crontab slot by up to <secs> seconds (at random)\n");
+    (void)fprintf(psrp_out,"    unschedule    <index>            :   unschedule a previously scheduled crontab slot\n");
+    (void)fprintf(psrp_out,"    crontstat                        :   display crontab\n\n\n");
+    (void)fflush(psrp_out);
+   
+    (void)fprintf(psrp_out,"    P3 server process general hoeostatis control/status functions\n");
+    (void)fprintf(psrp_out,"    =============================================================\n\n");
+    (void)fprintf(psrp_out,"    sicstat                          :   display open slaved interaction client channels\n");
+    (void)fprintf(psrp_out,"    rooted                           :   set process to rooted mode (system context cannot migrate)\n");
+    (void)fprintf(psrp_out,"    unrooted                         :   set process to unrooted mode (system context can migrate)\n");
+    (void)fprintf(psrp_out,"    parent         <name | PID>      :   set name/PID of effective parent process\n");
+    (void)fprintf(psrp_out,"    pexit                            :   process  exits if effective parent terminated\n");
+    (void)fprintf(psrp_out,"    unpexit                          :   process does not exit if effective parent terminated\n");
+    (void)fprintf(psrp_out,"    live           <f1> <f2> ...     :   protects list of (open) files against damage or deletion\n");
+    (void)fprintf(psrp_out,"    dead           <f1> <f2> ...     :   unprotects list of (open) files\n");
+    (void)fprintf(psrp_out,"    new            <f|>s> <n> <h>    :   create new instance <n> of server, n=instance, f=fork, s=segment, h=hostname\n");
+    (void)fprintf(psrp_out,"    overlay        <command>         :   Overlay server process with <command> (server resumes when command exits)\n");
+    (void)fprintf(psrp_out,"    overfork       <command>         :   Overfork server process with <command>\n");
+    (void)fprintf(psrp_out,"    autosave       [on | off]        :   switch automatic saving of dipatch table (at exit) on or off\n");
+    (void)fprintf(psrp_out,"    autosave                         :   display status of automatic dispatch table saving (at exit)\n");
+    (void)fprintf(psrp_out,"    save           <n>               :   save dispatch table (to PSRP ressource file <n>)\n");
+    (void)fprintf(psrp_out,"    load           <n>               :   load PSRP resource file <n> (appending objects to current dispatch table)\n");
+    (void)fprintf(psrp_out,"    reset                            :   reset dispatch table (returning it to its default state)\n");
+
+    if (psrp_bind_status & PSRP_DYNAMIC_DATABAG)
+       (void)fprintf(psrp_out,"    bag       <n> <f>   [LIVE|DEAD]  :   bind dynamic databag in <f> to PSRP handler <n>\n");
+    (void)fprintf(psrp_out,"\n\n");
+    (void)fflush(psrp_out);
+    
+
+    #ifdef DLL_SUPPORT 
+    (void)fprintf(psrp_out,"    P3 server process DLL (dynamically linked object) control/status functions\n");
+    (void)fprintf(psrp_out,"    ==========================================================================\n\n");
+
+    if (psrp_bind_status & PSRP_DYNAMIC_FUNCTION)
+    {  (void)fprintf(psrp_out,"    dll         <name> <object DLL>  :   bind dynamic function in <object DLL> to PSRP handler with <name>\n");
+       (void)fprintf(psrp_out,"    ostat                            :   display orifices which are bound to application\n");
+       (void)fprintf(psrp_out,"    ortab       [<n>]                :   display [or set to <n>] number of orifice [DLL] table slots\n\n\n");
     }
-  
-    if(stat(channel_name,&buf) == (-1))
-    {  pups_set_errno(ENFILE);
-       return(-1);
+
+    if (psrp_bind_status & PSRP_DYNAMIC_FUNCTION || psrp_bind_status & PSRP_DYNAMIC_DATABAG || psrp_bind_status & PSRP_PERSISTENT_HEAP)
+    {  (void)fprintf(psrp_out,"    detach      <item-list>          :   detach PSRP objects function in <item-list>\n");
+       (void)fprintf(psrp_out,"                                     :   if item list contains \"all\" reset dispatch table\n");
     }
 
-    pups_set_errno(OK);
+    (void)fprintf(psrp_out,"    dllstat     <name>               :   show orifices exported by DLL <name>\n\n\n");
+    (void)fflush(psrp_out);
+    #endif /* DLL_SUPPORT */
 
-    if(buf.st_nlink > 1)
-       return(TRUE);
 
-    return(FALSE);
+    #ifdef PTHREAD_SUPPORT
+    (void)fprintf(psrp_out,"    P3 server process thread control/status functions\n");
+    (void)fprintf(psrp_out,"    =================================================\n\n");
+    (void)fprintf(psrp_out,"    tstat          [<nid>]           :   show running threads, or optionally info for thread <nid>\n");
+    (void)fprintf(psrp_out,"    tstart         [<n> [ <a>]       :   run (static or dynamic payload function) [name <a>] on thread <n>\n");
+    (void)fprintf(psrp_out,"    tpause         [<n> | <all>]     :   pause thread <n> or all threads if <all> specifed\n");
+    (void)fprintf(psrp_out,"    tcont          [<n> | <all>]     :   restart thread <n> or all threads if <all> specifed\n");
+    (void)fprintf(psrp_out,"    tkill          [<n> | <all>]     :   kill thread <n> or all threads if <all> specifed\n\n\n");
+    #endif /* PTHREAD_SUPPORT */
+ 
+    (void)fprintf(psrp_out,"    P3 server process heap control/status functions\n");
+    (void)fprintf(psrp_out,"    ===============================================\n\n");
+    (void)fflush(psrp_out);
+
+
+    #ifdef PERSISTENT_HEAP_SUPPORT
+    if(psrp_bind_status & PSRP_PERSISTENT_HEAP)
+    {  (void)fprintf(psrp_out,"    heap     <n> <f>  [LIVE|DEAD      :   map persistent heap in <f> to PSRP handler <n>\n");
+       (void)fprintf(psrp_out,"    hstat    [<h | id> [<o | id>]     :   display pesistent heap details\n");
+       (void)fprintf(psrp_out,"    htab     [<n> | shrink]           :   display [or set to <n>] or Procrustes shrink number of persistent heap table slots\n");
+    }
+    #endif /* PERSISTENT_HEAP_SUPPORT */
+
+    (void)fprintf(psrp_out,"    hostat      <o1> <o2> ... <on>i  :   Show statistics for tracked heap object <tracked object>\n");
+    (void)fprintf(psrp_out,"    hostat                           :   Show statistics for all tracked heap objects\n\n\n");
+    (void)fflush(psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
+#ifdef DLL_SUPPORT
+/*---------------------------------------------------*/
+/* Show orifices which are bound to this application */
+/*---------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_attached_orifices(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("ostat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc != 1)
+    {  (void)fprintf(psrp_out,"Usage: ostat\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+    (void)pups_show_orifices(psrp_out);
+    return(PSRP_OK);
+}
+#endif /* DLL_SUPPORT */
+
+
+
+
+#ifdef PTHREAD_SUPPORT 
+/*-------------------------------------------------------*/
+/* Show threads of execution running in this application */
+/*-------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_threads(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("tstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc > 2 || (argc == 1 && strcmp(argv[0],"-usage") == 0))
+    {  (void)fprintf(psrp_out,"Usage: tstat [<nid>]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+    else if(argc == 2)
+    {  int32_t nid;
+
+
+       /*--------------------------------*/
+       /* Check that we have a valid nid */
+       /*--------------------------------*/
+
+       if(sscanf(argv[1],"%d",&nid) != 1 || nid < 0)
+       {  (void)fprintf(psrp_out,"expecting  integer value (>= 0) for (thread) nid\n");
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+
+       /*--------------------------------------*/
+       /* Show ttab entry for specified thread */
+       /*--------------------------------------*/
+
+       if(pupsthread_show_threadinfo(psrp_out,nid) < 0)
+       {  (void)fprintf(psrp_out,"specfied thread (nid %d) does not exist\n",nid);
+          (void)fflush(psrp_out);
+       
+          return(PSRP_OK);
+       }
+    }
+    else
+       (void)pupsthread_show_ttab(psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Start a new thread of execution (using dispatch table object) */
+/*---------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_launch_thread(const uint32_t argc, const char *argv[])
+
+{   uint32_t i;
+    int32_t  d_index;
+
+    char tname[SSIZE] = "";
+
+    void *tfunc = (void *)NULL,
+         *targs = (void *)NULL;
+
+    pthread_t tid;
+
+    if(strcmp("tstart",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc == 1 || argc == 2 && (strcmp(argv[1],"-usage") == 0))
+    {  (void)fprintf(psrp_out,"Usage: tstart [-usage] | [<thread name> <payload name> [<argument string>]]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*-------------------------------------------------------------------*/
+    /* Check that payload is in dispatch table and that it is executable */
+    /*-------------------------------------------------------------------*/
+
+    if((d_index = lookup_psrp_object_by_name(argv[2])) == (-1))
+    {  (void)fprintf(psrp_out,"Payload function \"%s\" is not in disptach table\n",argv[2]);
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*--------------------------------------------------------*/
+    /* Check object type - if its not PSRP_STATIC_FUNCTION or */
+    /* PSRP_DYNAMIC_FUNCTION we can't execute it!             */
+    /*--------------------------------------------------------*/
+
+    if(psrp_object_list[d_index].object_type != PSRP_STATIC_FUNCTION    &&
+       psrp_object_list[d_index].object_type != PSRP_DYNAMIC_FUNCTION    )  
+    {  (void)fprintf(psrp_out,"Payload function \"%s\" is not a static or dynamic executable\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*-----------------------------------------*/
+    /* Build argument list for thread launcher */
+    /* and get name of thread                  */
+    /*-----------------------------------------*/
+
+    tfunc = (void *)psrp_object_list[d_index].object_handle;
+    (void)strlcpy(tname,argv[1],SSIZE);
+
+
+    /*------------------------------------------*/
+    /* We have some arguments - typically these */
+    /* will be passed as a string which will be */
+    /* parsed by the thread payload function    */
+    /*------------------------------------------*/
+
+    if(argc == 4)
+       targs = argv[3];
+                                                             /*----------------------------------------------*/
+    if((tid = pupsthread_create(tname,                       /* Name of payload function to be run by thread */
+                                tfunc,                       /* Payload function to be run by thread         */
+                                targs)) != (pthread_t)NULL)  /* Payload arguments                            */
+                                                             /*----------------------------------------------*/
+    {   int32_t tpid,
+                t_index;
+
+       t_index = pupsthread_tid2nid(tid);
+       tpid    = pupsthread_nid2tpid(t_index);
+       (void)fprintf(psrp_out,"Thread %d (LWP: %d, payload function: \"%-32s\") launched (at %016lx virtual)\n",
+                                                                               t_index,tpid,tname,(uint64_t)tid);
+       (void)fflush(psrp_out);
+    }
+    else
+    {  (void)fprintf(psrp_out,"Failed to start thread\n");
+       (void)fflush(psrp_out);
+    }
+   
+    return(PSRP_OK);
+}
+
+
+
+
+/*--------------------------------------------*/
+/* Pause thread executing in this application */
+/*--------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_pause_thread(const uint32_t argc, const char *argv[])
+
+{   pthread_t tid;
+
+    if(strcmp("tpause",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
+    {  (void)fprintf(psrp_out,"Usage: tpause [-usage] | [<thread name> | [all]]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*------------------------*/
+    /* Pause specified thread */
+    /*------------------------*/
+
+    if(strcmp(argv[1],"all") != 0)
+    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
+       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       if(pupsthread_pause(tid) == (-1))
+       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to stop\n",(uint64_t)tid,argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") paused\n",(uint64_t)tid,argv[1]);
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*-------------------*/
+    /* Pause all threads */
+    /*-------------------*/
+
+    else
+    {   int32_t i,
+                t_cnt = 0;
+
+       char     tmpname[SSIZE] = "";
+
+       (void)pthread_mutex_lock(&ttab_mutex);
+
+
+       /*---------------------------------------------------*/
+       /* Pause all active threads (other than root thread) */
+       /*---------------------------------------------------*/
+
+       for(i=0; i<MAX_THREADS; ++i)
+       {  if(ttab[i].tid != (pthread_t *)NULL)
+          {  tid = ttab[i].tid;
+             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
+             if(pupsthread_pause(tid) == (-1))
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to stop\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+             }
+             else
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") stopped\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+
+                ++t_cnt;
+             }
+          }
+       }
+
+       (void)pthread_mutex_unlock(&ttab_mutex);
+
+
+       if(t_cnt == 0)
+          (void)fprintf(psrp_out,"\nno threads stopped\n");
+       else
+          (void)fprintf(psrp_out,"\n%d threads stopped\n",t_cnt);
+       (void)fflush(psrp_out);
+    }
+
+    return(PSRP_OK);
+}
+
+
+
+
+/*----------------------------------------------*/
+/* Restart thread executing in this application */
+/*----------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_restart_thread(const uint32_t argc, const char *argv[])
+
+{   pthread_t tid;
+
+    if(strcmp("tcont",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
+    {  (void)fprintf(psrp_out,"Usage: tcont [-usage] | [<thread name> | [all]]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*--------------------------*/
+    /* Restart specified thread */
+    /*--------------------------*/
+
+    if(strcmp(argv[1],"all") != 0)
+    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
+       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       if(pupsthread_cont(tid) == (-1))
+       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to restart\n",(uint64_t)tid,argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") restarted\n",(uint64_t)tid,argv[1]);
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*---------------------*/
+    /* Restart all threads */
+    /*---------------------*/
+
+    else
+    {  uint32_t i,
+                t_cnt          = 0;
+
+       char     tmpname[SSIZE] = "";
+
+       (void)pthread_mutex_lock(&ttab_mutex);
+
+
+       /*-----------------------------------------------------*/
+       /* Restart all active threads (other than root thread) */
+       /*-----------------------------------------------------*/
+
+       for(i=0; i<MAX_THREADS; ++i)
+       {  if(ttab[i].tid != (pthread_t *)NULL)
+          {  tid = ttab[i].tid;
+             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
+             if(pupsthread_cont(tid) == (-1))
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to restart\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+             }
+             else
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") restarted\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+
+                ++t_cnt;
+             }
+          }
+       }
+
+       (void)pthread_mutex_unlock(&ttab_mutex);
+
+
+       if(t_cnt == 0)
+          (void)fprintf(psrp_out,"\nno threads restarted\n");
+       else
+          (void)fprintf(psrp_out,"\n%d threads restarted\n",t_cnt);
+       (void)fflush(psrp_out);
+    }
+
+    return(PSRP_OK);
+}
+
+
+
+/*-------------------------------------------*/
+/* Kill thread executing in this application */
+/*-------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_kill_thread(const uint32_t argc, const char *argv[])
+
+{   pthread_t tid;
+
+    if(strcmp("tkill",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc == 1 || argc == 2 && strcmp(argv[1],"-usage") == 0)
+    {  (void)fprintf(psrp_out,"Usage: tkill [-usage] | [<thread name> | [all]]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*-----------------------*/
+    /* Kill specified thread */
+    /*-----------------------*/
+
+    if(strcmp(argv[1],"all") != 0)
+    {  if((tid = pupsthread_tfuncname2tid(argv[1])) == (pthread_t)NULL)
+       {  (void)fprintf(psrp_out,"Name \"%s\" is not associated with a running thread\n",argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       if(pupsthread_cancel(tid) == (-1))
+       {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to terminate\n",(uint64_t)tid,argv[1]);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+    
+       (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") terminated\n",(uint64_t)tid,argv[1]);
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+
+    /*------------------*/
+    /* Kill all threads */
+    /*------------------*/
+
+    else
+    {  uint32_t i,
+                t_cnt          = 0;
+
+       char     tmpname[SSIZE] = "";
+
+       (void)pthread_mutex_lock(&ttab_mutex);
+
+
+       /*--------------------------------------------------*/
+       /* Kill all active threads (other than root thread) */
+       /*--------------------------------------------------*/
+
+       for(i=0; i<MAX_THREADS; ++i)
+       {  if(ttab[i].tid != (pthread_t *)NULL)
+          {  tid = ttab[i].tid;
+             (void)strlcpy(tmpname,ttab[i].tfuncname,SSIZE);
+             if(pupsthread_cancel(tid) == (-1))
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") failed to terminate\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+             }
+             else
+             {  (void)fprintf(psrp_out,"Thread (%lx, name \"%s\") terminated\n",(uint64_t)tid,tmpname);
+                (void)fflush(psrp_out);
+
+                ++t_cnt;
+             }
+          }
+       }
+
+       (void)pthread_mutex_unlock(&ttab_mutex);
+
+
+       if(t_cnt == 0)
+          (void)fprintf(psrp_out,"\nno threads terminated\n");
+       else
+          (void)fprintf(psrp_out,"\n%d threads terminated\n",t_cnt);
+       (void)fflush(psrp_out);
+    }
+
+    return(PSRP_OK);
+}
+#endif /* PTHREAD_SUPPORT */
+
+
+
+
+/*------------------------------------------------*/
+/* Show /proc filesystem entries for this process */
+/*------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_procstatus(const uint32_t argc, const char *argv[])
+
+{   char appl_procstatus[SSIZE] = "",
+         line[SSIZE]            = "";
+
+    FILE *proc_stream = (FILE *)NULL;
+
+    if(strcmp("pstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc != 1)
+    {  (void)fprintf(psrp_out,"\nusage: procstatus\n\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+    (void)snprintf(appl_procstatus,SSIZE,"/proc/%d/status",appl_pid);
+
+    proc_stream = pups_fopen(appl_procstatus,"r",DEAD);
+
+    (void)fprintf(psrp_out,"\n");
+    (void)fflush(psrp_out);
+
+    do {   (void)pups_fgets(line,SSIZE,proc_stream);
+
+           if(feof(proc_stream) == 0)
+           {  (void)fprintf(psrp_out,"%s\n",line);
+              (void)fflush(psrp_out);
+           }
+       } while(feof(proc_stream) == 0);
+      
+    (void)pups_fclose(proc_stream);
+    (void)fprintf(psrp_out,"\n");
+    (void)fflush(psrp_out);
+
+    return(PSRP_OK); 
+}
+
+
+
+
+
+/*-----------------------------------------------*/
+/* Show link file locks held by this application */
+/*-----------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_link_file_locks(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("lflstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    (void)pups_show_link_file_locks(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*-------------------------------------------*/
+/* Show flock locks held by this application */
+/*-------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_flock_locks(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("flstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    (void)pups_show_flock_locks(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Show non-default signal handlers installed for this application */
+/*-----------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_sigstatus(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("sigstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+
+    /*------------------------------------------*/
+    /* Show signal status for individual signal */
+    /*------------------------------------------*/
+
+    if(argc > 1)
+    {  uint32_t i;
+
+       for(i=1; i<argc; ++i)
+       {  if(pups_show_siglstatus(pups_signametosigno(argv[i]),psrp_out) == (-1))
+          {  (void)fprintf(psrp_out,"Not a valid signal (%s)\n",argv[i]);
+             (void)fflush(psrp_out);
+          }
+       }
+    }
+
+
+    /*---------------------------------------*/
+    /* Show (abridged) status of all signals */
+    /*---------------------------------------*/
+
+    else
+       pups_show_sigstatus(psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Show signal mask and signals pending for this application */
+/*-----------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_sigmaskstatus(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("maskstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_sigmaskstatus(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*--------------------------------------------------*.
+/* Show file descriptors opened by this application */
+/*--------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_open_fdescriptors(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("fstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_open_fdescriptors(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*-------------------------------------------*/
+/* Show (active) children of current process */
+/*-------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_children(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("cstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_children(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+/*-------------------------------------------------------------------------------*/
+/* Show (fast) caches curently mapped into the address space of this application */
+/*-------------------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_caches(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("cachestat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc > 1)
+    {  (void)fprintf(psrp_out,"usage: cashestat <cache>\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+    if(argc == 2)
+    {  int32_t c_index; 
+
+       c_index = cache_name2index(FALSE,argv[1]);
+       if(cache_display_statistics(FALSE,psrp_out,c_index) == (-1))
+       {  (void)fprintf(psrp_out,"\ncache \"%s\" is not mapped into addrees space of \"%s\"\n",argv[1],appl_name);
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+    }
+    else
+       (void)cache_display(FALSE,psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
+
+#ifdef PERSISTENT_HEAP_SUPPORT
+/*---------------------------------------------------------------------------*/
+/* Show persistent heaps attached to this application - if request is of the */
+/* form hstat <heap> show the object map of that heap                        */
+/*---------------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_persistent_heaps(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("hstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+
+    /*--------------------*/
+    /* Parse command line */
+    /*--------------------*/
+
+    if(argc > 3 || (argc == 2 && strcmp(argv[1],"-usage") == 0))
+    {  (void)fprintf(psrp_out,"usage: hstat [<hid>]\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+
+    /*---------------------------------------------*/
+    /* Display details of specific persistent heap */
+    /*---------------------------------------------*/
+
+    if(argc >= 2)
+    {   int32_t h_index;
+       char     heapname[SSIZE] = "";
+
+
+       /*--------------*/
+       /* Sanity check */
+       /*--------------*/
+
+       if(sscanf(argv[1],"%d",&h_index) != 1 || h_index < 0)
+       {  
+          if((h_index = msm_name2index(argv[1])) == (-1))
+          {  (void)fprintf(psrp_out,"invalid heap specification (%s)\n",argv[1]);
+             (void)fflush(psrp_out);
+
+             return(PSRP_OK);
+          }
+       }
+
+
+       /*------------------------------------*/
+       /* Display objects on persistent heap */
+       /*------------------------------------*/
+
+       if(argc == 2)
+       {  if(msm_show_mapped_objects(h_index,psrp_out) == (-1))
+          {  (void)fprintf(psrp_out,"invalid heap specification (%s)\n",argv[1]);
+             (void)fflush(psrp_out);
+
+             return(PSRP_OK);
+          }
+       } 
+
+
+       /*------------------------------------*/
+       /* Display details of specific object */
+       /* on peristent heap                  */
+       /*------------------------------------*/
+
+       else
+       {  int32_t o_index;
+
+          if(sscanf(argv[2],"%d",&o_index) != 1 ||  o_index < 0)
+          {  if((o_index = msm_map_objectname2index(h_index,argv[2])) == (-1))
+             {  (void)fprintf(psrp_out,"\nInvalid object specification (%s)\n",argv[2]);
+                (void)fflush(psrp_out);
+
+                return(PSRP_OK);
+              }
+          }
+
+          if(msm_show_mapped_object(h_index,o_index,psrp_out) == (-1))
+          {  (void)fprintf(psrp_out,"\nInvalid object specification (%s)\n",argv[2]);
+             (void)fflush(psrp_out);
+
+             return(PSRP_OK);
+          }
+       } 
+    }
+
+
+    /*--------------------------------------------------*/
+    /* Display details of all attached persistent heaps */
+    /*--------------------------------------------------*/
+
+    else
+       psrp_show_persistent_heaps(psrp_out);
+
+    return(PSRP_OK);
+}
+#endif /* PERSISTENT_HEAP_SUPPORT */
+
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Show slaved interation client channels opened by this application */
+/*-------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_open_sics(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("sicstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    psrp_show_open_sics(psrp_out);
+    return(PSRP_OK);
+}
+
+
+ 
+
+/*-----------------------------------------------------*/
+/* Show (PUPS) entrance functions bound to application */
+/*-----------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_pups_show_entrance_f(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("atentrance",argv[0]) != 0) 
+       return(PSRP_DISPATCH_ERROR); 
+
+    pups_show_entrance_f(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*-------------------------------------------------*/
+/* Show (PUPS) exit functions bound to application */
+/*-------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_pups_show_exit_f(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("atexit",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_exit_f(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+/*-------------------------------------------------*/
+/* Show (PUPS) exit functions bound to application */
+/*-------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_pups_show_abort_f(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("atabort",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_abort_f(psrp_out);
+    psrp_show_on_abort_callback_f(psrp_out);
+
+    return(PSRP_OK);
+}
+
+
+
+
+/*-----------------------------------------------------------------*/
+/* Show (PUPS) virtual interval timers associated with application */
+/*-----------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_pups_show_vitimers(const uint32_t argc, const char *argv[])
+
+{   if(strcmp("vitstat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    pups_show_vitimers(psrp_out);
+    return(PSRP_OK);
+}
+
+
+
+
+/*----------------------------------*/
+/* Show tracked heap memory objects */
+/*----------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_show_htobjects(const uint32_t argc, const char *argv[])
+
+{   uint32_t objects;
+
+    if(strcmp("hostat",argv[0]) != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(argc < 2)
+    {  (void)fprintf(psrp_out,"Usage: hostat <Largest N objects | list of named objects>\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+    if(sscanf(argv[1],"%d",&objects) == 1)
+       pups_tshowobjects(psrp_out,&objects);
+    else
+    {  uint32_t    i,
+                    pos;
+
+       if(argc >= 2)
+       {  for(i=1; i<argc; ++i)
+          {  int32_t  cnt          = 0;
+             _BOOLEAN is_name = FALSE;
+             void     *ptr    = (void *)NULL;
+
+
+             /*--------------------------------*/ 
+             /* Search matab by (partial) name */ 
+             /*--------------------------------*/ 
+
+             pos = 0;
+             while((ptr = pups_tpartnametoptr(&pos, argv[i])) != (void *)NULL)
+             {    is_name = TRUE;
+
+                  pups_tshowobject(psrp_out,ptr);
+                  ++cnt;
+             }
+
+
+             /*-----------------------------------*/
+             /* Not a name - search matab by type */
+             /*-----------------------------------*/
+
+             if(is_name == FALSE)
+             {  pos = 0;
+                while((ptr = pups_ttypetoptr(&pos ,argv[i])) != (void *)NULL)
+                {    pups_tshowobject(psrp_out,ptr);
+                     ++cnt;
+                }
+             }
+
+             if(cnt == 0)
+             {  (void)fprintf(psrp_out,"\n%s is not a tracked heap object\n\n",argv[i]);
+                (void)fflush(psrp_out);
+             }
+          }
+       }
+    }
+
+    return(PSRP_OK);
+}
+
+
+
+
+
+/*--------------------------------------------*/
+/* Destroy PSRP object by handler table index */
+/*--------------------------------------------*/
+
+_PUBLIC void psrp_destroy_object(const uint32_t slot_index)
+
+{   
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_destroy_object] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    (void)psrp_ifree_tag_list(slot_index); 
+}
+
+
+
+
+/*-------------------------------------*/
+/* Send error message string to client */
+/*-------------------------------------*/
+
+_PUBLIC void psrp_error(const char *error_string)
+
+{   
+    if(error_string == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_destroy_object] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    (void)fprintf(psrp_out,"[psrp %sERROR%s] %s\n",boldOn,boldOff,error_string);
+    (void)fflush(psrp_out);
+
+    pups_set_errno(OK);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Attach process name registry. The registry is created (and */
+/* zero filled) by the first PUPS process to register a name  */
+/*------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN psrp_pnreg_attach(const _BOOLEAN create)
+
+{   des_t       fdes;
+    uint32_t    magic      = 0;
+    pnreg_type  *registry  = (pnreg_type *)NULL;
+    char        path[SSIZE] = "";
+    struct stat buf;
+
+    if(psrp_pnreg != (pnreg_type *)NULL)
+       return(TRUE);
+
+    (void)snprintf(path,SSIZE,PNREG_PATH_FMT,getuid());
+    if(create == TRUE)
+       fdes = open(path,O_RDWR | O_CREAT | O_CLOEXEC,0600);
+    else
+       fdes = open(path,O_RDWR | O_CLOEXEC);
+
+    if(fdes == (-1))
+       return(FALSE);
+
+
+    /*-------------------------------------------------*/
+    /* Registry must belong to us (and only us) and we */
+    /* must be able to map all of it                   */
+    /*-------------------------------------------------*/
+
+    if(fstat(fdes,&buf) == (-1) || buf.st_uid != getuid() || (buf.st_mode & 077) != 0)
+    {  (void)close(fdes);
+       return(FALSE);
+    }
+
+    if((size_t)buf.st_size < sizeof(pnreg_type))
+    {  if(create == FALSE || ftruncate(fdes,sizeof(pnreg_type)) == (-1))
+       {  (void)close(fdes);
+          return(FALSE);
+       }
+    }
+
+    registry = (pnreg_type *)mmap((void *)NULL,sizeof(pnreg_type),PROT_READ | PROT_WRITE,MAP_SHARED,fdes,0);
+    (void)close(fdes);
+
+    if((void *)registry == MAP_FAILED)
+       return(FALSE);
+
+
+    /*-------------------------------------------------------------*/
+    /* Stamp new (zero filled) registry. Any other magic number is */
+    /* a registry with an incompatible layout which we leave alone */
+    /*-------------------------------------------------------------*/
+
+    __atomic_store_n(&registry->slots,PNREG_SLOTS,__ATOMIC_SEQ_CST);
+    (void)__atomic_compare_exchange_n(&registry->magic,&magic,PNREG_MAGIC,FALSE,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST);
+
+    if(__atomic_load_n(&registry->magic,__ATOMIC_SEQ_CST) != PNREG_MAGIC)
+    {  (void)munmap((void *)registry,sizeof(pnreg_type));
+       return(FALSE);
+    }
+
+    psrp_pnreg = registry;
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Reclaim registry entry whose sequence number has stayed odd */
+/* for PNREG_STALE_POLLS milliseconds (its writer died part    */
+/* way through an update). If we win the reclaim we own the    */
+/* entry (at odd sequence number *seq)                         */
+/*-------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN psrp_pnreg_reclaim(pnreg_entry_type *entry, uint32_t *seq)
+
+{   uint32_t i,
+             stale_seq = *seq;
+
+    for(i=0; i<PNREG_STALE_POLLS; ++i)
+    {  (void)pups_usleep(1000);
+
+       if(__atomic_load_n(&entry->seq,__ATOMIC_ACQUIRE) != stale_seq)
+          return(FALSE);
+    }
+
+
+    /*-------------------------------------------------------*/
+    /* Move entry to the next odd sequence number -- if some */
+    /* other process is reclaiming it too only one of us can */
+    /* succeed                                               */
+    /*-------------------------------------------------------*/
+
+    if(!__atomic_compare_exchange_n(&entry->seq,&stale_seq,stale_seq + 2,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_RELAXED))
+       return(FALSE);
+
+    *seq = stale_seq + 2;
+    return(TRUE);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Register process name (in shared memory process name    */
+/* registry)                                               */
+/*---------------------------------------------------------*/
+
+_PUBLIC int32_t psrp_pnreg_register(const char *process_name)
+
+{   uint32_t i,
+             home;
+
+    pid_t    pid        = getpid();
+    uint64_t start_time = 0;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_pnreg_register] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(process_name == (const char *)NULL || strlen(process_name) >= PNREG_NAMELEN)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    if(psrp_pnreg_attach(TRUE) == FALSE)
+    {  pups_set_errno(ENOENT);
+       return(-1);
+    }
+
+
+    /*----------------------------------------------*/
+    /* Drop any name we have already registered (we */
+    /* may be re-registering under a new name)      */
+    /*----------------------------------------------*/
+
+    psrp_pnreg_unregister();
+
+    start_time = pnreg_start_time(pid);
+    home       = pnreg_hash(process_name);
+
+
+    /*------------------------------------------------------------*/
+    /* Claim first free (or dead) slot in window. Claiming a slot */
+    /* moves its sequence number from even to odd -- if somebody  */
+    /* else got there first, the CAS fails and we try next slot.  */
+    /* A slot left odd by a writer which died is reclaimed        */
+    /*------------------------------------------------------------*/
+
+    for(i=0; i<PNREG_PROBES; ++i)
+    {  uint32_t         seq,
+                        slot   = (home + i) % PNREG_SLOTS;
+       pnreg_entry_type copy,
+                        *entry = &psrp_pnreg->entry[slot];
+
+       if(pnreg_read_entry(entry,&copy) == 0)
+       {  if(copy.pid != 0 && copy.pid != pid && pnreg_alive(copy.pid,copy.start_time) == 0)
+             continue;
+
+          seq = copy.seq;
+          if(!__atomic_compare_exchange_n(&entry->seq,&seq,seq + 1,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_RELAXED))
+             continue;
+          ++seq;
+       }
+       else
+       {  seq = __atomic_load_n(&entry->seq,__ATOMIC_ACQUIRE);
+          if((seq & 1) == 0 || psrp_pnreg_reclaim(entry,&seq) == FALSE)
+             continue;
+       }
+
+       entry->pid        = pid;
+       entry->start_time = start_time;
+       (void)strlcpy(entry->name,process_name,PNREG_NAMELEN);
+
+
+       /*-----------------------------------------------------*/
+       /* If our (odd) sequence number has changed, somebody  */
+       /* decided we had died and reclaimed the slot from us  */
+       /*-----------------------------------------------------*/
+
+       if(!__atomic_compare_exchange_n(&entry->seq,&seq,seq + 1,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_RELAXED))
+          continue;
+
+       psrp_pnreg_slot  = slot;
+       psrp_pnreg_owner = pid;
+
+       pups_set_errno(OK);
+       return(0);
+    }
+
+
+    /*------------------------------------------------------*/
+    /* Window is full -- name lookups for this process will */
+    /* fall back to walking /proc                           */
+    /*------------------------------------------------------*/
+
+    pups_set_errno(ENOSPC);
+    return(-1);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Remove process name from process name registry          */
+/*---------------------------------------------------------*/
+
+_PUBLIC void psrp_pnreg_unregister(void)
+
+{   uint32_t         seq;
+    pnreg_entry_type *entry = (pnreg_entry_type *)NULL;
+
+
+    /*------------------------------------------------------------*/
+    /* Slot may have been inherited (via fork) from our parent in */
+    /* which case it is not ours to remove                        */
+    /*------------------------------------------------------------*/
+
+    if(psrp_pnreg == (pnreg_type *)NULL || psrp_pnreg_slot == (-1) || psrp_pnreg_owner != getpid())
+    {  psrp_pnreg_slot = (-1);
+       return;
+    }
+
+    entry = &psrp_pnreg->entry[psrp_pnreg_slot];
+    seq   = __atomic_load_n(&entry->seq,__ATOMIC_ACQUIRE);
+
+    if((seq & 1) == 0 && entry->pid == psrp_pnreg_owner &&
+       __atomic_compare_exchange_n(&entry->seq,&seq,seq + 1,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_RELAXED))
+    {  entry->pid     = 0;
+       entry->name[0] = '\0';
+
+       ++seq;
+       (void)__atomic_compare_exchange_n(&entry->seq,&seq,seq + 1,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_RELAXED);
+    }
+
+    psrp_pnreg_slot  = (-1);
+    psrp_pnreg_owner = (-1);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Look up process name in process name registry. Returns PID of */
+/* (live) registered process, PSRP_DUPLICATE_PROCESS_NAME if the */
+/* name is registered more than once, or PSRP_TERMINATED if the  */
+/* name is not registered (or if an entry in its window could    */
+/* not be read, in which case the caller must walk /proc)        */
+/*---------------------------------------------------------------*/
+
+_PUBLIC pid_t psrp_pnreg_lookup(const char *process_name)
+
+{   int32_t cnt;
+    pid_t   target_pid = PSRP_TERMINATED;
+
+    if(process_name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_TERMINATED);
+    }
+
+    if(strlen(process_name) >= PNREG_NAMELEN || psrp_pnreg_attach(FALSE) == FALSE)
+    {  pups_set_errno(ENOENT);
+       return(PSRP_TERMINATED);
+    }
+
+
+    /*------------------------------------------------------*/
+    /* An entry was never stable (its writer may have died) */
+    /* so we cannot tell whether the name is unique         */
+    /*------------------------------------------------------*/
+
+    if((cnt = pnreg_lookup(psrp_pnreg,process_name,&target_pid)) == (-1))
+    {  pups_set_errno(EAGAIN);
+       return(PSRP_TERMINATED);
+    }
+
+    if(cnt > 1)
+    {  pups_set_errno(ESRCH);
+       return(PSRP_DUPLICATE_PROCESS_NAME);
+    }
+
+    pups_set_errno(OK);
+    return(target_pid);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Get process pid from process name. A name which is in the    */
+/* process name registry is resolved exactly: only registered   */
+/* (PUPS) processes with the same name count as duplicates. An  */
+/* unregistered name is found by walking /proc, where any       */
+/* process whose command line starts with the name is a match   */
+/* (so more than one such process is a duplicate)               */
+/*--------------------------------------------------------------*/
+
+_PUBLIC pid_t psrp_pname_to_pid(const char *process_name)
+
+{   int32_t       target_pid         = PSRP_TERMINATED;
+    pid_t         pid;
+    uint32_t      cnt                = 0;
+
+    char          cmd_line[SSIZE]    = "",
+                  procpidpath[SSIZE] = "";
+
+    FILE          *stream            = (FILE *)NULL;
+    DIR           *dirp              = (DIR *)NULL;
+    struct dirent *next_item         = (struct dirent *)NULL;
+
+    if(process_name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+
+    /*--------------------------------------------------------*/
+    /* Try the (shared memory) process name registry first -- */
+    /* we only walk /proc if the name is not registered there */
+    /* (or the registry cannot be read). Note a registry hit  */
+    /* is not checked against other (non PUPS) processes      */
+    /* whose command line starts with the same name           */
+    /*--------------------------------------------------------*/
+
+    if((target_pid = psrp_pnreg_lookup(process_name)) != PSRP_TERMINATED)
+       return(target_pid);
+
+    if((dirp = opendir("/proc")) == (DIR *)NULL)
+    {  pups_set_errno(ENOTDIR);
+       return(-1);
+    }
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_pname_to_pid] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    /*----------------------------*/
+    /* Search for (named) process */
+    /*----------------------------*/
+
+    pups_set_errno(OK);
+    while((next_item = readdir(dirp)) != (struct dirent *)NULL)
+    {    if(sscanf(next_item->d_name,"%d",&pid) == 1) 
+         {  (void)snprintf(procpidpath,SSIZE,"/proc/%d/cmdline",pid);
+            if ((stream = fopen(procpidpath,"r")) != (FILE *)NULL)
+            {  
+               (void)strlcpy(cmd_line,"",SSIZE);
+               (void)fgets(cmd_line,SSIZE,stream);
+               (void)fclose(stream);
+
+               if(strncmp(cmd_line,process_name,strlen(process_name)) == 0)
+               {  ++cnt;
+
+                  if(cnt > 1)
+                  {  (void)closedir(dirp);
+                      pups_set_errno(ESRCH);
+
+                      return(PSRP_DUPLICATE_PROCESS_NAME);
+                  }
+
+                  target_pid = pid;
+               }
+            }
+         }
+    }
+
+    (void)closedir(dirp);
+
+    pups_set_errno(OK);
+    return(target_pid);
+}
+
+               
+            
+                                        
+
+/*---------------------------*/
+/* Get process name from pid */
+/*---------------------------*/
+
+_PUBLIC _BOOLEAN psrp_pid_to_pname(const pid_t pid, char *process_name) 
+
+{   FILE *stream = (FILE *)NULL;
+
+    char cmd_line[SSIZE]    = "",
+         procpidpath[SSIZE] = "";
+
+    if(process_name == (char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_pid_to_pname] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    /*-------------------------*/
+    /* Does the process exist? */
+    /*-------------------------*/
+
+    (void)snprintf(procpidpath,SSIZE,"/proc/%d/cmdline",pid);
+    if((stream = fopen(procpidpath,"r")) == (FILE *)NULL)
+    {  pups_set_errno(ESRCH);
+       return(FALSE);
+    }
+
+
+    /*-------------------------------------------*/
+    /* Ok -- process exists -- lets get its name */
+    /*-------------------------------------------*/
+
+    (void)fgets(cmd_line,SSIZE,stream);
+    (void)fclose(stream);
+    
+    if(sscanf(cmd_line,"%s",process_name) != 1)
+       (void)strlcpy(process_name,"<unknown>",SSIZE);
+
+    pups_set_errno(OK);
+    return(TRUE);
+} 
+
+
+
+
+/*--------------------------------*/
+/* Get pid from PSRP channel name */
+/*--------------------------------*/
+
+_PUBLIC pid_t psrp_channelname_to_pid(const char *patchboard_path,  // Patchboard containing channel information
+                                      const char *process_name,     // Name of process for which corresponding pid required
+                                      const char *process_host)     // Name of host running process
+
+{   uint32_t i,
+             entry_cnt,
+             d_cnt                       = 0;
+
+    pid_t    old_target_pid              = PSRP_TERMINATED,
+             target_pid                  = PSRP_TERMINATED;
+
+    uid_t    target_uid                  = (-1);
+         
+    char     strdum[SSIZE]               = "",
+             tmpstr[SSIZE]               = "",
+             channel_process_name[SSIZE] = "",
+             **entries                   = (char **)NULL;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_channelname_to_pid] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    if(patchboard_path == (const char *)NULL    ||
+       process_name    == (const char *)NULL    ||
+       process_host    == (const char *)NULL     )
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    (void)strlcpy(tmpstr,process_name,SSIZE);
+    (void)strlcat(tmpstr,"#",SSIZE);
+    if((entries = pups_get_directory_entries(patchboard_path, 
+                                             tmpstr, 
+                                             &d_cnt, 
+                                             &entry_cnt)) == (char **)NULL)
+    {   pups_set_errno(ESRCH);
+        return(-1);
+    }
+
+
+    /*-----------------------------------------------------------------*/
+    /* Check that we don't have duplicate processes with the same name */
+    /*-----------------------------------------------------------------*/
+
+    for(i=0; i<d_cnt; ++i)
+    {  (void)mchrep(' ',"#",entries[i]);
+
+       if(strin(entries[i],"psrp") == TRUE && strin(entries[i],"in") == TRUE)
+       {  int32_t tmp_pid;
+
+          (void)sscanf(entries[i],"%s%s%s%s%s%d%d",strdum,channel_process_name,process_host,strdum,strdum,&tmp_pid,&target_uid);
+
+          if(target_uid == getuid())
+          {  if(i > 0                                          &&
+                old_target_pid > 0                             &&
+                strcmp(process_name,channel_process_name) == 0 &&
+                tmp_pid != old_target_pid                       )
+             {
+
+                /*----------------------------------------------------*/ 
+                /* Clear memory allocated by directory search routine */
+                /*----------------------------------------------------*/ 
+
+                for(i=0; i<d_cnt; ++i)
+                   (void)pups_free((void *)entries[i]);
+                (void)pups_free((void *)entries);
+
+                pups_set_errno(EEXIST);
+                return(PSRP_DUPLICATE_PROCESS_NAME);
+             }
+
+             else
+             {  target_pid     = tmp_pid;
+                old_target_pid = target_pid;
+             }
+          }
+       }
+    }
+
+
+    /*----------------------------------------------------*/
+    /* Clear memory allocated by directory search routine */
+    /*----------------------------------------------------*/
+
+    for(i=0; i<d_cnt; ++i)
+       (void)pups_free((void *)entries[i]);
+    (void)pups_free((void *)entries);
+
+
+    /*----------------------------------------------------------*/
+    /* Is the channel actually associated with a live processs? */
+    /*----------------------------------------------------------*/
+
+    if(target_pid > 0 && kill(target_pid,SIGALIVE) == (-1))
+    {  pups_set_errno(EEXIST);
+       return(PSRP_TERMINATED);
+    }
+ 
+    pups_set_errno(OK);
+    return(target_pid);
+}
+
+
+
+
+/*---------------------------------------------*/
+/* Resolve process name from PSRP channel name */
+/*---------------------------------------------*/
+
+_PUBLIC _BOOLEAN psrp_pid_to_channelname(const char *patchboard_path,  // Patchboard containing channel information
+                                         const pid_t             pid,  // Pid for which corresponding channelname is required
+                                         char          *process_name,  // Name of process corresponding to pid
+                                         char          *process_host)  // Name of host running process corresponding to pid
+
+{  uint32_t i,
+            entry_cnt,
+            d_cnt          = 0;
+
+   uid_t    uid;
+
+   char     strdum[SSIZE]  = "",
+            pid_str[SSIZE] = "",
+            **entries      = (char **)NULL;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_pid_to_channelname] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(patchboard_path == (char *)NULL    ||
+       pid             <  0               || 
+       process_name    == (char *)NULL    ||
+       process_host    == (char *)NULL     )
+    {  pups_set_errno(EINVAL);
+       return(FALSE);
+    }
+
+
+    /*-----------------------------------------*/
+    /* Check to see if process actually exists */
+    /*-----------------------------------------*/
+
+    if(kill(pid,SIGALIVE) == (-1))
+    {  pups_set_errno(EEXIST);
+       return(FALSE);
+    }
+
+
+    /*------------------------------------------------*/
+    /* Open stream and run ps command to get pid list */
+    /*------------------------------------------------*/
+
+    (void)snprintf(pid_str,SSIZE,"%d",pid);
+    if((entries = pups_get_directory_entries(patchboard_path, 
+                                             pid_str, 
+                                             &d_cnt, 
+                                             &entry_cnt)) == (char **)NULL)
+    {   pups_set_errno(ESRCH);
+        return(FALSE);
+    }
+
+
+    /*--------------------------------------------------------------*/
+    /* values <= 0 imply that their is no channel for specified pid */
+    /*--------------------------------------------------------------*/
+
+    if(d_cnt > 0)
+    {  for(i=0; i<d_cnt; ++i)    
+       {  if(strin(entries[i],"psrp") == TRUE)
+          {  int32_t tmp_pid;
+
+             (void)mchrep(' ',"#",entries[i]);
+             (void)sscanf(entries[i],"%s%s%s%s%s%d%d",strdum,process_name,process_host,strdum,strdum,&tmp_pid,&uid);
+
+
+             /*----------------------------------------------*/
+             /* Check to see if we actually own this process */
+             /*----------------------------------------------*/
+
+             if(uid != getuid())
+             {  pups_set_errno(EACCES);
+                return(FALSE);
+             }
+
+             if(pid == tmp_pid)
+             {
+
+                /*----------------------------------------------------*/
+                /* Clear memory allocated by directory search routine */
+                /*----------------------------------------------------*/
+
+                for(i=0; i<d_cnt; ++i)
+                   (void)pups_free((void *)entries[i]);
+                (void)pups_free((void *)entries);
+
+                pups_set_errno(OK);
+                return(TRUE);
+             }
+          }
+       }
+    }
+
+
+    /*----------------------------------------------------*/
+    /* Clear memory allocated by directory search routine */
+    /*----------------------------------------------------*/
+
+    for(i=0; i<d_cnt; ++i)
+       (void)pups_free((void *)entries[i]);
+    (void)pups_free((void *)entries);
+
+    (void)strlcpy(process_name,"nochan",SSIZE);
+    (void)strlcpy(process_host,"nohost",SSIZE);
+
+    pups_set_errno(ESRCH);
+    return(FALSE);
+}
+
+
+
+
+/*---------------------------------------------------*/
+/* Initialise slaved interation client channel table */
+/*---------------------------------------------------*/
+
+_PRIVATE void psrp_initsic(void)
+
+{   uint32_t i;
+
+    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
+    {  (void)strlcpy(channel[i].in_name,  "",SSIZE);
+       (void)strlcpy(channel[i].out_name, "",SSIZE);
+       (void)strlcpy(channel[i].host_name,"",SSIZE);
+       (void)strlcpy(channel[i].ssh_port, "",SSIZE);
+       (void)strlcpy(channel[i].pen,      "",SSIZE);
+
+       channel[i].index      = FREE; 
+       channel[i].in_stream  = (FILE *)NULL;
+       channel[i].out_stream = (FILE *)NULL;
+    }
+
+    if(appl_verbose == TRUE)
+    {  strdate(date);
+
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP slaved  interaction clients (%d channels available)\n",
+                                       date,appl_name,appl_pid,appl_host,appl_owner,PSRP_MAX_SIC_CHANNELS);
+       (void)fflush(stderr);
+    }
+}
+
+
+
+
+#ifdef PERSISTENT_HEAP_SUPPORT
+/*---------------------------------------------------------*/
+/* Show persistent heaps mapped into process address space */
+/*---------------------------------------------------------*/
+
+_PUBLIC void psrp_show_persistent_heaps(const FILE *stream)
+
+{   uint32_t i,
+             heaps = 0;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_show_persistemt_heaps] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(stream == (FILE *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&htab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+
+    /*---------------------------------------*/
+    /* Check to see that we have initialised */
+    /* persistent heaps                      */
+    /*---------------------------------------*/
+
+    if(msm_init == FALSE)
+    {  (void)fprintf(stream,"\n\n    Persistent heaps not initialised\n\n");
+       (void)fflush(stream);
+
+       pups_set_errno(EINVAL);
+       return;
+    }
+
+    (void)fprintf(stream,"\n\n    Persistent heaps attached\n");
+    (void)fprintf(stream,"    =========================\n\n");
+    (void)fflush(stream);
+
+
+    /*-----------------------------------------------------------*/
+    /* Display abridged details of each attached persistent heap */
+    /*-----------------------------------------------------------*/
+
+    for(i=0; i<appl_max_pheaps; ++i)
+    {
+
+       #ifdef PSRPLIB_DEBUG
+       (void)fprintf(stderr,"HTABLE: %d name: (%s)\n",i,htable[i].name);
+       (void)fflush(stderr);
+       #endif /* PSRPLIB_DEBUG */
+
+       if(strcmp(htable[i].name,"") != 0)
+       {  
+
+          (void)fprintf(stream,"    %04d: \"%-32s\"  mapped at %016lx virtual (size %016lx bytes)\n",i,
+                                                                                        htable[i].name,
+                                                                     (uint64_t         )htable[i].addr,
+                                                                     htable[i].edata - htable[i].sdata);
+          (void)fflush(stream);
+
+          ++heaps;
+       }
+    }
+
+
+    /*---------------------------------------------*/
+    /* Display number of attached persistent heaps */
+    /*---------------------------------------------*/
+
+    if(heaps == 0)
+    {  (void)fprintf(stream,"    no persistent heaps mapped (%04d slots free)\n\n",appl_max_pheaps,appl_max_pheaps);
+       (void)fflush(stream);
+    }
+    else if(heaps == 1)
+       (void)fprintf(stream,"\n\n    %04d persistent heap mapped  int32_to process address space (%04d slots free)\n\n",1,appl_max_pheaps,appl_max_pheaps - 1);
+    else if(heaps > 1)
+       (void)fprintf(stream,"\n\n    %04d persistent heaps mapped  int32_to process address space (%04d slots free)\n\n",heaps,appl_max_pheaps,appl_max_pheaps - heaps);
+
+    (void)fflush(stream);
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&htab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    pups_set_errno(OK);
+}
+#endif /* PERSISTENT_HEAP_SUPPORT */
+
+
+
+
+/*----------------------------------*/
+/* Show open slaved client channels */
+/*----------------------------------*/
+
+_PUBLIC void psrp_show_open_sics(const FILE *stream)
+
+{   uint32_t i,
+             j,
+             sics = 0;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_show_open_sics] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(stream == (FILE *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+    (void)fprintf(stream,"\n\n     Slaved interation client channels (SICs) free\n");
+    (void)fprintf(stream,"     =============================================\n\n");
+
+    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
+    {  if(channel[i].index != FREE)
+       {  char type[SSIZE] = "";
+
+          if(channel[i].type == SIC_FIFO)
+             (void)strlcpy(type,"[duplex FIFO]",SSIZE);
+          else
+             (void)strlcpy(type,"[ssh tunnel]",SSIZE); 
+
+          #ifdef SSH_SUPPORT
+          (void)fprintf(stream,"    %04d: %-32s (on host %-48s via %-48s) %-16s (ssh port: %s)\n",i,
+                                                                                     channel[i].pen,
+                                                                                channel[i].out_name,
+                                                                               channel[i].host_name,
+                                                                                               type,
+                                                                                channel[i].ssh_port);
+          #else
+          (void)fprintf(stream,"    %04d: %-32s (on host %-48s via %-48s) %-16s (ssh port: %s)\n",i,
+                                                                                     channel[i].pen,
+                                                                                channel[i].out_name,
+                                                                               channel[i].host_name,
+                                                                                               type);
+          #endif /* SSH_SUPPPORT */
+
+          for(j=0; j<PSRP_SIC_POOL_SIZE; ++j)
+          {  if(psrp_sic_pool[j].sic == &channel[i])
+             {  if(psrp_sic_pool[j].in_use == TRUE)
+                   (void)fprintf(stream,"          [pooled, in use, %lu reuses]\n",psrp_sic_pool[j].reuses);
+                else
+                   (void)fprintf(stream,"          [pooled, idle %ld secs, %lu reuses]\n",
+                                     time((time_t *)NULL) - psrp_sic_pool[j].last_used,psrp_sic_pool[j].reuses);
+             }
+          }
+
+          (void)fflush(stream);
+          ++sics;
+       }
+    }
+
+    if(sics == 0)
+       (void)fprintf(stream,"\n\n     no sics in use (%04d slots free)\n\n",PSRP_MAX_SIC_CHANNELS);
+    else if(sics == 1)
+       (void)fprintf(stream,"\n\n     %04d sic in use (%04d slots free)\n\n", 1,PSRP_MAX_SIC_CHANNELS - 1);
+    else
+       (void)fprintf(stream,"    %04d sics in use (%04d slots free)\n\n",sics,PSRP_MAX_SIC_CHANNELS - sics);
+
+    (void)fflush(stream);
+
+    pups_set_errno(OK);
+}
+
+                                                        
+
+
+/*-------------------------------------------------*/
+/* Create connection to slaved PSRP client process */
+/*-------------------------------------------------*/
+
+#ifdef SSH_SUPPORT
+_PUBLIC psrp_channel_type *psrp_create_slaved_interaction_client(const char  *host_name,  // Host to create client on 
+                                                                 const char  *ssh_port,   // Port on client
+                                                                 const char  *psrp_pen)   // PEN of client
+#else
+_PUBLIC psrp_channel_type *psrp_create_slaved_interaction_client(const char  *psrp_pen)   // PEN of client
+#endif /* SSH_SUPPORT */
+{   uint32_t i,
+             sic_index;
+
+    int32_t  ssh_portNo                   = (-1), 
+             scp,
+             ft_index,
+             get_items;
+
+    char     eff_psrp_pen[SSIZE]          = "psrp",
+             sic_channel_in_name[SSIZE]   = "",
+             sic_channel_out_name[SSIZE]  = "",
+             psrp_command[SSIZE]          = "",
+             psrp_pathname[SSIZE]         = "",
+             pwd_file_name[SSIZE]         = "",
+             slaved_psrp_client_ok[SSIZE] = "";
+
+    _BOOLEAN local_client                 = TRUE,
+             channel_in_use               = FALSE,
+             channel_allocated            = FALSE;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_create_slaved_interaction_client] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    /*----------------------------------*/
+    /* Get name of slaved psrp instance */
+    /*----------------------------------*/
+
+    if(psrp_pen != (char *)NULL)
+       (void)strlcpy(eff_psrp_pen,psrp_pen,SSIZE);
+
+
+    #ifdef SSH_SUPPORT
+    /*--------------------------*/
+    /* Check port specification */
+    /*--------------------------*/
+
+    if(ssh_port                  != (char *)NULL  && 
+       strcmp(ssh_port,"")       != 0             && 
+       strcmp(ssh_port,"notset") != 0              )
+    {  if(sscanf(ssh_port,"%d",&ssh_portNo) != 1 || ssh_portNo <= 0)
+       {  pups_set_errno(EINVAL);
+          return((psrp_channel_type *)NULL);
+       }
+    }
+    #endif /* SSH_SUPPORT */
+
+
+    /*-----------------------------------------------------------------------------------*/
+    /* We have not yet created this channel so find a free slot in the channel table and */
+    /* allocate it.                                                                      */
+    /*-----------------------------------------------------------------------------------*/
+
+    for(i=0; i<PSRP_MAX_SIC_CHANNELS; ++i)
+    {  if(channel[i].index == FREE)
+       {
+
+          /*------------------------------*/
+          /* SIC channel can be allocated */
+          /*------------------------------*/
+
+          sic_index         = i;
+          channel_allocated = TRUE;
+          break;
+       }
+    }
+
+
+    /*-------------------------------------------------*/
+    /* SIC channel names for input and output channels */
+    /*-------------------------------------------------*/
+
+    (void)snprintf(sic_channel_in_name,SSIZE, "%s/psrp#%s#%s#fifo#in#%d#%d#sic#%d" ,appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid,sic_index); 
+    (void)snprintf(sic_channel_out_name,SSIZE,"%s/psrp#%s#%s#fifo#out#%d#%d#sic#%d",appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid,sic_index);
+
+
+    /*-------------------------*/
+    /* All SIC channels in use */
+    /*-------------------------*/
+
+    if(channel_allocated == FALSE)
+    {  pups_set_errno(ENFILE);
+       return((psrp_channel_type *)NULL);
+    }
+
+
+    /*----------------------------------------------------------*/
+    /* Create FIFO channels for local slaved interaction client */
+    /*----------------------------------------------------------*/
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+
+       if(host_name != (char *)NULL)
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): creating remote SIC channel [to host %s] (via slaved client %s)\n",
+                                                 date,appl_name,appl_pid,appl_host,appl_owner,host_name,eff_psrp_pen);
+       else
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): creating local SIC channel (via slaved client %s)\n",
+                                             date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
+       (void)fflush(stderr);
+    }
+
+
+    /*---------------------------------------------------*/
+    /* Fill in (common) fields of SIC channel descriptor */
+    /*---------------------------------------------------*/
+
+    channel[sic_index].index = sic_index;
+
+    (void)strlcpy(channel[sic_index].in_name, sic_channel_in_name,SSIZE);
+    (void)strlcpy(channel[sic_index].out_name,sic_channel_out_name,SSIZE);
+
+    if(host_name == (char *)NULL)
+    {  (void)strlcpy(channel[sic_index].host_name,appl_host,SSIZE);
+        channel[sic_index].remote = FALSE;
+    }
+    else
+    {  (void)strlcpy(channel[sic_index].host_name,host_name,SSIZE);
+        channel[sic_index].remote = TRUE;
+    }
+
+
+
+    /*----------------------*/
+    /* Non default ssh port */
+    /* (e.g. for container) */
+    /*----------------------*/
+
+    if(ssh_portNo >  0)
+       (void)strlcpy(channel[sic_index].ssh_port,ssh_port,SSIZE);
+    (void)strlcpy(channel[sic_index].pen,eff_psrp_pen,SSIZE);
+
+
+    /*----------------------------------------------*/
+    /* Create physical channel (as named FIFO pair) */
+    /*----------------------------------------------*/
+
+    (void)mkfifo(sic_channel_in_name,0600);
+    channel[sic_index].in_stream  = pups_fopen(sic_channel_in_name, "w",LIVE);
+    (void)psrp_empty_fifo(fileno(channel[sic_index].in_stream));
+
+    (void)mkfifo(sic_channel_out_name,0600);
+    channel[sic_index].out_stream = pups_fopen(sic_channel_out_name,"r",LIVE);
+    (void)psrp_empty_fifo(fileno(channel[sic_index].out_stream));
+
+
+    /*-----------------------------------------------------------------*/
+    /* Give the slave channel FIFO's the same level of protection as   */
+    /* a PSRP channel -- e.g. homeostatic protection cannot be removed */
+    /*-----------------------------------------------------------------*/
+
+    ft_index = pups_get_ftab_index(fileno(channel[sic_index].in_stream));
+    ftab[ft_index].psrp    = TRUE;
+    ftab[ft_index].creator = TRUE;
+
+    ft_index = pups_get_ftab_index(fileno(channel[sic_index].out_stream));
+    ftab[ft_index].psrp    = TRUE;
+    ftab[ft_index].creator = TRUE;
+
+
+    /*----------------------------------------*/
+    /* Start remote slaved interaction client */ 
+    /*----------------------------------------*/
+
+    if(strccpy(psrp_pathname,pups_search_path("PATH","psrp")) == (char *)NULL)
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+
+
+          /*--------------------------*/
+          /* Cannot find psrp command */
+          /*--------------------------*/
+
+          if(host_name != (char *)NULL)
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) SIC channel [to host %s] (cannot find psrp client in path)\n",
+                                                                                                 date,appl_name,appl_pid,appl_host,appl_owner,host_name);
+          else
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create local SIC channel (cannot find psrp client in path)\n",
+                                                                                date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       psrp_clear_channel_slot(&channel[sic_index]);
+
+       pups_set_errno(EEXIST);
+       return((psrp_channel_type *)NULL);
+    }
+
+
+    /*--------------------------------------------------------------------*/
+    /* Build slaved client command (noting whether it is local or remote) */
+    /*--------------------------------------------------------------------*/
+
+
+    /*----------------------------------------*/
+    /* Slaved PSRP client is running remotely */
+    /*----------------------------------------*/
+
+    if(host_name                     != (char *)NULL  && 
+       strcmp(host_name,"localhost") != 0             && 
+       strcmp(host_name,"notset")    != 0             &&
+       strcmp(host_name,"")          != 0              )
+    {  (void)snprintf(psrp_command,SSIZE,"%s -slaved -on %s -from %s %s %d -pen %s -noprompt",
+                                                                                psrp_pathname,
+                                                                                    host_name,
+                                                                                    appl_host,
+                                                                                    appl_name,
+                                                                                     appl_pid,
+                                                                                 eff_psrp_pen);
+       local_client = FALSE;
+    }
+
+    /*---------------------------------------*/
+    /* Slaved PSRP client is running locally */
+    /*---------------------------------------*/
+
+    else
+       (void)snprintf(psrp_command,SSIZE,"%s -slaved -pen %s -noprompt",
+                                                          psrp_pathname,
+                                                           eff_psrp_pen);
+
+
+    /*---------------------------------------------*/
+    /* Start (local) slaved instane of psrp client */
+    /*---------------------------------------------*/
+
+    if(local_client == TRUE)
+    { 
+
+       /*----------------------------------------------------*/
+       /* Child side of fork                                 */
+       /* Associate stdio (for slaved ssh) with PSRP channel */
+       /*----------------------------------------------------*/
+
+       if((scp = pups_fork(FALSE,FALSE)) == 0)
+       {
+
+          /*--------------------------------------*/
+          /* Connect slaved client to SIC channel */
+          /*--------------------------------------*/
+
+          (void)fclose(stdin);
+          stdin = fopen(sic_channel_in_name,  "r");
+
+          (void)fclose(stdout);
+          stdout = fopen(sic_channel_out_name,"w");
+
+          (void)fclose(stderr);
+          stderr = fopen(sic_channel_out_name,"w");
+
+
+          /*----------------------------------*/
+          /* Start local slaved psrp instance */
+          /*----------------------------------*/
+
+          (void)execlp("sh","sh","-c",psrp_command,(char *)NULL);
+
+
+          /*---------------------------------------------------------*/
+          /* We should not get here -- if we do an error has occured */
+          /*---------------------------------------------------------*/
+
+          _exit(255);
+       }
+
+
+       /*---------------------*/
+       /* Parent side of fork */
+       /*---------------------*/
+
+       else if(scp == (-1))
+       {  
+
+          /*---------------------------------------*/
+          /* Failed to create slaved psrp instance */
+          /*---------------------------------------*/
+
+          (void)psrp_destroy_slaved_interaction_client(&channel[sic_index],TRUE);
+
+          if(appl_verbose == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create local (duplex FIFO) SIC channel (exec failed)\n",
+                                                                          date,appl_name,appl_pid,appl_host,appl_owner);
+             (void)fflush(stderr);
+          }
+
+          psrp_clear_channel_slot(&channel[sic_index]);
+
+          pups_set_errno(ENOEXEC);
+          return((psrp_channel_type *)NULL);
+       }
+
+
+       /*----------------------------------------------------*/
+       /* Fill in remaining fields of SIC channel descriptor */
+       /*----------------------------------------------------*/
+
+       channel[sic_index].type     = SIC_FIFO;
+       channel[sic_index].remote   = FALSE;
+       channel[sic_index].scp      = scp; 
+    }
+
+
+    /*---------------------------------------------*/
+    /* Start remote slaved instance of psrp client */
+    /*---------------------------------------------*/
+
+    #ifdef SSH_SUPPORT
+    else
+    {  char absolute_pathname[SSIZE] = "";
+
+
+       /*------------------------------------------------------*/
+       /* ssh needs an absolute pathname if we have a relative */
+       /* pathname -- make it absolute                         */
+       /*------------------------------------------------------*/
+
+       if(psrp_pathname[0] != '/')
+       {  char cwd[SSIZE] = "";
+
+          (void)getcwd(cwd,SSIZE);
+
+
+          /*-----------------------------------*/
+          /* Pathname is of the form ./relpath */
+          /*-----------------------------------*/
+
+          if(psrp_pathname[0] == '.')
+             (void)snprintf(absolute_pathname,SSIZE,"%s/%s",cwd,&psrp_command[2]);
+          else
+             (void)snprintf(absolute_pathname,SSIZE,"%s/%s",cwd,psrp_command);
+
+          (void)strlcpy(psrp_command,absolute_pathname,SSIZE);
+       }
+
+       ssh_sic_index = (int)sic_index;
+
+       #ifdef PSRPLIB_DEBUG
+       (void)fprintf(stderr,"REMOTE PSRP COMMAND: \"%s\"\n",psrp_command);
+       (void)fflush(stderr);
+       #endif /* PSRPLIB_DEBUG */
+
+
+       /*----------------------------------------------------*/
+       /* Child side of fork                                 */
+       /* Associate stdio (for slaved ssh) with PSRP channel */
+       /*----------------------------------------------------*/
+
+       if((scp = pups_fork(FALSE,FALSE)) == 0)
+       {  char sshPortOpt[SSIZE] = "";
+
+          if(ssh_portNo > 0)
+             (void)snprintf(sshPortOpt,SSIZE,"-p %d",ssh_portNo);
+          else
+             (void)snprintf(sshPortOpt,SSIZE,"-p 22");
+
+          (void)fclose(stdin);
+          stdin = fopen(sic_channel_in_name,  "r");
+
+          (void)fclose(stdout);
+          stdout = fopen(sic_channel_out_name,"w");
+
+          (void)fclose(stderr);
+          stderr = fopen(sic_channel_out_name,"w");
+
+
+          /*--------------------------------------*/
+          /* We are not using passwords. You will */
+          /* need to generate a public/private    */
+          /* keyset for this to work              */
+          /*--------------------------------------*/
+
+
+          /*-----------------------------------*/
+          /* Start remote slaved psrp instance */
+          /*-----------------------------------*/
+
+          if(ssh_compression == TRUE)
+             (void)execlp("ssh","ssh",sshPortOpt,"-oPasswordAuthentication=no","-C","-l",    ssh_remote_uname,host_name,psrp_command,(char *)NULL);
+          else
+             (void)execlp("ssh","ssh",sshPortOpt,"-oPasswordAuthentication=no","-l",         ssh_remote_uname,host_name,psrp_command,(char *)NULL);
+
+
+          /*---------------------------------------------------------*/
+          /* We should not get here -- if we do an error has occured */
+          /*---------------------------------------------------------*/
+
+          _exit(255);
+       }
+
+
+       /*---------------------*/
+       /* Parent side of fork */
+       /*---------------------*/
+
+       else if(scp == (-1))
+       {  if(appl_verbose == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) SIC channel [to host %s] (could not exec ssh)\n",
+                                                                                    date,appl_name,appl_pid,appl_host,appl_owner,host_name);
+             (void)fflush(stderr);
+          }
+
+          psrp_clear_channel_slot(&channel[sic_index]);
+
+          pups_set_errno(ENOEXEC);
+          return((psrp_channel_type *)NULL);
+       }
+ 
+
+       if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): PSRP servers (slaved) ssh using (ssh tunnel) SIC channel (%s)\n",
+                                                  date,appl_name,appl_pid,appl_host,appl_owner,sic_channel_in_name);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): now talking to PSRP server \"%s\"'s slaved ssh client\n\n",
+                                                      date,appl_name,appl_pid,appl_host,appl_owner,appl_name);
+          (void)fflush(stderr);
+       }
+
+
+       if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): finished talking to PSRP server \"%s\"'s slaved ssh client (authentication successful)\n",
+                                                                                     date,appl_name,appl_pid,appl_host,appl_owner,appl_name);
+          (void)fflush(stderr);
+       }
+
+
+       /*----------------------------------------------------*/
+       /* Fill in remaining fields of SIC channel descriptor */
+       /*----------------------------------------------------*/
+
+       channel[sic_index].type   = SIC_SSH_TUNNEL;
+       channel[sic_index].remote = TRUE;
+       channel[sic_index].scp    = scp;
+
+
+       /*-------------------*/   
+       /* Clear SIC channel */
+       /*-------------------*/   
+
+       (void)psrp_empty_fifo(fileno(channel[sic_index].in_stream));
+       (void)psrp_empty_fifo(fileno(channel[sic_index].out_stream));
+
+       scp           = (-1);
+       ssh_sic_index = (-1);
+    } 
+    #else
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): remote SIC channels not supported (no ssh support)\n",
+                                                           date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       psrp_clear_channel_slot(&channel[index]);
+
+       pups_set_errno(EINVAL);
+       return((psrp_channel_type *)NULL);
+    }       
+    #endif /* SSH_SUPPORT */
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       if(host_name == (char *)NULL)
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): local (duplex FIFO) SIC channel created (via slaved client %s)\n",
+                                                          date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
+       #ifdef SSH_SUPPORT
+       else
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): remote (ssh tunnel) SIC channel [to host %s] created (via slaved client %s)\n",
+                                                             date,appl_name,appl_pid,appl_host,appl_owner,host_name,eff_psrp_pen);
+       #endif /* SSH_SUPPORT */
+
+       (void)fflush(stderr);
+    }
+
+
+    /*---------------------------------------------------*/
+    /* Check that we have out PSRP server up and running */
+    /*---------------------------------------------------*/
+
+    (void)fgets(slaved_psrp_client_ok,SSIZE,channel[sic_index].out_stream);
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"GOT \"%s\"\n",slaved_psrp_client_ok);
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+
+    if(strncmp(slaved_psrp_client_ok,"PSRP",4) == 0)
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): slaved PSRP server \"%s\" has started\n",
+                                 date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
+          (void)fflush(stderr);
+       }
+
+
+       #ifdef PSRPLIB_DEBUG
+       int32_t cnt = 0;
+       while(1)
+       {   (void)fputs("test\n",channel[sic_index].in_stream);
+           (void)fflush(channel[index].in_stream);
+
+           (void)psrp_read_sic(&channel[sic_index],slaved_psrp_client_ok);
+           (void)pups_sleep(1);
+
+           (void)fprintf(stderr,"GOT: %s (cnt: %d)\n**********\n\n",slaved_psrp_client_ok,cnt++);
+           (void)fflush(stderr);
+       }
+       #endif /* PSRPLIB_DEBUG */
+
+       pups_set_errno(OK);
+       return(&channel[sic_index]);
+    }
+
+
+    /*---------------------------------*/
+    /* Problem with slaved psrp server */
+    /*---------------------------------*/
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): slaved PSRP server \"%s\" has failed to start\n",
+                                      date,appl_name,appl_pid,appl_host,appl_owner,eff_psrp_pen);
+       (void)fflush(stderr);
+    }
+
+    psrp_clear_channel_slot(&channel[sic_index]);
+       
+    pups_set_errno(EINVAL);
+    return((psrp_channel_type *)NULL);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Send a request to slaved PSRP client and wait for reply */
+/*---------------------------------------------------------*/
+
+_PUBLIC char *psrp_slaved_client_transaction(const _BOOLEAN          log_reply, // Log reply
+                                             const psrp_channel_type      *sic, // SIC channel
+                                             const char               *request) // Request to send
+
+{   int32_t  ret;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_slaved_client_transaction] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(sic == (const psrp_channel_type *)NULL || request == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((char *)NULL);
+    }
+
+
+    /*--------------*/
+    /* Send request */
+    /*--------------*/
+
+    if((ret = psrp_write_sic(sic,request)) < 0)
+    {  if(ret == (-2) && appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"\n%s %s (%d@%s:%s): attempted SIC transaction with self\n\n",
+                                                date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       pups_set_errno(EINVAL);
+       return((char *)NULL);
+    }
+
+
+    /*------------*/
+    /* Read reply */
+    /*------------*/
+
+    return(psrp_read_sic_reply(log_reply,sic));
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Read (complete) reply to a request from slaved PSRP client  */
+/* (up to and including EOT). If log_reply is TRUE the reply   */
+/* is accumulated and returned (the caller frees it)           */
+/*-------------------------------------------------------------*/
+
+_PRIVATE char *psrp_read_sic_reply(const _BOOLEAN log_reply, const psrp_channel_type *sic)
+
+{   size_t   len,
+             size           = 0;
+
+    int32_t  looper;
+
+    char     tmp_str[512]   = "",
+             *reply         = (char *)NULL,
+             *new_reply     = (char *)NULL;
+
+    do {    (void)psrp_set_current_sic(sic); 
+            if((looper = psrp_read_sic(sic,tmp_str)) == PSRP_MORE)
+            {  
+               if(log_reply == TRUE)
+               {  len = strlen(tmp_str);
+
+                  if((new_reply = (char *)realloc((void *)reply,size + len + 1)) != (char *)NULL)
+                  {  reply = new_reply;
+                     (void)memcpy((void *)&reply[size],(void *)tmp_str,len + 1);
+                     size += len;
+                  }
+               }
+            }
+
+            #ifdef PSRPLIB_DEBUG
+            (void)fprintf(stderr,"PSRPLIB TRANSACTION GOT: \"%s\"\n",tmp_str);
+            (void)fflush(stderr);
+            #endif /* PSRPLIB_DEBUG */
+
+            (void)psrp_unset_current_sic();
+       } while(looper == PSRP_MORE);
+
+    pups_set_errno(OK);
+    return(reply);
+}
+
+ 
+
+
+/*------------------------------------------------*/
+/* Routine to clear a SIC channel descriptor slot */
+/*------------------------------------------------*/
+
+_PRIVATE void psrp_clear_channel_slot(psrp_channel_type *channel)
+
+{   channel->in_stream   = channel->out_stream = (FILE *)NULL;
+
+    (void)strlcpy(channel->in_name,  "",SSIZE);
+    (void)strlcpy(channel->out_name, "",SSIZE);
+    (void)strlcpy(channel->host_name,"",SSIZE);
+    (void)strlcpy(channel->ssh_port, "",SSIZE);
+    (void)strlcpy(channel->pen,      "",SSIZE);
+
+    channel->index       = FREE;
+    channel->scp         = 0;
+    channel->type        = 0;
+    channel->remote      = FALSE;
+}
+
+
+
+
+/*---------------------------------------*/
+/* Destroy slaved PSRP client connection */
+/*---------------------------------------*/
+
+_PUBLIC psrp_channel_type *psrp_destroy_slaved_interaction_client(const psrp_channel_type        *channel,   // SIC to destroy
+                                                                  const _BOOLEAN           channel_client)   // Force slaved client termination
+
+{   char reply[SSIZE] = "";
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_destroy_slaved_interaction_client] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(channel == (const psrp_channel_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((psrp_channel_type *)NULL);
+    }
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+
+       #ifdef SSH_SUPPORT
+       if(channel->remote == TRUE)
+       {  (void)fprintf(stderr,"%s %s (%d@%s:%s): remote (ssh tunnel) SIC [to PSRP client %s@%s] destroyed\n",
+                                 date,appl_name,appl_pid,appl_host,appl_owner,channel->pen,channel->host_name);
+       }
+       else
+       #endif /* SSH_SUPPORT */
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): local (duplex FIFO) SIC [to PSRP client %s] destroyed\n",
+                                                 date,appl_name,appl_pid,appl_host,appl_owner,channel->pen);
+
+       (void)fflush(stderr);
+    }
+
+
+    /*--------------------------------*/
+    /* Destroy the interaction client */ 
+    /*--------------------------------*/
+
+    if(channel_client == TRUE)
+       (void)psrp_write_sic(channel,"quit\n");
+
+    (void)pups_fclose(channel->in_stream); 
+    (void)pups_fclose(channel->out_stream); 
+    (void)unlink(channel->in_name); 
+    (void)unlink(channel->out_name); 
+
+
+    /*-------------------------------*/
+    /* Clear channel descriptor slot */
+    /*-------------------------------*/
+
+    psrp_clear_channel_slot(channel);
+
+
+    /*-------------------------------------------------*/
+    /* If we have run a suid root SIC we might need to */
+    /* re-create /dev/tty                              */
+    /*-------------------------------------------------*/
+
+    if(access("/dev/tty",F_OK | R_OK | W_OK) == (-1))
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): /dev/tty lost - recreating (mktty)\n",
+                                           date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       (void)pups_system("mktty",shell,PUPS_ERROR_EXIT,(int32_t *)NULL);
+    }
+
+    pups_set_errno(OK);
+    return((psrp_channel_type *)NULL);
+}
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Is SIC healthy (slaved client still running and channel intact)? */
+/*-------------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN psrp_sic_alive(const psrp_channel_type *sic)
+
+{   if(sic->index == FREE                  ||
+       sic->in_stream  == (FILE *)NULL      ||
+       sic->out_stream == (FILE *)NULL      ||
+       ferror(sic->in_stream)  != 0         ||
+       ferror(sic->out_stream) != 0          )
+       return(FALSE);
+
+    if(sic->scp > 0 && kill(sic->scp,0) == (-1) && errno == ESRCH)
+       return(FALSE);
+
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Get SIC from pool. If there is an idle (and healthy) SIC to the   */
+/* same slaved client (host, ssh port and PEN) it is re-used,        */
+/* otherwise a new SIC is created (and pooled if there is room).     */
+/* SICs are returned to the pool by psrp_sic_pool_put()              */
+/*-------------------------------------------------------------------*/
+
+_PUBLIC psrp_channel_type *psrp_sic_pool_get(const char *host_name,  // Host to create client on (NULL if local)
+                                             const char *ssh_port,   // Port on client (ignored if no ssh support)
+                                             const char *psrp_pen)   // PEN of client
+
+{   uint32_t          i;
+    int32_t           slot     = (-1);
+    time_t            lru_time = 0;
+
+    char              key_host[SSIZE] = "",
+                      key_port[SSIZE] = "",
+                      key_pen[SSIZE]  = "psrp";
+
+    psrp_channel_type *sic     = (psrp_channel_type *)NULL;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_sic_pool_get] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(host_name != (const char *)NULL)
+       (void)strlcpy(key_host,host_name,SSIZE);
+
+    if(ssh_port != (const char *)NULL)
+       (void)strlcpy(key_port,ssh_port,SSIZE);
+
+    if(psrp_pen != (const char *)NULL)
+       (void)strlcpy(key_pen,psrp_pen,SSIZE);
+
+
+    /*---------------------------------------------------*/
+    /* The pool is also reaped by the sic_pool_homeostat */
+    /* (which runs from SIGALRM) so hold SIGALRM while   */
+    /* we are manipulating it                            */
+    /*---------------------------------------------------*/
+
+    (void)pupsighold(SIGALRM,TRUE);
+    psrp_sic_pool_reap(FALSE);
+
+
+    /*-------------------------------*/
+    /* Look for idle SIC we can reuse */
+    /*-------------------------------*/
+
+    for(i=0; i<PSRP_SIC_POOL_SIZE; ++i)
+    {  if(psrp_sic_pool[i].sic    != (psrp_channel_type *)NULL &&
+          psrp_sic_pool[i].in_use == FALSE                     &&
+          strcmp(psrp_sic_pool[i].host_name,key_host) == 0     &&
+          strcmp(psrp_sic_pool[i].ssh_port, key_port) == 0     &&
+          strcmp(psrp_sic_pool[i].pen,      key_pen)  == 0      )
+       {
+
+          /*------------------------------------------------*/
+          /* Failed health check - discard and keep looking */
+          /*------------------------------------------------*/
+
+          if(psrp_sic_alive(psrp_sic_pool[i].sic) == FALSE)
+          {  if(psrp_sic_pool[i].sic->index != FREE)
+                (void)psrp_destroy_slaved_interaction_client(psrp_sic_pool[i].sic,FALSE);
+             psrp_sic_pool[i].sic = (psrp_channel_type *)NULL;
+
+             continue;
+          }
+
+          psrp_sic_pool[i].in_use    = TRUE;
+          psrp_sic_pool[i].last_used = time((time_t *)NULL);
+          ++psrp_sic_pool[i].reuses;
+
+          (void)pupsigrelse(SIGALRM);
+
+          pups_set_errno(OK);
+          return(psrp_sic_pool[i].sic);
+       }
+    }
+
+
+    /*---------------------------------------------------------------*/
+    /* Create new SIC. If pool is full, evict least recently used    */
+    /* idle SIC (to free both pool slot and SIC channel)             */
+    /*---------------------------------------------------------------*/
+
+    for(i=0; i<PSRP_SIC_POOL_SIZE; ++i)
+    {  if(psrp_sic_pool[i].sic == (psrp_channel_type *)NULL)
+       {  slot = i;
+          break;
+       }
+
+       if(psrp_sic_pool[i].in_use == FALSE && (slot == (-1) || psrp_sic_pool[i].last_used < lru_time))
+       {  slot     = i;
+          lru_time = psrp_sic_pool[i].last_used;
+       }
+    }
+
+    if(slot != (-1) && psrp_sic_pool[slot].sic != (psrp_channel_type *)NULL)
+    {  (void)psrp_destroy_slaved_interaction_client(psrp_sic_pool[slot].sic,TRUE);
+       psrp_sic_pool[slot].sic = (psrp_channel_type *)NULL;
+    }
+
+    (void)pupsigrelse(SIGALRM);
+
+    #ifdef SSH_SUPPORT
+    sic = psrp_create_slaved_interaction_client(host_name,key_port,key_pen);
+    #else
+    sic = psrp_create_slaved_interaction_client(key_pen);
+    #endif /* SSH_SUPPORT */
+
+    if(sic == (psrp_channel_type *)NULL)
+       return((psrp_channel_type *)NULL);
+
+
+    /*--------------------------------------------------*/
+    /* No room in pool - caller gets an unpooled SIC    */
+    /* (which is destroyed when it is put back)         */
+    /*--------------------------------------------------*/
+
+    if(slot == (-1))
+       return(sic);
+
+    (void)pupsighold(SIGALRM,TRUE);
+    (void)strlcpy(psrp_sic_pool[slot].host_name,key_host,SSIZE);
+    (void)strlcpy(psrp_sic_pool[slot].ssh_port, key_port,SSIZE);
+    (void)strlcpy(psrp_sic_pool[slot].pen,      key_pen, SSIZE);
+
+    psrp_sic_pool[slot].sic       = sic;
+    psrp_sic_pool[slot].in_use    = TRUE;
+    psrp_sic_pool[slot].last_used = time((time_t *)NULL);
+    psrp_sic_pool[slot].reuses    = 0;
+    (void)pupsigrelse(SIGALRM);
+
+    pups_set_errno(OK);
+    return(sic);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Return SIC to pool. If it is not healthy (or is not pooled)   */
+/* it is destroyed, otherwise it is kept warm for re-use         */
+/*---------------------------------------------------------------*/
+
+_PUBLIC void psrp_sic_pool_put(psrp_channel_type *sic,      // SIC (from psrp_sic_pool_get)
+                               const _BOOLEAN    healthy)   // FALSE if caller saw channel errors
+
+{   uint32_t i;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_sic_pool_put] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(sic == (psrp_channel_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
+
+
+    /*------------------------------------------*/
+    /* Keep the sic_pool_homeostat out while we */
+    /* are manipulating the pool                */
+    /*------------------------------------------*/
+
+    (void)pupsighold(SIGALRM,TRUE);
+    for(i=0; i<PSRP_SIC_POOL_SIZE; ++i)
+    {  if(psrp_sic_pool[i].sic == sic)
+       {  if(healthy == FALSE || psrp_sic_alive(sic) == FALSE)
+          {  (void)psrp_destroy_slaved_interaction_client(sic,TRUE);
+             psrp_sic_pool[i].sic = (psrp_channel_type *)NULL;
+          }
+          else
+          {  psrp_sic_pool[i].in_use    = FALSE;
+             psrp_sic_pool[i].last_used = time((time_t *)NULL);
+
+
+             /*-------------------------------------------------*/
+             /* Idle SICs are reaped by a virtual timer so they */
+             /* are destroyed even if no more traffic arrives   */
+             /*-------------------------------------------------*/
+
+             if(psrp_sic_pool_timer == FALSE &&
+                pups_setvitimer("sic_pool_homeostat",1,VT_CONTINUOUS,PSRP_SIC_POOL_REAP,NULL,(void *)psrp_sic_pool_homeostat) >= 0)
+                psrp_sic_pool_timer = TRUE;
+          }
+
+          (void)pupsigrelse(SIGALRM);
+
+          pups_set_errno(OK);
+          return;
+       }
+    }
+
+    (void)pupsigrelse(SIGALRM);
+    if(sic->index != FREE)
+       (void)psrp_destroy_slaved_interaction_client(sic,healthy);
+
+    pups_set_errno(OK);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Destroy idle pooled SICs which have not been used for        */
+/* PSRP_SIC_POOL_IDLE seconds (or all idle SICs if force TRUE)  */
+/*--------------------------------------------------------------*/
+
+_PUBLIC void psrp_sic_pool_reap(const _BOOLEAN force)
+
+{   uint32_t i;
+    time_t   now = time((time_t *)NULL);
+
+    for(i=0; i<PSRP_SIC_POOL_SIZE; ++i)
+    {  if(psrp_sic_pool[i].sic != (psrp_channel_type *)NULL && psrp_sic_pool[i].in_use == FALSE)
+       {  if(force == TRUE || now - psrp_sic_pool[i].last_used >= PSRP_SIC_POOL_IDLE)
+          {  (void)psrp_destroy_slaved_interaction_client(psrp_sic_pool[i].sic,TRUE);
+             psrp_sic_pool[i].sic = (psrp_channel_type *)NULL;
+          }
+       }
+    }
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Reap idle pooled SICs (sic_pool_homeostat virtual timer)     */
+/*--------------------------------------------------------------*/
+
+_PRIVATE void psrp_sic_pool_homeostat(char *args)
+
+{   psrp_sic_pool_reap(FALSE);
+}
+
+
+
+
+/*------------------------------------------*/
+/* Assign stdio descriptors for PSRP server */
+/*------------------------------------------*/
+
+_PUBLIC int32_t psrp_assign_stdio(const FILE     *psrp_out,   // PSRP output channel
+                                  const  int32_t     *argc,   // Number of arguments
+                                  const char       *argv[],   // Argument vector
+                                  des_t            *in_des,   // Input descriptor
+                                  des_t           *out_des,   // Output descriptor
+                                  des_t           *err_des)   // Error/status logging descriptor
+
+{    char in_name[SSIZE]  = "",
+          out_name[SSIZE] = "",
+          err_name[SSIZE] = ""; 
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_assign_stdio] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(psrp_out == (const FILE *)   NULL    ||
+       argc     == (const int32_t *)NULL    ||
+       argv     == (const char **)  NULL    ||
+       in_des   == (const int32_t *)NULL    ||
+       out_des  == (const int32_t *)NULL    ||
+       err_des  == (const int32_t *)NULL     )
+    {  pups_set_errno(EINVAL);
+       return(PSRP_STDIO_ERROR);
+    }
+
+    if((ptr = pups_locate(&init,"in",argc,(char **)argv,0)) != NOT_FOUND    ||
+       (ptr = pups_locate(&init,"i", argc,(char **)argv,0)) != NOT_FOUND     )
+    {  if(strccpy(in_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting input file name");
+          (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+
+       if((*in_des = open(in_name,2)) == (-1))
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (input) stream %s could not be opened\n");
+          (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+    }
+    else
+       *in_des = open("/dev/null",2);   
+
+    if((ptr = pups_locate(&init,"out",argc,(char **)argv,0)) != NOT_FOUND    ||
+       (ptr = pups_locate(&init,"o"  ,argc,(char **)argv,0)) != NOT_FOUND     )
+    {  if(strccpy(out_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting output file name");
+          (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+
+       if((*out_des = open(out_name,2)) == (-1))
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (output) stream %s could not be opened\n");
+          (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+    }
+    else
+       *out_des = open("/dev/null",2);   
+
+    if((ptr = pups_locate(&init,"err",argc,(char **)argv,0)) != NOT_FOUND    ||
+       (ptr = pups_locate(&init,"e"  ,argc,(char **)argv,0))  != NOT_FOUND    )
+    {  if(strccpy(err_name,pups_str_dec(&ptr,argc,args)) == (char *)NULL)
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: expecting error (log) file name");
+           (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+ 
+       if((*err_des = open(err_name,2)) == (-1))
+       {  (void)fprintf(psrp_out,"assign_psrp_stdio: (error) stream %s could not be opened\n");
+          (void)fflush(psrp_out);
+
+          pups_set_errno(EINVAL);
+          return(PSRP_STDIO_ERROR);
+       }
+    }
+    else
+       *err_des = open("/dev/null",2);   
+
+    pups_set_errno(OK); 
+    return(PSRP_STDIO_ASSIGNED);
+}
+
+
+
+/*--------------------------------------*/
+/* Assign stdio streams for PSRP server */
+/*--------------------------------------*/
+
+_PUBLIC int32_t psrp_assign_fstdio(const FILE    *psrp_out, // PSRP output channel
+                                   const int32_t     *argc, // Number of arguments
+                                   const char      *argv[], // Argument vector
+                                   FILE         *in_stream, // Input stream
+                                   FILE        *out_stream, // Output stream
+                                   FILE        *err_stream) // Error/logging stream
+
+{    des_t in,
+           out,
+           err,
+           ret; 
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_assign_fstdio] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(psrp_out    == (const FILE *)   NULL    ||
+       argc        == (const int32_t *)NULL    ||
+       argv        == (const char **)  NULL    ||
+       in_stream   == (const FILE *)   NULL    ||
+       out_stream  == (const FILE *)   NULL    ||
+       err_stream  == (const FILE *)   NULL     )
+    {  pups_set_errno(EINVAL);
+       return(PSRP_STDIO_ERROR);
+    }
+
+    ret = psrp_assign_stdio(psrp_out,argc,argv,&in,&out,&err);
+
+    if(ret != PSRP_STDIO_ERROR)
+    {  in_stream  = fdopen(in,"r"),
+       out_stream = fdopen(out,"w"),
+       err_stream = fdopen(err,"w");
+    }
+
+    return(ret);
+}
+
+
+
+
+
+/*---------------------------------------*/
+/* Wait for data on nominated descriptor */
+/*---------------------------------------*/
+
+_PUBLIC int32_t psrp_wait_for_data(const des_t fdes)
+
+{   fd_set readfds,
+           excepfds;
+
+    struct timeval timeout;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_wait_for_data] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(fdes < 0 || fdes >= appl_max_files)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 100;
+
+    FD_ZERO(&readfds);
+    FD_ZERO(&excepfds);
+    FD_SET(fdes,&readfds);
+    FD_SET(fdes,&excepfds);
+
+
+    /*-----------------------------------------------------------*/
+    /* Wait for data to become available on nominated descriptor */
+    /*-----------------------------------------------------------*/
+
+    do {   while(select(1,&readfds,(fd_set *)NULL,(fd_set *)NULL,&timeout) < 0);
+
+
+           /*-------------------------*/
+           /* Invalid file descriptor */
+           /*-------------------------*/
+ 
+           if(errno == EBADF)
+              return(-1);
+
+           timeout.tv_sec  = 0;
+           timeout.tv_usec = 100;
+
+           if(FD_ISSET(0,&readfds))
+           {  pups_set_errno(OK);
+              return(0);
+           }
+
+           FD_SET(0,&readfds);
+           FD_SET(1,&readfds);
+        } while(TRUE);
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*---------------------------------------------*/
+/* Search PSRP handler list for the first slot */
+/*---------------------------------------------*/
+
+_PUBLIC int32_t psrp_get_tag_index(const uint32_t tag_index)
+
+{   uint32_t i;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_get_tag_index] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(tag_index > psrp_object_list_allocated)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    if(psrp_object_list[tag_index].aliases == psrp_object_list[tag_index].aliases_allocated)
+    {  psrp_object_list[tag_index].aliases_allocated += PSRP_ALLOCATION_QUANTUM;
+
+       if(psrp_object_list[tag_index].object_tag == (char **)NULL)
+         psrp_object_list[tag_index].object_tag = (char **)pups_calloc(psrp_object_list[tag_index].aliases_allocated,sizeof(char **));
+      else
+         psrp_object_list[tag_index].object_tag = (char **)pups_realloc((void *)psrp_object_list[tag_index].object_tag,
+                                                                        psrp_object_list[tag_index].aliases_allocated*sizeof(char **));
+
+
+       for(i=psrp_object_list[tag_index].aliases; i<psrp_object_list[tag_index].aliases_allocated; ++i)
+          psrp_object_list[tag_index].object_tag[i] = (char *)NULL;
+
+       ++psrp_object_list[tag_index].aliases; 
+
+       pups_set_errno(OK);
+       return(psrp_object_list[tag_index].aliases - 1);
+    }
+
+    for(i=0; i<psrp_object_list[tag_index].aliases_allocated; ++i)
+    {  if(psrp_object_list[tag_index].object_tag[i] == (char *)NULL)
+       {  ++psrp_object_list[tag_index].aliases;
+
+          pups_set_errno(OK);
+          return(i);
+       }
+    }
+
+    pups_set_errno(ESRCH);
+    return(PSRP_OK);
+}
+
+
+ 
+ 
+/*-----------------------------------------------*/
+/* Free resources allocated to PSRP handler slot */
+/*-----------------------------------------------*/
+
+_PUBLIC int32_t psrp_ifree_tag_list(const uint32_t tag_index)
+
+{   uint32_t i;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_ifree_tag_list] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(tag_index > psrp_object_list_allocated)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    if(psrp_object_list[tag_index].object_handle != (void *)NULL    &&
+       psrp_object_list[tag_index].object_tag    != (void *)NULL     )
+    {   psrp_tag_index_remove_slot(tag_index,0);
+
+        for(i=0; i<psrp_object_list[tag_index].aliases_allocated; ++i)
+        {   if(psrp_object_list[tag_index].object_tag[i] != (char *)NULL)
+               (void)pups_free((void *)psrp_object_list[tag_index].object_tag[i]);
+        }
+ 
+        psrp_object_list[tag_index].object_tag = (char **)NULL; 
+        pups_set_errno(OK);
+
+        return(0);
+    }
+
+    pups_set_errno(ESRCH);
+    return(-1);
+}
+
+
+
+
+
+/*-----------------------------------*/
+/* Search PSRP handler list by index */
+/*-----------------------------------*/
+
+_PUBLIC int32_t psrp_isearch_tag_list(const char *object_tag, const uint32_t tag_index)
+
+{   uint32_t i;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_isearch_tag_list] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(object_tag == (const char *)NULL || tag_index > psrp_object_list_allocated)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    for(i=0; i<psrp_object_list[tag_index].aliases_allocated; ++i)
+    {  if(psrp_object_list[tag_index].object_tag[i] != (char *)NULL       &&
+          strcmp(psrp_object_list[tag_index].object_tag[i],object_tag) == 0)
+       {  pups_set_errno(OK);
+          return(i);
+       }
+    }
+
+    pups_set_errno(ESRCH);
+    return(PSRP_DISPATCH_ERROR);
+}
+
+
+
+/*-------------------------------------------------------------*/
+/* Hash PSRP object tag (FNV-1a). Also used (with a different  */
+/* seed) to compute the builtin perfect hash                   */
+/*-------------------------------------------------------------*/
+
+_PRIVATE uint32_t psrp_hash_tag(const char *object_tag, const uint32_t seed)
+
+{   uint32_t hash = seed;
+
+    for(; *object_tag != '\0'; ++object_tag)
+    {  hash ^= (uint8_t)*object_tag;
+       hash *= 16777619;
+    }
+
+    return(hash);
+}
+
+
+
+
+/*-------------------------------------------------------------------*/
+/* Add tag (or alias) of PSRP object to tag index. The index is a    */
+/* chained hash table which is doubled in size when its load factor  */
+/* exceeds 2. Note that the index holds its own copy of the tag      */
+/*-------------------------------------------------------------------*/
+
+_PRIVATE void psrp_tag_index_insert(const char *object_tag, const uint32_t slot_index, const uint32_t tag_index)
+
+{   uint32_t           i,
+                       hash;
+
+    psrp_tag_hash_type *node  = (psrp_tag_hash_type *)NULL,
+                       *next  = (psrp_tag_hash_type *)NULL,
+                       **old  = (psrp_tag_hash_type **)NULL;
+
+    hash = psrp_hash_tag(object_tag,2166136261U);
+
+
+    /*--------------------------------------------------*/
+    /* Grow (and rehash) index if load factor too large */
+    /*--------------------------------------------------*/
+
+    if(psrp_tag_hash_size == 0 || psrp_tag_hash_entries >= 2*psrp_tag_hash_size)
+    {  uint32_t old_size = psrp_tag_hash_size;
+
+       old                = psrp_tag_hash;
+       psrp_tag_hash_size = (old_size == 0) ? PSRP_TAG_HASH_SIZE : 2*old_size;
+       psrp_tag_hash      = (psrp_tag_hash_type **)pups_calloc(psrp_tag_hash_size,sizeof(psrp_tag_hash_type *));
+
+       for(i=0; i<old_size; ++i)
+       {  for(node = old[i]; node != (psrp_tag_hash_type *)NULL; node = next)
+          {  next                                                  = node->next;
+             node->next                                            = psrp_tag_hash[node->hash & (psrp_tag_hash_size - 1)];
+             psrp_tag_hash[node->hash & (psrp_tag_hash_size - 1)]  = node;
+          }
+       }
+
+       if(old != (psrp_tag_hash_type **)NULL)
+          (void)pups_free((void *)old);
+    }
+
+
+    /*-----------------------------------------*/
+    /* Tag is already indexed (for this slot)  */
+    /*-----------------------------------------*/
+
+    for(node = psrp_tag_hash[hash & (psrp_tag_hash_size - 1)]; node != (psrp_tag_hash_type *)NULL; node = node->next)
+    {  if(node->hash == hash && node->slot_index == slot_index && strcmp(node->tag,object_tag) == 0)
+       {  node->tag_index = tag_index;
+          return;
+       }
+    }
+
+    node             = (psrp_tag_hash_type *)pups_malloc(sizeof(psrp_tag_hash_type));
+    node->hash       = hash;
+    node->slot_index = slot_index;
+    node->tag_index  = tag_index;
+    node->tag        = (char *)pups_malloc(strlen(object_tag) + 1);
+    (void)strcpy(node->tag,object_tag);
+
+    node->next                                          = psrp_tag_hash[hash & (psrp_tag_hash_size - 1)];
+    psrp_tag_hash[hash & (psrp_tag_hash_size - 1)]      = node;
+    ++psrp_tag_hash_entries;
+}
+
+
+
+
+/*-----------------------------------------------*/
+/* Remove tag (of given slot) from tag index     */
+/*-----------------------------------------------*/
+
+_PRIVATE void psrp_tag_index_remove(const char *object_tag, const uint32_t slot_index)
+
+{   uint32_t           hash;
+    psrp_tag_hash_type *node  = (psrp_tag_hash_type *)NULL,
+                       **prev = (psrp_tag_hash_type **)NULL;
+
+    if(psrp_tag_hash_size == 0)
+       return;
+
+    hash = psrp_hash_tag(object_tag,2166136261U);
+
+    for(prev = &psrp_tag_hash[hash & (psrp_tag_hash_size - 1)]; (node = *prev) != (psrp_tag_hash_type *)NULL; prev = &node->next)
+    {  if(node->hash == hash && node->slot_index == slot_index && strcmp(node->tag,object_tag) == 0)
+       {  *prev = node->next;
+
+          (void)pups_free((void *)node->tag);
+          (void)pups_free((void *)node);
+          --psrp_tag_hash_entries;
+
+          return;
+       }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Remove tags of slot from tag index (from tag index onwards -- */
+/* for static objects the root tag is kept)                      */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void psrp_tag_index_remove_slot(const uint32_t slot_index, const uint32_t from_tag_index)
+
+{   uint32_t           i;
+    psrp_tag_hash_type *node  = (psrp_tag_hash_type *)NULL,
+                       **prev = (psrp_tag_hash_type **)NULL;
+
+    for(i=0; i<psrp_tag_hash_size; ++i)
+    {  prev = &psrp_tag_hash[i];
+
+       while((node = *prev) != (psrp_tag_hash_type *)NULL)
+       {  if(node->slot_index == slot_index && node->tag_index >= from_tag_index)
+          {  *prev = node->next;
+
+             (void)pups_free((void *)node->tag);
+             (void)pups_free((void *)node);
+             --psrp_tag_hash_entries;
+          }
+          else
+             prev = &node->next;
+       }
+    }
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Look up attached PSRP object by tag (or alias). If several       */
+/* objects share a tag, the lowest slot wins (as it would for a     */
+/* linear search of the dispatch table)                             */
+/*------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_tag_index_lookup(const char *object_tag)
+
+{   uint32_t           hash;
+    int32_t            slot_index = (-1);
+    psrp_tag_hash_type *node      = (psrp_tag_hash_type *)NULL;
+
+    if(object_tag == (const char *)NULL || psrp_tag_hash_size == 0)
+       return(-1);
+
+    hash = psrp_hash_tag(object_tag,2166136261U);
+
+    for(node = psrp_tag_hash[hash & (psrp_tag_hash_size - 1)]; node != (psrp_tag_hash_type *)NULL; node = node->next)
+    {  if(node->hash == hash                                             &&
+          psrp_object_list[node->slot_index].object_handle != (void *)NULL &&
+          (slot_index == (-1) || node->slot_index < (uint32_t)slot_index)  &&
+          strcmp(node->tag,object_tag) == 0                                 )
+          slot_index = (int32_t)node->slot_index;
+    }
+
+    return(slot_index);
+}
+
+
+
+
+/*--------------------------------*/
+/* Create alias for a PSRP object */
+/*--------------------------------*/
+
+_PUBLIC int32_t psrp_alias(const char *name, const char *alias)
+
+{   uint32_t i;
+    int32_t  alias_index;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_alias] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(name == (const char *)NULL || alias == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    /*-------------------------------------------*/
+    /* Search dispatch table for object to alias */
+    /*-------------------------------------------*/
+
+    for(i=0; i<psrp_object_list_allocated; ++i)
+    {  if(psrp_object_list[i].object_handle != NULL)
+       {
+
+          /*----------------------------------------------------------------*/
+          /* Search for PSRP object tagged with target name (to be aliased) */ 
+          /*----------------------------------------------------------------*/
+
+          if(psrp_isearch_tag_list(name,i) >= 0) 
+          {
+
+             /*---------------------------------*/
+             /* Check that this alias is unique */
+             /*---------------------------------*/
+
+             if(psrp_isearch_tag_list(alias,i) >= 0)
+             {  pups_set_errno(ESRCH);
+                return(PSRP_DISPATCH_ERROR);
+             }
+             else
+             {  alias_index = psrp_get_tag_index(i);
+
+                if(psrp_object_list[i].object_tag[alias_index] == (char *)NULL)
+                   psrp_object_list[i].object_tag[alias_index] = (char *)pups_malloc(SSIZE);
+                (void)strlcpy(psrp_object_list[i].object_tag[alias_index],alias,SSIZE);
+                psrp_tag_index_insert(alias,i,alias_index);
+
+                if(appl_verbose == TRUE)
+                {  (void)fprintf(stderr,"%s %s (%d@%s:%s): %s aliased to %s\n",
+                                                                          date,
+                                                                     appl_name,
+                                                                      appl_pid,
+                                                                     appl_host,
+                                                                    appl_owner,
+                                             psrp_object_list[i].object_tag[0],
+                                                                         alias);
+                   (void)fflush(stderr);
+                }
+
+                pups_set_errno(OK);
+                return(PSRP_OK);
+             }
+          }
+        }   
+     }
+
+     pups_set_errno(ESRCH);
+     return(PSRP_DISPATCH_ERROR);
+}
+
+
+
+
+/*--------------------------*/
+/* Remove PSRP object alias */
+/*--------------------------*/
+ 
+_PUBLIC int32_t psrp_unalias(const char *alias, const char *base_tag_name)
+ 
+{   uint32_t i;
+     int32_t alias_index;
+ 
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_unalias] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(base_tag_name == (const char *)NULL || alias == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+
+    /*---------------------------------------------*/
+    /* Search dispatch table for object to unalias */
+    /*---------------------------------------------*/
+
+    for(i=0; i<psrp_object_list_allocated; ++i)
+    {   if(psrp_object_list[i].object_handle != NULL)
+        {  if((alias_index = psrp_isearch_tag_list(alias,i)) >= 0)
+           {
+
+              /*----------------------------------------------------------*/
+              /* Check that this is not the root alias (the real name) of */
+              /* this object. We cannot remove this as it is used to map  */
+              /* and unmap the object if it a DLL object                  */
+              /*----------------------------------------------------------*/
+
+              if(alias_index == 0)
+              {  pups_set_errno(EPERM);
+                 return(PSRP_TAG_ERROR);
+              }
+
+              if(appl_verbose == TRUE) 
+              {  (void)fprintf(stderr,"%s %s (%d@%s:%s): %s unliased from %s\n",
+                                                                           date,
+                                                                      appl_name,
+                                                                       appl_pid,
+                                                                      appl_host,
+                                                                     appl_owner,
+                                                                          alias,
+                                              psrp_object_list[i].object_tag[0]);
+
+                 (void)fflush(stderr);
+              }
+
+              psrp_tag_index_remove(alias,i);
+              (void)pups_free((void *)psrp_object_list[i].object_tag[alias_index]);
+              psrp_object_list[i].object_tag[alias_index] = (char *)NULL;
+
+              (void)strlcpy(base_tag_name,psrp_object_list[i].object_tag[0],SSIZE);
+              --psrp_object_list[i].aliases;
+
+              pups_set_errno(OK); 
+              return(PSRP_OK);
+           }
+        }
+    }
+      
+    pups_set_errno(ESRCH); 
+    return(PSRP_DISPATCH_ERROR);
+}
+
+
+
+
+/*-----------------------------*/
+/* Display PSRP object aliases */
+/*-----------------------------*/
+ 
+_PUBLIC int32_t psrp_show_aliases(const char *basename)
+ 
+{   uint32_t i,
+             j;
+
+    int32_t  alias_index;
+ 
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_show_aliases] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(basename == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(PSRP_DISPATCH_ERROR);
+    }
+
+    for(i=0; i<psrp_object_list_allocated; ++i)
+    {  if(psrp_object_list[i].object_handle != (void *)NULL)
+       {  alias_index = psrp_isearch_tag_list(basename,i);
+ 
+         if(alias_index >= 0)
+         {  (void)fprintf(psrp_out,"\n\n    Aliases list containing object tag \"%s\"\n\n",basename); 
+            for(j=0; j<psrp_object_list[i].aliases_allocated; ++j)
+               if(psrp_object_list[i].object_tag[j] != (char *)NULL)
+               {  if(j == 0)
+                     (void)fprintf(psrp_out,"%04d:    \"%-32s\" (root tag of PSRP object at %016lx virtual)\n",j,
+                                                                               psrp_object_list[i].object_tag[j],
+                                                            (uint64_t         )psrp_object_list[i].object_handle);
+                  else
+                     (void)fprintf(psrp_out,"%04d:    \"%-32s\"\n",j,psrp_object_list[i].object_tag[j]);
+               }
+                 
+            (void)fprintf(psrp_out,"\n\n");
+            (void)fflush(psrp_out);
+ 
+            pups_set_errno(OK);
+            return(PSRP_OK);
+         }
+       }
+    }
+ 
+    (void)fprintf(psrp_out,"psrp_show_aliases: \"%s\" is not a tag name of any loaded PSRP object\n",basename);       
+    (void)fflush(psrp_out);
+
+    pups_set_errno(ESRCH); 
+    return(PSRP_DISPATCH_ERROR);
+}
+
+
+
+
+/*-------------------------------------------------*/
+/* Check if named PSRP channel is locked by client */
+/*-------------------------------------------------*/
+
+_PUBLIC _BOOLEAN psrp_channel_locked(const FILE *stream, const char *channel_name)
+
+{   struct stat buf;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_channel_locked] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(channel_name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+  
+    if(stat(channel_name,&buf) == (-1))
+    {  pups_set_errno(ENFILE);
+       return(-1);
+    }
+
+    pups_set_errno(OK);
+
+    if(buf.st_nlink > 1)
+       return(TRUE);
+
+    return(FALSE);
+}
+
+
+
+
+
+/*-----------------------------------------------*/
+/* Attach a dynamic databag to PSRP handler list */
+/*-----------------------------------------------*/
+ 
+_PRIVATE int32_t psrp_builtin_attach_dbag(const uint32_t argc, const char *argv[])
+ 
+{   char    databag_file_name[SSIZE] = "",
+            bag_tag[SSIZE]           = "";
+
+    int32_t h_mode; 
+
+    if(strcmp(argv[0],"bag") != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(!(psrp_bind_status & PSRP_DYNAMIC_DATABAG))
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): permission denied (attach dynamic databag)\n\n",
+                                                     date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       (void)fprintf(psrp_out,"\nPermision denied (attach dynamic databag)\n\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+ 
+    if(argc < 2 || argc > 4)
+    {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+    if(argc == 2)
+    {  if(strcmp(argv[1],"LIVE") == 0 || strcmp(argv[1],"DEAD") == 0) 
+       {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
+          (void)fflush(psrp_out);
+          return(PSRP_OK);
+       }
+
+       (void)strlcpy(bag_tag,argv[1],SSIZE);
+       (void)strlcpy(databag_file_name,argv[1],SSIZE);
+    } 
+    else if(argc == 3)
+    {  (void)strlcpy(bag_tag,argv[1],SSIZE);
+
+       if(strcmp(argv[2],"LIVE") == 0)
+       {  h_mode = LIVE;
+          (void)strlcpy(databag_file_name,argv[1],SSIZE);
+       }
+       else if(strcmp(argv[2],"DEAD") == 0)
+       {  h_mode = DEAD;
+          (void)strlcpy(databag_file_name,argv[1],SSIZE);
+       }
+       else
+          (void)strlcpy(databag_file_name,argv[1],SSIZE);
+    }
+    else if(argc == 4)
+    {  (void)strlcpy(bag_tag,argv[1],SSIZE);
+       (void)strlcpy(databag_file_name,argv[2],SSIZE);
+       if(strcmp(argv[3],"LIVE") == 0)
+          h_mode = LIVE;
+       else if(strcmp(argv[3],"DEAD") == 0)
+          h_mode = DEAD;
+       else
+       {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
+          (void)fflush(psrp_out);
+           return(PSRP_OK);
+       }
+
+       (void)strlcpy(databag_file_name,argv[2],SSIZE);
+    }
+ 
+    if(psrp_bind_status & PSRP_DYNAMIC_DATABAG)
+    {  if(psrp_attach_dynamic_databag(TRUE,
+                                      bag_tag,
+                                      databag_file_name,
+                                                 h_mode) == PSRP_DISPATCH_ERROR)
+       {
+ 
+           /*--------------------------------------------------------------------*/
+           /* If we could not find an action matching the clients tag report the */
+           /* error back to the client.                                          */
+           /*--------------------------------------------------------------------*/
+ 
+           (void)fprintf(psrp_out,"\nfailed to attach dynamic databag \"%s\" (from %s) to PSRP handler action list\n\n",
+                                                                                              argv[1],databag_file_name);
+           (void)fflush(psrp_out);
+       }
+       else
+       {  (void)fprintf(psrp_out,"\ndynamic databag \"%s\" bound to PSRP handler action list\n\n");
+          (void)fflush(psrp_out);
+ 
+          (void)strdate(date);
+          if(appl_verbose == TRUE)
+          {  (void)fprintf(stderr,"%s %s (%d@%s:%s): dynamic databag \"%s\" attached to PSRP handler (imported from file %s)\n",
+                                                         date,appl_name,appl_pid,appl_host,appl_owner,argv[1],databag_file_name);
+             (void)fflush(stderr);
+          }
+       }   
+    }   
+
+    return(PSRP_OK);
+}
+
+
+
+
+/*--------------------------------------------------------------*/
+/* Attach a dynamic databag (streamed by client via shared      */
+/* memory ring) to PSRP handler list. If the ring cannot be     */
+/* attached the completion code is "ringerr" and the client     */
+/* falls back to bag                                            */
+/*--------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_attach_ring_dbag(const uint32_t argc, const char *argv[])
+
+{   int32_t        w_pid,
+                   w_des;
+
+    psrp_ring_type *ring = (psrp_ring_type *)NULL;
+
+    if(strcmp(argv[0],"rbag") != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(!(psrp_bind_status & PSRP_DYNAMIC_DATABAG))
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): permission denied (attach dynamic databag)\n\n",
+                                                     date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       (void)fprintf(psrp_out,"\nPermision denied (attach dynamic databag)\n\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+    if(argc != 4 || sscanf(argv[2],"%d",&w_pid) != 1 || sscanf(argv[3],"%d",&w_des) != 1 || w_pid <= 0 || w_des < 0)
+    {  (void)fprintf(psrp_out,"usage: rbag <PSRP dispatch name> <writer pid> <ring fd>\n");
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+
+    /*-------------------------------------------------------*/
+    /* Ring must belong to the client which sent the request */
+    /* (otherwise we could be pointed at any descriptor of   */
+    /* any of our processes)                                 */
+    /*-------------------------------------------------------*/
+
+    if(w_pid != psrp_client_pid[c_client])
+    {  (void)strlcpy(psrp_c_code,"ringerr",SSIZE);
+
+       (void)fprintf(psrp_out,"\nring writer (%d) is not the requesting client for dynamic databag \"%s\"\n\n",w_pid,argv[1]);
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+    if((ring = psrp_ring_attach((pid_t)w_pid,(des_t)w_des)) == (psrp_ring_type *)NULL)
+    {  (void)strlcpy(psrp_c_code,"ringerr",SSIZE);
+
+       (void)fprintf(psrp_out,"\nfailed to attach ring (writer %d, fd %d) for dynamic databag \"%s\"\n\n",w_pid,w_des,argv[1]);
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+    if(psrp_attach_ring_databag(argv[1],ring) == PSRP_DISPATCH_ERROR)
+    {  psrp_ring_close(ring,TRUE);
+       (void)fprintf(psrp_out,"\nfailed to attach dynamic databag \"%s\" (from ring) to PSRP handler action list\n\n",argv[1]);
+       (void)fflush(psrp_out);
+    }
+    else
+    {  (void)fprintf(psrp_out,"\ndynamic databag \"%s\" bound to PSRP handler action list\n\n",argv[1]);
+       (void)fflush(psrp_out);
+    }
+
+    (void)psrp_ring_destroy(ring);
+    return(PSRP_OK);
+}
+
+
+
+
+#ifdef PERSISTENT_HEAP_SUPPORT
+/*-----------------------------------------------------------------------*/
+/* Attach a dynamic function to the dispatch list of the current process */
+/*-----------------------------------------------------------------------*/
+
+
+_PRIVATE int32_t psrp_builtin_attach_persistent_heap(const uint32_t argc, const char *argv[])
+
+{   char    heap_file_name[SSIZE] = "",
+            heap_tag[SSIZE]       = "";
+
+    int32_t h_mode   = DEAD;
+ 
+    if(strcmp(argv[0],"heap") != 0)
+       return(PSRP_DISPATCH_ERROR);
+ 
+    if(!(psrp_bind_status & PSRP_PERSISTENT_HEAP))
+    {   int32_t h_mode;
+
+       (void)strdate(date);
+       (void)fprintf(psrp_out,"Permision denied (attach persistent heap)\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+    if(argc < 2 || argc > 4)
+    {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !<persistent heap file name>! [LIVE | DEAD]\n");
+       (void)fflush(psrp_out); 
+       return(PSRP_OK);
+    }
+
+    if(argc == 2)
+    {  if(strcmp(argv[1],"LIVE") == 0 || strcmp(argv[1],"DEAD") == 0)
+       {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !map mode! [<persistent heap file name>] [LIVE | DEAD]\n");
+          (void)fflush(psrp_out);
+          return(PSRP_OK);
+       }
+
+       (void)strlcpy(heap_tag,argv[1],SSIZE);
+       (void)strlcpy(heap_file_name,argv[1],SSIZE);
+    }    
+    else if(argc == 3)
+    {  (void)strlcpy(heap_tag,argv[1],SSIZE);
+       (void)strlcpy(heap_file_name,argv[2],SSIZE);
+    }
+    else if(argc == 4)
+    {  (void)strlcpy(heap_tag,argv[1],SSIZE);
+       (void)strlcpy(heap_file_name,argv[3],SSIZE);
+
+       if(strcmp(argv[4],"LIVE") == 0)
+          h_mode = LIVE; 
+       else if(strcmp(argv[4],"DEAD") == 0)
+          h_mode = DEAD;
+       else 
+       {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !map mode! [<persistent heap file name>] [LIVE | DEAD]\n");
+          (void)fflush(psrp_out);
+          return(PSRP_OK);
+       }
+    }
+ 
+    (void)psrp_attach_persistent_heap(TRUE,
+                                      heap_tag,
+                                      heap_file_name,
+				      h_mode);
+
+    return(PSRP_OK);
+}
+#endif /* PERSISTENT_HEAP_SUPPORT */
+
+ 
+
+
+#ifdef DLL_SUPPORT
+/*-----------------------------------------------------------------------*/
+/* Attach a dynamic function to the dispatch list of the current process */
+/*-----------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_builtin_attach_dynamic_function(const uint32_t argc, const char *argv[])
+
+{   char object_tag[SSIZE]     = "",
+         object_tag_DLL[SSIZE] = "";
+
+    if(strcmp(argv[0],"dll") != 0)
+       return(PSRP_DISPATCH_ERROR);
+
+    if(!(psrp_bind_status & PSRP_DYNAMIC_FUNCTION))
+    {  if(appl_verbose == TRUE)
+       {  char date[SSIZE] = "";
+
+          (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s): permission denied (attach dynamic function)\n",
+                                                            date,appl_name,appl_pid,appl_host);
+          (void)fflush(stderr);
+       }
+
+       (void)fprintf(stderr,"\nPermission denied (attach dynamic function)\n\n");
+       (void)fflush(stderr); 
+
+       return(PSRP_OK);
+    }
+
+    if(argc < 2 || argc > 3)
+    {  (void)fprintf(psrp_out,"usage: dll <PSRP dispatch name> [<object DLL>]\n");
+       (void)fflush(psrp_out);
+
+       return(PSRP_OK);
+    }
+
+    if(argc == 3)
+    {  (void)strlcpy(object_tag,argv[1],SSIZE);
+       (void)strlcpy(object_tag_DLL,argv[2],SSIZE);
+    }
+    else
+       (void)strlcpy(object_tag_DLL,argv[1],SSIZE);
+
+    if(access(object_tag_DLL,F_OK | R_OK | W_OK) == (-1))
+    {  (void)fprintf(psrp_out,"cannot find DLL \"%s\"\n",object_tag,object_tag_DLL);
+       (void)fflush(psrp_out);
+    }
+    else if(psrp_attach_dynamic_function(TRUE,
+                                         object_tag,
+                                         object_tag_DLL) == (-1))
+    {  (void)fprintf(psrp_out,"error attaching \"%s\" (from DLL \"%s\")\n",object_tag,object_tag_DLL);
+       (void)fflush(psrp_out);
+    }
+    else
+       (void)fprintf(psrp_out,"dynamic function \"%s\" attached (from DLL \"%s\")\n",
+                                                            object_tag,object_tag_DLL);
+    return(PSRP_OK);
+}
+#endif /* DLL_SUPPORT */
+
+
+
+
+/*--------------------------*/
+/* Start new server segmant */
+/*--------------------------*/
+
+#ifdef SSH_SUPPORT
+_PUBLIC int32_t psrp_new_segment (const char *name,             // Name of process
+                                  const char *host_name,        // Name of new host
+                                  const char *ssh_port,         // Ssh port number to use 
+                                  const char *ckpt_file_name)   // CRIU checkpoint associated with process
+#else
+_PUBLIC  int32_t psrp_new_segment(const char *name,             // Name of process
+                                  const char *host_name,        // Name of new host
+                                  const char *ckpt_file_name)   // CRIU checkpoint associated with process
+#endif /* SSH_SUPPORT */
+
+{   pid_t    ssh_pid;
+    sigset_t set;
+
+    char     line[SSIZE]               = "",
+             command_line[SSIZE]       = "",
+             cmd_tail[SSIZE]           = "",
+             p_name[SSIZE]             = "",
+             autoload_file_name[SSIZE] = "",
+             exec_pathname[SSIZE]      = "",
+             ckpt_restart[SSIZE]       = "",
+             errstr[SSIZE]             = "";
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_new_segment] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+ 
+
+    /*----------------------------------------------------------------------------*/
+    /* Make sure that we ignore any yields from (multiple) clients until we have  */
+    /* finished segmentation.                                                     */
+    /*----------------------------------------------------------------------------*/
+
+    in_psrp_new_segment = TRUE;
+
+
+    /*--------------------------------------------------------------------------*/
+    /* Save dispatch table so any aliases defined by this segment are passed to */
+    /* the next.                                                                */
+    /*--------------------------------------------------------------------------*/
+ 
+    if(appl_psrp_save == TRUE)
+    {  
+
+       /*----------------------------------------------------------------*/
+       /* Save the names of those objects which are to be automatically  */
+       /* loaded at the next invocation of this server                   */
+       /*----------------------------------------------------------------*/
+
+       if(getuid() != 0)
+          (void)snprintf(autoload_file_name,SSIZE,"%s/.%s.psrp",appl_home,name);
+       else
+          (void)snprintf(autoload_file_name,SSIZE,"/%s.psrp",name);
+
+       if(appl_verbose == TRUE)
+       {  strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): saving PSRP dispatch table (to [default] PSRP resource file %s)\n",
+                                                     date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
+          (void)fflush(stderr);
+       }
+
+       psrp_save_dispatch_table(autoload_file_name);
+    }
+
+
+    /*-----------------------------------------------------------------------------*/
+    /* Make sure that we don't catch any signals until the new segment of the PSRP */
+    /* server is up and running.                                                   */
+    /*-----------------------------------------------------------------------------*/
+    /*-----------------------------------------------------*/
+    /* Don't raise SIGALRM during the segmentation process */
+    /*-----------------------------------------------------*/
+
+    (void)pups_malarm(0);
+    (void)pups_sighandle(SIGALRM,(char *)NULL,SIG_IGN,(sigset_t *)NULL);
+
+    if(host_name != (char *)NULL)
+    {  (void)pups_sighandle(SIGINIT,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGCHAN,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGPSRP,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGPSRPIO,(char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGALIVE, (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGCHLD,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGINT,   (char *)NULL, SIG_IGN, (sigset_t *)NULL);
+       (void)pups_sighandle(SIGCLIENT,(char *)NULL, SIG_IGN, (sigset_t *)NULL);
+
+
+       /*----------------------------------------------------------*/
+       /* Make sure all PUPS signals are serviced (while ignored)  */
+       /* this stops spurious signals when the next segment starts */
+       /*----------------------------------------------------------*/
+
+       (void)sigemptyset(&set);
+       (void)sigaddset(&set,SIGINIT);
+       (void)sigaddset(&set,SIGCHAN);
+       (void)sigaddset(&set,SIGPSRP);
+       (void)sigaddset(&set,SIGPSRPIO);
+       (void)sigaddset(&set,SIGALIVE);
+       (void)sigaddset(&set,SIGALRM);
+       (void)sigaddset(&set,SIGINT);
+       (void)sigaddset(&set,SIGCHLD);
+       (void)sigaddset(&set,SIGCLIENT);
+
+       (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+    }
+
+
+    /*--------------------------------------------------------*/
+    /* Build command and overlay current process using execls */ 
+    /*--------------------------------------------------------*/
+
+    pups_argtline(cmd_tail);
+
+
+    /*------------------------------------------------------*/
+    /* If the user has specified a name for the new segment */
+    /* make sure that it answers to it!                     */
+    /*------------------------------------------------------*/
+
+    if(name != (char *)NULL)
+       (void)strlcpy(p_name,name,SSIZE);
+    else
+       (void)strlcpy(p_name,appl_name,SSIZE);
+
+
+    /*-------------------------*/
+    /* Expand command pathname */
+    /*-------------------------*/
+
+    if(appl_bin_name != (char *)NULL && strcmp(appl_bin_name,"") != 0)
+    {  char stripped_bin_name[SSIZE] = "";
+
+
+       /*---------------------------------------*/
+       /* Need to strip path leading to binname */
+       /*---------------------------------------*/
+
+       if((char *)rindex(appl_bin_name,'/') != (char *)NULL)
+       {  char tmpstr[SSIZE] = "";
+
+          (void)strlcpy(tmpstr,(char *)rindex(appl_bin_name,'/'),SSIZE);
+          (void)strlcpy(stripped_bin_name,&tmpstr[1],SSIZE);
+       }
+       else
+          (void)strlcpy(stripped_bin_name,appl_bin_name,SSIZE); 
+
+       if(strccpy(exec_pathname,pups_search_path("PATH",stripped_bin_name)) == (char *)NULL)
+       {  pups_set_errno(ENOENT);
+          return(-1);
+       }
+    }
+    else 
+    {  if(strccpy(exec_pathname,pups_search_path("PATH",appl_name)) == (char *)NULL)
+       {  pups_set_errno(ENOENT);
+          return(-1);
+       }
+    }
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB APPL BIN NAME: %s\n",appl_bin_name);
+    (void)fflush(stderr);
+    #endif /* "PSRPLIB_DEBUG */
+
+
+    /*-------------------------------------*/
+    /* We must have absolute command paths */
+    /*-------------------------------------*/
+
+    if(exec_pathname[0] == '.' && exec_pathname[1] == '/')
+    {  char cwd[SSIZE] = "";
+
+       (void)getcwd(cwd,SSIZE);
+       (void)strlcat(cwd,&exec_pathname[1],SSIZE);
+       (void)strlcpy(exec_pathname,cwd,SSIZE);
+    }
+    else if(exec_pathname[0] == '.' && exec_pathname[1] == '.')
+    {  char uwd[SSIZE] = "",
+            cwd[SSIZE] = "";
+
+       (void)getcwd(cwd,SSIZE); 
+       (void)chdir("..");
+       (void)getcwd(uwd,SSIZE);
+       (void)strlcat(uwd,&exec_pathname[2],SSIZE);
+       (void)strlcpy(exec_pathname,uwd,SSIZE);
+       (void)chdir(cwd);
+    }
+
+
+    #ifdef SSH_SUPPORT
+    /*---------------------------------------*/
+    /* Is the new instance on a remote node? */
+    /*---------------------------------------*/
+
+    if(host_name != (char *)NULL && strcmp(host_name,"localhost") != 0)
+    {
+
+       /*-------------------------------------*/
+       /* Build command to start new instance */
+       /*-------------------------------------*/
+
+       (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d %s >& /dev/null",exec_pathname, 
+                                                                                                 p_name,
+                                                                                           ckpt_restart,
+                                                                                         ++psrp_seg_cnt,
+                                                                                               cmd_tail);
+
+
+
+       /*---------------------*/
+       /* Child side of fork */
+       /*---------------------*/
+
+       if((ssh_pid = pups_fork(FALSE,FALSE)) == 0)
+       {  char sshPortOpt[SSIZE] = "";
+
+
+          /*-------------*/
+          /* Close files */
+          /*-------------*/
+
+          (void)pups_closeall();
+
+          (void)close(0);
+          (void)close(1);
+          (void)close(2);
+
+
+          /*---------------------------------*/
+          /* Are we using non-standard port? */
+          /*---------------------------------*/
+
+          if(ssh_port != (char *)NULL && strcmp(ssh_port,"") != 0)
+             (void)snprintf(sshPortOpt,SSIZE,"-p %s",ssh_port);
+          else
+             (void)snprintf(sshPortOpt,SSIZE,"-p %s",ssh_remote_port);
+
+
+          /*--------------------------------------*/
+          /* We are not using passwords. You will */
+          /* need to generate a public/private    */
+          /* keyset for this to work              */
+          /*--------------------------------------*/
+
+          if(ssh_compression == TRUE)
+             (void)execlp("ssh","ssh",sshPortOpt,"-C","-l",ssh_remote_uname,host_name,command_line,(char *)NULL);
+          else
+             (void)execlp("ssh","ssh",sshPortOpt,"-l",     ssh_remote_uname,host_name,command_line,(char *)NULL);
+
+
+          /*---------------------------------------------------------*/
+          /* We should not get here -- if we do an error has occured */
+          /*---------------------------------------------------------*/
+
+          _exit(255);
+       }
+
+       /*---------------------*/
+       /* Parent side of fork */
+       /*---------------------*/
+ 
+       else 
+       {  int32_t status = 0;
+
+
+          /*-----------------------------------------------------*/
+          /* If the remote end of the ssh connection is still    */
+          /* running after 5 seconds  we can assume that command */
+          /* is successfully running on remote server            */
+          /*-----------------------------------------------------*/
+
+          (void)pups_sleep(1);
+
+          #ifdef PSRPLIB_DEBUG
+          (void)fprintf(stderr,"PSRPLIB SSH EXEC WAITPID: %d\n",waitpid(ssh_pid,&status, WNOHANG));
+          (void)fflush(stderr);
+          #endif /* PSRPLIB_DEBUG */
+
+
+          if(waitpid(ssh_pid,&status, WNOHANG) == (-1))
+          {  
+
+             #ifdef PSRPLIB_DEBUG
+             (void)fprintf(stderr,"PSRPLIB SSH EXEC FAILED\n");
+             (void)fflush(stderr);
+             #endif /* PSRPLIB_DEBUG */
+
+             if(appl_verbose == TRUE)
+             {  (void)strdate(date);
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) channel [to host %s] (could not exec ssh)\n",
+                                                                                   date,appl_name,appl_pid,appl_host,appl_owner,host_name);
+                (void)fflush(stderr);
+             }
+
+             (void)pups_malarm(1);
+             in_psrp_new_segment = FALSE;
+             pups_set_errno(ENOEXEC);
+
+             return(-1);
+          }
+          else
+          {
+             #ifdef PSRPLIB_DEBUG
+             (void)fprintf(stderr,"PSRPLIB SSH EXEC GOOD\n");
+             (void)fflush(stderr);
+             #endif /* PSRPLIB_DEBUG */
+
+
+             /*----------------------------------*/
+             /* Delay is a kludge - we have      */
+             /* to make sure command has started */
+             /* at remote end before we stop ssh */
+             /*----------------------------------*/
+
+             (void)pups_sleep(segmentation_delay);
+
+
+             /*----------------------------------*/
+             /* Kill hanging instance of ssh     */
+             /* on local host                    */
+             /*----------------------------------*/
+
+             (void)kill(ssh_pid,SIGTERM);
+          }
+
+          /*----------------------------------------------*/
+          /* Tell clients that a server change is pending */
+          /*----------------------------------------------*/
+
+          (void)psrp_reactivate_clients();
+       }
+
+
+       /*-------------------------------------------------------*/
+       /* If we are segmenting parent effectively must delete   */
+       /* PSRP channels and then create a regular file (whose   */
+       /* name is the same as the input channel) which contains */
+       /* a "trail" to the new location of the server           */
+       /*-------------------------------------------------------*/
+
+
+       #ifdef PSRPLIB_DEBUG
+       (void)fprintf(stderr,"PSRPLIB TERMINATE CURRENT INSTANCE: %d\n",terminate_current_instance);
+       (void)fflush(stderr);
+       #endif /* PSRPLIB_DEBUG */
+
+       if(terminate_current_instance == TRUE)
+       {  char trailfile_name[SSIZE] = "";
+
+
+           #ifdef PSRPLIB_DEBUG
+           (void)fprintf(stderr,"PSRPLIB CREATING TRAILFILE\n");
+           (void)fflush(stderr);
+           #endif /* PSRPLIB_DEBUG */
+
+
+          /*---------------------------------------------------------------*/
+          /* Make sure that remote invocation can read PSRP initialisation */
+          /* file (assuming it can see the same filesystem as exec host)   */
+          /*---------------------------------------------------------------*/
+
+          (void)strlcpy(appl_name,p_name,SSIZE);
+          (void)snprintf(trailfile_name,SSIZE,"%s.trail",channel_name_out);
+          (void)psrp_create_trailfile(trailfile_name,p_name,host_name,ssh_remote_port);
+
+
+           /*--------------------------------------------------*/
+           /* Parent exits leaving trail to its migrated child */
+           /*--------------------------------------------------*/
+
+           pups_exit(0);
+       }
+    }
+    #endif /* SSH_SUPPORT */
+
+    else 
+    {  
+
+       /*-------------------------------------*/
+       /* Build command to start new instance */
+       /*-------------------------------------*/
+
+       if(n_clients > 0)
+       {
+
+          /*------------------------------------------------------------------------------*/
+          /* If we have attached client(s) -- we must arrange for them to be re-awakened  */
+          /* once our child segment is ready to deal with them                            */
+          /*------------------------------------------------------------------------------*/
+
+          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d -psrp_reactivate_client %d %s",
+                                                                                             exec_pathname,
+                                                                                                    p_name,
+                                                                                              ckpt_restart,
+                                                                                            ++psrp_seg_cnt,
+                                                                                                 chlockdes,
+                                                                                                  cmd_tail);
+       }
+       else
+       {
+
+          /*---------------------*/
+          /* No attached clients */
+          /*---------------------*/
+
+          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d",
+	                                                       exec_pathname,
+					                              p_name,
+					                        ckpt_restart,
+						              ++psrp_seg_cnt);
+       }
+ 
+
+       /*--------------------------------------------------*/
+       /* Local segmentation (parent is overlaid by child) */ 
+       /*--------------------------------------------------*/
+
+       if(terminate_current_instance == TRUE)
+       {  
+
+          /*-------------------------------------------------*/
+          /* Make sure PSRP FIFOS are clean for new instance */
+          /*-------------------------------------------------*/
+
+          if(psrp_in != (FILE *)NULL)
+             (void)psrp_empty_fifo(fileno(psrp_in));
+
+          if(psrp_out != (FILE *)NULL)
+             (void)psrp_empty_fifo(fileno(psrp_out));
+
+
+          /*-------------------------------------*/
+          /* Overlay new segment on local process*/
+          /*-------------------------------------*/
+
+          (void)pups_closeall();
+
+
+          /*----------------------------------*/
+          /* PSRP server is changing its name */
+          /*----------------------------------*/
+
+          if(strcmp(appl_name,p_name) != 0 && appl_default_chname == TRUE)
+          {
+
+             /*----------------------------------------------------*/
+             /* If we are changing name we need to rename old PSRP */
+             /* channels and lockposts and tell clients that a     */
+             /* server change is pending                           */
+             /*----------------------------------------------------*/
+
+             if(psrp_rename_channel(p_name) == (-1))
+                return(-1);
+          }
+
+
+          /*---------------------------------*/
+          /* PSRP server is keeping its name */
+          /*---------------------------------*/
+
+          else
+          {
+
+            /*----------------------------------------------*/
+            /* Tell clients that a server change is pending */
+            /*----------------------------------------------*/
+
+            (void)psrp_reactivate_clients();
+          }
+
+          #ifdef PSRPLIB_DEBUG
+          (void)fprintf(stderr,"PSRPLIB EXECLS: %s\n",command_line);
+          (void)fflush(stderr);
+          #endif /* PSRPLIB_DEBUG */
+
+
+          /*-------------------------------------*/
+          /* We should not return from this call */
+          /*-------------------------------------*/
+
+          (void)pups_execls(command_line);
+ 
+          (void)snprintf(errstr,SSIZE,"[psrp_new_segment] exec failure (%s)\n",command_line);
+          pups_error(errstr);
+       }
+       else
+       {   int32_t child_pid = (-1);
+
+
+          /*-------------------------------------*/
+          /* Build command to start new instance */
+          /*-------------------------------------*/
+
+          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d",
+                                                               exec_pathname,
+                                                                      p_name,
+                                                                ckpt_restart,
+                                                              ++psrp_seg_cnt);
+
+          #ifdef PSRPLIB_DEBUG
+          (void)fprintf(stderr,"PSRPLIB NEW INSTANCE COMAMND LINE is: %s\n",command_line);
+          (void)fflush(stderr);
+          #endif /* PSRPLIB_DEBUG */
+
+
+          /*---------------------------------------*/
+          /* Local fork (parent is not terminated) */ 
+          /*---------------------------------------*/
+
+          if((child_pid = pups_fork(FALSE,FALSE)) == 0)
+          {
+
+             /*---------------------------------------*/
+             /* Overlay new segment on local process. */
+             /* and run in new session                */
+             /*---------------------------------------*/
+
+             (void)fclose(stdin);
+             stdin = fopen("/dev/tty","r");
+
+             (void)fclose(stdout);
+             stdout = fopen("/dev/tty","w");
+
+             (void)fclose(stderr);
+             stderr = fopen("/dev/tty","w");
+
+             (void)pups_closeall();
+             (void)setsid();
+
+
+             /*-------------------------------------*/
+             /* We should not return from this call */
+             /*-------------------------------------*/
+
+             (void)pups_execls(command_line);
+
+             (void)snprintf(errstr,SSIZE,"[psrp_new_segment] exec failure (%s)\n",command_line);
+             pups_error(errstr);
+          }
+
+          if(appl_verbose == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): new instance \"%s\" (%d@%s:%s) created\n",
+                           date,appl_name,appl_pid,appl_host,appl_owner,name,child_pid,appl_host,appl_owner);
+             (void)fflush(stderr);
+          }
+
+          (void)pups_malarm(1);
+          in_psrp_new_segment = FALSE;
+
+          pups_set_errno(OK);
+          return(0);
+       }
+    }
+
+    (void)pups_malarm(1);
+    in_psrp_new_segment = FALSE;
+
+
+    /*-----------------------------------------------*/
+    /* No error if current instance is still running */
+    /*-----------------------------------------------*/
+
+    if(terminate_current_instance == FALSE)
+       return(0);
+    else
+       pups_set_errno(ENOEXEC);
+
+    return(-1);
+}
+
+
+
+
+/*-----------------------------------------------*/
+/* Send end of operation (return code) to client */
+/* this is the psrp service return code          */
+/*-----------------------------------------------*/
+
+_PRIVATE void psrp_endop(char *op_tag)
+
+{   
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"PSRPLIB ENDOP BEGIN %s\n",op_tag);
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+
+    if(op_tag == (char *)NULL)
+       (void)fprintf(psrp_out,"EOP\n");
+    else
+       (void)fprintf(psrp_out,"EOP %s\n",op_tag); 
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,""PSRPLIB ENDOP FLUSH %s\n",op_tag);
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+
+    (void)fflush(psrp_out);
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,""PSRPLIB ENDOP: %s written\n",op_tag);
+    (void)fflush(stderr);
+    #endif /* DEBUG */
+
+}
+
+
+
+
+/*----------------------------------------------*/
+/* Return number of clients connected to server */
+/*----------------------------------------------*/
+
+_PRIVATE int32_t psrp_connected_clients(void)
+
+{    int32_t i,
+             cnt = 0;
+
+
+    /*----------------------------*/
+    /* Search for client in table */
+    /*----------------------------*/
+
+    if(n_clients > 0)
+    {  for(i=0; i<MAX_CLIENTS; ++i)
+          if(psrp_client_pid[i] != (-1))
+             ++cnt;
+    }
+
+    return(cnt);
+}
+
+
+
+
+/*---------------------------------------------------------------------------*/
+/* Get current client index - if the current client pid is in the channel    */
+/* table, return the corresponding index, if it isn't, and the channel table */
+/* is not full return a new index, otherwise return error (ENOCH)            */
+/*---------------------------------------------------------------------------*/
+
+_PRIVATE int32_t psrp_get_client_slot(pid_t pid)
+
+{   uint32_t i;
+
+
+    /*----------------------------*/
+    /* Search for client in table */
+    /*----------------------------*/
+
+    if(n_clients > 0)
+    {  for(i=0; i<MAX_CLIENTS; ++i)
+          if(psrp_client_pid[i] == pid)
+             return(i);
+    }
+
+
+    /*---------------------------*/ 
+    /* Find unused slot in table */
+    /*---------------------------*/ 
+
+    for(i=0; i<MAX_CLIENTS; ++i)
+    {  if(psrp_client_pid[i] == (-1))
+       {  ++n_clients;
+          return(i);
+       }
+    }
+
+    /*---------------------------*/
+    /* Table full - return error */
+    /*---------------------------*/
+
+    return(ENOCH);
 }
 
 
 
 
+/*--------------------------------------------*/
+/* Clear current client entry in client table */
+/*--------------------------------------------*/
 
-/*-----------------------------------------------*/
-/* Attach a dynamic databag to PSRP handler list */
-/*-----------------------------------------------*/
- 
-_PRIVATE int32_t psrp_builtin_attach_dbag(const uint32_t argc, const char *argv[])
- 
-{   char    databag_file_name[SSIZE] = "",
-            bag_tag[SSIZE]           = "";
-
-    int32_t h_mode; 
-
-    if(strcmp(argv[0],"bag") != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PRIVATE int32_t psrp_clear_client_slot(int32_t slot_index)
 
-    if(!(psrp_bind_status & PSRP_DYNAMIC_DATABAG))
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): permission denied (attach dynamic databag)\n\n",
-                                                     date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
-       }
+{
+   #ifdef PTHREAD_SUPPORT
+   sigset_t old_set;
+   #endif /* PTHREAD_SUPPORT */
 
-       (void)fprintf(psrp_out,"\nPermision denied (attach dynamic databag)\n\n");
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
-    }
- 
-    if(argc < 2 || argc > 4)
-    {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
-    }
+   if(slot_index < 0 || slot_index > MAX_CLIENTS)
+      return(-1);
 
-    if(argc == 2)
-    {  if(strcmp(argv[1],"LIVE") == 0 || strcmp(argv[1],"DEAD") == 0) 
-       {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
-          (void)fflush(psrp_out);
-          return(PSRP_OK);
-       }
+   if(psrp_client_pid[slot_index] > 0)
+      (void)pups_pid_unwatch(psrp_client_pid[slot_index]);
 
-       (void)strlcpy(bag_tag,argv[1],SSIZE);
-       (void)strlcpy(databag_file_name,argv[1],SSIZE);
-    } 
-    else if(argc == 3)
-    {  (void)strlcpy(bag_tag,argv[1],SSIZE);
+   #ifdef PTHREAD_SUPPORT
+   psrp_sock_lock(&old_set);
+   #endif /* PTHREAD_SUPPORT */
 
-       if(strcmp(argv[2],"LIVE") == 0)
-       {  h_mode = LIVE;
-          (void)strlcpy(databag_file_name,argv[1],SSIZE);
-       }
-       else if(strcmp(argv[2],"DEAD") == 0)
-       {  h_mode = DEAD;
-          (void)strlcpy(databag_file_name,argv[1],SSIZE);
-       }
-       else
-          (void)strlcpy(databag_file_name,argv[1],SSIZE);
-    }
-    else if(argc == 4)
-    {  (void)strlcpy(bag_tag,argv[1],SSIZE);
-       (void)strlcpy(databag_file_name,argv[2],SSIZE);
-       if(strcmp(argv[3],"LIVE") == 0)
-          h_mode = LIVE;
-       else if(strcmp(argv[3],"DEAD") == 0)
-          h_mode = DEAD;
-       else
-       {  (void)fprintf(psrp_out,"usage: bag <PSRP dispatch name> [<databag file name>] [LIVE | DEAD]\n");
-          (void)fflush(psrp_out);
-           return(PSRP_OK);
-       }
+   psrp_client_exitf[slot_index] = (void *)NULL;
+   psrp_client_pid[slot_index]   = (-1);
+   req_r_cnt[slot_index]         = 0;
+   
+   (void)strlcpy(psrp_client_name[slot_index],    "none",SSIZE);
+   (void)strlcpy(psrp_client_efname[slot_index],  "none",SSIZE);
+   (void)strlcpy(psrp_client_host[slot_index],    "none",SSIZE);
+   (void)strlcpy(old_request_str[slot_index],     "",SSIZE);
+   (void)strlcpy(psrp_remote_hostpath[slot_index],"notset",SSIZE);
 
-       (void)strlcpy(databag_file_name,argv[2],SSIZE);
-    }
- 
-    if(psrp_bind_status & PSRP_DYNAMIC_DATABAG)
-    {  if(psrp_attach_dynamic_databag(TRUE,
-                                      bag_tag,
-                                      databag_file_name,
-                                                 h_mode) == PSRP_DISPATCH_ERROR)
-       {
- 
-           /*--------------------------------------------------------------------*/
-           /* If we could not find an action matching the clients tag report the */
-           /* error back to the client.                                          */
-           /*--------------------------------------------------------------------*/
- 
-           (void)fprintf(psrp_out,"\nfailed to attach dynamic databag \"%s\" (from %s) to PSRP handler action list\n\n",
-                                                                                              argv[1],databag_file_name);
-           (void)fflush(psrp_out);
-       }
-       else
-       {  (void)fprintf(psrp_out,"\ndynamic databag \"%s\" bound to PSRP handler action list\n\n");
-          (void)fflush(psrp_out);
- 
-          (void)strdate(date);
-          if(appl_verbose == TRUE)
-          {  (void)fprintf(stderr,"%s %s (%d@%s:%s): dynamic databag \"%s\" attached to PSRP handler (imported from file %s)\n",
-                                                         date,appl_name,appl_pid,appl_host,appl_owner,argv[1],databag_file_name);
-             (void)fflush(stderr);
-          }
-       }   
-    }   
+   #ifdef PTHREAD_SUPPORT
+   psrp_sock_unlock(&old_set);
+   #endif /* PTHREAD_SUPPORT */
 
-    return(PSRP_OK);
+   --n_clients;
+   return(0);
 }
 
 
 
 
-#ifdef PERSISTENT_HEAP_SUPPORT
-/*-----------------------------------------------------------------------*/
-/* Attach a dynamic function to the dispatch list of the current process */
-/*-----------------------------------------------------------------------*/
-
+/*---------------------------------------*/
+/* Show clients connected to this server */
+/*---------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_attach_persistent_heap(const uint32_t argc, const char *argv[])
+_PRIVATE  int32_t psrp_show_clients(void)
 
-{   char    heap_file_name[SSIZE] = "",
-            heap_tag[SSIZE]       = "";
+{   uint32_t i;
 
-    int32_t h_mode   = DEAD;
- 
-    if(strcmp(argv[0],"heap") != 0)
-       return(PSRP_DISPATCH_ERROR);
- 
-    if(!(psrp_bind_status & PSRP_PERSISTENT_HEAP))
-    {   int32_t h_mode;
+    (void)fprintf(psrp_out,"\n\n    Clients attached to %s (%d@%s)\n\n",appl_name,appl_pid,appl_host);
+    (void)fflush(psrp_out);
 
-       (void)strdate(date);
-       (void)fprintf(psrp_out,"Permision denied (attach persistent heap)\n");
-       (void)fflush(psrp_out);
+    for(i=0; i<MAX_CLIENTS; ++i)
+    {  if(psrp_client_pid[i] > 0)
+       {  (void)fprintf(psrp_out,"    %d: %s (%d@%s)",i,psrp_client_name[i],psrp_client_pid[i],psrp_client_host[i]);
 
-       return(PSRP_OK);
-    }
+          if(psrp_client_pid[i] == psrp_client_pid[c_client])
+             (void)fprintf(psrp_out,"    [*** me, your client]");
 
-    if(argc < 2 || argc > 4)
-    {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !<persistent heap file name>! [LIVE | DEAD]\n");
-       (void)fflush(psrp_out); 
-       return(PSRP_OK);
-    }
+          if(strcmp(psrp_remote_hostpath[i],"notset") != 0)
+             (void)fprintf(psrp_out,"    [from %s]",psrp_remote_hostpath[i]);
 
-    if(argc == 2)
-    {  if(strcmp(argv[1],"LIVE") == 0 || strcmp(argv[1],"DEAD") == 0)
-       {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !map mode! [<persistent heap file name>] [LIVE | DEAD]\n");
+          if((void *)psrp_client_exitf[i] != (void *)NULL)
+             (void)fprintf(psrp_out,"    (exit function \"%032s\" installed at %016lx virtual)",
+                                                                          psrp_client_efname[i],
+                                                        (uint64_t         )psrp_client_exitf[i]);
+    
+          (void)fprintf(psrp_out,"\n");
           (void)fflush(psrp_out);
-          return(PSRP_OK);
-       }
-
-       (void)strlcpy(heap_tag,argv[1],SSIZE);
-       (void)strlcpy(heap_file_name,argv[1],SSIZE);
-    }    
-    else if(argc == 3)
-    {  (void)strlcpy(heap_tag,argv[1],SSIZE);
-       (void)strlcpy(heap_file_name,argv[2],SSIZE);
+        }
     }
-    else if(argc == 4)
-    {  (void)strlcpy(heap_tag,argv[1],SSIZE);
-       (void)strlcpy(heap_file_name,argv[3],SSIZE);
 
-       if(strcmp(argv[4],"LIVE") == 0)
-          h_mode = LIVE; 
-       else if(strcmp(argv[4],"DEAD") == 0)
-          h_mode = DEAD;
-       else 
-       {  (void)fprintf(psrp_out,"usage: heap <PSRP dispatch name> !map mode! [<persistent heap file name>] [LIVE | DEAD]\n");
-          (void)fflush(psrp_out);
-          return(PSRP_OK);
-       }
-    }
- 
-    (void)psrp_attach_persistent_heap(TRUE,
-                                      heap_tag,
-                                      heap_file_name,
-				      h_mode);
+    (void)fprintf(psrp_out,"\n\n    Total of %d client(s) currently attached to server\n\n",n_clients);
+    (void)fflush(psrp_out);
 
-    return(PSRP_OK);
+    return(0);
 }
-#endif /* PERSISTENT_HEAP_SUPPORT */
 
- 
 
 
-#ifdef DLL_SUPPORT
-/*-----------------------------------------------------------------------*/
-/* Attach a dynamic function to the dispatch list of the current process */
-/*-----------------------------------------------------------------------*/
+/*--------------------------------------------*/
+/* Read reply over slaved PSRP client channel */
+/*--------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_attach_dynamic_function(const uint32_t argc, const char *argv[])
+_PUBLIC int32_t psrp_read_sic(const psrp_channel_type *sic, char *reply)
 
-{   char object_tag[SSIZE]     = "",
-         object_tag_DLL[SSIZE] = "";
+{   
 
-    if(strcmp(argv[0],"dll") != 0)
-       return(PSRP_DISPATCH_ERROR);
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    if(!(psrp_bind_status & PSRP_DYNAMIC_FUNCTION))
-    {  if(appl_verbose == TRUE)
-       {  char date[SSIZE] = "";
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"IN READ SIC\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
 
-          (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s): permission denied (attach dynamic function)\n",
-                                                            date,appl_name,appl_pid,appl_host);
-          (void)fflush(stderr);
-       }
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_read_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(reply == (char *)NULL || sic == (const psrp_channel_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"CAN READ SIC\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
+
+
+    /*---------------------------------------------------*/
+    /* Buffer in which reply is accumulated MUST be NULL */
+    /* as we are going to dynamically allocate it. The   */
+    /* caller is responsible for freeing up the memory   */
+    /* used                                              */
+    /*---------------------------------------------------*/
+    /*-----------------------------------------------*/
+    /* Read data from channel until we get an EOT or */
+    /* other error condition                         */
+    /*-----------------------------------------------*/
+
+    (void)fgets(reply,255,sic->out_stream);
+
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"READ SIC (reply is \"%s\")\n",reply);
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
 
-       (void)fprintf(stderr,"\nPermission denied (attach dynamic function)\n\n");
-       (void)fflush(stderr); 
 
-       return(PSRP_OK);
+    /*---------------------------------------------*/
+    /* Check for error conditions                  */
+    /* EOG - end of current PSRP transaction group */
+    /*---------------------------------------------*/
+
+    if(strncmp(reply,"EOT",3) == 0)
+    {  pups_set_errno(OK);
+       return(PSRP_EOT);
     }
 
-    if(argc < 2 || argc > 3)
-    {  (void)fprintf(psrp_out,"usage: dll <PSRP dispatch name> [<object DLL>]\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
+    /*-------------------------------------------------*/
+    /* CST - remote peer has terminated (unexpectedly) */
+    /*-------------------------------------------------*/
 
-    if(argc == 3)
-    {  (void)strlcpy(object_tag,argv[1],SSIZE);
-       (void)strlcpy(object_tag_DLL,argv[2],SSIZE);
+    if(strncmp(reply,"CST",3) == 0)
+    {  pups_set_errno(EEXIST);
+       return(PSRP_TERMINATED);
     }
-    else
-       (void)strlcpy(object_tag_DLL,argv[1],SSIZE);
 
-    if(access(object_tag_DLL,F_OK | R_OK | W_OK) == (-1))
-    {  (void)fprintf(psrp_out,"cannot find DLL \"%s\"\n",object_tag,object_tag_DLL);
-       (void)fflush(psrp_out);
-    }
-    else if(psrp_attach_dynamic_function(TRUE,
-                                         object_tag,
-                                         object_tag_DLL) == (-1))
-    {  (void)fprintf(psrp_out,"error attaching \"%s\" (from DLL \"%s\")\n",object_tag,object_tag_DLL);
-       (void)fflush(psrp_out);
-    }
-    else
-       (void)fprintf(psrp_out,"dynamic function \"%s\" attached (from DLL \"%s\")\n",
-                                                            object_tag,object_tag_DLL);
-    return(PSRP_OK);
-}
-#endif /* DLL_SUPPORT */
+    #ifdef PSRPLIB_DEBUG
+    (void)fprintf(stderr,"READ SIC: OK\n");
+    (void)fflush(stderr);
+    #endif /* PSRPLIB_DEBUG */
 
+    pups_set_errno(OK);
+    return(PSRP_MORE);
+}
 
 
 
-/*--------------------------*/
-/* Start new server segmant */
-/*--------------------------*/
 
-#ifdef SSH_SUPPORT
-_PUBLIC int32_t psrp_new_segment (const char *name,             // Name of process
-                                  const char *host_name,        // Name of new host
-                                  const char *ssh_port,         // Ssh port number to use 
-                                  const char *ckpt_file_name)   // CRIU checkpoint associated with process
-#else
-_PUBLIC  int32_t psrp_new_segment(const char *name,             // Name of process
-                                  const char *host_name,        // Name of new host
-                                  const char *ckpt_file_name)   // CRIU checkpoint associated with process
-#endif /* SSH_SUPPORT */
+/*-----------------------------------------*/
+/* Send request over slaved client channel */
+/*-----------------------------------------*/
 
-{   pid_t    ssh_pid;
-    sigset_t set;
+_PUBLIC  int32_t psrp_write_sic(const psrp_channel_type *sic, const char *request)
 
-    char     line[SSIZE]               = "",
-             command_line[SSIZE]       = "",
-             cmd_tail[SSIZE]           = "",
-             p_name[SSIZE]             = "",
-             autoload_file_name[SSIZE] = "",
-             exec_pathname[SSIZE]      = "",
-             ckpt_restart[SSIZE]       = "",
-             errstr[SSIZE]             = "";
+{   char toxic_1[SSIZE] = "",
+         toxic_2[SSIZE] = "",
+         toxic_3[SSIZE] = "";
 
 
     /*----------------------------------*/
@@ -9581,1852 +15167,1800 @@ _PUBLIC  int32_t psrp_new_segment(const char *name,             // Name of proce
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_new_segment] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       pups_error("[psrp_write_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(name == (const char *)NULL)
+    if(sic == (const psrp_channel_type *)NULL || request == (const char *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
- 
 
-    /*----------------------------------------------------------------------------*/
-    /* Make sure that we ignore any yields from (multiple) clients until we have  */
-    /* finished segmentation.                                                     */
-    /*----------------------------------------------------------------------------*/
 
-    in_psrp_new_segment = TRUE;
+    /*----------------------------*/
+    /* Check that channel is open */
+    /*----------------------------*/
 
+    (void)snprintf(toxic_1,SSIZE,"%s",                    appl_name);
+    (void)snprintf(toxic_2,SSIZE,"%s@localhost",appl_name,appl_host);
+    (void)snprintf(toxic_2,SSIZE,"%s@%s",       appl_name,appl_host);
 
-    /*--------------------------------------------------------------------------*/
-    /* Save dispatch table so any aliases defined by this segment are passed to */
-    /* the next.                                                                */
-    /*--------------------------------------------------------------------------*/
- 
-    if(appl_psrp_save == TRUE)
-    {  
 
-       /*----------------------------------------------------------------*/
-       /* Save the names of those objects which are to be automatically  */
-       /* loaded at the next invocation of this server                   */
-       /*----------------------------------------------------------------*/
+    /*--------------------------------------------------------*/
+    /* Self interaction via SIC is very toxic -- don't do it! */
+    /*--------------------------------------------------------*/
 
-       if(getuid() != 0)
-          (void)snprintf(autoload_file_name,SSIZE,"%s/.%s.psrp",appl_home,name);
-       else
-          (void)snprintf(autoload_file_name,SSIZE,"/%s.psrp",name);
+    if(strin(request,toxic_1) == TRUE || strin(request,toxic_2) == TRUE)
+    {   int32_t ret;
+       char     reply[SSIZE] = "";
 
-       if(appl_verbose == TRUE)
-       {  strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): saving PSRP dispatch table (to [default] PSRP resource file %s)\n",
-                                                     date,appl_name,appl_pid,appl_host,appl_owner,autoload_file_name);
-          (void)fflush(stderr);
-       }
+       (void)fputs("end\n",sic->in_stream);
+       (void)fflush(sic->in_stream);
 
-       psrp_save_dispatch_table(autoload_file_name);
-    }
 
+       /*------------*/
+       /* Read reply */
+       /*------------*/
 
-    /*-----------------------------------------------------------------------------*/
-    /* Make sure that we don't catch any signals until the new segment of the PSRP */
-    /* server is up and running.                                                   */
-    /*-----------------------------------------------------------------------------*/
-    /*-----------------------------------------------------*/
-    /* Don't raise SIGALRM during the segmentation process */
-    /*-----------------------------------------------------*/
+       do {    if((ret = psrp_read_sic(sic,reply)) == PSRP_MORE)
+               {  (void)fputs(reply,psrp_out);
+                  (void)fflush(psrp_out);
+               }
+          } while(ret == PSRP_MORE);
 
-    (void)pups_malarm(0);
-    (void)pups_sighandle(SIGALRM,(char *)NULL,SIG_IGN,(sigset_t *)NULL);
+       pups_set_errno(EINVAL);
+       return(-2);
+    }
 
-    if(host_name != (char *)NULL)
-    {  (void)pups_sighandle(SIGINIT,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGCHAN,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGPSRP,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGALIVE, (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGCHLD,  (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGINT,   (char *)NULL, SIG_IGN, (sigset_t *)NULL);
-       (void)pups_sighandle(SIGCLIENT,(char *)NULL, SIG_IGN, (sigset_t *)NULL);
 
+    /*--------------*/
+    /* Send request */
+    /*--------------*/
 
-       /*----------------------------------------------------------*/
-       /* Make sure all PUPS signals are serviced (while ignored)  */
-       /* this stops spurious signals when the next segment starts */
-       /*----------------------------------------------------------*/
+    if(strin(request,"\n") == FALSE)
+       (void)strlcat(request,"\n",SSIZE);
 
-       (void)sigemptyset(&set);
-       (void)sigaddset(&set,SIGINIT);
-       (void)sigaddset(&set,SIGCHAN);
-       (void)sigaddset(&set,SIGPSRP);
-       (void)sigaddset(&set,SIGALIVE);
-       (void)sigaddset(&set,SIGALRM);
-       (void)sigaddset(&set,SIGINT);
-       (void)sigaddset(&set,SIGCHLD);
-       (void)sigaddset(&set,SIGCLIENT);
+    (void)fputs(request,sic->in_stream);
+    (void)fflush(sic->in_stream);
 
-       (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-    }
+    pups_set_errno(OK);
+    return(0);
+}
 
 
-    /*--------------------------------------------------------*/
-    /* Build command and overlay current process using execls */ 
-    /*--------------------------------------------------------*/
 
-    pups_argtline(cmd_tail);
 
 
-    /*------------------------------------------------------*/
-    /* If the user has specified a name for the new segment */
-    /* make sure that it answers to it!                     */
-    /*------------------------------------------------------*/
+/*----------------------------------------*/
+/* Set current PSRP slaved client channel */
+/*----------------------------------------*/
 
-    if(name != (char *)NULL)
-       (void)strlcpy(p_name,name,SSIZE);
-    else
-       (void)strlcpy(p_name,appl_name,SSIZE);
+_PUBLIC int32_t psrp_set_current_sic(const psrp_channel_type *sic)
 
+{
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    /*-------------------------*/
-    /* Expand command pathname */
-    /*-------------------------*/
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_set_current_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(appl_bin_name != (char *)NULL && strcmp(appl_bin_name,"") != 0)
-    {  char stripped_bin_name[SSIZE] = "";
+    if(sic == (const psrp_channel_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
+    psrp_current_sic = sic;
+    pups_set_errno(OK);
 
-       /*---------------------------------------*/
-       /* Need to strip path leading to binname */
-       /*---------------------------------------*/
+    return(0);
+}
 
-       if((char *)rindex(appl_bin_name,'/') != (char *)NULL)
-       {  char tmpstr[SSIZE] = "";
 
-          (void)strlcpy(tmpstr,(char *)rindex(appl_bin_name,'/'),SSIZE);
-          (void)strlcpy(stripped_bin_name,&tmpstr[1],SSIZE);
-       }
-       else
-          (void)strlcpy(stripped_bin_name,appl_bin_name,SSIZE); 
 
-       if(strccpy(exec_pathname,pups_search_path("PATH",stripped_bin_name)) == (char *)NULL)
-       {  pups_set_errno(ENOENT);
-          return(-1);
-       }
-    }
-    else 
-    {  if(strccpy(exec_pathname,pups_search_path("PATH",appl_name)) == (char *)NULL)
-       {  pups_set_errno(ENOENT);
-          return(-1);
-       }
-    }
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB APPL BIN NAME: %s\n",appl_bin_name);
-    (void)fflush(stderr);
-    #endif /* "PSRPLIB_DEBUG */
+/*----------------------------------------*/
+/* Unset current PSRP interaction channel */
+/*----------------------------------------*/
 
+_PUBLIC void psrp_unset_current_sic(void)
 
-    /*-------------------------------------*/
-    /* We must have absolute command paths */
-    /*-------------------------------------*/
+{
 
-    if(exec_pathname[0] == '.' && exec_pathname[1] == '/')
-    {  char cwd[SSIZE] = "";
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-       (void)getcwd(cwd,SSIZE);
-       (void)strlcat(cwd,&exec_pathname[1],SSIZE);
-       (void)strlcpy(exec_pathname,cwd,SSIZE);
-    }
-    else if(exec_pathname[0] == '.' && exec_pathname[1] == '.')
-    {  char uwd[SSIZE] = "",
-            cwd[SSIZE] = "";
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_unset_current_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-       (void)getcwd(cwd,SSIZE); 
-       (void)chdir("..");
-       (void)getcwd(uwd,SSIZE);
-       (void)strlcat(uwd,&exec_pathname[2],SSIZE);
-       (void)strlcpy(exec_pathname,uwd,SSIZE);
-       (void)chdir(cwd);
-    }
+    psrp_current_sic = (psrp_channel_type *)NULL;
+}
 
 
-    #ifdef SSH_SUPPORT
-    /*---------------------------------------*/
-    /* Is the new instance on a remote node? */
-    /*---------------------------------------*/
 
-    if(host_name != (char *)NULL && strcmp(host_name,"localhost") != 0)
-    {
 
-       /*-------------------------------------*/
-       /* Build command to start new instance */
-       /*-------------------------------------*/
+/*--------------------------------------*/
+/* Send interrupt to slaved PSRP client */
+/*--------------------------------------*/
 
-       (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d %s >& /dev/null",exec_pathname, 
-                                                                                                 p_name,
-                                                                                           ckpt_restart,
-                                                                                         ++psrp_seg_cnt,
-                                                                                               cmd_tail);
+_PUBLIC void psrp_int_sic(const psrp_channel_type *sic)
 
+{   char pidname[SSIZE] = "";
 
 
-       /*---------------------*/
-       /* Child side of fork */
-       /*---------------------*/
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-       if((ssh_pid = pups_fork(FALSE,FALSE)) == 0)
-       {  char sshPortOpt[SSIZE] = "";
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("attempt by non root thread to perform PUPS/P3 PSRP operation (psrp_int_sic)");
 
+    if(sic == (const psrp_channel_type *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
 
-          /*-------------*/
-          /* Close files */
-          /*-------------*/
+    (void)snprintf(pidname,SSIZE,"%d",sic->scp);
+    (void)pups_rkill(sic->host_name,
+                     sic->ssh_port,
+                     appl_owner,
+                     pidname,
+                     SIGINT);
 
-          (void)pups_closeall();
+    pups_set_errno(OK);
+}
 
-          (void)close(0);
-          (void)close(1);
-          (void)close(2);
 
 
-          /*---------------------------------*/
-          /* Are we using non-standard port? */
-          /*---------------------------------*/
 
-          if(ssh_port != (char *)NULL && strcmp(ssh_port,"") != 0)
-             (void)snprintf(sshPortOpt,SSIZE,"-p %s",ssh_port);
-          else
-             (void)snprintf(sshPortOpt,SSIZE,"-p %s",ssh_remote_port);
+/*---------------------------------------*/
+/* Install exit function for PSRP client */
+/*---------------------------------------*/
 
+_PUBLIC int32_t psrp_set_client_exitf(const uint32_t chid, const char *fname,  int32_t (*func)(int32_t))
 
-          /*--------------------------------------*/
-          /* We are not using passwords. You will */
-          /* need to generate a public/private    */
-          /* keyset for this to work              */
-          /*--------------------------------------*/
+{
 
-          if(ssh_compression == TRUE)
-             (void)execlp("ssh","ssh",sshPortOpt,"-C","-l",ssh_remote_uname,host_name,command_line,(char *)NULL);
-          else
-             (void)execlp("ssh","ssh",sshPortOpt,"-l",     ssh_remote_uname,host_name,command_line,(char *)NULL);
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_set_client_exitf] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-          /*---------------------------------------------------------*/
-          /* We should not get here -- if we do an error has occured */
-          /*---------------------------------------------------------*/
+    if(chid > MAX_CLIENTS || fname == (const char *)NULL || (void *)func == (void *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-          _exit(255);
-       }
+    (void)strlcpy(psrp_client_efname[chid],fname,SSIZE);
+    psrp_client_exitf[chid] = (void *)func;
 
-       /*---------------------*/
-       /* Parent side of fork */
-       /*---------------------*/
- 
-       else 
-       {  int32_t status = 0;
+    pups_set_errno(OK);
+    return(0);
+}
 
 
-          /*-----------------------------------------------------*/
-          /* If the remote end of the ssh connection is still    */
-          /* running after 5 seconds  we can assume that command */
-          /* is successfully running on remote server            */
-          /*-----------------------------------------------------*/
 
-          (void)pups_sleep(1);
 
-          #ifdef PSRPLIB_DEBUG
-          (void)fprintf(stderr,"PSRPLIB SSH EXEC WAITPID: %d\n",waitpid(ssh_pid,&status, WNOHANG));
-          (void)fflush(stderr);
-          #endif /* PSRPLIB_DEBUG */
+/*----------------------------------------*/
+/* Remove exit function for a PSRP client */ 
+/*----------------------------------------*/
 
+_PUBLIC int32_t psrp_reset_client_exitf(const uint32_t chid)
 
-          if(waitpid(ssh_pid,&status, WNOHANG) == (-1))
-          {  
+{
 
-             #ifdef PSRPLIB_DEBUG
-             (void)fprintf(stderr,"PSRPLIB SSH EXEC FAILED\n");
-             (void)fflush(stderr);
-             #endif /* PSRPLIB_DEBUG */
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-             if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to create remote (ssh tunnel) channel [to host %s] (could not exec ssh)\n",
-                                                                                   date,appl_name,appl_pid,appl_host,appl_owner,host_name);
-                (void)fflush(stderr);
-             }
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_reset_client_exitf] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-             (void)pups_malarm(1);
-             in_psrp_new_segment = FALSE;
-             pups_set_errno(ENOEXEC);
+    if(chid > MAX_CLIENTS)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-             return(-1);
-          }
-          else
-          {
-             #ifdef PSRPLIB_DEBUG
-             (void)fprintf(stderr,"PSRPLIB SSH EXEC GOOD\n");
-             (void)fflush(stderr);
-             #endif /* PSRPLIB_DEBUG */
+    (void)strlcpy(psrp_client_efname[chid],"",SSIZE);
+    psrp_client_exitf[chid] = (void *)NULL;
 
+    pups_set_errno(OK);
+    return(0);
+}
 
-             /*----------------------------------*/
-             /* Delay is a kludge - we have      */
-             /* to make sure command has started */
-             /* at remote end before we stop ssh */
-             /*----------------------------------*/
 
-             (void)pups_sleep(segmentation_delay);
 
 
-             /*----------------------------------*/
-             /* Kill hanging instance of ssh     */
-             /* on local host                    */
-             /*----------------------------------*/
+/*------------------------------------------------*/
+/* Overlay the current process with a new comamnd */
+/*------------------------------------------------*/
 
-             (void)kill(ssh_pid,SIGTERM);
-          }
+_PRIVATE int32_t psrp_builtin_overlay_server_process(const uint32_t argc, const char *argv[])
 
-          /*----------------------------------------------*/
-          /* Tell clients that a server change is pending */
-          /*----------------------------------------------*/
+{   uint32_t i;
 
-          (void)psrp_reactivate_clients();
-       }
+    char overlay_command_name[SSIZE] = "",
+         overlay_command_tail[SSIZE] = "";
 
+    if(strcmp(argv[0],"overlay") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-       /*-------------------------------------------------------*/
-       /* If we are segmenting parent effectively must delete   */
-       /* PSRP channels and then create a regular file (whose   */
-       /* name is the same as the input channel) which contains */
-       /* a "trail" to the new location of the server           */
-       /*-------------------------------------------------------*/
+    if(argc < 2)
+    {  (void)fprintf(psrp_out,"usage: overlay <command to overlay>\n");
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
-       #ifdef PSRPLIB_DEBUG
-       (void)fprintf(stderr,"PSRPLIB TERMINATE CURRENT INSTANCE: %d\n",terminate_current_instance);
-       (void)fflush(stderr);
-       #endif /* PSRPLIB_DEBUG */
 
-       if(terminate_current_instance == TRUE)
-       {  char trailfile_name[SSIZE] = "";
+    /*--------------------------*/
+    /* Build command to overlay */
+    /*--------------------------*/
 
+    (void)strlcpy(overlay_command_tail,"",SSIZE);
+    for(i=1; i<argc; ++i)
+    {   if(i == 1)
+           (void)strlcpy(overlay_command_name,argv[1],SSIZE);
+        else
+        {  (void)strlcat(overlay_command_tail,argv[i],SSIZE);
 
-           #ifdef PSRPLIB_DEBUG
-           (void)fprintf(stderr,"PSRPLIB CREATING TRAILFILE\n");
-           (void)fflush(stderr);
-           #endif /* PSRPLIB_DEBUG */
+           if(i < argc - 1)
+              (void)strlcat(overlay_command_tail," ",SSIZE);
+        }
+    }
 
+    (void)psrp_overlay_server_process(FALSE,overlay_command_name,overlay_command_tail);
 
-          /*---------------------------------------------------------------*/
-          /* Make sure that remote invocation can read PSRP initialisation */
-          /* file (assuming it can see the same filesystem as exec host)   */
-          /*---------------------------------------------------------------*/
 
-          (void)strlcpy(appl_name,p_name,SSIZE);
-          (void)snprintf(trailfile_name,SSIZE,"%s.trail",channel_name_out);
-          (void)psrp_create_trailfile(trailfile_name,p_name,host_name,ssh_remote_port);
+    /*---------------------------*/
+    /* We should not get here if */
+    /* overlay is successful     */
+    /*---------------------------*/
 
+    (void)fprintf(psrp_out,"\nfailed to overlay PSRP server (%s) [with command %s]\n\n",appl_name,overlay_command_name);
+    (void)fflush(psrp_out);
 
-           /*--------------------------------------------------*/
-           /* Parent exits leaving trail to its migrated child */
-           /*--------------------------------------------------*/
+    return(PSRP_OK);
+}
 
-           pups_exit(0);
-       }
-    }
-    #endif /* SSH_SUPPORT */
 
-    else 
-    {  
 
-       /*-------------------------------------*/
-       /* Build command to start new instance */
-       /*-------------------------------------*/
 
-       if(n_clients > 0)
-       {
+/*------------------------------------------------*/
+/* Overlay the current process with a new command */
+/*------------------------------------------------*/
 
-          /*------------------------------------------------------------------------------*/
-          /* If we have attached client(s) -- we must arrange for them to be re-awakened  */
-          /* once our child segment is ready to deal with them                            */
-          /*------------------------------------------------------------------------------*/
+_PRIVATE int32_t psrp_builtin_overfork_server_process(const uint32_t argc, const char *argv[])
 
-          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d -psrp_reactivate_client %d %s",
-                                                                                             exec_pathname,
-                                                                                                    p_name,
-                                                                                              ckpt_restart,
-                                                                                            ++psrp_seg_cnt,
-                                                                                                 chlockdes,
-                                                                                                  cmd_tail);
-       }
-       else
-       {
+{   uint32_t i;
+    int32_t  ret;
 
-          /*---------------------*/
-          /* No attached clients */
-          /*---------------------*/
+    char overlay_command_name[SSIZE] = "",
+         overlay_command_tail[SSIZE] = "";
 
-          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d",
-	                                                       exec_pathname,
-					                              p_name,
-					                        ckpt_restart,
-						              ++psrp_seg_cnt);
-       }
- 
+    if(strcmp(argv[0],"overfork") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-       /*--------------------------------------------------*/
-       /* Local segmentation (parent is overlaid by child) */ 
-       /*--------------------------------------------------*/
+    if(argc < 2)
+    {  (void)fprintf(psrp_out,"\nusage: overfork <command to fork>\n\n");
+       (void)fflush(psrp_out);
 
-       if(terminate_current_instance == TRUE)
-       {  
+       return(PSRP_OK);
+    }
 
-          /*-------------------------------------------------*/
-          /* Make sure PSRP FIFOS are clean for new instance */
-          /*-------------------------------------------------*/
 
-          if(psrp_in != (FILE *)NULL)
-             (void)psrp_empty_fifo(fileno(psrp_in));
+    /*---------------------------*/
+    /* Build command to overfork */
+    /*---------------------------*/
 
-          if(psrp_out != (FILE *)NULL)
-             (void)psrp_empty_fifo(fileno(psrp_out));
+    (void)strlcpy(overlay_command_tail,"",SSIZE);
+    for(i=1; i<argc; ++i)
+    {   if(i == 1)
+           (void)strlcpy(overlay_command_name,argv[1],SSIZE);
+        else
+        {  (void)strlcat(overlay_command_tail,argv[i],SSIZE);
 
+           if(i < argc - 1)
+              (void)strlcat(overlay_command_tail," ",SSIZE);
+        }
+    }
 
-          /*-------------------------------------*/
-          /* Overlay new segment on local process*/
-          /*-------------------------------------*/
+    if(psrp_overlay_server_process(TRUE,overlay_command_name,overlay_command_tail) < 0)
+       (void)fprintf(psrp_out,"\noverfork  PSRP server (%s) [with command %s] failed - resuming execution\n\n",
+                                                                                 appl_name,overlay_command_name);
+    else
+       (void)fprintf(psrp_out,"\noverfork  PSRP server (%s) [with command %s] finished - resuming execution\n\n",
+                                                                                   appl_name,overlay_command_name);
+    (void)fflush(psrp_out);
 
-          (void)pups_closeall();
+    return(PSRP_OK);
+}
 
 
-          /*----------------------------------*/
-          /* PSRP server is changing its name */
-          /*----------------------------------*/
 
-          if(strcmp(appl_name,p_name) != 0 && appl_default_chname == TRUE)
-          {
 
-             /*----------------------------------------------------*/
-             /* If we are changing name we need to rename old PSRP */
-             /* channels and lockposts and tell clients that a     */
-             /* server change is pending                           */
-             /*----------------------------------------------------*/
+/*----------------------------------------------------*/
+/* Overlay PSRP server process with specified command */
+/*----------------------------------------------------*/
 
-             if(psrp_rename_channel(p_name) == (-1))
-                return(-1);
-          }
+_PUBLIC int32_t psrp_overlay_server_process(const _BOOLEAN over_fork, const char *command_name, const char *command_tail)
 
+{   char command_path[SSIZE]      = "",
+         command_tail_path[SSIZE] = "";
 
-          /*---------------------------------*/
-          /* PSRP server is keeping its name */
-          /*---------------------------------*/
 
-          else
-          {
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-            /*----------------------------------------------*/
-            /* Tell clients that a server change is pending */
-            /*----------------------------------------------*/
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_overlay_server_process] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-            (void)psrp_reactivate_clients();
-          }
 
-          #ifdef PSRPLIB_DEBUG
-          (void)fprintf(stderr,"PSRPLIB EXECLS: %s\n",command_line);
-          (void)fflush(stderr);
-          #endif /* PSRPLIB_DEBUG */
+    if(command_name == (const char *)NULL || command_tail == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
 
-          /*-------------------------------------*/
-          /* We should not return from this call */
-          /*-------------------------------------*/
+    /*------------------------------------------------------*/
+    /* This command should not return (if it is successful) */
+    /*------------------------------------------------------*/
 
-          (void)pups_execls(command_line);
- 
-          (void)snprintf(errstr,SSIZE,"[psrp_new_segment] exec failure (%s)\n",command_line);
-          pups_error(errstr);
-       }
+    if(strccpy(command_path,pups_search_path("PATH",command_name)) != (char *)NULL)
+    {  if(command_tail != (char *)NULL)
+          (void)snprintf(command_tail_path,SSIZE,"%s %s",command_path,command_tail);
        else
-       {   int32_t child_pid = (-1);
+          (void)strlcpy(command_tail_path,command_path,SSIZE);
 
 
-          /*-------------------------------------*/
-          /* Build command to start new instance */
-          /*-------------------------------------*/
+       /*---------------------------------------------*/
+       /* Make sure this operation is not interrupted */
+       /* by PUPS signal handlers                     */
+       /*---------------------------------------------*/
 
-          (void)snprintf(command_line,SSIZE,"%s -pen %s %s -psrp_segment %d",
-                                                               exec_pathname,
-                                                                      p_name,
-                                                                ckpt_restart,
-                                                              ++psrp_seg_cnt);
+       (void)pups_malarm(0);
+       (void)pupshold(PSRP_SIGS);
 
-          #ifdef PSRPLIB_DEBUG
-          (void)fprintf(stderr,"PSRPLIB NEW INSTANCE COMAMND LINE is: %s\n",command_line);
-          (void)fflush(stderr);
-          #endif /* PSRPLIB_DEBUG */
+       if(over_fork == TRUE)
+       {  int32_t status;
 
+          char channel_wait_in[SSIZE]  = "",
+               channel_wait_out[SSIZE] = "";
 
-          /*---------------------------------------*/
-          /* Local fork (parent is not terminated) */ 
-          /*---------------------------------------*/
+          overforking = TRUE;
 
-          if((child_pid = pups_fork(FALSE,FALSE)) == 0)
-          {
 
-             /*---------------------------------------*/
-             /* Overlay new segment on local process. */
-             /* and run in new session                */
-             /*---------------------------------------*/
+          /*-----------------------------*/
+          /* Child (overforking process) */
+          /*-----------------------------*/
 
-             (void)fclose(stdin);
-             stdin = fopen("/dev/tty","r");
+          if((overforked_child_pid = pups_fork(FALSE,FALSE)) == 0)
+          {  (void)pups_execls(command_tail_path);
 
-             (void)fclose(stdout);
-             stdout = fopen("/dev/tty","w");
+             if(appl_verbose == TRUE)
+             {  (void)strdate(date);
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to overfork command (%s) - resuming execution\n",
+                                                      date,appl_name,appl_pid,appl_host,appl_owner,command_name);
+                (void)fflush(stderr);
+             }
+             exit(255);
+          }
 
-             (void)fclose(stderr);
-             stderr = fopen("/dev/tty","w");
 
-             (void)pups_closeall();
-             (void)setsid();
+          /*----------------------*/
+          /* Parent (psrp server) */
+          /*----------------------*/
 
+          (void)snprintf(channel_wait_in,SSIZE,"%s.wait",channel_name_in);
+          (void)rename(channel_name_in,channel_wait_in);
+          (void)snprintf(channel_wait_out,SSIZE,"%s.wait",channel_name_out);
+          (void)rename(channel_name_out,channel_wait_out);
 
-             /*-------------------------------------*/
-             /* We should not return from this call */
-             /*-------------------------------------*/
 
-             (void)pups_execls(command_line);
+          /*-----------------------------*/
+          /* Wait for child to terminate */
+          /*-----------------------------*/
 
-             (void)snprintf(errstr,SSIZE,"[psrp_new_segment] exec failure (%s)\n",command_line);
-             pups_error(errstr);
-          }
+          (void)pupswaitpid(TRUE,overforked_child_pid,&status);
+
+          overforking          = FALSE;
+          overforked_child_pid = (-1);
+
+          (void)rename(channel_wait_in, channel_name_in);
+          (void)rename(channel_wait_out,channel_name_out);
 
           if(appl_verbose == TRUE)
           {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): new instance \"%s\" (%d@%s:%s) created\n",
-                           date,appl_name,appl_pid,appl_host,appl_owner,name,child_pid,appl_host,appl_owner);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): overforked command (%s) has terminated - resuming execution\n",
+                                                          date,appl_name,appl_pid,appl_host,appl_owner,command_name);
              (void)fflush(stderr);
           }
-
-          (void)pups_malarm(1);
-          in_psrp_new_segment = FALSE;
-
-          pups_set_errno(OK);
-          return(0);
        }
-    }
-
-    (void)pups_malarm(1);
-    in_psrp_new_segment = FALSE;
+       else if(command_tail_path[0] != ' ')
+       {  
 
+          /*-----------------*/
+          /* Reply to client */
+          /*-----------------*/
 
-    /*-----------------------------------------------*/
-    /* No error if current instance is still running */
-    /*-----------------------------------------------*/
+          (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
+          (void)fflush(psrp_out);
 
-    if(terminate_current_instance == FALSE)
-       return(0);
-    else
-       pups_set_errno(ENOEXEC);
 
-    return(-1);
-}
+          /*------------------------------------------------------*/
+          /* Tell client that we have finished processing SIGPSRP */
+          /*------------------------------------------------------*/
 
+          psrp_endop("psrp");       
 
 
+          /*----------------------------------------*/
+          /* Close channel to existing PSRP command */
+          /*----------------------------------------*/
 
-/*-----------------------------------------------*/
-/* Send end of operation (return code) to client */
-/* this is the psrp service return code          */
-/*-----------------------------------------------*/
+          pups_exit(PUPS_DEFER_EXIT); 
 
-_PRIVATE void psrp_endop(char *op_tag)
 
-{   
+          /*----------------------------------------*/
+          /* Overlay new command on current process */
+          /*----------------------------------------*/
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"PSRPLIB ENDOP BEGIN %s\n",op_tag);
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+          (void)pups_execls(command_tail_path);
 
-    if(op_tag == (char *)NULL)
-       (void)fprintf(psrp_out,"EOP\n");
-    else
-       (void)fprintf(psrp_out,"EOP %s\n",op_tag); 
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,""PSRPLIB ENDOP FLUSH %s\n",op_tag);
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+          /*----------------------------------------------------------*/
+          /* We should not get here -- if overlay has been successful */
+          /*----------------------------------------------------------*/
 
-    (void)fflush(psrp_out);
+          (void)pups_malarm(1);
+          pupsrelse(PSRP_SIGS);
+          pups_set_errno(ENOEXEC);
+          return(-1);
+       }
+       else
+       {  (void)pups_malarm(1);
+          pupsrelse(PSRP_SIGS);
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,""PSRPLIB ENDOP: %s written\n",op_tag);
-    (void)fflush(stderr);
-    #endif /* DEBUG */
+          pups_set_errno(ENOEXEC);
+          return(-1);
+       }
+
+       (void)pups_malarm(1);
+       pupsrelse(PSRP_SIGS);
+    }
 
+    pups_set_errno(OK);
+    return(0);
 }
 
 
 
 
-/*----------------------------------------------*/
-/* Return number of clients connected to server */
-/*----------------------------------------------*/
+/*-----------------------------*/
+/* Set size of PUPS file table */
+/*-----------------------------*/
 
-_PRIVATE int32_t psrp_connected_clients(void)
 
-{    int32_t i,
-             cnt = 0;
+_PRIVATE int32_t psrp_builtin_extend_ftab(const uint32_t argc, const char *argv[])
 
+{   uint32_t i,
+             n_files;
 
-    /*----------------------------*/
-    /* Search for client in table */
-    /*----------------------------*/
+    if(strcmp(argv[0],"ftab") != 0)
+       return(PSRP_DISPATCH_ERROR);
+   
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: files [<maximum number of PUPS file table slots>]\n\n");
+       (void)fflush(psrp_out);
 
-    if(n_clients > 0)
-    {  for(i=0; i<MAX_CLIENTS; ++i)
-          if(psrp_client_pid[i] != (-1))
-             ++cnt;
+       return(PSRP_OK);
     }
 
-    return(cnt);
-}
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n%d PUPS file table slots available for PSRP server \"%s\"\n\n",
+                                                                        appl_max_files,appl_name);
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
+    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_files) != 1)
+    {  (void)fprintf(psrp_out,"\nExpecting maximum number of files (in PUPS file table)\n\n");
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
-/*---------------------------------------------------------------------------*/
-/* Get current client index - if the current client pid is in the channel    */
-/* table, return the corresponding index, if it isn't, and the channel table */
-/* is not full return a new index, otherwise return error (ENOCH)            */
-/*---------------------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_MUTEX */
 
-_PRIVATE int32_t psrp_get_client_slot(pid_t pid)
+    if(n_files < appl_max_files || strcmp(argv[1],"shrink") == 0)
+    {
 
-{   uint32_t i;
+       /*---------------------------------------------*/
+       /* Find the high water mark for the file table */
+       /*---------------------------------------------*/
 
+       for(i=appl_max_files-1; i>0; --i)
+       {  if(ftab[i].fdes != (-1))
+          {  uint32_t j;
 
-    /*----------------------------*/
-    /* Search for client in table */
-    /*----------------------------*/
 
-    if(n_clients > 0)
-    {  for(i=0; i<MAX_CLIENTS; ++i)
-          if(psrp_client_pid[i] == pid)
-             return(i);
-    }
+             /*-----------------------------------------------------*/
+             /* We have found the high water mark return all memory */
+             /* above it to this processes free pool                */
+             /*-----------------------------------------------------*/
 
+             for(j=i; j<appl_max_files; ++j)
+                (void)pups_clear_ftab_slot(TRUE,j);
+             appl_max_files = i + 1;
+             ftab = (ftab_type *)pups_realloc((void *)ftab,appl_max_files*sizeof(ftab_type));
 
-    /*---------------------------*/ 
-    /* Find unused slot in table */
-    /*---------------------------*/ 
+             (void)fprintf(psrp_out,"\n%d PUPS file table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                                 appl_max_files,appl_name); 
+             (void)fflush(psrp_out);
 
-    for(i=0; i<MAX_CLIENTS; ++i)
-    {  if(psrp_client_pid[i] == (-1))
-       {  ++n_clients;
-          return(i);
+             #ifdef PTHREAD_SUPPORT
+             (void)pthread_mutex_unlock(&ftab_mutex);
+             #endif /* PTHREAD_MUTEX */
+
+             return(PSRP_OK);
+          }
        }
-    }
 
-    /*---------------------------*/
-    /* Table full - return error */
-    /*---------------------------*/
+       (void)fprintf(psrp_out,"\n%d PUPS file table slots allocated for PSRP server (unchanged)\"%s\"\n\n",
+                                                                                   appl_max_files,appl_name); 
+       (void)fflush(psrp_out);
 
-    return(ENOCH);
-}
 
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&ftab_mutex);
+       #endif /* PTHREAD_MUTEX */
 
+       return(PSRP_OK);
+    }
 
+    ftab = (ftab_type *)pups_realloc((void *)ftab,n_files*sizeof(ftab_type));
+    for(i=appl_max_files; i<n_files; ++i)
+        (void)pups_clear_ftab_slot(FALSE,i);
+    appl_max_files = n_files;
 
-/*--------------------------------------------*/
-/* Clear current client entry in client table */
-/*--------------------------------------------*/
 
-_PRIVATE int32_t psrp_clear_client_slot(int32_t slot_index)
+    (void)fprintf(psrp_out,"\n%d PUPS file table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                        appl_max_files,appl_name);
+    (void)fflush(psrp_out); 
 
-{  if(slot_index < 0 || slot_index > MAX_CLIENTS)
-      return(-1);
 
-   psrp_client_exitf[slot_index] = (void *)NULL;
-   psrp_client_pid[slot_index]   = (-1);
-   req_r_cnt[slot_index]         = 0;
-   
-   (void)strlcpy(psrp_client_name[slot_index],    "none",SSIZE);
-   (void)strlcpy(psrp_client_efname[slot_index],  "none",SSIZE);
-   (void)strlcpy(psrp_client_host[slot_index],    "none",SSIZE);
-   (void)strlcpy(old_request_str[slot_index],     "",SSIZE);
-   (void)strlcpy(psrp_remote_hostpath[slot_index],"notset",SSIZE);
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_MUTEX */
 
-   --n_clients;
-   return(0);
+    return(PSRP_OK);
 }
 
 
 
 
-/*---------------------------------------*/
-/* Show clients connected to this server */
-/*---------------------------------------*/
+/*--------------------------------------*/
+/* Set size of PUPS virtual timer table */
+/*--------------------------------------*/
 
-_PRIVATE  int32_t psrp_show_clients(void)
+_PRIVATE int32_t psrp_builtin_extend_vitab(const uint32_t argc, const char *argv[])
 
-{   uint32_t i;
+{   uint32_t i,
+             n_vtimers;
 
-    (void)fprintf(psrp_out,"\n\n    Clients attached to %s (%d@%s)\n\n",appl_name,appl_pid,appl_host);
-    (void)fflush(psrp_out);
+    if(strcmp(argv[0],"vitab") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    for(i=0; i<MAX_CLIENTS; ++i)
-    {  if(psrp_client_pid[i] > 0)
-       {  (void)fprintf(psrp_out,"    %d: %s (%d@%s)",i,psrp_client_name[i],psrp_client_pid[i],psrp_client_host[i]);
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: vitab [<maximum number of PUPS virtual timer table slots>]\n\n");
+       (void)fflush(psrp_out);
 
-          if(psrp_client_pid[i] == psrp_client_pid[c_client])
-             (void)fprintf(psrp_out,"    [*** me, your client]");
+       return(PSRP_OK);
+    }
 
-          if(strcmp(psrp_remote_hostpath[i],"notset") != 0)
-             (void)fprintf(psrp_out,"    [from %s]",psrp_remote_hostpath[i]);
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots available for PSRP server \"%s\"\n\n",
+                                                                              appl_max_vtimers,appl_name);
+       (void)fflush(psrp_out);
 
-          if((void *)psrp_client_exitf[i] != (void *)NULL)
-             (void)fprintf(psrp_out,"    (exit function \"%032s\" installed at %016lx virtual)",
-                                                                          psrp_client_efname[i],
-                                                        (uint64_t         )psrp_client_exitf[i]);
-    
-          (void)fprintf(psrp_out,"\n");
-          (void)fflush(psrp_out);
-        }
+       return(PSRP_OK);
     }
 
-    (void)fprintf(psrp_out,"\n\n    Total of %d client(s) currently attached to server\n\n",n_clients);
-    (void)fflush(psrp_out);
+    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_vtimers) != 1)
+    {  (void)fprintf(psrp_out,"\nExpecting maximum number of timers (in PUPS virtual timer table)\n\n");
+       (void)fflush(psrp_out);
 
-    return(0);
-}
+       return(PSRP_OK);
+    }
 
+    if(n_vtimers < appl_max_vtimers || strcmp(argv[1],"shrink") == 0)
+    {
 
+       /*------------------------------------------------------*/
+       /* Find the high water mark for the virtual timer table */
+       /*------------------------------------------------------*/
 
-/*--------------------------------------------*/
-/* Read reply over slaved PSRP client channel */
-/*--------------------------------------------*/
+       for(i=appl_max_vtimers-1; i>0; --i)
+       {  if(vttab[i].interval_time != (-1))
+          {  uint32_t j;
 
-_PUBLIC int32_t psrp_read_sic(const psrp_channel_type *sic, char *reply)
 
-{   
+             /*-----------------------------------------------------*/
+             /* We have found the high water mark return all memory */
+             /* above it to this processes free pool                */
+             /*-----------------------------------------------------*/
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+             for(j=i; j<appl_max_vtimers; ++j)
+                (void)pups_clear_vitimer(j);
+             appl_max_vtimers = i + 1;
+             vttab = (vttab_type *)pups_realloc((void *)vttab,appl_max_vtimers*sizeof(vttab_type));
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"IN READ SIC\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+             (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                                        appl_max_vtimers,appl_name);
+             (void)fflush(psrp_out);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_read_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
+             return(PSRP_OK);
+          }
+       }
 
-    if(reply == (char *)NULL || sic == (const psrp_channel_type *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+       (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
+                                                                                          appl_max_vtimers,appl_name);
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
     }
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"CAN READ SIC\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
+    vttab = (vttab_type *)pups_realloc((void *)vttab,n_vtimers*sizeof(vttab_type));
+    for(i=appl_max_vtimers; i<n_vtimers; ++i)
+        (void)pups_clear_vitimer(i);
+    appl_max_vtimers = n_vtimers;
 
+    (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                               appl_max_vtimers,appl_name);
+    (void)fflush(psrp_out);
+    return(PSRP_OK);
+}
 
-    /*---------------------------------------------------*/
-    /* Buffer in which reply is accumulated MUST be NULL */
-    /* as we are going to dynamically allocate it. The   */
-    /* caller is responsible for freeing up the memory   */
-    /* used                                              */
-    /*---------------------------------------------------*/
-    /*-----------------------------------------------*/
-    /* Read data from channel until we get an EOT or */
-    /* other error condition                         */
-    /*-----------------------------------------------*/
 
-    (void)fgets(reply,255,sic->out_stream);
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"READ SIC (reply is \"%s\")\n",reply);
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
 
+/*------------------------------*/
+/* Set size of PUPS child table */
+/*------------------------------*/
 
-    /*---------------------------------------------*/
-    /* Check for error conditions                  */
-    /* EOG - end of current PSRP transaction group */
-    /*---------------------------------------------*/
+_PRIVATE int32_t psrp_builtin_extend_chtab(const uint32_t argc, const char *argv[])
 
-    if(strncmp(reply,"EOT",3) == 0)
-    {  pups_set_errno(OK);
-       return(PSRP_EOT);
-    }
+{   uint32_t i,
+             n_children;
 
+    if(strcmp(argv[0],"chtab") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    /*-------------------------------------------------*/
-    /* CST - remote peer has terminated (unexpectedly) */
-    /*-------------------------------------------------*/
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: chtab [<maximum number of PUPS child table slots>]\n\n");
+       (void)fflush(psrp_out);
 
-    if(strncmp(reply,"CST",3) == 0)
-    {  pups_set_errno(EEXIST);
-       return(PSRP_TERMINATED);
+       return(PSRP_OK);
     }
 
-    #ifdef PSRPLIB_DEBUG
-    (void)fprintf(stderr,"READ SIC: OK\n");
-    (void)fflush(stderr);
-    #endif /* PSRPLIB_DEBUG */
-
-    pups_set_errno(OK);
-    return(PSRP_MORE);
-}
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n%d PUPS child table slots available for PSRP server \"%s\"\n\n",
+                                                                        appl_max_child,appl_name);
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
+    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_children) != 1)
+    {  (void)fprintf(psrp_out,"\nExpecting maximum number of children (in PUPS child table)\n\n");
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
-/*-----------------------------------------*/
-/* Send request over slaved client channel */
-/*-----------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&chtab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-_PUBLIC  int32_t psrp_write_sic(const psrp_channel_type *sic, const char *request)
+    if(n_children < appl_max_child || strcmp(argv[1],"shrink") == 0)
+    {
 
-{   char toxic_1[SSIZE] = "",
-         toxic_2[SSIZE] = "",
-         toxic_3[SSIZE] = "";
+       /*---------------------------------------------*/
+       /* Find the high water mark for the file table */
+       /*---------------------------------------------*/
 
+       for(i=appl_max_child-1; i>0; --i)
+       {  if(chtab[i].pid != (-1))
+          {  uint32_t j; 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_write_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
+             /*-----------------------------------------------------*/
+             /* We have found the high water mark return all memory */
+             /* above it to this processes free pool                */
+             /*-----------------------------------------------------*/
 
-    if(sic == (const psrp_channel_type *)NULL || request == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+             for(j=i; j<appl_max_child; ++j)
+                (void)pups_clear_chtab_slot(TRUE,j);
+             appl_max_child = i + 1;
+             chtab = (chtab_type *)pups_realloc((void *)chtab,appl_max_child*sizeof(chtab_type));
 
+             (void)fprintf(psrp_out,"\n%d PUPS child table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                                  appl_max_child,appl_name);
+             (void)fflush(psrp_out);
 
-    /*----------------------------*/
-    /* Check that channel is open */
-    /*----------------------------*/
+             #ifdef PTHREAD_SUPPORT
+             (void)pthread_mutex_unlock(&chtab_mutex);
+             #endif /* PTHREAD_SUPPORT */
 
-    (void)snprintf(toxic_1,SSIZE,"%s",                    appl_name);
-    (void)snprintf(toxic_2,SSIZE,"%s@localhost",appl_name,appl_host);
-    (void)snprintf(toxic_2,SSIZE,"%s@%s",       appl_name,appl_host);
+             return(PSRP_OK);
+          }
+       }
 
+       (void)fprintf(psrp_out,"\n%d PUPS child table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
+                                                                                    appl_max_child,appl_name);
+       (void)fflush(psrp_out);
 
-    /*--------------------------------------------------------*/
-    /* Self interaction via SIC is very toxic -- don't do it! */
-    /*--------------------------------------------------------*/
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&chtab_mutex);
+       #endif /* PTHREAD_SUPPORT */
 
-    if(strin(request,toxic_1) == TRUE || strin(request,toxic_2) == TRUE)
-    {   int32_t ret;
-       char     reply[SSIZE] = "";
+       return(PSRP_OK);
+    }
 
-       (void)fputs("end\n",sic->in_stream);
-       (void)fflush(sic->in_stream);
+    chtab = (chtab_type *)pups_realloc((void *)chtab,n_children*sizeof(chtab_type));
+    for(i=appl_max_files; i<n_children; ++i)
+        (void)pups_clear_chtab_slot(FALSE,i);
+    appl_max_child = n_children;
 
+    (void)fprintf(psrp_out,"\n%d PUPS child table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                         appl_max_child,appl_name);
+    (void)fflush(psrp_out);
 
-       /*------------*/
-       /* Read reply */
-       /*------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&chtab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-       do {    if((ret = psrp_read_sic(sic,reply)) == PSRP_MORE)
-               {  (void)fputs(reply,psrp_out);
-                  (void)fflush(psrp_out);
-               }
-          } while(ret == PSRP_MORE);
+    return(PSRP_OK);
+}
 
-       pups_set_errno(EINVAL);
-       return(-2);
-    }
 
 
-    /*--------------*/
-    /* Send request */
-    /*--------------*/
 
-    if(strin(request,"\n") == FALSE)
-       (void)strlcat(request,"\n",SSIZE);
+#ifdef PERSISTENT_HEAP_SUPPORT
+/*-----------------------------------*/
+/* Extend PUPS persistent heap table */
+/*-----------------------------------*/
 
-    (void)fputs(request,sic->in_stream);
-    (void)fflush(sic->in_stream);
+_PRIVATE int32_t psrp_builtin_extend_htab(const uint32_t argc, const char *argv[])
 
-    pups_set_errno(OK);
-    return(0);
-}
+{   uint32_t n_pheaps;
 
+    if(strcmp(argv[0],"htab") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: htab [<maximum number of PUPS persistent heap table slots>]\n\n");
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n%d PUPS persistent heap table slots available for PSRP server \"%s\"\n\n",
+                                                                                 appl_max_pheaps,appl_name);
+       (void)fflush(psrp_out);
 
-/*----------------------------------------*/
-/* Set current PSRP slaved client channel */
-/*----------------------------------------*/
+       return(PSRP_OK);
+    }
 
-_PUBLIC int32_t psrp_set_current_sic(const psrp_channel_type *sic)
+    if(sscanf(argv[1],"%d",&n_pheaps) != 1)
+    {  (void)fprintf(psrp_out,"\nExpecting maximum number of heaps (in PUPS persistent heap table)\n\n");
+       (void)fflush(psrp_out);
 
-{
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+       return(PSRP_OK);
+    }
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_set_current_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(n_pheaps < appl_max_pheaps)
+    {  (void)fprintf(psrp_out,"\nCannot shrink PUPS persistent heap table\n\n");
+       (void)fflush(psrp_out);
 
-    if(sic == (const psrp_channel_type *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+       return(PSRP_OK);
     }
 
-    psrp_current_sic = sic;
-    pups_set_errno(OK);
+    msm_extend(appl_max_pheaps,n_pheaps);
+    appl_max_pheaps = n_pheaps;
 
-    return(0);
+    (void)fprintf(psrp_out,"\n%d PUPS persistent heap table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                                  appl_max_pheaps,appl_name);
+    (void)fflush(psrp_out);
+
+    return(PSRP_OK);
 }
+#endif /* PERSISTENT_HEAP_SUPPORT */
 
 
 
 
-/*----------------------------------------*/
-/* Unset current PSRP interaction channel */
-/*----------------------------------------*/
+#ifdef DLL_SUPPORT
+/*---------------------------------*/
+/* Extend PUPS orifice [DLL] table */
+/*---------------------------------*/
 
-_PUBLIC void psrp_unset_current_sic(void)
+_PRIVATE int32_t psrp_builtin_extend_ortab(const uint32_t argc, const char *argv[])
 
-{
+{   uint32_t i,
+             n_orifices;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(strcmp(argv[0],"ortab") != 0)
+       return(PSRP_DISPATCH_ERROR);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_unset_current_sic] attempt by non root thread to perform PUPS/P3 PSRP operation");
+    if(argc > 2)
+    {  (void)fprintf(psrp_out,"\nusage: ortab [<maximum number of PUPS orifice [DLL] table slots>]\n\n");
+       (void)fflush(psrp_out);
 
-    psrp_current_sic = (psrp_channel_type *)NULL;
-}
+       return(PSRP_OK);
+    }
 
+    if(argc == 1)
+    {  (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots available for PSRP server \"%s\"\n\n",
+                                                                              appl_max_orifices,appl_name);
+       (void)fflush(psrp_out);
 
+       return(PSRP_OK);
+    }
 
+    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_orifices) != 1)
+    {  (void)fprintf(psrp_out,"\nExpecting maximum number of orifices (in PUPS orifice [DLL] table)\n\n");
+       (void)fflush(psrp_out);
 
-/*--------------------------------------*/
-/* Send interrupt to slaved PSRP client */
-/*--------------------------------------*/
+       return(PSRP_OK);
+    }
 
-_PUBLIC void psrp_int_sic(const psrp_channel_type *sic)
+    if(n_orifices < appl_max_orifices || strcmp(argv[1],"shrink") == 0)
+    {
 
-{   char pidname[SSIZE] = "";
+       /*---------------------------------------------*/
+       /* Find the high water mark for the file table */
+       /*---------------------------------------------*/
 
+       for(i=appl_max_orifices-1; i>0; --i)
+       {  if(ortab[i].orifice_handle == (void *)NULL)
+          {  uint32_t    j;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("attempt by non root thread to perform PUPS/P3 PSRP operation (psrp_int_sic)");
+             /*-----------------------------------------------------*/
+             /* We have found the high water mark return all memory */
+             /* above it to this processes free pool                */
+             /*-----------------------------------------------------*/
 
-    if(sic == (const psrp_channel_type *)NULL)
-    {  pups_set_errno(EINVAL);
-       return;
-    }
+             for(j=i; j<appl_max_orifices; ++j)
+                 (void)clear_ortab_slot(TRUE,j);
 
-    (void)snprintf(pidname,SSIZE,"%d",sic->scp);
-    (void)pups_rkill(sic->host_name,
-                     sic->ssh_port,
-                     appl_owner,
-                     pidname,
-                     SIGINT);
+             appl_max_orifices = i + 1;
+             ortab = (ortab_type *)pups_realloc((void *)ortab,appl_max_orifices*sizeof(ortab_type));
 
-    pups_set_errno(OK);
-}
+             (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots now allocated for PSRP server \"%s\"\n\n",
+                                                                                       appl_max_orifices,appl_name);
+             (void)fflush(psrp_out);
+             return(PSRP_OK);
+          }
+       }
 
+       (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
+                                                                                         appl_max_orifices,appl_name);
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
 
+    ortab = (ortab_type *)pups_realloc((void *)ortab,n_orifices*sizeof(ortab_type));
+    for(i=appl_max_orifices; i<n_orifices; ++i)
+        clear_ortab_slot(FALSE,i);
+    appl_max_orifices = n_orifices;
 
+    (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] slots now allocated for PSRP server \"%s\"\n\n",
+                                                                        appl_max_orifices,appl_name);
+    (void)fflush(psrp_out);
+    return(PSRP_OK);
+}
+#endif /* DLL_SUPPORT */
 
-/*---------------------------------------*/
-/* Install exit function for PSRP client */
-/*---------------------------------------*/
 
-_PUBLIC int32_t psrp_set_client_exitf(const uint32_t chid, const char *fname,  int32_t (*func)(int32_t))
 
-{
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+/*------------------------------------------------------------*/
+/* Lock crontab (and its deadline queue). On the root thread  */
+/* signals are blocked while the lock is held (a handler      */
+/* which schedules activity would otherwise deadlock)         */
+/*------------------------------------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_set_client_exitf] attempt by non root thread to perform PUPS/P3 PSRP operation");
+_PRIVATE void psrp_cron_lock(sigset_t *old_set)
 
-    if(chid > MAX_CLIENTS || fname == (const char *)NULL || (void *)func == (void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+{   sigset_t set;
 
-    (void)strlcpy(psrp_client_efname[chid],fname,SSIZE);
-    psrp_client_exitf[chid] = (void *)func;
+    (void)sigfillset(&set);
 
-    pups_set_errno(OK);
-    return(0);
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_sigmask(SIG_BLOCK,&set,old_set);
+    (void)pthread_mutex_lock(&psrp_cron_mutex);
+    #else
+    (void)sigprocmask(SIG_BLOCK,&set,old_set);
+    #endif /* PTHREAD_SUPPORT */
 }
 
 
 
 
-/*----------------------------------------*/
-/* Remove exit function for a PSRP client */ 
-/*----------------------------------------*/
+/*------------------------------------------------------------*/
+/* Unlock crontab, waking cron thread so that it picks up any */
+/* change to the earliest wakeup                              */
+/*------------------------------------------------------------*/
 
-_PUBLIC int32_t psrp_reset_client_exitf(const uint32_t chid)
+_PRIVATE void psrp_cron_unlock(const sigset_t *old_set)
 
 {
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_cond_signal(&psrp_cron_cond);
+    (void)pthread_mutex_unlock(&psrp_cron_mutex);
+    (void)pthread_sigmask(SIG_SETMASK,old_set,(sigset_t *)NULL);
+    #else
+    (void)sigprocmask(SIG_SETMASK,old_set,(sigset_t *)NULL);
+    #endif /* PTHREAD_SUPPORT */
+}
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_reset_client_exitf] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(chid > MAX_CLIENTS)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
 
-    (void)strlcpy(psrp_client_efname[chid],"",SSIZE);
-    psrp_client_exitf[chid] = (void *)NULL;
+/*------------------------------------------------------------*/
+/* Swap crontab deadline queue entries                        */
+/*------------------------------------------------------------*/
 
-    pups_set_errno(OK);
-    return(0);
-}
+_PRIVATE void psrp_cron_heap_swap(const uint32_t i, const uint32_t j)
 
+{   int32_t tmp;
 
+    tmp               = psrp_cron_heap[i];
+    psrp_cron_heap[i] = psrp_cron_heap[j];
+    psrp_cron_heap[j] = tmp;
 
+    crontab[psrp_cron_heap[i]].heap_index = i;
+    crontab[psrp_cron_heap[j]].heap_index = j;
+}
 
-/*------------------------------------------------*/
-/* Overlay the current process with a new comamnd */
-/*------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_overlay_server_process(const uint32_t argc, const char *argv[])
 
-{   uint32_t i;
 
-    char overlay_command_name[SSIZE] = "",
-         overlay_command_tail[SSIZE] = "";
+/*------------------------------------------------------------*/
+/* Restore deadline queue order about entry i                 */
+/*------------------------------------------------------------*/
 
-    if(strcmp(argv[0],"overlay") != 0)
-       return(PSRP_DISPATCH_ERROR);
+_PRIVATE void psrp_cron_heap_fix(uint32_t i)
 
-    if(argc < 2)
-    {  (void)fprintf(psrp_out,"usage: overlay <command to overlay>\n");
-       (void)fflush(psrp_out);
+{   uint32_t child;
 
-       return(PSRP_OK);
+    while(i > 0 && crontab[psrp_cron_heap[i]].next < crontab[psrp_cron_heap[(i - 1)/2]].next)
+    {    psrp_cron_heap_swap(i,(i - 1)/2);
+         i = (i - 1)/2;
     }
 
+    while((child = 2*i + 1) < psrp_cron_heap_size)
+    {    if(child + 1 < psrp_cron_heap_size && crontab[psrp_cron_heap[child + 1]].next < crontab[psrp_cron_heap[child]].next)
+            ++child;
 
-    /*--------------------------*/
-    /* Build command to overlay */
-    /*--------------------------*/
-
-    (void)strlcpy(overlay_command_tail,"",SSIZE);
-    for(i=1; i<argc; ++i)
-    {   if(i == 1)
-           (void)strlcpy(overlay_command_name,argv[1],SSIZE);
-        else
-        {  (void)strlcat(overlay_command_tail,argv[i],SSIZE);
+         if(crontab[psrp_cron_heap[i]].next <= crontab[psrp_cron_heap[child]].next)
+            break;
 
-           if(i < argc - 1)
-              (void)strlcat(overlay_command_tail," ",SSIZE);
-        }
+         psrp_cron_heap_swap(i,child);
+         i = child;
     }
+}
 
-    (void)psrp_overlay_server_process(FALSE,overlay_command_name,overlay_command_tail);
 
 
-    /*---------------------------*/
-    /* We should not get here if */
-    /* overlay is successful     */
-    /*---------------------------*/
 
-    (void)fprintf(psrp_out,"\nfailed to overlay PSRP server (%s) [with command %s]\n\n",appl_name,overlay_command_name);
-    (void)fflush(psrp_out);
+/*------------------------------------------------------------*/
+/* Add crontab slot to deadline queue                         */
+/*------------------------------------------------------------*/
 
-    return(PSRP_OK);
+_PRIVATE void psrp_cron_heap_push(const int32_t ctab_index)
+
+{   crontab[ctab_index].heap_index      = psrp_cron_heap_size;
+    psrp_cron_heap[psrp_cron_heap_size] = ctab_index;
+
+    ++psrp_cron_heap_size;
+    psrp_cron_heap_fix(crontab[ctab_index].heap_index);
 }
 
 
 
 
-/*------------------------------------------------*/
-/* Overlay the current process with a new command */
-/*------------------------------------------------*/
+/*------------------------------------------------------------*/
+/* Remove crontab slot from deadline queue                    */
+/*------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_overfork_server_process(const uint32_t argc, const char *argv[])
+_PRIVATE void psrp_cron_heap_remove(const int32_t ctab_index)
 
 {   uint32_t i;
-    int32_t  ret;
 
-    char overlay_command_name[SSIZE] = "",
-         overlay_command_tail[SSIZE] = "";
+    if(crontab[ctab_index].heap_index == (-1))
+       return;
 
-    if(strcmp(argv[0],"overfork") != 0)
-       return(PSRP_DISPATCH_ERROR);
+    i = crontab[ctab_index].heap_index;
+    crontab[ctab_index].heap_index = (-1);
 
-    if(argc < 2)
-    {  (void)fprintf(psrp_out,"\nusage: overfork <command to fork>\n\n");
-       (void)fflush(psrp_out);
+    if(i != --psrp_cron_heap_size)
+    {  psrp_cron_heap[i]                     = psrp_cron_heap[psrp_cron_heap_size];
+       crontab[psrp_cron_heap[i]].heap_index = i;
 
-       return(PSRP_OK);
+       psrp_cron_heap_fix(i);
     }
+}
 
 
-    /*---------------------------*/
-    /* Build command to overfork */
-    /*---------------------------*/
-
-    (void)strlcpy(overlay_command_tail,"",SSIZE);
-    for(i=1; i<argc; ++i)
-    {   if(i == 1)
-           (void)strlcpy(overlay_command_name,argv[1],SSIZE);
-        else
-        {  (void)strlcat(overlay_command_tail,argv[i],SSIZE);
 
-           if(i < argc - 1)
-              (void)strlcat(overlay_command_tail," ",SSIZE);
-        }
-    }
 
-    if(psrp_overlay_server_process(TRUE,overlay_command_name,overlay_command_tail) < 0)
-       (void)fprintf(psrp_out,"\noverfork  PSRP server (%s) [with command %s] failed - resuming execution\n\n",
-                                                                                 appl_name,overlay_command_name);
-    else
-       (void)fprintf(psrp_out,"\noverfork  PSRP server (%s) [with command %s] finished - resuming execution\n\n",
-                                                                                   appl_name,overlay_command_name);
-    (void)fflush(psrp_out);
+/*------------------------------------------------------------*/
+/* Parse (comma separated) cron field. Each item is *, n, n-m */
+/* optionally followed by /step                               */
+/*------------------------------------------------------------*/
 
-    return(PSRP_OK);
-}
+_PRIVATE int32_t psrp_cron_field(const char *field, const int32_t lo, const int32_t hi, uint64_t *bits)
 
+{   int32_t from,
+            to,
+            step,
+            value;
 
+    char    *item,
+            *save,
+            *slash,
+            *dash,
+            *end,
+            field_str[SSIZE] = "";
 
+    (void)strlcpy(field_str,field,SSIZE);
+    *bits = 0;
 
-/*----------------------------------------------------*/
-/* Overlay PSRP server process with specified command */
-/*----------------------------------------------------*/
+    for(item=strtok_r(field_str,",",&save); item != (char *)NULL; item=strtok_r((char *)NULL,",",&save))
+    {  step = 1;
 
-_PUBLIC int32_t psrp_overlay_server_process(const _BOOLEAN over_fork, const char *command_name, const char *command_tail)
+       if((slash = strchr(item,'/')) != (char *)NULL)
+       {  *slash = '\0';
+          step   = (int32_t)strtol(slash + 1,&end,10);
 
-{   char command_path[SSIZE]      = "",
-         command_tail_path[SSIZE] = "";
+          if(*end != '\0' || end == slash + 1 || step < 1)
+             return(-1);
+       }
 
+       if(strcmp(item,"*") == 0)
+       {  from = lo;
+          to   = hi;
+       }
+       else
+       {  if((dash = strchr(item,'-')) != (char *)NULL)
+             *dash = '\0';
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+          from = (int32_t)strtol(item,&end,10);
+          if(*end != '\0' || end == item)
+             return(-1);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_overlay_server_process] attempt by non root thread to perform PUPS/P3 PSRP operation");
+          if(dash != (char *)NULL)
+          {  to = (int32_t)strtol(dash + 1,&end,10);
+             if(*end != '\0' || end == dash + 1)
+                return(-1);
+          }
+          else if(slash != (char *)NULL)
+             to = hi;
+          else
+             to = from;
+       }
 
+       if(from < lo || to > hi || from > to)
+          return(-1);
 
-    if(command_name == (const char *)NULL || command_tail == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+       for(value=from; value<=to; value += step)
+          *bits |= (uint64_t)1 << value;
     }
 
+    return(0);
+}
 
-    /*------------------------------------------------------*/
-    /* This command should not return (if it is successful) */
-    /*------------------------------------------------------*/
-
-    if(strccpy(command_path,pups_search_path("PATH",command_name)) != (char *)NULL)
-    {  if(command_tail != (char *)NULL)
-          (void)snprintf(command_tail_path,SSIZE,"%s %s",command_path,command_tail);
-       else
-          (void)strlcpy(command_tail_path,command_path,SSIZE);
-
-
-       /*---------------------------------------------*/
-       /* Make sure this operation is not interrupted */
-       /* by PUPS signal handlers                     */
-       /*---------------------------------------------*/
-
-       (void)pups_malarm(0);
-       (void)pupshold(PSRP_SIGS);
 
-       if(over_fork == TRUE)
-       {  int32_t status;
 
-          char channel_wait_in[SSIZE]  = "",
-               channel_wait_out[SSIZE] = "";
 
-          overforking = TRUE;
+/*------------------------------------------------------------*/
+/* Parse cron expression - five fields (minute hour day-of-   */
+/* month month day-of-week) or one of the @ shorthands        */
+/*------------------------------------------------------------*/
 
+_PRIVATE int32_t psrp_cron_parse(const char *expression, psrp_cron_spec_type *spec)
 
-          /*-----------------------------*/
-          /* Child (overforking process) */
-          /*-----------------------------*/
+{   uint32_t n_fields = 0;
+    uint64_t bits;
 
-          if((overforked_child_pid = pups_fork(FALSE,FALSE)) == 0)
-          {  (void)pups_execls(command_tail_path);
+    char     *field[5],
+             *save,
+             *next_field,
+             expression_str[SSIZE] = "";
 
-             if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): failed to overfork command (%s) - resuming execution\n",
-                                                      date,appl_name,appl_pid,appl_host,appl_owner,command_name);
-                (void)fflush(stderr);
-             }
-             exit(255);
-          }
+    if(strcmp(expression,"@yearly") == 0 || strcmp(expression,"@annually") == 0)
+       expression = "0 0 1 1 *";
+    else if(strcmp(expression,"@monthly") == 0)
+       expression = "0 0 1 * *";
+    else if(strcmp(expression,"@weekly") == 0)
+       expression = "0 0 * * 0";
+    else if(strcmp(expression,"@daily") == 0 || strcmp(expression,"@midnight") == 0)
+       expression = "0 0 * * *";
+    else if(strcmp(expression,"@hourly") == 0)
+       expression = "0 * * * *";
 
+    (void)strlcpy(expression_str,expression,SSIZE);
 
-          /*----------------------*/
-          /* Parent (psrp server) */
-          /*----------------------*/
+    for(next_field=strtok_r(expression_str," \t",&save); next_field != (char *)NULL; next_field=strtok_r((char *)NULL," \t",&save))
+    {  if(n_fields == 5)
+          return(-1);
 
-          (void)snprintf(channel_wait_in,SSIZE,"%s.wait",channel_name_in);
-          (void)rename(channel_name_in,channel_wait_in);
-          (void)snprintf(channel_wait_out,SSIZE,"%s.wait",channel_name_out);
-          (void)rename(channel_name_out,channel_wait_out);
+       field[n_fields++] = next_field;
+    }
 
+    if(n_fields != 5)
+       return(-1);
 
-          /*-----------------------------*/
-          /* Wait for child to terminate */
-          /*-----------------------------*/
+    if(psrp_cron_field(field[0],0,59,&spec->minute) == (-1))
+       return(-1);
 
-          while(kill(overforked_child_pid,SIGALIVE) != (-1))
-          {    (void)pups_usleep(100);
-               (void)pupswaitpid(TRUE,overforked_child_pid,&status);
-          }
+    if(psrp_cron_field(field[1],0,23,&bits) == (-1))
+       return(-1);
+    spec->hour = (uint32_t)bits;
 
-          overforking          = FALSE;
-          overforked_child_pid = (-1);
+    if(psrp_cron_field(field[2],1,31,&bits) == (-1))
+       return(-1);
+    spec->mday = (uint32_t)bits;
 
-          (void)rename(channel_wait_in, channel_name_in);
-          (void)rename(channel_wait_out,channel_name_out);
+    if(psrp_cron_field(field[3],1,12,&bits) == (-1))
+       return(-1);
+    spec->month = (uint32_t)bits;
 
-          if(appl_verbose == TRUE)
-          {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): overforked command (%s) has terminated - resuming execution\n",
-                                                          date,appl_name,appl_pid,appl_host,appl_owner,command_name);
-             (void)fflush(stderr);
-          }
-       }
-       else if(command_tail_path[0] != ' ')
-       {  
 
-          /*-----------------*/
-          /* Reply to client */
-          /*-----------------*/
+    /*-------------------------------------*/
+    /* Day of week 7 is (also) Sunday      */
+    /*-------------------------------------*/
 
-          (void)fprintf(psrp_out,"EOT %s\n",psrp_c_code);
-          (void)fflush(psrp_out);
+    if(psrp_cron_field(field[4],0,7,&bits) == (-1))
+       return(-1);
+    spec->wday = (uint32_t)((bits | (bits >> 7)) & 0x7f);
 
 
-          /*------------------------------------------------------*/
-          /* Tell client that we have finished processing SIGPSRP */
-          /*------------------------------------------------------*/
+    /*--------------------------------------------------------*/
+    /* A day field is unrestricted if it covers its whole     */
+    /* range (so a step of 1 or a full range like 1-31 is     */
+    /* treated just like "*")                                 */
+    /*--------------------------------------------------------*/
 
-          psrp_endop("psrp");       
+    spec->any_mday = FALSE;
+    if(spec->mday == 0xfffffffe)
+       spec->any_mday = TRUE;
 
+    spec->any_wday = FALSE;
+    if(spec->wday == 0x7f)
+       spec->any_wday = TRUE;
 
-          /*----------------------------------------*/
-          /* Close channel to existing PSRP command */
-          /*----------------------------------------*/
+    return(0);
+}
 
-          pups_exit(PUPS_DEFER_EXIT); 
 
 
-          /*----------------------------------------*/
-          /* Overlay new command on current process */
-          /*----------------------------------------*/
 
-          (void)pups_execls(command_tail_path);
+/*------------------------------------------------------------*/
+/* Set cron specification for (daily or monthly) window time  */
+/* [dd:]hh:mm                                                 */
+/*------------------------------------------------------------*/
 
+_PRIVATE int32_t psrp_cron_window_time(const char *window_time, psrp_cron_spec_type *spec)
 
-          /*----------------------------------------------------------*/
-          /* We should not get here -- if overlay has been successful */
-          /*----------------------------------------------------------*/
+{   int32_t d,
+            h,
+            m;
 
-          (void)pups_malarm(1);
-          pupsrelse(PSRP_SIGS);
-          pups_set_errno(ENOEXEC);
-          return(-1);
-       }
-       else
-       {  (void)pups_malarm(1);
-          pupsrelse(PSRP_SIGS);
+    time_t    t;
+    struct tm local_time;
 
-          pups_set_errno(ENOEXEC);
+    if(strcmp(window_time,"now") == 0)
+    {  t = time((time_t *)NULL);
+       (void)localtime_r(&t,&local_time);
+
+       d = local_time.tm_mday;
+       h = local_time.tm_hour;
+       m = local_time.tm_min;
+    }
+    else if(sscanf(window_time,"%d:%d:%d",&d,&h,&m) != 3)
+    {  if(sscanf(window_time,"%d:%d",&h,&m) != 2)
           return(-1);
-       }
 
-       (void)pups_malarm(1);
-       pupsrelse(PSRP_SIGS);
+       d = 0;
+    }
+
+    if(d < 0 || d > 31 || h < 0 || h > 23 || m < 0 || m > 59)
+       return(-1);
+
+    spec->minute   = (uint64_t)1 << m;
+    spec->hour     = (uint32_t)1 << h;
+    spec->month    = 0x1ffe;
+    spec->wday     = 0x7f;
+    spec->any_wday = TRUE;
+
+    if(d == 0)
+    {  spec->mday     = 0xfffffffe;
+       spec->any_mday = TRUE;
+    }
+    else
+    {  spec->mday     = (uint32_t)1 << d;
+       spec->any_mday = FALSE;
     }
 
-    pups_set_errno(OK);
     return(0);
 }
 
 
 
 
-/*-----------------------------*/
-/* Set size of PUPS file table */
-/*-----------------------------*/
+/*------------------------------------------------------------*/
+/* Does cron specification match (local) day. If both day of  */
+/* month and day of week are restricted either may match      */
+/*------------------------------------------------------------*/
 
+_PRIVATE _BOOLEAN psrp_cron_day_match(const psrp_cron_spec_type *spec, const struct tm *local_time)
 
-_PRIVATE int32_t psrp_builtin_extend_ftab(const uint32_t argc, const char *argv[])
+{   _BOOLEAN mday_match = FALSE,
+             wday_match = FALSE;
 
-{   uint32_t i,
-             n_files;
+    if((spec->month & ((uint32_t)1 << (local_time->tm_mon + 1))) == 0)
+       return(FALSE);
 
-    if(strcmp(argv[0],"ftab") != 0)
-       return(PSRP_DISPATCH_ERROR);
-   
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: files [<maximum number of PUPS file table slots>]\n\n");
-       (void)fflush(psrp_out);
+    if(spec->mday & ((uint32_t)1 << local_time->tm_mday))
+       mday_match = TRUE;
 
-       return(PSRP_OK);
-    }
+    if(spec->wday & ((uint32_t)1 << local_time->tm_wday))
+       wday_match = TRUE;
 
-    if(argc == 1)
-    {  (void)fprintf(psrp_out,"\n%d PUPS file table slots available for PSRP server \"%s\"\n\n",
-                                                                        appl_max_files,appl_name);
-       (void)fflush(psrp_out);
+    if(spec->any_mday == TRUE)
+       return(wday_match);
 
-       return(PSRP_OK);
-    }
+    if(spec->any_wday == TRUE)
+       return(mday_match);
 
-    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_files) != 1)
-    {  (void)fprintf(psrp_out,"\nExpecting maximum number of files (in PUPS file table)\n\n");
-       (void)fflush(psrp_out);
+    if(mday_match == TRUE || wday_match == TRUE)
+       return(TRUE);
 
-       return(PSRP_OK);
-    }
+    return(FALSE);
+}
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_MUTEX */
 
-    if(n_files < appl_max_files || strcmp(argv[1],"shrink") == 0)
-    {
 
-       /*---------------------------------------------*/
-       /* Find the high water mark for the file table */
-       /*---------------------------------------------*/
 
-       for(i=appl_max_files-1; i>0; --i)
-       {  if(ftab[i].fdes != (-1))
-          {  uint32_t j;
+/*------------------------------------------------------------*/
+/* Next (absolute) time after t which matches cron spec. Days */
+/* which do not match are skipped whole, so this is cheap     */
+/* even for sparse specifications                             */
+/*------------------------------------------------------------*/
 
+_PRIVATE time_t psrp_cron_next(const psrp_cron_spec_type *spec, const time_t t)
 
-             /*-----------------------------------------------------*/
-             /* We have found the high water mark return all memory */
-             /* above it to this processes free pool                */
-             /*-----------------------------------------------------*/
+{   uint32_t  day;
+     int32_t  h,
+              m;
 
-             for(j=i; j<appl_max_files; ++j)
-                (void)pups_clear_ftab_slot(TRUE,j);
-             appl_max_files = i + 1;
-             ftab = (ftab_type *)pups_realloc((void *)ftab,appl_max_files*sizeof(ftab_type));
+    time_t    next;
+    struct tm local_time;
 
-             (void)fprintf(psrp_out,"\n%d PUPS file table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                                 appl_max_files,appl_name); 
-             (void)fflush(psrp_out);
+    (void)localtime_r(&t,&local_time);
 
-             #ifdef PTHREAD_SUPPORT
-             (void)pthread_mutex_unlock(&ftab_mutex);
-             #endif /* PTHREAD_MUTEX */
+    local_time.tm_sec   = 0;
+    local_time.tm_min  += 1;
+    local_time.tm_isdst = (-1);
 
-             return(PSRP_OK);
+    next = mktime(&local_time);
+    (void)localtime_r(&next,&local_time);
+
+    for(day=0; day<PSRP_CRON_MAX_DAYS; ++day)
+    {  if(psrp_cron_day_match(spec,&local_time) == TRUE)
+       {  for(h=local_time.tm_hour; h<24; ++h)
+          {  if(spec->hour & ((uint32_t)1 << h))
+             {  for(m=(h == local_time.tm_hour) ? local_time.tm_min : 0; m<60; ++m)
+                {  if(spec->minute & ((uint64_t)1 << m))
+                   {  local_time.tm_hour  = h;
+                      local_time.tm_min   = m;
+                      local_time.tm_sec   = 0;
+                      local_time.tm_isdst = (-1);
+
+                      return(mktime(&local_time));
+                   }
+                }
+             }
           }
        }
 
-       (void)fprintf(psrp_out,"\n%d PUPS file table slots allocated for PSRP server (unchanged)\"%s\"\n\n",
-                                                                                   appl_max_files,appl_name); 
-       (void)fflush(psrp_out);
+       local_time.tm_mday  += 1;
+       local_time.tm_hour   = 0;
+       local_time.tm_min    = 0;
+       local_time.tm_sec    = 0;
+       local_time.tm_isdst  = (-1);
 
+       next = mktime(&local_time);
+       (void)localtime_r(&next,&local_time);
+    }
 
-       #ifdef PTHREAD_SUPPORT
-       (void)pthread_mutex_unlock(&ftab_mutex);
-       #endif /* PTHREAD_MUTEX */
+    return((time_t)(-1));
+}
 
-       return(PSRP_OK);
-    }
 
-    ftab = (ftab_type *)pups_realloc((void *)ftab,n_files*sizeof(ftab_type));
-    for(i=appl_max_files; i<n_files; ++i)
-        (void)pups_clear_ftab_slot(FALSE,i);
-    appl_max_files = n_files;
 
 
-    (void)fprintf(psrp_out,"\n%d PUPS file table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                        appl_max_files,appl_name);
-    (void)fflush(psrp_out); 
+/*------------------------------------------------------------*/
+/* Queue next start of crontab activity (with jitter)         */
+/*------------------------------------------------------------*/
 
+_PRIVATE void psrp_cron_queue_start(const int32_t ctab_index, const time_t t)
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_MUTEX */
+{   if((crontab[ctab_index].due = psrp_cron_next(&crontab[ctab_index].start,t)) == (time_t)(-1))
+       return;
 
-    return(PSRP_OK);
+    crontab[ctab_index].next = crontab[ctab_index].due;
+
+    if(crontab[ctab_index].jitter > 0)
+       crontab[ctab_index].next += rand_r(&crontab[ctab_index].seed) % (crontab[ctab_index].jitter + 1);
+
+    psrp_cron_heap_push(ctab_index);
 }
 
 
 
 
-/*--------------------------------------*/
-/* Set size of PUPS virtual timer table */
-/*--------------------------------------*/
+/*------------------------------------------------------------*/
+/* Pop crontab activities which are due from deadline queue.  */
+/* Returns the slots whose payload should now be run          */
+/* (called with crontab locked)                               */
+/*------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_extend_vitab(const uint32_t argc, const char *argv[])
+_PRIVATE uint32_t psrp_cron_run_due(const time_t t, int32_t *launch)
 
-{   uint32_t i,
-             n_vtimers;
+{   int32_t  ctab_index;
+    uint32_t n_launch = 0;
 
-    if(strcmp(argv[0],"vitab") != 0)
-       return(PSRP_DISPATCH_ERROR);
+    while(psrp_cron_heap_size > 0 && crontab[psrp_cron_heap[0]].next <= t)
+    {    ctab_index = psrp_cron_heap[0];
+         psrp_cron_heap_remove(ctab_index);
 
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: vitab [<maximum number of PUPS virtual timer table slots>]\n\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
+         /*--------------------------------------------*/
+         /* Window closes - queue its next opening     */
+         /*--------------------------------------------*/
 
-    if(argc == 1)
-    {  (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots available for PSRP server \"%s\"\n\n",
-                                                                              appl_max_vtimers,appl_name);
-       (void)fflush(psrp_out);
+         if(crontab[ctab_index].window == TRUE && crontab[ctab_index].active == TRUE)
+         {  crontab[ctab_index].active = FALSE;
+            psrp_cron_queue_start(ctab_index,t);
 
-       return(PSRP_OK);
-    }
+            if(appl_verbose == TRUE)
+            {  (void)strdate(date);
+               (void)fprintf(stderr,"%s %s (%d@%s:%s): crontab event %d (%s) finished\n",
+                             date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,crontab[ctab_index].fname);
+               (void)fflush(stderr);
+            }
 
-    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_vtimers) != 1)
-    {  (void)fprintf(psrp_out,"\nExpecting maximum number of timers (in PUPS virtual timer table)\n\n");
-       (void)fflush(psrp_out);
+            continue;
+         }
 
-       return(PSRP_OK);
+
+         /*--------------------------------------------*/
+         /* Window opens (or cron expression matches)  */
+         /*--------------------------------------------*/
+
+         if(appl_verbose == TRUE)
+         {  (void)strdate(date);
+            (void)fprintf(stderr,"%s %s (%d@%s:%s): scheduling crontab event %d (%s)\n",
+                          date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,crontab[ctab_index].fname);
+            (void)fflush(stderr);
+         }
+
+         if(crontab[ctab_index].window == TRUE)
+         {  crontab[ctab_index].active = TRUE;
+
+            if(crontab[ctab_index].forever == FALSE &&
+               (crontab[ctab_index].due = psrp_cron_next(&crontab[ctab_index].stop,t)) != (time_t)(-1))
+            {  crontab[ctab_index].next = crontab[ctab_index].due;
+               psrp_cron_heap_push(ctab_index);
+            }
+         }
+         else
+            psrp_cron_queue_start(ctab_index,t);
+
+
+         /*--------------------------------------------*/
+         /* A payload which is still running from its  */
+         /* previous activation is not run again       */
+         /*--------------------------------------------*/
+
+         if(crontab[ctab_index].func != (void *)NULL && crontab[ctab_index].running == FALSE)
+         {  crontab[ctab_index].running = TRUE;
+            ++crontab[ctab_index].runs;
+
+            launch[n_launch++] = ctab_index;
+         }
     }
 
-    if(n_vtimers < appl_max_vtimers || strcmp(argv[1],"shrink") == 0)
-    {
+    return(n_launch);
+}
 
-       /*------------------------------------------------------*/
-       /* Find the high water mark for the virtual timer table */
-       /*------------------------------------------------------*/
 
-       for(i=appl_max_vtimers-1; i>0; --i)
-       {  if(vttab[i].interval_time != (-1))
-          {  uint32_t j;
 
 
-             /*-----------------------------------------------------*/
-             /* We have found the high water mark return all memory */
-             /* above it to this processes free pool                */
-             /*-----------------------------------------------------*/
+/*------------------------------------------------------------*/
+/* Run payload of crontab activity on the root thread (we     */
+/* pass the payload function its crontab slot so it can check */
+/* whether it should stop). Activity which was unscheduled    */
+/* after it became due is not run                             */
+/*------------------------------------------------------------*/
 
-             for(j=i; j<appl_max_vtimers; ++j)
-                (void)pups_clear_vitimer(j);
-             appl_max_vtimers = i + 1;
-             vttab = (vttab_type *)pups_realloc((void *)vttab,appl_max_vtimers*sizeof(vttab_type));
+_PRIVATE void psrp_cron_launch(const int32_t ctab_index)
 
-             (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                                        appl_max_vtimers,appl_name);
-             (void)fflush(psrp_out);
+{   sigset_t old_set;
+    void     (*func)(int32_t) = NULL;
 
-             return(PSRP_OK);
-          }
-       }
+    psrp_cron_lock(&old_set);
 
-       (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
-                                                                                          appl_max_vtimers,appl_name);
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
-    }
+    if(crontab[ctab_index].used == TRUE)
+       func = crontab[ctab_index].func;
 
-    vttab = (vttab_type *)pups_realloc((void *)vttab,n_vtimers*sizeof(vttab_type));
-    for(i=appl_max_vtimers; i<n_vtimers; ++i)
-        (void)pups_clear_vitimer(i);
-    appl_max_vtimers = n_vtimers;
+    psrp_cron_unlock(&old_set);
 
-    (void)fprintf(psrp_out,"\n%d PUPS virtual timer table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                               appl_max_vtimers,appl_name);
-    (void)fflush(psrp_out);
-    return(PSRP_OK);
+    if(func != NULL)
+       (*func)(ctab_index);
+
+    psrp_cron_lock(&old_set);
+    crontab[ctab_index].running = FALSE;
+    psrp_cron_unlock(&old_set);
 }
 
 
 
 
-/*------------------------------*/
-/* Set size of PUPS child table */
-/*------------------------------*/
+#ifdef PTHREAD_SUPPORT
+/*------------------------------------------------------------*/
+/* Handler for SIGCRON - runs the payloads which the cron     */
+/* thread has queued for the root thread                      */
+/*------------------------------------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_extend_chtab(const uint32_t argc, const char *argv[])
+_PRIVATE int32_t psrp_cron_handler(const int32_t signum)
 
 {   uint32_t i,
-             n_children;
-
-    if(strcmp(argv[0],"chtab") != 0)
-       return(PSRP_DISPATCH_ERROR);
+             n_launch;
 
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: chtab [<maximum number of PUPS child table slots>]\n\n");
-       (void)fflush(psrp_out);
+    int32_t  launch[MAX_CRON_SLOTS];
+    sigset_t old_set;
 
-       return(PSRP_OK);
-    }
+    psrp_cron_lock(&old_set);
 
-    if(argc == 1)
-    {  (void)fprintf(psrp_out,"\n%d PUPS child table slots available for PSRP server \"%s\"\n\n",
-                                                                        appl_max_child,appl_name);
-       (void)fflush(psrp_out);
+    n_launch = psrp_cron_n_pending;
+    for(i=0; i<n_launch; ++i)
+       launch[i] = psrp_cron_pending[i];
+    psrp_cron_n_pending = 0;
 
-       return(PSRP_OK);
-    }
+    psrp_cron_unlock(&old_set);
 
-    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_children) != 1)
-    {  (void)fprintf(psrp_out,"\nExpecting maximum number of children (in PUPS child table)\n\n");
-       (void)fflush(psrp_out);
+    for(i=0; i<n_launch; ++i)
+       psrp_cron_launch(launch[i]);
 
-       return(PSRP_OK);
-    }
+    return(0);
+}
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&chtab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    if(n_children < appl_max_child || strcmp(argv[1],"shrink") == 0)
-    {
 
-       /*---------------------------------------------*/
-       /* Find the high water mark for the file table */
-       /*---------------------------------------------*/
 
-       for(i=appl_max_child-1; i>0; --i)
-       {  if(chtab[i].pid != (-1))
-          {  uint32_t j; 
+/*------------------------------------------------------------*/
+/* Cron thread - sleeps until the earliest (absolute) wakeup  */
+/* in the deadline queue, then queues the payloads which are  */
+/* due and signals the root thread to run them                */
+/*------------------------------------------------------------*/
 
+_PRIVATE void *psrp_cron_thread(void *arg)
 
-             /*-----------------------------------------------------*/
-             /* We have found the high water mark return all memory */
-             /* above it to this processes free pool                */
-             /*-----------------------------------------------------*/
+{   uint32_t        i,
+                    n_launch;
 
-             for(j=i; j<appl_max_child; ++j)
-                (void)pups_clear_chtab_slot(TRUE,j);
-             appl_max_child = i + 1;
-             chtab = (chtab_type *)pups_realloc((void *)chtab,appl_max_child*sizeof(chtab_type));
+    int32_t         launch[MAX_CRON_SLOTS];
+    struct timespec deadline;
 
-             (void)fprintf(psrp_out,"\n%d PUPS child table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                                  appl_max_child,appl_name);
-             (void)fflush(psrp_out);
+    (void)pthread_mutex_lock(&psrp_cron_mutex);
 
-             #ifdef PTHREAD_SUPPORT
-             (void)pthread_mutex_unlock(&chtab_mutex);
-             #endif /* PTHREAD_SUPPORT */
+    while(TRUE)
+    {    if((n_launch = psrp_cron_run_due(time((time_t *)NULL),launch)) > 0)
+         {  for(i=0; i<n_launch; ++i)
+               psrp_cron_pending[psrp_cron_n_pending++] = launch[i];
 
-             return(PSRP_OK);
-          }
-       }
+            (void)pthread_mutex_unlock(&psrp_cron_mutex);
+            (void)pthread_kill(appl_root_tid,SIGCRON);
+            (void)pthread_mutex_lock(&psrp_cron_mutex);
 
-       (void)fprintf(psrp_out,"\n%d PUPS child table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
-                                                                                    appl_max_child,appl_name);
-       (void)fflush(psrp_out);
+            continue;
+         }
 
-       #ifdef PTHREAD_SUPPORT
-       (void)pthread_mutex_unlock(&chtab_mutex);
-       #endif /* PTHREAD_SUPPORT */
+         if(psrp_cron_heap_size == 0)
+            (void)pthread_cond_wait(&psrp_cron_cond,&psrp_cron_mutex);
+         else
+         {  deadline.tv_sec  = crontab[psrp_cron_heap[0]].next;
+            deadline.tv_nsec = 0;
 
-       return(PSRP_OK);
+            (void)pthread_cond_timedwait(&psrp_cron_cond,&psrp_cron_mutex,&deadline);
+         }
     }
 
-    chtab = (chtab_type *)pups_realloc((void *)chtab,n_children*sizeof(chtab_type));
-    for(i=appl_max_files; i<n_children; ++i)
-        (void)pups_clear_chtab_slot(FALSE,i);
-    appl_max_child = n_children;
+    return((void *)NULL);
+}
 
-    (void)fprintf(psrp_out,"\n%d PUPS child table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                         appl_max_child,appl_name);
-    (void)fflush(psrp_out);
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&chtab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    return(PSRP_OK);
-}
 
+/*------------------------------------------------------------*/
+/* Cron thread does not survive fork. Payloads queued for our */
+/* parent are dropped and the cron service is restarted (from */
+/* the child's mainline) by psrp_fork, or by the next call to */
+/* schedule crontab activity                                  */
+/*------------------------------------------------------------*/
 
+_PRIVATE void psrp_cron_child(void)
 
+{   uint32_t i;
 
-#ifdef PERSISTENT_HEAP_SUPPORT
-/*-----------------------------------*/
-/* Extend PUPS persistent heap table */
-/*-----------------------------------*/
+    if(psrp_cron_threaded == FALSE)
+       return;
 
-_PRIVATE int32_t psrp_builtin_extend_htab(const uint32_t argc, const char *argv[])
+    (void)pthread_mutex_init(&psrp_cron_mutex,(pthread_mutexattr_t *)NULL);
+    (void)pthread_cond_init(&psrp_cron_cond,(pthread_condattr_t *)NULL);
 
-{   uint32_t n_pheaps;
+    for(i=0; i<MAX_CRON_SLOTS; ++i)
+       crontab[i].running = FALSE;
 
-    if(strcmp(argv[1],"htab") != 0)
-       return(PSRP_DISPATCH_ERROR);
+    psrp_cron_n_pending = 0;
+    psrp_cron_threaded  = FALSE;
+    psrp_cron_rearm     = TRUE;
+}
+#endif /* PTHREAD_SUPPORT */
 
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: htab [<maximum number of PUPS persistent heap table slots>]\n\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
 
-    if(argc == 1)
-    {  (void)fprintf(psrp_out,"\n%d PUPS persistent heap table slots available for PSRP server \"%s\"\n\n",
-                                                                                 appl_max_pheaps,appl_name);
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
+/*------------------------------------------------------------*/
+/* Start cron service. The crontab is serviced by a cron      */
+/* thread if we can start one -- it must not take any signals */
+/* (they are all handled by the root thread). Otherwise it is */
+/* serviced by the cron_homeostat virtual timer               */
+/*------------------------------------------------------------*/
 
-    if(sscanf(argv[1],"%d",&n_pheaps) != 1)
-    {  (void)fprintf(psrp_out,"\nExpecting maximum number of heaps (in PUPS persistent heap table)\n\n");
-       (void)fflush(psrp_out);
+_PRIVATE void psrp_cron_start(void)
 
-       return(PSRP_OK);
-    }
+{
+    #ifdef PTHREAD_SUPPORT
+    psrp_cron_rearm = FALSE;
 
-    if(n_pheaps < appl_max_pheaps)
-    {  (void)fprintf(psrp_out,"\nCannot shrink PUPS persistent heap table\n\n");
-       (void)fflush(psrp_out);
+    if(psrp_cron_threaded == FALSE)
+    {  sigset_t set,
+                old_set;
 
-       return(PSRP_OK);
-    }
+       _IMMORTAL _BOOLEAN atfork_registered = FALSE;
 
-    msm_extend(appl_max_pheaps,n_pheaps);
-    appl_max_pheaps = n_pheaps;
+       (void)pups_sighandle(SIGCRON,"psrp_cron_handler",(void *)psrp_cron_handler,(sigset_t *)NULL);
 
-    (void)fprintf(psrp_out,"\n%d PUPS persistent heap table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                                  appl_max_pheaps,appl_name);
-    (void)fflush(psrp_out);
+       (void)sigfillset(&set);
+       (void)pthread_sigmask(SIG_SETMASK,&set,&old_set);
 
-    return(PSRP_OK);
-}
-#endif /* PERSISTENT_HEAP_SUPPORT */
+       if(pthread_create(&psrp_cron_tid,(pthread_attr_t *)NULL,psrp_cron_thread,(void *)NULL) == 0)
+       {  (void)pthread_detach(psrp_cron_tid);
+          psrp_cron_threaded = TRUE;
 
+          if(atfork_registered == FALSE)
+          {  (void)pthread_atfork((void *)NULL,(void *)NULL,psrp_cron_child);
+             atfork_registered = TRUE;
+          }
+       }
 
+       (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
+    }
 
+    if(psrp_cron_threaded == TRUE)
+    {  (void)pups_clearvitimer("cron_homeostat");
+       return;
+    }
+    #endif /* PTHREAD_SUPPORT */
 
-#ifdef DLL_SUPPORT
-/*---------------------------------*/
-/* Extend PUPS orifice [DLL] table */
-/*---------------------------------*/
 
-_PRIVATE int32_t psrp_builtin_extend_ortab(const uint32_t argc, const char *argv[])
+    /*-----------------------------------------------------------*/
+    /* Add croncheck to the list of virtual interval timer tasks */
+    /*-----------------------------------------------------------*/
 
-{   uint32_t i,
-             n_orifices;
+    (void)pups_setvitimer("cron_homeostat",1,VT_CONTINUOUS,10,NULL,(void *)psrp_crontab_checkschedule);
+}
 
-    if(strcmp(argv[0],"ortab") != 0)
-       return(PSRP_DISPATCH_ERROR);
 
-    if(argc > 2)
-    {  (void)fprintf(psrp_out,"\nusage: ortab [<maximum number of PUPS orifice [DLL] table slots>]\n\n");
-       (void)fflush(psrp_out);
 
-       return(PSRP_OK);
-    }
 
-    if(argc == 1)
-    {  (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots available for PSRP server \"%s\"\n\n",
-                                                                              appl_max_orifices,appl_name);
-       (void)fflush(psrp_out);
+/*------------------------------------------------------------*/
+/* Check process circadian activity (crontab) schedule (only  */
+/* used if there is no cron thread). Only the head of the     */
+/* deadline queue is examined                                 */
+/*------------------------------------------------------------*/
 
-       return(PSRP_OK);
-    }
+_PRIVATE void psrp_crontab_checkschedule(char *args)
 
-    if(strcmp(argv[1],"shrink") != 0 && sscanf(argv[1],"%d",&n_orifices) != 1)
-    {  (void)fprintf(psrp_out,"\nExpecting maximum number of orifices (in PUPS orifice [DLL] table)\n\n");
-       (void)fflush(psrp_out);
+{   uint32_t i,
+             n_launch;
 
-       return(PSRP_OK);
-    }
+    int32_t  launch[MAX_CRON_SLOTS];
+    sigset_t old_set;
 
-    if(n_orifices < appl_max_orifices || strcmp(argv[1],"shrink") == 0)
-    {
+    psrp_cron_lock(&old_set);
+    n_launch = psrp_cron_run_due(time((time_t *)NULL),launch);
+    psrp_cron_unlock(&old_set);
 
-       /*---------------------------------------------*/
-       /* Find the high water mark for the file table */
-       /*---------------------------------------------*/
+    for(i=0; i<n_launch; ++i)
+       psrp_cron_launch(launch[i]);
+}
 
-       for(i=appl_max_orifices-1; i>0; --i)
-       {  if(ortab[i].orifice_handle == (void *)NULL)
-          {  uint32_t    j;
 
 
-             /*-----------------------------------------------------*/
-             /* We have found the high water mark return all memory */
-             /* above it to this processes free pool                */
-             /*-----------------------------------------------------*/
 
-             for(j=i; j<appl_max_orifices; ++j)
-                 (void)clear_ortab_slot(TRUE,j);
+/*------------------------------------------------------------*/
+/* Find free crontab slot (called with crontab locked)        */
+/*------------------------------------------------------------*/
 
-             appl_max_orifices = i + 1;
-             ortab = (ortab_type *)pups_realloc((void *)ortab,appl_max_orifices*sizeof(ortab_type));
+_PRIVATE int32_t psrp_cron_free_slot(void)
 
-             (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots now allocated for PSRP server \"%s\"\n\n",
-                                                                                       appl_max_orifices,appl_name);
-             (void)fflush(psrp_out);
-             return(PSRP_OK);
-          }
-       }
+{   uint32_t i;
 
-       (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] table slots allocated for PSRP server (unchanged) \"%s\"\n\n",
-                                                                                         appl_max_orifices,appl_name);
-       (void)fflush(psrp_out);
-       return(PSRP_OK);
+    for(i=0; i<MAX_CRON_SLOTS; ++i)
+    {  if(crontab[i].used == FALSE && crontab[i].running == FALSE)
+          return(i);
     }
 
-    ortab = (ortab_type *)pups_realloc((void *)ortab,n_orifices*sizeof(ortab_type));
-    for(i=appl_max_orifices; i<n_orifices; ++i)
-        clear_ortab_slot(FALSE,i);
-    appl_max_orifices = n_orifices;
-
-    (void)fprintf(psrp_out,"\n%d PUPS orifice [DLL] slots now allocated for PSRP server \"%s\"\n\n",
-                                                                        appl_max_orifices,appl_name);
-    (void)fflush(psrp_out);
-    return(PSRP_OK);
+    return(-1);
 }
-#endif /* DLL_SUPPORT */
 
 
 
 
-/*-----------------------------------------------------*/
-/* Check process circadian activity (crontab) schedule */
-/*-----------------------------------------------------*/
+/*--------------------------------------------------*/
+/* Schedule activity in (PSRP server) crontab table */
+/*--------------------------------------------------*/
 
-_PRIVATE void psrp_crontab_checkschedule(char *args)
+_PUBLIC int32_t psrp_crontab_schedule(const char *from, const char *to, const char *fname, const void *func)
 
-{   uint32_t i;
-     int32_t local_s;
+{   int32_t             ctab_index;
+    time_t              t;
+    sigset_t            old_set;
+    psrp_cron_spec_type start,
+                        stop;
 
-    time_t   t,
-             tdum;
+    (void)memset((void *)&stop,0,sizeof(psrp_cron_spec_type));
 
-    struct   tm *local_time = (struct tm *)NULL;
 
-    for(i=0; i<MAX_CRON_SLOTS; ++i)
-    {  if(crontab[i].from != (-1) && crontab[i].to != (-1)) 
-       {  t = time(&tdum);
-          local_time = localtime(&t);
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_crontab_schedule] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+
+    /*------------------------------------------------*/
+    /* Restart cron service if we have been forked    */
+    /*------------------------------------------------*/
 
+    #ifdef PTHREAD_SUPPORT
+    if(psrp_cron_rearm == TRUE)
+       psrp_cron_start();
+    #endif /* PTHREAD_SUPPORT */
+
+    if(from  == (const char *)NULL  ||
+       to    == (const char *)NULL  ||
+       fname == (const char *)NULL   )
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-          /*---------------------*/
-          /* Should we be awake? */
-          /*---------------------*/
 
-          if(crontab[i].overnight == TRUE)
-             local_s = local_time->tm_hour*3600  + local_time->tm_min*60    + local_time->tm_sec;
-          else
-             local_s = local_time->tm_mday*86400 + local_time->tm_hour*3600 + local_time->tm_min*60 + local_time->tm_sec;
+    /*------------------------------------------------*/
+    /* Window is [dd:]hh:mm to [dd:]hh:mm (or forever) */
+    /*------------------------------------------------*/
 
-          if(crontab[i].from >= local_s && crontab[i].to < local_s)
-          {  if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                (void)fprintf(stderr,"%s %s ($d@%s:%s): scheduling crontab event %d (%s)\n",
-                        date,appl_name,appl_pid,appl_host,appl_owner,i,crontab[i].fname);
-                (void)fflush(stderr);
-             }
+    if(psrp_cron_window_time(from,&start) == (-1)                              ||
+       (strcmp(to,"forever") != 0 && psrp_cron_window_time(to,&stop) == (-1))  )
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
+    psrp_cron_lock(&old_set);
 
-             /*----------------------------------------------------------*/
-             /* If the entry in the crontab has no computational payload */
-             /* simply sleep for the requisite period                    */
-             /*----------------------------------------------------------*/
+    if((ctab_index = psrp_cron_free_slot()) == (-1))
+    {  psrp_cron_unlock(&old_set);
 
-             if(crontab[i].func == (void *)NULL)
-             {  do {   (void)pups_usleep(1000000);
+       pups_set_errno(ENOMEM);
+       return(-1);
+    }
 
-                       t = time(&tdum);
-                       local_time = localtime(&t);
+    crontab[ctab_index].used    = TRUE;
+    crontab[ctab_index].window  = TRUE;
+    crontab[ctab_index].forever = FALSE;
+    if(strcmp(to,"forever") == 0)
+       crontab[ctab_index].forever = TRUE;
+    crontab[ctab_index].active  = FALSE;
+    crontab[ctab_index].start   = start;
+    crontab[ctab_index].stop    = stop;
+    crontab[ctab_index].jitter  = 0;
+    crontab[ctab_index].runs    = 0;
+    crontab[ctab_index].func    = func;
 
+    (void)strlcpy(crontab[ctab_index].fname,fname,SSIZE);
+    (void)strlcpy(crontab[ctab_index].fromdate,from,SSIZE);
+    (void)strlcpy(crontab[ctab_index].todate  ,to,SSIZE);
 
-                       /*---------------------*/
-                       /* Should we be awake? */
-                       /*---------------------*/
 
-                       if(crontab[i].overnight == TRUE)
-                          local_s = local_time->tm_hour*3600  + local_time->tm_min*60    + local_time->tm_sec;
-                       else
-                          local_s = local_time->tm_mday*86400 + local_time->tm_hour*3600 + local_time->tm_min*60 + local_time->tm_sec;
-                   } while(crontab[i].from >= local_s && crontab[i].to < local_s);
-             }
-             else
-             {  
+    /*------------------------------------------------------*/
+    /* If we are already inside the window (it closes       */
+    /* before it next opens) open it now                    */
+    /*------------------------------------------------------*/
 
-                /*--------------------------------------------------*/
-                /* Launch computational payload  - note we pass the */
-                /* payload function its crontab slot so it can stop */
-                /*--------------------------------------------------*/
+    t = time((time_t *)NULL);
 
-                (*crontab[i].func)(i);              
-             }
+    if(strcmp(from,"now") == 0 || (crontab[ctab_index].forever == FALSE && psrp_cron_next(&stop,t) < psrp_cron_next(&start,t)))
+       crontab[ctab_index].due = t;
+    else
+       crontab[ctab_index].due = psrp_cron_next(&start,t);
 
-             if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                (void)fprintf(stderr,"%s %s ($d@%s:%s): crontab event %d (%s) finished\n",
-                              date,appl_name,appl_pid,appl_host,appl_owner,i,crontab[i].fname);
-                (void)fflush(stderr);
-             }
-          }
-       }
-    }
-}
+    crontab[ctab_index].next = crontab[ctab_index].due;
 
+    if(crontab[ctab_index].due != (time_t)(-1))
+       psrp_cron_heap_push(ctab_index);
 
+    psrp_cron_unlock(&old_set);
 
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       if(func == (void *)NULL)
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): [crontab slot %d] no activity scheduled between %s and %s\n\n",
+                                                 date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,from,to);
+       else
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): [crontab slot %d]  \"%-32s\" (at %016lx virtual) scheduled between %s and %s\n\n",
+                                      date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,fname,(uint64_t         )func,from,to);
 
-/*--------------------------------------------------*/
-/* Schedule activity in (PSRP server) crontab table */
-/*--------------------------------------------------*/
+       (void)fflush(stderr);
+    }
 
-_PUBLIC int32_t psrp_crontab_schedule(const char *from, const char *to, const char *fname, const void *func)
+    pups_set_errno(OK);
+    return(ctab_index);
+}
 
-{   uint32_t  i,
-              ctab_index;
 
-     int32_t  to_h,
-              to_m,
-              to_d,
-              from_h,
-              from_m,
-              from_d,
-              to_s,
-              from_s;
 
-    _BOOLEAN  do_from_now  = FALSE;
 
-    time_t    t,
-              tdum;
+/*------------------------------------------------------------*/
+/* Schedule activity in (PSRP server) crontab table using     */
+/* (five field) cron expression                               */
+/*------------------------------------------------------------*/
 
-    struct tm *local_time  = (struct tm *)NULL;
+_PUBLIC int32_t psrp_crontab_schedule_cron(const char *expression, const char *fname, const void *func)
 
-    char      sfrom[SSIZE] = "",
-              sto[SSIZE]   = "";
+{   int32_t             ctab_index;
+    sigset_t            old_set;
+    psrp_cron_spec_type start;
 
 
     /*----------------------------------*/
@@ -11435,138 +16969,111 @@ _PUBLIC int32_t psrp_crontab_schedule(const char *from, const char *to, const ch
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[psrp_crontab_schedule] attempt by non root thread to perform PUPS/P3 PSRP operation");
+       pups_error("[psrp_crontab_schedule_cron] attempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(from  == (const char *)NULL  ||
-       to    == (const char *)NULL  ||
-       fname == (const char *)NULL  ||
-       func  == (const void *)NULL   )
+
+    /*------------------------------------------------*/
+    /* Restart cron service if we have been forked    */
+    /*------------------------------------------------*/
+
+    #ifdef PTHREAD_SUPPORT
+    if(psrp_cron_rearm == TRUE)
+       psrp_cron_start();
+    #endif /* PTHREAD_SUPPORT */
+
+    if(expression == (const char *)NULL  ||
+       fname      == (const char *)NULL  ||
+       func       == (const void *)NULL  ||
+       psrp_cron_parse(expression,&start) == (-1))
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
+    psrp_cron_lock(&old_set);
 
-    /*------------------------------------------------*/
-    /* Find a free slot in the crontab data structure */
-    /*------------------------------------------------*/
+    if((ctab_index = psrp_cron_free_slot()) == (-1))
+    {  psrp_cron_unlock(&old_set);
 
-    for(i=0; i<MAX_CRON_SLOTS; ++i)
-    {  if(strcmp(crontab[i].fname,"notset") == 0)
-       {  ctab_index = i;
-          goto cronslot_found;
-       }
+       pups_set_errno(ENOMEM);
+       return(-1);
     }
 
-    pups_set_errno(ENOMEM);
-    return(-1);
-
-cronslot_found:
+    crontab[ctab_index].used    = TRUE;
+    crontab[ctab_index].window  = FALSE;
+    crontab[ctab_index].forever = FALSE;
+    crontab[ctab_index].active  = FALSE;
+    crontab[ctab_index].start   = start;
+    crontab[ctab_index].jitter  = 0;
+    crontab[ctab_index].runs    = 0;
+    crontab[ctab_index].func    = func;
 
+    (void)strlcpy(crontab[ctab_index].fname,fname,SSIZE);
+    (void)strlcpy(crontab[ctab_index].fromdate,expression,SSIZE);
+    (void)strlcpy(crontab[ctab_index].todate,"-",SSIZE);
 
-    /*---------------------------------------------------------*/
-    /* We have a free crontab slot -- add schedule information */
-    /* to it.                                                  */
-    /*---------------------------------------------------------*/
+    psrp_cron_queue_start(ctab_index,time((time_t *)NULL));
+    psrp_cron_unlock(&old_set);
 
-    for(i=0; i<strlen(from); ++i)
-    {  if(from[i] == ':')
-          sfrom[i] = ' ';
-       else
-          sfrom[i] = from[i];
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): [crontab slot %d]  \"%-32s\" (at %016lx virtual) scheduled at \"%s\"\n\n",
+                                date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,fname,(uint64_t)func,expression);
+       (void)fflush(stderr);
     }
 
-    if(strcmp(sfrom,"now") == 0)
-    {  t          = time(&tdum);
-       local_time = localtime(&t);
+    pups_set_errno(OK);
+    return(ctab_index);
+}
 
-       from_d = local_time->tm_mday;
-       from_h = local_time->tm_hour;
-       from_m = local_time->tm_min;
 
-       do_from_now = TRUE;
-    }
-    else if(sscanf(sfrom,"%d%d%d",&from_d,&from_h,&from_m) != 3)
-    {  if(sscanf(sfrom,"%d%d",&from_h,&from_m) != 2)
-       {  pups_set_errno(EINVAL);
-          return(-1);
-       }
 
-       from_d = 0;
-    }    
 
-    if(from_h < 0 || from_h > 24 || from_m < 0 || from_m > 60)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+/*------------------------------------------------------------*/
+/* Set maximum random delay (in seconds) added to each start  */
+/* of crontab activity (spreads load from servers which share */
+/* the same schedule)                                         */
+/*------------------------------------------------------------*/
 
-    for(i=0; i<strlen(to); ++i)
-       if(to[i] == ':')
-          sto[i] = ' ';
-       else
-          sto[i] = to[i];
+_PUBLIC int32_t psrp_crontab_set_jitter(const uint32_t ctab_index, const uint32_t jitter)
 
-    if(strcmp(to,"forever") == 0)
-       to_s = INT_MAX;
-    else if(sscanf(sto,"%d%d%d",&to_d,&to_h,&to_m) != 3)
-    {  if(sscanf(sto,"%d%d",&to_h,&to_m) != 2)
-       {  pups_set_errno(EINVAL);
-          return(-1);
-       }
+{   sigset_t old_set;
 
-       if(do_from_now == TRUE)
-          to_d = local_time->tm_mday;
-       else
-          to_d = 0;
-    }
 
-    if(to_h < 0 || to_h > 24 || to_m < 0 || to_m > 60)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    if(from_d == 0 && to_d != 0 || from_d != 0 && to_d == 0)
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[psrp_crontab_set_jitter] attempt by non root thread to perform PUPS/P3 PSRP operation");
+
+    if(ctab_index >= MAX_CRON_SLOTS || crontab[ctab_index].used == FALSE)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    if(from_h > to_h)
-    {  t          = time(&tdum);
-       local_time = localtime(&t);
-       from_d     = local_time->tm_mday;
-       to_d       = from_d + 1;
-
-       crontab[ctab_index].overnight = TRUE;
-    }
-    else
-       crontab[ctab_index].overnight = FALSE;
+    psrp_cron_lock(&old_set);
 
-    from_s = from_d*86400 + from_h*3600 + from_m*60;
-    to_s   = to_d* 86400  + to_h*3600   + to_m*60;
+    crontab[ctab_index].jitter = jitter;
+    crontab[ctab_index].seed   = (uint32_t)(appl_pid ^ (ctab_index << 16) ^ time((time_t *)NULL));
 
 
     /*------------------------------------------------------*/
-    /* We can finally add the time data to the crontab slot */
+    /* Re-queue pending start so jitter applies immediately */
     /*------------------------------------------------------*/
 
-    crontab[ctab_index].from  = from_s;
-    crontab[ctab_index].to    = to_s;
-    crontab[ctab_index].func  = func;
-    (void)strlcpy(crontab[ctab_index].fname,fname,SSIZE);
-    (void)strlcpy(crontab[ctab_index].fromdate,from,SSIZE);
-    (void)strlcpy(crontab[ctab_index].todate  ,to,SSIZE);
+    if(crontab[ctab_index].heap_index != (-1) && crontab[ctab_index].active == FALSE)
+    {  psrp_cron_heap_remove(ctab_index);
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       if(crontab[ctab_index].func  == (void *)NULL)
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): [crontab slot %d] no activity scheduled between %s and %s\n\n",
-                                                 date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,from,to);
-       else
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): [crontab slot %d]  \"%-32s\" (at %016lx virtual) scheduled between %s and %s\n\n",
-                                      date,appl_name,appl_pid,appl_host,appl_owner,ctab_index,fname,(uint64_t         )func,from,to);
+       crontab[ctab_index].next = crontab[ctab_index].due;
+       if(jitter > 0)
+          crontab[ctab_index].next += rand_r(&crontab[ctab_index].seed) % (jitter + 1);
 
-       (void)fflush(stderr);
+       psrp_cron_heap_push(ctab_index);
     }
 
+    psrp_cron_unlock(&old_set);
+
     pups_set_errno(OK);
     return(0);
 }
@@ -11574,13 +17081,34 @@ cronslot_found:
 
 
 
+/*------------------------------------------------------------*/
+/* Is crontab activity window open (or its payload running)   */
+/*------------------------------------------------------------*/
+
+_PUBLIC _BOOLEAN psrp_crontab_active(const uint32_t ctab_index)
+
+{   if(ctab_index >= MAX_CRON_SLOTS)
+    {  pups_set_errno(EINVAL);
+       return(FALSE);
+    }
+
+    pups_set_errno(OK);
+    if(crontab[ctab_index].active == TRUE || crontab[ctab_index].running == TRUE)
+       return(TRUE);
+
+    return(FALSE);
+}
+
+
+
+
 /*-------------------------------------------*/
 /* Unschedule PSRP server (crontab) activity */
 /*-------------------------------------------*/
 
 _PUBLIC int32_t psrp_crontab_unschedule(const uint32_t ctab_index)
 
-{   uint32_t i;
+{   sigset_t old_set;
 
 
     /*----------------------------------*/
@@ -11591,34 +17119,38 @@ _PUBLIC int32_t psrp_crontab_unschedule(const uint32_t ctab_index)
     if(pupsthread_is_root_thread() == FALSE)
        pups_error("[psrp_crontab_unschedule] mattempt by non root thread to perform PUPS/P3 PSRP operation");
 
-    if(ctab_index >= MAX_CRON_SLOTS)
+    if(ctab_index >= MAX_CRON_SLOTS || crontab[ctab_index].used == FALSE)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    if(crontab[ctab_index].from != (-1) && crontab[ctab_index].to != (-1))
-    {  crontab[ctab_index].to        = (-1);
-       crontab[ctab_index].from      = (-1);
-       crontab[ctab_index].overnight = FALSE;
-       crontab[ctab_index].func      = (void *)NULL;
+    psrp_cron_lock(&old_set);
+    psrp_cron_heap_remove(ctab_index);
 
-       (void)strlcpy(crontab[ctab_index].fname   ,"notset",SSIZE);
-       (void)strlcpy(crontab[ctab_index].fromdate,"notset",SSIZE);
-       (void)strlcpy(crontab[ctab_index].todate  ,"notset",SSIZE);
 
-       if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): crontab slot [%d] cleared\n",
-                        date,appl_name,appl_pid,appl_host,appl_owner,ctab_index);
-          (void)fflush(stderr);
-       }
+    /*-------------------------------------------------*/
+    /* A running payload is left to finish (its slot   */
+    /* is not reused until it has)                     */
+    /*-------------------------------------------------*/
 
-       pups_set_errno(OK);
-       return(-1);
+    crontab[ctab_index].used   = FALSE;
+    crontab[ctab_index].active = FALSE;
+
+    (void)strlcpy(crontab[ctab_index].fname   ,"notset",SSIZE);
+    (void)strlcpy(crontab[ctab_index].fromdate,"notset",SSIZE);
+    (void)strlcpy(crontab[ctab_index].todate  ,"notset",SSIZE);
+
+    psrp_cron_unlock(&old_set);
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): crontab slot [%d] cleared\n",
+                     date,appl_name,appl_pid,appl_host,appl_owner,ctab_index);
+       (void)fflush(stderr);
     }
 
-    pups_set_errno(EINVAL);
-    return(-1);
+    pups_set_errno(OK);
+    return(0);
 }
 
 
@@ -11647,22 +17179,25 @@ _PUBLIC void psrp_crontab_init(void)
     /*-----------------------------------*/
 
     for(i=0; i<MAX_CRON_SLOTS; ++i)
-    {  crontab[i].from      = (-1);
-       crontab[i].to        = (-1);
-       crontab[i].overnight = FALSE;
-       crontab[i].func      = (void *)NULL;
+    {  crontab[i].used       = FALSE;
+       crontab[i].active     = FALSE;
+       crontab[i].running    = FALSE;
+       crontab[i].heap_index = (-1);
+       crontab[i].func       = (void *)NULL;
  
        (void)strlcpy(crontab[i].fname,   "notset",SSIZE);
        (void)strlcpy(crontab[i].fromdate,"notset",SSIZE);
        (void)strlcpy(crontab[i].todate,  "notset",SSIZE);
     }
 
+    psrp_cron_heap_size = 0;
 
-    /*-----------------------------------------------------------*/
-    /* Add croncheck to the list of virtual interval timer tasks */
-    /*-----------------------------------------------------------*/
 
-    (void)pups_setvitimer("cron_homeostat",1,VT_CONTINUOUS,10,NULL,(void *)psrp_crontab_checkschedule);
+    /*---------------------------------------------*/
+    /* Start cron thread (or cron_homeostat timer) */
+    /*---------------------------------------------*/
+
+    psrp_cron_start();
 
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
@@ -11683,8 +17218,14 @@ _PUBLIC void psrp_crontab_init(void)
 
 _PUBLIC  int32_t psrp_show_crontab(const FILE *stream)
 
-{   uint32_t i,
-             cront = 0;
+{   uint32_t  i,
+              cront = 0;
+
+    sigset_t  old_set;
+    struct tm next_time;
+
+    char      next_str[SSIZE] = "",
+              state_str[SSIZE] = "";
 
 
     /*----------------------------------*/
@@ -11704,20 +17245,51 @@ _PUBLIC  int32_t psrp_show_crontab(const FILE *stream)
     (void)fprintf(stream,"    ================\n\n");
     (void)fflush(stream);
 
+    psrp_cron_lock(&old_set);
+
     for(i=0; i<MAX_CRON_SLOTS; ++i)
-    {  if(crontab[i].from > 0)
-       {  if(crontab[i].func != (void *)NULL)
-             (void)fprintf(stream,"    %04d: (payload \"%-32s\" at %016lx virtual) start: %-32s, stop %-32s\n",
-                                                                                                             i,
-                                                                                              crontab[i].fname,
-                                                                            (uint64_t         )crontab[i].func,
-                                                                                           crontab[i].fromdate,
-                                                                                            crontab[i].todate);
+    {  if(crontab[i].used == TRUE)
+       {  if(crontab[i].heap_index != (-1))
+          {  (void)localtime_r(&crontab[i].next,&next_time);
+             (void)strftime(next_str,SSIZE,"%a %b %d %H:%M:%S %Y",&next_time);
+          }
+          else
+             (void)strlcpy(next_str,"none",SSIZE);
+
+          if(crontab[i].running == TRUE)
+             (void)strlcpy(state_str,"running",SSIZE);
+          else if(crontab[i].active == TRUE)
+             (void)strlcpy(state_str,"open",SSIZE);
           else
-             (void)fprintf(stream,"    %04d: (inactivity) start: %-32s, stop %-32s\n",
-                                                                                    i,
-                                                                  crontab[i].fromdate,
-                                                                    crontab[i].todate);
+             (void)strlcpy(state_str,"idle",SSIZE);
+
+          if(crontab[i].window == FALSE)
+             (void)fprintf(stream,"    %04d: (payload \"%-32s\" at %016lx virtual) cron: \"%s\", next: %s, jitter %d secs, runs %lu [%s]\n",
+                                                                                                                                       i,
+                                                                                                                        crontab[i].fname,
+                                                                                                       (uint64_t         )crontab[i].func,
+                                                                                                                     crontab[i].fromdate,
+                                                                                                                                next_str,
+                                                                                                                       crontab[i].jitter,
+                                                                                                                         crontab[i].runs,
+                                                                                                                               state_str);
+          else if(crontab[i].func != (void *)NULL)
+             (void)fprintf(stream,"    %04d: (payload \"%-32s\" at %016lx virtual) start: %-32s, stop %-32s, next: %s, jitter %d secs [%s]\n",
+                                                                                                                                       i,
+                                                                                                                        crontab[i].fname,
+                                                                                                       (uint64_t         )crontab[i].func,
+                                                                                                                     crontab[i].fromdate,
+                                                                                                                       crontab[i].todate,
+                                                                                                                                next_str,
+                                                                                                                       crontab[i].jitter,
+                                                                                                                               state_str);
+          else
+             (void)fprintf(stream,"    %04d: (inactivity) start: %-32s, stop %-32s, next: %s [%s]\n",
+                                                                                                   i,
+                                                                                 crontab[i].fromdate,
+                                                                                   crontab[i].todate,
+                                                                                            next_str,
+                                                                                           state_str);
 
           (void)fflush(stream);
 
@@ -11725,6 +17297,8 @@ _PUBLIC  int32_t psrp_show_crontab(const FILE *stream)
        }
     }
 
+    psrp_cron_unlock(&old_set);
+
     if(cront == 0)
        (void)fprintf(stream,"\n\n    No crontab tasks scheduled (%04d slots free)\n\n",MAX_CRON_SLOTS);
     else if(cront == 1)
@@ -11741,45 +17315,116 @@ _PUBLIC  int32_t psrp_show_crontab(const FILE *stream)
 
 
 
+
 /*-------------------------------------*/
 /* Add scheduling slot to PSRP crontab */
 /*-------------------------------------*/
 
 _PRIVATE int32_t psrp_builtin_crontab_schedule(const uint32_t argc, const char *argv[])
 
-{   if(strcmp("schedule",argv[0]) != 0)
+{   uint32_t   i,
+               jitter;
+
+     int32_t   ctab_index,
+               slot_index;
+
+    _BOOLEAN   cron             = FALSE;
+    void       *func            = (void *)NULL;
+    const char *payload         = (const char *)NULL;
+    char       expression[SSIZE] = "";
+
+    if(strcmp("schedule",argv[0]) != 0)
        return(PSRP_DISPATCH_ERROR);
 
     if(argc < 3)
-    {  (void)fprintf(psrp_out,"\nusage: schedule !from! !to! [payload computation]\n\n");
+    {  (void)fprintf(psrp_out,"\nusage: schedule !from! !to! [payload computation]\n");
+       (void)fprintf(psrp_out,"       schedule cron !min! !hour! !mday! !month! !wday! !payload computation!\n");
+       (void)fprintf(psrp_out,"       schedule cron !@hourly | @daily | @weekly | @monthly | @yearly! !payload computation!\n");
+       (void)fprintf(psrp_out,"       schedule jitter !crontab slot index! !secs!\n\n");
        (void)fflush(psrp_out);
 
        return(PSRP_OK);
     }
 
-    if(argc > 3)
-    {  int32_t slot_index;
-       void    *func = (void *)NULL;
 
-       slot_index = psrp_find_action_slot_index(argv[3]);
-       if(slot_index != (-1)                                                   &&
-          psrp_object_list[slot_index].object_type == PSRP_DYNAMIC_FUNCTION    ||
-          psrp_object_list[slot_index].object_type == PSRP_STATIC_FUNCTION      )
-          psrp_crontab_schedule(argv[1],argv[2],argv[3],psrp_object_list[slot_index].object_handle);
+    /*---------------------------------------------------*/
+    /* Set maximum random delay for crontab slot         */
+    /*---------------------------------------------------*/
+
+    if(strcmp(argv[1],"jitter") == 0)
+    {  if(argc != 4                               ||
+          sscanf(argv[2],"%d",&ctab_index) != 1   ||
+          sscanf(argv[3],"%u",&jitter)     != 1   ||
+          psrp_crontab_set_jitter(ctab_index,jitter) == (-1))
+          (void)fprintf(psrp_out,"\ncannot set jitter for crontab slot \"%s\"\n\n",argv[2]);
        else
-       {  (void)fprintf(psrp_out,"\nobject \"%s\" is not executable\n\n");
+          (void)fprintf(psrp_out,"\ncrontab slot %d jitter is now %d seconds\n\n",ctab_index,jitter);
+
+       (void)fflush(psrp_out);
+       return(PSRP_OK);
+    }
+
+
+    /*---------------------------------------------------*/
+    /* Cron expression is either an @ shorthand or five  */
+    /* fields, the payload computation is always last    */
+    /*---------------------------------------------------*/
+
+    if(strcmp(argv[1],"cron") == 0)
+    {  if(argc != 4 && argc != 8)
+       {  (void)fprintf(psrp_out,"\nexpecting cron expression (five fields or @ shorthand) and payload computation\n\n");
+          (void)fflush(psrp_out);
+
+          return(PSRP_OK);
+       }
+
+       for(i=2; i<argc-1; ++i)
+       {  if(i > 2)
+             (void)strlcat(expression," ",SSIZE);
+          (void)strlcat(expression,argv[i],SSIZE);
+       }
+
+       cron    = TRUE;
+       payload = argv[argc - 1];
+    }
+    else if(argc > 3)
+       payload = argv[3];
+
+    if(payload != (const char *)NULL)
+    {  slot_index = psrp_find_action_slot_index(payload);
+
+       if(slot_index == (-1)                                                     ||
+          (psrp_object_list[slot_index].object_type != PSRP_DYNAMIC_FUNCTION    &&
+           psrp_object_list[slot_index].object_type != PSRP_STATIC_FUNCTION      ))
+       {  (void)fprintf(psrp_out,"\nobject \"%s\" is not executable\n\n",payload);
           (void)fflush(psrp_out);
+
+          return(PSRP_OK);
        }
+
+       func = psrp_object_list[slot_index].object_handle;
     }
+
+    if(cron == TRUE)
+       ctab_index = psrp_crontab_schedule_cron(expression,payload,func);
+    else if(payload != (const char *)NULL)
+       ctab_index = psrp_crontab_schedule(argv[1],argv[2],payload,func);
     else
-       (void)psrp_crontab_schedule(argv[1],argv[2],"notset",(void *)NULL);
+       ctab_index = psrp_crontab_schedule(argv[1],argv[2],"notset",(void *)NULL);
 
+    if(ctab_index == (-1))
+       (void)fprintf(psrp_out,"\ncannot schedule activity (invalid schedule or crontab full)\n\n");
+    else
+       (void)fprintf(psrp_out,"\nactivity scheduled (crontab slot %d)\n\n",ctab_index);
+
+    (void)fflush(psrp_out);
     return(PSRP_OK);
 }
 
 
 
 
+
 /*------------------------------------------*/
 /* Remove scheduling slot from PSRP crontab */
 /*------------------------------------------*/
@@ -11801,6 +17446,8 @@ _PRIVATE int32_t psrp_builtin_crontab_unschedule(const uint32_t argc, const char
     if(sscanf(argv[1],"%d",&ctab_index) != 1)
     {  (void)fprintf(psrp_out,"\ncrontab index must be an integer (range 0 to %d)\n",MAX_CRON_SLOTS - 1);
        (void)fflush(psrp_out);
+
+       return(PSRP_OK);
     }
 
     (void)psrp_crontab_unschedule(ctab_index);
@@ -13103,6 +18750,14 @@ done:
     appl_pid = getpid();
 
 
+    /*----------------------------------------------------*/
+    /* Register (child) process name. The registry slot   */
+    /* we inherited belongs to our parent                 */
+    /*----------------------------------------------------*/
+
+    (void)psrp_pnreg_register(appl_name);
+
+
     /*---------------------------------------*/
     /* Create standard I/O for this process. */
     /*---------------------------------------*/
@@ -13209,9 +18864,14 @@ done:
     (void)sigprocmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
 
 
-    /*---------------------*/
-    /* Restart homeostasis */
-    /*---------------------*/
+    /*------------------------------------------*/
+    /* Restart homeostasis (and cron service)   */
+    /*------------------------------------------*/
+
+    #ifdef PTHREAD_SUPPORT
+    if(psrp_cron_rearm == TRUE)
+       psrp_cron_start();
+    #endif /* PTHREAD_SUPPORT */
 
     (void)pups_vitrestart();
 
@@ -14939,17 +20599,18 @@ _PUBLIC char **psrp_process_sic_transaction_list(const char      *hostname,  //
                  				 const           *requests)  // Request list
 #endif /* SSH_SUPPORT */
 
-{   uint32_t i;
-
-    int32_t  ret,
-             eff_n_requests;
+{   uint32_t i,
+             sent                 = 0,
+             collected            = 0,
+             n_split              = 0,
+             eff_n_requests       = 0;
 
     _BOOLEAN looper               = FALSE,
+             healthy              = TRUE,
              ignore_replys        = FALSE;
 
     char     sic_name[SSIZE]      = "",
-             next_request[SSIZE]  = "",
-             *reply               = (char *)NULL,
+             **request_list       = (char **)NULL,
              **replys             = (char **)NULL;
 
     psrp_channel_type *sic        = (psrp_channel_type *)NULL;
@@ -14981,14 +20642,18 @@ _PUBLIC char **psrp_process_sic_transaction_list(const char      *hostname,  //
     /*-----------------------------*/
 
     if(n_requests < 0)
-    {  eff_n_requests *= (-1);
-       ignore_replys   =  TRUE;
+    {  eff_n_requests = (uint32_t)(-n_requests);
+       ignore_replys  =  TRUE;
     }
+    else
+       eff_n_requests = (uint32_t)n_requests;
 
 
-    /*--------------------------------------------*/
-    /* Create SIC channels for slaved interaction */
-    /*--------------------------------------------*/
+    /*--------------------------------------------------------*/
+    /* Get SIC channels for slaved interaction (from the SIC */
+    /* pool, so repeated transactions with the same host     */
+    /* reuse a warm channel)                                 */
+    /*--------------------------------------------------------*/
     /*----------------------------*/
     /* Identifier for SIC channel */
     /*----------------------------*/
@@ -15003,11 +20668,7 @@ _PUBLIC char **psrp_process_sic_transaction_list(const char      *hostname,  //
     if(hostname == (const char *)NULL)
     {  
 
-       #ifdef SSH_SUPPORT
-       if((sic = psrp_create_slaved_interaction_client((char *)NULL,"","pslave")) == (psrp_channel_type *)NULL)
-       #else
-       if((sic = psrp_create_slaved_interaction_client("pslave")) == (psrp_channel_type *)NULL)
-       #endif /* SSH_SUPPORT */
+       if((sic = psrp_sic_pool_get((char *)NULL,"","pslave")) == (psrp_channel_type *)NULL)
 
        {  if(appl_verbose == TRUE)
           {  (void)strdate(date);
@@ -15043,7 +20704,7 @@ _PUBLIC char **psrp_process_sic_transaction_list(const char      *hostname,  //
        else
           (void)strlcpy(eff_ssh_port,ssh_port,SSIZE);
 
-       if((sic = psrp_create_slaved_interaction_client(hostname,eff_ssh_port,"pslave")) == (psrp_channel_type *)NULL)
+       if((sic = psrp_sic_pool_get(hostname,eff_ssh_port,"pslave")) == (psrp_channel_type *)NULL)
        {  if(appl_verbose == TRUE)
           {  (void)strdate(date);
              (void)fprintf(stderr,"%s %s (%d@%s:%s): SIC creation failed\n",date,appl_name,appl_pid,appl_host,appl_owner);
@@ -15065,49 +20726,85 @@ _PUBLIC char **psrp_process_sic_transaction_list(const char      *hostname,  //
     /* Create buffer for replies */
     /*---------------------------*/
 
-    replys = (char **)pups_calloc(eff_n_requests,sizeof(char *));
+    replys       = (char **)pups_calloc(eff_n_requests,sizeof(char *));
+    request_list = (char **)pups_calloc(eff_n_requests,sizeof(char *));
 
 
-    /*----------------------------------*/
-    /* Send requests and collect replys */
-    /*----------------------------------*/
+    /*--------------------*/
+    /* Split request list */
+    /*--------------------*/
 
     (void)strext(' ',(char *)NULL,(char *)NULL);
     for(i=0; i<eff_n_requests; ++i)
-    {   looper = strext(';',next_request,requests);
+    {   request_list[i] = (char *)pups_calloc(SSIZE,sizeof(char));
+        looper          = strext(';',request_list[i],requests);
 
         #ifdef PSRPLIB_DEBUG
-        (void)fprintf(stderr,"REQUEST %d: \"%s\"\n",i,next_request);
+        (void)fprintf(stderr,"REQUEST %d: \"%s\"\n",i,request_list[i]);
         (void)fflush(stderr);
         #endif /* PSRPLIB_DEBUG */
 
-        if(looper != FALSE)
-        {  if(ignore_replys == FALSE)
-           {  if((reply = psrp_slaved_client_transaction(TRUE,sic,next_request)) != (char *)NULL) 
-                 replys[i] = reply;
+        ++n_split;
+        if(looper == FALSE)
+           break;
+    }
+    eff_n_requests = i;
 
-              #ifdef PSRPLIB_DEBUG
-              (void)fprintf(stderr,"REPLY %d: \"%s\"\n",i,reply);
-              (void)fflush(stderr);
-              #endif /* PSRPLIB_DEBUG */
 
-           }
-           else
-              (void)psrp_slaved_client_transaction(FALSE,sic, next_request);
-        }
+    /*-----------------------------------------------------------------*/
+    /* Send requests and collect replys. Requests are pipelined: up to */
+    /* PSRP_PIPELINE_WINDOW requests are queued on the slaved client's */
+    /* input before we wait for a reply, so we do not pay a round trip */
+    /* (which may be over ssh) for every request. The slaved client    */
+    /* processes requests in order so replies are too                  */
+    /*-----------------------------------------------------------------*/
+
+    while(collected < sent || sent < eff_n_requests)
+    {  while(sent < eff_n_requests && sent - collected < PSRP_PIPELINE_WINDOW)
+       {  if(psrp_write_sic(sic,request_list[sent]) < 0)
+          {  
+
+             /*-------------------------------------------------------*/
+             /* Send failed - collect replies to requests which have  */
+             /* already been sent, but don't send any more            */
+             /*-------------------------------------------------------*/
+
+             eff_n_requests = sent;
+             healthy        = FALSE;
+             break;
+          }
+
+          ++sent;
+       }
+
+       if(collected < sent)
+       {  replys[collected] = psrp_read_sic_reply((ignore_replys == FALSE) ? TRUE : FALSE,sic);
+
+          #ifdef PSRPLIB_DEBUG
+          (void)fprintf(stderr,"REPLY %d: \"%s\"\n",collected,replys[collected]);
+          (void)fflush(stderr);
+          #endif /* PSRPLIB_DEBUG */
+
+          ++collected;
+       }
     }
 
+    for(i=0; i<n_split; ++i)
+       (void)pups_free((void *)request_list[i]);
+
+    (void)pups_free((void *)request_list);
+
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
        (void)fprintf(stderr,"%s %s (%d@%s:%s): SIC transaction done\n",date,appl_name,appl_pid,appl_host,appl_owner);
        (void)fflush(stderr);
     }
 
-    (void) psrp_destroy_slaved_interaction_client(sic,TRUE);
+    psrp_sic_pool_put(sic,healthy);
 
     if(appl_verbose == TRUE)
     {  (void)strdate(date);
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): SIC channel closed\n",date,appl_name,appl_pid,appl_host,appl_owner);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): SIC channel released\n",date,appl_name,appl_pid,appl_host,appl_owner);
        (void)fflush(stderr);
     }
 
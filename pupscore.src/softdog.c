@@ -1,13 +1,13 @@
 /*----------------------------------------
-    Purpose: Per process software watchdog 
+    Purpose: Process software watchdog
 
     Author:  Mark A. O'Neill
              Tumbling Dice
              Gosforth
-             NE3 4RT 
+             NE3 4RT
 
-    Version: 1.02 
-    Date:    11th December 2024 
+    Version: 2.00
+    Date:    19th October 2026
     Email:   mao@tumblingdice.co.uk
 ---------------------------------------*/
 
@@ -23,9 +23,20 @@
 #include <signal.h>
 #include <time.h>
 #include <stdint.h>
-
-
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#include <softdog.h>
+
+
+#ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE
+#endif /* _XOPEN_SOURCE */
 #include <unistd.h>
 
 
@@ -33,8 +44,8 @@
 /* Defines */
 /*---------*/
 
-#define SOFTDOG_VERSION         "1.02" 
-#define DEFAULT_SOFTDOG_TIMEOUT  60 
+#define SOFTDOG_VERSION         "2.00"
+#define DEFAULT_SOFTDOG_TIMEOUT  60
 
 
 /*-------------*/
@@ -44,200 +55,630 @@
 #define SSIZE                    2048
 
 
-/*----------------------*/
-/* Signaction structure */
-/*----------------------*/
+/*--------------------------------------------------*/
+/* Event sources (tag in upper half of epoll data)  */
+/*--------------------------------------------------*/
+
+#define EV_TIMER                 0
+#define EV_SIGNAL                1
+#define EV_TABLE                 2
+#define EV_PROCESS               3
+
+#define MAX_EVENTS               64
+
+
+/*------------------------------------------------*/
+/* Slot used by (single) target in monitor mode   */
+/*------------------------------------------------*/
+
+#define MONITOR_SLOT             0
+
+
 
-_PRIVATE struct sigaction sighandle;
+
+/*------------------------------------------------------*/
+/* Watched target. Targets are kept in a (binary) heap  */
+/* ordered by deadline - the timerfd is armed for the   */
+/* target at the top of the heap                        */
+/*------------------------------------------------------*/
+
+typedef struct {   _BOOLEAN active;                   // TRUE if target is being watched
+                   pid_t    pid;                      // Watched process
+                   pid_t    pgrp;                     // Watched process group ((-1) if none)
+                   uint64_t timeout;                  // Watchdog timeout (milliseconds)
+                   uint64_t deadline;                 // Current deadline (milliseconds)
+                   uint64_t kick;                     // Time of last kick (monitor mode only)
+                   des_t    pidfd;                    // Process descriptor of watched process
+                   int32_t  heap_index;               // Position of target in deadline heap
+               } target_type;
 
 
 /*-------------------*/
 /* Private Variables */
 /*-------------------*/
 
-                                                                   /*------------------------------------*/
-_PRIVATE _BOOLEAN     do_verbose       = FALSE;                    /* Log status to stderr if TRUE       */
-_PRIVATE uint32_t     monitor_pgrp     = (-1);                     /* Pgrp of monitored process group    */
-_PRIVATE uint32_t     monitor_pid      = (-1);                     /* Pid of monitored process           */
-_PRIVATE uint32_t     softdog_timeout  = DEFAULT_SOFTDOG_TIMEOUT;  /* Softfog timeout (seconds)          */
-_PRIVATE unsigned char hostname[SSIZE] = "";                       /* Host running this softdog instance */
-                                                                   /*------------------------------------*/
+                                                                          /*-------------------------------------*/
+_PRIVATE _BOOLEAN     do_verbose       = FALSE;                           /* Log status to stderr if TRUE        */
+_PRIVATE _BOOLEAN     daemon_mode      = FALSE;                           /* Watch shared table if TRUE          */
+_PRIVATE int32_t      monitor_pgrp     = (-1);                            /* Pgrp of monitored process group     */
+_PRIVATE int32_t      monitor_pid      = (-1);                            /* Pid of monitored process            */
+_PRIVATE int32_t      softdog_timeout  = DEFAULT_SOFTDOG_TIMEOUT;         /* Softfog timeout (seconds)           */
+_PRIVATE char         hostname[SSIZE]  = "";                              /* Host running this softdog instance  */
+_PRIVATE char         table_name[SSIZE]= "";                              /* Name of shared watchdog table       */
+_PRIVATE des_t        epoll_des        = (-1);                            /* Event (epoll) set                   */
+_PRIVATE des_t        timer_des        = (-1);                            /* Deadline timer (timerfd)            */
+_PRIVATE des_t        signal_des       = (-1);                            /* Signal descriptor (signalfd)        */
+_PRIVATE des_t        inotify_des      = (-1);                            /* Table doorbell (inotify)            */
+_PRIVATE des_t        table_des        = (-1);                            /* Shared watchdog table               */
+_PRIVATE softdog_table_type *table     = (softdog_table_type *)NULL;      /* Mapped shared watchdog table        */
+_PRIVATE target_type  target[SOFTDOG_SLOTS];                              /* Watched targets                     */
+_PRIVATE uint32_t     heap[SOFTDOG_SLOTS];                                /* Deadline heap (of target slots)     */
+_PRIVATE uint32_t     heap_size        = 0;                               /* Number of targets in heap           */
+                                                                          /*-------------------------------------*/
+
+
+
+
+/*----------------------------------------*/
+/* Current time (milliseconds) - the same */
+/* clock is used by the watched processes */
+/*----------------------------------------*/
+
+_PRIVATE uint64_t now_ms(void)
+
+{   struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC,&now);
+    return((uint64_t)now.tv_sec*1000 + now.tv_nsec/1000000);
+}
+
+
+
+
+/*---------------------------------------*/
+/* Open process descriptor for process   */
+/*---------------------------------------*/
+
+_PRIVATE des_t softdog_pidfd_open(const pid_t pid)
+
+{
+
+    #ifdef SYS_pidfd_open
+    return((des_t)syscall(SYS_pidfd_open,pid,0));
+    #else
+    errno = ENOSYS;
+    return(-1);
+    #endif /* SYS_pidfd_open */
+}
+
+
+
+
+/*-------------------------------------------*/
+/* Signal process via its process descriptor */
+/* (so a recycled PID is never signalled)    */
+/*-------------------------------------------*/
+
+_PRIVATE int32_t softdog_pidfd_kill(const des_t pidfd, const int32_t signum)
+
+{
+
+    #ifdef SYS_pidfd_send_signal
+    return((int32_t)syscall(SYS_pidfd_send_signal,pidfd,signum,(siginfo_t *)NULL,0));
+    #else
+    errno = ENOSYS;
+    return(-1);
+    #endif /* SYS_pidfd_send_signal */
+}
+
+
+
+
+/*---------------------------*/
+/* Swap two heap entries     */
+/*---------------------------*/
+
+_PRIVATE void heap_swap(const uint32_t i, const uint32_t j)
+
+{   uint32_t tmp = heap[i];
+
+    heap[i] = heap[j];
+    heap[j] = tmp;
+
+    target[heap[i]].heap_index = i;
+    target[heap[j]].heap_index = j;
+}
+
+
+
+
+/*---------------------------------------------*/
+/* Restore heap order after deadline is moved  */
+/*---------------------------------------------*/
+
+_PRIVATE void heap_fix(uint32_t i)
+
+{   uint32_t child;
+
+
+    /*--------------------------*/
+    /* Sift up (earlier target) */
+    /*--------------------------*/
+
+    while(i > 0 && target[heap[i]].deadline < target[heap[(i - 1)/2]].deadline)
+    {    heap_swap(i,(i - 1)/2);
+         i = (i - 1)/2;
+    }
+
+
+    /*--------------------------*/
+    /* Sift down (later target) */
+    /*--------------------------*/
+
+    while((child = 2*i + 1) < heap_size)
+    {    if(child + 1 < heap_size && target[heap[child + 1]].deadline < target[heap[child]].deadline)
+            ++child;
+
+         if(target[heap[i]].deadline <= target[heap[child]].deadline)
+            break;
+
+         heap_swap(i,child);
+         i = child;
+    }
+}
+
+
+
+
+/*---------------------------*/
+/* Remove target from heap   */
+/*---------------------------*/
+
+_PRIVATE void heap_remove(const uint32_t slot)
+
+{   uint32_t i = target[slot].heap_index;
+
+    --heap_size;
+    if(i != heap_size)
+    {  heap_swap(i,heap_size);
+       heap_fix(i);
+    }
+
+    target[slot].heap_index = (-1);
+}
+
 
 
-/*----------------*/
-/* Signal handler */
-/*----------------*/
 
-_PRIVATE int32_t sighandler(const int32_t signum)
+/*----------------------------------------------------*/
+/* Arm timer for earliest deadline (or disarm it if   */
+/* there are no targets)                              */
+/*----------------------------------------------------*/
 
-{   sigset_t pending_set;
+_PRIVATE void arm_timer(void)
 
+{   struct itimerspec its;
 
-    /*----------------------------------*/
-    /* Which signal are we processing ? */
-    /*----------------------------------*/
+    (void)memset((void *)&its,0,sizeof(struct itimerspec));
 
-    switch(signum)
+    if(heap_size > 0)
+    {  its.it_value.tv_sec  = target[heap[0]].deadline / 1000;
+       its.it_value.tv_nsec = (target[heap[0]].deadline % 1000)*1000000;
+
+
+       /*------------------------------------------*/
+       /* A zero it_value would disarm the timer   */
+       /*------------------------------------------*/
+
+       if(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+          its.it_value.tv_nsec = 1;
+    }
+
+    (void)timerfd_settime(timer_des,TFD_TIMER_ABSTIME,&its,(struct itimerspec *)NULL);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Start watching target. Its exit is tracked (via pidfd)  */
+/* in the epoll set and its deadline goes into the heap    */
+/*---------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN track(const uint32_t slot, const pid_t pid, const pid_t pgrp, const uint64_t timeout, const uint64_t kick)
+
+{   struct epoll_event event;
+
+    if((target[slot].pidfd = softdog_pidfd_open(pid)) == (-1))
     {
 
-          /*------------------------*/
-          /* Stop software watchdog */
-          /*------------------------*/
+       /*----------------------------------------------------*/
+       /* Process has gone. A process group can outlive its  */
+       /* leader so we still watch it (but not for its exit) */
+       /*----------------------------------------------------*/
+
+       if(errno == ESRCH && pgrp == (-1))
+          return(FALSE);
+    }
+    else
+    {  event.events   = EPOLLIN;
+       event.data.u64 = ((uint64_t)EV_PROCESS << 32) | slot;
+       (void)epoll_ctl(epoll_des,EPOLL_CTL_ADD,target[slot].pidfd,&event);
+    }
 
-          case SIGINT:
-          case SIGQUIT:
-          case SIGTERM:   
-		 
-		          /*---------------*/ 
-		          /* Close softdog */
-		          /*---------------*/
+    target[slot].active     = TRUE;
+    target[slot].pid        = pid;
+    target[slot].pgrp       = pgrp;
+    target[slot].timeout    = timeout;
+    target[slot].kick       = kick;
+    target[slot].deadline   = kick + timeout;
 
-		          (void)alarm(0);
+    heap[heap_size]         = slot;
+    target[slot].heap_index = heap_size++;
+    heap_fix(target[slot].heap_index);
 
+    if (do_verbose == TRUE)
+    {  if (pgrp == (-1))
+          (void)fprintf(stderr,"softdog (%d@%s): watching process %d (timeout %lu milliseconds)\n",getpid(),hostname,pid,timeout);
+       else
+          (void)fprintf(stderr,"softdog (%d@%s): watching process group %d (timeout %lu milliseconds)\n",getpid(),hostname,pgrp,timeout);
+       (void)fflush(stderr);
+    }
 
-			  /*-------------------------*/
-                          /* Close hardware watchdog */
-			  /*-------------------------*/
-			  /*-------------------------------------------------------------------------*/
-			  /* The 'V' value needs to be written into watchdog device file to indicate */
-			  /* that we intend to close/stop the watchdog. Otherwise, debug message     */
-			  /* watchdog timer closed unexpectedly' will be printed                     */
-			  /*-------------------------------------------------------------------------*/
+    return(TRUE);
+}
 
-			  if (do_verbose == TRUE)
-			  {  (void)fprintf(stderr,"\nsoftdog (%d@%s): aborted\n\n",getpid(),hostname);
-			     (void)fflush(stderr);
-			  }
 
-                          exit(0);
 
 
-          /*--------------------------*/
-          /* Restart watchdog timeout */
-          /*--------------------------*/
+/*---------------------------*/
+/* Stop watching target      */
+/*---------------------------*/
 
-          case SIGCONT:   
+_PRIVATE void untrack(const uint32_t slot)
 
-                          /*----------*/
-                          /* Log kick */
-                          /*----------*/
+{   if(target[slot].active == FALSE)
+       return;
 
-                          if (do_verbose == TRUE)
-                          {  (void)fprintf(stderr,"softdog (%d@%s): kicked\n",getpid(),hostname);
-                             (void)fflush(stderr);
-                          }
+    if(target[slot].pidfd != (-1))
+    {  (void)close(target[slot].pidfd);
+       target[slot].pidfd = (-1);
+    }
 
+    heap_remove(slot);
+    target[slot].active = FALSE;
+}
 
-                          /*--------------------------------------------------*/
-                          /* Clear any further kicks which might have accrued */
-                          /* while dealing with this kick                     */
-                          /*--------------------------------------------------*/
 
-                          (void)sigpending(&pending_set);
 
-                          if(sigismember(&pending_set,SIGCONT))
-                          {  sighandle.sa_handler = SIG_IGN; 
-                             (void)sigaction(SIGCONT,&sighandle, (struct sigaction *)NULL);
 
-                             (void)sigemptyset(&pending_set);
-                             (void)sigaddset(&pending_set,SIGCONT);
-                             (void)sigsuspend(&pending_set);
+/*---------------------------------------------------*/
+/* Release target (and its slot in shared table). In */
+/* monitor mode we have nothing left to do so exit   */
+/*---------------------------------------------------*/
 
-                             sighandle.sa_handler = (void *)sighandler;
-                             (void)sigaction(SIGCONT,&sighandle, (struct sigaction *)NULL);
-                          }
+_PRIVATE void release(const uint32_t slot)
+
+{   untrack(slot);
+
+    if (table != (softdog_table_type *)NULL)
+       __atomic_store_n(&table->slot[slot].state,SOFTDOG_FREE,__ATOMIC_RELEASE);
+    else
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"softdog (%d@%s): exit (monitored process terminated)\n\n",getpid(),hostname);
+          (void)fflush(stderr);
+       }
 
+       exit(0);
+    }
+}
 
-                          /*---------------*/
-			  /* Reset softdog */
-                          /*---------------*/
 
-                          (void)alarm(softdog_timeout);
 
-                          break;
 
+/*-------------------------------------------------*/
+/* Time of last kick. In daemon mode the watched   */
+/* process writes it into its slot                 */
+/*-------------------------------------------------*/
 
-          /*----------------------------------*/
-          /* Kill monitored processi and exit */
-          /*----------------------------------*/
+_PRIVATE uint64_t last_kick(const uint32_t slot)
 
-          case SIGALRM:
-		      
-                          if (do_verbose == TRUE)
-                          {  if (monitor_pgrp == (-1))
-                                (void)fprintf(stderr,"\nsoftdog (%d@%s): terminating monitored process\n",getpid(),hostname);
-                             else
-                                (void)fprintf(stderr,"\nsoftdog (%d@%s): terminating monitored process group\n",getpid(),hostname);
+{   if (table != (softdog_table_type *)NULL)
+       return(__atomic_load_n(&table->slot[slot].kick,__ATOMIC_ACQUIRE));
 
-                             (void)fflush(stderr);
-                          }
+    return(target[slot].kick);
+}
 
 
-			  /*------------------------------*/ 
-			  /* Send signal to process group */
-			  /*------------------------------*/
 
-			  if (monitor_pgrp != (-1))
-			  {  
 
-                             /*-------------------------------------------*/
-                             /* Exit if monitored process group is killed */
-                             /*-------------------------------------------*/
+/*--------------------------------------------------*/
+/* Target has not been kicked in time - kill it     */
+/*--------------------------------------------------*/
 
-                             if (killpg(monitor_pgrp,SIGKILL) == 0)
-                             {  if (do_verbose == TRUE)
-                                {  (void)fprintf(stderr,"softdog (%d@%s): exit (monitored process group terminated)\n\n",getpid(),hostname);
-                                   (void)fflush(stderr);
-                                }
+_PRIVATE void expire(const uint32_t slot)
 
-                                exit(0);
-                             }
-                          }
+{   if (do_verbose == TRUE)
+    {  if (target[slot].pgrp == (-1))
+          (void)fprintf(stderr,"\nsoftdog (%d@%s): terminating monitored process %d\n",getpid(),hostname,target[slot].pid);
+       else
+          (void)fprintf(stderr,"\nsoftdog (%d@%s): terminating monitored process group %d\n",getpid(),hostname,target[slot].pgrp);
 
+       (void)fflush(stderr);
+    }
 
-			  /*------------------------*/
-			  /* Send signal to process */
-			  /*------------------------*/
 
-			  else
-                          {
+    /*------------------------------*/
+    /* Send signal to process group */
+    /*------------------------------*/
 
-                             /*-------------------------------------*/
-                             /* Exit if monitored process is killed */
-                             /*-------------------------------------*/
+    if (target[slot].pgrp != (-1))
+       (void)killpg(target[slot].pgrp,SIGKILL);
 
-			     if (kill(monitor_pid, SIGKILL) == 0)
-                             {  if (do_verbose == TRUE)
-                                {  (void)fprintf(stderr,"softdog (%d@%s): exit (moninitored process terminated)\n\n",getpid(),hostname);
-                                   (void)fflush(stderr);
-                                }
-                                exit(0);
-                             }
-                          }
 
-          /*---------*/
-          /* Default */
-          /*---------*/
+    /*--------------------------------------------*/
+    /* Send signal to process (via its process    */
+    /* descriptor if we have one)                 */
+    /*--------------------------------------------*/
+
+    else if (target[slot].pidfd != (-1))
+       (void)softdog_pidfd_kill(target[slot].pidfd,SIGKILL);
+    else
+       (void)kill(target[slot].pid,SIGKILL);
+
+    release(slot);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Deadline timer has expired. Targets which have been kicked    */
+/* since their deadline was set get a new deadline (last kick    */
+/* plus timeout), the others are killed                          */
+/*---------------------------------------------------------------*/
+
+_PRIVATE void process_deadlines(void)
+
+{   uint32_t slot;
+    uint64_t kick,
+             expirations,
+             now = now_ms();
+
+    (void)read(timer_des,&expirations,sizeof(uint64_t));
+
+    while(heap_size > 0 && target[heap[0]].deadline <= now)
+    {    slot = heap[0];
+         kick = last_kick(slot);
+
+         if(kick + target[slot].timeout > now)
+         {  target[slot].deadline = kick + target[slot].timeout;
+            heap_fix(0);
+         }
+         else
+            expire(slot);
+    }
+
+    arm_timer();
+}
+
+
+
+
+/*--------------------------------------------------------*/
+/* Scan shared table (after doorbell has been rung) for   */
+/* targets which have been added or released              */
+/*--------------------------------------------------------*/
+
+_PRIVATE void scan_table(void)
+
+{   uint32_t i,
+             state;
+
+    for(i=0; i<SOFTDOG_SLOTS; ++i)
+    {  state = __atomic_load_n(&table->slot[i].state,__ATOMIC_ACQUIRE);
 
-          default:        break;
+       switch(state)
+       {
+
+             /*-------------------------------------------------*/
+             /* New target (or slot reused by another process)  */
+             /*-------------------------------------------------*/
+
+             case SOFTDOG_ACTIVE:   if (target[i].active == TRUE && target[i].pid == table->slot[i].pid)
+                                       break;
+
+                                    untrack(i);
+                                    if (track(i,table->slot[i].pid,
+                                                table->slot[i].pgrp,
+                                                table->slot[i].timeout,
+                                                last_kick(i)) == FALSE)
+                                       __atomic_store_n(&table->slot[i].state,SOFTDOG_FREE,__ATOMIC_RELEASE);
+                                    break;
+
+
+             /*-------------------------------*/
+             /* Target no longer needs to be  */
+             /* watched                       */
+             /*-------------------------------*/
+
+             case SOFTDOG_RELEASED: if (do_verbose == TRUE && target[i].active == TRUE)
+                                    {  (void)fprintf(stderr,"softdog (%d@%s): released process %d\n",getpid(),hostname,target[i].pid);
+                                       (void)fflush(stderr);
+                                    }
+
+                                    untrack(i);
+                                    __atomic_store_n(&table->slot[i].state,SOFTDOG_FREE,__ATOMIC_RELEASE);
+                                    break;
+
+
+             /*-----------------------------------------------*/
+             /* Slot claimed by process which died before it  */
+             /* could make the slot active                    */
+             /*-----------------------------------------------*/
+
+             case SOFTDOG_CLAIMED:  if (kill(table->slot[i].pid,0) == (-1) && errno == ESRCH)
+                                       (void)__atomic_compare_exchange_n(&table->slot[i].state,&state,SOFTDOG_FREE,FALSE,
+                                                                                     __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE);
+                                    break;
+
+             default:               untrack(i);
+                                    break;
+       }
+    }
+
+    arm_timer();
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Open (and initialise) shared watchdog table. Only one   */
+/* daemon (per user) can hold the table lock               */
+/*---------------------------------------------------------*/
+
+_PRIVATE void table_open(void)
+
+{   struct epoll_event event;
+    struct stat        buf;
+
+    (void)snprintf(table_name,SSIZE,SOFTDOG_PATH_FMT,getuid());
+
+    if ((table_des = open(table_name,O_RDWR | O_CREAT | O_CLOEXEC,0600)) == (-1))
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): cannot open watchdog table \"%s\"\n\n",getpid(),hostname,table_name);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
+
+    /*-------------------------------------------------*/
+    /* Table must belong to us (and only us) - anybody */
+    /* else could forge the PIDs we kill               */
+    /*-------------------------------------------------*/
+
+    if (fstat(table_des,&buf) == (-1) || buf.st_uid != getuid() || (buf.st_mode & 077) != 0)
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): watchdog table \"%s\" is not owned by us (or is accessible to others)\n\n",
+                                                                                                getpid(),hostname,table_name);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
+    if (flock(table_des,LOCK_EX | LOCK_NB) == (-1))
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): softdog daemon already running\n\n",getpid(),hostname);
+          (void)fflush(stderr);
+       }
+
+       exit(0);
+    }
+
+    if (ftruncate(table_des,sizeof(softdog_table_type)) == (-1)                                                         ||
+        (table = (softdog_table_type *)mmap((void *)NULL,sizeof(softdog_table_type),PROT_READ | PROT_WRITE,MAP_SHARED,table_des,0)) == MAP_FAILED)
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): cannot map watchdog table \"%s\"\n\n",getpid(),hostname,table_name);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
+
+    /*------------------------------------------------------*/
+    /* Clients ring the doorbell by writing to the table so */
+    /* watch it (before we look at it for the first time)   */
+    /*------------------------------------------------------*/
+
+    if ((inotify_des = inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) == (-1) || inotify_add_watch(inotify_des,table_name,IN_MODIFY) == (-1))
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): cannot watch watchdog table (inotify)\n\n",getpid(),hostname);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
     }
 
-    return(0);
+    event.events   = EPOLLIN;
+    event.data.u64 = (uint64_t)EV_TABLE << 32;
+    (void)epoll_ctl(epoll_des,EPOLL_CTL_ADD,inotify_des,&event);
+
+    table->slots = SOFTDOG_SLOTS;
+    __atomic_store_n(&table->magic, SOFTDOG_MAGIC,__ATOMIC_RELEASE);
+    __atomic_store_n(&table->daemon,getpid(),     __ATOMIC_RELEASE);
+
+    scan_table();
+}
+
+
+
+
+/*------------------------------------------*/
+/* Signals (read via signalfd) - terminate  */
+/* or (in monitor mode) kick the watchdog   */
+/*------------------------------------------*/
+
+_PRIVATE void process_signal(void)
+
+{   struct signalfd_siginfo info;
+
+    if (read(signal_des,&info,sizeof(struct signalfd_siginfo)) != sizeof(struct signalfd_siginfo))
+       return;
+
+    switch(info.ssi_signo)
+    {
+
+          /*--------------------------*/
+          /* Restart watchdog timeout */
+          /*--------------------------*/
+
+          case SIGCONT:   if (do_verbose == TRUE)
+                          {  (void)fprintf(stderr,"softdog (%d@%s): kicked\n",getpid(),hostname);
+                             (void)fflush(stderr);
+                          }
+
+                          target[MONITOR_SLOT].kick = now_ms();
+                          break;
+
+
+          /*------------------------*/
+          /* Stop software watchdog */
+          /*------------------------*/
+
+          default:        if (table != (softdog_table_type *)NULL)
+                             __atomic_store_n(&table->daemon,0,__ATOMIC_RELEASE);
+
+                          if (do_verbose == TRUE)
+                          {  (void)fprintf(stderr,"\nsoftdog (%d@%s): aborted\n\n",getpid(),hostname);
+                             (void)fflush(stderr);
+                          }
+
+                          exit(0);
+    }
 }
 
 
 
-/*------------------*/          
+
+/*------------------*/
 /* Main entry point */
 /*------------------*/
 
 _PUBLIC int32_t main(int32_t argc, char *argv[])
 
-{   sigset_t full_set,
-             empty_set;
+{   sigset_t           signal_set;
+    struct epoll_event event,
+                       events[MAX_EVENTS];
+
+    int32_t            i,
+                       n_events;
 
-    uint32_t i,
-             decoded = 0;
+    uint32_t           decoded = 0;
 
 
     /*----------*/
@@ -261,8 +702,9 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
 
        (void)fprintf(stderr,"usage: softdog [-usage] | [-help] |\n");
        (void)fprintf(stderr,"               [-verbose:FALSE]\n");
-       (void)fprintf(stderr,"               !-monitorpid <pid>! | !monitorpg <pgrp>!\n");
+       (void)fprintf(stderr,"               !-daemon! | !-monitorpid <pid>! | !monitorpg <pgrp>!\n");
        (void)fprintf(stderr,"               [-timeout <seconds:%04d>]\n\n",softdog_timeout);
+       (void)fprintf(stderr,"-daemon watches every process registered in %s (one daemon per user)\n\n",SOFTDOG_PATH_FMT);
        (void)fflush(stderr);
 
        exit(1);
@@ -281,12 +723,22 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        }
 
 
+       /*----------------------------------------*/
+       /* Daemon mode (watch processes in table) */
+       /*----------------------------------------*/
+
+       if (strcmp(argv[i],"-daemon") == 0)
+       {  daemon_mode = TRUE;
+          ++decoded;
+       }
+
+
        /*---------------------------------*/
        /* PGRP of monitored process group */
        /*---------------------------------*/
 
        if (strcmp(argv[i],"-monitorpg") == 0)
-       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&monitor_pgrp) != 1 || monitor_pgrp < 0) 
+       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&monitor_pgrp) != 1 || monitor_pgrp < 0)
           {  if (do_verbose == TRUE)
              {  (void)fprintf(stderr,"\nsoftdog (%d@%s): monitorpgrp [%s] must be a positive integer value\n\n",getpid(),hostname,argv[i+1]);
                 (void)fflush(stderr);
@@ -305,7 +757,7 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        /*--------------------------*/
 
        if (monitor_pgrp == (-1) && strcmp(argv[i],"-monitorpid") == 0)
-       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&monitor_pid) != 1 || monitor_pid < 0) 
+       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&monitor_pid) != 1 || monitor_pid < 0)
           {  if (do_verbose == TRUE)
              {  (void)fprintf(stderr,"\nsoftdog (%d@%s): monitorpid [%s] must be a positive integer value\n\n",getpid(),hostname,argv[i+1]);
                 (void)fflush(stderr);
@@ -324,7 +776,7 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        /*-----------------*/
 
        if (strcmp(argv[i],"-timeout") == 0)
-       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&softdog_timeout) != 1 || softdog_timeout < 0) 
+       {  if (i == argc - 1 || argv[i+1][0] == '-' || sscanf(argv[i+1],"%d",&softdog_timeout) != 1 || softdog_timeout < 0)
           {  if (do_verbose == TRUE)
              {  (void)fprintf(stderr,"\nsoftdog (%d@%s): timeout must be a positive integer value\n\n",getpid(),hostname);
                 (void)fflush(stderr);
@@ -339,10 +791,10 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
     }
 
 
-    /*--------------------------------------------*/ 
+    /*--------------------------------------------*/
     /* Check for unparsed command line parameters */
-    /*--------------------------------------------*/ 
-     
+    /*--------------------------------------------*/
+
     if (decoded < argc - 1)
     {  if (do_verbose == TRUE)
        {  (void)fprintf(stderr,"\nsoftdog (%d@%s): command tail items unparsed (got %d, expected %d)\n\n",getpid(),hostname,decoded,argc - 1);
@@ -352,6 +804,15 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        exit(255);
     }
 
+    if (daemon_mode == FALSE && monitor_pid == (-1) && monitor_pgrp == (-1))
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): expecting -daemon, -monitorpid or -monitorpg\n\n",getpid(),hostname);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
+
 
     /*--------*/
     /* Banner */
@@ -362,35 +823,70 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
        (void)fflush(stderr);
     }
 
-    /*-----------------------*/
-    /* Setup signal handlers */
-    /*-----------------------*/
+    for (i=0; i<SOFTDOG_SLOTS; ++i)
+    {   target[i].active     = FALSE;
+        target[i].pidfd      = (-1);
+        target[i].heap_index = (-1);
+    }
+
+
+    /*-------------------------------------------------------*/
+    /* Event set: deadline timer, signals, table doorbell    */
+    /* (daemon mode) and one pidfd per watched process       */
+    /*-------------------------------------------------------*/
+
+    if ((epoll_des = epoll_create1(EPOLL_CLOEXEC))                                  == (-1) ||
+        (timer_des = timerfd_create(CLOCK_MONOTONIC,TFD_CLOEXEC | TFD_NONBLOCK))    == (-1)  )
+    {  if (do_verbose == TRUE)
+       {  (void)fprintf(stderr,"\nsoftdog (%d@%s): cannot create event set\n\n",getpid(),hostname);
+          (void)fflush(stderr);
+       }
+
+       exit(255);
+    }
 
-    sigemptyset(&empty_set);
-    sigfillset(&full_set);
-    sighandle.sa_handler = (void *)sighandler;
-    sighandle.sa_flags   = SA_RESTART;
-    sighandle.sa_mask    = full_set;
+    event.events   = EPOLLIN;
+    event.data.u64 = (uint64_t)EV_TIMER << 32;
+    (void)epoll_ctl(epoll_des,EPOLL_CTL_ADD,timer_des,&event);
 
 
     /*---------------------------------------------------*/
-    /* Reset signal mask (as it is inherited from parent */
+    /* Signals are delivered via signalfd. Reset signal  */
+    /* mask (as it is inherited from parent)             */
     /*---------------------------------------------------*/
 
-    (void)sigprocmask(SIG_SETMASK,&empty_set,(sigset_t *)NULL);
+    (void)sigemptyset(&signal_set);
+    (void)sigaddset(&signal_set,SIGINT);
+    (void)sigaddset(&signal_set,SIGQUIT);
+    (void)sigaddset(&signal_set,SIGTERM);
 
-    (void)sigaction(SIGINT, &sighandle, (struct sigaction *)NULL);
-    (void)sigaction(SIGQUIT,&sighandle, (struct sigaction *)NULL);
-    (void)sigaction(SIGTERM,&sighandle, (struct sigaction *)NULL);
-    (void)sigaction(SIGALRM,&sighandle, (struct sigaction *)NULL);
-    (void)sigaction(SIGCONT,&sighandle, (struct sigaction *)NULL);
+    if (daemon_mode == FALSE)
+       (void)sigaddset(&signal_set,SIGCONT);
 
+    (void)sigprocmask(SIG_SETMASK,&signal_set,(sigset_t *)NULL);
 
-    /*---------------*/
-    /* Start softdog */
-    /*---------------*/
+    signal_des     = signalfd((-1),&signal_set,SFD_CLOEXEC | SFD_NONBLOCK);
+    event.events   = EPOLLIN;
+    event.data.u64 = (uint64_t)EV_SIGNAL << 32;
+    (void)epoll_ctl(epoll_des,EPOLL_CTL_ADD,signal_des,&event);
+
+
+    /*-----------------------------------------------*/
+    /* Start softdog. Either watch everything in the */
+    /* shared table, or the target on command line   */
+    /*-----------------------------------------------*/
+
+    if (daemon_mode == TRUE)
+       table_open();
+    else
+    {  if (monitor_pgrp != (-1))
+          monitor_pid = monitor_pgrp;
+
+       if (track(MONITOR_SLOT,monitor_pid,monitor_pgrp,(uint64_t)softdog_timeout*1000,now_ms()) == FALSE)
+          release(MONITOR_SLOT);
 
-    (void)alarm(softdog_timeout);
+       arm_timer();
+    }
 
 
     /*---------------*/
@@ -398,7 +894,64 @@ _PUBLIC int32_t main(int32_t argc, char *argv[])
     /*---------------*/
 
     while( TRUE )
-	 (void)usleep(1000);
+    {    if ((n_events = epoll_wait(epoll_des,events,MAX_EVENTS,(-1))) == (-1))
+            continue;
+
+         for (i=0; i<n_events; ++i)
+         {   switch(events[i].data.u64 >> 32)
+             {     case EV_TIMER:   process_deadlines();
+                                    break;
+
+                   case EV_SIGNAL:  process_signal();
+                                    break;
+
+
+                   /*-------------------------------------*/
+                   /* Doorbell - drain inotify, rescan    */
+                   /*-------------------------------------*/
+
+                   case EV_TABLE:   {  char buf[SSIZE];
+
+                                       while (read(inotify_des,buf,SSIZE) > 0);
+                                       scan_table();
+                                    }
+                                    break;
+
+
+                   /*--------------------------------------*/
+                   /* Watched process has exited - stop    */
+                   /* watching it                          */
+                   /*--------------------------------------*/
+
+                   case EV_PROCESS: {  uint32_t slot = (uint32_t)(events[i].data.u64 & 0xffffffff);
+
+                                       if (target[slot].active == TRUE && target[slot].pgrp == (-1))
+                                       {  if (do_verbose == TRUE)
+                                          {  (void)fprintf(stderr,"softdog (%d@%s): process %d has exited\n",getpid(),hostname,target[slot].pid);
+                                             (void)fflush(stderr);
+                                          }
+
+                                          release(slot);
+                                          arm_timer();
+                                       }
+
+
+                                       /*--------------------------------------*/
+                                       /* Process group leader has exited but  */
+                                       /* group may still be alive             */
+                                       /*--------------------------------------*/
+
+                                       else if (target[slot].active == TRUE && target[slot].pidfd != (-1))
+                                       {  (void)close(target[slot].pidfd);
+                                          target[slot].pidfd = (-1);
+                                       }
+                                    }
+                                    break;
+
+                   default:         break;
+             }
+         }
+    }
 
 
     /*-------------------*/
@@ -8,7 +8,7 @@
              NE3 4RT
              United Kingdom
 
-    Version: 8.11 
+    Version: 8.15 
     Dated:   2nd January 2025 
     E-Mail:  mao@tumblingdice.co.uk
 --------------------------------------------*/
@@ -40,6 +40,11 @@
 #include <syscall.h>
 #include <zlib.h>
 #include <cache.h>
+#include <sys/mman.h>
+#include <inttypes.h>
+#include <cpustat.h>
+#include <softdog.h>
+#include <sys/epoll.h>
 
 
 /*-------------------------------------------------------------*/
@@ -54,6 +59,7 @@
 
 #ifdef PTHREAD_SUPPORT
 #include <tad.h>
+#include <sys/timerfd.h>
 #endif /* PTHREAD_SUPPORT */
 
 #ifdef SHADOW_SUPPORT
@@ -137,6 +143,16 @@
 #define NFS_SUPER_MAGIC      0x6969
 
 
+/*--------------------------------------------------*/
+/* Size of liveness watch set (PSRP clients and     */
+/* children) and number of events collected by each */
+/* poll of the set                                  */
+/*--------------------------------------------------*/
+
+#define PIDWATCH_SLOTS       (MAX_CLIENTS + MAX_CHILDREN)
+#define PIDWATCH_EVENTS      64
+
+
 /*-------------------------*/
 /* Handle a broken va_list */
 /*-------------------------*/
@@ -358,6 +374,18 @@ _PRIVATE int32_t       start_index      = 0;
 _PRIVATE int32_t       active_v_timers  = 0;
 _PRIVATE _BOOLEAN  vt_no_reset      = FALSE;
 
+#ifdef PTHREAD_SUPPORT
+_PRIVATE _BOOLEAN        vt_wheel_threaded = FALSE;                                    // TRUE if timer wheel thread running
+_PRIVATE des_t           vt_wheel_des      = (-1);                                     // Timer wheel (timerfd) descriptor
+_PRIVATE pthread_t       vt_wheel_tid;                                                 // Timer wheel thread
+_PRIVATE pthread_mutex_t vt_wheel_mutex    = PTHREAD_MUTEX_INITIALIZER;                // Timer wheel lock
+_PRIVATE uint64_t        vt_wheel_now      = 0;                                        // Current wheel tick
+_PRIVATE uint64_t        vt_wheel_base     = 0;                                        // Time (nsecs) of current wheel tick
+_PRIVATE uint64_t        vt_wheel_map[VT_WHEEL_LEVELS];                                // Occupied slots (per level)
+_PRIVATE int32_t         vt_wheel[VT_WHEEL_LEVELS][VT_WHEEL_SLOTS];                    // Wheel slots (timer lists)
+_PRIVATE int32_t         vt_wheel_fired    = (-1);                                     // Expired timers (handlers pending)
+#endif /* PTHREAD_SUPPORT */
+
 
 /*---------------------------------------*/
 /* Private variables used by child table */
@@ -373,6 +401,42 @@ _PRIVATE  int32_t       n_children       = 0;
 _PRIVATE char ckpt_file_name[SSIZE] = "";
 
 
+/*------------------------------------------------*/
+/* Private variables used by CPU utilisation      */
+/* sampler                                        */
+/*------------------------------------------------*/
+
+_PRIVATE cpustat_type *cpustat_table = (cpustat_type *)NULL;                  // Shared utilisation table (published by cpuload)
+_PRIVATE ino_t        cpustat_ino    = 0;                                     // Inode of shared utilisation table
+_PRIVATE uint64_t     cpustat_total  = 0;                                     // Total ticks (at last local sample)
+_PRIVATE uint64_t     cpustat_busy   = 0;                                     // Busy ticks (at last local sample)
+
+
+/*------------------------------------------------*/
+/* Private variables used by liveness watch set   */
+/*------------------------------------------------*/
+
+typedef struct {   pid_t pid;                                                // Watched process (0 if slot is free)
+                   des_t pidfd;                                              // Process descriptor ((-1) if no pidfd)
+               } pidwatch_type;
+
+_PRIVATE pidwatch_type pidwatch[PIDWATCH_SLOTS];                            // Watched processes
+_PRIVATE uint32_t      pidwatch_n    = 0;                                    // Number of watched processes
+_PRIVATE des_t         pidwatch_epfd = (-1);                                 // Watch set (epoll) descriptor
+_PRIVATE _BOOLEAN      auto_child    = FALSE;                                // TRUE if children reaped by chld_handler
+
+
+/*------------------------------------------------*/
+/* Private variables used by software watchdog    */
+/* client                                         */
+/*------------------------------------------------*/
+
+_PRIVATE softdog_table_type *softdog_table = (softdog_table_type *)NULL;     // Shared watchdog table (watched by softdog daemon)
+_PRIVATE des_t              softdog_des    = (-1);                           // Shared watchdog table descriptor (doorbell)
+_PRIVATE int32_t            softdog_slot   = (-1);                           // Our slot in shared watchdog table
+_PRIVATE pid_t              softdog_owner  = (-1);                           // Process which owns slot
+
+
 
 #ifdef PTHREAD_SUPPORT
 /*------------------------------*/
@@ -406,6 +470,12 @@ _PRIVATE pthread_mutex_t errstr_mutex   = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
 // File copy mutex
 _PRIVATE pthread_mutex_t copy_mutex     = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
+// CPU utilisation sampler mutex
+_PRIVATE pthread_mutex_t cpustat_mutex  = PTHREAD_MUTEX_INITIALIZER;
+
+// Liveness watch set mutex
+_PRIVATE pthread_mutex_t pidwatch_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
 #endif /* PTHREAD_SUPPORT */
 
 
@@ -619,6 +689,50 @@ _PROTOTYPE _PRIVATE void chld_handler(int32_t);
 // Initialise PUPS virtual interval timers
 _PROTOTYPE _PRIVATE void initvitimers(int32_t);
 
+#ifdef PTHREAD_SUPPORT
+// Current time (for virtual timer wheel)
+_PROTOTYPE _PRIVATE uint64_t vt_wheel_clock(void);
+
+// Length of virtual timer wheel tick
+_PROTOTYPE _PRIVATE uint64_t vt_wheel_quantum(void);
+
+// Take timer wheel lock (root thread)
+_PROTOTYPE _PRIVATE void vt_wheel_lock(sigset_t *);
+
+// Release timer wheel lock (root thread)
+_PROTOTYPE _PRIVATE void vt_wheel_unlock(const sigset_t *);
+
+// Insert timer into wheel
+_PROTOTYPE _PRIVATE void vt_wheel_insert(const int32_t, const uint64_t);
+
+// Remove timer from wheel
+_PROTOTYPE _PRIVATE void vt_wheel_cancel(const int32_t);
+
+// Next tick at which timer wheel has work
+_PROTOTYPE _PRIVATE uint64_t vt_wheel_next(void);
+
+// Process timer wheel tick
+_PROTOTYPE _PRIVATE void vt_wheel_tick(const uint64_t);
+
+// Advance timer wheel to current time
+_PROTOTYPE _PRIVATE void vt_wheel_advance(void);
+
+// Arm timerfd for next timer wheel event
+_PROTOTYPE _PRIVATE void vt_wheel_arm(void);
+
+// Timer wheel thread
+_PROTOTYPE _PRIVATE void *vt_wheel_thread(void *);
+
+// Reset timer wheel in child (after fork)
+_PROTOTYPE _PRIVATE void vt_wheel_child(void);
+
+// Start timer wheel thread
+_PROTOTYPE _PRIVATE int32_t vt_wheel_start(void);
+#endif /* PTHREAD_SUPPORT */
+
+// Re-enable virtual timer system after critical section
+_PROTOTYPE _PRIVATE void vt_rearm(void);
+
 // Initialise PUPS file table
 _PROTOTYPE _PRIVATE void initftab(int32_t,  int32_t);
 
@@ -634,6 +748,48 @@ _PROTOTYPE _PRIVATE void shm_init(void);
 // Initialise PUPS heap object tracking system
 _PROTOTYPE _PRIVATE void tinit(void);
 
+// Attach (shared) CPU utilisation table published by cpuload
+_PROTOTYPE _PRIVATE cpustat_type *cpustat_attach(void);
+
+// Read CPU utilisation (and load averages) from shared table
+_PROTOTYPE _PRIVATE _BOOLEAN cpustat_read(const int32_t, const int32_t, FTYPE *, FTYPE *);
+
+// Sample (aggregate) CPU utilisation from /proc/stat
+_PROTOTYPE _PRIVATE FTYPE cpustat_local(void);
+
+// Has process exited (or become a zombie)?
+_PROTOTYPE _PRIVATE _BOOLEAN pid_exited(const pid_t);
+
+// Milliseconds elapsed since start time
+_PROTOTYPE _PRIVATE int64_t pid_elapsed(const struct timespec *);
+
+// Has watched process exited?
+_PROTOTYPE _PRIVATE _BOOLEAN pidwatch_exited(const uint32_t);
+
+// Remove process from liveness watch set
+_PROTOTYPE _PRIVATE void pidwatch_release(const uint32_t);
+
+// Current time (milliseconds) on clock shared with softdog daemon
+_PROTOTYPE _PRIVATE uint64_t softdog_now(void);
+
+// Attach (per user) shared watchdog table
+_PROTOTYPE _PRIVATE softdog_table_type *softdog_attach(void);
+
+// Is softdog daemon running?
+_PROTOTYPE _PRIVATE _BOOLEAN softdog_daemon_alive(void);
+
+// Start softdog daemon (if it is not running)
+_PROTOTYPE _PRIVATE _BOOLEAN softdog_daemon_start(void);
+
+// Tell softdog daemon that shared watchdog table has changed
+_PROTOTYPE _PRIVATE void softdog_doorbell(void);
+
+// Register with softdog daemon (claim slot in shared watchdog table)
+_PROTOTYPE _PRIVATE int32_t softdog_register(const uint32_t);
+
+// Release slot in shared watchdog table
+_PROTOTYPE _PRIVATE void softdog_release(void);
+
 
 
 
@@ -10578,6 +10734,15 @@ _PUBLIC pid_t pups_fork(const _BOOLEAN fork_wait, const _BOOLEAN obituary)
              chtab[i].obituary = obituary;
              ++n_children;
 
+
+             /*--------------------------------------------------*/
+             /* Children of PSRP servers are watched so the PSRP */
+             /* homeostat can reap any whose exit was missed     */
+             /*--------------------------------------------------*/
+
+             if(appl_psrp == TRUE)
+                (void)pups_pid_watch(pid);
+
             #ifdef PTHREAD_SUPPORT
             (void)pthread_mutex_unlock(&pups_fork_mutex);
             #endif /* PTHREAD_SUPPORT */
@@ -10642,6 +10807,7 @@ _PUBLIC void pups_init_child_table(const uint32_t max_children)
     }
 
     (void)pups_sighandle(SIGCHLD,"child_handler",(void *)&chld_handler, (sigset_t *)NULL);
+    auto_child = TRUE;
 
     #ifdef PTHREAD_SUPPORT
     (void)pthread_mutex_unlock(&chtab_mutex);
@@ -10857,6 +11023,7 @@ _PRIVATE void chld_handler(const int32_t signum)
 _PUBLIC void pups_auto_child(void)
 
 {   pups_sighandle(SIGCHLD,"child_handler",(void *)chld_handler, (sigset_t *)NULL);
+    auto_child = TRUE;
 }
 
 
@@ -10868,7 +11035,8 @@ _PUBLIC void pups_auto_child(void)
 
 _PUBLIC void pups_noauto_child(void)
 
-{   pups_sighandle(SIGCHLD,"ignored",SIG_DFL, (sigset_t *)NULL);
+{   auto_child = FALSE;
+    pups_sighandle(SIGCHLD,"ignored",SIG_DFL, (sigset_t *)NULL);
 }
 
 
@@ -10992,18 +11160,14 @@ _PUBLIC int32_t pupswaitpid(const _BOOLEAN waitpid_verbose, const pid_t wait_pid
     /*------------------------*/
 
     pups_noauto_child();
-    do {   pid = waitpid(wait_pid,status,WNOHANG);
-
-           if(pid == 0)
-             (void)pups_usleep(100);
-           else
-           {  pups_auto_child();
-              pups_set_errno(ECHILD);
+    while((pid = waitpid(wait_pid,status,0)) == (-1) && errno == EINTR);
 
-              return(-1);
-           }
+    if(pid == (-1))
+    {  pups_auto_child();
+       pups_set_errno(ECHILD);
 
-        } while(pid == 0);
+       return(-1);
+    }
 
     #ifdef PTHREAD_SUPPORT
     (void)pthread_mutex_lock(&pups_fork_mutex);
@@ -12101,13 +12265,13 @@ _PUBLIC  int32_t pups_exit(const int32_t exit_code)
 
     /*----------------------------------------*/
     /* If we are being monitored by a softdog */
-    /* instance termimnate it                 */
+    /* release our slot                       */
     /*----------------------------------------*/
 
     if (appl_softdog_enabled == TRUE)
-    {  (void)kill(appl_softdog_pid,SIGTERM);
+    {  softdog_release();
 
-       (void)fprintf(stderr,"\n%s %s (%d@%s:%s): softdog terminated\n\n",date,appl_name,appl_pid,appl_host,appl_owner);
+       (void)fprintf(stderr,"\n%s %s (%d@%s:%s): softdog released\n\n",date,appl_name,appl_pid,appl_host,appl_owner);
        (void)fflush(stderr);
     }
 
@@ -12468,7 +12632,7 @@ _PUBLIC  int32_t pups_exit(const int32_t exit_code)
 
     else if(exit_code == PUPS_DEFER_EXIT)
     {  (void)pups_sigprocmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
-       (void)pups_malarm(vitimer_quantum);
+       vt_rearm();
 
        return(0);
     }
@@ -13375,6 +13539,7 @@ _PUBLIC void pupshold(const int32_t sigs_to_hold)
        (void)pupsighold(SIGINIT,  TRUE);
        (void)pupsighold(SIGCHAN,  TRUE);
        (void)pupsighold(SIGPSRP,  TRUE);
+       (void)pupsighold(SIGPSRPIO,TRUE);
        (void)pupsighold(SIGCLIENT,TRUE);
     }
 
@@ -13387,6 +13552,7 @@ _PUBLIC void pupshold(const int32_t sigs_to_hold)
     {  (void)pupsighold(SIGINIT,  TRUE);
        (void)pupsighold(SIGCHAN,  TRUE);
        (void)pupsighold(SIGPSRP,  TRUE);
+       (void)pupsighold(SIGPSRPIO,TRUE);
        (void)pupsighold(SIGCLIENT,TRUE);
     }
 
@@ -13455,6 +13621,7 @@ _PUBLIC void pupsrelse(const int32_t sigs_to_relse)
     {  (void)pupsigrelse(SIGINIT);
        (void)pupsigrelse(SIGCHAN);
        (void)pupsigrelse(SIGPSRP);
+       (void)pupsigrelse(SIGPSRPIO);
        (void)pupsigrelse(SIGCLIENT);
     }
 
@@ -13691,7 +13858,7 @@ _PUBLIC int32_t pups_signalpause(const int32_t signum)
     if((ret = sigsuspend(&set)) == (-1))
        return(ret);
 
-    (void)pups_malarm(vitimer_quantum);
+    vt_rearm();
 
     pups_set_errno(OK);
     return(ret);
@@ -14239,6 +14406,8 @@ _PRIVATE void initvitimers(int32_t appl_max_vtimers)
        vttab[i].prescaler       = 0;
        vttab[i].interval_time   = 0;
        vttab[i].handler         = NULL;
+       vttab[i].wheel_slot      = (-1);
+       vttab[i].fired           = FALSE;
 
        (void)strlcpy(vttab[i].name,        "",SSIZE);
        (void)strlcpy(vttab[i].handler_args,"",SSIZE);
@@ -14290,6 +14459,77 @@ _PRIVATE int32_t pups_vt_handler(const int32_t signum)
     }
 
     in_vt_handler = TRUE;
+
+
+    /*------------------------------------------------------*/
+    /* Timer wheel running - only the timers which have     */
+    /* expired are visited (highest priority first). Their  */
+    /* handlers are run here, in signal context             */
+    /*------------------------------------------------------*/
+
+    #ifdef PTHREAD_SUPPORT
+    if(vt_wheel_threaded == TRUE)
+    {  sigset_t old_set;
+
+       while(TRUE)
+       {    int32_t t_index,
+                    *link,
+                    *t_link = (int32_t *)NULL;
+
+            vt_wheel_lock(&old_set);
+
+            for(link=&vt_wheel_fired; *link != (-1); link=&vttab[*link].fired_next)
+            {  if(t_link == (int32_t *)NULL || vttab[*link].priority > vttab[*t_link].priority)
+                  t_link = link;
+            }
+
+            if(t_link == (int32_t *)NULL)
+            {  vt_wheel_unlock(&old_set);
+               break;
+            }
+
+            t_index               = *t_link;
+            *t_link               = vttab[t_index].fired_next;
+            vttab[t_index].fired  = FALSE;
+
+            (void)strlcpy(handler_args,vttab[t_index].handler_args,SSIZE);
+
+            tinfo   = vttab[t_index];
+            handler = vttab[t_index].handler;
+
+            if(vttab[t_index].mode == VT_ONESHOT)
+            {  --active_v_timers;
+
+               vttab[t_index].priority      = 0;
+               vttab[t_index].mode          = VT_NONE;
+               vttab[t_index].interval_time = 0;
+               vttab[t_index].handler       = NULL;
+
+               (void)strlcpy(vttab[t_index].name,        "",SSIZE);
+               (void)strlcpy(vttab[t_index].handler_args,"",SSIZE);
+            }
+
+            vt_wheel_unlock(&old_set);
+
+            (*handler)((void *)&tinfo,handler_args);
+       }
+
+
+       /*-------------------------------------------------*/
+       /* A handler forked (and we are the child) so the  */
+       /* wheel has gone - drive timers from tick instead */
+       /*-------------------------------------------------*/
+
+       if(vt_wheel_threaded == FALSE && active_v_timers > 0)
+          vt_rearm();
+
+       in_vt_handler = FALSE;
+
+       pups_set_errno(OK);
+       return(0);
+    }
+    #endif /* PTHREAD_SUPPORT */
+
     for(i=start_index; i<appl_max_vtimers; ++i)
     {  if(vttab[i].priority > 0)
        {  --vttab[i].prescaler;
@@ -14338,7 +14578,7 @@ _PRIVATE int32_t pups_vt_handler(const int32_t signum)
     start_index   = 0;
 
     if(active_v_timers > 0)
-      (void)pups_malarm(vitimer_quantum);
+      vt_rearm();
 
     in_vt_handler = FALSE;
 
@@ -14367,576 +14607,580 @@ _PRIVATE int32_t sort_priority(vttab_type *el_1, vttab_type *el_2)
 
 
 
-/*------------------------------------------------------------------------------*/
-/* Restart virtual timer system (this routine is usually called as a precaution */
-/* after using dubious library functions e.g. CURSES which may silently reset   */
-/* signal handlers in an undocumented fashion)                                  */
-/* -----------------------------------------------------------------------------*/
+#ifdef PTHREAD_SUPPORT
+/*-------------------------------------------------------------*/
+/* Current time (in nanoseconds) for virtual timer wheel       */
+/*-------------------------------------------------------------*/
 
-_PUBLIC int32_t pups_vitrestart(void)
+_PRIVATE uint64_t vt_wheel_clock(void)
 
-{
+{   struct timespec now;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    (void)clock_gettime(CLOCK_MONOTONIC,&now);
+    return((uint64_t)now.tv_sec*1000000000 + (uint64_t)now.tv_nsec);
+}
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_vitrestart] attempt by non root thread to perform PUPS/P3 utility operation");
 
-    if((in_setvitimer == TRUE  && active_v_timers == 0)    ||
-       (in_setvitimer == FALSE && active_v_timers >  0)     )
-    {  sigset_t vt_set;
 
 
-       /*------------------------------------------------*/
-       /* Initialise interval timer if this is the first */
-       /* virtual timer activated                        */
-       /* vt_set is the set of signals masked when the   */
-       /* vt_handler function is running                 */
-       /*------------------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Length of virtual timer wheel tick (in nanoseconds)         */
+/*-------------------------------------------------------------*/
 
-       (void)sigfillset(&vt_set);
+_PRIVATE uint64_t vt_wheel_quantum(void)
 
-       (void)sigdelset(&vt_set,SIGALRM);
-       (void)sigdelset(&vt_set,SIGINT);
-       (void)sigdelset(&vt_set,SIGTERM);
-       (void)sigdelset(&vt_set,SIGCONT);
+{   if(vitimer_quantum < 1)
+       return(1000);
 
-       (void)pups_sighandle(SIGALRM,"vt_handler",(void *)pups_vt_handler, &vt_set);
+    return((uint64_t)vitimer_quantum*1000);
+}
 
-       in_vt_handler = FALSE;
-       (void)pups_malarm(vitimer_quantum);
- 
-       pups_set_errno(OK);
-       return(0);
-    }
- 
-    pups_set_errno(EINVAL);
-    return(-1);
+
+
+
+/*-------------------------------------------------------------*/
+/* Block signals while root thread holds the timer wheel lock  */
+/* (a signal handler which sets or clears a timer would        */
+/* otherwise deadlock)                                         */
+/*-------------------------------------------------------------*/
+
+_PRIVATE void vt_wheel_lock(sigset_t *old_set)
+
+{   sigset_t set;
+
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_BLOCK,&set,old_set);
+    (void)pthread_mutex_lock(&vt_wheel_mutex);
 }
 
 
 
 
-/*----------------------------*/
-/* Set virtual interval timer */
-/*----------------------------*/
-                                                              /*---------------------------------*/
-_PUBLIC int32_t pups_setvitimer(const char     *tname      ,  /* Timer payload name              */
-                                const  int32_t priority    ,  /* Priority of handler             */
-                                const  int32_t mode        ,  /* Mode of timer                   */
-                                const time_t  interval     ,  /* Timeout interval (microseconds) */
-                                const char    *handler_args,  /* Handler arguments               */
-                                const void    *handler     )  /* Handler called on timeout       */
-                                                              /*---------------------------------*/
+/*-------------------------------------------------------------*/
+/* Release timer wheel lock (and restore signal mask)          */
+/*-------------------------------------------------------------*/
 
-{   int32_t  i,
-             t_index;
+_PRIVATE void vt_wheel_unlock(const sigset_t *old_set)
 
-    time_t   tdum;
-    sigset_t set;
+{   (void)pthread_mutex_unlock(&vt_wheel_mutex);
+    (void)pthread_sigmask(SIG_SETMASK,old_set,(sigset_t *)NULL);
+}
 
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_setvitimer] attempt by non root thread to perform PUPS/P3 global utility operation");
 
-    if(tname        == (const char *)NULL  ||
-       priority     <  0                   ||
-       interval     <  0                   ||
-       handler      == (const void *)NULL   )
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+/*-------------------------------------------------------------*/
+/* Insert timer into wheel - the level is chosen so that the   */
+/* timer is cascaded (to a finer level) before it expires. O(1) */
+/*-------------------------------------------------------------*/
 
+_PRIVATE void vt_wheel_insert(const int32_t t_index, const uint64_t expires)
 
-    /*----------------------------------------------------------*/
-    /* If we have disabled VT services do not process this call */
-    /*----------------------------------------------------------*/
+{   int32_t  level = 0,
+             slot;
+    uint64_t delta;
 
-    if(no_vt_services == TRUE)
-    {  pups_set_errno(EACCES);
-       return(-1);
-    }
+    delta = (expires > vt_wheel_now) ? expires - vt_wheel_now : 0;
+    while(level < VT_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (VT_WHEEL_BITS*(level + 1))))
+         ++level;
 
-    if(priority < 0)
-       pups_error("[setvitimer] invalid priority");
+    slot = (int32_t)((expires >> (VT_WHEEL_BITS*level)) & (VT_WHEEL_SLOTS - 1));
 
+    vttab[t_index].expires    = expires;
+    vttab[t_index].wheel_slot = level*VT_WHEEL_SLOTS + slot;
+    vttab[t_index].prev       = (-1);
+    vttab[t_index].next       = vt_wheel[level][slot];
 
+    if(vt_wheel[level][slot] != (-1))
+       vttab[vt_wheel[level][slot]].prev = t_index;
 
-    /*-------------------------------------------*/
-    /* Ignore timer signals while reseting timer */
-    /*-------------------------------------------*/
+    vt_wheel[level][slot]  = t_index;
+    vt_wheel_map[level]   |= (uint64_t)1 << slot;
+}
 
-    (void)pups_malarm(0);
-    (void)sigemptyset(&set);
-    (void)sigaddset(&set,SIGALRM);
-    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
 
 
-    /*--------------------------------------------*/
-    /* Get free timer slot and check to make sure */
-    /* this timer is unique                       */
-    /*--------------------------------------------*/
 
-    for(i=0; i<appl_max_vtimers; ++i)
-    {   if(vttab[i].name != (char *)NULL && strcmp(vttab[i].name,tname) == 0)
-        {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-           (void)pups_malarm(vitimer_quantum);
+/*-------------------------------------------------------------*/
+/* Remove timer from wheel (and from expired list). O(1) for   */
+/* the wheel, the expired list is only ever a few timers long  */
+/*-------------------------------------------------------------*/
 
-           pups_set_errno(EEXIST);
-           return(-1);
-        }
+_PRIVATE void vt_wheel_cancel(const int32_t t_index)
 
-        if((void *)vttab[i].handler == (void *)NULL)
-        {  t_index = i;
-           goto free_timer;
-        }
-    }
+{   int32_t level,
+            slot,
+            *next = (int32_t *)NULL;
 
-    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-    (void)pups_malarm(vitimer_quantum);
+    if(vttab[t_index].wheel_slot != (-1))
+    {  level = vttab[t_index].wheel_slot / VT_WHEEL_SLOTS;
+       slot  = vttab[t_index].wheel_slot % VT_WHEEL_SLOTS;
 
-    pups_set_errno(ENOSPC);
-    return(-1);
+       if(vttab[t_index].prev != (-1))
+          vttab[vttab[t_index].prev].next = vttab[t_index].next;
+       else
+          vt_wheel[level][slot] = vttab[t_index].next;
 
-free_timer:
+       if(vttab[t_index].next != (-1))
+          vttab[vttab[t_index].next].prev = vttab[t_index].prev;
 
-    if(mode != VT_ONESHOT && mode != VT_CONTINUOUS)
-    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-       (void)pups_malarm(vitimer_quantum);
+       if(vt_wheel[level][slot] == (-1))
+          vt_wheel_map[level] &= ~((uint64_t)1 << slot);
 
-       pups_set_errno(EINVAL);
-       return(-1);
+       vttab[t_index].wheel_slot = (-1);
     }
 
-    if(interval <= 0)
-    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-       (void)pups_malarm(vitimer_quantum);
+    if(vttab[t_index].fired == TRUE)
+    {  for(next=&vt_wheel_fired; *next != (-1); next=&vttab[*next].fired_next)
+       {  if(*next == t_index)
+          {  *next = vttab[t_index].fired_next;
+             break;
+          }
+       }
 
-       pups_set_errno(ERANGE);
-       return(-1);
+       vttab[t_index].fired = FALSE;
     }
+}
 
 
-    /*------------------------------------------------*/
-    /* Set up signal handler for virtual timer system */
-    /*------------------------------------------------*/
 
-    in_setvitimer = TRUE;
-    (void)pups_vitrestart();
-    in_setvitimer = FALSE;
 
+/*-------------------------------------------------------------*/
+/* Find the next tick (after current tick) at which something  */
+/* happens on the wheel - either a timer expires or an         */
+/* occupied slot is cascaded. Returns UINT64_MAX if the wheel  */
+/* is empty                                                    */
+/*-------------------------------------------------------------*/
 
-    /*----------------------*/
-    /* Set up virtual timer */
-    /*----------------------*/
+_PRIVATE uint64_t vt_wheel_next(void)
 
-    if(vttab[t_index].priority == 0)
-       ++active_v_timers;
+{   int32_t  level,
+             shift,
+             current;
 
-    vttab[t_index].priority       = priority;
+    uint64_t map,
+             tick,
+             next = UINT64_MAX;
 
+    for(level=0; level<VT_WHEEL_LEVELS; ++level)
+    {  if(vt_wheel_map[level] != 0)
+       {  shift   = VT_WHEEL_BITS*level;
+          current = (int32_t)(((vt_wheel_now >> shift) + 1) & (VT_WHEEL_SLOTS - 1));
 
-    /*-------------------------------------------------------------*/
-    /* A negative interval means that we want the payload function */
-    /* run immediately                                             */
-    /*-------------------------------------------------------------*/
 
-    if(interval > 0 && mode == VT_CONTINUOUS)
-       vttab[t_index].prescaler   =  interval;
-    else if(mode != VT_CONTINUOUS)
-    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-       (void)pups_malarm(vitimer_quantum);
+          /*-----------------------------------------------*/
+          /* Rotate occupancy map so bit 0 is the slot     */
+          /* after the current one                         */
+          /*-----------------------------------------------*/
 
-       pups_set_errno(EINVAL);
-       return(-1);
+          map = vt_wheel_map[level];
+          if(current > 0)
+             map = (map >> current) | (map << (VT_WHEEL_SLOTS - current));
+
+          tick = ((vt_wheel_now >> shift) + (uint64_t)__builtin_ctzll(map) + 1) << shift;
+          if(tick < next)
+             next = tick;
+       }
     }
 
-    vttab[t_index].interval_time  =  interval;
-    vttab[t_index].mode           = mode;
-    vttab[t_index].handler        = handler;
+    return(next);
+}
 
-    if(handler_args != (char *)NULL)
-       (void)strlcpy(vttab[t_index].handler_args,handler_args,SSIZE);
 
-    (void)strlcpy(vttab[t_index].name,tname,SSIZE);
 
 
-    /*-----------------------------------------------*/
-    /* Order the timer structure by handler priority */
-    /*-----------------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Process wheel tick - cascade coarse slots which are due     */
+/* (coarsest first), then expire the timers in the fine slot.  */
+/* Continuous timers are re-inserted here (so they do not      */
+/* drift while waiting for the root thread to run them)        */
+/*-------------------------------------------------------------*/
 
-    (void)qsort((void *)vttab,appl_max_vtimers,sizeof(vttab_type),(void *)sort_priority);
+_PRIVATE void vt_wheel_tick(const uint64_t tick)
 
+{   int32_t level,
+            slot,
+            shift,
+            t_index,
+            next;
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       if(mode == VT_CONTINUOUS)
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) continuous timer, priority %d (interval %5.2F secs)\n",
-                                                                                                                               date,
-                                                                                                                          appl_name,
-                                                                                                                           appl_pid,
-                                                                                                                          appl_host,
-                                                                                                                         appl_owner,
-                                                                                                                            t_index,
-                                                                                                                              tname,
-                                                                                                                           priority,
-                                                                                                           (FTYPE)interval / 1000.0);
-       else
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) one shot timer, priority %d (interval %5.2F secs)\n",
-                                                                                                                             date,
-                                                                                                                        appl_name,
-                                                                                                                         appl_pid,
-                                                                                                                        appl_host,
-                                                                                                                       appl_owner,
-                                                                                                                          t_index,
-                                                                                                                            tname,
-                                                                                                                         priority,
-                                                                                                          (FTYPE)interval /1000.0);
+    for(level=VT_WHEEL_LEVELS-1; level>0; --level)
+    {  shift = VT_WHEEL_BITS*level;
 
-       (void)fflush(stderr);
+       if((tick & (((uint64_t)1 << shift) - 1)) == 0)
+       {  slot    = (int32_t)((tick >> shift) & (VT_WHEEL_SLOTS - 1));
+          t_index = vt_wheel[level][slot];
+
+          vt_wheel[level][slot] = (-1);
+          vt_wheel_map[level]  &= ~((uint64_t)1 << slot);
+
+          for(; t_index != (-1); t_index=next)
+          {  next = vttab[t_index].next;
+             vt_wheel_insert(t_index,vttab[t_index].expires);
+          }
+       }
     }
 
+    slot    = (int32_t)(tick & (VT_WHEEL_SLOTS - 1));
+    t_index = vt_wheel[0][slot];
 
-    /*-----------------------------------------------------*/
-    /* Re-enable interrupts from underlying hardware timer */
-    /*-----------------------------------------------------*/
+    vt_wheel[0][slot] = (-1);
+    vt_wheel_map[0]  &= ~((uint64_t)1 << slot);
 
-    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-    (void)pups_malarm(vitimer_quantum);
+    for(; t_index != (-1); t_index=next)
+    {  next                      = vttab[t_index].next;
+       vttab[t_index].wheel_slot = (-1);
 
-    pups_set_errno(OK);
-    return(t_index);
-}
+       if(vttab[t_index].mode == VT_CONTINUOUS)
+          vt_wheel_insert(t_index,tick + (uint64_t)((vttab[t_index].interval_time > 0) ? vttab[t_index].interval_time : 1));
 
 
+       /*-----------------------------------------------*/
+       /* Expiries of a continuous timer which happen   */
+       /* before its handler has run are coalesced      */
+       /*-----------------------------------------------*/
 
+       if(vttab[t_index].fired == FALSE)
+       {  vttab[t_index].fired      = TRUE;
+          vttab[t_index].fired_next = vt_wheel_fired;
+          vt_wheel_fired            = t_index;
+       }
+    }
+}
 
-/*------------------------------*/
-/* Clear virtual interval timer */
-/*------------------------------*/
 
-_PUBLIC int32_t pups_clearvitimer(const char *tname)
 
-{   uint32_t i;
-    sigset_t set;
 
+/*-------------------------------------------------------------*/
+/* Advance wheel to the current time. Only ticks at which      */
+/* something happens are visited (the wheel is tickless)       */
+/*-------------------------------------------------------------*/
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+_PRIVATE void vt_wheel_advance(void)
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[clearvitimer] attempt by non root thread to perform PUPS/P3 global utility operation");
+{   uint64_t quantum,
+             target,
+             next;
 
-    if(tname == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+    quantum = vt_wheel_quantum();
+    target  = vt_wheel_now + (vt_wheel_clock() - vt_wheel_base) / quantum;
+
+    vt_wheel_base += (target - vt_wheel_now)*quantum;
+
+    while(vt_wheel_now < target)
+    {    if((next = vt_wheel_next()) > target)
+            vt_wheel_now = target;
+         else
+         {  vt_wheel_now = next;
+            vt_wheel_tick(next);
+         }
     }
+}
 
-    (void)pups_malarm(0);
-    (void)sigemptyset(&set);
-    (void)sigaddset(&set,SIGALRM);
-    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
 
-    for(i=0; i<appl_max_vtimers; ++i)
-    {  if(vttab[i].name != (char *)NULL && strcmp(vttab[i].name,tname) == 0)
-       {  if(appl_verbose == TRUE)
-          {  char date[SSIZE] = "";
 
-             (void)strdate(date);
 
-             if (strcmp(vttab[i].name,"") == 0)
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d cleared\n",
-                              date,appl_name,appl_pid,appl_host,appl_owner,i,vttab[i].name);
-             else
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) cleared\n",
-                                 date,appl_name,appl_pid,appl_host,appl_owner,i,vttab[i].name);
+/*-------------------------------------------------------------*/
+/* Arm timerfd for next wheel event (disarm if wheel empty) so */
+/* timer thread sleeps until it is actually needed             */
+/*-------------------------------------------------------------*/
 
-             (void)fflush(stderr);
-          }
+_PRIVATE void vt_wheel_arm(void)
 
+{   uint64_t          next,
+                      deadline;
+    struct itimerspec itimer;
 
-          vttab[i].mode            = 0;
-          vttab[i].priority        = 0;
-          vttab[i].prescaler       = 0;
-          vttab[i].interval_time   = 0;
-          vttab[i].handler         = NULL;
+    (void)memset((void *)&itimer,0,sizeof(struct itimerspec));
 
-          (void)strlcpy(vttab[i].name,        "",SSIZE);
-          (void)strlcpy(vttab[i].handler_args,"",SSIZE);
+    if((next = vt_wheel_next()) != UINT64_MAX)
+    {  deadline                = vt_wheel_base + (next - vt_wheel_now)*vt_wheel_quantum();
+       itimer.it_value.tv_sec  = (time_t)(deadline / 1000000000);
+       itimer.it_value.tv_nsec = (long)(deadline % 1000000000);
+    }
 
-          --active_v_timers;
+    (void)timerfd_settime(vt_wheel_des,TFD_TIMER_ABSTIME,&itimer,(struct itimerspec *)NULL);
+}
 
-          if(vt_no_reset == FALSE)
-          {  
 
-             /*---------------*/
-             /* Active timers */
-             /*---------------*/
 
-             if(active_v_timers > 0)
-             { 
 
-               /*------------------------------------------------------------*/
-               /* Note we have to re-enable the alarm after we have finished */
-               /* clearing timers in case it expired in the critical section */
-               /*------------------------------------------------------------*/
+/*-------------------------------------------------------------*/
+/* Timer wheel thread - sleeps on timerfd until next deadline, */
+/* advances wheel, then sends SIGALRM to root thread. Handlers */
+/* of expired timers are run by pups_vt_handler (so they still */
+/* run in signal context on the root thread)                   */
+/*-------------------------------------------------------------*/
 
-               (void)pups_malarm(vitimer_quantum);
-               (void)pups_malarm(vitimer_quantum);
-               (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-             }
+_PRIVATE void *vt_wheel_thread(void *arg)
 
+{   uint64_t expirations;
+    _BOOLEAN fired = FALSE;
 
-             /*------------------*/
-             /* No active timers */
-             /*------------------*/
+    while(TRUE)
+    {    if(read(vt_wheel_des,&expirations,sizeof(uint64_t)) == (-1) && errno != EINTR && errno != EAGAIN)
+            break;
 
-             else
-             {  (void)pups_malarm(0);
-                (void)pups_sighandle(SIGALRM,"default",SIG_DFL, (sigset_t *)NULL);
-                (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
-             }
-          }
-     
-          pups_set_errno(OK);
-          return(0);
-       }
+         (void)pthread_mutex_lock(&vt_wheel_mutex);
+
+         vt_wheel_advance();
+         vt_wheel_arm();
+         fired = FALSE;
+         if(vt_wheel_fired != (-1))
+            fired = TRUE;
+
+         (void)pthread_mutex_unlock(&vt_wheel_mutex);
+
+         if(fired == TRUE)
+            (void)pthread_kill(appl_root_tid,SIGALRM);
     }
 
-    pups_set_errno(ESRCH);
-    return(-1);
+    return((void *)NULL);
 }
 
- 
 
 
-/*--------------------------------------*/
-/* Display virtual interval timer table */                      
-/*--------------------------------------*/
 
-_PUBLIC void pups_show_vitimers(const FILE *stream)
+/*-------------------------------------------------------------*/
+/* Timer wheel thread does not survive fork - child falls back */
+/* to (signal driven) tick until pups_vitrestart is next       */
+/* called. Interval timers are not inherited across fork so    */
+/* the tick is re-armed here                                   */
+/*-------------------------------------------------------------*/
 
-{   uint32_t i;
+_PRIVATE void vt_wheel_child(void)
 
+{   int32_t           i;
+    pthread_mutex_t   malarm_init = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+    struct itimerval  itimer;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(vt_wheel_threaded == FALSE)
+       return;
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_show_vitimers] attempt by non root thread to perform PUPS/P3 global utility operation");
+    (void)close(vt_wheel_des);
+    (void)pthread_mutex_init(&vt_wheel_mutex,(pthread_mutexattr_t *)NULL);
 
-    if(stream == (const FILE *)NULL)
-    {  pups_set_errno(EINVAL);
-       return;
+
+    /*-------------------------------------------------*/
+    /* Some other (parent) thread may have held the    */
+    /* pups_malarm lock when we forked                 */
+    /*-------------------------------------------------*/
+
+    malarm_mutex = malarm_init;
+
+    for(i=0; i<appl_max_vtimers; ++i)
+    {  if(vttab[i].priority > 0)
+       {  if(vttab[i].fired == TRUE || vttab[i].expires <= vt_wheel_now)
+             vttab[i].prescaler = 1;
+          else
+             vttab[i].prescaler = (int32_t)(vttab[i].expires - vt_wheel_now);
+       }
+
+       vttab[i].wheel_slot = (-1);
+       vttab[i].fired      = FALSE;
     }
 
-    if(active_v_timers == 0)
-       (void)fprintf(stream,"\n\n    No virtual timers active (%d slots free)\n",appl_max_vtimers);
-    else
-    {  (void)fprintf(stream,"\n\n    Virtual timers active\n");
-       (void)fprintf(stream,"    =====================\n\n");
-       (void)fflush(stream);
+    vt_wheel_des      = (-1);
+    vt_wheel_fired    = (-1);
+    vt_wheel_threaded = FALSE;
 
-        (void)fprintf(stream,"    Virtual timer quantum is %7.4F seconds\n\n",(FTYPE)vitimer_quantum*1.e-7);
-        (void)fflush(stream);
 
-        for(i=0; i<appl_max_vtimers; ++i)
-        {  if(vttab[i].priority > 0)
-           {  if(vttab[i].mode == VT_CONTINUOUS)
-                 (void)fprintf(stream,
-                               "    %04d: \"%-48s\" priority %02d, continuous mode, interval time %7.4F secs, prescaler %04d, (handler at %016lx virtual)\n",i,
-                                                                                                                                                 vttab[i].name,
-                                                                                                                                             vttab[i].priority,
-                                                                                                                        (FTYPE)vttab[i].interval_time / 1000.0,
-                                                                                                                                            vttab[i].prescaler,
-                                                                                                                                    (uint64_t)vttab[i].handler);
-              else
-                (void)fprintf(stream,
-                              "    %04d: \"%-48s\" priority %02d, oneshot mode, interval time %7.4F secs, prescaler %04d, (handler at %016lx virtual)\n",i,
-                                                                                                                                             vttab[i].name,
-                                                                                                                                         vttab[i].priority,
-			                                                                                            (FTYPE)vttab[i].interval_time / 1000.0,
-                                                                                                                                        vttab[i].prescaler,
-                                                                                                                                (uint64_t)vttab[i].handler);
-              (void)fflush(stream);
-           }
-        }
+    /*-----------------------------------------------*/
+    /* Re-arm tick directly (pups_malarm is not safe */
+    /* to call in an atfork handler)                 */
+    /*-----------------------------------------------*/
 
-        if(active_v_timers > 1)
-           (void)fprintf(stream,"\n\n    %04d virtual timers in use (%04d slots free)\n\n",active_v_timers,appl_max_vtimers - active_v_timers);
-        else if(active_v_timers == 1)
-           (void)fprintf(stream,"\n\n    %04d virtual timers registered (%04d slots free)\n\n",1,appl_max_vtimers - 1);
-        else
-           (void)fprintf(stream,"    No virtual timers in use ((%04d slots free)\n\n",appl_max_vtimers);
-        (void)fflush(stream);
-     }
+    if(active_v_timers > 0)
+    {  itimer.it_interval.tv_sec  = 0;
+       itimer.it_interval.tv_usec = 0;
+       itimer.it_value.tv_sec     = 0;
+       itimer.it_value.tv_usec    = vitimer_quantum;
 
-     pups_set_errno(OK);
+       (void)setitimer(ITIMER_REAL,&itimer,(struct itimerval *)NULL);
+    }
 }
 
 
 
 
-
 /*-------------------------------------------------------------*/
-/* Routine to get (or test) write lock on open file descriptor */
+/* Start timer wheel thread. Any timers already running (on    */
+/* signal driven tick) are moved onto the wheel                */
 /*-------------------------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_get_fd_lock(const des_t fdes, const int32_t mode)
+_PRIVATE int32_t vt_wheel_start(void)
 
-{   int32_t f_index;
+{   int32_t  i,
+             level,
+             slot;
 
-    if(fdes < 0 || fdes >= appl_max_files || mode != GETLOCK && mode != TSTLOCK)
-    {  pups_set_errno(EINVAL);
+    sigset_t set,
+             old_set;
+
+    _IMMORTAL _BOOLEAN atfork_registered = FALSE;
+
+    if(vt_wheel_threaded == TRUE)
+       return(0);
+
+    if((vt_wheel_des = timerfd_create(CLOCK_MONOTONIC,TFD_CLOEXEC)) == (-1))
        return(-1);
+
+    for(level=0; level<VT_WHEEL_LEVELS; ++level)
+    {  for(slot=0; slot<VT_WHEEL_SLOTS; ++slot)
+          vt_wheel[level][slot] = (-1);
+
+       vt_wheel_map[level] = 0;
     }
 
-    if(in_psrp_new_segment == FALSE)
-    {  if((f_index = pups_get_ftab_index(fdes)) == (-1))
-       {  pups_set_errno(EBADF);
-          return(-1);
-       }
-    }
- 
-    if(mode == GETLOCK)
-    {  (void)lockf(fdes,F_LOCK,0);
-       pups_set_errno(OK);
-       return(TRUE);
-    }
-    else
-    {  if(lockf(fdes,F_TLOCK,0) < 0)
-       {  pups_set_errno(OK); 
-          return(FALSE);
-       }
+    vt_wheel_now   = 0;
+    vt_wheel_base  = vt_wheel_clock();
+    vt_wheel_fired = (-1);
+
+    for(i=0; i<appl_max_vtimers; ++i)
+    {  vttab[i].wheel_slot = (-1);
+       vttab[i].fired      = FALSE;
+
+       if(vttab[i].priority > 0)
+          vt_wheel_insert(i,(uint64_t)((vttab[i].prescaler > 0) ? vttab[i].prescaler : 1));
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    vt_wheel_arm();
 
-    if(in_psrp_new_segment == FALSE)
-       ftab[f_index].locked == TRUE;
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    /*-----------------------------------------------------------*/
+    /* Timer thread must not take any signals - they are all     */
+    /* handled by the root thread                                */
+    /*-----------------------------------------------------------*/
 
-    pups_set_errno(OK);
-    return(TRUE);
-}
+    (void)sigfillset(&set);
+    (void)pthread_sigmask(SIG_SETMASK,&set,&old_set);
 
+    if(pthread_create(&vt_wheel_tid,(pthread_attr_t *)NULL,vt_wheel_thread,(void *)NULL) != 0)
+    {  (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
+       (void)close(vt_wheel_des);
 
+       vt_wheel_des = (-1);
+       return(-1);
+    }
 
+    (void)pthread_sigmask(SIG_SETMASK,&old_set,(sigset_t *)NULL);
+    (void)pthread_detach(vt_wheel_tid);
 
-/*--------------------------------------------*/
-/* Release write lock on open file descriptor */ 
-/*--------------------------------------------*/
+    if(atfork_registered == FALSE)
+    {  (void)pthread_atfork((void *)NULL,(void *)NULL,vt_wheel_child);
+       atfork_registered = TRUE;
+    }
 
-_PUBLIC int32_t pups_release_fd_lock(const des_t fd)
+    vt_wheel_threaded = TRUE;
+    return(0);
+}
+#endif /* PTHREAD_SUPPORT */
 
-{   int32_t f_index;
 
-    if((f_index = pups_get_ftab_index(fd)) == (-1))
-    {  pups_set_errno(EBADF);
-       return(-1);
-    }
 
-    (void)lockf(fd,F_ULOCK,0); 
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+/*-------------------------------------------------------------*/
+/* Re-enable virtual timer system after critical section. The  */
+/* (signal driven) tick is only needed if the timer wheel is   */
+/* not running                                                 */
+/*-------------------------------------------------------------*/
 
-    ftab[f_index].locked = FALSE;
+_PRIVATE void vt_rearm(void)
 
+{
     #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
+    if(vt_wheel_threaded == TRUE)
+       return;
     #endif /* PTHREAD_SUPPORT */
 
-    pups_set_errno(OK);
-    return(TRUE);
+    (void)pups_malarm(vitimer_quantum);
 }
 
 
 
 
-/*------------------------------*/
-/* Acquire lock on (named) file */
-/*------------------------------*/
+/*------------------------------------------------------------------------------*/
+/* Restart virtual timer system (this routine is usually called as a precaution */
+/* after using dubious library functions e.g. CURSES which may silently reset   */
+/* signal handlers in an undocumented fashion)                                  */
+/* -----------------------------------------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_get_lock(const char *name, const int32_t mode)
+_PUBLIC int32_t pups_vitrestart(void)
 
-{   des_t    fdes = (-1);
-    _BOOLEAN ret;
+{
 
-    if(name == (const char *)NULL || (mode !=  GETLOCK && mode != TSTLOCK))
-    { pups_set_errno(EINVAL);
-      return(-1);
-    }
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    fdes = pups_open(name,2,LIVE);
-    if((ret = pups_get_fd_lock(fdes,mode)) == (-1))
-       return(-1);
-    else
-       fdes = pups_close(fdes);
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_vitrestart] attempt by non root thread to perform PUPS/P3 utility operation");
 
-    pups_set_errno(OK);
-    return(0);
-}
+    if((in_setvitimer == TRUE  && active_v_timers == 0)    ||
+       (in_setvitimer == FALSE && active_v_timers >  0)     )
+    {  sigset_t vt_set;
 
 
+       /*------------------------------------------------*/
+       /* Initialise interval timer if this is the first */
+       /* virtual timer activated                        */
+       /* vt_set is the set of signals masked when the   */
+       /* vt_handler function is running                 */
+       /*------------------------------------------------*/
 
+       (void)sigfillset(&vt_set);
 
-/*------------------------------*/
-/* Release lock on a named file */
-/*------------------------------*/
+       (void)sigdelset(&vt_set,SIGALRM);
+       (void)sigdelset(&vt_set,SIGINT);
+       (void)sigdelset(&vt_set,SIGTERM);
+       (void)sigdelset(&vt_set,SIGCONT);
 
-_PUBLIC _BOOLEAN pups_release_lock(const char *name)
+       (void)pups_sighandle(SIGALRM,"vt_handler",(void *)pups_vt_handler, &vt_set);
 
-{   des_t    fdes = (-1);
-    _BOOLEAN ret;
+       in_vt_handler = FALSE;
 
-    if(name == (const char *)NULL)
-    { pups_set_errno(EINVAL);
-      return(-1);
-    }
 
-    fdes = pups_open(name,2,LIVE);
-    ret  = pups_release_fd_lock(fdes);
-    fdes = pups_close(fdes);
+       /*------------------------------------------------*/
+       /* Run virtual timers from timer wheel if we can, */
+       /* otherwise from (signal driven) tick            */
+       /*------------------------------------------------*/
 
-    pups_set_errno(OK);
-    return(ret);
-}
+       #ifdef PTHREAD_SUPPORT
+       if(vt_wheel_start() == (-1))
+       #endif /* PTHREAD_SUPPORT */
 
+       (void)pups_malarm(vitimer_quantum);
+ 
+       pups_set_errno(OK);
+       return(0);
+    }
+ 
+    pups_set_errno(EINVAL);
+    return(-1);
+}
 
 
 
 
-/*----------------------------------------*/
-/* Attach homeostat to a file table entry */
-/*----------------------------------------*/
+/*----------------------------*/
+/* Set virtual interval timer */
+/*----------------------------*/
+                                                              /*---------------------------------*/
+_PUBLIC int32_t pups_setvitimer(const char     *tname      ,  /* Timer payload name              */
+                                const  int32_t priority    ,  /* Priority of handler             */
+                                const  int32_t mode        ,  /* Mode of timer                   */
+                                const time_t  interval     ,  /* Timeout interval (microseconds) */
+                                const char    *handler_args,  /* Handler arguments               */
+                                const void    *handler     )  /* Handler called on timeout       */
+                                                              /*---------------------------------*/
 
-_PUBLIC int32_t pups_attach_homeostat(const des_t fd, const void *homeostat)
+{   int32_t  i,
+             t_index;
 
-{   int32_t f_index;
+    time_t   tdum;
+    sigset_t set;
 
-    if(homeostat == (const void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
 
     /*----------------------------------*/
     /* Only the root thread can process */
@@ -14944,148 +15188,211 @@ _PUBLIC int32_t pups_attach_homeostat(const des_t fd, const void *homeostat)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_attach_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
+       pups_error("[pups_setvitimer] attempt by non root thread to perform PUPS/P3 global utility operation");
 
-    if((f_index = pups_get_ftab_index(fd)) == (-1))
-    {  pups_set_errno(EBADF);
-       return(-1); 
+    if(tname        == (const char *)NULL  ||
+       priority     <  0                   ||
+       interval     <  0                   ||
+       handler      == (const void *)NULL   )
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
- 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    ftab[f_index].homeostat = homeostat;
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    /*----------------------------------------------------------*/
+    /* If we have disabled VT services do not process this call */
+    /*----------------------------------------------------------*/
 
-    pups_set_errno(OK);
-    return(0);
-}
+    if(no_vt_services == TRUE)
+    {  pups_set_errno(EACCES);
+       return(-1);
+    }
 
+    if(priority < 0)
+       pups_error("[setvitimer] invalid priority");
 
 
 
-/*-------------------------------------------------*/
-/* Detach homeostat function from file table entry */
-/*-------------------------------------------------*/
+    /*-------------------------------------------*/
+    /* Ignore timer signals while reseting timer */
+    /*-------------------------------------------*/
 
-_PUBLIC  int32_t pups_detach_homeostat(const des_t fd)
+    (void)pups_malarm(0);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGALRM);
+    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
 
-{    int32_t f_index;
 
+    /*--------------------------------------------*/
+    /* Get free timer slot and check to make sure */
+    /* this timer is unique                       */
+    /*--------------------------------------------*/
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    for(i=0; i<appl_max_vtimers; ++i)
+    {   if(vttab[i].name != (char *)NULL && strcmp(vttab[i].name,tname) == 0)
+        {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+           vt_rearm();
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_detach_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
+           pups_set_errno(EEXIST);
+           return(-1);
+        }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+        if((void *)vttab[i].handler == (void *)NULL)
+        {  t_index = i;
+           goto free_timer;
+        }
+    }
 
-    if((f_index = pups_get_ftab_index(fd)) == (-1)) 
-    {
+    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+    vt_rearm();
 
-       #ifdef PTHREAD_SUPPORT
-       (void)pthread_mutex_unlock(&ftab_mutex);
-       #endif /* PTHREAD_SUPPORT */
+    pups_set_errno(ENOSPC);
+    return(-1);
 
-       pups_set_errno(EBADF);
-       return(-1); 
+free_timer:
+
+    if(mode != VT_ONESHOT && mode != VT_CONTINUOUS)
+    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+       vt_rearm();
+
+       pups_set_errno(EINVAL);
+       return(-1);
     }
 
-    ftab[f_index].homeostat = (void *)NULL;
+    if(interval <= 0)
+    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+       vt_rearm();
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+       pups_set_errno(ERANGE);
+       return(-1);
+    }
 
-    pups_set_errno(OK);
-    return(0);
-}
 
+    /*------------------------------------------------*/
+    /* Set up signal handler for virtual timer system */
+    /*------------------------------------------------*/
 
+    in_setvitimer = TRUE;
+    (void)pups_vitrestart();
+    in_setvitimer = FALSE;
 
 
-/*--------------------------------------------------------------------*/
-/* Check for space of filesystem associated with open file descriptor */
-/*--------------------------------------------------------------------*/
+    /*----------------------*/
+    /* Set up virtual timer */
+    /*----------------------*/
 
-_PUBLIC _BOOLEAN pups_check_fs_space(const des_t fd)
+    if(vttab[t_index].priority == 0)
+       ++active_v_timers;
 
-{   int32_t            f_index;
-    struct    statfs   fs_state;
-    _IMMORTAL _BOOLEAN entered = FALSE;
+    vttab[t_index].priority       = priority;
 
-    if((f_index = pups_get_ftab_index(fd)) == (-1))
-    {  pups_set_errno(EBADF);
-       return(-1);  
+
+    /*-------------------------------------------------------------*/
+    /* A negative interval means that we want the payload function */
+    /* run immediately                                             */
+    /*-------------------------------------------------------------*/
+
+    if(interval > 0 && mode == VT_CONTINUOUS)
+       vttab[t_index].prescaler   =  interval;
+    else if(mode != VT_CONTINUOUS)
+    {  (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+       vt_rearm();
+
+       pups_set_errno(EINVAL);
+       return(-1);
     }
- 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
+    vttab[t_index].interval_time  =  interval;
+    vttab[t_index].mode           = mode;
+    vttab[t_index].handler        = handler;
 
-    /*--------------------------------------------*/
-    /* Find the state of the nominated filesystem */
-    /*--------------------------------------------*/
+    if(handler_args != (char *)NULL)
+       (void)strlcpy(vttab[t_index].handler_args,handler_args,SSIZE);
 
-    (void)fstatfs(fd,&fs_state);
+    (void)strlcpy(vttab[t_index].name,tname,SSIZE);
 
-    if(fs_state.f_bavail  < ftab[f_index].fs_blocks)
-    {  if(appl_verbose == TRUE && entered == FALSE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): file system full (%s) [free:%ld, limit:%ld] (FSHP version %s)\n",
-                                                                                                              date,
-                                                                                                         appl_name,
-                                                                                                          appl_pid,
-                                                                                                         appl_host,
-                                                                                                        appl_owner,
-                                                                                               ftab[f_index].fname,
-                                                                                                 fs_state.f_bavail,
-                                                                                           ftab[f_index].fs_blocks,
-                                                                                                      FSHP_VERSION);
-          (void)fflush(stderr);
-       }
 
-       entered = TRUE;
+    /*-------------------------------------------------*/
+    /* Schedule timer on wheel (O(1)). Timers are not  */
+    /* re-ordered, priority is applied when expired    */
+    /* timers are run                                  */
+    /*-------------------------------------------------*/
+
+    #ifdef PTHREAD_SUPPORT
+    if(vt_wheel_threaded == TRUE)
+    {  sigset_t old_set;
+
+       vt_wheel_lock(&old_set);
+
+       vt_wheel_advance();
+       vt_wheel_cancel(t_index);
+       vt_wheel_insert(t_index,vt_wheel_now + (uint64_t)interval);
+       vt_wheel_arm();
+
+       vt_wheel_unlock(&old_set);
     }
     else
-    {  entered = FALSE;
+    #endif /* PTHREAD_SUPPORT */
 
-       #ifdef PTHREAD_SUPPORT
-       (void)pthread_mutex_unlock(&ftab_mutex);
-       #endif /* PTHREAD_SUPPORT */
 
-      pups_set_errno(OK);
-      return(TRUE);
+    /*-----------------------------------------------*/
+    /* Order the timer structure by handler priority */
+    /*-----------------------------------------------*/
+
+    (void)qsort((void *)vttab,appl_max_vtimers,sizeof(vttab_type),(void *)sort_priority);
+
+
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       if(mode == VT_CONTINUOUS)
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) continuous timer, priority %d (interval %5.2F secs)\n",
+                                                                                                                               date,
+                                                                                                                          appl_name,
+                                                                                                                           appl_pid,
+                                                                                                                          appl_host,
+                                                                                                                         appl_owner,
+                                                                                                                            t_index,
+                                                                                                                              tname,
+                                                                                                                           priority,
+                                                                                                           (FTYPE)interval / 1000.0);
+       else
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) one shot timer, priority %d (interval %5.2F secs)\n",
+                                                                                                                             date,
+                                                                                                                        appl_name,
+                                                                                                                         appl_pid,
+                                                                                                                        appl_host,
+                                                                                                                       appl_owner,
+                                                                                                                          t_index,
+                                                                                                                            tname,
+                                                                                                                         priority,
+                                                                                                          (FTYPE)interval /1000.0);
+
+       (void)fflush(stderr);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+
+    /*-----------------------------------------------------*/
+    /* Re-enable interrupts from underlying hardware timer */
+    /*-----------------------------------------------------*/
+
+    (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+    vt_rearm();
 
     pups_set_errno(OK);
-    return(FALSE);
+    return(t_index);
 }
 
 
 
 
-/*-------------------------------------------------------------*/
-/* Set parameters for homeostatic file system space monitoring */
-/*-------------------------------------------------------------*/
+/*------------------------------*/
+/* Clear virtual interval timer */
+/*------------------------------*/
 
-_PUBLIC int32_t pups_set_fs_hsm_parameters(const des_t fd, const int32_t fs_blocks, const char *fs_name)
+_PUBLIC int32_t pups_clearvitimer(const char *tname)
 
-{   int32_t f_index;
+{   uint32_t i;
+    sigset_t set;
 
 
     /*----------------------------------*/
@@ -15094,317 +15401,352 @@ _PUBLIC int32_t pups_set_fs_hsm_parameters(const des_t fd, const int32_t fs_bloc
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_set_fs_hsm_parameters] attempt by non root thread to perform PUPS/P3 utility operation");
+       pups_error("[clearvitimer] attempt by non root thread to perform PUPS/P3 global utility operation");
 
-    if(fs_blocks <= 0 || fs_name == (const char *)NULL)
+    if(tname == (const char *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    if((f_index = pups_get_ftab_index(fd)) == (-1)) 
-    {  pups_set_errno(EBADF);
-       return(-1);
-    }
+    (void)pups_malarm(0);
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set,SIGALRM);
+    (void)pups_sigprocmask(SIG_BLOCK,&set,(sigset_t *)NULL);
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    for(i=0; i<appl_max_vtimers; ++i)
+    {  if(vttab[i].name != (char *)NULL && strcmp(vttab[i].name,tname) == 0)
+       {  if(appl_verbose == TRUE)
+          {  char date[SSIZE] = "";
 
-    ftab[f_index].fs_blocks = fs_blocks;
+             (void)strdate(date);
 
-    if(fs_name != (char *)NULL)
-       (void)strlcpy(ftab[f_index].fs_name,fs_name,SSIZE); 
-    else
-       (void)strlcpy(ftab[f_index].fs_name,"<unknown>",SSIZE);
+             if (strcmp(vttab[i].name,"") == 0)
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d cleared\n",
+                              date,appl_name,appl_pid,appl_host,appl_owner,i,vttab[i].name);
+             else
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): PUPS virtual timer %d (%s) cleared\n",
+                                 date,appl_name,appl_pid,appl_host,appl_owner,i,vttab[i].name);
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+             (void)fflush(stderr);
+          }
 
-    pups_set_errno(OK);
-    return(0);
-}
+          #ifdef PTHREAD_SUPPORT
+          if(vt_wheel_threaded == TRUE)
+          {  sigset_t old_set;
 
+             vt_wheel_lock(&old_set);
+             vt_wheel_cancel(i);
+             vt_wheel_unlock(&old_set);
+          }
+          #endif /* PTHREAD_SUPPORT */
 
+          vttab[i].mode            = 0;
+          vttab[i].priority        = 0;
+          vttab[i].prescaler       = 0;
+          vttab[i].interval_time   = 0;
+          vttab[i].handler         = NULL;
 
+          (void)strlcpy(vttab[i].name,        "",SSIZE);
+          (void)strlcpy(vttab[i].handler_args,"",SSIZE);
 
-/*-----------------------------------------------------------------------------------*/
-/* Homeostatic write check the default action is to wait until file system has space */
-/* available. If mfunc is non-null this is executed (and implements a file           */
-/*  migration scheme)                                                                */
-/* ----------------------------------------------------------------------------------*/
-                                                    /*------------------------------*/
-_PUBLIC _BOOLEAN fs_write_blocked = FALSE;          /* If TRUE filesystem full      */
-                                                    /*------------------------------*/
+          --active_v_timers;
 
-_PUBLIC int32_t pups_write_homeostat(const des_t fdes, int32_t (*mfunc)(int32_t))
+          if(vt_no_reset == FALSE)
+          {  
 
-{      
+             /*---------------*/
+             /* Active timers */
+             /*---------------*/
 
-    int32_t iter = 0, 
-            f_index;
+             if(active_v_timers > 0)
+             { 
 
-    struct statfs  fs_buf;
+               /*------------------------------------------------------------*/
+               /* Note we have to re-enable the alarm after we have finished */
+               /* clearing timers in case it expired in the critical section */
+               /*------------------------------------------------------------*/
 
+               vt_rearm();
+               vt_rearm();
+               (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+             }
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_write_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
+             /*------------------*/
+             /* No active timers */
+             /*------------------*/
 
-    if((void *)mfunc == (void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+             else
+             {  (void)pups_malarm(0);
 
-    f_index = pups_get_ftab_index(fdes);
 
-    if(fstatfs(fdes,&fs_buf) == (-1))
-    {  pups_set_errno(EBADF);
-       return(-1);
+                /*---------------------------------------------*/
+                /* Discard any SIGALRM already sent by timer   */
+                /* wheel thread (before it is made default)    */
+                /*---------------------------------------------*/
+
+                #ifdef PTHREAD_SUPPORT
+                if(vt_wheel_threaded == TRUE)
+                   (void)pups_sighandle(SIGALRM,"ignore",SIG_IGN, (sigset_t *)NULL);
+                #endif /* PTHREAD_SUPPORT */
+
+                (void)pups_sighandle(SIGALRM,"default",SIG_DFL, (sigset_t *)NULL);
+                (void)pups_sigprocmask(SIG_UNBLOCK,&set,(sigset_t *)NULL);
+             }
+          }
+     
+          pups_set_errno(OK);
+          return(0);
+       }
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    pups_set_errno(ESRCH);
+    return(-1);
+}
 
+ 
 
-    /*------------------------------------------------------------*/
-    /* If a monitoring function is installed, execute it when the */
-    /* file system filled to user defined limit                   */ 
-    /*------------------------------------------------------------*/
 
-    if(fs_buf.f_bavail < ftab[f_index].fs_blocks && (void *)mfunc != (void *)NULL)
-    {  int32_t new_fdes;
+/*--------------------------------------*/
+/* Display virtual interval timer table */                      
+/*--------------------------------------*/
 
-       fs_write_blocked = TRUE;
-       new_fdes         = (*mfunc)(fdes);
-       fs_write_blocked = FALSE;
+_PUBLIC void pups_show_vitimers(const FILE *stream)
 
-       pups_set_errno(OK);
-       return(new_fdes);
-    }
-    else
-    {  while(fs_buf.f_bavail < ftab[f_index].fs_blocks)
-       {    
+{   uint32_t i;
 
-            /*------------------------------------------------------------------*/
-            /* Stop rest of process group (usually processes in same pipeline   */ 
-            /* as caller)                                                       */
-            /* Note that we have to ignore SIGTSTOP as we have to remain active */
-            /* to monitor the state of the filesystem we are writing to         */
-            /*------------------------------------------------------------------*/
 
-            if(iter == 0)
-            {  (void)pups_sighandle(SIGTSTP,"ignored",SIG_IGN,(sigset_t *)NULL);
-               (void)kill(0,SIGTSTP);
-            }
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-            (void)sched_yield();
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_show_vitimers] attempt by non root thread to perform PUPS/P3 global utility operation");
 
-            if(iter == 0 && appl_verbose == TRUE)
-            {  (void)strdate(date);
-               (void)fprintf(stderr,"%s %s (%d@%s): file system full (%s:%d) [avail:%ld limit:%ld] (FSHP version %s)\n",
-                                                                                                                   date,
-                                                                                                              appl_name,
-                                                                                                               appl_pid,
-                                                                                                              appl_host,
-                                                                                                    ftab[f_index].fname,
-                                                                                                                   fdes,
-                                                                                                        fs_buf.f_bavail,
-                                                                                                ftab[f_index].fs_blocks,
-                                                                                                           FSHP_VERSION);
-               (void)fflush(stderr);
+    if(stream == (const FILE *)NULL)
+    {  pups_set_errno(EINVAL);
+       return;
+    }
 
-               fs_write_blocked = TRUE;
-            }
+    if(active_v_timers == 0)
+       (void)fprintf(stream,"\n\n    No virtual timers active (%d slots free)\n",appl_max_vtimers);
+    else
+    {  (void)fprintf(stream,"\n\n    Virtual timers active\n");
+       (void)fprintf(stream,"    =====================\n\n");
+       (void)fflush(stream);
 
-            ++iter;
-            (void)fstatfs(fdes, &fs_buf);
-       }
+        (void)fprintf(stream,"    Virtual timer quantum is %7.4F seconds\n\n",(FTYPE)vitimer_quantum*1.e-7);
+        (void)fflush(stream);
 
-       if(fs_write_blocked == TRUE)
-       {  if(appl_verbose == TRUE)
-          {  (void)strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem has space (%s:%d): continuing (FSHP version %s)\n",date,
-                                                                                                              appl_name,
-                                                                                                               appl_pid,
-                                                                                                             appl_owner,
-                                                                                                              appl_host,
-                                                                                                    ftab[f_index].fname,
-                                                                                                                   fdes,
-                                                                                                           FSHP_VERSION);
-             (void)fflush(stderr);
-          }
 
+        /*-----------------------------------------------*/
+        /* Timer wheel running - prescaler is the number */
+        /* of ticks until timer next expires             */
+        /*-----------------------------------------------*/
 
-          /*-----------------------------------------------*/
-          /* Restore default signal processing for SIGSTOP */
-          /* and restart pipeline                          */
-          /*-----------------------------------------------*/
+        #ifdef PTHREAD_SUPPORT
+        if(vt_wheel_threaded == TRUE)
+        {  uint64_t now;
+           sigset_t old_set;
 
-          fs_write_blocked = FALSE;
-          (void)pups_sighandle(SIGTSTP,"default",SIG_DFL,(sigset_t *)NULL); 
-          (void)kill(0,SIGCONT);
-       }
-    }
+           vt_wheel_lock(&old_set);
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+           now = vt_wheel_now + (vt_wheel_clock() - vt_wheel_base) / vt_wheel_quantum();
+           for(i=0; i<appl_max_vtimers; ++i)
+           {  if(vttab[i].priority > 0)
+                 vttab[i].prescaler = (vttab[i].expires > now) ? (int32_t)(vttab[i].expires - now) : 0;
+           }
 
-    pups_set_errno(OK);
-    return(0);
+           vt_wheel_unlock(&old_set);
+        }
+        #endif /* PTHREAD_SUPPORT */
+
+        for(i=0; i<appl_max_vtimers; ++i)
+        {  if(vttab[i].priority > 0)
+           {  if(vttab[i].mode == VT_CONTINUOUS)
+                 (void)fprintf(stream,
+                               "    %04d: \"%-48s\" priority %02d, continuous mode, interval time %7.4F secs, prescaler %04d, (handler at %016lx virtual)\n",i,
+                                                                                                                                                 vttab[i].name,
+                                                                                                                                             vttab[i].priority,
+                                                                                                                        (FTYPE)vttab[i].interval_time / 1000.0,
+                                                                                                                                            vttab[i].prescaler,
+                                                                                                                                    (uint64_t)vttab[i].handler);
+              else
+                (void)fprintf(stream,
+                              "    %04d: \"%-48s\" priority %02d, oneshot mode, interval time %7.4F secs, prescaler %04d, (handler at %016lx virtual)\n",i,
+                                                                                                                                             vttab[i].name,
+                                                                                                                                         vttab[i].priority,
+			                                                                                            (FTYPE)vttab[i].interval_time / 1000.0,
+                                                                                                                                        vttab[i].prescaler,
+                                                                                                                                (uint64_t)vttab[i].handler);
+              (void)fflush(stream);
+           }
+        }
+
+        if(active_v_timers > 1)
+           (void)fprintf(stream,"\n\n    %04d virtual timers in use (%04d slots free)\n\n",active_v_timers,appl_max_vtimers - active_v_timers);
+        else if(active_v_timers == 1)
+           (void)fprintf(stream,"\n\n    %04d virtual timers registered (%04d slots free)\n\n",1,appl_max_vtimers - 1);
+        else
+           (void)fprintf(stream,"    No virtual timers in use ((%04d slots free)\n\n",appl_max_vtimers);
+        (void)fflush(stream);
+     }
+
+     pups_set_errno(OK);
 }
 
 
 
 
-/*---------------------------*/
-/* PUPS compliant sleep call */
-/*---------------------------*/
 
-_PUBLIC int32_t pups_sleep(const int32_t secs)
+/*-------------------------------------------------------------*/
+/* Routine to get (or test) write lock on open file descriptor */
+/*-------------------------------------------------------------*/
 
-{   uint32_t i;
+_PUBLIC _BOOLEAN pups_get_fd_lock(const des_t fdes, const int32_t mode)
 
-    if(secs <= 0)
+{   int32_t f_index;
+
+    if(fdes < 0 || fdes >= appl_max_files || mode != GETLOCK && mode != TSTLOCK)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
+    if(in_psrp_new_segment == FALSE)
+    {  if((f_index = pups_get_ftab_index(fdes)) == (-1))
+       {  pups_set_errno(EBADF);
+          return(-1);
+       }
+    }
+ 
+    if(mode == GETLOCK)
+    {  (void)lockf(fdes,F_LOCK,0);
+       pups_set_errno(OK);
+       return(TRUE);
+    }
+    else
+    {  if(lockf(fdes,F_TLOCK,0) < 0)
+       {  pups_set_errno(OK); 
+          return(FALSE);
+       }
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    /*-----------------------------------------------------------------*/
-    /* Use half seconds so we do not cause an overflow in nanosleep()  */
-    /*-----------------------------------------------------------------*/
+    if(in_psrp_new_segment == FALSE)
+       ftab[f_index].locked == TRUE;
 
-    for(i=0; i<2*secs; ++i)
-       pups_usleep(500000); 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
     pups_set_errno(OK);
-    return(0);
+    return(TRUE);
 }
 
 
 
 
-/*--------------------------------------------------------*/
-/* Microsecond alarm function (raises SIGALRM on timeout) */
-/*--------------------------------------------------------*/
+/*--------------------------------------------*/
+/* Release write lock on open file descriptor */ 
+/*--------------------------------------------*/
 
-_PUBLIC int32_t pups_malarm(const uint64_t usecs)
+_PUBLIC int32_t pups_release_fd_lock(const des_t fd)
 
-{   struct   itimerval itimer;
-    sigset_t set;
-    int32_t  ret;
+{   int32_t f_index;
+
+    if((f_index = pups_get_ftab_index(fd)) == (-1))
+    {  pups_set_errno(EBADF);
+       return(-1);
+    }
+
+    (void)lockf(fd,F_ULOCK,0); 
 
     #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&malarm_mutex);
+    (void)pthread_mutex_lock(&ftab_mutex);
     #endif /* PTHREAD_SUPPORT */
 
-    itimer.it_interval.tv_sec  = 0;
-    itimer.it_interval.tv_usec = 0;
-    itimer.it_value.tv_sec     = 0;
-    itimer.it_value.tv_usec    = usecs;
-
-    ret = setitimer(ITIMER_REAL,&itimer,(struct itimerval *)NULL);
+    ftab[f_index].locked = FALSE;
 
     #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&malarm_mutex);
+    (void)pthread_mutex_unlock(&ftab_mutex);
     #endif /* PTHREAD_SUPPORT */
 
-    return(ret);
+    pups_set_errno(OK);
+    return(TRUE);
 }
 
 
 
 
-/*------------------------------------------------------------*/
-/* Unhide the branch part of a file pathname (and its shadow) */
-/*------------------------------------------------------------*/
-
-_PRIVATE _BOOLEAN pups_unhide_pathnames(vttab_type *t_info, const char *fname, const char *fshadow)
+/*------------------------------*/
+/* Acquire lock on (named) file */
+/*------------------------------*/
 
-{   char new_fname[SSIZE] = "";
+_PUBLIC _BOOLEAN pups_get_lock(const char *name, const int32_t mode)
 
+{   des_t    fdes = (-1);
+    _BOOLEAN ret;
 
-    /*------------------*/
-    /* Update file name */
-    /*------------------*/
+    if(name == (const char *)NULL || (mode !=  GETLOCK && mode != TSTLOCK))
+    { pups_set_errno(EINVAL);
+      return(-1);
+    }
 
-    if(fname[0] == '.') 
-       (void)snprintf (new_fname,SSIZE,"%s",(char *)&fname[1]);
+    fdes = pups_open(name,2,LIVE);
+    if((ret = pups_get_fd_lock(fdes,mode)) == (-1))
+       return(-1);
     else
-       (void)strep(fname,  new_fname, "/.", "/");
-
-    if(strcmp(fname,new_fname) != 0)
-    {  char branch     [SSIZE] = "",
-            new_branch [SSIZE] = "",
-            leaf       [SSIZE] = "", 
-            new_fshadow[SSIZE] = "";
+       fdes = pups_close(fdes);
 
+    pups_set_errno(OK);
+    return(0);
+}
 
-       /*-----------------------*/
-       /* Update file homeostat */
-       /*-----------------------*/
 
-       (void)strlcpy((char *)t_info->name,new_fname,SSIZE);
 
 
-       /*-----------------*/
-       /* Update filename */
-       /*-----------------*/
+/*------------------------------*/
+/* Release lock on a named file */
+/*------------------------------*/
 
-       (void)strlcpy(fname,new_fname,SSIZE);
+_PUBLIC _BOOLEAN pups_release_lock(const char *name)
 
+{   des_t    fdes = (-1);
+    _BOOLEAN ret;
 
-       /*-------------------------*/
-       /* Update shadow file name */
-       /*-------------------------*/
+    if(name == (const char *)NULL)
+    { pups_set_errno(EINVAL);
+      return(-1);
+    }
 
-       (void)strbranch(fshadow,branch);
-       (void)strleaf  (fshadow,leaf);
+    fdes = pups_open(name,2,LIVE);
+    ret  = pups_release_fd_lock(fdes);
+    fdes = pups_close(fdes);
 
-       if(branch[0] == '.')
-          (void)snprintf (new_fshadow,SSIZE,"%s/%s",(char *)&branch[1],leaf);
-       else
-       {  (void)strep    (branch, new_branch, "/.", "/");
-          (void)snprintf (new_fshadow,SSIZE,"%s/%s",new_branch,leaf);
-       }
-
-       (void)rename (fshadow,new_fshadow);
-       (void)strlcpy(fshadow,new_fshadow,SSIZE);
-
-
-
-       return(TRUE);  
-    }
-
-    return(FALSE); 
+    pups_set_errno(OK);
+    return(ret);
 }
 
 
 
 
-/*----------------------------*/
-/* Homeostat for (open) files */
-/*----------------------------*/
 
-_PUBLIC _BOOLEAN default_fd_homeostat_action = FALSE;
+/*----------------------------------------*/
+/* Attach homeostat to a file table entry */
+/*----------------------------------------*/
 
-_PUBLIC int32_t pups_default_fd_homeostat(void *t_info, const char *args)
+_PUBLIC int32_t pups_attach_homeostat(const des_t fd, const void *homeostat)
 
 {   int32_t f_index;
 
-    char    fname[SSIZE]            = "",
-            object_type[SSIZE]      = "",
-            current_hostname[SSIZE] = "";
-
-    struct  stat buf;
-
+    if(homeostat == (const void *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
     /*----------------------------------*/
     /* Only the root thread can process */
@@ -15412,971 +15754,1861 @@ _PUBLIC int32_t pups_default_fd_homeostat(void *t_info, const char *args)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_default_fd_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
-
-    if(t_info == (void *)      NULL   ||
-       args   == (const char *)NULL    )
-       pups_error("[pups_default_fd_homeostat] invalid arguments");
-
-    if(sscanf(args,"%d",&f_index) != 1 || f_index < 0)
-       pups_error("[pups_default_fd_homeostat] argument decode error");
-
+       pups_error("[pups_attach_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
 
+    if((f_index = pups_get_ftab_index(fd)) == (-1))
+    {  pups_set_errno(EBADF);
+       return(-1); 
+    }
+ 
     #ifdef PTHREAD_SUPPORT
     (void)pthread_mutex_lock(&ftab_mutex);
     #endif /* PTHREAD_SUPPORT */
 
+    ftab[f_index].homeostat = homeostat;
 
-    /*------------------------------------------------------------------------------*/
-    /* If this is one of the stdio descriptors -- check to see if our process group */
-    /* is currently in the foreground.                                              */
-    /*------------------------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    pups_set_errno(OK);
+    return(0);
+}
 
-    /*--------------------------------------------------*/
-    /* Check whether we are currently a foreground task */
-    /*--------------------------------------------------*/
 
-    if(appl_fgnd == TRUE)
-    {  
 
-       /*---------------------------------------------------------*/
-       /* Is this application about to go  int32_to the background?    */ 
-       /* If so all unredirected stdio streams must be redirected */
-       /* to the data sink                                        */
-       /*---------------------------------------------------------*/
 
-       if(appl_nodetach == FALSE && tcgetpgrp(appl_tty) != getpgrp())
-       {   if(appl_verbose == TRUE)
-           {  (void)strdate(date);
-              (void)fprintf(stderr,"%s %s (%d@%s:%s): background (controlling tty [%s] detached)\n",
-                                          date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
-              (void)fflush(stderr);
-           }
+/*-------------------------------------------------*/
+/* Detach homeostat function from file table entry */
+/*-------------------------------------------------*/
 
-           if(isatty(0) == 1)
-           {
+_PUBLIC  int32_t pups_detach_homeostat(const des_t fd)
 
-              /*--------------------------------------*/
-              /* Backgrounded channels are never live */ 
-              /*--------------------------------------*/
+{    int32_t f_index;
 
-              (void)fclose(stdin);
-              stdin = fopen("/dev/null","r");
 
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-              /*-----------------------------------------------*/
-              /* Make sure that we do not remove /dev/tty      */
-              /* this is possible if application is runnig as  */
-              /* suid root and we do not protect /dev/tty with */
-              /* a guard link                                  */
-              /*-----------------------------------------------*/
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_detach_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
 
-              if(getuid() == 0)
-                 (void)link("/dev/tty","/dev/ttyprot");
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    if((f_index = pups_get_ftab_index(fd)) == (-1)) 
+    {
 
-              /*-----------------*/
-              /* Remove the file */
-              /*-----------------*/
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&ftab_mutex);
+       #endif /* PTHREAD_SUPPORT */
 
-              (void)unlink(ftab[0].fname);
+       pups_set_errno(EBADF);
+       return(-1); 
+    }
 
+    ftab[f_index].homeostat = (void *)NULL;
 
-              /*--------------------*/
-              /* Remove shadow file */
-              /*--------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-              (void)unlink(ftab[0].fshadow);
+    pups_set_errno(OK);
+    return(0);
+}
 
-              if(getuid() == 0)
-                 (void)rename("/dev/ttyprot","/dev/tty");
 
-              (void)strlcpy(ftab[0].fname,  "/dev/null",SSIZE);
-              (void)strlcpy(ftab[0].fshadow,"/dev/null",SSIZE);
-           }
 
-           if(isatty(1) == 1)
-           {  (void)fclose(stdout);
-              stdout = fopen("/dev/null","w");
 
+/*--------------------------------------------------------------------*/
+/* Check for space of filesystem associated with open file descriptor */
+/*--------------------------------------------------------------------*/
 
-              /*-----------------------------------------------*/
-              /* Make sure that we do not remove /dev/tty      */
-              /* this is possible if application is runnig as  */
-              /* suid root and we do not protect /dev/tty with */
-              /* a guard link                                  */
-              /*-----------------------------------------------*/
+_PUBLIC _BOOLEAN pups_check_fs_space(const des_t fd)
 
-              if(getuid() == 0)
-                 (void)link("/dev/tty","/dev/ttyprot");
+{   int32_t            f_index;
+    struct    statfs   fs_state;
+    _IMMORTAL _BOOLEAN entered = FALSE;
 
+    if((f_index = pups_get_ftab_index(fd)) == (-1))
+    {  pups_set_errno(EBADF);
+       return(-1);  
+    }
+ 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-              /*-----------------*/
-              /* Remove the file */
-              /*-----------------*/
 
-              (void)unlink(ftab[1].fname);
+    /*--------------------------------------------*/
+    /* Find the state of the nominated filesystem */
+    /*--------------------------------------------*/
 
+    (void)fstatfs(fd,&fs_state);
 
-              /*--------------------*/
-              /* Remove shadow file */
-              /*--------------------*/
+    if(fs_state.f_bavail  < ftab[f_index].fs_blocks)
+    {  if(appl_verbose == TRUE && entered == FALSE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): file system full (%s) [free:%ld, limit:%ld] (FSHP version %s)\n",
+                                                                                                              date,
+                                                                                                         appl_name,
+                                                                                                          appl_pid,
+                                                                                                         appl_host,
+                                                                                                        appl_owner,
+                                                                                               ftab[f_index].fname,
+                                                                                                 fs_state.f_bavail,
+                                                                                           ftab[f_index].fs_blocks,
+                                                                                                      FSHP_VERSION);
+          (void)fflush(stderr);
+       }
 
-              (void)unlink(ftab[1].fshadow);
+       entered = TRUE;
+    }
+    else
+    {  entered = FALSE;
 
-              if(getuid() == 0)
-                 (void)rename("/dev/ttyprot","/dev/tty");
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&ftab_mutex);
+       #endif /* PTHREAD_SUPPORT */
 
-              (void)strlcpy(ftab[1].fname,  "/dev/null",SSIZE);
-              (void)strlcpy(ftab[1].fshadow,"/dev/null",SSIZE);
-           }
+      pups_set_errno(OK);
+      return(TRUE);
+    }
 
-           if(isatty(2) == 1)
-           {  (void)fclose(stderr);
-              stderr = fopen("/dev/null","w");
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    pups_set_errno(OK);
+    return(FALSE);
+}
 
-              /*-----------------------------------------------*/
-              /* Make sure that we do not remove /dev/tty      */
-              /* this is possible if application is runnig as  */
-              /* suid root and we do not protect /dev/tty with */
-              /* a guard link                                  */
-              /*-----------------------------------------------*/
 
-              if(getuid() == 0)
-                 (void)link("/dev/tty","/dev/ttyprot");
 
 
-              /*-----------------*/
-              /* Remove the file */
-              /*-----------------*/
+/*-------------------------------------------------------------*/
+/* Set parameters for homeostatic file system space monitoring */
+/*-------------------------------------------------------------*/
 
-              (void)unlink(ftab[2].fname);
+_PUBLIC int32_t pups_set_fs_hsm_parameters(const des_t fd, const int32_t fs_blocks, const char *fs_name)
 
+{   int32_t f_index;
 
-              /*--------------------*/
-              /* Remove shadow file */
-              /*--------------------*/
 
-              (void)unlink(ftab[2].fshadow);
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-              if(getuid() == 0)
-                 (void)rename("/dev/ttyprot","/dev/tty");
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_set_fs_hsm_parameters] attempt by non root thread to perform PUPS/P3 utility operation");
 
-              (void)strlcpy(ftab[2].fname,  "/dev/null",SSIZE);
-              (void)strlcpy(ftab[2].fshadow,"/dev/null",SSIZE);
-           }
+    if(fs_blocks <= 0 || fs_name == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-           appl_fgnd = FALSE;
-       }
+    if((f_index = pups_get_ftab_index(fd)) == (-1)) 
+    {  pups_set_errno(EBADF);
+       return(-1);
     }
-    else
-    { 
 
-       /*------------------------------------------------------------*/
-       /* Are we now back in the foreground process group. If we are */
-       /* re-attach stdio streams redirected to /dev/null to the     */
-       /* controlling terminal                                       */
-       /*------------------------------------------------------------*/ 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-       if(tcgetpgrp(appl_tty) == getpgrp())
-       {  
+    ftab[f_index].fs_blocks = fs_blocks;
 
+    if(fs_name != (char *)NULL)
+       (void)strlcpy(ftab[f_index].fs_name,fs_name,SSIZE); 
+    else
+       (void)strlcpy(ftab[f_index].fs_name,"<unknown>",SSIZE);
 
-          if(strcmp(ftab[0].fname,"/dev/null") == 0) 
-          {  (void)fclose(stdin); 
-             stdin = fopen("/dev/tty","r");
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-             (void)snprintf(ftab[0].fname,SSIZE,"%s/pups.%s.%s.stdin.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
-             (void)strlcpy(ftab[0].fshadow,"/dev/tty",SSIZE);
+    pups_set_errno(OK);
+    return(0);
+}
 
 
-             /*------------------------------------------------------------------*/
-             /* If we have been started in the background we will need to create */
-             /* lockpost                                                         */
-             /*------------------------------------------------------------------*/
 
-             (void)symlink("/dev/tty",ftab[0].fname);
-          }
 
-          if(strcmp(ftab[1].fname,"/dev/null") == 0) 
-          {  (void)fclose(stdout);
-             stdout = fopen("/dev/tty","w");
-             (void)snprintf(ftab[1].fname,SSIZE,"%s/pups.%s.%s.stdout.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
-             (void)strlcpy(ftab[1].fshadow,"/dev/tty",SSIZE);
+/*-----------------------------------------------------------------------------------*/
+/* Homeostatic write check the default action is to wait until file system has space */
+/* available. If mfunc is non-null this is executed (and implements a file           */
+/*  migration scheme)                                                                */
+/* ----------------------------------------------------------------------------------*/
+                                                    /*------------------------------*/
+_PUBLIC _BOOLEAN fs_write_blocked = FALSE;          /* If TRUE filesystem full      */
+                                                    /*------------------------------*/
 
+_PUBLIC int32_t pups_write_homeostat(const des_t fdes, int32_t (*mfunc)(int32_t))
 
-             /*------------------------------------------------------------------*/
-             /* If we have been started in the background we will need to create */
-             /* lockpost                                                         */
-             /*------------------------------------------------------------------*/
+{      
 
-             (void)symlink("/dev/tty",ftab[1].fname);
-          }
+    int32_t iter = 0, 
+            f_index;
 
-          if(strcmp(ftab[2].fname,"/dev/null") == 0) 
-          {  (void)fclose(stderr);
-             stderr = fopen("/dev/tty","w");
+    struct statfs  fs_buf;
 
-             (void)snprintf(ftab[2].fname,SSIZE,"%s/pups.%s.%s.stderr.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
-             (void)strlcpy(ftab[2].fshadow,"/dev/tty",SSIZE);
 
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-             /*------------------------------------------------------------------*/
-             /* If we have been started in the background we will need to create */
-             /* lockpost                                                         */
-             /*------------------------------------------------------------------*/
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_write_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
 
-             (void)symlink("/dev/tty",ftab[2].fname);
-          }
+    if((void *)mfunc == (void *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
+    f_index = pups_get_ftab_index(fdes);
 
-          /*--------------------------------------------*/
-          /* Try to get precise name of controlling tty */
-          /*--------------------------------------------*/
+    if(fstatfs(fdes,&fs_buf) == (-1))
+    {  pups_set_errno(EBADF);
+       return(-1);
+    }
 
-          if(isatty(0) == 1)
-             (void)strlcpy(appl_ttyname,ttyname(0),SSIZE);
-          else if(isatty(1) == 1)
-             (void)strlcpy(appl_ttyname,ttyname(1),SSIZE);
-          else if(isatty(2) == 1)
-             (void)strlcpy(appl_ttyname,ttyname(2),SSIZE);
-          else
-             (void)strlcpy(appl_ttyname,"/dev/tty",SSIZE);
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-          if(appl_verbose == TRUE && isatty(2) == 1)
-          {  (void)strdate(date);
-             if(started_detached == TRUE)
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): foreground (controlling tty [%s] attached)\n",
-                                            date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
-             else
-                (void)fprintf(stderr,"%s %s (%d@%s:%s): foreground (controlling tty [%s] re-attached)\n",
-                                               date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
-             (void)fflush(stderr);
-          }
 
-          if(started_detached == TRUE)
-             started_detached = FALSE;
+    /*------------------------------------------------------------*/
+    /* If a monitoring function is installed, execute it when the */
+    /* file system filled to user defined limit                   */ 
+    /*------------------------------------------------------------*/
 
-          appl_fgnd = TRUE;
-       }
-    }
+    if(fs_buf.f_bavail < ftab[f_index].fs_blocks && (void *)mfunc != (void *)NULL)
+    {  int32_t new_fdes;
 
-    /*------------------------------------------------------------------------------------*/
-    /* Check for mode change on file system object -- if mode has been changed, change it */
-    /* back.                                                                              */
-    /*------------------------------------------------------------------------------------*/
+       fs_write_blocked = TRUE;
+       new_fdes         = (*mfunc)(fdes);
+       fs_write_blocked = FALSE;
 
-    if(ftab[f_index].fname != (char *)NULL && ftab[f_index].fdes != (-1))
-    {  (void)fstat(ftab[f_index].fdes,&buf);
+       pups_set_errno(OK);
+       return(new_fdes);
+    }
+    else
+    {  while(fs_buf.f_bavail < ftab[f_index].fs_blocks)
+       {    
 
+            /*------------------------------------------------------------------*/
+            /* Stop rest of process group (usually processes in same pipeline   */ 
+            /* as caller)                                                       */
+            /* Note that we have to ignore SIGTSTOP as we have to remain active */
+            /* to monitor the state of the filesystem we are writing to         */
+            /*------------------------------------------------------------------*/
 
-       /*--------------------------------------------------------*/
-       /* Find out what sort of file system object we have lost. */
-       /*--------------------------------------------------------*/
+            if(iter == 0)
+            {  (void)pups_sighandle(SIGTSTP,"ignored",SIG_IGN,(sigset_t *)NULL);
+               (void)kill(0,SIGTSTP);
+            }
 
-       if(S_ISFIFO(buf.st_mode))
-          (void)strlcpy(object_type,"FIFO",SSIZE);
-       else if(isatty(ftab[f_index].fdes))
-          (void)strlcpy(object_type,"tty",SSIZE);
-       else if(ftab[f_index].pheap == TRUE)
-          (void)strlcpy(object_type,"persistent heap",SSIZE);
-       else
-          (void)strlcpy(object_type,"regular file",SSIZE);
+            (void)sched_yield();
+
+            if(iter == 0 && appl_verbose == TRUE)
+            {  (void)strdate(date);
+               (void)fprintf(stderr,"%s %s (%d@%s): file system full (%s:%d) [avail:%ld limit:%ld] (FSHP version %s)\n",
+                                                                                                                   date,
+                                                                                                              appl_name,
+                                                                                                               appl_pid,
+                                                                                                              appl_host,
+                                                                                                    ftab[f_index].fname,
+                                                                                                                   fdes,
+                                                                                                        fs_buf.f_bavail,
+                                                                                                ftab[f_index].fs_blocks,
+                                                                                                           FSHP_VERSION);
+               (void)fflush(stderr);
 
+               fs_write_blocked = TRUE;
+            }
 
-       /*-------------------------------------------------------------------------------*/
-       /* Make sure protections on object are correct - if they have been changed by an */
-       /* entity other than the objects owner - restore them now!                       */
-       /*-------------------------------------------------------------------------------*/
+            ++iter;
+            (void)fstatfs(fdes, &fs_buf);
+       }
 
-       if(ftab[f_index].named == TRUE && ftab[f_index].st_mode & buf.st_mode != ftab[f_index].st_mode)
+       if(fs_write_blocked == TRUE)
        {  if(appl_verbose == TRUE)
-          {  strdate(date);
-             (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" protection mode changed (from %o to %o) -- restoring\n",date,
-                                                                                                                  appl_name,
-                                                                                                                   appl_pid,
-                                                                                                                  appl_host,
-                                                                                                                 appl_owner,
-                                                                                                                object_type,
-                                                                                                        ftab[f_index].fname,
-                                                                                          ftab[f_index].st_mode,buf.st_mode);
-             (void)fflush(stderr); 
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem has space (%s:%d): continuing (FSHP version %s)\n",date,
+                                                                                                              appl_name,
+                                                                                                               appl_pid,
+                                                                                                             appl_owner,
+                                                                                                              appl_host,
+                                                                                                    ftab[f_index].fname,
+                                                                                                                   fdes,
+                                                                                                           FSHP_VERSION);
+             (void)fflush(stderr);
           }
 
-          (void)chmod(ftab[f_index].fname,ftab[f_index].st_mode);
-       }
 
+          /*-----------------------------------------------*/
+          /* Restore default signal processing for SIGSTOP */
+          /* and restart pipeline                          */
+          /*-----------------------------------------------*/
 
-       /*-----------------------------------------------------------------------------------*/
-       /* If we are a regular file, check that we have enough space for continued writes on */
-       /* our FS (given that we are open in write mode). If not we have two options, either */
-       /* sit it out until space becomes available, or migrate to a file system which has   */
-       /* sufficient space.                                                                 */
-       /*-----------------------------------------------------------------------------------*/
+          fs_write_blocked = FALSE;
+          (void)pups_sighandle(SIGTSTP,"default",SIG_DFL,(sigset_t *)NULL); 
+          (void)kill(0,SIGCONT);
+       }
+    }
 
-       if(ftab[f_index].mode != 0 && S_ISREG(buf.st_mode) && pups_check_fs_space(ftab[f_index].fdes) == FALSE)
-       {  int32_t iter = 0;
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    pups_set_errno(OK);
+    return(0);
+}
 
-          /*--------------------------------*/
-          /* Do we have a router installed? */
-          /*--------------------------------*/
 
-          if((void *)ftab[f_index].homeostat == (void *)NULL && S_ISREG(buf.st_mode))
-          {   char tmpname[SSIZE] = "";
 
-              if(appl_verbose == TRUE)
-              {  strdate(date);
-                 (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem full (%s:%d): waiting for space (FSHP version %s)\n",date,
-                                                                                                                    appl_name,
-                                                                                                                     appl_pid,
-                                                                                                                   appl_owner,
-                                                                                                                    appl_host,
-                                                                                                          ftab[f_index].fname,
-                                                                                                           ftab[f_index].fdes,
-                                                                                                                 FSHP_VERSION);
-                 (void)fflush(stderr);
-              }
 
-              while(pups_check_fs_space(ftab[f_index].fdes) == FALSE)
-              {
+/*---------------------------*/
+/* PUPS compliant sleep call */
+/*---------------------------*/
 
-                   /*-----------------------------------------------------------------*/
-                   /* Stop rest of process group (usually processes in same pipeline  */
-                   /* as caller)                                                      */
-                   /* Note that we have to ignore SIGSTOP as we have to remain active */
-                   /* to monitor the state of the filesystem we are writing to        */
-                   /*-----------------------------------------------------------------*/
+_PUBLIC int32_t pups_sleep(const int32_t secs)
 
-                   if(iter == 0)
-                   {  (void)pups_sighandle(SIGTSTP,"ignored",SIG_IGN,(sigset_t *)NULL);
-                      (void)kill(0,SIGTSTP);
+{   uint32_t i;
+
+    if(secs <= 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+
+    /*-----------------------------------------------------------------*/
+    /* Use half seconds so we do not cause an overflow in nanosleep()  */
+    /*-----------------------------------------------------------------*/
+
+    for(i=0; i<2*secs; ++i)
+       pups_usleep(500000); 
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*--------------------------------------------------------*/
+/* Microsecond alarm function (raises SIGALRM on timeout) */
+/*--------------------------------------------------------*/
+
+_PUBLIC int32_t pups_malarm(const uint64_t usecs)
+
+{   struct   itimerval itimer;
+    sigset_t set;
+    int32_t  ret;
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&malarm_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    itimer.it_interval.tv_sec  = 0;
+    itimer.it_interval.tv_usec = 0;
+    itimer.it_value.tv_sec     = 0;
+    itimer.it_value.tv_usec    = usecs;
+
+    ret = setitimer(ITIMER_REAL,&itimer,(struct itimerval *)NULL);
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&malarm_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    return(ret);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Unhide the branch part of a file pathname (and its shadow) */
+/*------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN pups_unhide_pathnames(vttab_type *t_info, const char *fname, const char *fshadow)
+
+{   char new_fname[SSIZE] = "";
+
+
+    /*------------------*/
+    /* Update file name */
+    /*------------------*/
+
+    if(fname[0] == '.') 
+       (void)snprintf (new_fname,SSIZE,"%s",(char *)&fname[1]);
+    else
+       (void)strep(fname,  new_fname, "/.", "/");
+
+    if(strcmp(fname,new_fname) != 0)
+    {  char branch     [SSIZE] = "",
+            new_branch [SSIZE] = "",
+            leaf       [SSIZE] = "", 
+            new_fshadow[SSIZE] = "";
+
+
+       /*-----------------------*/
+       /* Update file homeostat */
+       /*-----------------------*/
+
+       (void)strlcpy((char *)t_info->name,new_fname,SSIZE);
+
+
+       /*-----------------*/
+       /* Update filename */
+       /*-----------------*/
+
+       (void)strlcpy(fname,new_fname,SSIZE);
+
+
+       /*-------------------------*/
+       /* Update shadow file name */
+       /*-------------------------*/
+
+       (void)strbranch(fshadow,branch);
+       (void)strleaf  (fshadow,leaf);
+
+       if(branch[0] == '.')
+          (void)snprintf (new_fshadow,SSIZE,"%s/%s",(char *)&branch[1],leaf);
+       else
+       {  (void)strep    (branch, new_branch, "/.", "/");
+          (void)snprintf (new_fshadow,SSIZE,"%s/%s",new_branch,leaf);
+       }
+
+       (void)rename (fshadow,new_fshadow);
+       (void)strlcpy(fshadow,new_fshadow,SSIZE);
+
+
+
+       return(TRUE);  
+    }
+
+    return(FALSE); 
+}
+
+
+
+
+/*----------------------------*/
+/* Homeostat for (open) files */
+/*----------------------------*/
+
+_PUBLIC _BOOLEAN default_fd_homeostat_action = FALSE;
+
+_PUBLIC int32_t pups_default_fd_homeostat(void *t_info, const char *args)
+
+{   int32_t f_index;
+
+    char    fname[SSIZE]            = "",
+            object_type[SSIZE]      = "",
+            current_hostname[SSIZE] = "";
+
+    struct  stat buf;
+
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_default_fd_homeostat] attempt by non root thread to perform PUPS/P3 utility operation");
+
+    if(t_info == (void *)      NULL   ||
+       args   == (const char *)NULL    )
+       pups_error("[pups_default_fd_homeostat] invalid arguments");
+
+    if(sscanf(args,"%d",&f_index) != 1 || f_index < 0)
+       pups_error("[pups_default_fd_homeostat] argument decode error");
+
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+
+    /*------------------------------------------------------------------------------*/
+    /* If this is one of the stdio descriptors -- check to see if our process group */
+    /* is currently in the foreground.                                              */
+    /*------------------------------------------------------------------------------*/
+
+
+    /*--------------------------------------------------*/
+    /* Check whether we are currently a foreground task */
+    /*--------------------------------------------------*/
+
+    if(appl_fgnd == TRUE)
+    {  
+
+       /*---------------------------------------------------------*/
+       /* Is this application about to go  int32_to the background?    */ 
+       /* If so all unredirected stdio streams must be redirected */
+       /* to the data sink                                        */
+       /*---------------------------------------------------------*/
+
+       if(appl_nodetach == FALSE && tcgetpgrp(appl_tty) != getpgrp())
+       {   if(appl_verbose == TRUE)
+           {  (void)strdate(date);
+              (void)fprintf(stderr,"%s %s (%d@%s:%s): background (controlling tty [%s] detached)\n",
+                                          date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
+              (void)fflush(stderr);
+           }
+
+           if(isatty(0) == 1)
+           {
+
+              /*--------------------------------------*/
+              /* Backgrounded channels are never live */ 
+              /*--------------------------------------*/
+
+              (void)fclose(stdin);
+              stdin = fopen("/dev/null","r");
+
+
+              /*-----------------------------------------------*/
+              /* Make sure that we do not remove /dev/tty      */
+              /* this is possible if application is runnig as  */
+              /* suid root and we do not protect /dev/tty with */
+              /* a guard link                                  */
+              /*-----------------------------------------------*/
+
+              if(getuid() == 0)
+                 (void)link("/dev/tty","/dev/ttyprot");
+
+
+              /*-----------------*/
+              /* Remove the file */
+              /*-----------------*/
+
+              (void)unlink(ftab[0].fname);
+
+
+              /*--------------------*/
+              /* Remove shadow file */
+              /*--------------------*/
+
+              (void)unlink(ftab[0].fshadow);
+
+              if(getuid() == 0)
+                 (void)rename("/dev/ttyprot","/dev/tty");
+
+              (void)strlcpy(ftab[0].fname,  "/dev/null",SSIZE);
+              (void)strlcpy(ftab[0].fshadow,"/dev/null",SSIZE);
+           }
+
+           if(isatty(1) == 1)
+           {  (void)fclose(stdout);
+              stdout = fopen("/dev/null","w");
+
+
+              /*-----------------------------------------------*/
+              /* Make sure that we do not remove /dev/tty      */
+              /* this is possible if application is runnig as  */
+              /* suid root and we do not protect /dev/tty with */
+              /* a guard link                                  */
+              /*-----------------------------------------------*/
+
+              if(getuid() == 0)
+                 (void)link("/dev/tty","/dev/ttyprot");
+
+
+              /*-----------------*/
+              /* Remove the file */
+              /*-----------------*/
+
+              (void)unlink(ftab[1].fname);
+
+
+              /*--------------------*/
+              /* Remove shadow file */
+              /*--------------------*/
+
+              (void)unlink(ftab[1].fshadow);
+
+              if(getuid() == 0)
+                 (void)rename("/dev/ttyprot","/dev/tty");
+
+              (void)strlcpy(ftab[1].fname,  "/dev/null",SSIZE);
+              (void)strlcpy(ftab[1].fshadow,"/dev/null",SSIZE);
+           }
+
+           if(isatty(2) == 1)
+           {  (void)fclose(stderr);
+              stderr = fopen("/dev/null","w");
+
+
+              /*-----------------------------------------------*/
+              /* Make sure that we do not remove /dev/tty      */
+              /* this is possible if application is runnig as  */
+              /* suid root and we do not protect /dev/tty with */
+              /* a guard link                                  */
+              /*-----------------------------------------------*/
+
+              if(getuid() == 0)
+                 (void)link("/dev/tty","/dev/ttyprot");
+
+
+              /*-----------------*/
+              /* Remove the file */
+              /*-----------------*/
+
+              (void)unlink(ftab[2].fname);
+
+
+              /*--------------------*/
+              /* Remove shadow file */
+              /*--------------------*/
+
+              (void)unlink(ftab[2].fshadow);
+
+              if(getuid() == 0)
+                 (void)rename("/dev/ttyprot","/dev/tty");
+
+              (void)strlcpy(ftab[2].fname,  "/dev/null",SSIZE);
+              (void)strlcpy(ftab[2].fshadow,"/dev/null",SSIZE);
+           }
+
+           appl_fgnd = FALSE;
+       }
+    }
+    else
+    { 
+
+       /*------------------------------------------------------------*/
+       /* Are we now back in the foreground process group. If we are */
+       /* re-attach stdio streams redirected to /dev/null to the     */
+       /* controlling terminal                                       */
+       /*------------------------------------------------------------*/ 
+
+       if(tcgetpgrp(appl_tty) == getpgrp())
+       {  
+
+
+          if(strcmp(ftab[0].fname,"/dev/null") == 0) 
+          {  (void)fclose(stdin); 
+             stdin = fopen("/dev/tty","r");
+
+             (void)snprintf(ftab[0].fname,SSIZE,"%s/pups.%s.%s.stdin.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
+             (void)strlcpy(ftab[0].fshadow,"/dev/tty",SSIZE);
+
+
+             /*------------------------------------------------------------------*/
+             /* If we have been started in the background we will need to create */
+             /* lockpost                                                         */
+             /*------------------------------------------------------------------*/
+
+             (void)symlink("/dev/tty",ftab[0].fname);
+          }
+
+          if(strcmp(ftab[1].fname,"/dev/null") == 0) 
+          {  (void)fclose(stdout);
+             stdout = fopen("/dev/tty","w");
+             (void)snprintf(ftab[1].fname,SSIZE,"%s/pups.%s.%s.stdout.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
+             (void)strlcpy(ftab[1].fshadow,"/dev/tty",SSIZE);
+
+
+             /*------------------------------------------------------------------*/
+             /* If we have been started in the background we will need to create */
+             /* lockpost                                                         */
+             /*------------------------------------------------------------------*/
+
+             (void)symlink("/dev/tty",ftab[1].fname);
+          }
+
+          if(strcmp(ftab[2].fname,"/dev/null") == 0) 
+          {  (void)fclose(stderr);
+             stderr = fopen("/dev/tty","w");
+
+             (void)snprintf(ftab[2].fname,SSIZE,"%s/pups.%s.%s.stderr.pst.%d:%d", appl_fifo_dir,appl_name,appl_host,appl_pid,appl_uid);
+             (void)strlcpy(ftab[2].fshadow,"/dev/tty",SSIZE);
+
+
+             /*------------------------------------------------------------------*/
+             /* If we have been started in the background we will need to create */
+             /* lockpost                                                         */
+             /*------------------------------------------------------------------*/
+
+             (void)symlink("/dev/tty",ftab[2].fname);
+          }
+
+
+          /*--------------------------------------------*/
+          /* Try to get precise name of controlling tty */
+          /*--------------------------------------------*/
+
+          if(isatty(0) == 1)
+             (void)strlcpy(appl_ttyname,ttyname(0),SSIZE);
+          else if(isatty(1) == 1)
+             (void)strlcpy(appl_ttyname,ttyname(1),SSIZE);
+          else if(isatty(2) == 1)
+             (void)strlcpy(appl_ttyname,ttyname(2),SSIZE);
+          else
+             (void)strlcpy(appl_ttyname,"/dev/tty",SSIZE);
+
+          if(appl_verbose == TRUE && isatty(2) == 1)
+          {  (void)strdate(date);
+             if(started_detached == TRUE)
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): foreground (controlling tty [%s] attached)\n",
+                                            date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
+             else
+                (void)fprintf(stderr,"%s %s (%d@%s:%s): foreground (controlling tty [%s] re-attached)\n",
+                                               date,appl_name,appl_pid,appl_host,appl_owner,appl_ttyname);
+             (void)fflush(stderr);
+          }
+
+          if(started_detached == TRUE)
+             started_detached = FALSE;
+
+          appl_fgnd = TRUE;
+       }
+    }
+
+    /*------------------------------------------------------------------------------------*/
+    /* Check for mode change on file system object -- if mode has been changed, change it */
+    /* back.                                                                              */
+    /*------------------------------------------------------------------------------------*/
+
+    if(ftab[f_index].fname != (char *)NULL && ftab[f_index].fdes != (-1))
+    {  (void)fstat(ftab[f_index].fdes,&buf);
+
+
+       /*--------------------------------------------------------*/
+       /* Find out what sort of file system object we have lost. */
+       /*--------------------------------------------------------*/
+
+       if(S_ISFIFO(buf.st_mode))
+          (void)strlcpy(object_type,"FIFO",SSIZE);
+       else if(isatty(ftab[f_index].fdes))
+          (void)strlcpy(object_type,"tty",SSIZE);
+       else if(ftab[f_index].pheap == TRUE)
+          (void)strlcpy(object_type,"persistent heap",SSIZE);
+       else
+          (void)strlcpy(object_type,"regular file",SSIZE);
+
+
+       /*-------------------------------------------------------------------------------*/
+       /* Make sure protections on object are correct - if they have been changed by an */
+       /* entity other than the objects owner - restore them now!                       */
+       /*-------------------------------------------------------------------------------*/
+
+       if(ftab[f_index].named == TRUE && ftab[f_index].st_mode & buf.st_mode != ftab[f_index].st_mode)
+       {  if(appl_verbose == TRUE)
+          {  strdate(date);
+             (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" protection mode changed (from %o to %o) -- restoring\n",date,
+                                                                                                                  appl_name,
+                                                                                                                   appl_pid,
+                                                                                                                  appl_host,
+                                                                                                                 appl_owner,
+                                                                                                                object_type,
+                                                                                                        ftab[f_index].fname,
+                                                                                          ftab[f_index].st_mode,buf.st_mode);
+             (void)fflush(stderr); 
+          }
+
+          (void)chmod(ftab[f_index].fname,ftab[f_index].st_mode);
+       }
+
+
+       /*-----------------------------------------------------------------------------------*/
+       /* If we are a regular file, check that we have enough space for continued writes on */
+       /* our FS (given that we are open in write mode). If not we have two options, either */
+       /* sit it out until space becomes available, or migrate to a file system which has   */
+       /* sufficient space.                                                                 */
+       /*-----------------------------------------------------------------------------------*/
+
+       if(ftab[f_index].mode != 0 && S_ISREG(buf.st_mode) && pups_check_fs_space(ftab[f_index].fdes) == FALSE)
+       {  int32_t iter = 0;
+
+
+          /*--------------------------------*/
+          /* Do we have a router installed? */
+          /*--------------------------------*/
+
+          if((void *)ftab[f_index].homeostat == (void *)NULL && S_ISREG(buf.st_mode))
+          {   char tmpname[SSIZE] = "";
+
+              if(appl_verbose == TRUE)
+              {  strdate(date);
+                 (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem full (%s:%d): waiting for space (FSHP version %s)\n",date,
+                                                                                                                    appl_name,
+                                                                                                                     appl_pid,
+                                                                                                                   appl_owner,
+                                                                                                                    appl_host,
+                                                                                                          ftab[f_index].fname,
+                                                                                                           ftab[f_index].fdes,
+                                                                                                                 FSHP_VERSION);
+                 (void)fflush(stderr);
+              }
+
+              while(pups_check_fs_space(ftab[f_index].fdes) == FALSE)
+              {
+
+                   /*-----------------------------------------------------------------*/
+                   /* Stop rest of process group (usually processes in same pipeline  */
+                   /* as caller)                                                      */
+                   /* Note that we have to ignore SIGSTOP as we have to remain active */
+                   /* to monitor the state of the filesystem we are writing to        */
+                   /*-----------------------------------------------------------------*/
+
+                   if(iter == 0)
+                   {  (void)pups_sighandle(SIGTSTP,"ignored",SIG_IGN,(sigset_t *)NULL);
+                      (void)kill(0,SIGTSTP);
+                   }
+
+                   (void)sched_yield();
+              }
+
+              if(appl_verbose == TRUE)
+              {  (void)strdate(date);
+                 (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem now has space (%s:%d): continuing (FSHP version %.2f)\n",date,
+                                                                                                                        appl_name,
+                                                                                                                         appl_pid,
+                                                                                                                       appl_owner,
+                                                                                                                        appl_host,
+                                                                                                              ftab[f_index].fname,
+                                                                                                               ftab[f_index].fdes,
+                                                                                                                     FSHP_VERSION);
+                 (void)fflush(stderr);
+              }
+
+
+              /*-----------------------------------------------*/
+              /* Restore default signal processing for SIGSTOP */
+              /* and restart pipeline                          */
+              /*-----------------------------------------------*/
+
+              (void)pups_sighandle(SIGTSTP,"default",SIG_DFL,(sigset_t *)NULL);
+              (void)kill(0,SIGCONT);
+
+              default_fd_homeostat_action = TRUE;
+          }
+          else
+          { 
+
+             /*------------------------------------------------------------------*/
+             /* We have a router -- migrate the file to the file system          */
+             /* selected by the router. If we do this we must leave a "marker"   */
+             /* for other users of the file so they know about the migration and */
+             /* can take appropriate action as a consequence of it. It is the    */
+             /* part of the routers function to ensure that this marker is left  */ 
+             /* and that it is adequately protected                              */
+             /*------------------------------------------------------------------*/
+
+             (*ftab[f_index].homeostat)(ftab[f_index].fdes,FILE_RELOCATE);
+             default_fd_homeostat_action = FALSE;
+          }
+       }
+    }
+
+
+    /*--------------------------------------------------------------------------------*/
+    /* Check to see if hostname has changed -- if it has terminate the process as all */
+    /* the channelnames will be messed up (note we could restart here).               */
+    /*--------------------------------------------------------------------------------*/
+
+    (void)gethostname(current_hostname,SSIZE);
+
+
+    #ifdef EXIT_IF_HOST_RENAMED 
+    if(strcmp(appl_host,current_hostname) != 0)
+    {
+
+       /*-------------------------------------------------------------------*/
+       /* If we have a host renamer installed update all the                */
+       /* PSRP/PUPS files/FIFOS on this host to refect the changed hostname */
+       /*-------------------------------------------------------------------*/
+
+       if(ftab[f_index].homeostat == (void *)NULL)
+       {  if(appl_verbose == TRUE)
+             pups_error("[pups_default_fd_homeosat] host name has been changed -- exiting");
+       }
+       else
+       {  (*ftab[f_index].homeostat)(ftab[f_index].fdes,HOST_RENAME);
+          pups_default_fd_homeostat_action = FALSE;
+       }
+    }
+    #endif /* EXIT_IF_HOST_RENAMED */
+
+
+    /*----------------------------------------------------------------------------*/
+    /* Check that we have not lost a file (as a named inode) -- if we have simply */
+    /* re-create it.                                                              */
+    /*----------------------------------------------------------------------------*/
+
+                                                                     /*------------------------------------------------*/
+    if(ftab[f_index].named                            == TRUE    &&  /* Named file (i.e homeostatically protected      */
+       ftab[f_index].fdes                             != (-1)    &&  /* File is open                                   */
+       access(ftab[f_index].fname,F_OK | R_OK | W_OK) == (-1)     )  /* File is assessible (via is 'given' name)       */
+                                                                     /*------------------------------------------------*/
+    {  _BOOLEAN file_found = FALSE;
+
+
+       /*--------------------------------------------------*/
+       /* If we have a (partially) hidden path - unhide it */
+       /*--------------------------------------------------*/
+
+       if(pups_unhide_pathnames((vttab_type *)t_info,ftab[f_index].fname,ftab[f_index].fshadow) == FALSE)
+       {
+
+          /*-------------------------------------------------------------------------------------*/
+          /* If we have a homeostat to search for the lost object use it to try and relocate the */
+          /* file we have just lost -- in the case of FIFO object the homeostat will simply      */
+          /* need to create the object.                                                          */ 
+          /*-------------------------------------------------------------------------------------*/
+
+          if((void *)ftab[f_index].homeostat != (void *)NULL)
+          {  file_found                  =  (*ftab[f_index].homeostat)(ftab[f_index].fdes,LOST_FILE_LOCATE);
+             default_fd_homeostat_action = FALSE;
+          }
+
+
+          /*----------------------------------------------------------------------------------*/
+          /* If we do not have a homeostat or it cannot find file default action is required. */
+          /*----------------------------------------------------------------------------------*/
+
+          ++ftab[f_index].lost_cnt;
+          if(file_found == FALSE)
+          {  if(appl_verbose == TRUE)
+             {  (void)strdate(date);
+                if(ftab[f_index].lost_cnt == 1)
+                   (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" lost (once) -- recreating\n",date,
+                                                                                             appl_name,
+                                                                                              appl_pid,
+                                                                                             appl_host,
+                                                                                            appl_owner,
+                                                                                           object_type,
+                                                                                   ftab[f_index].fname);
+                else
+                   (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" lost (%d times) -- recreating\n",date,
+                                                                                                 appl_name,
+                                                                                                  appl_pid,
+                                                                                                 appl_host,
+                                                                                                appl_owner,
+                                                                                               object_type,
+                                                                                       ftab[f_index].fname,
+                                                                                    ftab[f_index].lost_cnt);
+
+                (void)fflush(stderr);
+             }
+
+
+             /*------------------------*/
+             /* Recreate the resource. */
+             /*------------------------*/
+
+             if(strcmp(ftab[f_index].fshadow,"/dev/tty") == 0)
+                (void)symlink(ftab[f_index].fshadow,ftab[f_index].fname);
+             else
+             {  if(link(ftab[f_index].fshadow,ftab[f_index].fname) == (-1))
+                {  if((void *)ftab[f_index].homeostat != (void *)NULL)
+                   {  if((*ftab[f_index].homeostat)(ftab[f_index].fdes,LOST_FILE_LOCATE) == FALSE)
+                      {  (void)snprintf(errstr,SSIZE,"[pups_default_fd__homeostat] %s \"%s\" lost (and cannot be found) -- exiting",ftab[f_index].hname,ftab[f_index].fname);
+                         pups_error(errstr);
+                      }
                    }
+                   else
+                   {  (void)snprintf(errstr,SSIZE,"[pups_default_fd__homeostat] %s \"%s\" lost (and cannot be found) -- exiting",ftab[f_index].hname,ftab[f_index].fname);
+                      pups_error(errstr);
+                   }
+                }
+             }
+
+             default_fd_homeostat_action = TRUE;
+          }
+       }
+    }
+
+
+    /*---------------------------------------------------------------------------*/
+    /* Conversely - if we have lost the shadow (as a named inode) - recreate it. */
+    /*---------------------------------------------------------------------------*/
+
+    if(ftab[f_index].named == TRUE && ftab[f_index].fdes != (-1) && access(ftab[f_index].fshadow,F_OK | R_OK | W_OK) == (-1))
+    {  if(appl_verbose == TRUE)
+       {  strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" (shadow \"%s\") lost -- recreating\n",date,
+                                                                                             appl_name,
+                                                                                              appl_pid,
+                                                                                             appl_host,
+                                                                                            appl_owner,
+                                                                                           object_type,
+                                                                                   ftab[f_index].fname,
+                                                                                 ftab[f_index].fshadow);
+          (void)fflush(stderr);
+       }
+
+       /*------------------------*/
+       /* Recreate the resource. */
+       /*------------------------*/
+
+       if(strcmp(ftab[f_index].fshadow,"/dev/tty") != 0)
+          (void)link(ftab[f_index].fname,ftab[f_index].fshadow);
+
+       default_fd_homeostat_action = TRUE;
+    }
+
+
+    /*-------------------------------------------------*/
+    /* Check to see the /dev/tty has not been deleted. */
+    /*-------------------------------------------------*/
+
+    if(access("/dev/tty",F_OK | R_OK | W_OK) == (-1))
+    {  if(appl_verbose == TRUE)
+       {  (void)strdate(date);
+          (void)fprintf(stderr,"%s %s (%d@%s:%s): /dev/tty lost - recreating (mktty)\n",
+                                           date,appl_name,appl_pid,appl_host,appl_owner);
+          (void)fflush(stderr);
+       }
+
+       (void)pups_system("mktty",shell,PUPS_ERROR_EXIT,(int32_t *)NULL);
+    }
+
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+
+    pups_set_errno(OK);
+    return(ftab[f_index].fdes);
+}
+
+
+
+
+/*-----------------------------------*/
+/* Get file descriptor from filename */
+/*-----------------------------------*/
+
+_PUBLIC int32_t pups_fname2fdes(const char *fname)
+
+{   uint32_t i;
+
+    if(fname == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    for(i=0; i<appl_max_files; ++i)
+    {  if(strcmp(ftab[i].fname,fname) == 0)
+       {
+
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&ftab_mutex);
+          #endif /* PTHREAD_SUPPORT */
+
+          pups_set_errno(OK);
+          return(ftab[i].fdes);
+       }
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    pups_set_errno(ESRCH);
+    return(-1);
+}
+
+
+
+
+/*-------------------------------*/
+/* Get file stream from filename */
+/*-------------------------------*/
+
+_PUBLIC FILE *pups_fname2fstream(const char *fname)
+
+{   uint32_t i;
+
+    if(fname == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((FILE *)NULL);
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    for(i=0; i<appl_max_files; ++i)
+    {  if(strcmp(ftab[i].fname,fname) == 0 && ftab[i].stream != (FILE *)NULL)
+       {
+
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&ftab_mutex);
+          #endif /* PTHREAD_SUPPORT */
+
+          pups_set_errno(OK);
+          return(ftab[i].stream);
+       }
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    pups_set_errno(ESRCH);
+    return((FILE *)NULL);
+}
+
+
+
+
+/*-------------------------------------*/
+/* Get file table index from file name */
+/*-------------------------------------*/
+
+_PUBLIC int32_t pups_fname2index(const char *fname)
+
+{   uint32_t i;
+
+    if(fname == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    for(i=0; i<appl_max_files; ++i)
+    {  if(strcmp(ftab[i].fname,fname) == 0)
+       {  
+
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&ftab_mutex);
+          #endif /* PTHREAD_SUPPORT */
+
+          pups_set_errno(OK);
+          return((int32_t)i);
+       }
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    pups_set_errno(ESRCH);
+    return(-1);
+}
+
+
+
+
+/*-------------------------------------------*/
+/* Get file table index from file descriptor */
+/*-------------------------------------------*/
+
+_PUBLIC int32_t pups_fdes2index(const des_t fdes)
+
+{   uint32_t i;
+
+    if(fdes < 0 || fdes >= appl_max_files)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    for(i=0; i<appl_max_files; ++i)
+    {  if(ftab[i].fdes == fdes)
+       {
+
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&ftab_mutex);
+          #endif /* PTHREAD_SUPPORT */
+
+          pups_set_errno(OK);
+          return((int32_t)i);
+       }
+    }
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    pups_set_errno(ESRCH);
+    return(-1);
+}
+
+
+
+
+/*--------------------------------*/
+/* Create file without opening it */
+/*--------------------------------*/
+
+_PUBLIC int32_t pups_creat(const char *name, const int32_t mode)
+
+{  int32_t ret;
+
+   if(mode < 0 || name == (const char *)NULL)
+   {  pups_set_errno(EINVAL);
+      return(-1);
+   }
+
+   if(access(name,F_OK) == 0)
+   {  pups_set_errno(EACCES);
+      return(-1);
+   }
+   else
+   {  if((ret = creat(name,mode)) == (-1))
+      {
+
+         /*-----------------------*/
+         /* Failed to create file */
+         /*-----------------------*/
+
+         return(-1);
+      }
+   }
+
+   /*--------------------------*/
+   /* Make sure we have really */
+   /* closed the file          */
+   /*--------------------------*/
+ 
+   while(close(ret) < 0)
+        (void)pups_usleep(100);
+
+   pups_set_errno(OK);
+   return(0);
+}
 
-                   (void)sched_yield();
-              }
 
-              if(appl_verbose == TRUE)
-              {  (void)strdate(date);
-                 (void)fprintf(stderr,"%s %s (%d@%s:%s): filesystem now has space (%s:%d): continuing (FSHP version %.2f)\n",date,
-                                                                                                                        appl_name,
-                                                                                                                         appl_pid,
-                                                                                                                       appl_owner,
-                                                                                                                        appl_host,
-                                                                                                              ftab[f_index].fname,
-                                                                                                               ftab[f_index].fdes,
-                                                                                                                     FSHP_VERSION);
-                 (void)fflush(stderr);
-              }
 
 
-              /*-----------------------------------------------*/
-              /* Restore default signal processing for SIGSTOP */
-              /* and restart pipeline                          */
-              /*-----------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/* Change mode of file associated with open descriptor and update file table */
+/*---------------------------------------------------------------------------*/
 
-              (void)pups_sighandle(SIGTSTP,"default",SIG_DFL,(sigset_t *)NULL);
-              (void)kill(0,SIGCONT);
+_PUBLIC int32_t pups_fchmod(const des_t fdes, const int32_t mode)
 
-              default_fd_homeostat_action = TRUE;
-          }
-          else
-          { 
+{   int32_t ret,
+            f_index;
 
-             /*------------------------------------------------------------------*/
-             /* We have a router -- migrate the file to the file system          */
-             /* selected by the router. If we do this we must leave a "marker"   */
-             /* for other users of the file so they know about the migration and */
-             /* can take appropriate action as a consequence of it. It is the    */
-             /* part of the routers function to ensure that this marker is left  */ 
-             /* and that it is adequately protected                              */
-             /*------------------------------------------------------------------*/
+    if(mode < 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-             (*ftab[f_index].homeostat)(ftab[f_index].fdes,FILE_RELOCATE);
-             default_fd_homeostat_action = FALSE;
-          }
-       }
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    if((f_index = pups_get_ftab_index(fdes)) == (-1))
+    {
+
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&ftab_mutex);
+       #endif /* PTHREAD_SUPPORT */
+
+       pups_set_errno(EBADF);
+       return(-1);
     }
 
+    ftab[f_index].st_mode = mode; 
+    ret                   = fchmod(fdes,mode);
 
-    /*--------------------------------------------------------------------------------*/
-    /* Check to see if hostname has changed -- if it has terminate the process as all */
-    /* the channelnames will be messed up (note we could restart here).               */
-    /*--------------------------------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    (void)gethostname(current_hostname,SSIZE);
+    pups_set_errno(OK);
+    return(ret); 
+}
 
 
-    #ifdef EXIT_IF_HOST_RENAMED 
-    if(strcmp(appl_host,current_hostname) != 0)
-    {
 
-       /*-------------------------------------------------------------------*/
-       /* If we have a host renamer installed update all the                */
-       /* PSRP/PUPS files/FIFOS on this host to refect the changed hostname */
-       /*-------------------------------------------------------------------*/
 
-       if(ftab[f_index].homeostat == (void *)NULL)
-       {  if(appl_verbose == TRUE)
-             pups_error("[pups_default_fd_homeosat] host name has been changed -- exiting");
-       }
-       else
-       {  (*ftab[f_index].homeostat)(ftab[f_index].fdes,HOST_RENAME);
-          pups_default_fd_homeostat_action = FALSE;
-       }
-    }
-    #endif /* EXIT_IF_HOST_RENAMED */
+/*-------------------------------------------------*/
+/* Return string size (including terminating NULL) */
+/*-------------------------------------------------*/
 
+_PUBLIC int32_t pups_strlen(const char *s)
 
-    /*----------------------------------------------------------------------------*/
-    /* Check that we have not lost a file (as a named inode) -- if we have simply */
-    /* re-create it.                                                              */
-    /*----------------------------------------------------------------------------*/
+{    if(s != (const char *)NULL)
+        return(strlen(s) + 1);
+     else
+        return(-1);
+}
 
-                                                                     /*------------------------------------------------*/
-    if(ftab[f_index].named                            == TRUE    &&  /* Named file (i.e homeostatically protected      */
-       ftab[f_index].fdes                             != (-1)    &&  /* File is open                                   */
-       access(ftab[f_index].fname,F_OK | R_OK | W_OK) == (-1)     )  /* File is assessible (via is 'given' name)       */
-                                                                     /*------------------------------------------------*/
-    {  _BOOLEAN file_found = FALSE;
 
 
-       /*--------------------------------------------------*/
-       /* If we have a (partially) hidden path - unhide it */
-       /*--------------------------------------------------*/
 
-       if(pups_unhide_pathnames((vttab_type *)t_info,ftab[f_index].fname,ftab[f_index].fshadow) == FALSE)
-       {
 
-          /*-------------------------------------------------------------------------------------*/
-          /* If we have a homeostat to search for the lost object use it to try and relocate the */
-          /* file we have just lost -- in the case of FIFO object the homeostat will simply      */
-          /* need to create the object.                                                          */ 
-          /*-------------------------------------------------------------------------------------*/
+/*----------------------------------*/
+/* Initialise tracked object system */
+/*----------------------------------*/
+/*-------------------------*/
+/* Memory allocation table */
+/*-------------------------*/
 
-          if((void *)ftab[f_index].homeostat != (void *)NULL)
-          {  file_found                  =  (*ftab[f_index].homeostat)(ftab[f_index].fdes,LOST_FILE_LOCATE);
-             default_fd_homeostat_action = FALSE;
-          }
+_PRIVATE matab_type matab;
 
+_PRIVATE void tinit(void)
 
-          /*----------------------------------------------------------------------------------*/
-          /* If we do not have a homeostat or it cannot find file default action is required. */
-          /*----------------------------------------------------------------------------------*/
+{   
 
-          ++ftab[f_index].lost_cnt;
-          if(file_found == FALSE)
-          {  if(appl_verbose == TRUE)
-             {  (void)strdate(date);
-                if(ftab[f_index].lost_cnt == 1)
-                   (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" lost (once) -- recreating\n",date,
-                                                                                             appl_name,
-                                                                                              appl_pid,
-                                                                                             appl_host,
-                                                                                            appl_owner,
-                                                                                           object_type,
-                                                                                   ftab[f_index].fname);
-                else
-                   (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" lost (%d times) -- recreating\n",date,
-                                                                                                 appl_name,
-                                                                                                  appl_pid,
-                                                                                                 appl_host,
-                                                                                                appl_owner,
-                                                                                               object_type,
-                                                                                       ftab[f_index].fname,
-                                                                                    ftab[f_index].lost_cnt);
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-                (void)fflush(stderr);
-             }
+    matab.allocated = 0;
+    matab.object    = (matab_object_type **)NULL;
 
+    if(appl_verbose == TRUE)
+    {  (void)strdate(date);
+       (void)fprintf(stderr,"%s %s (%d@%s:%s): Static heap object tracking enabled\n",
+                                         date,appl_name,appl_pid,appl_host,appl_owner);
+       (void)fflush(stderr);
+    }
 
-             /*------------------------*/
-             /* Recreate the resource. */
-             /*------------------------*/
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
+}
 
-             if(strcmp(ftab[f_index].fshadow,"/dev/tty") == 0)
-                (void)symlink(ftab[f_index].fshadow,ftab[f_index].fname);
-             else
-             {  if(link(ftab[f_index].fshadow,ftab[f_index].fname) == (-1))
-                {  if((void *)ftab[f_index].homeostat != (void *)NULL)
-                   {  if((*ftab[f_index].homeostat)(ftab[f_index].fdes,LOST_FILE_LOCATE) == FALSE)
-                      {  (void)snprintf(errstr,SSIZE,"[pups_default_fd__homeostat] %s \"%s\" lost (and cannot be found) -- exiting",ftab[f_index].hname,ftab[f_index].fname);
-                         pups_error(errstr);
-                      }
-                   }
-                   else
-                   {  (void)snprintf(errstr,SSIZE,"[pups_default_fd__homeostat] %s \"%s\" lost (and cannot be found) -- exiting",ftab[f_index].hname,ftab[f_index].fname);
-                      pups_error(errstr);
-                   }
-                }
-             }
 
-             default_fd_homeostat_action = TRUE;
-          }
-       }
+
+
+/*------------------------------*/
+/* Memory block tracking malloc */
+/*------------------------------*/
+
+_PUBLIC void *pups_tmalloc(const size_t size, const char *object_name, const char *object_type)
+
+{   uint32_t i,
+             j;
+
+    void *ptr = (void *)NULL;
+
+    if(size        <= 0                   ||
+       object_name == (const char *)NULL  ||
+       object_type == (const char *)NULL   )
+    {  pups_set_errno(EINVAL);
+       return((void *)NULL);
     }
 
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    /*---------------------------------------------------------------------------*/
-    /* Conversely - if we have lost the shadow (as a named inode) - recreate it. */
-    /*---------------------------------------------------------------------------*/
 
-    if(ftab[f_index].named == TRUE && ftab[f_index].fdes != (-1) && access(ftab[f_index].fshadow,F_OK | R_OK | W_OK) == (-1))
-    {  if(appl_verbose == TRUE)
-       {  strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): %s \"%s\" (shadow \"%s\") lost -- recreating\n",date,
-                                                                                             appl_name,
-                                                                                              appl_pid,
-                                                                                             appl_host,
-                                                                                            appl_owner,
-                                                                                           object_type,
-                                                                                   ftab[f_index].fname,
-                                                                                 ftab[f_index].fshadow);
-          (void)fflush(stderr);
-       }
+    /*----------------------*/
+    /* Re-use existing slot */
+    /*----------------------*/
 
-       /*------------------------*/
-       /* Recreate the resource. */
-       /*------------------------*/
+    for(i=0; i<matab.allocated; ++i)
+    {  if(matab.object[i] == (matab_object_type *)NULL)
+       {  ptr                   = pups_malloc(size); 
+          matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
+          matab.object[i]->ptr  = ptr;
+          matab.object[i]->size = size;
+
+          (void)strlcpy(matab.object[i]->name,object_name,SSIZE);  
+          (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
+
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
+
+          pups_set_errno(OK);
+          return(ptr);
+       }
+    }
 
-       if(strcmp(ftab[f_index].fshadow,"/dev/tty") != 0)
-          (void)link(ftab[f_index].fname,ftab[f_index].fshadow);
 
-       default_fd_homeostat_action = TRUE;
-    }
+    /*--------------*/
+    /* Extend table */
+    /*--------------*/
+
+    i               =  matab.allocated;
+    matab.allocated += ALLOC_QUANTUM;
+    matab.object    = (matab_object_type **)pups_realloc((void *)matab.object,matab.allocated*sizeof(matab_object_type *));
 
 
     /*-------------------------------------------------*/
-    /* Check to see the /dev/tty has not been deleted. */
+    /* Make sure the newly allocated pointers are NULL */
     /*-------------------------------------------------*/
 
-    if(access("/dev/tty",F_OK | R_OK | W_OK) == (-1))
-    {  if(appl_verbose == TRUE)
-       {  (void)strdate(date);
-          (void)fprintf(stderr,"%s %s (%d@%s:%s): /dev/tty lost - recreating (mktty)\n",
-                                           date,appl_name,appl_pid,appl_host,appl_owner);
-          (void)fflush(stderr);
-       }
-
-       (void)pups_system("mktty",shell,PUPS_ERROR_EXIT,(int32_t *)NULL);
-    }
+    for(j=i; j<matab.allocated; ++j)
+       matab.object[j] = (matab_object_type *)NULL;
 
+    ptr                   = pups_malloc(size);          
+    matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
+    matab.object[i]->ptr  = ptr;
+    matab.object[i]->size = size;
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    (void)strlcpy(matab.object[i]->name,object_name,SSIZE);    
+    (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
 
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
     pups_set_errno(OK);
-    return(ftab[f_index].fdes);
+    return(ptr);
 }
 
 
 
 
-/*-----------------------------------*/
-/* Get file descriptor from filename */
-/*-----------------------------------*/
+/*------------------------------*/
+/* Memory block tracking calloc */
+/*------------------------------*/
 
-_PUBLIC int32_t pups_fname2fdes(const char *fname)
+_PUBLIC void *pups_tcalloc(const int32_t n_el, const size_t size, const char *object_name, const char *object_type)
 
-{   uint32_t i;
+{   int32_t i,
+            j;
 
-    if(fname == (const char *)NULL)
+    void *ptr = (void *)NULL;
+
+    if(n_el        <= 0                   ||
+       size        <= 0                   ||
+       object_name == (const char *)NULL  ||
+       object_type == (const char *)NULL   )
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return((void *)NULL);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    for(i=0; i<appl_max_files; ++i)
-    {  if(strcmp(ftab[i].fname,fname) == 0)
-       {
+    for(i=0; i<matab.allocated; ++i)
+    {  if(matab.object[i] == (matab_object_type *)NULL)
+       {  ptr                   = pups_calloc(n_el,size);
+          matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
+          matab.object[i]->ptr  = ptr;
+          matab.object[i]->size = size;
+          matab.object[i]->n_el = n_el;
 
-          #ifdef PTHREAD_SUPPORT
-          (void)pthread_mutex_unlock(&ftab_mutex);
-          #endif /* PTHREAD_SUPPORT */
+          (void)strlcpy(matab.object[i]->name,object_name,SSIZE);    
+          (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
+
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
 
           pups_set_errno(OK);
-          return(ftab[i].fdes);
+          return(ptr);
        }
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
-
-    pups_set_errno(ESRCH);
-    return(-1);
-}
-
-
-
-
-/*-------------------------------*/
-/* Get file stream from filename */
-/*-------------------------------*/
+    i               = matab.allocated;
+    matab.allocated += ALLOC_QUANTUM;
+    matab.object    = (matab_object_type **)pups_realloc((void *)matab.object,matab.allocated*sizeof(matab_object_type *));
 
-_PUBLIC FILE *pups_fname2fstream(const char *fname)
 
-{   uint32_t i;
+    /*-------------------------------------------------*/
+    /* Make sure the newly allocated pointers are NULL */
+    /*-------------------------------------------------*/
 
-    if(fname == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((FILE *)NULL);
-    }
+    for(j=i; j<matab.allocated; ++j)
+       matab.object[j] = (matab_object_type *)NULL;
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    ptr                   = pups_calloc(n_el,size);
+    matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
+    matab.object[i]->ptr  = ptr;
+    matab.object[i]->size = size;
 
-    for(i=0; i<appl_max_files; ++i)
-    {  if(strcmp(ftab[i].fname,fname) == 0 && ftab[i].stream != (FILE *)NULL)
-       {
+    (void)strlcpy(matab.object[i]->name,object_name,SSIZE);
+    (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
 
-          #ifdef PTHREAD_SUPPORT
-          (void)pthread_mutex_unlock(&ftab_mutex);
-          #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-          pups_set_errno(OK);
-          return(ftab[i].stream);
-       }
-    }
+    pups_set_errno(OK);
+    return(ptr);
+}
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    pups_set_errno(ESRCH);
-    return((FILE *)NULL);
-}
 
 
+/*-------------------------------*/
+/* Memory block tracking realloc */
+/*-------------------------------*/
 
+_PUBLIC void *pups_trealloc(void *ptr, const size_t size)
 
-/*-------------------------------------*/
-/* Get file table index from file name */
-/*-------------------------------------*/
+{    int32_t i;
 
-_PUBLIC int32_t pups_fname2index(const char *fname)
 
-{   uint32_t i;
+    /*--------------------------------------------------------------*/
+    /* If this is our first time we need to be processed by tmalloc */
+    /*--------------------------------------------------------------*/
 
-    if(fname == (const char *)NULL)
+    if(ptr == (void *)NULL || size <= 0)
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return((void *)NULL);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    for(i=0; i<appl_max_files; ++i)
-    {  if(strcmp(ftab[i].fname,fname) == 0)
-       {  
 
-          #ifdef PTHREAD_SUPPORT
-          (void)pthread_mutex_unlock(&ftab_mutex);
-          #endif /* PTHREAD_SUPPORT */
+    /*-----------------------------------------------------------*/ 
+    /* Find object to be reallocated in the block tracking table */
+    /*-----------------------------------------------------------*/ 
+
+    for(i=0; i<matab.allocated; ++i)
+    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
+       {  ptr                   = pups_realloc(ptr,size);
+          matab.object[i]->size = size;
+          matab.object[i]->ptr  = ptr;
+
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
 
           pups_set_errno(OK);
-          return((int32_t)i);
+          return(ptr);
        }
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    pups_set_errno(ESRCH);
-    return(-1);
+    pups_set_errno(ERANGE);
+    return((void *)NULL);
 }
 
 
 
 
-/*-------------------------------------------*/
-/* Get file table index from file descriptor */
-/*-------------------------------------------*/
+/*---------------------------*/
+/* Allocate 2D tracked array */
+/*---------------------------*/
 
-_PUBLIC int32_t pups_fdes2index(const des_t fdes)
+_PUBLIC void **pups_taalloc(const pindex_t rows, const pindex_t cols, const psize_t size, const char *name, const char *type_name)
 
 {   uint32_t i;
 
-    if(fdes < 0 || fdes >= appl_max_files)
+    char mem_name[SSIZE] = "";
+    void *array_mem      = (void *)NULL;
+    void **array         = (void **)NULL;
+
+    if(rows      <= 0                   ||
+       cols      <= 0                   ||
+       size      <= 0                   ||
+       name      == (const char *)NULL  ||
+       type_name == (const char *)NULL   )
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return((void **)NULL);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    for(i=0; i<appl_max_files; ++i)
-    {  if(ftab[i].fdes == fdes)
-       {
+    /*-------------------------------------------*/
+    /* First allocate memory for the whole array */
+    /*-------------------------------------------*/
 
-          #ifdef PTHREAD_SUPPORT
-          (void)pthread_mutex_unlock(&ftab_mutex);
-          #endif /* PTHREAD_SUPPORT */
+    (void)snprintf(mem_name,SSIZE,"%s[mem]",name);
+    array_mem = (void *)pups_tmalloc(rows*cols*size,mem_name,"void *");
 
-          pups_set_errno(OK);
-          return((int32_t)i);
-       }
-    }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    /*------------------------------------*/
+    /* Now row allocate the pointer array */
+    /*------------------------------------*/
+
+    array = (void **)pups_tmalloc(rows*sizeof(void **),name,type_name);
+
+
+    /*---------------------------------------------------------*/
+    /* Now allocate the columns addressed by the pointer array */
+    /*---------------------------------------------------------*/
+
+    for(i=0; i<rows; ++i)
+    {  array[i]  = (void *)array_mem;
+       array_mem = (void *)((uint64_t)array_mem + (uint64_t)(cols*size));
+    }
 
-    pups_set_errno(ESRCH);
-    return(-1);
+    pups_set_errno(OK);
+    return(array);
 }
 
 
 
 
-/*--------------------------------*/
-/* Create file without opening it */
-/*--------------------------------*/
+/*-----------------------*/
+/* Free 2D tracked array */
+/*-----------------------*/
 
-_PUBLIC int32_t pups_creat(const char *name, const int32_t mode)
+_PUBLIC void **pups_tafree(const void **array)
 
-{  int32_t ret;
+{    if(array != (void **)NULL)
+     {  
 
-   if(mode < 0 || name == (const char *)NULL)
-   {  pups_set_errno(EINVAL);
-      return(-1);
-   }
+        /*--------------------------------------*/
+        /* Free contiguous slab of array memory */
+        /*--------------------------------------*/
 
-   if(access(name,F_OK) == 0)
-   {  pups_set_errno(EACCES);
-      return(-1);
-   }
-   else
-   {  if((ret = creat(name,mode)) == (-1))
-      {
+        (void)pups_tfree((const void *)array[0]);
 
-         /*-----------------------*/
-         /* Failed to create file */
-         /*-----------------------*/
 
-         return(-1);
-      }
-   }
+        /*-----------------------*/
+        /* Free 2D mapping array */
+        /*-----------------------*/
 
-   /*--------------------------*/
-   /* Make sure we have really */
-   /* closed the file          */
-   /*--------------------------*/
- 
-   while(close(ret) < 0)
-        (void)pups_usleep(100);
+        (void)pups_tfree((const void **)array);
 
-   pups_set_errno(OK);
-   return(0);
+        pups_set_errno(OK);
+     }
+ 
+     pups_set_errno(EINVAL);
+     return((void **)NULL);
 }
 
 
 
 
-/*---------------------------------------------------------------------------*/
-/* Change mode of file associated with open descriptor and update file table */
-/*---------------------------------------------------------------------------*/
 
-_PUBLIC int32_t pups_fchmod(const des_t fdes, const int32_t mode)
+/*----------------------------------------------------------*/
+/* Get tracked object heap address from tracked object name */
+/*----------------------------------------------------------*/
 
-{   int32_t ret,
-            f_index;
+_PUBLIC void *pups_tnametoptr(const char *name)
 
-    if(mode < 0)
+{   uint32_t i;
+
+    if(name == (const char *)NULL)
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return((void *)NULL);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    if((f_index = pups_get_ftab_index(fdes)) == (-1))
-    {
+    for(i=0; i<matab.allocated; ++i)
+    {  if(matab.object[i] != (matab_object_type *)NULL && strcmp(matab.object[i]->name,name) == 0)
+       {
 
-       #ifdef PTHREAD_SUPPORT
-       (void)pthread_mutex_unlock(&ftab_mutex);
-       #endif /* PTHREAD_SUPPORT */
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
 
-       pups_set_errno(EBADF);
-       return(-1);
+          pups_set_errno(OK);
+          return(matab.object[i]->ptr);
+       }
     }
 
-    ftab[f_index].st_mode = mode; 
-    ret                   = fchmod(fdes,mode);
-
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-    pups_set_errno(OK);
-    return(ret); 
+    pups_set_errno(ESRCH);
+    return((void *)NULL);
 }
 
 
 
 
-/*-------------------------------------------------*/
-/* Return string size (including terminating NULL) */
-/*-------------------------------------------------*/
+/*----------------------------------------------*/
+/* Get pointer from partial tracked object name */
+/*----------------------------------------------*/
 
-_PUBLIC int32_t pups_strlen(const char *s)
+_PUBLIC void *pups_tpartnametoptr(uint32_t *pos, const char *pname)
 
-{    if(s != (const char *)NULL)
-        return(strlen(s) + 1);
-     else
-        return(-1);
-}
+{   uint32_t i;
+
+    if(pname == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((void *)NULL);
+    }
+
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_lock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
+    for(i=(*pos); i<matab.allocated; ++i)
+    {  if(matab.object[i] != (matab_object_type *)NULL && strin(matab.object[i]->name,pname) == TRUE)
+       {  (*pos) = i + 1;
 
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
 
+          pups_set_errno(OK);
+          return(matab.object[i]->ptr);
+       }
+    }
 
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
-/*----------------------------------*/
-/* Initialise tracked object system */
-/*----------------------------------*/
-/*-------------------------*/
-/* Memory allocation table */
-/*-------------------------*/
+    pups_set_errno(ESRCH);
+    return((void *)NULL);
+}
 
-_PRIVATE matab_type matab;
 
-_PRIVATE void tinit(void)
 
-{   
+
+/*-------------------------------*/
+/* Get pointer from tracked type */
+/*-------------------------------*/
+
+_PUBLIC void *pups_ttypetoptr(uint32_t *pos, const char *type)
+
+{   uint32_t i;
+
+    if(type == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return((void *)NULL);
+    }
 
     #ifdef PTHREAD_SUPPPORT
     (void)pthread_mutex_lock(&matab_mutex);
     #endif /* PTHREAD_SUPPPORT */
 
-    matab.allocated = 0;
-    matab.object    = (matab_object_type **)NULL;
+    for(i=(*pos); i<matab.allocated; ++i)
+    {  if(matab.object[i] != (matab_object_type *)NULL && strcmp(matab.object[i]->type,type) == 0)
+       {  (*pos) = i + 1;
 
-    if(appl_verbose == TRUE)
-    {  (void)strdate(date);
-       (void)fprintf(stderr,"%s %s (%d@%s:%s): Static heap object tracking enabled\n",
-                                         date,appl_name,appl_pid,appl_host,appl_owner);
-       (void)fflush(stderr);
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
+
+          pups_set_errno(OK);
+          return(matab.object[i]->ptr);
+       }
     }
 
     #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
+    (void)pthread_mutex_unlock(&matab_mutex);
     #endif /* PTHREAD_SUPPPORT */
+
+    pups_set_errno(ESRCH);
+    return((void *)NULL);
 }
 
 
 
 
-/*------------------------------*/
-/* Memory block tracking malloc */
-/*------------------------------*/
 
-_PUBLIC void *pups_tmalloc(const size_t size, const char *object_name, const char *object_type)
+/*----------------------------*/
+/* Memory block tracking free */
+/*----------------------------*/
 
-{   uint32_t i,
-             j;
+_PUBLIC void *pups_tfree(const void *ptr)
 
-    void *ptr = (void *)NULL;
+{   uint32_t i;
 
-    if(size        <= 0                   ||
-       object_name == (const char *)NULL  ||
-       object_type == (const char *)NULL   )
+
+    /*------------------------------------------------------*/
+    /* Simply ignore a NULL object (but warn user about it) */
+    /*------------------------------------------------------*/
+
+    if(ptr == (const void *)NULL)
     {  pups_set_errno(EINVAL);
        return((void *)NULL);
     }
-
+  
     #ifdef PTHREAD_SUPPPORT
     (void)pthread_mutex_lock(&matab_mutex);
     #endif /* PTHREAD_SUPPPORT */
 
 
-    /*----------------------*/
-    /* Re-use existing slot */
-    /*----------------------*/
+    /*-----------------------------*/
+    /* Find the object to be freed */
+    /*-----------------------------*/
 
     for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] == (matab_object_type *)NULL)
-       {  ptr                   = pups_malloc(size); 
-          matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
-          matab.object[i]->ptr  = ptr;
-          matab.object[i]->size = size;
-
-          (void)strlcpy(matab.object[i]->name,object_name,SSIZE);  
-          (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
-
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
+    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
+       {
 
-          pups_set_errno(OK);
-          return(ptr);
-       }
-    }
+          /*----------------------------------------------*/
+          /* Free the object returning memory to free pool*/
+          /*----------------------------------------------*/
 
+          (void)pups_free((void *)ptr);
 
-    /*--------------*/
-    /* Extend table */
-    /*--------------*/
 
-    i               =  matab.allocated;
-    matab.allocated += ALLOC_QUANTUM;
-    matab.object    = (matab_object_type **)pups_realloc((void *)matab.object,matab.allocated*sizeof(matab_object_type *));
+          /*------------------------------------------------------------------*/
+          /* Clear information about object (in PUPS memory allocation table) */
+          /*------------------------------------------------------------------*/
 
+          matab.object[i]->ptr  = (void *)NULL;
+          matab.object[i]->size = 0;
+          matab.object[i]->n_el = 0;
 
-    /*-------------------------------------------------*/
-    /* Make sure the newly allocated pointers are NULL */
-    /*-------------------------------------------------*/
+          (void)strlcpy(matab.object[i]->name,"",SSIZE);
+          (void)strlcpy(matab.object[i]->type,"",SSIZE);
 
-    for(j=i; j<matab.allocated; ++j)
-       matab.object[j] = (matab_object_type *)NULL;
 
-    ptr                   = pups_malloc(size);          
-    matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
-    matab.object[i]->ptr  = ptr;
-    matab.object[i]->size = size;
+          /*------------------------------------------------------------------*/
+          /* Free the slot in the table which contained the information about */
+          /* freed object                                                     */
+          /*------------------------------------------------------------------*/
 
-    (void)strlcpy(matab.object[i]->name,object_name,SSIZE);    
-    (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
+          matab.object[i] = (matab_object_type *)pups_free((void *)matab.object[i]);
+
+          #ifdef PTHREAD_SUPPPORT
+          (void)pthread_mutex_unlock(&matab_mutex);
+          #endif /* PTHREAD_SUPPPORT */
+
+          pups_set_errno(OK);
+          return((void *)NULL);
+       }
+    }
 
     #ifdef PTHREAD_SUPPPORT
     (void)pthread_mutex_unlock(&matab_mutex);
     #endif /* PTHREAD_SUPPPORT */
 
-    pups_set_errno(OK);
-    return(ptr);
+    pups_set_errno(ESRCH);
+    return((void *)NULL);
 }
 
 
 
 
-/*------------------------------*/
-/* Memory block tracking calloc */
-/*------------------------------*/
+/*-------------------------*/
+/* Display tracked objects */
+/*-------------------------*/
 
-_PUBLIC void *pups_tcalloc(const int32_t n_el, const size_t size, const char *object_name, const char *object_type)
+_PUBLIC int32_t pups_tshowobject(const FILE *stream, const void *ptr)
 
-{   int32_t i,
-            j;
+{   uint32_t i;
 
-    void *ptr = (void *)NULL;
 
-    if(n_el        <= 0                   ||
-       size        <= 0                   ||
-       object_name == (const char *)NULL  ||
-       object_type == (const char *)NULL   )
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_show_tobject] attempt by non root thread to perform PUPS/P3 utility operation");
+
+    if(stream == (const FILE *)NULL || ptr == (const void *)NULL)
     {  pups_set_errno(EINVAL);
-       return((void *)NULL);
+       return(-1);
+    }
+
+    if(matab.allocated == 0)
+    {  pups_set_errno(EACCES);
+       return(0);
     }
 
     #ifdef PTHREAD_SUPPPORT
@@ -16384,72 +17616,95 @@ _PUBLIC void *pups_tcalloc(const int32_t n_el, const size_t size, const char *ob
     #endif /* PTHREAD_SUPPPORT */
 
     for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] == (matab_object_type *)NULL)
-       {  ptr                   = pups_calloc(n_el,size);
-          matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
-          matab.object[i]->ptr  = ptr;
-          matab.object[i]->size = size;
-          matab.object[i]->n_el = n_el;
+    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
+       {  (void)fprintf(stream,"    Object %-32s (type %-32s) size %016lx (at %016lx virtual)\n",matab.object[i]->name,
+                                                                                                 matab.object[i]->type,
+                                                                                                 matab.object[i]->size,
+                                                                               (uint64_t         )matab.object[i]->ptr); 
+          (void)fflush(stream);
 
-          (void)strlcpy(matab.object[i]->name,object_name,SSIZE);    
-          (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
 
           #ifdef PTHREAD_SUPPPORT
           (void)pthread_mutex_unlock(&matab_mutex);
           #endif /* PTHREAD_SUPPPORT */
 
           pups_set_errno(OK);
-          return(ptr);
+          return(0);
        }
     }
 
-    i               = matab.allocated;
-    matab.allocated += ALLOC_QUANTUM;
-    matab.object    = (matab_object_type **)pups_realloc((void *)matab.object,matab.allocated*sizeof(matab_object_type *));
+    #ifdef PTHREAD_SUPPPORT
+    (void)pthread_mutex_unlock(&matab_mutex);
+    #endif /* PTHREAD_SUPPPORT */
 
+    pups_set_errno(ESRCH);
+    return(-1);
+}
 
-    /*-------------------------------------------------*/
-    /* Make sure the newly allocated pointers are NULL */
-    /*-------------------------------------------------*/
 
-    for(j=i; j<matab.allocated; ++j)
-       matab.object[j] = (matab_object_type *)NULL;
 
-    ptr                   = pups_calloc(n_el,size);
-    matab.object[i]       = (matab_object_type *)pups_malloc(sizeof(matab_object_type));
-    matab.object[i]->ptr  = ptr;
-    matab.object[i]->size = size;
 
-    (void)strlcpy(matab.object[i]->name,object_name,SSIZE);
-    (void)strlcpy(matab.object[i]->type,object_type,SSIZE);
+/*------------------------------------*/
+/* Display all dynamic memory objects */
+/*------------------------------------*/
+/*--------------*/
+/* Sort by size */
+/*--------------*/
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+_PRIVATE int32_t compare_objects(matab_object_type **el_1, matab_object_type **el_2)
 
-    pups_set_errno(OK);
-    return(ptr);
+
+{   if(*el_1 == (matab_object_type *)NULL && *el_2 == (matab_object_type *)NULL) 
+       return(0);
+
+    if(*el_1 != (matab_object_type *)NULL && *el_2 == (matab_object_type *)NULL)
+       return(-1);
+
+    if(*el_1 == (matab_object_type *)NULL && *el_2 != (matab_object_type *)NULL)
+       return(1);
+
+    if((*el_1)->size < (*el_2)->size)
+       return(1);
+
+    if((*el_1)->size > (*el_2)->size)
+       return(-1);
+
+    return(0);
 }
 
 
 
 
-/*-------------------------------*/
-/* Memory block tracking realloc */
-/*-------------------------------*/
+/*------------------------------*/
+/* Display tracked object table */
+/*------------------------------*/
 
-_PUBLIC void *pups_trealloc(void *ptr, const size_t size)
+_PUBLIC int32_t pups_tshowobjects(const FILE *stream, int32_t *display_objects)
 
-{    int32_t i;
+{   uint32_t          i,
+                      t_cnt = 0;
 
+    uint64_t          heap_used        = 0;
+    matab_object_type **ordered_object = (matab_object_type **)NULL;
 
-    /*--------------------------------------------------------------*/
-    /* If this is our first time we need to be processed by tmalloc */
-    /*--------------------------------------------------------------*/
 
-    if(ptr == (void *)NULL || size <= 0)
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_tshowobjects] attempt by non root thread to perform PUPS/P3 utility operation");
+
+    if(stream == (const FILE *)NULL)
     {  pups_set_errno(EINVAL);
-       return((void *)NULL);
+       return(-1);
+    }
+
+
+    if(matab.allocated == 0)
+    {  pups_set_errno(EACCES);
+       return(0);
     }
 
     #ifdef PTHREAD_SUPPPORT
@@ -16457,22 +17712,17 @@ _PUBLIC void *pups_trealloc(void *ptr, const size_t size)
     #endif /* PTHREAD_SUPPPORT */
 
 
-    /*-----------------------------------------------------------*/ 
-    /* Find object to be reallocated in the block tracking table */
-    /*-----------------------------------------------------------*/ 
+    /*---------------------------------------------------------------------------------*/
+    /* As we may inadvertantly re-order the object table while we are doing a critical */
+    /* operation on it (e.g. using one of the tracked object allocator routines) make  */
+    /* a copy of the table and re-order that                                           */
+    /*---------------------------------------------------------------------------------*/
 
+    ordered_object = (matab_object_type **)pups_calloc(matab.allocated,sizeof(matab_type *));
     for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
-       {  ptr                   = pups_realloc(ptr,size);
-          matab.object[i]->size = size;
-          matab.object[i]->ptr  = ptr;
-
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
-
-          pups_set_errno(OK);
-          return(ptr);
+    {  if(matab.object[i] != (matab_object_type *)NULL)
+       {  ordered_object[t_cnt] = matab.object[i];
+          ++t_cnt;
        }
     }
 
@@ -16480,403 +17730,391 @@ _PUBLIC void *pups_trealloc(void *ptr, const size_t size)
     (void)pthread_mutex_unlock(&matab_mutex);
     #endif /* PTHREAD_SUPPPORT */
 
-    pups_set_errno(ERANGE);
-    return((void *)NULL);
-}
-
-
 
+    /*------------------------------------------------------------------------------*/
+    /* Order the objects so the largest ones are always towards the top of the list */
+    /*------------------------------------------------------------------------------*/
 
-/*---------------------------*/
-/* Allocate 2D tracked array */
-/*---------------------------*/
+    (void)qsort((void *)ordered_object,t_cnt,sizeof(matab_object_type *),(void *)compare_objects);
 
-_PUBLIC void **pups_taalloc(const pindex_t rows, const pindex_t cols, const psize_t size, const char *name, const char *type_name)
+    (void)fprintf(stream,"\n\n    Heap objects for %s (%d@%s)\n\n",appl_name,getpid(),appl_host);
+    (void)fflush(stream);
 
-{   uint32_t i;
+    if(*display_objects > t_cnt && display_objects != (int32_t *)NULL)
+       *display_objects = t_cnt;
 
-    char mem_name[SSIZE] = "";
-    void *array_mem      = (void *)NULL;
-    void **array         = (void **)NULL;
+    for(i=0; i<display_objects; ++i)
+    {  (void)fprintf(stream,"    %04d: Object %-32s (type %-32s) size %016lx (at %016lx virtual)\n",i,
+                                                                              ordered_object[i]->name,
+                                                                              ordered_object[i]->type,
+                                                                              ordered_object[i]->size,
+                                                            (uint64_t         )ordered_object[i]->ptr); 
+       (void)fflush(stream);
 
-    if(rows      <= 0                   ||
-       cols      <= 0                   ||
-       size      <= 0                   ||
-       name      == (const char *)NULL  ||
-       type_name == (const char *)NULL   )
-    {  pups_set_errno(EINVAL);
-       return((void **)NULL);
+       heap_used += ordered_object[i]->size;
     }
 
 
-    /*-------------------------------------------*/
-    /* First allocate memory for the whole array */
-    /*-------------------------------------------*/
-
-    (void)snprintf(mem_name,SSIZE,"%s[mem]",name);
-    array_mem = (void *)pups_tmalloc(rows*cols*size,mem_name,"void *");
-
-
-    /*------------------------------------*/
-    /* Now row allocate the pointer array */
-    /*------------------------------------*/
-
-    array = (void **)pups_tmalloc(rows*sizeof(void **),name,type_name);
-
-
-    /*---------------------------------------------------------*/
-    /* Now allocate the columns addressed by the pointer array */
-    /*---------------------------------------------------------*/
+    if(t_cnt > 1)
+       (void)fprintf(stream,"\n\n    %04d tracked objects [in %016lx bytes of heap] (%04d slots free)\n\n",t_cnt,heap_used,matab.allocated - t_cnt);
+    else if(t_cnt == 1)
+       (void)fprintf(stream,"\n\n    %04d tracked objects [in %016lx bytes of heap] (%04d slots free)\n\n",1,heap_used,matab.allocated - 1);
+    else
+       (void)fprintf(stream,"    no tracked objects (%04d slots free)\n\n",matab.allocated);
+    (void)fflush(stream);
 
-    for(i=0; i<rows; ++i)
-    {  array[i]  = (void *)array_mem;
-       array_mem = (void *)((uint64_t)array_mem + (uint64_t)(cols*size));
-    }
+    (void)pups_free((void *)ordered_object);
 
     pups_set_errno(OK);
-    return(array);
-}
-
-
-
-
-/*-----------------------*/
-/* Free 2D tracked array */
-/*-----------------------*/
+    return(0);
+}
 
-_PUBLIC void **pups_tafree(const void **array)
 
-{    if(array != (void **)NULL)
-     {  
 
-        /*--------------------------------------*/
-        /* Free contiguous slab of array memory */
-        /*--------------------------------------*/
 
-        (void)pups_tfree((const void *)array[0]);
+/*---------------------*/
+/* PUPS fgets function */
+/*---------------------*/
 
+_PUBLIC char *pups_fgets(char *s, const size_t size, const FILE *stream)
 
-        /*-----------------------*/
-        /* Free 2D mapping array */
-        /*-----------------------*/
 
-        (void)pups_tfree((const void **)array);
+{   size_t c_index;
+    char   *ret = (char *)NULL;
 
-        pups_set_errno(OK);
-     }
- 
-     pups_set_errno(EINVAL);
-     return((void **)NULL);
-}
+    ret = fgets(s,size,stream);
+    if((c_index = ch_pos(s,'\n')) != (-1))
+       s[c_index] = '\0';
 
+    return(ret);
+}
 
 
 
 
-/*----------------------------------------------------------*/
-/* Get tracked object heap address from tracked object name */
-/*----------------------------------------------------------*/
+/*-------------------------------------------------------------------------------*/
+/* Check to see if line is a comment line (first non-space char is '#') or empty */
+/*-------------------------------------------------------------------------------*/
 
-_PUBLIC void *pups_tnametoptr(const char *name)
+_PUBLIC _BOOLEAN strcomment(const char *s)
 
-{   uint32_t i;
+{   size_t i;
 
-    if(name == (const char *)NULL)
+    if(s == (const char *)NULL)
     {  pups_set_errno(EINVAL);
-       return((void *)NULL);
+       return(-1);
     }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
 
-    for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && strcmp(matab.object[i]->name,name) == 0)
-       {
+    /*------------*/
+    /* Empty line */
+    /*------------*/
 
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
+    if(s[0] =='\0')
+    {  pups_set_errno(OK);
+       return(TRUE);
+    }
 
-          pups_set_errno(OK);
-          return(matab.object[i]->ptr);
+    /*-----------------------------*/
+    /* Comment or white/tab space? */
+    /*-----------------------------*/
+
+    for(i=0; i<strlen(s); ++i)
+    {  if(s[i] != ' ') 
+       {  if(s[i] == '#')
+          {  pups_set_errno(OK);
+             return(TRUE);
+          }
        }
     }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
-
-    pups_set_errno(ESRCH);
-    return((void *)NULL);
+    pups_set_errno(OK);
+    return(FALSE);
 }
 
 
 
 
-/*----------------------------------------------*/
-/* Get pointer from partial tracked object name */
-/*----------------------------------------------*/
+/*---------------------------------------------*/
+/* Set all characters in string to NULL ('\0') */
+/*---------------------------------------------*/
 
-_PUBLIC void *pups_tpartnametoptr(uint32_t *pos, const char *pname)
+_PUBLIC void strclr(char *s)
 
-{   uint32_t i;
+{   size_t i;
 
-    if(pname == (const char *)NULL)
+    if(s == (char *)NULL)
     {  pups_set_errno(EINVAL);
-       return((void *)NULL);
+       return;
     }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+    for(i=0; i<strlen(s); ++i)
+       s[i] = '\0';
 
-    for(i=(*pos); i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && strin(matab.object[i]->name,pname) == TRUE)
-       {  (*pos) = i + 1;
+    pups_set_errno(OK);
+}
 
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
 
-          pups_set_errno(OK);
-          return(matab.object[i]->ptr);
-       }
-    }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
 
-    pups_set_errno(ESRCH);
-    return((void *)NULL);
+/*-----------*/
+/* Set errno */
+/*-----------*/
+
+_PUBLIC void pups_set_errno(const int32_t pups_errno)
+
+{   errno = pups_errno;
 }
 
 
 
 
-/*-------------------------------*/
-/* Get pointer from tracked type */
-/*-------------------------------*/
 
-_PUBLIC void *pups_ttypetoptr(uint32_t *pos, const char *type)
+/*-----------*/
+/* Get errno */
+/*-----------*/
 
-{   uint32_t i;
+_PUBLIC int32_t pups_get_errno(void)
+ 
+{   return(errno);
+}
 
-    if(type == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((void *)NULL);
-    }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
 
-    for(i=(*pos); i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && strcmp(matab.object[i]->type,type) == 0)
-       {  (*pos) = i + 1;
 
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
+/*----------------------------------------------------------------------------------------*/
+/* Handler for SIGTTIN/SIGTTOU (automatically re-directs stdio to datasink if application */
+/* moved into background interactively from a shell)                                      */
+/*----------------------------------------------------------------------------------------*/
 
-          pups_set_errno(OK);
-          return(matab.object[i]->ptr);
-       }
+_PRIVATE int32_t fgio_handler(const int32_t signum)
+
+{   
+    if(signum < 1 || signum > MAX_SIGS)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    pups_set_errno(ESRCH);
-    return((void *)NULL);
-}
+    if(isatty(0) == 1)
+    {  (void)fclose(stdin);
+       stdin = fopen("/dev/null","r");
+       (void)strlcpy(ftab[0].fname,"/dev/null",SSIZE);
+       (void)strlcpy(ftab[0].fshadow,"/dev/null",SSIZE);
+    }
+
+    if(isatty(1) == 1)
+    {  (void)fclose(stdout);
+       stdout = fopen("/dev/null","w");
+       (void)strlcpy(ftab[1].fname,"/dev/null",SSIZE);
+       (void)strlcpy(ftab[1].fshadow,"/dev/null",SSIZE);
+    }
 
+    if(isatty(2) == 1)
+    {  (void)fclose(stderr);
+       stderr = fopen("/dev/null","w");
+       (void)strlcpy(ftab[2].fname,"/dev/null",SSIZE);
+       (void)strlcpy(ftab[2].fshadow,"/dev/null",SSIZE);
+    }
 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&ftab_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    pups_set_errno(OK);
+    return(0);
+}
 
 
-/*----------------------------*/
-/* Memory block tracking free */
-/*----------------------------*/
 
-_PUBLIC void *pups_tfree(const void *ptr)
 
-{   uint32_t i;
+/*-------------------------------------------------------------------------*/
+/*  Turn tty echoing off                                                   */
+/*                                                                         */
+/*  It is desirable to use this bit on systems that have it.               */
+/*  The only bit of terminal state we want to twiddle is echoing, which is */
+/*  done in software; there is no need to change the state of the terminal */
+/*  hardware                                                               */
+/*-------------------------------------------------------------------------*/
 
+#ifndef TCSASOFT
+#define TCSASOFT 0
+#endif /* TCSASOFT */
 
-    /*------------------------------------------------------*/
-    /* Simply ignore a NULL object (but warn user about it) */
-    /*------------------------------------------------------*/
 
-    if(ptr == (const void *)NULL)
-    {  pups_set_errno(EINVAL);
-       return((void *)NULL);
-    }
-  
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+_PUBLIC int32_t pups_tty_echoing_off(FILE *in, struct termios *s)
 
+{   int32_t tty_changed;
+    struct  termios t;
 
-    /*-----------------------------*/
-    /* Find the object to be freed */
-    /*-----------------------------*/
 
-    for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
-       {
+    /*-----------------------------------*/
+    /* Turn echoing off if it is on now. */
+    /*-----------------------------------*/
 
-          /*----------------------------------------------*/
-          /* Free the object returning memory to free pool*/
-          /*----------------------------------------------*/
+    if(tcgetattr (fileno (in), &t) == 0)
+    {
 
-          (void)pups_free((void *)ptr);
+       /*-------------------*/
+       /* Save the old one. */
+       /*-------------------*/
 
+       *s = t;
 
-          /*------------------------------------------------------------------*/
-          /* Clear information about object (in PUPS memory allocation table) */
-          /*------------------------------------------------------------------*/
 
-          matab.object[i]->ptr  = (void *)NULL;
-          matab.object[i]->size = 0;
-          matab.object[i]->n_el = 0;
+       /*-----------------*/
+       /* Tricky, tricky. */
+       /*-----------------*/
 
-          (void)strlcpy(matab.object[i]->name,"",SSIZE);
-          (void)strlcpy(matab.object[i]->type,"",SSIZE);
+       t.c_lflag &= ~(ECHO|ISIG);
+       tty_changed = (tcsetattr (fileno (in), TCSAFLUSH|TCSASOFT, &t) == 0);
+    }
+    else
+       tty_changed = 0;
 
+    return(tty_changed);
+}
 
-          /*------------------------------------------------------------------*/
-          /* Free the slot in the table which contained the information about */
-          /* freed object                                                     */
-          /*------------------------------------------------------------------*/
 
-          matab.object[i] = (matab_object_type *)pups_free((void *)matab.object[i]);
 
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
 
-          pups_set_errno(OK);
-          return((void *)NULL);
-       }
-    }
+/*---------------------*/
+/* Turn tty echoing on */
+/*---------------------*/
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+_PUBLIC void pups_tty_echoing_on(FILE *in, int32_t tty_changed, struct termios s)
 
-    pups_set_errno(ESRCH);
-    return((void *)NULL);
-}
+{   
 
+    /*-------------------------------*/
+    /* Restore the original setting. */
+    /*-------------------------------*/
 
+    if(tty_changed)
+       (void) tcsetattr (fileno (in), TCSAFLUSH|TCSASOFT, &s);
+}
 
 
-/*-------------------------*/
-/* Display tracked objects */
-/*-------------------------*/
 
-_PUBLIC int32_t pups_tshowobject(const FILE *stream, const void *ptr)
 
-{   uint32_t i;
 
+/*-------------------------------*.
+/* Execute command on local host */
+/*-------------------------------*/
+                                                  /*--------------------------*/
+_PUBLIC pid_t pups_lexec(const char      *shell,  /* Shell to execute comamnd */
+                         const char    *command,  /* Command to be executed   */
+                         const  int32_t    wait)  /* Wait action flag         */
+                                                  /*--------------------------*/
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+{   pid_t   pid;
+    int32_t status;
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_show_tobject] attempt by non root thread to perform PUPS/P3 utility operation");
+    _BOOLEAN obituary = FALSE;
 
-    if(stream == (const FILE *)NULL || ptr == (const void *)NULL)
+    if(shell == (char *)NULL || command == (char *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
-    if(matab.allocated == 0)
-    {  pups_set_errno(EACCES);
-       return(0);
-    }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+    /*-----------------------------------------------*/
+    /* Fork thread of control to create new process. */
+    /*-----------------------------------------------*/
 
-    for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL && matab.object[i]->ptr == ptr)
-       {  (void)fprintf(stream,"    Object %-32s (type %-32s) size %016lx (at %016lx virtual)\n",matab.object[i]->name,
-                                                                                                 matab.object[i]->type,
-                                                                                                 matab.object[i]->size,
-                                                                               (uint64_t         )matab.object[i]->ptr); 
-          (void)fflush(stream);
+    if(wait & PUPS_OBITUARY)
+       obituary = TRUE;
 
+    /*--------------------*/
+    /* Child side of fork */
+    /*--------------------*/
 
-          #ifdef PTHREAD_SUPPPORT
-          (void)pthread_mutex_unlock(&matab_mutex);
-          #endif /* PTHREAD_SUPPPORT */
+    if((pid = pups_fork(TRUE, obituary)) == 0)
+    {  uint32_t i;
 
-          pups_set_errno(OK);
-          return(0);
-       }
-    }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+       /*-----------------------------------*/
+       /* Set effective and real user i.d's */
+       /*-----------------------------------*/
 
-    pups_set_errno(ESRCH);
-    return(-1);
-}
+       (void)setreuid(getuid(),getuid());
 
 
+       /*-------------------------*/
+       /* Clear any pending alarm */
+       /*-------------------------*/
 
+       (void)pups_malarm(0);
 
-/*------------------------------------*/
-/* Display all dynamic memory objects */
-/*------------------------------------*/
-/*--------------*/
-/* Sort by size */
-/*--------------*/
 
-_PRIVATE int32_t compare_objects(matab_object_type **el_1, matab_object_type **el_2)
+       /*---------------------------------------*/
+       /* Restore all signals to default states */
+       /*---------------------------------------*/
 
+       for(i=0; i<MAX_SIGS; ++i)
+          (void)pups_sighandle(i,"default",SIG_DFL, (sigset_t *)NULL);
 
-{   if(*el_1 == (matab_object_type *)NULL && *el_2 == (matab_object_type *)NULL) 
-       return(0);
 
-    if(*el_1 != (matab_object_type *)NULL && *el_2 == (matab_object_type *)NULL)
-       return(-1);
+       /*---------------------------------------------------*/
+       /* Extract argument list for execl call and overlay. */
+       /*---------------------------------------------------*/
 
-    if(*el_1 == (matab_object_type *)NULL && *el_2 != (matab_object_type *)NULL)
-       return(1);
+       if(execlp(shell,shell,"-c",command,(char *)0) == (-1))
+       {  pups_set_errno(ENOEXEC);
+          return(-1);
+       }
+    }
 
-    if((*el_1)->size < (*el_2)->size)
-       return(1);
 
-    if((*el_1)->size > (*el_2)->size)
-       return(-1);
+    /*----------------------------------------------------------------------------*/
+    /* Parent side of fork - return childs pid if we are not going to wait for it */
+    /* otherwise return the child's exit status.                                  */
+    /*----------------------------------------------------------------------------*/
 
-    return(0);
-}
+    else
+    {
 
+       (void)pups_set_child_name(pid,command);
 
+       if(wait == PUPS_WAIT_FOR_CHILD)
+       {  
 
+          /*-----------------------------------*/
+          /* Wait for the child we have forked */
+          /*-----------------------------------*/
 
-/*------------------------------*/
-/* Display tracked object table */
-/*------------------------------*/
+          if(waitpid(pid,&status,0) == (-1))
+          {  pups_set_errno(ECHILD);
+             return(-1);
+          }
 
-_PUBLIC int32_t pups_tshowobjects(const FILE *stream, int32_t *display_objects)
+          pups_set_errno(OK);
+          return(status);
+       }
 
-{   uint32_t          i,
-                      t_cnt = 0;
+       pups_set_errno(OK);
+       return(pid);
+    }
 
-    uint64_t          heap_used        = 0;
-    matab_object_type **ordered_object = (matab_object_type **)NULL;
+    pups_set_errno(ENOSYS);
+    return(-1);
+}
+
+
+
+
+
+#ifdef PSRP_AUTHENTICATE
+/*-------------------------------*/
+/* Check secure service password */
+/*-------------------------------*/
+
+_PUBLIC _BOOLEAN pups_check_appl_password(const char *password)
 
+{
 
     /*----------------------------------*/
     /* Only the root thread can process */
@@ -16884,836 +18122,926 @@ _PUBLIC int32_t pups_tshowobjects(const FILE *stream, int32_t *display_objects)
     /*----------------------------------*/
 
     if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_tshowobjects] attempt by non root thread to perform PUPS/P3 utility operation");
+       pups_error("[pups_check_appl_password] attempt by non root thread to perform PUPS/P3 utility operation");
 
-    if(stream == (const FILE *)NULL)
+    if(password == (char *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
+    /*-----------------------------------------------*/
+    /* Check arguments if any are NULL simply return */
+    /*-----------------------------------------------*/
 
-    if(matab.allocated == 0)
-    {  pups_set_errno(EACCES);
-       return(0);
+    if(strcmp(appl_password,"notset") == 0)
+    {  pups_set_errno(OK);
+       return(TRUE);
     }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_lock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
+    if(strncmp(password,appl_password,strlen(appl_password)-1) != 0)
+    {  pups_set_errno(OK);
+       return(FALSE);
+    }
 
+    pups_set_errno(OK);
+    return(TRUE);
+}
 
-    /*---------------------------------------------------------------------------------*/
-    /* As we may inadvertantly re-order the object table while we are doing a critical */
-    /* operation on it (e.g. using one of the tracked object allocator routines) make  */
-    /* a copy of the table and re-order that                                           */
-    /*---------------------------------------------------------------------------------*/
 
-    ordered_object = (matab_object_type **)pups_calloc(matab.allocated,sizeof(matab_type *));
-    for(i=0; i<matab.allocated; ++i)
-    {  if(matab.object[i] != (matab_object_type *)NULL)
-       {  ordered_object[t_cnt] = matab.object[i];
-          ++t_cnt;
-       }
-    }
 
-    #ifdef PTHREAD_SUPPPORT
-    (void)pthread_mutex_unlock(&matab_mutex);
-    #endif /* PTHREAD_SUPPPORT */
 
+/*-------------------*/
+/* Authenticate user */
+/*-------------------*/
 
-    /*------------------------------------------------------------------------------*/
-    /* Order the objects so the largest ones are always towards the top of the list */
-    /*------------------------------------------------------------------------------*/
+_PUBLIC _BOOLEAN pups_checkuser(const char *username, const char *password)
 
-    (void)qsort((void *)ordered_object,t_cnt,sizeof(matab_object_type *),(void *)compare_objects);
+{   struct passwd  *pwent = (struct passwd *)NULL;
 
-    (void)fprintf(stream,"\n\n    Heap objects for %s (%d@%s)\n\n",appl_name,getpid(),appl_host);
-    (void)fflush(stream);
+    char salt[2]                 = "",
+         crypted_password[SSIZE] = "";
 
-    if(*display_objects > t_cnt && display_objects != (int32_t *)NULL)
-       *display_objects = t_cnt;
 
-    for(i=0; i<display_objects; ++i)
-    {  (void)fprintf(stream,"    %04d: Object %-32s (type %-32s) size %016lx (at %016lx virtual)\n",i,
-                                                                              ordered_object[i]->name,
-                                                                              ordered_object[i]->type,
-                                                                              ordered_object[i]->size,
-                                                            (uint64_t         )ordered_object[i]->ptr); 
-       (void)fflush(stream);
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_checkuser] attempt by non root thread to perform PUPS/P3 utility operation");
+
+    if(username == (char *)NULL || password == (char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+
+    /*--------------------------*/
+    /* Authenticate remote user */
+    /*--------------------------*/
 
-       heap_used += ordered_object[i]->size;
+    if((pwent = pups_getpwnam(username)) == (struct passwd *)NULL)
+    {  pups_set_errno(ESRCH);
+       return(FALSE);
     }
 
 
-    if(t_cnt > 1)
-       (void)fprintf(stream,"\n\n    %04d tracked objects [in %016lx bytes of heap] (%04d slots free)\n\n",t_cnt,heap_used,matab.allocated - t_cnt);
-    else if(t_cnt == 1)
-       (void)fprintf(stream,"\n\n    %04d tracked objects [in %016lx bytes of heap] (%04d slots free)\n\n",1,heap_used,matab.allocated - 1);
-    else
-       (void)fprintf(stream,"    no tracked objects (%04d slots free)\n\n",matab.allocated);
-    (void)fflush(stream);
+    /*-------------------------------------------*/
+    /* Crypt password using first two characters */
+    /* in password for "salt"                    */
+    /* Crypt password using first two characters */
+    /* in in encrypted password for "salt"       */
+    /*-------------------------------------------*/
 
-    (void)pups_free((void *)ordered_object);
+    salt[0] = pwent->pw_passwd[0];
+    salt[1] = pwent->pw_passwd[1];
+    (void)strlcpy((char *)&crypted_password,(char *)crypt(password,salt),SSIZE);
+
+    if(strcmp(pwent->pw_passwd,crypted_password) != 0)
+    {  pups_set_errno(EPERM);
+       return(FALSE);
+    }
 
     pups_set_errno(OK);
-    return(0);
+    return(TRUE);
 }
 
 
 
 
-/*---------------------*/
-/* PUPS fgets function */
-/*---------------------*/
+/*-----------------------------------------*/
+/* Check that application has password set */
+/*-----------------------------------------*/
 
-_PUBLIC char *pups_fgets(char *s, const size_t size, const FILE *stream)
+_PUBLIC _BOOLEAN pups_check_pass_set(void)
 
+{   
 
-{   size_t c_index;
-    char   *ret = (char *)NULL;
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
 
-    ret = fgets(s,size,stream);
-    if((c_index = ch_pos(s,'\n')) != (-1))
-       s[c_index] = '\0';
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_check_pass_set] attempt by non root thread to perform PUPS/P3 utility operation");
 
-    return(ret);
+    pups_set_errno(OK);
+    if(strcmp(appl_password,"notset") == 0)
+       return(FALSE);
+
+    return(TRUE);
 }
 
 
 
 
-/*-------------------------------------------------------------------------------*/
-/* Check to see if line is a comment line (first non-space char is '#') or empty */
-/*-------------------------------------------------------------------------------*/
+/*---------------------*/
+/* Authenticate a user */
+/*---------------------*/
 
-_PUBLIC _BOOLEAN strcomment(const char *s)
+_PUBLIC _BOOLEAN pups_getpass(const char *password_banner)
 
-{   size_t i;
+{   char pwd_file_name[SSIZE]         = "",
+         pups_password_banner[SSIZE]  = "";
 
-    if(s == (const char *)NULL)
+
+    /*----------------------------------*/
+    /* Only the root thread can process */
+    /* PSRP requests                    */
+    /*----------------------------------*/
+
+    if(pupsthread_is_root_thread() == FALSE)
+       pups_error("[pups_getpass] attempt by non root thread to perform PUPS/P3 utility operation");
+
+    if(password_banner == (char *)NULL)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
 
-    /*------------*/
-    /* Empty line */
-    /*------------*/
+    /*--------------------------------------------------------------*/
+    /* Check to see if we actually need to obtain an authentication */
+    /* token                                                        */
+    /*--------------------------------------------------------------*/
 
-    if(s[0] =='\0')
+    if(strcmp(appl_password,"notset") != 0)
     {  pups_set_errno(OK);
        return(TRUE);
     }
 
-    /*-----------------------------*/
-    /* Comment or white/tab space? */
-    /*-----------------------------*/
-
-    for(i=0; i<strlen(s); ++i)
-    {  if(s[i] != ' ') 
-       {  if(s[i] == '#')
-          {  pups_set_errno(OK);
-             return(TRUE);
-          }
-       }
-    }
 
-    pups_set_errno(OK);
-    return(FALSE);
-}
+    /*--------------------------------------------------------------*/
+    /* Search /tmp for an authorisation token for application owner */
+    /*--------------------------------------------------------------*/
 
+    (void)snprintf(pwd_file_name,SSIZE,"/tmp/auth.%s.tmp",appl_owner);
+    if(access(pwd_file_name,F_OK | R_OK | W_OK) == (-1))
+    {
 
+       /*------------------------------------------------------*/
+       /* Can we get to a controlling tty to talk to our user? */
+       /*------------------------------------------------------*/
 
+       if((isatty(0) == 1 || isatty(1) == 1 || isatty(2) == 1) && access(pwd_file_name,F_OK | R_OK | W_OK) == (-1))
+       {  int32_t indes = (-1);
 
-/*---------------------------------------------*/
-/* Set all characters in string to NULL ('\0') */
-/*---------------------------------------------*/
 
-_PUBLIC void strclr(char *s)
+          /*-----------------------------------------------------------------*/
+          /* Is stdin indirected? If so we need to inverse indirect it so we */
+          /* can talk to our user                                            */ 
+          /*-----------------------------------------------------------------*/
 
-{   size_t i;
+          if(isatty(0) == 0)
+          {  int32_t ttydes = (-1);
 
-    if(s == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return;
-    }
+             #ifdef UTILIB_DEBUG
+             (void)fprintf(stderr,"pups_getpass [%d@%s] duplicating stdin (and saving intial descriptor)\n",getpid(),appl_host);
+             (void)fflush(stderr);
+             #endif /* UTILIB_DEBUG */
 
-    for(i=0; i<strlen(s); ++i)
-       s[i] = '\0';
+             indes  = dup(0);
+          }
 
-    pups_set_errno(OK);
-}
+          (void)snprintf(pups_password_banner,SSIZE,"PUPS %s [%s] login: ",password_banner,appl_host);
+          (void)strlcpy(appl_password,(char *)getpass(pups_password_banner),SSIZE);
 
 
+          /*----------------------------*/
+          /* Check authentication token */
+          /*----------------------------*/
 
+          if(pups_checkuser(appl_owner,appl_password) == FALSE)
+          {  (void)fprintf(stderr,"pups_getpass [%d@%s]: permission denied\n",getpid(),appl_name);
+             (void)fflush(stderr);
 
-/*-----------*/
-/* Set errno */
-/*-----------*/
+             pups_set_errno(EPERM);
+             return(FALSE);
+          }
 
-_PUBLIC void pups_set_errno(const int32_t pups_errno)
 
-{   errno = pups_errno;
-}
+          /*--------------------------------------------------*/
+          /* If we have had to inverse indirect restore stdin */
+          /* to its intial (e.g. indirected) state            */
+          /*--------------------------------------------------*/
 
+          if(indes != (-1))
+          {  (void)dup2(indes,0);
+             (void)close(indes);
 
+             #ifdef DEBUG
+             (void)fprintf(stderr,"rfifod [%d@%s]: initial stdin descriptor restored (after password entry)\n",getpid(),appl_host);
+             (void)fflush(stderr);
+             #endif /* DEBUG */
+          }
 
+          pups_set_errno(OK);
+          return(TRUE);
+       }
+    }
+    else
+    {  FILE *pwd_stream = (FILE *)NULL; 
 
 
-/*-----------*/
-/* Get errno */
-/*-----------*/
+       /*---------------------------------------------*/
+       /* Extract token from authorisation token file */
+       /*---------------------------------------------*/
 
-_PUBLIC int32_t pups_get_errno(void)
- 
-{   return(errno);
-}
+       pwd_stream = pups_fopen(pwd_file_name,"r",DEAD);
 
+       (void)fscanf(pwd_stream,"%s",appl_password);
+       (void)pups_fclose(pwd_stream);
 
 
+       /*----------------------------*/
+       /* Check authentication token */
+       /*----------------------------*/
 
-/*----------------------------------------------------------------------------------------*/
-/* Handler for SIGTTIN/SIGTTOU (automatically re-directs stdio to datasink if application */
-/* moved into background interactively from a shell)                                      */
-/*----------------------------------------------------------------------------------------*/
+       if(pups_checkuser(appl_owner,appl_password) == FALSE)
+       {  (void)fprintf(stderr,"%d@%s: permission denied\n",appl_pid,appl_name);
+          (void)fflush(stderr);
 
-_PRIVATE int32_t fgio_handler(const int32_t signum)
+          pups_set_errno(EPERM);
+          return(FALSE);
+       }
 
-{   
-    if(signum < 1 || signum > MAX_SIGS)
-    {  pups_set_errno(EINVAL);
-       return(-1);
+       pups_set_errno(OK);
+       return(TRUE);
     }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_lock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    if(isatty(0) == 1)
-    {  (void)fclose(stdin);
-       stdin = fopen("/dev/null","r");
-       (void)strlcpy(ftab[0].fname,"/dev/null",SSIZE);
-       (void)strlcpy(ftab[0].fshadow,"/dev/null",SSIZE);
-    }
+    /*---------------------------------------*/
+    /* We cannot get an authentication token */
+    /*---------------------------------------*/
 
-    if(isatty(1) == 1)
-    {  (void)fclose(stdout);
-       stdout = fopen("/dev/null","w");
-       (void)strlcpy(ftab[1].fname,"/dev/null",SSIZE);
-       (void)strlcpy(ftab[1].fshadow,"/dev/null",SSIZE);
-    }
+    pups_set_errno(EPERM);
+    return(FALSE);
+}
+#endif /* PSRP_AUTHENTICATE */
 
-    if(isatty(2) == 1)
-    {  (void)fclose(stderr);
-       stderr = fopen("/dev/null","w");
-       (void)strlcpy(ftab[2].fname,"/dev/null",SSIZE);
-       (void)strlcpy(ftab[2].fshadow,"/dev/null",SSIZE);
-    }
 
-    #ifdef PTHREAD_SUPPORT
-    (void)pthread_mutex_unlock(&ftab_mutex);
-    #endif /* PTHREAD_SUPPORT */
 
-    pups_set_errno(OK);
-    return(0);
-}
 
+/*----------------------------------------*/
+/* Handler for SIGSEGV, SIGBUS and SIGFPE */
+/*----------------------------------------*/
 
+_PRIVATE int32_t segbusfpe_handler(const int32_t signum)
 
+{    uint32_t i;
 
-/*-------------------------------------------------------------------------*/
-/*  Turn tty echoing off                                                   */
-/*                                                                         */
-/*  It is desirable to use this bit on systems that have it.               */
-/*  The only bit of terminal state we want to twiddle is echoing, which is */
-/*  done in software; there is no need to change the state of the terminal */
-/*  hardware                                                               */
-/*-------------------------------------------------------------------------*/
+     if(signum < 1 || signum > MAX_SIGS)
+     {  pups_set_errno(EINVAL);
+        return(-1);
+     }
 
-#ifndef TCSASOFT
-#define TCSASOFT 0
-#endif /* TCSASOFT */
 
+     /*-----------------------------------------------*/
+     /* Make sure that shadows are removed. The files */
+     /* which they are shadowing are not removed as   */
+     /* they may contain information which will aid   */
+     /* debugging                                     */
+     /*-----------------------------------------------*/
 
-_PUBLIC int32_t pups_tty_echoing_off(FILE *in, struct termios *s)
+     #ifdef PTHREAD_SUPPORT
+     (void)pthread_mutex_lock(&ftab_mutex);
+     #endif /* PTHREAD_SUPPORT */
 
-{   int32_t tty_changed;
-    struct  termios t;
+     for(i=0; i<appl_max_files; ++i)
+     {  if(ftab[i].fshadow != (char *)NULL && strcmp(ftab[i].fshadow,"none") != 0)
+           (void)unlink(ftab[i].fshadow);
+     }
 
+     #ifdef PTHREAD_SUPPORT
+     (void)pthread_mutex_unlock(&ftab_mutex);
+     #endif /* PTHREAD_SUPPORT */
 
-    /*-----------------------------------*/
-    /* Turn echoing off if it is on now. */
-    /*-----------------------------------*/
+     (void)strdate(date);
+     if(appl_verbose == TRUE)
+     {
+        switch(signum)
+        {    case SIGSEGV:  (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGSEGV\n",date,appl_name,appl_pid,appl_host,appl_owner);
 
-    if(tcgetattr (fileno (in), &t) == 0)
-    {
+                            #ifdef SANITISE
+                            (void)fprintf(stderr,"%s %s (%d@%s:%s): have you specified -fsanitize and not linked against debug PUPS/P3 libraries?\n");
+                            (void)fflush(stderr);
+                            #endif /* SANITIZE */
 
-       /*-------------------*/
-       /* Save the old one. */
-       /*-------------------*/
+                            break;
 
-       *s = t;
+             case SIGFPE:   (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGFPE\n",date,appl_name,appl_pid,appl_host,appl_owner);
+                            break;
 
+             case SIGBUS:   (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGBUS\n",date,appl_name,appl_pid,appl_host,appl_owner);
+                            break;
 
-       /*-----------------*/
-       /* Tricky, tricky. */
-       /*-----------------*/
+             default:       break;
 
-       t.c_lflag &= ~(ECHO|ISIG);
-       tty_changed = (tcsetattr (fileno (in), TCSAFLUSH|TCSASOFT, &t) == 0);
+        }
     }
-    else
-       tty_changed = 0;
 
-    return(tty_changed);
-}
+    (void)fflush(stderr);
 
 
+    /*-------------------------------------------------*/
+    /* If we are error trapping wait to be attached to */
+    /* a debugger here                                 */
+    /*-------------------------------------------------*/
 
+    if(appl_etrap == TRUE)
+    {
 
-/*---------------------*/
-/* Turn tty echoing on */
-/*---------------------*/
+       /*----------------------------------------------------------*/
+       /* SIGTERM must be released so we can terminate the process */
+       /*----------------------------------------------------------*/
 
-_PUBLIC void pups_tty_echoing_on(FILE *in, int32_t tty_changed, struct termios s)
+       (void)sigfillset(&set);
 
-{   
+       (void)sigdelset(&set,SIGINT);
+       (void)sigdelset(&set,SIGTERM);
 
-    /*-------------------------------*/
-    /* Restore the original setting. */
-    /*-------------------------------*/
+       (void)pups_sigprocmask(SIG_SETMASK,&set,(sigset_t *)NULL);
 
-    if(tty_changed)
-       (void) tcsetattr (fileno (in), TCSAFLUSH|TCSASOFT, &s);
+       while(1)
+            (void)pups_usleep(100);
+    }
+
+    pups_exit(255);
 }
 
 
 
 
+/*--------------------------------------------------------------------------------*/
+/* PUPS kill function which notes state of signalled process. Processes which are */
+/* terminated or stopped return appropriate error condition                       */
+/*--------------------------------------------------------------------------------*/
 
-/*-------------------------------*.
-/* Execute command on local host */
-/*-------------------------------*/
-                                                  /*--------------------------*/
-_PUBLIC pid_t pups_lexec(const char      *shell,  /* Shell to execute comamnd */
-                         const char    *command,  /* Command to be executed   */
-                         const  int32_t    wait)  /* Wait action flag         */
-                                                  /*--------------------------*/
+_PUBLIC int32_t pups_statkill(const pid_t pid, const int32_t signum)
 
-{   pid_t   pid;
-    int32_t status;
+{   pid_t next_pid;
 
-    _BOOLEAN obituary = FALSE;
+    char  line[SSIZE]       = "",
+          procstatus[SSIZE] = "";
 
-    if(shell == (char *)NULL || command == (char *)NULL)
+    FILE  *procstream = (FILE *)NULL;
+
+    if(pid <= 0 || signum < 1 || signum > MAX_SIGS)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
+    (void)snprintf(procstatus,SSIZE,"/proc/%d/status",pid);
+    if(access(procstatus,F_OK) == (-1))
+       return(PUPS_TERMINATED);
 
-    /*-----------------------------------------------*/
-    /* Fork thread of control to create new process. */
-    /*-----------------------------------------------*/
-
-    if(wait & PUPS_OBITUARY)
-       obituary = TRUE;
-
-    /*--------------------*/
-    /* Child side of fork */
-    /*--------------------*/
-
-    if((pid = pups_fork(TRUE, obituary)) == 0)
-    {  uint32_t i;
-
-
-       /*-----------------------------------*/
-       /* Set effective and real user i.d's */
-       /*-----------------------------------*/
-
-       (void)setreuid(getuid(),getuid());
-
-
-       /*-------------------------*/
-       /* Clear any pending alarm */
-       /*-------------------------*/
+    procstream = fopen(procstatus,"r");
 
-       (void)pups_malarm(0);
 
+    /*------------------------------------------------*/
+    /* We have to search for the relevant line in the */
+    /* status file as this file is kernel dependent   */
+    /*------------------------------------------------*/
 
-       /*---------------------------------------*/
-       /* Restore all signals to default states */
-       /*---------------------------------------*/
+    do {    (void)fgets(line,SSIZE,procstream);
+       } while(strin(line,"State") == FALSE);
 
-       for(i=0; i<MAX_SIGS; ++i)
-          (void)pups_sighandle(i,"default",SIG_DFL, (sigset_t *)NULL);
+    (void)fclose(procstream);
 
+    if(strin(line,"T") == TRUE)
+    {  pups_set_errno(OK);
+       return(PUPS_STOPPED);
+    }
 
-       /*---------------------------------------------------*/
-       /* Extract argument list for execl call and overlay. */
-       /*---------------------------------------------------*/
+    #ifdef UTILIB_DEBUG
+    (void)fprintf(stderr,"UTILIB SENDING SIGNAL %d\n",signum);
+    (void)fflush(stderr);
+    #endif /* UTILIB_DEBUG */
 
-       if(execlp(shell,shell,"-c",command,(char *)0) == (-1))
-       {  pups_set_errno(ENOEXEC);
-          return(-1);
-       }
+    if(kill(pid,signum) == (-1))
+    {  pups_set_errno(OK);
+       return(PUPS_TERMINATED);
     }
 
+    pups_set_errno(OK);
+    return(PUPS_EXEC);
+}
 
-    /*----------------------------------------------------------------------------*/
-    /* Parent side of fork - return childs pid if we are not going to wait for it */
-    /* otherwise return the child's exit status.                                  */
-    /*----------------------------------------------------------------------------*/
 
-    else
-    {
 
-       (void)pups_set_child_name(pid,command);
 
-       if(wait == PUPS_WAIT_FOR_CHILD)
-       {  
+/*------------------------------------------------------------*/
+/* Open process descriptor (pidfd) for process. Returns (-1)  */
+/* with errno set to ENOSYS if pidfds are not supported       */
+/*------------------------------------------------------------*/
 
-          /*-----------------------------------*/
-          /* Wait for the child we have forked */
-          /*-----------------------------------*/
+_PUBLIC des_t pups_pidfd_open(const pid_t pid)
 
-          if(waitpid(pid,&status,0) == (-1))
-          {  pups_set_errno(ECHILD);
-             return(-1);
-          }
+{   
 
-          pups_set_errno(OK);
-          return(status);
-       }
+    #ifdef SYS_pidfd_open
+    des_t pidfd;
+    #endif /* SYS_pidfd_open */
 
-       pups_set_errno(OK);
-       return(pid);
+    if(pid <= 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
     }
 
+    #ifdef SYS_pidfd_open
+    if((pidfd = (des_t)syscall(SYS_pidfd_open,pid,0)) == (-1))
+       return(-1);
+
+    pups_set_errno(OK);
+    return(pidfd);
+    #else
     pups_set_errno(ENOSYS);
     return(-1);
+    #endif /* SYS_pidfd_open */
 }
 
 
 
 
+/*-----------------------------------------------------------*/
+/* Has process exited? A zombie has exited even though it    */
+/* can still be signalled (this is the fallback used when    */
+/* pidfds are not available)                                 */
+/*-----------------------------------------------------------*/
 
-#ifdef PSRP_AUTHENTICATE
-/*-------------------------------*/
-/* Check secure service password */
-/*-------------------------------*/
+_PRIVATE _BOOLEAN pid_exited(const pid_t pid)
 
-_PUBLIC _BOOLEAN pups_check_appl_password(const char *password)
+{   char procstat[SSIZE] = "",
+         line[SSIZE]     = "",
+         *state          = (char *)NULL;
 
-{
+    FILE *stream         = (FILE *)NULL;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(kill(pid,SIGALIVE) == (-1) && errno == ESRCH)
+       return(TRUE);
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_check_appl_password] attempt by non root thread to perform PUPS/P3 utility operation");
+    (void)snprintf(procstat,SSIZE,"/proc/%d/stat",pid);
+    if((stream = fopen(procstat,"r")) == (FILE *)NULL)
+       return(TRUE);
 
-    if(password == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    (void)fgets(line,SSIZE,stream);
+    (void)fclose(stream);
 
-    /*-----------------------------------------------*/
-    /* Check arguments if any are NULL simply return */
-    /*-----------------------------------------------*/
 
-    if(strcmp(appl_password,"notset") == 0)
-    {  pups_set_errno(OK);
-       return(TRUE);
-    }
+    /*----------------------------------------------*/
+    /* State follows the (bracketed) command name   */
+    /* which may itself contain spaces or brackets  */
+    /*----------------------------------------------*/
 
-    if(strncmp(password,appl_password,strlen(appl_password)-1) != 0)
-    {  pups_set_errno(OK);
-       return(FALSE);
-    }
+    if((state = strrchr(line,')')) != (char *)NULL && (state[2] == 'Z' || state[2] == 'X'))
+       return(TRUE);
 
-    pups_set_errno(OK);
-    return(TRUE);
+    return(FALSE);
 }
 
 
 
 
-/*-------------------*/
-/* Authenticate user */
-/*-------------------*/
+/*----------------------------------------*/
+/* Milliseconds elapsed since given time  */
+/*----------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_checkuser(const char *username, const char *password)
+_PRIVATE int64_t pid_elapsed(const struct timespec *start)
 
-{   struct passwd  *pwent = (struct passwd *)NULL;
+{   struct timespec now;
 
-    char salt[2]                 = "",
-         crypted_password[SSIZE] = "";
+    (void)clock_gettime(CLOCK_MONOTONIC,&now);
+    return((int64_t)(now.tv_sec - start->tv_sec)*1000 + (now.tv_nsec - start->tv_nsec)/1000000);
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Wait for process to exit. The caller blocks (on a pidfd) until   */
+/* the process exits or timeout (milliseconds) expires. A negative  */
+/* timeout waits indefinitely. Returns 0 if the process has exited  */
+/* and (-1) with errno set to ETIMEDOUT if it is still running.     */
+/* Note that the process is not reaped                              */
+/*------------------------------------------------------------------*/
 
+_PUBLIC int32_t pups_pid_wait(const pid_t pid, const int32_t timeout)
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+{   des_t           pidfd;
+    int32_t         ret,
+                    remaining = timeout;
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_checkuser] attempt by non root thread to perform PUPS/P3 utility operation");
+    struct pollfd   pfd;
+    struct timespec start;
 
-    if(username == (char *)NULL || password == (char *)NULL)
+    if(pid <= 0)
     {  pups_set_errno(EINVAL);
        return(-1);
     }
 
+    (void)clock_gettime(CLOCK_MONOTONIC,&start);
+    if((pidfd = pups_pidfd_open(pid)) == (-1))
+    {  if(errno == ESRCH)
+       {  pups_set_errno(OK);
+          return(0);
+       }
 
-    /*--------------------------*/
-    /* Authenticate remote user */
-    /*--------------------------*/
 
-    if((pwent = pups_getpwnam(username)) == (struct passwd *)NULL)
-    {  pups_set_errno(ESRCH);
-       return(FALSE);
+       /*-------------------------------------------*/
+       /* No pidfds - fall back to polling process  */
+       /*-------------------------------------------*/
+
+       while(pid_exited(pid) == FALSE)
+       {    if(timeout >= 0 && pid_elapsed(&start) >= timeout)
+            {  pups_set_errno(ETIMEDOUT);
+               return(-1);
+            }
+
+            (void)pups_usleep(1000);
+       }
+
+       pups_set_errno(OK);
+       return(0);
     }
 
 
-    /*-------------------------------------------*/
-    /* Crypt password using first two characters */
-    /* in password for "salt"                    */
-    /* Crypt password using first two characters */
-    /* in in encrypted password for "salt"       */
-    /*-------------------------------------------*/
+    /*---------------------------------------------------------*/
+    /* Pidfd becomes readable when process exits. Signals      */
+    /* (for example homeostat timers) interrupt the wait so we */
+    /* restart it with whatever is left of the timeout         */
+    /*---------------------------------------------------------*/
 
-    salt[0] = pwent->pw_passwd[0];
-    salt[1] = pwent->pw_passwd[1];
-    (void)strlcpy((char *)&crypted_password,(char *)crypt(password,salt),SSIZE);
+    pfd.fd     = pidfd;
+    pfd.events = POLLIN;
 
-    if(strcmp(pwent->pw_passwd,crypted_password) != 0)
-    {  pups_set_errno(EPERM);
-       return(FALSE);
+    while((ret = poll(&pfd,1,remaining)) == (-1) && errno == EINTR)
+    {    if(timeout >= 0 && (remaining = timeout - (int32_t)pid_elapsed(&start)) < 0)
+            remaining = 0;
+    }
+
+    (void)close(pidfd);
+
+    if(ret == 0)
+    {  pups_set_errno(ETIMEDOUT);
+       return(-1);
     }
+    else if(ret == (-1))
+       return(-1);
 
     pups_set_errno(OK);
-    return(TRUE);
+    return(0);
 }
 
 
 
 
-/*-----------------------------------------*/
-/* Check that application has password set */
-/*-----------------------------------------*/
+/*---------------------------------------------------------------*/
+/* Has watched process exited? Caller must hold pidwatch mutex   */
+/*---------------------------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_check_pass_set(void)
+_PRIVATE _BOOLEAN pidwatch_exited(const uint32_t slot)
 
-{   
+{   struct pollfd pfd;
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
+    if(pidwatch[slot].pidfd == (-1))
+       return(pid_exited(pidwatch[slot].pid));
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_check_pass_set] attempt by non root thread to perform PUPS/P3 utility operation");
+    pfd.fd     = pidwatch[slot].pidfd;
+    pfd.events = POLLIN;
 
-    pups_set_errno(OK);
-    if(strcmp(appl_password,"notset") == 0)
-       return(FALSE);
+    if(poll(&pfd,1,0) > 0)
+       return(TRUE);
 
-    return(TRUE);
+    return(FALSE);
 }
 
 
 
 
-/*---------------------*/
-/* Authenticate a user */
-/*---------------------*/
+/*---------------------------------------------------------------*/
+/* Release watch set slot (closing its pidfd also removes it     */
+/* from the epoll set). Caller must hold pidwatch mutex          */
+/*---------------------------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_getpass(const char *password_banner)
+_PRIVATE void pidwatch_release(const uint32_t slot)
 
-{   char pwd_file_name[SSIZE]         = "",
-         pups_password_banner[SSIZE]  = "";
+{   if(pidwatch[slot].pidfd != (-1))
+       (void)close(pidwatch[slot].pidfd);
 
+    pidwatch[slot].pid   = 0;
+    pidwatch[slot].pidfd = (-1);
+    --pidwatch_n;
+}
 
-    /*----------------------------------*/
-    /* Only the root thread can process */
-    /* PSRP requests                    */
-    /*----------------------------------*/
 
-    if(pupsthread_is_root_thread() == FALSE)
-       pups_error("[pups_getpass] attempt by non root thread to perform PUPS/P3 utility operation");
 
-    if(password_banner == (char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
 
+/*-------------------------------------------------------------------*/
+/* Add process to liveness watch set. Watched processes are reported */
+/* by pups_pid_watch_poll() when they exit. Watching a process which */
+/* is already in the set is not an error                             */
+/*-------------------------------------------------------------------*/
 
-    /*--------------------------------------------------------------*/
-    /* Check to see if we actually need to obtain an authentication */
-    /* token                                                        */
-    /*--------------------------------------------------------------*/
+_PUBLIC int32_t pups_pid_watch(const pid_t pid)
 
-    if(strcmp(appl_password,"notset") != 0)
-    {  pups_set_errno(OK);
-       return(TRUE);
-    }
+{   uint32_t i,
+             slot = PIDWATCH_SLOTS;
 
+    des_t    pidfd;
 
-    /*--------------------------------------------------------------*/
-    /* Search /tmp for an authorisation token for application owner */
-    /*--------------------------------------------------------------*/
+    if(pid <= 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-    (void)snprintf(pwd_file_name,SSIZE,"/tmp/auth.%s.tmp",appl_owner);
-    if(access(pwd_file_name,F_OK | R_OK | W_OK) == (-1))
-    {
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-       /*------------------------------------------------------*/
-       /* Can we get to a controlling tty to talk to our user? */
-       /*------------------------------------------------------*/
+    for(i=0; i<PIDWATCH_SLOTS; ++i)
+    {  if(pidwatch[i].pid == pid)
+       {  
 
-       if((isatty(0) == 1 || isatty(1) == 1 || isatty(2) == 1) && access(pwd_file_name,F_OK | R_OK | W_OK) == (-1))
-       {  int32_t indes = (-1);
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&pidwatch_mutex);
+          #endif /* PTHREAD_SUPPORT */
 
+          pups_set_errno(OK);
+          return(0);
+       }
+       else if(pidwatch[i].pid == 0 && slot == PIDWATCH_SLOTS)
+          slot = i;
+    }
 
-          /*-----------------------------------------------------------------*/
-          /* Is stdin indirected? If so we need to inverse indirect it so we */
-          /* can talk to our user                                            */ 
-          /*-----------------------------------------------------------------*/
 
-          if(isatty(0) == 0)
-          {  int32_t ttydes = (-1);
+    /*------------------------------------------------*/
+    /* Set is full - drop processes which have exited */
+    /* but which have not been collected yet          */
+    /*------------------------------------------------*/
 
-             #ifdef UTILIB_DEBUG
-             (void)fprintf(stderr,"pups_getpass [%d@%s] duplicating stdin (and saving intial descriptor)\n",getpid(),appl_host);
-             (void)fflush(stderr);
-             #endif /* UTILIB_DEBUG */
+    if(slot == PIDWATCH_SLOTS)
+    {  for(i=0; i<PIDWATCH_SLOTS; ++i)
+       {  if(pidwatch[i].pid != 0 && pidwatch_exited(i) == TRUE)
+          {  pidwatch_release(i);
 
-             indes  = dup(0);
+             if(slot == PIDWATCH_SLOTS)
+                slot = i;
           }
+       }
 
-          (void)snprintf(pups_password_banner,SSIZE,"PUPS %s [%s] login: ",password_banner,appl_host);
-          (void)strlcpy(appl_password,(char *)getpass(pups_password_banner),SSIZE);
-
+       if(slot == PIDWATCH_SLOTS)
+       {  
 
-          /*----------------------------*/
-          /* Check authentication token */
-          /*----------------------------*/
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&pidwatch_mutex);
+          #endif /* PTHREAD_SUPPORT */
 
-          if(pups_checkuser(appl_owner,appl_password) == FALSE)
-          {  (void)fprintf(stderr,"pups_getpass [%d@%s]: permission denied\n",getpid(),appl_name);
-             (void)fflush(stderr);
+          pups_set_errno(ENOSPC);
+          return(-1);
+       }
+    }
 
-             pups_set_errno(EPERM);
-             return(FALSE);
-          }
 
+    /*--------------------------------------------------------*/
+    /* If we cannot get a pidfd (or an epoll set) the process */
+    /* is still watched, but it is polled via /proc           */
+    /*--------------------------------------------------------*/
 
-          /*--------------------------------------------------*/
-          /* If we have had to inverse indirect restore stdin */
-          /* to its intial (e.g. indirected) state            */
-          /*--------------------------------------------------*/
+    if(pidwatch_epfd == (-1))
+       pidwatch_epfd = epoll_create1(EPOLL_CLOEXEC);
 
-          if(indes != (-1))
-          {  (void)dup2(indes,0);
-             (void)close(indes);
+    if((pidfd = pups_pidfd_open(pid)) == (-1) && errno == ESRCH)
+    {  
 
-             #ifdef DEBUG
-             (void)fprintf(stderr,"rfifod [%d@%s]: initial stdin descriptor restored (after password entry)\n",getpid(),appl_host);
-             (void)fflush(stderr);
-             #endif /* DEBUG */
-          }
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&pidwatch_mutex);
+       #endif /* PTHREAD_SUPPORT */
 
-          pups_set_errno(OK);
-          return(TRUE);
-       }
+       pups_set_errno(ESRCH);
+       return(-1);
     }
-    else
-    {  FILE *pwd_stream = (FILE *)NULL; 
+    else if(pidfd != (-1))
+    {  struct epoll_event event;
 
+       event.events   = EPOLLIN;
+       event.data.u32 = slot;
 
-       /*---------------------------------------------*/
-       /* Extract token from authorisation token file */
-       /*---------------------------------------------*/
+       if(pidwatch_epfd == (-1) || epoll_ctl(pidwatch_epfd,EPOLL_CTL_ADD,pidfd,&event) == (-1))
+       {  (void)close(pidfd);
+          pidfd = (-1);
+       }
+    }
 
-       pwd_stream = pups_fopen(pwd_file_name,"r",DEAD);
+    pidwatch[slot].pid   = pid;
+    pidwatch[slot].pidfd = pidfd;
+    ++pidwatch_n;
 
-       (void)fscanf(pwd_stream,"%s",appl_password);
-       (void)pups_fclose(pwd_stream);
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    pups_set_errno(OK);
+    return(0);
+}
 
-       /*----------------------------*/
-       /* Check authentication token */
-       /*----------------------------*/
 
-       if(pups_checkuser(appl_owner,appl_password) == FALSE)
-       {  (void)fprintf(stderr,"%d@%s: permission denied\n",appl_pid,appl_name);
-          (void)fflush(stderr);
 
-          pups_set_errno(EPERM);
-          return(FALSE);
-       }
 
-       pups_set_errno(OK);
-       return(TRUE);
-    }
+/*--------------------------------------------*/
+/* Remove process from liveness watch set     */
+/*--------------------------------------------*/
 
+_PUBLIC int32_t pups_pid_unwatch(const pid_t pid)
 
-    /*---------------------------------------*/
-    /* We cannot get an authentication token */
-    /*---------------------------------------*/
+{   uint32_t i;
 
-    pups_set_errno(EPERM);
-    return(FALSE);
-}
-#endif /* PSRP_AUTHENTICATE */
+    if(pid <= 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    for(i=0; i<PIDWATCH_SLOTS; ++i)
+    {  if(pidwatch[i].pid == pid)
+       {  pidwatch_release(i);
 
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&pidwatch_mutex);
+          #endif /* PTHREAD_SUPPORT */
 
-/*----------------------------------------*/
-/* Handler for SIGSEGV, SIGBUS and SIGFPE */
-/*----------------------------------------*/
+          pups_set_errno(OK);
+          return(0);
+       }
+    }
 
-_PRIVATE int32_t segbusfpe_handler(const int32_t signum)
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-{    uint32_t i;
+    pups_set_errno(ESRCH);
+    return(-1);
+}
 
-     if(signum < 1 || signum > MAX_SIGS)
-     {  pups_set_errno(EINVAL);
-        return(-1);
-     }
 
 
-     /*-----------------------------------------------*/
-     /* Make sure that shadows are removed. The files */
-     /* which they are shadowing are not removed as   */
-     /* they may contain information which will aid   */
-     /* debugging                                     */
-     /*-----------------------------------------------*/
 
-     #ifdef PTHREAD_SUPPORT
-     (void)pthread_mutex_lock(&ftab_mutex);
-     #endif /* PTHREAD_SUPPORT */
+/*---------------------------------------------------------------------*/
+/* Collect watched processes which have exited (up to max_exited of    */
+/* them). Collected processes are removed from the watch set. The      */
+/* caller blocks for up to timeout milliseconds (indefinitely if       */
+/* timeout is negative) if no watched process has exited yet. Returns  */
+/* the number of processes collected                                   */
+/*---------------------------------------------------------------------*/
 
-     for(i=0; i<appl_max_files; ++i)
-     {  if(ftab[i].fshadow != (char *)NULL && strcmp(ftab[i].fshadow,"none") != 0)
-           (void)unlink(ftab[i].fshadow);
-     }
+_PUBLIC int32_t pups_pid_watch_poll(pid_t *exited, const uint32_t max_exited, const int32_t timeout)
 
-     #ifdef PTHREAD_SUPPORT
-     (void)pthread_mutex_unlock(&ftab_mutex);
-     #endif /* PTHREAD_SUPPORT */
+{   uint32_t           i,
+                       slot;
 
-     (void)strdate(date);
-     if(appl_verbose == TRUE)
-     {
-        switch(signum)
-        {    case SIGSEGV:  (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGSEGV\n",date,appl_name,appl_pid,appl_host,appl_owner);
+    int32_t            n_events,
+                       n_exited = 0;
 
-                            #ifdef SANITISE
-                            (void)fprintf(stderr,"%s %s (%d@%s:%s): have you specified -fsanitize and not linked against debug PUPS/P3 libraries?\n");
-                            (void)fflush(stderr);
-                            #endif /* SANITIZE */
+    des_t              epfd;
+    struct epoll_event events[PIDWATCH_EVENTS];
 
-                            break;
+    if(exited == (pid_t *)NULL || max_exited == 0)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
 
-             case SIGFPE:   (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGFPE\n",date,appl_name,appl_pid,appl_host,appl_owner);
-                            break;
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-             case SIGBUS:   (void)fprintf(stderr,"%s %s (%d@%s:%s): SIGBUS\n",date,appl_name,appl_pid,appl_host,appl_owner);
-                            break;
+    if(pidwatch_n == 0)
+    {  
 
-             default:       break;
+       #ifdef PTHREAD_SUPPORT
+       (void)pthread_mutex_unlock(&pidwatch_mutex);
+       #endif /* PTHREAD_SUPPORT */
 
-        }
+       pups_set_errno(OK);
+       return(0);
     }
 
-    (void)fflush(stderr);
 
+    /*--------------------------------------------*/
+    /* Processes without pidfds are polled first  */
+    /*--------------------------------------------*/
 
-    /*-------------------------------------------------*/
-    /* If we are error trapping wait to be attached to */
-    /* a debugger here                                 */
-    /*-------------------------------------------------*/
+    for(i=0; i<PIDWATCH_SLOTS && (uint32_t)n_exited < max_exited; ++i)
+    {  if(pidwatch[i].pid != 0 && pidwatch[i].pidfd == (-1) && pid_exited(pidwatch[i].pid) == TRUE)
+       {  exited[n_exited++] = pidwatch[i].pid;
+          pidwatch_release(i);
+       }
+    }
 
-    if(appl_etrap == TRUE)
-    {
+    epfd = pidwatch_epfd;
 
-       /*----------------------------------------------------------*/
-       /* SIGTERM must be released so we can terminate the process */
-       /*----------------------------------------------------------*/
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-       (void)sigfillset(&set);
+    if(n_exited > 0 || epfd == (-1))
+    {  pups_set_errno(OK);
+       return(n_exited);
+    }
 
-       (void)sigdelset(&set,SIGINT);
-       (void)sigdelset(&set,SIGTERM);
 
-       (void)pups_sigprocmask(SIG_SETMASK,&set,(sigset_t *)NULL);
+    /*----------------------------------------------------------*/
+    /* Wait on epoll set. We do not hold the mutex while we are */
+    /* waiting so a slot may have been reused by the time we    */
+    /* look at it - so check (again) that its process exited    */
+    /*----------------------------------------------------------*/
 
-       while(1)
-            (void)pups_usleep(100);
+    if((n_events = epoll_wait(epfd,events,PIDWATCH_EVENTS,timeout)) <= 0)
+    {  pups_set_errno(OK);
+       return(0);
     }
 
-    pups_exit(255);
-}
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    for(i=0; i<(uint32_t)n_events && (uint32_t)n_exited < max_exited; ++i)
+    {  slot = events[i].data.u32;
 
+       if(pidwatch[slot].pid != 0 && pidwatch[slot].pidfd != (-1) && pidwatch_exited(slot) == TRUE)
+       {  exited[n_exited++] = pidwatch[slot].pid;
+          pidwatch_release(slot);
+       }
+    }
 
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&pidwatch_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-/*--------------------------------------------------------------------------------*/
-/* PUPS kill function which notes state of signalled process. Processes which are */
-/* terminated or stopped return appropriate error condition                       */
-/*--------------------------------------------------------------------------------*/
+    pups_set_errno(OK);
+    return(n_exited);
+}
 
-_PUBLIC int32_t pups_statkill(const pid_t pid, const int32_t signum)
 
-{   pid_t next_pid;
 
-    char  line[SSIZE]       = "",
-          procstatus[SSIZE] = "";
 
-    FILE  *procstream = (FILE *)NULL;
+/*------------------------------------------------------------------*/
+/* Reap child which has exited. This catches children whose exit    */
+/* was not seen by chld_handler (for example if SIGCHLD was lost).  */
+/* Children are not reaped if automatic child management is off as  */
+/* someone else is waiting for them                                 */
+/*------------------------------------------------------------------*/
 
-    if(pid <= 0 || signum < 1 || signum > MAX_SIGS)
+_PUBLIC _BOOLEAN pups_reap_child(const pid_t pid)
+
+{   uint32_t i;
+    int32_t  status;
+
+    if(pid <= 0)
     {  pups_set_errno(EINVAL);
-       return(-1);
+       return(FALSE);
     }
 
-    (void)snprintf(procstatus,SSIZE,"/proc/%d/status",pid);
-    if(access(procstatus,F_OK) == (-1))
-       return(PUPS_TERMINATED);
+    if(auto_child == FALSE)
+    {  pups_set_errno(EBUSY);
+       return(FALSE);
+    }
 
-    procstream = fopen(procstatus,"r");
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&pups_fork_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
+    for(i=0; i<(uint32_t)appl_max_child; ++i)
+    {  if(chtab[i].pid == pid)
+       {  if(waitpid(pid,&status,WNOHANG) != pid)
+             break;
 
-    /*------------------------------------------------*/
-    /* We have to search for the relevant line in the */
-    /* status file as this file is kernel dependent   */
-    /*------------------------------------------------*/
+          if(appl_verbose == TRUE && chtab[i].obituary == TRUE)
+          {  (void)strdate(date);
+             (void)fprintf(stderr,"%s %s(%d@%s): [pups_reap_child] child process %d (%s) has exited\n",
+                                                date,appl_name,appl_pid,appl_host,pid,chtab[i].name);
+             (void)fflush(stderr);
+          }
 
-    do {    (void)fgets(line,SSIZE,procstream);
-       } while(strin(line,"State") == FALSE);
+          chtab[i].pid = (-1);
+          (void)strlcpy(chtab[i].name,"",SSIZE);
+          --n_children;
 
-    (void)fclose(procstream);
+          #ifdef PTHREAD_SUPPORT
+          (void)pthread_mutex_unlock(&pups_fork_mutex);
+          #endif /* PTHREAD_SUPPORT */
 
-    if(strin(line,"T") == TRUE)
-    {  pups_set_errno(OK);
-       return(PUPS_STOPPED);
+          pups_set_errno(OK);
+          return(TRUE);
+       }
     }
 
-    #ifdef UTILIB_DEBUG
-    (void)fprintf(stderr,"UTILIB SENDING SIGNAL %d\n",signum);
-    (void)fflush(stderr);
-    #endif /* UTILIB_DEBUG */
-
-    if(kill(pid,signum) == (-1))
-    {  pups_set_errno(OK);
-       return(PUPS_TERMINATED);
-    }
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&pups_fork_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    pups_set_errno(OK);
-    return(PUPS_EXEC);
+    pups_set_errno(ESRCH);
+    return(FALSE);
 }
 
 
@@ -17812,15 +19140,29 @@ _PUBLIC FTYPE pups_get_load_average(const int32_t which_load_average)
 
     FTYPE l_1,
           l_2,
-          l_3;
+          l_3,
+          loadavg[3];
 
-    if((stream = fopen("/proc/loadavg","r")) == (FILE *)NULL)
-    {  pups_set_errno(EBADF);
-       return(-1.0);
+
+    /*-------------------------------------------------*/
+    /* Use load averages published by cpuload if it is */
+    /* running                                         */
+    /*-------------------------------------------------*/
+
+    if(cpustat_read(CPUSTAT_AGGREGATE,CPUSTAT_INSTANT,(FTYPE *)NULL,loadavg) == TRUE)
+    {  l_1 = loadavg[0];
+       l_2 = loadavg[1];
+       l_3 = loadavg[2];
     }
+    else
+    {  if((stream = fopen("/proc/loadavg","r")) == (FILE *)NULL)
+       {  pups_set_errno(EBADF);
+          return(-1.0);
+       }
 
-    (void)fscanf(stream,"%F%F%F",&l_1,&l_2,&l_3);
-    (void)fclose(stream);
+       (void)fscanf(stream,"%F%F%F",&l_1,&l_2,&l_3);
+       (void)fclose(stream);
+    }
 
     switch(which_load_average)
     {     case LOAD_AVERAGE_1: pups_set_errno(OK);
@@ -17970,7 +19312,7 @@ _PRIVATE int32_t ssave_handler(const int32_t signum)
      /* Reschedule timers */
      /*-------------------*/
 
-     (void)pups_malarm(vitimer_quantum);
+     vt_rearm();
      return(0);
 }
 #endif /* CRIU_SUPPORT */
@@ -18167,6 +19509,16 @@ _PUBLIC int32_t pups_clear_vitimer(const uint32_t t_index)
        return(-1);
     } 
 
+    #ifdef PTHREAD_SUPPORT
+    if(vt_wheel_threaded == TRUE)
+    {  sigset_t old_set;
+
+       vt_wheel_lock(&old_set);
+       vt_wheel_cancel(t_index);
+       vt_wheel_unlock(&old_set);
+    }
+    #endif /* PTHREAD_SUPPORT */
+
     vttab[t_index].priority        = 0;
     vttab[t_index].mode            = VT_NONE;
     vttab[t_index].prescaler       = 0;
@@ -18587,8 +19939,7 @@ _PUBLIC pid_t pups_process_homeostat_enable(const _BOOLEAN wait_if_damaged)
     if(appl_verbose == TRUE)
        save_appl_verbose = appl_verbose;
 
-    while(kill(appl_ppid,SIGALIVE) == 0)
-         pups_usleep(1000);
+    (void)pups_pid_wait(appl_ppid,(-1));
 
 
     /*--------------------------------------------------------*/
@@ -18617,7 +19968,7 @@ _PUBLIC pid_t pups_process_homeostat_enable(const _BOOLEAN wait_if_damaged)
     /*------------------------*/
 
     if(vitimer_quantum > 0)
-       (void)pups_malarm(vitimer_quantum);
+       vt_rearm();
 
 
     /*----------------------------------------------*/
@@ -20644,111 +21995,334 @@ _PUBLIC _BOOLEAN pups_is_foreground(void)
 
 
 
-/*--------------------------------*/
-/* Check if process in background */ 
-/*--------------------------------*/
+/*--------------------------------*/
+/* Check if process in background */ 
+/*--------------------------------*/
+
+_PUBLIC _BOOLEAN pups_is_background(void)
+
+{   if(tcgetpgrp(0) == getpgrp())
+       return(FALSE);
+
+    return(TRUE);
+}
+
+
+
+
+/*---------------------------------*/
+/* Is command installed on system? */
+/*---------------------------------*/
+
+_PUBLIC _BOOLEAN pups_cmd_installed(const char *command)
+
+{   char line[SSIZE]        = "",
+         pstream_cmd[SSIZE] = "";
+
+    FILE *pstream = (FILE *)NULL;
+
+    if(command == (const char *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    (void)snprintf(pstream_cmd,SSIZE,"which %s",command);
+    if((pstream = popen(pstream_cmd,"r")) == (FILE *)NULL)
+    {  pups_set_errno(ENOEXEC);
+       return(-1);
+    }
+
+    (void)fgets(line,SSIZE,pstream); 
+    (void)pclose(pstream);
+  
+    pups_set_errno(OK); 
+    if(strin(line,"Command not found") == TRUE)
+       return(FALSE);
+ 
+    return(TRUE); 
+}
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Attach shared CPU utilisation table. If cpuload has been  */
+/* restarted (the table has a new inode) we attach the new   */
+/* table. Caller must hold cpustat mutex                     */
+/*-----------------------------------------------------------*/
+
+_PRIVATE cpustat_type *cpustat_attach(void)
+
+{   des_t        fdes;
+    cpustat_type *table = (cpustat_type *)NULL;
+    struct stat  buf;
+
+    if((fdes = open(CPUSTAT_PATH,O_RDONLY | O_CLOEXEC)) == (-1))
+       return((cpustat_type *)NULL);
+
+    /*---------------------------------------------------*/
+    /* Table must have been published by us (or root)    */
+    /* and must not be writable by anyone else           */
+    /*---------------------------------------------------*/
+
+    if(fstat(fdes,&buf) == (-1)                     ||
+       (buf.st_uid != 0 && buf.st_uid != getuid())  ||
+       (buf.st_mode & 022) != 0                     ||
+       (size_t)buf.st_size < sizeof(cpustat_type)    )
+    {  (void)close(fdes);
+       return((cpustat_type *)NULL);
+    }
+
+
+    /*-----------------------------------*/
+    /* Already attached to current table */
+    /*-----------------------------------*/
+
+    if(cpustat_table != (cpustat_type *)NULL && buf.st_ino == cpustat_ino)
+    {  (void)close(fdes);
+       return(cpustat_table);
+    }
+
+    table = (cpustat_type *)mmap((void *)NULL,sizeof(cpustat_type),PROT_READ,MAP_SHARED,fdes,0);
+    (void)close(fdes);
+
+    if((void *)table == MAP_FAILED)
+       return((cpustat_type *)NULL);
+
+    if(cpustat_table != (cpustat_type *)NULL)
+       (void)munmap((void *)cpustat_table,sizeof(cpustat_type));
+
+    cpustat_table = table;
+    cpustat_ino   = buf.st_ino;
+
+    return(cpustat_table);
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Read CPU utilisation (over window) and load averages from  */
+/* shared table. Returns FALSE if cpuload is not running (or  */
+/* has not updated the table for several sample periods)      */
+/*------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN cpustat_read(const int32_t cpu, const int32_t window, FTYPE *utilisation, FTYPE *loadavg)
+
+{   uint32_t     i,
+                 seq,
+                 spins,
+                 retries;
+    int64_t      updated,
+                 stale;
+    uint32_t     period,
+                 n_cpus;
+    float        value,
+                 l[3];
+    _BOOLEAN     ret        = FALSE,
+                 consistent = FALSE;
+    cpustat_type *table     = (cpustat_type *)NULL;
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&cpustat_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    if((table = cpustat_table) == (cpustat_type *)NULL)
+       table = cpustat_attach();
+
+    for(retries=0; table != (cpustat_type *)NULL && retries<2; ++retries)
+    {
+
+       /*------------------------------------------------*/
+       /* Copy what we need (retrying if cpuload updates */
+       /* the table while we are copying it)             */
+       /*------------------------------------------------*/
+
+       consistent = FALSE;
+       for(spins=0; spins<CPUSTAT_MAX_SPINS; ++spins)
+       {  if((seq = __atomic_load_n(&table->seq,__ATOMIC_ACQUIRE)) & 1)
+          {  (void)sched_yield();
+             continue;
+          }
+
+          updated = table->updated;
+          period  = table->period;
+          n_cpus  = table->n_cpus;
+
+          if(cpu == CPUSTAT_AGGREGATE)
+             value = table->aggregate[window];
+          else if((uint32_t)cpu < n_cpus && cpu < CPUSTAT_MAX_CPUS)
+             value = table->cpu[cpu][window];
+          else
+             value = (-1.0);
+
+          for(i=0; i<3; ++i)
+             l[i] = table->loadavg[i];
+
+          __atomic_thread_fence(__ATOMIC_ACQUIRE);
+          if(__atomic_load_n(&table->seq,__ATOMIC_RELAXED) == seq)
+          {  consistent = TRUE;
+             break;
+          }
+       }
+
+
+       /*-------------------------------------------------*/
+       /* Publisher died (or stalled) mid update -- our   */
+       /* caller falls back to sampling /proc itself      */
+       /*-------------------------------------------------*/
+
+       if(consistent == FALSE)
+          break;
+
+
+       /*--------------------------------------------------*/
+       /* Table is fresh if it was updated within the last */
+       /* few sample periods                               */
+       /*--------------------------------------------------*/
+
+       stale = 3*(int64_t)period/1000 + 2;
+       if(__atomic_load_n(&table->magic,__ATOMIC_RELAXED) == CPUSTAT_MAGIC && (int64_t)time((time_t *)NULL) - updated <= stale)
+       {  if(utilisation != (FTYPE *)NULL)
+             *utilisation = (FTYPE)value;
+
+          if(loadavg != (FTYPE *)NULL)
+          {  for(i=0; i<3; ++i)
+                loadavg[i] = (FTYPE)l[i];
+          }
+
+          if(value >= 0.0)
+             ret = TRUE;
+
+          break;
+       }
+
+
+       /*--------------------------------------------*/
+       /* Stale table -- cpuload may have restarted  */
+       /* and published a new one                    */
+       /*--------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_is_background(void)
+       else if((table = cpustat_attach()) == (cpustat_type *)NULL)
+          break;
+    }
 
-{   if(tcgetpgrp(0) == getpgrp())
-       return(FALSE);
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&cpustat_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    return(TRUE);
+    return(ret);
 }
 
 
 
 
-/*---------------------------------*/
-/* Is command installed on system? */
-/*---------------------------------*/
+/*-----------------------------------------------------------*/
+/* Sample (aggregate) CPU utilisation from /proc/stat. This  */
+/* is utilisation since the last call (or since boot on the  */
+/* first call)                                               */
+/*-----------------------------------------------------------*/
 
-_PUBLIC _BOOLEAN pups_cmd_installed(const char *command)
+_PRIVATE FTYPE cpustat_local(void)
+
+{   FILE     *stream     = (FILE *)NULL;
+    uint64_t user        = 0,
+             nice        = 0,
+             system      = 0,
+             idle        = 0,
+             iowait      = 0,
+             irq         = 0,
+             softirq     = 0,
+             steal       = 0,
+             total,
+             busy;
+    FTYPE    utilisation = 0.0;
+
+    if((stream = fopen("/proc/stat","r")) == (FILE *)NULL)
+       return(-1.0);
 
-{   char line[SSIZE]        = "",
-         pstream_cmd[SSIZE] = "";
+    if(fscanf(stream,"cpu %" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64 "%" SCNu64,
+                                          &user,&nice,&system,&idle,&iowait,&irq,&softirq,&steal) < 4)
+    {  (void)fclose(stream);
+       return(-1.0);
+    }
 
-    FILE *pstream = (FILE *)NULL;
+    (void)fclose(stream);
 
-    if(command == (const char *)NULL)
-    {  pups_set_errno(EINVAL);
-       return(-1);
-    }
+    total = user + nice + system + idle + iowait + irq + softirq + steal;
+    busy  = total - idle - iowait;
 
-    (void)snprintf(pstream_cmd,SSIZE,"which %s",command);
-    if((pstream = popen(pstream_cmd,"r")) == (FILE *)NULL)
-    {  pups_set_errno(ENOEXEC);
-       return(-1);
-    }
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_lock(&cpustat_mutex);
+    #endif /* PTHREAD_SUPPORT */
 
-    (void)fgets(line,SSIZE,pstream); 
-    (void)pclose(pstream);
-  
-    pups_set_errno(OK); 
-    if(strin(line,"Command not found") == TRUE)
-       return(FALSE);
- 
-    return(TRUE); 
+    if(total > cpustat_total && busy >= cpustat_busy)
+       utilisation = 100.0*(FTYPE)(busy - cpustat_busy)/(FTYPE)(total - cpustat_total);
+
+    cpustat_total = total;
+    cpustat_busy  = busy;
+
+    #ifdef PTHREAD_SUPPORT
+    (void)pthread_mutex_unlock(&cpustat_mutex);
+    #endif /* PTHREAD_SUPPORT */
+
+    return(utilisation);
 }
 
 
 
 
-/*---------------------*/
-/* Get CPU utilisation */
-/*---------------------*/
+/*---------------------------------------------------------*/
+/* Get CPU utilisation. This is the (aggregate) short      */
+/* window utilisation published by cpuload if it is        */
+/* running, otherwise we sample /proc/stat ourselves       */
+/*---------------------------------------------------------*/
 
 _PUBLIC FTYPE pups_cpu_utilisation(void)
 
-{    char  line[SSIZE]         = "",
-           pstream_cmd[SSIZE]  = "";
-     FILE  *pstream            = (FILE *)NULL;
-     FTYPE utilisation         = 0.0;
+{    FTYPE utilisation = 0.0;
 
-     /*----------------------------------*/
-     /* Is the mpstat command installed? */
-     /*----------------------------------*/
-
-     if(pups_cmd_installed("mpstat") == FALSE)
-     {  pups_set_errno(ESRCH);
-        return(-1.0);
+     if(cpustat_read(CPUSTAT_AGGREGATE,CPUSTAT_SHORT,&utilisation,(FTYPE *)NULL) == FALSE)
+     {  if((utilisation = cpustat_local()) < 0.0)
+        {  pups_set_errno(EINVAL);
+           return(-1.0);
+        }
      }
 
-     (void)snprintf(pstream_cmd,SSIZE,"mpstat | tail -1 | awk '{print $11}'");
+     pups_set_errno(OK);
+     return(utilisation);
+}
 
 
-     /*--------------------------*/
-     /* Find the CPU utilisation */
-     /*--------------------------*/
 
-     if((pstream = popen(pstream_cmd,"r")) == (FILE *)NULL)
-     {   pups_set_errno(EINVAL);
-         return(-1.0);
-     } 
 
-     (void)fgets(line,SSIZE,pstream);
-     (void)pclose(pstream);
+/*---------------------------------------------------------*/
+/* Get CPU utilisation for cpu (or CPUSTAT_AGGREGATE) over */
+/* window (CPUSTAT_INSTANT, CPUSTAT_SHORT or CPUSTAT_LONG) */
+/*---------------------------------------------------------*/
 
+_PUBLIC FTYPE pups_cpu_utilisation_window(const int32_t cpu, const int32_t window)
 
-     /*-----------------------------*/
-     /* Returns idle CPU percentage */
-     /*-----------------------------*/
+{    FTYPE utilisation = 0.0;
 
-     if(sscanf(line,"%F",&utilisation) != 1)
-     {   pups_set_errno(EINVAL);
-         return(-1.0);
+     if(cpu < CPUSTAT_AGGREGATE || cpu >= CPUSTAT_MAX_CPUS || window < 0 || window >= CPUSTAT_WINDOWS)
+     {  pups_set_errno(EINVAL);
+        return(-1.0);
      }
 
 
-     /*-----------------------------*/
-     /* Get occupied CPU percentage */
-     /*-----------------------------*/
+     /*--------------------------------------------*/
+     /* Per CPU and windowed utilisation are only  */
+     /* available if cpuload is running            */
+     /*--------------------------------------------*/
 
-     else
-        utilisation = 100.0 - utilisation;
+     if(cpustat_read(cpu,window,&utilisation,(FTYPE *)NULL) == FALSE)
+     {  pups_set_errno(ESRCH);
+        return(-1.0);
+     }
 
      pups_set_errno(OK);
-     return(utilisation);    
+     return(utilisation);
 }
 
 
@@ -21356,7 +22930,7 @@ _PRIVATE  int32_t ssave_homeostat(void *t_info, char *args)
        /* Reschedule timers */
        /*-------------------*/
 
-       (void)pups_malarm(vitimer_quantum);
+       vt_rearm();
     }
 
     return(0);
@@ -21670,7 +23244,7 @@ _PUBLIC int32_t pups_show_softdogstatus(const FILE *stream)
     /*-----------------------------*/
 
     if (appl_softdog_enabled == TRUE)
-    {  (void)fprintf(stream,"\n    softdog: software watchdog is enabled (pid: %d timeout: %d seconds)\n\n",appl_softdog_pid,appl_softdog_timeout);
+    {  (void)fprintf(stream,"\n    softdog: software watchdog is enabled (daemon pid: %d timeout: %d seconds)\n\n",appl_softdog_pid,appl_softdog_timeout);
        (void)fflush(stream);
     }
 
@@ -21690,26 +23264,271 @@ _PUBLIC int32_t pups_show_softdogstatus(const FILE *stream)
 
 
 
-/*--------------------------------------*/
-/* Perioidically kick software watchdog */
-/*--------------------------------------*/
+/*-----------------------------------------------*/
+/* Current time (milliseconds). The softdog      */
+/* daemon uses the same clock                    */
+/*-----------------------------------------------*/
+
+_PRIVATE uint64_t softdog_now(void)
+
+{   struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC,&now);
+    return((uint64_t)now.tv_sec*1000 + (uint64_t)now.tv_nsec/1000000);
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Attach (per user) shared watchdog table. The table is    */
+/* created by whichever of us (or the softdog daemon) gets  */
+/* there first                                              */
+/*----------------------------------------------------------*/
+
+_PRIVATE softdog_table_type *softdog_attach(void)
+
+{   char        table_name[SSIZE] = "";
+    struct stat buf;
+    void        *table            = (void *)NULL;
+
+    if(softdog_table != (softdog_table_type *)NULL)
+       return(softdog_table);
+
+    (void)snprintf(table_name,SSIZE,SOFTDOG_PATH_FMT,getuid());
+    if((softdog_des = open(table_name,O_RDWR | O_CREAT | O_CLOEXEC,0600)) == (-1))
+       return((softdog_table_type *)NULL);
+
+    if(fstat(softdog_des,&buf) == (-1)                                                                        ||
+       buf.st_uid != getuid()                                                                                ||
+       (buf.st_mode & 077) != 0                                                                              ||
+       ((size_t)buf.st_size < sizeof(softdog_table_type) && ftruncate(softdog_des,sizeof(softdog_table_type)) == (-1)) ||
+       (table = mmap((void *)NULL,sizeof(softdog_table_type),PROT_READ | PROT_WRITE,MAP_SHARED,softdog_des,0)) == MAP_FAILED)
+    {  (void)close(softdog_des);
+       softdog_des = (-1);
+
+       return((softdog_table_type *)NULL);
+    }
+
+    softdog_table = (softdog_table_type *)table;
+    return(softdog_table);
+}
+
+
+
+
+/*------------------------------------------------------*/
+/* Is softdog daemon running? The daemon holds the      */
+/* table lock for as long as it runs, so if we can take */
+/* it (via a separate open) there is no daemon. Unlike  */
+/* kill(pid,0) this cannot be fooled by a recycled PID  */
+/*------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN softdog_daemon_alive(void)
+
+{   des_t fdes;
+    char  table_name[SSIZE] = "";
+
+    (void)snprintf(table_name,SSIZE,SOFTDOG_PATH_FMT,getuid());
+    if((fdes = open(table_name,O_RDONLY | O_CLOEXEC)) == (-1))
+       return(FALSE);
+
+    if(flock(fdes,LOCK_EX | LOCK_NB) == 0)
+    {  (void)flock(fdes,LOCK_UN);
+       (void)close(fdes);
+
+       return(FALSE);
+    }
+
+    (void)close(fdes);
+    return(TRUE);
+}
+
+
+
+
+/*---------------------------------------------------------------*/
+/* Start softdog daemon. It is detached (double fork) so that it */
+/* is not one of our children and outlives us. If another        */
+/* process starts a daemon at the same time only one of them     */
+/* gets the table lock - the other exits                         */
+/*---------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN softdog_daemon_start(void)
+
+{   pid_t           child_pid;
+    struct timespec start;
+
+    if(softdog_daemon_alive() == TRUE)
+       return(TRUE);
+
+    if((child_pid = fork()) == 0)
+    {  (void)setsid();
+
+       if(fork() == 0)
+       {  sigset_t empty_set;
+
+
+          /*----------------------------------------*/
+          /* Do not pass our signal mask on to the  */
+          /* daemon                                 */
+          /*----------------------------------------*/
+
+          (void)sigemptyset(&empty_set);
+          (void)sigprocmask(SIG_SETMASK,&empty_set,(sigset_t *)NULL);
+
+          (void)execlp("softdog","softdog","-daemon",(char *)NULL);
+          _exit(255);
+       }
+
+       _exit(0);
+    }
+    else if(child_pid == (-1))
+       return(FALSE);
+
+    (void)waitpid(child_pid,(int *)NULL,0);
+
+
+    /*--------------------------------------------*/
+    /* Wait (up to two seconds) for daemon to     */
+    /* publish itself in table                    */
+    /*--------------------------------------------*/
+
+    (void)clock_gettime(CLOCK_MONOTONIC,&start);
+    while(softdog_daemon_alive() == FALSE)
+    {    if(pid_elapsed(&start) > 2000)
+            return(FALSE);
+
+         (void)usleep(10000);
+    }
+
+    return(TRUE);
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Ring doorbell. The softdog daemon sees the write (via    */
+/* inotify) and rescans the table                           */
+/*----------------------------------------------------------*/
+
+_PRIVATE void softdog_doorbell(void)
+
+{   uint32_t bell = __atomic_add_fetch(&softdog_table->doorbell,1,__ATOMIC_ACQ_REL);
+
+    (void)pwrite(softdog_des,&bell,sizeof(uint32_t),offsetof(softdog_table_type,doorbell));
+}
+
+
+
+
+/*------------------------------------------------------------*/
+/* Register with softdog daemon. We claim a free slot in the  */
+/* shared table, fill it in and then make it active           */
+/*------------------------------------------------------------*/
+
+_PRIVATE int32_t softdog_register(const uint32_t timeout)
+
+{   uint32_t i,
+             state;
+
+    for(i=0; i<SOFTDOG_SLOTS; ++i)
+    {  state = SOFTDOG_FREE;
+
+       if(__atomic_compare_exchange_n(&softdog_table->slot[i].state,&state,SOFTDOG_CLAIMED,FALSE,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE))
+       {  softdog_table->slot[i].pid     = getpid();
+          softdog_table->slot[i].pgrp    = (-1);
+          softdog_table->slot[i].timeout = timeout*1000;
+          softdog_table->slot[i].kick    = softdog_now();
+
+          __atomic_store_n(&softdog_table->slot[i].state,SOFTDOG_ACTIVE,__ATOMIC_RELEASE);
+          softdog_doorbell();
+
+          softdog_slot  = i;
+          softdog_owner = getpid();
+
+          return(0);
+       }
+    }
+
+    return(-1);
+}
+
+
+
+
+/*---------------------------------------------*/
+/* Release slot (softdog daemon frees it)      */
+/*---------------------------------------------*/
+
+_PRIVATE void softdog_release(void)
+
+{   uint32_t state = SOFTDOG_ACTIVE;
+
+    if(softdog_slot == (-1) || softdog_owner != getpid())
+       return;
+
+    if(softdog_table->slot[softdog_slot].pid == softdog_owner)
+    {  (void)__atomic_compare_exchange_n(&softdog_table->slot[softdog_slot].state,&state,SOFTDOG_RELEASED,FALSE,
+                                                                                 __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE);
+       softdog_doorbell();
+    }
+
+    softdog_slot  = (-1);
+    softdog_owner = (-1);
+}
+
+
+
+
+/*---------------------------------------------------------*/
+/* Perioidically kick software watchdog. A kick is a store */
+/* of the current time into our slot (no signal is sent)   */
+/*---------------------------------------------------------*/
 
 _PRIVATE int32_t softdog_homeostat(void *t_info, const char *args)
 
 {
 
+    /*---------------------------------------------*/
+    /* Watchdog belongs to parent (we are a child  */
+    /* which has inherited homeostat)              */
+    /*---------------------------------------------*/
+
+    if(softdog_owner != getpid())
+       return(0);
+
+
     /*------------------------*/
     /* Kick software watchdog */
     /*------------------------*/
 
-    if (kill(appl_softdog_pid,SIGCONT) != 0)
-    {  
-	    
-       /*-------------------------------------*/	
-       /* Software watchdog lost - restart it */
-       /*-------------------------------------*/
+    if(softdog_slot != (-1)                                                                                         &&
+       softdog_table->slot[softdog_slot].pid == softdog_owner                                                       &&
+       __atomic_load_n(&softdog_table->slot[softdog_slot].state,__ATOMIC_ACQUIRE) == SOFTDOG_ACTIVE)
+       __atomic_store_n(&softdog_table->slot[softdog_slot].kick,softdog_now(),__ATOMIC_RELEASE);
+
 
-       (void)pups_start_softdog(appl_softdog_timeout);
+    /*----------------------------------------------*/
+    /* Slot lost - register with softdog daemon     */
+    /* again                                        */
+    /*----------------------------------------------*/
+
+    else
+    {  softdog_slot = (-1);
+       (void)softdog_register(appl_softdog_timeout);
+    }
+
+
+    /*------------------------------------------------*/
+    /* Software watchdog lost - restart it. The new   */
+    /* daemon picks up our (active) slot              */
+    /*------------------------------------------------*/
+
+    if(softdog_daemon_alive() == FALSE)
+    {  (void)softdog_daemon_start();
+       appl_softdog_pid = __atomic_load_n(&softdog_table->daemon,__ATOMIC_ACQUIRE);
 
        if(appl_verbose == TRUE)
        {  (void)strdate(date);
@@ -21724,66 +23543,57 @@ _PRIVATE int32_t softdog_homeostat(void *t_info, const char *args)
 
 
 
-/*-------------------------*/
-/* Start software watchdog */
-/*-------------------------*/
+/*-----------------------------------------------------------*/
+/* Start software watchdog. One softdog daemon (per user)    */
+/* watches every registered process, starting the daemon if  */
+/* it is not already running                                 */
+/*-----------------------------------------------------------*/
 
 _PUBLIC int32_t pups_start_softdog(const uint32_t timeout)
 
 {    int32_t t_index  = (-1);
 
+     if(appl_softdog_enabled == TRUE)
+     {  pups_set_errno(EEXIST);
+        return(-1);
+     }
 
-     /*-------*/
-     /* Child */
-     /*-------*/
-
-     if ((appl_softdog_pid = pups_fork(FALSE,FALSE)) == 0)
-     {  char applpidstr[SSIZE]  = "",
-                      timeoutstr[SSIZE]  = "";
-
-
-        /*---------------------------------*/
-        /* Cancel timers so child does not */
-        /* get signalled                   */
-        /*---------------------------------*/
-
-        (void)pups_malarm(0);
-
-
-	/*---------------------------------*/
-	/* Exec software watchdog as child */
-	/*---------------------------------*/
-
-        (void)snprintf(applpidstr,SSIZE,"%d",appl_pid);
-        (void)snprintf(timeoutstr,SSIZE,"%d",timeout);
-        (void)execlp("softdog","softdog","-monitorpid",applpidstr,"-timeout",timeoutstr,(char *)NULL);
+     if(softdog_attach() == (softdog_table_type *)NULL)
+     {  pups_set_errno(ENODEV);
+        return(-1);
+     }
 
 
-	/*------------------------*/
-	/* We should not get here */
-	/*------------------------*/
+     /*-----------------------*/
+     /* Start softdog daemon  */
+     /*-----------------------*/
 
-	_exit(255);
+     if(softdog_daemon_start() == FALSE)
+     {  pups_set_errno(ESRCH);
+        return(-1);
      }
 
 
-     /*--------*/
-     /* Parent */
-     /*--------*/
-
-     else
+     /*-------------------------------*/
+     /* Register with softdog daemon  */
+     /*-------------------------------*/
 
+     if(softdog_register(timeout) == (-1))
+     {  pups_set_errno(ENOSPC);
+        return(-1);
+     }
 
-        /*------------------------------------------------*/
-        /* Set polling time software watchdog (in seconds) */
-        /*------------------------------------------------*/
+     appl_softdog_pid = __atomic_load_n(&softdog_table->daemon,__ATOMIC_ACQUIRE);
 
-        t_index = pups_setvitimer("softdog_homeostat",
-                                  1,VT_CONTINUOUS,500,
-                                  (void *)NULL,
-                                  (void *)softdog_homeostat);
 
+     /*-------------------------------------------------*/
+     /* Set polling time software watchdog (in seconds) */
+     /*-------------------------------------------------*/
 
+     t_index = pups_setvitimer("softdog_homeostat",
+                               1,VT_CONTINUOUS,500,
+                               (void *)NULL,
+                               (void *)softdog_homeostat);
 
      if(appl_verbose == TRUE)
      {  (void)strdate(date);
@@ -21800,21 +23610,26 @@ _PUBLIC int32_t pups_start_softdog(const uint32_t timeout)
 
 
 
-/*------------------------*/
-/* Stop software watchdog */
-/*------------------------*/
+/*------------------------------------------------------*/
+/* Stop software watchdog. We release our slot (the     */
+/* softdog daemon carries on watching other processes)  */
+/*------------------------------------------------------*/
 
 _PUBLIC int32_t pups_stop_softdog(void)
 
-{   int32_t ret = (-1);
+{
+
+    if(appl_softdog_enabled == FALSE)
+    {  pups_set_errno(ESRCH);
+       return(-1);
+    }
 
 
-    /*-----------------------------*/
-    /* Terminate software watchdog */
-    /*-----------------------------*/
+    /*--------------------------------------*/
+    /* Deregister with software watchdog    */
+    /*--------------------------------------*/
 
-    pups_set_errno(OK);
-    ret = kill(appl_softdog_pid,SIGTERM);
+    softdog_release();
 
 
     /*------------------*/
@@ -11,8 +11,8 @@
              NE3 4RT
              United Kingdom
 
-    Version: 2.11
-    Dated:   12th December 2024
+    Version: 2.12
+    Dated:   19th October 2026
     E-mail:  mao@tumblingdice.co.uk 
 ------------------------------------------------------------------------------*/
 
@@ -24,6 +24,13 @@
 
 #include <casino.h>
 #include <utils.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif /* _OPENMP */
 
 
 /*-----------------------------------------------*/
@@ -85,6 +92,16 @@ _PRIVATE _CONST FTYPE    TINY    = 1.0e-20;
 #define MAX_VECS 256 
 
 
+/*------------------------------------------------------------*/
+/* Alignment of SoA component arrays and smallest set size    */
+/* for which batch kernels are run in parallel (below this,   */
+/* thread start up costs more than is gained)                 */
+/*------------------------------------------------------------*/
+
+#define SOA_ALIGN    64
+#define SOA_PAR_MIN  16384
+
+
 
 
 /*---------------------------------------------*/
@@ -1711,3 +1728,462 @@ _PUBLIC matrix3 m3inv(matrix3 *arg)
 
     return(*arg);
 }
+
+
+
+
+/*-----------------------------------------------------------*/
+/* Create SoA vector3 set. Each component array is allocated */
+/* on a cache line boundary and zeroed                       */
+/*-----------------------------------------------------------*/
+
+_PUBLIC vector3_soa *v3soa_create(const size_t n)
+
+{   uint32_t i;
+
+    vector3_soa *ret = (vector3_soa *)NULL;
+
+    ret    = (vector3_soa *)pups_calloc(1,sizeof(vector3_soa));
+    ret->n = n;
+
+    for(i=0; i<3; ++i)
+    {  if(posix_memalign((void **)&ret->comp[i],SOA_ALIGN,(n + 1)*sizeof(FTYPE)) != 0)
+       {  pups_set_errno(ENOMEM);
+          return(v3soa_destroy(ret));
+       }
+
+       (void)memset((void *)ret->comp[i],0,(n + 1)*sizeof(FTYPE));
+    }
+
+    pups_set_errno(OK);
+    return(ret);
+}
+
+
+
+
+/*----------------------------*/
+/* Destroy SoA vector3 set    */
+/*----------------------------*/
+
+_PUBLIC vector3_soa *v3soa_destroy(vector3_soa *arg)
+
+{   uint32_t i;
+
+    if(arg == (vector3_soa *)NULL)
+       return((vector3_soa *)NULL);
+
+    for(i=0; i<3; ++i)
+    {  if(arg->comp[i] != (FTYPE *)NULL)
+          (void)free((void *)arg->comp[i]);
+    }
+
+    (void)pups_free((void *)arg);
+    return((vector3_soa *)NULL);
+}
+
+
+
+
+/*---------------------------------------------------*/
+/* Load SoA vector3 set from array of vector3's      */
+/*---------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_load(const size_t n, const vector3 *arr, vector3_soa *ret)
+
+{   size_t   i;
+    uint32_t j;
+
+    if(ret == (vector3_soa *)NULL || arr == (const vector3 *)NULL || ret->n != n)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #pragma omp parallel for private(j) if(n >= SOA_PAR_MIN)
+    for(i=0; i<n; ++i)
+    {  for(j=0; j<3; ++j)
+          ret->comp[j][i] = arr[i].comp[j];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*--------------------------------------------------*/
+/* Store SoA vector3 set to array of vector3's      */
+/*--------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_store(const vector3_soa *arg, vector3 *arr)
+
+{   size_t   i;
+    uint32_t j;
+
+    if(arg == (const vector3_soa *)NULL || arr == (vector3 *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #pragma omp parallel for private(j) if(arg->n >= SOA_PAR_MIN)
+    for(i=0; i<arg->n; ++i)
+    {  for(j=0; j<3; ++j)
+          arr[i].comp[j] = arg->comp[j][i];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*-------------------------------------------------------------*/
+/* Check that SoA vector3 sets are the same size (arg2 may     */
+/* be NULL for unary kernels)                                  */
+/*-------------------------------------------------------------*/
+
+_PRIVATE _BOOLEAN soa_conformant(const vector3_soa *arg1, const vector3_soa *arg2, const vector3_soa *ret)
+
+{   if(arg1 == (const vector3_soa *)NULL || ret == (const vector3_soa *)NULL || arg1->n != ret->n)
+    {  pups_set_errno(EINVAL);
+       return(FALSE);
+    }
+
+    if(arg2 != (const vector3_soa *)NULL && arg2->n != arg1->n)
+    {  pups_set_errno(EINVAL);
+       return(FALSE);
+    }
+
+    return(TRUE);
+}
+
+
+
+
+/*-------------------------------*/
+/* Add two SoA vector3 sets      */
+/*-------------------------------*/
+
+_PUBLIC int32_t v3soa_add(const vector3_soa *arg1, const vector3_soa *arg2, vector3_soa *ret)
+
+{   uint32_t j;
+
+    if(arg2 == (const vector3_soa *)NULL || soa_conformant(arg1,arg2,ret) == FALSE)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    for(j=0; j<3; ++j)
+    {  size_t      i;
+
+       const FTYPE *a = arg1->comp[j],
+                   *b = arg2->comp[j];
+       FTYPE       *r = ret->comp[j];
+
+       #pragma omp parallel for simd if(arg1->n >= SOA_PAR_MIN)
+       for(i=0; i<arg1->n; ++i)
+          r[i] = a[i] + b[i];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*------------------------------------------------*/
+/* Subtract SoA vector3 set from SoA vector3 set  */
+/*------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_sub(const vector3_soa *arg1, const vector3_soa *arg2, vector3_soa *ret)
+
+{   uint32_t j;
+
+    if(arg2 == (const vector3_soa *)NULL || soa_conformant(arg1,arg2,ret) == FALSE)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    for(j=0; j<3; ++j)
+    {  size_t      i;
+
+       const FTYPE *a = arg1->comp[j],
+                   *b = arg2->comp[j];
+       FTYPE       *r = ret->comp[j];
+
+       #pragma omp parallel for simd if(arg1->n >= SOA_PAR_MIN)
+       for(i=0; i<arg1->n; ++i)
+          r[i] = a[i] - b[i];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*-------------------------------------*/
+/* Multiply SoA vector3 set by scalar  */
+/*-------------------------------------*/
+
+_PUBLIC int32_t v3soa_scalm(const FTYPE scalar, const vector3_soa *arg, vector3_soa *ret)
+
+{   uint32_t j;
+
+    if(soa_conformant(arg,(const vector3_soa *)NULL,ret) == FALSE)
+       return(-1);
+
+    for(j=0; j<3; ++j)
+    {  size_t      i;
+
+       const FTYPE *a = arg->comp[j];
+       FTYPE       *r = ret->comp[j];
+
+       #pragma omp parallel for simd if(arg->n >= SOA_PAR_MIN)
+       for(i=0; i<arg->n; ++i)
+          r[i] = scalar*a[i];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*------------------------------------------------------*/
+/* Scalar (dot) products of two SoA vector3 sets. dot   */
+/* must have room for n values                          */
+/*------------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_dot(const vector3_soa *arg1, const vector3_soa *arg2, FTYPE *dot)
+
+{   size_t i;
+
+    if(dot == (FTYPE *)NULL || soa_conformant(arg1,arg2,arg1) == FALSE || arg2 == (const vector3_soa *)NULL)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #pragma omp parallel for simd if(arg1->n >= SOA_PAR_MIN)
+    for(i=0; i<arg1->n; ++i)
+    {  uint32_t j;
+       FTYPE    sum = 0.0;
+
+       for(j=0; j<3; ++j)
+          sum += arg1->comp[j][i]*arg2->comp[j][i];
+
+       dot[i] = sum;
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*--------------------------------------------------------*/
+/* Magnitudes of SoA vector3 set (mag must have room for  */
+/* n values)                                              */
+/*--------------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_mag(const vector3_soa *arg, FTYPE *mag)
+
+{   if(v3soa_dot(arg,arg,mag) == (-1))
+       return(-1);
+
+    {  size_t i;
+
+       #pragma omp parallel for simd if(arg->n >= SOA_PAR_MIN)
+       for(i=0; i<arg->n; ++i)
+          mag[i] = SQRT(mag[i]);
+    }
+
+    return(0);
+}
+
+
+
+
+/*-----------------------------------------------------*/
+/* Normalise SoA vector3 set. As for v3unit, zero      */
+/* vectors are returned as zero vectors                */
+/*-----------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_unit(const vector3_soa *arg, vector3_soa *ret)
+
+{   size_t i;
+
+    if(soa_conformant(arg,(const vector3_soa *)NULL,ret) == FALSE)
+       return(-1);
+
+    #pragma omp parallel for simd if(arg->n >= SOA_PAR_MIN)
+    for(i=0; i<arg->n; ++i)
+    {  uint32_t j;
+       FTYPE    magnitude = 0.0,
+                scale;
+
+       for(j=0; j<3; ++j)
+          magnitude += arg->comp[j][i]*arg->comp[j][i];
+
+       scale = (magnitude == 0.0) ? 0.0 : 1.0/SQRT(magnitude);
+
+       for(j=0; j<3; ++j)
+          ret->comp[j][i] = scale*arg->comp[j][i];
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*----------------------------------------------------------*/
+/* Cross products of two SoA vector3 sets. As for v3cross   */
+/* only the first three components take part                */
+/*----------------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_cross(const vector3_soa *arg1, const vector3_soa *arg2, vector3_soa *ret)
+
+{   size_t i;
+
+
+    /*-----------------------------------------*/
+    /* Cross product needs three components    */
+    /*-----------------------------------------*/
+
+    #if 3 < 3
+    pups_set_errno(EINVAL);
+    return(-1);
+    #else
+    if(arg2 == (const vector3_soa *)NULL || soa_conformant(arg1,arg2,ret) == FALSE)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    #pragma omp parallel for simd if(arg1->n >= SOA_PAR_MIN)
+    for(i=0; i<arg1->n; ++i)
+    {  FTYPE a0 = arg1->comp[0][i],
+             a1 = arg1->comp[1][i],
+             a2 = arg1->comp[2][i],
+             b0 = arg2->comp[0][i],
+             b1 = arg2->comp[1][i],
+             b2 = arg2->comp[2][i];
+
+       ret->comp[0][i] = a1*b2 - a2*b1;
+       ret->comp[1][i] = a2*b0 - a0*b2;
+       ret->comp[2][i] = a0*b1 - a1*b0;
+    }
+
+    pups_set_errno(OK);
+    return(0);
+    #endif /* 3 < 3 */
+}
+
+
+
+
+/*------------------------------------------------------------------*/
+/* Rotate SoA vector3 set by theta radians in the plane of          */
+/* components c1 and c2. Rotation about X is plane (1,2), about Y   */
+/* plane (2,0) and about Z plane (0,1) (cf. v3rotx/y/z)             */
+/*------------------------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_rot(const uint32_t c1, const uint32_t c2, const FTYPE theta, const vector3_soa *arg, vector3_soa *ret)
+
+{   uint32_t j;
+
+    FTYPE    cos_theta,
+             sin_theta;
+
+    if(c1 >= 3 || c2 >= 3 || c1 == c2 || soa_conformant(arg,(const vector3_soa *)NULL,ret) == FALSE)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    sin_theta = SIN(theta);
+    cos_theta = COS(theta);
+
+    {  size_t      i;
+
+       const FTYPE *a1 = arg->comp[c1],
+                   *a2 = arg->comp[c2];
+       FTYPE       *r1 = ret->comp[c1],
+                   *r2 = ret->comp[c2];
+
+       #pragma omp parallel for simd if(arg->n >= SOA_PAR_MIN)
+       for(i=0; i<arg->n; ++i)
+       {  FTYPE x = a1[i],
+                y = a2[i];
+
+          r1[i] = x*cos_theta - y*sin_theta;
+          r2[i] = x*sin_theta + y*cos_theta;
+       }
+    }
+
+
+    /*-------------------------------------------*/
+    /* Components outside plane are not changed  */
+    /*-------------------------------------------*/
+
+    if(ret != arg)
+    {  for(j=0; j<3; ++j)
+       {  if(j != c1 && j != c2)
+             (void)memcpy((void *)ret->comp[j],(void *)arg->comp[j],arg->n*sizeof(FTYPE));
+       }
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}
+
+
+
+
+/*--------------------------------------------------------*/
+/* Multiply SoA vector3 set by matrix3 (e.g. Euler        */
+/* rotation). May be applied in place                     */
+/*--------------------------------------------------------*/
+
+_PUBLIC int32_t v3soa_mmult(const matrix3 *mat, const vector3_soa *arg, vector3_soa *ret)
+
+{   size_t   i;
+
+    FTYPE    m[3][3];
+
+    if(mat == (const matrix3 *)NULL || soa_conformant(arg,(const vector3_soa *)NULL,ret) == FALSE)
+    {  pups_set_errno(EINVAL);
+       return(-1);
+    }
+
+    (void)memcpy((void *)m,(void *)mat->comp,sizeof(m));
+
+    #pragma omp parallel for simd if(arg->n >= SOA_PAR_MIN)
+    for(i=0; i<arg->n; ++i)
+    {  uint32_t j,
+                k;
+
+       FTYPE    in[3];
+
+       for(j=0; j<3; ++j)
+          in[j] = arg->comp[j][i];
+
+       for(j=0; j<3; ++j)
+       {  FTYPE sum = 0.0;
+
+          for(k=0; k<3; ++k)
+             sum += m[j][k]*in[k];
+
+          ret->comp[j][i] = sum;
+       }
+    }
+
+    pups_set_errno(OK);
+    return(0);
+}